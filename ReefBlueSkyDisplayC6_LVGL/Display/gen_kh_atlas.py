@@ -0,0 +1,250 @@
+# gen_kh_atlas.py
+# Gera o atlas RGB565 (RLE) do número grande de dKH a partir da fonte
+# montserrat_bold_32.c (formato lv_font_conv, 4 bpp, sem compressão).
+#
+# Os glifos já saem misturados com as cores fixas do painel (texto do tema
+# escuro sobre fundo preto), então o widget KhDigits só copia pixels para o
+# draw buffer do LVGL, sem passar pelo motor de fontes.
+#
+# Uso:
+#   python gen_kh_atlas.py                # regenera src/display/assets/kh_digits_atlas.{c,h}
+#   extra_scripts = pre:gen_kh_atlas.py   # PlatformIO: regenera se a fonte/script mudou
+
+import os
+import re
+import sys
+
+FONT_REL   = os.path.join("src", "display", "assets", "montserrat_bold_32.c")
+OUT_C_REL  = os.path.join("src", "display", "assets", "kh_digits_atlas.c")
+OUT_H_REL  = os.path.join("src", "display", "assets", "kh_digits_atlas.h")
+LVCONF_REL = "lv_conf.h"
+
+# Caracteres do readout: dígitos, separadores, sinal e a unidade
+CHARSET  = "0123456789.,-+ dKH"
+TABULAR  = "0123456789"   # dígitos com largura fixa (número não "pula" ao mudar)
+
+# Cores do readout: texto do tema default escuro (GREY lighten 5) sobre o fundo
+# preto do ui_Screen1. Se o tema mudar, regerar o atlas.
+FG_RGB = 0xFAFAFA
+BG_RGB = 0x000000
+
+
+def parse_font(path):
+    with open(path, "r", encoding="utf-8") as f:
+        src = f.read()
+
+    m = re.search(r"glyph_bitmap\[\]\s*=\s*\{(.*?)\};", src, re.S)
+    if not m:
+        raise RuntimeError("glyph_bitmap[] não encontrado em " + path)
+    body = re.sub(r"/\*.*?\*/", "", m.group(1), flags=re.S)
+    bitmap = [int(tok, 16) for tok in re.findall(r"0x[0-9a-fA-F]+", body)]
+
+    m = re.search(r"glyph_dsc\[\]\s*=\s*\{(.*?)\};", src, re.S)
+    dsc = []
+    for g in re.finditer(r"\{\.bitmap_index = (\d+), \.adv_w = (\d+), \.box_w = (\d+), "
+                         r"\.box_h = (\d+), \.ofs_x = (-?\d+), \.ofs_y = (-?\d+)\}", m.group(1)):
+        dsc.append(tuple(int(v) for v in g.groups()))
+
+    m = re.search(r"\.range_start = (\d+), \.range_length = (\d+), \.glyph_id_start = (\d+)", src)
+    cmap = tuple(int(v) for v in m.groups())
+
+    line_height = int(re.search(r"\.line_height = (\d+)", src).group(1))
+    base_line   = int(re.search(r"\.base_line = (\d+)", src).group(1))
+    bpp         = int(re.search(r"\.bpp = (\d+)", src).group(1))
+    if bpp != 4:
+        raise RuntimeError("esperado 4 bpp, fonte tem %d" % bpp)
+
+    return bitmap, dsc, cmap, line_height, base_line
+
+
+def glyph_id(cmap, ch):
+    start, length, id_start = cmap
+    cp = ord(ch)
+    if not (start <= cp < start + length):
+        raise RuntimeError("caractere fora do cmap ASCII: %r" % ch)
+    return cp - start + id_start
+
+
+def rgb565(c):
+    r, g, b = (c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF
+    return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+
+
+def blend(a4):
+    # mesma tabela de opacidade do LVGL para 4 bpp (0, 17, 34 ... 255)
+    a = a4 * 17
+    out = 0
+    for shift in (16, 8, 0):
+        f = (FG_RGB >> shift) & 0xFF
+        b = (BG_RGB >> shift) & 0xFF
+        out |= ((f * a + b * (255 - a) + 127) // 255) << shift
+    return rgb565(out)
+
+
+def swap16(v):
+    return ((v & 0xFF) << 8) | (v >> 8)
+
+
+def render(bitmap, dsc, cmap, line_height, base_line, swap):
+    digit_w = max((dsc[glyph_id(cmap, d)][1] + 8) >> 4 for d in TABULAR)
+    bg = blend(0)
+
+    glyphs = []
+    for ch in CHARSET:
+        bidx, adv, bw, bh, ox, oy = dsc[glyph_id(cmap, ch)]
+        adv_px = (adv + 8) >> 4
+        width = digit_w if ch in TABULAR else adv_px
+        x0 = ox + (width - adv_px) // 2
+        y0 = line_height - base_line - bh - oy     # igual ao lv_draw_letter
+
+        cell = [[bg] * width for _ in range(line_height)]
+        for y in range(bh):
+            for x in range(bw):
+                i = y * bw + x                        # 4 bpp contínuo entre linhas
+                byte = bitmap[bidx + (i >> 1)]
+                a4 = (byte >> 4) if (i & 1) == 0 else (byte & 0x0F)
+                cx, cy = x0 + x, y0 + y
+                if a4 and 0 <= cx < width and 0 <= cy < line_height:
+                    cell[cy][cx] = blend(a4)
+
+        # RLE por linha: pares (comprimento, cor); nenhuma corrida cruza linha
+        rle, row_ofs = [], []
+        for row in cell:
+            row_ofs.append(len(rle))
+            run_c, run_n = row[0], 0
+            for px in row:
+                if px == run_c:
+                    run_n += 1
+                else:
+                    rle += [run_n, swap16(run_c) if swap else run_c]
+                    run_c, run_n = px, 1
+            rle += [run_n, swap16(run_c) if swap else run_c]
+
+        glyphs.append((ch, width, rle, row_ofs))
+    return glyphs, digit_w
+
+
+def lv_color_swap(project_dir):
+    try:
+        with open(os.path.join(project_dir, LVCONF_REL), "r", encoding="utf-8") as f:
+            m = re.search(r"#define\s+LV_COLOR_16_SWAP\s+(\d+)", f.read())
+            return bool(m and int(m.group(1)))
+    except OSError:
+        return False
+
+
+def c_char(ch):
+    return "'\\''" if ch == "'" else "'%s'" % ch
+
+
+def write_outputs(project_dir):
+    font_path = os.path.join(project_dir, FONT_REL)
+    bitmap, dsc, cmap, line_height, base_line = parse_font(font_path)
+    swap = lv_color_swap(project_dir)
+    glyphs, digit_w = render(bitmap, dsc, cmap, line_height, base_line, swap)
+
+    raw_bytes = sum(g[1] for g in glyphs) * line_height * 2
+    rle_words = sum(len(g[2]) for g in glyphs)
+
+    h = []
+    h.append("// kh_digits_atlas.h")
+    h.append("// GERADO por gen_kh_atlas.py a partir de montserrat_bold_32.c - não editar.")
+    h.append("#pragma once")
+    h.append("")
+    h.append("#include <stdint.h>")
+    h.append("")
+    h.append("#ifdef __cplusplus")
+    h.append('extern "C" {')
+    h.append("#endif")
+    h.append("")
+    h.append("#define KH_ATLAS_HEIGHT         %d      // line_height da fonte" % line_height)
+    h.append("#define KH_ATLAS_DIGIT_W        %d      // largura tabular dos dígitos" % digit_w)
+    h.append("#define KH_ATLAS_GLYPH_COUNT    %d" % len(glyphs))
+    h.append("#define KH_ATLAS_COLOR_16_SWAP  %d       // pixels já no formato do lv_color_t" % int(swap))
+    h.append("#define KH_ATLAS_FG             0x%06X" % FG_RGB)
+    h.append("#define KH_ATLAS_BG             0x%06X" % BG_RGB)
+    h.append("")
+    h.append("// Glifo = célula largura x KH_ATLAS_HEIGHT; RLE por linha em pares")
+    h.append("// (comprimento, cor RGB565) a partir de kh_atlas_rle[rle_start + row_ofs[y]]")
+    h.append("typedef struct {")
+    h.append("    uint32_t rle_start;")
+    h.append("    uint16_t row_ofs[KH_ATLAS_HEIGHT];")
+    h.append("    uint8_t  width;")
+    h.append("    char     ch;")
+    h.append("} kh_atlas_glyph_t;")
+    h.append("")
+    h.append("extern const kh_atlas_glyph_t kh_atlas_glyphs[KH_ATLAS_GLYPH_COUNT];")
+    h.append("extern const uint16_t         kh_atlas_rle[];")
+    h.append("")
+    h.append("// ASCII 32..127 -> índice em kh_atlas_glyphs (-1 = ausente)")
+    h.append("extern const int8_t           kh_atlas_map[96];")
+    h.append("")
+    h.append("#ifdef __cplusplus")
+    h.append("}")
+    h.append("#endif")
+    h.append("")
+
+    c = []
+    c.append("/*******************************************************************************")
+    c.append(" * GERADO por gen_kh_atlas.py - não editar.")
+    c.append(" * Fonte: montserrat_bold_32.c (4 bpp), chars: \"%s\"" % CHARSET)
+    c.append(" * Cores: 0x%06X sobre 0x%06X, RGB565%s" % (FG_RGB, BG_RGB, " (byte swap)" if swap else ""))
+    c.append(" * Tamanho: %d bytes RLE (bruto seria %d bytes)" % (rle_words * 2, raw_bytes))
+    c.append(" ******************************************************************************/")
+    c.append("")
+    c.append('#include "kh_digits_atlas.h"')
+    c.append("")
+    c.append("const uint16_t kh_atlas_rle[] = {")
+    start = 0
+    starts = []
+    for ch, width, rle, row_ofs in glyphs:
+        starts.append(start)
+        c.append("    /* %s */" % c_char(ch))
+        for i in range(0, len(rle), 12):
+            c.append("    " + ", ".join("0x%04x" % v for v in rle[i:i + 12]) + ",")
+        start += len(rle)
+    c.append("};")
+    c.append("")
+    c.append("const kh_atlas_glyph_t kh_atlas_glyphs[KH_ATLAS_GLYPH_COUNT] = {")
+    for (ch, width, rle, row_ofs), s in zip(glyphs, starts):
+        rows = ", ".join(str(v) for v in row_ofs)
+        c.append("    {.rle_start = %d, .width = %d, .ch = %s," % (s, width, c_char(ch)))
+        c.append("     .row_ofs = {%s}}," % rows)
+    c.append("};")
+    c.append("")
+    amap = [-1] * 96
+    for i, (ch, _, _, _) in enumerate(glyphs):
+        amap[ord(ch) - 32] = i
+    c.append("const int8_t kh_atlas_map[96] = {")
+    for i in range(0, 96, 16):
+        c.append("    " + ", ".join("%2d" % v for v in amap[i:i + 16]) + ",")
+    c.append("};")
+    c.append("")
+
+    with open(os.path.join(project_dir, OUT_H_REL), "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(h))
+    with open(os.path.join(project_dir, OUT_C_REL), "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(c))
+
+    print("KH ATLAS: %d glifos, %d bytes RLE (bruto %d bytes)" % (len(glyphs), rle_words * 2, raw_bytes))
+
+
+def is_stale(project_dir, script_path):
+    out = os.path.join(project_dir, OUT_C_REL)
+    if not os.path.exists(out):
+        return True
+    deps = [os.path.join(project_dir, FONT_REL), os.path.join(project_dir, LVCONF_REL)]
+    if script_path:
+        deps.append(script_path)
+    t_out = os.path.getmtime(out)
+    return any(os.path.exists(d) and os.path.getmtime(d) > t_out for d in deps)
+
+
+try:
+    Import("env")  # noqa: F821 - executado pelo PlatformIO (extra_scripts = pre:)
+    _project_dir = env.subst("$PROJECT_DIR")  # noqa: F821
+    if is_stale(_project_dir, os.path.join(_project_dir, "gen_kh_atlas.py")):
+        write_outputs(_project_dir)
+except NameError:
+    if __name__ == "__main__":
+        write_outputs(os.path.dirname(os.path.abspath(sys.argv[0])))
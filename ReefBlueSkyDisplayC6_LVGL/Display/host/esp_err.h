@@ -0,0 +1,9 @@
+// esp_err.h (host) - só os códigos usados pelos módulos testados aqui
+#pragma once
+
+typedef int esp_err_t;
+
+#define ESP_OK                0
+#define ESP_FAIL              -1
+#define ESP_ERR_NO_MEM        0x101
+#define ESP_ERR_NVS_NOT_FOUND 0x1102
@@ -0,0 +1,14 @@
+// esp_log.h (host) - logs só com HOST_LOG definido
+#pragma once
+
+#include <stdio.h>
+
+#ifdef HOST_LOG
+#define ESP_LOGI(tag, fmt, ...) printf("I %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) printf("W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGE(tag, fmt, ...) printf("E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#else
+#define ESP_LOGI(tag, fmt, ...) ((void)(tag))
+#define ESP_LOGW(tag, fmt, ...) ((void)(tag))
+#define ESP_LOGE(tag, fmt, ...) ((void)(tag))
+#endif
@@ -0,0 +1,6 @@
+// esp_rom_crc.h (host) - CRC32 (polinômio 0xEDB88320) como o da ROM
+#pragma once
+
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len);
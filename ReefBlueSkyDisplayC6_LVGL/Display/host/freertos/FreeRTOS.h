@@ -0,0 +1,15 @@
+// FreeRTOS.h (host) - tick de 1 ms controlado pelo teste
+#pragma once
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int      BaseType_t;
+
+#define pdTRUE             1
+#define pdFALSE            0
+#define portMAX_DELAY      0xffffffffu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms)  ((TickType_t)(ms))
+
+extern TickType_t hostTicks;
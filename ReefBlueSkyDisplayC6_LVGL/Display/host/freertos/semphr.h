@@ -0,0 +1,10 @@
+// semphr.h (host) - um mutex que nunca disputa (teste numa thread só)
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t        xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait);
+BaseType_t        xSemaphoreGive(SemaphoreHandle_t sem);
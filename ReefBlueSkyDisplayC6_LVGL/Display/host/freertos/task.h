@@ -0,0 +1,6 @@
+// task.h (host)
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+TickType_t xTaskGetTickCount(void);
@@ -0,0 +1,374 @@
+// summary_cache_test.c - desgaste de flash do SummaryCache fora do ESP32
+//
+// Roda o SummaryCache.c de verdade contra um NVS em memória e um tick de
+// FreeRTOS controlado pelo teste. Simula um dia de resumos (polling/stream
+// a cada 20 s, summary_cache_tick() no mesmo ritmo do loop do main.c) e
+// confere os nvs_commit contados no próprio stub, não só o contador interno:
+//   - resumo repetido o dia todo: nenhum commit além do primeiro ponto
+//   - medição nova a cada 2 h: um commit por medição
+//   - só min/max/saúde mudando: no máximo um commit a cada 6 h
+//   - esp_restart (handler de shutdown) grava o que está sujo
+//   - reboot: histórico e resumo voltam do NVS; slot com CRC ruim é ignorado
+//
+// Uso: make test
+
+#include "storage/SummaryCache.h"
+#include "nvs.h"
+#include "esp_system.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+
+#define HOUR_MS (3600UL * 1000UL)
+#define DAY_MS  (24UL * HOUR_MS)
+#define STEP_MS 20000UL   // SUMMARY_POLL_MIN_MS do main.c
+
+// ---------- Stubs ----------
+
+TickType_t hostTicks = 1000;
+
+TickType_t xTaskGetTickCount(void) { return hostTicks; }
+
+static int g_mutex;
+SemaphoreHandle_t xSemaphoreCreateMutex(void) { return &g_mutex; }
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait) { (void)sem; (void)wait; return pdTRUE; }
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) { (void)sem; return pdTRUE; }
+
+static shutdown_handler_t g_shutdown;
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler)
+{
+    g_shutdown = handler;
+    return ESP_OK;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+// NVS: namespaces fixos, chaves num vetor; handle = índice do namespace + 1
+#define HOST_NVS_NS   4
+#define HOST_NVS_KEYS 32
+
+typedef struct {
+    char    ns[16];
+    char    key[16];
+    uint8_t data[512];
+    size_t  size;
+    bool    used;
+} host_nvs_key_t;
+
+static char           g_ns[HOST_NVS_NS][16];
+static int            g_ns_commits[HOST_NVS_NS];
+static int            g_ns_sets[HOST_NVS_NS];
+static host_nvs_key_t g_keys[HOST_NVS_KEYS];
+
+static void host_nvs_reset(void)
+{
+    memset(g_ns, 0, sizeof(g_ns));
+    memset(g_ns_commits, 0, sizeof(g_ns_commits));
+    memset(g_ns_sets, 0, sizeof(g_ns_sets));
+    memset(g_keys, 0, sizeof(g_keys));
+}
+
+static int ns_index(const char *ns, bool create)
+{
+    for (int i = 0; i < HOST_NVS_NS; i++) {
+        if (strcmp(g_ns[i], ns) == 0) return i;
+    }
+    if (!create) return -1;
+    for (int i = 0; i < HOST_NVS_NS; i++) {
+        if (!g_ns[i][0]) {
+            strncpy(g_ns[i], ns, sizeof(g_ns[i]) - 1);
+            return i;
+        }
+    }
+    return -1;
+}
+
+static host_nvs_key_t *find_key(nvs_handle_t handle, const char *key, bool create)
+{
+    const char *ns = g_ns[handle - 1];
+    host_nvs_key_t *free_slot = NULL;
+    for (int i = 0; i < HOST_NVS_KEYS; i++) {
+        if (g_keys[i].used) {
+            if (strcmp(g_keys[i].ns, ns) == 0 && strcmp(g_keys[i].key, key) == 0) return &g_keys[i];
+        } else if (!free_slot) {
+            free_slot = &g_keys[i];
+        }
+    }
+    if (!create || !free_slot) return NULL;
+    memset(free_slot, 0, sizeof(*free_slot));
+    free_slot->used = true;
+    strncpy(free_slot->ns, ns, sizeof(free_slot->ns) - 1);
+    strncpy(free_slot->key, key, sizeof(free_slot->key) - 1);
+    return free_slot;
+}
+
+// Comportamento do IDF: READONLY num namespace que nunca foi gravado falha
+esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *out)
+{
+    int i = ns_index(ns, mode == NVS_READWRITE);
+    if (i < 0) return ESP_ERR_NVS_NOT_FOUND;
+    *out = (nvs_handle_t)(i + 1);
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) { (void)handle; }
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out, size_t *size)
+{
+    host_nvs_key_t *k = find_key(handle, key, false);
+    if (!k) return ESP_ERR_NVS_NOT_FOUND;
+    if (*size < k->size) return ESP_FAIL;
+    memcpy(out, k->data, k->size);
+    *size = k->size;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t size)
+{
+    host_nvs_key_t *k = find_key(handle, key, true);
+    if (!k || size > sizeof(k->data)) return ESP_ERR_NO_MEM;
+    memcpy(k->data, value, size);
+    k->size = size;
+    g_ns_sets[handle - 1]++;
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    host_nvs_key_t *k = find_key(handle, key, false);
+    if (!k) return ESP_ERR_NVS_NOT_FOUND;
+    k->used = false;
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    g_ns_commits[handle - 1]++;
+    return ESP_OK;
+}
+
+// ---------- Auxiliares ----------
+
+static int commits(const char *ns)
+{
+    int i = ns_index(ns, false);
+    return i < 0 ? 0 : g_ns_commits[i];
+}
+
+static int sets(const char *ns)
+{
+    int i = ns_index(ns, false);
+    return i < 0 ? 0 : g_ns_sets[i];
+}
+
+static kh_summary_t make_summary(float kh, time_t ts)
+{
+    kh_summary_t s;
+    memset(&s, 0, sizeof(s));
+    s.has_data              = true;
+    s.kh                    = kh;
+    s.kh_min_24h            = kh - 0.2f;
+    s.kh_max_24h            = kh + 0.2f;
+    s.kh_var_24h            = 0.1f;
+    s.health                = 0.95f;
+    s.health_green_max_dev  = 0.2f;
+    s.health_yellow_max_dev = 0.5f;
+    s.ts                    = ts;
+    return s;
+}
+
+// Boot limpo: NVS vazio, cache recarregado
+static void fresh_boot(void)
+{
+    host_nvs_reset();
+    hostTicks = 1000;
+    CHECK(summary_cache_init() == ESP_OK);
+}
+
+// ---------- Casos ----------
+
+// Backend devolvendo o mesmo resumo o dia todo (stream reenviando, polling
+// sem ETag): só o primeiro ponto de cada device vai para a flash
+static void testUnchangedDay(void)
+{
+    fresh_boot();
+    uint32_t before = summary_cache_write_count();
+    kh_summary_t a = make_summary(7.80f, 1760000000);
+    kh_summary_t b = make_summary(8.10f, 1760000100);
+
+    int updates = 0;
+    for (uint32_t t = 0; t <= DAY_MS; t += STEP_MS) {
+        hostTicks = 1000 + t;
+        summary_cache_update("KH-A", "Aquário", &a);
+        summary_cache_update("KH-B", "Sump", &b);
+        summary_cache_tick();
+        updates += 2;
+    }
+
+    CHECK(updates > 8000);
+    CHECK(commits("sumcache") == 2);
+    CHECK(sets("sumcache") == 2);
+    CHECK(summary_cache_write_count() - before == 2);
+    printf("resumo repetido: %d updates em 24 h -> %d commits\n", updates, commits("sumcache"));
+}
+
+// KH mede a cada 2 h; entre medições o mesmo resumo chega a cada 20 s.
+// Um commit por medição (os dois devices medem no mesmo instante)
+static void testMeasurementsDay(void)
+{
+    fresh_boot();
+    uint32_t before = summary_cache_write_count();
+    const time_t base = 1760000000;
+    kh_summary_t a = make_summary(7.80f, base);
+    kh_summary_t b = make_summary(8.10f, base);
+    int measurements = 0;
+
+    for (uint32_t t = 0; t < DAY_MS; t += STEP_MS) {
+        hostTicks = 1000 + t;
+        if (t % (2 * HOUR_MS) == 0) {
+            time_t ts = base + (time_t)(t / 1000);
+            float delta = (float)(measurements % 5) * 0.05f;
+            a = make_summary(7.80f + delta, ts);
+            b = make_summary(8.10f - delta, ts);
+            measurements++;
+        }
+        summary_cache_update("KH-A", "Aquário", &a);
+        summary_cache_update("KH-B", "Sump", &b);
+        summary_cache_tick();
+    }
+
+    CHECK(measurements == 12);
+    CHECK(commits("sumcache") == 2 * measurements);
+    CHECK(summary_cache_write_count() - before == (uint32_t)(2 * measurements));
+
+    summary_point_t pts[SUMMARY_CACHE_POINTS];
+    int n = summary_cache_get_history("KH-A", pts, SUMMARY_CACHE_POINTS);
+    CHECK(n == measurements);
+    for (int i = 1; i < n; i++) CHECK(pts[i].ts - pts[i - 1].ts == 7200);
+    CHECK(n > 0 && pts[n - 1].kh_centi == (uint16_t)lroundf(a.kh * 100.0f));
+    printf("medição a cada 2 h: %d medições x 2 devices -> %d commits\n",
+           measurements, commits("sumcache"));
+
+    // Reboot: histórico e resumo voltam do NVS, sem gravar nada no boot
+    int commits_before = commits("sumcache");
+    hostTicks = 1000;
+    CHECK(summary_cache_init() == ESP_OK);
+    CHECK(commits("sumcache") == commits_before);
+    CHECK(summary_cache_device_count() == 2);
+
+    summary_point_t again[SUMMARY_CACHE_POINTS];
+    CHECK(summary_cache_get_history("KH-A", again, SUMMARY_CACHE_POINTS) == n);
+    CHECK(memcmp(again, pts, sizeof(pts[0]) * n) == 0);
+
+    kh_summary_t got;
+    CHECK(summary_cache_get("KH-B", &got));
+    CHECK(got.ts == b.ts);
+    CHECK(fabsf(got.kh - b.kh) < 0.006f);
+    CHECK(fabsf(got.kh_max_24h - b.kh_max_24h) < 0.006f);
+    CHECK(fabsf(got.health - b.health) < 0.006f);
+    CHECK(strcmp(summary_cache_device_name(1), "Sump") == 0);
+}
+
+// Sem medição nova, só a saúde oscilando a cada 10 min: fica em RAM e vai
+// para a flash pelo tick, no máximo uma vez a cada SUMMARY_CACHE_FLUSH_MS
+static void testSmallChangesDay(void)
+{
+    fresh_boot();
+    kh_summary_t s = make_summary(7.80f, 1760000000);
+
+    for (uint32_t t = 0; t <= DAY_MS; t += STEP_MS) {
+        hostTicks = 1000 + t;
+        s.health = ((t / (10 * 60000UL)) % 2) ? 0.90f : 0.93f;
+        summary_cache_update("KH-A", "Aquário", &s);
+        summary_cache_tick();
+    }
+
+    int max_ticks = (int)(DAY_MS / SUMMARY_CACHE_FLUSH_MS);
+    CHECK(max_ticks == 4);
+    CHECK(commits("sumcache") == 1 + max_ticks);   // primeiro ponto + timer
+    printf("só saúde mudando: %d commits em 24 h (limite 1 + %d)\n", commits("sumcache"), max_ticks);
+
+    // esp_restart antes do próximo tick: o handler de shutdown grava
+    hostTicks += 60000;
+    s.health = 0.50f;
+    summary_cache_update("KH-A", "Aquário", &s);
+    int before = commits("sumcache");
+    summary_cache_tick();
+    CHECK(commits("sumcache") == before);
+    CHECK(g_shutdown != NULL);
+    if (g_shutdown) g_shutdown();
+    CHECK(commits("sumcache") == before + 1);
+
+    CHECK(summary_cache_init() == ESP_OK);
+    kh_summary_t got;
+    CHECK(summary_cache_get("KH-A", &got));
+    CHECK(fabsf(got.health - 0.50f) < 0.006f);
+
+    // Nada sujo: flush e shutdown não gravam de novo
+    summary_cache_flush();
+    if (g_shutdown) g_shutdown();
+    CHECK(commits("sumcache") == before + 1);
+}
+
+// Blob antigo de 1 valor é apagado no boot; slot corrompido é ignorado
+static void testBootCleanup(void)
+{
+    fresh_boot();
+    kh_summary_t a = make_summary(7.80f, 1760000000);
+    kh_summary_t b = make_summary(8.10f, 1760000000);
+    summary_cache_update("KH-A", "Aquário", &a);
+    summary_cache_update("KH-B", "Sump", &b);
+
+    nvs_handle_t h = 0;
+    uint8_t legacy[16] = { 1 };
+    CHECK(nvs_open("reefbluesky", NVS_READWRITE, &h) == ESP_OK);
+    CHECK(nvs_set_blob(h, "summary", legacy, sizeof(legacy)) == ESP_OK);
+
+    CHECK(nvs_open("sumcache", NVS_READWRITE, &h) == ESP_OK);
+    host_nvs_key_t *d0 = find_key(h, "d0", false);
+    CHECK(d0 != NULL);
+    if (d0) d0->data[40] ^= 0xff;   // dentro do nome: CRC não bate
+
+    CHECK(summary_cache_init() == ESP_OK);
+    CHECK(summary_cache_device_count() == 1);
+    CHECK(strcmp(summary_cache_device_id(0), "KH-B") == 0);
+    CHECK(commits("reefbluesky") == 1);
+
+    size_t size = sizeof(legacy);
+    CHECK(nvs_open("reefbluesky", NVS_READONLY, &h) == ESP_OK);
+    CHECK(nvs_get_blob(h, "summary", legacy, &size) == ESP_ERR_NVS_NOT_FOUND);
+
+    // Segundo boot: nada a apagar, nenhum commit
+    CHECK(summary_cache_init() == ESP_OK);
+    CHECK(commits("reefbluesky") == 1);
+}
+
+int main(void)
+{
+    testUnchangedDay();
+    testMeasurementsDay();
+    testSmallChangesDay();
+    testBootCleanup();
+
+    if (errors) {
+        printf("FALHOU (%d erros)\n", errors);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,191 @@
+//
+//  png_bench.cpp
+//  Host benchmark suite for PNGdec
+//
+//  Decodes the bundled test images (examples/png_benchmark + perf_small.png,
+//  plus any files given on the command line) and reports:
+//   - full decode throughput (MB/s of output pixels) and a checksum of the
+//     decoded image, so the SIMD and scalar builds can be compared
+//   - per filter type unfilter throughput (MB/s): every row of the decoded
+//     image is re-filtered with each PNG filter and DeFilter() is timed on it;
+//     the round trip must give back the original row (OK/FAIL)
+//
+//  make png_bench        -> SSE2/NEON build (if the host has it)
+//  make png_bench_scalar -> same code with -DPNG_NO_SIMD (C6 code path)
+//
+#include <time.h>
+// Single translation unit so the static DeFilter() is reachable
+#include "../src/PNGdec.cpp"
+#include "../examples/png_benchmark/octocat_4bpp.h"
+#include "../examples/png_benchmark/octocat_8bpp.h"
+#include "../examples/png_benchmark/octocat_32bpp.h"
+
+#define MIN_BENCH_NS 200000000LL // run each measurement for at least 0.2s
+
+static PNG png;
+
+static int64_t NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static uint32_t Checksum(const uint8_t *p, int iLen)
+{
+    uint32_t h = 2166136261u; // FNV-1a
+    for (int i = 0; i < iLen; i++) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+static int Predict(int iFilter, int a, int b, int c)
+{
+    switch (iFilter) {
+        case PNG_FILTER_SUB:
+            return a;
+        case PNG_FILTER_UP:
+            return b;
+        case PNG_FILTER_AVG:
+            return (a + b) >> 1;
+        case PNG_FILTER_PAETH: {
+            int p = a + b - c;
+            int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+            if (pa <= pb && pa <= pc) return a;
+            return (pb <= pc) ? b : c;
+        }
+    }
+    return 0;
+}
+
+// Forward filter (reference encoder) of one row; pOut[0] = filter byte
+static void FilterRow(int iFilter, const uint8_t *pRow, const uint8_t *pPrevRow, uint8_t *pOut, int iPitch, int iBpp)
+{
+    pOut[0] = (uint8_t)iFilter;
+    for (int x = 0; x < iPitch; x++) {
+        int a = (x >= iBpp) ? pRow[x - iBpp] : 0;
+        int b = pPrevRow ? pPrevRow[x] : 0;
+        int c = (pPrevRow && x >= iBpp) ? pPrevRow[x - iBpp] : 0;
+        pOut[x + 1] = (uint8_t)(pRow[x] - Predict(iFilter, a, b, c));
+    }
+}
+
+static void BenchFilters(const uint8_t *pImage, int iWidth, int iHeight, int iPitch)
+{
+    static const char *szNames[PNG_FILTER_COUNT] = {"None", "Sub", "Up", "Avg", "Paeth"};
+    int iBpp = (iPitch <= iWidth) ? 1 : iPitch / iWidth; // same rule as DeFilter()
+    int iRowSize = iPitch + 1;
+    uint8_t *pFiltered = (uint8_t *)malloc(iRowSize * iHeight);
+    uint8_t *pWork = (uint8_t *)malloc(iRowSize * 2);
+    uint8_t *pZero = (uint8_t *)calloc(1, iRowSize);
+
+    for (int iFilter = PNG_FILTER_SUB; iFilter < PNG_FILTER_COUNT; iFilter++) {
+        for (int y = 0; y < iHeight; y++) {
+            FilterRow(iFilter, &pImage[y * iPitch], y ? &pImage[(y - 1) * iPitch] : NULL,
+                      &pFiltered[y * iRowSize], iPitch, iBpp);
+        }
+        // correctness: DeFilter with the real previous row must restore the image
+        bool bOK = true;
+        for (int y = 0; y < iHeight && bOK; y++) {
+            memcpy(pWork, &pFiltered[y * iRowSize], iRowSize);
+            pWork[iRowSize] = 0; // previous row layout: [filter][pixels]
+            if (y) memcpy(&pWork[iRowSize + 1], &pImage[(y - 1) * iPitch], iPitch);
+            else memset(&pWork[iRowSize + 1], 0, iPitch);
+            DeFilter(pWork, &pWork[iRowSize], iWidth, iPitch);
+            bOK = (memcmp(&pWork[1], &pImage[y * iPitch], iPitch) == 0);
+        }
+        // speed: DeFilter every row in place, as DecodePNG() does
+        int64_t llBytes = 0, llStart = NowNs(), llTime;
+        do {
+            for (int y = 0; y < iHeight; y++) {
+                uint8_t *pCurr = &pFiltered[y * iRowSize];
+                pCurr[0] = (uint8_t)iFilter; // overwritten by the previous pass
+                DeFilter(pCurr, y ? &pFiltered[(y - 1) * iRowSize] : pZero, iWidth, iPitch);
+            }
+            // the buffer now holds pixels; re-filter for the next pass
+            llBytes += (int64_t)iPitch * iHeight;
+            llTime = NowNs() - llStart;
+            if (llTime < MIN_BENCH_NS) {
+                for (int y = 0; y < iHeight; y++) {
+                    FilterRow(iFilter, &pImage[y * iPitch], y ? &pImage[(y - 1) * iPitch] : NULL,
+                              &pFiltered[y * iRowSize], iPitch, iBpp);
+                }
+                llStart += NowNs() - llStart - llTime; // don't count the encoder
+            }
+        } while (llTime < MIN_BENCH_NS);
+        printf("    %-6s %9.1f MB/s  %s\n", szNames[iFilter], (double)llBytes * 1000.0 / (double)llTime, bOK ? "OK" : "FAIL");
+    }
+    free(pFiltered);
+    free(pWork);
+    free(pZero);
+}
+
+static void BenchImage(const char *szName, uint8_t *pData, int iDataSize)
+{
+    int rc = png.openRAM(pData, iDataSize, NULL);
+    if (rc != PNG_SUCCESS) {
+        printf("%s: open failed (%d)\n", szName, rc);
+        return;
+    }
+    int iWidth = png.getWidth(), iHeight = png.getHeight();
+    int iSize = png.getBufferSize();
+    uint8_t *pImage = (uint8_t *)malloc(iSize);
+    png.setBuffer(pImage);
+
+    int64_t llBytes = 0, llStart = NowNs(), llTime;
+    do {
+        png.openRAM(pData, iDataSize, NULL);
+        png.setBuffer(pImage);
+        rc = png.decode(NULL, 0);
+        llBytes += iSize;
+        llTime = NowNs() - llStart;
+    } while (rc == PNG_SUCCESS && llTime < MIN_BENCH_NS);
+
+    int iPitch = iSize / iHeight;
+    printf("%s: %d x %d, %d bpp, pixel type %d, %d bytes -> decode %.1f MB/s, checksum %08x%s\n", szName,
+           iWidth, iHeight, png.getBpp(), png.getPixelType(), iDataSize, (double)llBytes * 1000.0 / (double)llTime, Checksum(pImage, iSize), (rc == PNG_SUCCESS) ? "" : " (DECODE ERROR)");
+    if (rc == PNG_SUCCESS) {
+        BenchFilters(pImage, iWidth, iHeight, iPitch);
+    }
+    png.close();
+    free(pImage);
+}
+
+static void BenchFile(const char *szFile)
+{
+    FILE *ihandle = fopen(szFile, "rb");
+    if (ihandle == NULL) {
+        fprintf(stderr, "Unable to open file: %s\n", szFile);
+        return;
+    }
+    fseek(ihandle, 0L, SEEK_END);
+    int iDataSize = (int)ftell(ihandle);
+    fseek(ihandle, 0, SEEK_SET);
+    uint8_t *pData = (uint8_t *)malloc(iDataSize);
+    if (fread(pData, 1, iDataSize, ihandle) == (size_t)iDataSize) {
+        BenchImage(szFile, pData, iDataSize);
+    }
+    fclose(ihandle);
+    free(pData);
+}
+
+int main(int argc, const char *argv[])
+{
+#if defined(PNG_SIMD_SSE2)
+    printf("PNGdec benchmark (SSE2)\n");
+#elif defined(PNG_SIMD_NEON)
+    printf("PNGdec benchmark (NEON)\n");
+#else
+    printf("PNGdec benchmark (scalar)\n");
+#endif
+    BenchImage("octocat_4bpp", (uint8_t *)octocat_4bpp, sizeof(octocat_4bpp));
+    BenchImage("octocat_8bpp", (uint8_t *)octocat_8bpp, sizeof(octocat_8bpp));
+    BenchImage("octocat_32bpp", (uint8_t *)octocat_32bpp, sizeof(octocat_32bpp));
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) BenchFile(argv[i]);
+    } else {
+        BenchFile("../perf_small.png");
+    }
+    return 0;
+}
@@ -7,6 +7,7 @@
 #include "inftrees.h"
 #include "inflate.h"
 #include "inffast.h"
+#include "png_simd.h"
 
 #if (INTPTR_MAX == INT64_MAX) || defined(HAL_ESP32_HAL_H_) || defined(TEENSYDUINO) || defined(ARM_MATH_CM4) || defined(ARM_MATH_CM7)
 #define ALLOWS_UNALIGNED
@@ -306,6 +307,19 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                     {
                         uint8_t *pEnd = out+len;
                         int overlap = (int)(intptr_t)(out-from);
+#if defined(PNG_SIMD_SSE2) || defined(PNG_SIMD_NEON)
+                        if (overlap >= 16) { // 16 bytes per copy, tail done below
+                            while (pEnd - out >= 16) {
+#ifdef PNG_SIMD_SSE2
+                                _mm_storeu_si128((__m128i *)out, _mm_loadu_si128((const __m128i *)from));
+#else
+                                vst1q_u8(out, vld1q_u8(from));
+#endif
+                                out += 16;
+                                from += 16;
+                            }
+                        }
+#endif // SIMD
                         if (overlap >= 4) { // overlap of source/dest won't impede normal copy
                             while (out < pEnd) {
                                 *(uint32_t *)out = *(uint32_t *)from;
@@ -314,15 +328,9 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                             }
                             // correct for possible overshoot of destination ptr
                             out = pEnd;
-                        } else if (overlap == 1) { // copy 1-byte pattern
-                            uint32_t pattern = *from;
-                            pattern = pattern | (pattern << 8);
-                            pattern = pattern | (pattern << 16);
-                            while (out < pEnd) {
-                                *(uint32_t *)out = pattern;
-                                out += 4;
-                            }
-                            out = pEnd; // correct possible overshoot
+                        } else if (overlap == 1) { // 1-byte pattern (runs of a palette index)
+                            memset(out, *from, len); // libc memset is vectorized on hosts
+                            out = pEnd;
                         } else { // overlap of 2 or 3
                             while (out < pEnd) {
                                 *out++ = *from++;
@@ -16,6 +16,8 @@
 #  define GUNZIP
 #endif
 
+#include <stdint.h> /* uint64_t hold */
+
 /* Possible inflate modes between inflate() calls */
 typedef enum {
     HEAD = 16180,   /* i: waiting for magic header */
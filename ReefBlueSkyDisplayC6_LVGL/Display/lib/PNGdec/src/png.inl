@@ -20,6 +20,7 @@
 //===========================================================================
 //
 #include "zlib.h"
+#include "png_simd.h"
 //
 // Convert 8-bit grayscale into RGB565
 //
@@ -550,6 +551,197 @@ PNG_STATIC int PNGParseInfo(PNGIMAGE *pPage)
     return PNG_SUCCESS;
 } /* PNGParseInfo() */
 //
+// SIMD unfilters (SSE2 / NEON hosts)
+// Up is done 16 bytes at a time for any pixel size; Sub, Avg and Paeth
+// carry a serial dependency on the pixel to the left, so they work one
+// 3 or 4-byte pixel at a time in vector registers (same approach as libpng).
+// Other pixel sizes and non-SIMD targets (ESP32-C6) use the scalar code.
+//
+#if defined(PNG_SIMD_SSE2) || defined(PNG_SIMD_NEON)
+#define PNG_HAS_SIMD_UNFILTER
+
+static inline void DeFilterUpSIMD(uint8_t *pCurr, const uint8_t *pPrev, int iPitch)
+{
+    int x = 0;
+    for (; x + 16 <= iPitch; x += 16) {
+#ifdef PNG_SIMD_SSE2
+        __m128i c = _mm_loadu_si128((const __m128i *)&pCurr[x]);
+        __m128i b = _mm_loadu_si128((const __m128i *)&pPrev[x]);
+        _mm_storeu_si128((__m128i *)&pCurr[x], _mm_add_epi8(c, b));
+#else
+        vst1q_u8(&pCurr[x], vaddq_u8(vld1q_u8(&pCurr[x]), vld1q_u8(&pPrev[x])));
+#endif
+    }
+    for (; x < iPitch; x++) {
+        pCurr[x] += pPrev[x];
+    }
+} /* DeFilterUpSIMD() */
+
+#ifdef PNG_SIMD_SSE2
+typedef __m128i png_px_t;
+static inline png_px_t PNGLoadPixel(const uint8_t *p, int iBpp)
+{
+    uint32_t u32 = 0;
+    memcpy(&u32, p, iBpp);
+    return _mm_cvtsi32_si128((int)u32);
+}
+static inline void PNGStorePixel(uint8_t *p, png_px_t v, int iBpp)
+{
+    uint32_t u32 = (uint32_t)_mm_cvtsi128_si32(v);
+    memcpy(p, &u32, iBpp);
+}
+#define PNG_PX_ZERO()    _mm_setzero_si128()
+#define PNG_PX_MASK(bpp) _mm_cvtsi32_si128((bpp) == 4 ? -1 : 0xffffff)
+#define PNG_PX_AND(a, b) _mm_and_si128(a, b)
+#define PNG_PX_ADD(a, b) _mm_add_epi8(a, b)
+// floor((a + b) / 2): pavgb rounds up, so remove the carried 1
+#define PNG_PX_AVG(a, b) _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)))
+
+static inline png_px_t PNGPaethSIMD(png_px_t a8, png_px_t b8, png_px_t c8)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i a = _mm_unpacklo_epi8(a8, zero);
+    __m128i b = _mm_unpacklo_epi8(b8, zero);
+    __m128i c = _mm_unpacklo_epi8(c8, zero);
+    __m128i pa = _mm_sub_epi16(b, c);           // |p - a| = |b - c|
+    __m128i pb = _mm_sub_epi16(a, c);           // |p - b| = |a - c|
+    __m128i pc = _mm_add_epi16(pa, pb);         // |p - c| = |a + b - 2c|
+    pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+    pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+    pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+    __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+    // ties favor a over b over c
+    __m128i mb = _mm_cmpeq_epi16(smallest, pb);
+    __m128i ma = _mm_cmpeq_epi16(smallest, pa);
+    __m128i nearest = _mm_or_si128(_mm_and_si128(mb, b), _mm_andnot_si128(mb, c));
+    nearest = _mm_or_si128(_mm_and_si128(ma, a), _mm_andnot_si128(ma, nearest));
+    return _mm_packus_epi16(nearest, nearest);
+}
+#else // NEON
+typedef uint8x8_t png_px_t;
+static inline png_px_t PNGLoadPixel(const uint8_t *p, int iBpp)
+{
+    uint32_t u32 = 0;
+    memcpy(&u32, p, iBpp);
+    return vreinterpret_u8_u32(vdup_n_u32(u32));
+}
+static inline void PNGStorePixel(uint8_t *p, png_px_t v, int iBpp)
+{
+    uint32_t u32 = vget_lane_u32(vreinterpret_u32_u8(v), 0);
+    memcpy(p, &u32, iBpp);
+}
+#define PNG_PX_ZERO()    vdup_n_u8(0)
+#define PNG_PX_MASK(bpp) vreinterpret_u8_u32(vdup_n_u32((bpp) == 4 ? 0xffffffffu : 0xffffffu))
+#define PNG_PX_AND(a, b) vand_u8(a, b)
+#define PNG_PX_ADD(a, b) vadd_u8(a, b)
+#define PNG_PX_AVG(a, b) vhadd_u8(a, b)
+
+static inline png_px_t PNGPaethSIMD(png_px_t a, png_px_t b, png_px_t c)
+{
+    uint16x8_t p1 = vaddl_u8(a, b);             // a + b
+    uint16x8_t pc = vaddl_u8(c, c);             // 2c
+    uint16x8_t pa = vabdl_u8(b, c);
+    uint16x8_t pb = vabdl_u8(a, c);
+    pc = vabdq_u16(p1, pc);
+    p1 = vandq_u16(vcleq_u16(pa, pb), vcleq_u16(pa, pc)); // pa <= pb && pa <= pc
+    uint8x8_t use_b = vmovn_u16(vcleq_u16(pb, pc));
+    uint8x8_t use_a = vmovn_u16(p1);
+    return vbsl_u8(use_a, a, vbsl_u8(use_b, b, c));
+}
+#endif // NEON
+
+// Sub is a running sum: 16 bytes (4 or 5 pixels) at a time as a prefix sum
+// with the last pixel of the previous block carried into the first one
+static inline void DeFilterSubSIMD(uint8_t *pCurr, int iPitch, int iBpp)
+{
+    int x = 0;
+    int iStep = (iBpp == 4) ? 16 : 15; // 4 or 5 whole pixels per block
+#ifdef PNG_SIMD_SSE2
+    __m128i carry = _mm_setzero_si128();
+    const __m128i mask = _mm_cvtsi32_si128((iBpp == 4) ? -1 : 0xffffff);
+    for (; x + 16 <= iPitch; x += iStep) {
+        uint8_t ucKeep = pCurr[x + 15]; // start of the next 5-pixel block (3 bpp)
+        __m128i v = _mm_add_epi8(_mm_loadu_si128((const __m128i *)&pCurr[x]), carry);
+        if (iBpp == 4) {
+            v = _mm_add_epi8(v, _mm_slli_si128(v, 4));
+            v = _mm_add_epi8(v, _mm_slli_si128(v, 8));
+        } else {
+            v = _mm_add_epi8(v, _mm_slli_si128(v, 3));
+            v = _mm_add_epi8(v, _mm_slli_si128(v, 6));
+            v = _mm_add_epi8(v, _mm_slli_si128(v, 12));
+        }
+        _mm_storeu_si128((__m128i *)&pCurr[x], v);
+        if (iBpp == 3) pCurr[x + 15] = ucKeep;
+        carry = _mm_and_si128(_mm_srli_si128(v, 12), mask); // last pixel is at byte 12 either way
+    }
+#else // NEON
+    uint8x16_t carry = vdupq_n_u8(0);
+    const uint8x16_t zero = vdupq_n_u8(0);
+    for (; x + 16 <= iPitch; x += iStep) {
+        uint8_t ucKeep = pCurr[x + 15];
+        uint8x16_t v = vaddq_u8(vld1q_u8(&pCurr[x]), carry);
+        if (iBpp == 4) {
+            v = vaddq_u8(v, vextq_u8(zero, v, 12)); // v << 4 bytes
+            v = vaddq_u8(v, vextq_u8(zero, v, 8));  // v << 8 bytes
+            carry = vextq_u8(v, zero, 12);          // last pixel -> lane 0..3
+        } else {
+            v = vaddq_u8(v, vextq_u8(zero, v, 13)); // v << 3 bytes
+            v = vaddq_u8(v, vextq_u8(zero, v, 10)); // v << 6 bytes
+            v = vaddq_u8(v, vextq_u8(zero, v, 4));  // v << 12 bytes
+            carry = vsetq_lane_u8(0, vextq_u8(v, zero, 12), 3); // keep 3 bytes only
+        }
+        vst1q_u8(&pCurr[x], v);
+        if (iBpp == 3) pCurr[x + 15] = ucKeep;
+    }
+#endif
+    for (x = (x == 0) ? iBpp : x; x < iPitch; x++) {
+        pCurr[x] += pCurr[x - iBpp];
+    }
+} /* DeFilterSubSIMD() */
+
+// Avg and Paeth: one pixel per step with 4-byte loads/stores. For 3-byte
+// pixels the predictor is masked to 3 lanes, so the 4th stored byte is the
+// untouched first byte of the next pixel; the last pixel uses a 3-byte copy.
+static inline void DeFilterAvgSIMD(uint8_t *pCurr, const uint8_t *pPrev, int iPitch, int iBpp)
+{
+    const png_px_t mask = PNG_PX_MASK(iBpp);
+    png_px_t a = PNG_PX_ZERO();
+    uint8_t *pEnd = &pCurr[iPitch];
+    while (pCurr + 4 <= pEnd) {
+        png_px_t b = PNGLoadPixel(pPrev, 4);
+        a = PNG_PX_ADD(PNGLoadPixel(pCurr, 4), PNG_PX_AND(PNG_PX_AVG(a, b), mask));
+        PNGStorePixel(pCurr, a, 4);
+        pCurr += iBpp;
+        pPrev += iBpp;
+    }
+    if (pCurr < pEnd) {
+        png_px_t b = PNGLoadPixel(pPrev, iBpp);
+        a = PNG_PX_ADD(PNGLoadPixel(pCurr, iBpp), PNG_PX_AVG(a, b));
+        PNGStorePixel(pCurr, a, iBpp);
+    }
+} /* DeFilterAvgSIMD() */
+
+static inline void DeFilterPaethSIMD(uint8_t *pCurr, const uint8_t *pPrev, int iPitch, int iBpp)
+{
+    const png_px_t mask = PNG_PX_MASK(iBpp);
+    png_px_t a = PNG_PX_ZERO(), c = PNG_PX_ZERO();
+    uint8_t *pEnd = &pCurr[iPitch];
+    while (pCurr + 4 <= pEnd) {
+        png_px_t b = PNGLoadPixel(pPrev, 4);
+        a = PNG_PX_ADD(PNGLoadPixel(pCurr, 4), PNG_PX_AND(PNGPaethSIMD(a, b, c), mask));
+        PNGStorePixel(pCurr, a, 4);
+        c = b;
+        pCurr += iBpp;
+        pPrev += iBpp;
+    }
+    if (pCurr < pEnd) {
+        png_px_t b = PNGLoadPixel(pPrev, iBpp);
+        a = PNG_PX_ADD(PNGLoadPixel(pCurr, iBpp), PNGPaethSIMD(a, b, c));
+        PNGStorePixel(pCurr, a, iBpp);
+    }
+} /* DeFilterPaethSIMD() */
+#endif // PNG_SIMD_SSE2 || PNG_SIMD_NEON
+//
 // De-filter the current line of pixels
 //
 PNG_STATIC void DeFilter(uint8_t *pCurr, uint8_t *pPrev, int iWidth, int iPitch)
@@ -562,6 +754,35 @@ PNG_STATIC void DeFilter(uint8_t *pCurr, uint8_t *pPrev, int iWidth, int iPitch)
         iBpp = iPitch / iWidth;
     
     pPrev++; // skip filter of previous line
+#ifdef PNG_HAS_SIMD_UNFILTER
+    if (ucFilter == PNG_FILTER_UP) {
+        DeFilterUpSIMD(pCurr, pPrev, iPitch);
+        return;
+    }
+    // RGB/RGBA 8-bit; constant pixel sizes let the helpers inline to fixed-size loads
+    if (iBpp == 4) {
+        switch (ucFilter) {
+            case PNG_FILTER_SUB:
+                DeFilterSubSIMD(pCurr, iPitch, 4);
+                return;
+            case PNG_FILTER_AVG:
+                DeFilterAvgSIMD(pCurr, pPrev, iPitch, 4);
+                return;
+            case PNG_FILTER_PAETH:
+                DeFilterPaethSIMD(pCurr, pPrev, iPitch, 4);
+                return;
+        }
+    } else if (iBpp == 3) { // Avg: the scalar loop's 3 independent byte chains win here
+        switch (ucFilter) {
+            case PNG_FILTER_SUB:
+                DeFilterSubSIMD(pCurr, iPitch, 3);
+                return;
+            case PNG_FILTER_PAETH:
+                DeFilterPaethSIMD(pCurr, pPrev, iPitch, 3);
+                return;
+        }
+    }
+#endif // PNG_HAS_SIMD_UNFILTER
     switch (ucFilter) { // switch on filter type
         case PNG_FILTER_NONE:
             // nothing to do :)
@@ -0,0 +1,23 @@
+//
+// png_simd.h
+// Selects the SIMD path used by the PNG unfilters (png.inl) and the
+// inflate match copy (inffast.c).
+//
+// SSE2 on x86/x64 hosts, NEON on ARMv7-A/ARMv8 hosts; everything else
+// (ESP32/ESP32-C6 RISC-V, Cortex-M) keeps the original scalar code.
+// Define PNG_NO_SIMD to force the scalar code on any target (benchmarks).
+//
+#ifndef __PNG_SIMD__
+#define __PNG_SIMD__
+
+#ifndef PNG_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PNG_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PNG_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif // !PNG_NO_SIMD
+
+#endif // __PNG_SIMD__
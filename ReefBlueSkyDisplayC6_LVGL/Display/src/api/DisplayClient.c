@@ -5,6 +5,7 @@
 #include "esp_http_client.h"
 #include "esp_log.h"
 #include <string.h>
+#include <strings.h>
 #include "esp_crt_bundle.h"
 #include "esp_system.h"
 #include "esp_netif.h"
@@ -18,14 +19,19 @@
 #define FIXED_SERVER_URL "https://iot.reefbluesky.com.br/api/v1"
 #define DISPLAY_PING_URL "https://iot.reefbluesky.com.br/api/display/ping"
 
+// stream SSE: backend manda keepalive a cada 25 s, então 60 s sem nada = conexão morta
+#define SUMMARY_STREAM_TIMEOUT_MS 60000
+
 static const char *TAG = "DisplayClient";
 
 static char http_body_buf[4096];
 static int  http_body_len = 0;
+static char http_etag_buf[48];
 
 typedef struct {
     char device_id[32];
     char name[64];
+    char etag[48];   // último ETag do kh-summary (If-None-Match)
 } kh_device_info_t;
 
 static kh_device_info_t g_kh_devices[8];
@@ -39,6 +45,13 @@ static char g_main_device_id[32] = {0};
 static esp_err_t http_event_handler(esp_http_client_event_t *evt)
 {
     switch (evt->event_id) {
+    case HTTP_EVENT_ON_HEADER:
+        if (evt->header_key && evt->header_value &&
+            strcasecmp(evt->header_key, "ETag") == 0) {
+            strncpy(http_etag_buf, evt->header_value, sizeof(http_etag_buf) - 1);
+            http_etag_buf[sizeof(http_etag_buf) - 1] = '\0';
+        }
+        break;
     case HTTP_EVENT_ON_DATA:
         if (!esp_http_client_is_chunked_response(evt->client)) {
             int copy_len = evt->data_len;
@@ -888,6 +901,7 @@ esp_err_t display_client_load_kh_devices(void)
         const char *nm = (j_name && cJSON_IsString(j_name)) ? j_name->valuestring : j_id->valuestring;
         strncpy(dst->name, nm, sizeof(dst->name) - 1);
         dst->name[sizeof(dst->name) - 1] = 0;
+        dst->etag[0] = 0;
     }
 
     cJSON_Delete(root);
@@ -895,12 +909,44 @@ esp_err_t display_client_load_kh_devices(void)
     return (g_kh_device_count > 0) ? ESP_OK : ESP_FAIL;
 }
 
-esp_err_t display_client_fetch_kh_summary_for(const char *device_id,
-                                              kh_summary_t *out)
+// Preenche out a partir do objeto "data" do kh-summary (GET ou evento SSE)
+static void parse_kh_summary_data(cJSON *data, kh_summary_t *out)
 {
-    if (!out || !device_id || !device_id[0]) return ESP_ERR_INVALID_ARG;
     memset(out, 0, sizeof(*out));
 
+    if (!data || !cJSON_IsObject(data)) {
+        out->has_data = false;
+        return;
+    }
+
+    cJSON *kh       = cJSON_GetObjectItem(data, "kh");
+    cJSON *khMin24h = cJSON_GetObjectItem(data, "khMin24h");
+    cJSON *khMax24h = cJSON_GetObjectItem(data, "khMax24h");
+    cJSON *khVar24h = cJSON_GetObjectItem(data, "khVar24h");
+    cJSON *health   = cJSON_GetObjectItem(data, "health");
+    cJSON *hGreen   = cJSON_GetObjectItem(data, "khHealthGreenMaxDev");
+    cJSON *hYellow  = cJSON_GetObjectItem(data, "khHealthYellowMaxDev");
+    cJSON *tsMs     = cJSON_GetObjectItem(data, "timestampMs");
+
+    out->kh         = (kh       && cJSON_IsNumber(kh))       ? (float)kh->valuedouble       : 0.0f;
+    out->kh_min_24h = (khMin24h && cJSON_IsNumber(khMin24h)) ? (float)khMin24h->valuedouble : out->kh;
+    out->kh_max_24h = (khMax24h && cJSON_IsNumber(khMax24h)) ? (float)khMax24h->valuedouble : out->kh;
+    out->kh_var_24h = (khVar24h && cJSON_IsNumber(khVar24h)) ? (float)khVar24h->valuedouble : 0.0f;
+    out->health     = (health   && cJSON_IsNumber(health))   ? (float)health->valuedouble   : 0.0f;
+    out->health_green_max_dev  = (hGreen  && cJSON_IsNumber(hGreen))  ? (float)hGreen->valuedouble  : 0.2f;
+    out->health_yellow_max_dev = (hYellow && cJSON_IsNumber(hYellow)) ? (float)hYellow->valuedouble : 0.5f;
+
+    out->ts       = (tsMs && cJSON_IsNumber(tsMs)) ? (time_t)(tsMs->valuedouble / 1000.0) : 0;
+    out->has_data = true;
+}
+
+static esp_err_t fetch_kh_summary(const char *device_id,
+                                  kh_summary_t *out,
+                                  char *etag, size_t etag_len,
+                                  bool *changed)
+{
+    if (changed) *changed = true;
+
     const char *token = jwt_handler_get_user_token();
     if (!token || !token[0]) {
         ESP_LOGE(TAG, "No JWT token available");
@@ -928,9 +974,13 @@ esp_err_t display_client_fetch_kh_summary_for(const char *device_id,
     char auth_hdr[512];
     snprintf(auth_hdr, sizeof(auth_hdr), "Bearer %s", token);
     esp_http_client_set_header(client, "Authorization", auth_hdr);
+    if (etag && etag[0]) {
+        esp_http_client_set_header(client, "If-None-Match", etag);
+    }
 
     http_body_len = 0;
     http_body_buf[0] = '\0';
+    http_etag_buf[0] = '\0';
 
     esp_err_t err = esp_http_client_perform(client);
     if (err != ESP_OK) {
@@ -945,6 +995,13 @@ esp_err_t display_client_fetch_kh_summary_for(const char *device_id,
 
     esp_http_client_cleanup(client);
 
+    if (status == 304) {
+        if (changed) *changed = false;
+        return ESP_OK;
+    }
+
+    memset(out, 0, sizeof(*out));
+
     char resp[1024];
     int to_copy = http_body_len > (int)sizeof(resp) - 1 ? (int)sizeof(resp) - 1 : http_body_len;
     memcpy(resp, http_body_buf, to_copy);
@@ -968,29 +1025,266 @@ esp_err_t display_client_fetch_kh_summary_for(const char *device_id,
         return ESP_OK;
     }
 
-    cJSON *kh       = cJSON_GetObjectItem(data, "kh");
-    cJSON *khMin24h = cJSON_GetObjectItem(data, "khMin24h");
-    cJSON *khMax24h = cJSON_GetObjectItem(data, "khMax24h");
-    cJSON *khVar24h = cJSON_GetObjectItem(data, "khVar24h");
-    cJSON *health   = cJSON_GetObjectItem(data, "health");
-    cJSON *hGreen   = cJSON_GetObjectItem(data, "khHealthGreenMaxDev");
-    cJSON *hYellow  = cJSON_GetObjectItem(data, "khHealthYellowMaxDev");
+    parse_kh_summary_data(data, out);
 
-    out->kh         = (kh       && cJSON_IsNumber(kh))       ? (float)kh->valuedouble       : 0.0f;
-    out->kh_min_24h = (khMin24h && cJSON_IsNumber(khMin24h)) ? (float)khMin24h->valuedouble : out->kh;
-    out->kh_max_24h = (khMax24h && cJSON_IsNumber(khMax24h)) ? (float)khMax24h->valuedouble : out->kh;
-    out->kh_var_24h = (khVar24h && cJSON_IsNumber(khVar24h)) ? (float)khVar24h->valuedouble : 0.0f;
-    out->health     = (health   && cJSON_IsNumber(health))   ? (float)health->valuedouble   : 0.0f;
-    out->health_green_max_dev  = (hGreen  && cJSON_IsNumber(hGreen))  ? (float)hGreen->valuedouble  : 0.2f;
-    out->health_yellow_max_dev = (hYellow && cJSON_IsNumber(hYellow)) ? (float)hYellow->valuedouble : 0.5f;
-
-    out->ts       = 0;
-    out->has_data = true;
+    // só guarda o ETag de respostas válidas
+    if (etag && etag_len > 0) {
+        strncpy(etag, http_etag_buf, etag_len - 1);
+        etag[etag_len - 1] = '\0';
+    }
 
     cJSON_Delete(root);
     return ESP_OK;
 }
 
+esp_err_t display_client_fetch_kh_summary_for(const char *device_id,
+                                              kh_summary_t *out)
+{
+    if (!out || !device_id || !device_id[0]) return ESP_ERR_INVALID_ARG;
+    memset(out, 0, sizeof(*out));
+
+    return fetch_kh_summary(device_id, out, NULL, 0, NULL);
+}
+
+esp_err_t display_client_fetch_kh_summary_cond(const char *device_id,
+                                               kh_summary_t *out,
+                                               bool *changed)
+{
+    if (!out || !changed || !device_id || !device_id[0]) return ESP_ERR_INVALID_ARG;
+
+    int idx = display_client_find_kh_device(device_id);
+    if (idx < 0) {
+        *changed = true;
+        return display_client_fetch_kh_summary_for(device_id, out);
+    }
+
+    kh_device_info_t *dev = &g_kh_devices[idx];
+    return fetch_kh_summary(device_id, out, dev->etag, sizeof(dev->etag), changed);
+}
+
+int display_client_fetch_kh_history(const char *device_id, time_t since,
+                                    kh_history_point_t *out, int max)
+{
+    if (!device_id || !device_id[0] || !out || max <= 0) return -1;
+
+    const char *token = jwt_handler_get_user_token();
+    if (!token || !token[0]) {
+        ESP_LOGE(TAG, "kh_history: sem JWT token");
+        return -1;
+    }
+
+    // resposta compacta: {"t":[s,...],"kh":[x,...]}; ~16 bytes/ponto no http_body_buf
+    int limit = max;
+    if (limit > (int)(sizeof(http_body_buf) / 16)) limit = sizeof(http_body_buf) / 16;
+
+    char url[256];
+    snprintf(url, sizeof(url),
+             "%s/user/devices/%s/display/kh-history?since=%lld&limit=%d",
+             FIXED_SERVER_URL, device_id, (long long)since, limit);
+
+    esp_http_client_config_t cfg = {
+        .url = url,
+        .method = HTTP_METHOD_GET,
+        .timeout_ms = 8000,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+        .event_handler = http_event_handler,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&cfg);
+    if (!client) return -1;
+
+    char auth_hdr[512];
+    snprintf(auth_hdr, sizeof(auth_hdr), "Bearer %s", token);
+    esp_http_client_set_header(client, "Authorization", auth_hdr);
+    esp_http_client_set_header(client, "Accept-Encoding", "identity");
+
+    http_body_len = 0;
+    http_body_buf[0] = '\0';
+
+    esp_err_t err = esp_http_client_perform(client);
+    int status = esp_http_client_get_status_code(client);
+    esp_http_client_cleanup(client);
+
+    if (err != ESP_OK || status != 200) {
+        ESP_LOGW(TAG, "kh_history: falhou (%s, status=%d)", esp_err_to_name(err), status);
+        return -1;
+    }
+
+    cJSON *root = cJSON_Parse(http_body_buf);
+    if (!root) {
+        ESP_LOGE(TAG, "kh_history: JSON parse error");
+        return -1;
+    }
+
+    int n = 0;
+    cJSON *data = cJSON_GetObjectItem(root, "data");
+    cJSON *j_t  = data ? cJSON_GetObjectItem(data, "t")  : NULL;
+    cJSON *j_kh = data ? cJSON_GetObjectItem(data, "kh") : NULL;
+    if (cJSON_IsArray(j_t) && cJSON_IsArray(j_kh)) {
+        cJSON *t  = j_t->child;
+        cJSON *kh = j_kh->child;
+        while (t && kh && n < max) {
+            if (cJSON_IsNumber(t) && cJSON_IsNumber(kh)) {
+                out[n].ts = (time_t)t->valuedouble;
+                out[n].kh = (float)kh->valuedouble;
+                n++;
+            }
+            t  = t->next;
+            kh = kh->next;
+        }
+    }
+
+    cJSON_Delete(root);
+    ESP_LOGI(TAG, "kh_history %s since=%lld -> %d pontos", device_id, (long long)since, n);
+    return n;
+}
+
+// Processa um evento SSE completo ("event:" + "data:" já acumulados)
+static void dispatch_summary_event(const char *event, char *data,
+                                   kh_summary_delta_cb_t cb, void *ctx)
+{
+    if (event[0] && strcmp(event, "summary") != 0) {
+        return; // outros eventos são ignorados por enquanto
+    }
+
+    cJSON *root = cJSON_Parse(data);
+    if (!root) {
+        ESP_LOGW(TAG, "summary stream: JSON parse error");
+        return;
+    }
+
+    cJSON *j_id   = cJSON_GetObjectItem(root, "deviceId");
+    cJSON *j_data = cJSON_GetObjectItem(root, "data");
+    if (cJSON_IsString(j_id) && j_id->valuestring) {
+        kh_summary_t summary;
+        parse_kh_summary_data(j_data, &summary);
+
+        // invalida o ETag do polling: o stream já trouxe dado mais novo
+        int idx = display_client_find_kh_device(j_id->valuestring);
+        if (idx >= 0) {
+            g_kh_devices[idx].etag[0] = '\0';
+        }
+
+        ESP_LOGI(TAG, "summary stream: %s KH=%.2f", j_id->valuestring, summary.kh);
+        cb(j_id->valuestring, &summary, ctx);
+    }
+
+    cJSON_Delete(root);
+}
+
+esp_err_t display_client_stream_kh_summaries(kh_summary_delta_cb_t cb, void *ctx)
+{
+    if (!cb) return ESP_ERR_INVALID_ARG;
+
+    const char *token = jwt_handler_get_user_token();
+    if (!token || !token[0]) {
+        ESP_LOGE(TAG, "summary stream: sem JWT token");
+        return ESP_FAIL;
+    }
+
+    char url[256];
+    snprintf(url, sizeof(url), "%s/user/display/kh-summary/stream", FIXED_SERVER_URL);
+
+    // sem event_handler: o corpo é lido direto com esp_http_client_read,
+    // sem disputar o http_body_buf com as outras chamadas
+    esp_http_client_config_t cfg = {
+        .url = url,
+        .method = HTTP_METHOD_GET,
+        .timeout_ms = SUMMARY_STREAM_TIMEOUT_MS,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&cfg);
+    if (!client) {
+        ESP_LOGE(TAG, "summary stream: falha ao init http client");
+        return ESP_FAIL;
+    }
+
+    char auth_hdr[512];
+    snprintf(auth_hdr, sizeof(auth_hdr), "Bearer %s", token);
+    esp_http_client_set_header(client, "Authorization", auth_hdr);
+    esp_http_client_set_header(client, "Accept", "text/event-stream");
+    esp_http_client_set_header(client, "Accept-Encoding", "identity");
+    esp_http_client_set_header(client, "Cache-Control", "no-cache");
+
+    esp_err_t err = esp_http_client_open(client, 0);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "summary stream: open falhou %s", esp_err_to_name(err));
+        esp_http_client_cleanup(client);
+        return err;
+    }
+
+    esp_http_client_fetch_headers(client);
+    int status = esp_http_client_get_status_code(client);
+    ESP_LOGI(TAG, "summary stream: status=%d", status);
+
+    if (status != 200) {
+        esp_http_client_close(client);
+        esp_http_client_cleanup(client);
+        return (status == 404) ? ESP_ERR_NOT_SUPPORTED : ESP_FAIL;
+    }
+
+    static char line[1024];
+    static char data[1024];
+    char event[32] = {0};
+    int  line_len  = 0;
+    int  data_len  = 0;
+    char chunk[256];
+
+    err = ESP_OK;
+    while (1) {
+        int n = esp_http_client_read(client, chunk, sizeof(chunk));
+        if (n < 0) {
+            ESP_LOGW(TAG, "summary stream: erro de leitura (%d)", n);
+            err = ESP_FAIL;
+            break;
+        }
+        if (n == 0) {
+            ESP_LOGW(TAG, "summary stream: conexão encerrada pelo servidor");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            char c = chunk[i];
+            if (c != '\n') {
+                if (c != '\r' && line_len < (int)sizeof(line) - 1) {
+                    line[line_len++] = c;
+                }
+                continue;
+            }
+            line[line_len] = '\0';
+
+            if (line_len == 0) {
+                // linha em branco fecha o evento
+                if (data_len > 0) {
+                    data[data_len] = '\0';
+                    dispatch_summary_event(event, data, cb, ctx);
+                }
+                event[0] = '\0';
+                data_len = 0;
+            } else if (strncmp(line, "event:", 6) == 0) {
+                const char *v = line + 6;
+                while (*v == ' ') v++;
+                strncpy(event, v, sizeof(event) - 1);
+                event[sizeof(event) - 1] = '\0';
+            } else if (strncmp(line, "data:", 5) == 0) {
+                const char *v = line + 5;
+                while (*v == ' ') v++;
+                int vlen = strlen(v);
+                if (data_len + vlen < (int)sizeof(data) - 1) {
+                    memcpy(data + data_len, v, vlen);
+                    data_len += vlen;
+                }
+            }
+            // ": ping" (comentário) e "retry:" são só keepalive
+
+            line_len = 0;
+        }
+    }
+
+    esp_http_client_close(client);
+    esp_http_client_cleanup(client);
+    return err;
+}
+
 
 int display_client_get_kh_device_count(void)
 {
@@ -1003,6 +1297,15 @@ const char *display_client_get_kh_device_id(int index)
     return g_kh_devices[index].device_id;
 }
 
+int display_client_find_kh_device(const char *device_id)
+{
+    if (!device_id) return -1;
+    for (int i = 0; i < g_kh_device_count; i++) {
+        if (strcmp(g_kh_devices[i].device_id, device_id) == 0) return i;
+    }
+    return -1;
+}
+
 const char *display_client_get_kh_device_name(int index)
 {
     if (index < 0 || index >= g_kh_device_count) return NULL;
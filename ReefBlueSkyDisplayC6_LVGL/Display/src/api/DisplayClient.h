@@ -26,6 +26,11 @@ typedef struct {
     time_t ts;
 } kh_summary_t;
 
+typedef struct {
+    time_t ts;
+    float  kh;
+} kh_history_point_t;
+
 
 // login + registro do LCD
 esp_err_t display_client_login_and_register(void);
@@ -44,10 +49,38 @@ void        display_client_set_main_device_id(const char *id);
 const char *display_client_get_main_device_id(void);
 
 
+int         display_client_find_kh_device(const char *device_id); // -1 se não achar
+
+
 // resumo KH para um deviceId específico
 esp_err_t   display_client_fetch_kh_summary_for(const char *device_id,
                                                 kh_summary_t *out);
 
+// resumo KH condicional (ETag/If-None-Match guardado por device).
+// 304 -> ESP_OK com *changed=false e out intocado.
+esp_err_t   display_client_fetch_kh_summary_cond(const char *device_id,
+                                                 kh_summary_t *out,
+                                                 bool *changed);
+
+// Histórico de KH mais novo que since (epoch s), do mais antigo ao mais novo:
+// os primeiros max pontos depois de since (até 256 por pedido). Menos que
+// max = não há mais; senão, pedir de novo com since = ts do último ponto.
+// Retorna a quantidade de pontos em out, ou -1 em erro.
+int         display_client_fetch_kh_history(const char *device_id,
+                                            time_t since,
+                                            kh_history_point_t *out,
+                                            int max);
+
+// Stream SSE com os deltas de resumo de todos os KH do usuário.
+// Bloqueia enquanto a conexão estiver aberta, chamando cb a cada evento.
+// ESP_ERR_NOT_SUPPORTED se o backend não tiver o endpoint de stream.
+typedef void (*kh_summary_delta_cb_t)(const char *device_id,
+                                      const kh_summary_t *summary,
+                                      void *ctx);
+
+esp_err_t   display_client_stream_kh_summaries(kh_summary_delta_cb_t cb,
+                                               void *ctx);
+
                                                 
 esp_err_t   display_client_ping_lcd(const char *main_device_id);                                                
 
@@ -0,0 +1,139 @@
+// KhDigits.c
+#include "KhDigits.h"
+#include "kh_digits_atlas.h"
+#include <string.h>
+
+#if LV_COLOR_DEPTH != 16 || KH_ATLAS_COLOR_16_SWAP != LV_COLOR_16_SWAP
+    #error "kh_digits_atlas.c não bate com lv_conf.h: rode gen_kh_atlas.py"
+#endif
+
+#define MY_CLASS &kh_digits_class
+
+// Largura fixa: 5 dígitos tabulares cobrem "00.00"; texto centralizado dentro
+#define KH_DIGITS_WIDTH  (5 * KH_ATLAS_DIGIT_W)
+
+typedef struct {
+    lv_obj_t obj;
+    uint8_t  count;
+    int8_t   glyph[KH_DIGITS_MAX_CHARS];  // índice em kh_atlas_glyphs
+    int16_t  x[KH_DIGITS_MAX_CHARS];      // x da célula, relativo ao objeto
+} kh_digits_t;
+
+static void kh_digits_constructor(const lv_obj_class_t *class_p, lv_obj_t *obj);
+static void kh_digits_event(const lv_obj_class_t *class_p, lv_event_t *e);
+
+static const lv_obj_class_t kh_digits_class = {
+    .base_class     = &lv_obj_class,
+    .constructor_cb = kh_digits_constructor,
+    .event_cb       = kh_digits_event,
+    .width_def      = KH_DIGITS_WIDTH,
+    .height_def     = KH_ATLAS_HEIGHT,
+    .instance_size  = sizeof(kh_digits_t),
+};
+
+static void kh_digits_constructor(const lv_obj_class_t *class_p, lv_obj_t *obj)
+{
+    LV_UNUSED(class_p);
+    kh_digits_t *d = (kh_digits_t *)obj;
+    d->count = 0;
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+}
+
+static void cell_area(const kh_digits_t *d, int i, lv_area_t *out)
+{
+    lv_obj_get_coords((lv_obj_t *)&d->obj, out);
+    out->x1 += d->x[i];
+    out->x2  = out->x1 + kh_atlas_glyphs[d->glyph[i]].width - 1;
+    out->y2  = out->y1 + KH_ATLAS_HEIGHT - 1;
+}
+
+// Copia as corridas RLE de cada célula que cruza o clip direto no draw buffer
+static void draw_glyphs(kh_digits_t *d, lv_draw_ctx_t *draw_ctx)
+{
+    const lv_area_t *buf_a = draw_ctx->buf_area;
+    lv_coord_t stride = lv_area_get_width(buf_a);
+
+    for (int i = 0; i < d->count; i++) {
+        const kh_atlas_glyph_t *g = &kh_atlas_glyphs[d->glyph[i]];
+        lv_area_t cell, a;
+        cell_area(d, i, &cell);
+        if (!_lv_area_intersect(&a, &cell, draw_ctx->clip_area)) continue;
+
+        for (lv_coord_t y = a.y1; y <= a.y2; y++) {
+            const uint16_t *rle = &kh_atlas_rle[g->rle_start + g->row_ofs[y - cell.y1]];
+            lv_color_t *dst = (lv_color_t *)draw_ctx->buf
+                            + (y - buf_a->y1) * stride + (a.x1 - buf_a->x1);
+            lv_coord_t x = cell.x1;
+
+            while (x <= a.x2) {
+                lv_coord_t n = rle[0];
+                uint16_t   c = rle[1];
+                rle += 2;
+
+                lv_coord_t s = LV_MAX(x, a.x1);
+                lv_coord_t e = LV_MIN(x + n - 1, a.x2);
+                for (; s <= e; s++) (dst++)->full = c;
+                x += n;
+            }
+        }
+    }
+}
+
+static void kh_digits_event(const lv_obj_class_t *class_p, lv_event_t *e)
+{
+    LV_UNUSED(class_p);
+
+    lv_res_t res = lv_obj_event_base(MY_CLASS, e);
+    if (res != LV_RES_OK) return;
+
+    if (lv_event_get_code(e) == LV_EVENT_DRAW_MAIN) {
+        draw_glyphs((kh_digits_t *)lv_event_get_target(e), lv_event_get_draw_ctx(e));
+    }
+}
+
+lv_obj_t *kh_digits_create(lv_obj_t *parent)
+{
+    lv_obj_t *obj = lv_obj_class_create_obj(MY_CLASS, parent);
+    lv_obj_class_init_obj(obj);
+    return obj;
+}
+
+void kh_digits_set_text(lv_obj_t *obj, const char *text)
+{
+    if (!obj || !text) return;
+    kh_digits_t *d = (kh_digits_t *)obj;
+
+    kh_digits_t next;
+    next.count = 0;
+    int total = 0;
+    for (const char *p = text; *p && next.count < KH_DIGITS_MAX_CHARS; p++) {
+        unsigned char ch = (unsigned char)*p;
+        int8_t idx = (ch >= 32 && ch < 128) ? kh_atlas_map[ch - 32] : -1;
+        if (idx < 0) idx = kh_atlas_map[' ' - 32];
+        next.glyph[next.count] = idx;
+        next.x[next.count]     = (int16_t)total;
+        total += kh_atlas_glyphs[idx].width;
+        next.count++;
+    }
+
+    int16_t x0 = (int16_t)((lv_obj_get_width(obj) - total) / 2);
+    for (int i = 0; i < next.count; i++) next.x[i] += x0;
+
+    // Invalida só as células que mudaram (glifo ou posição), antigas e novas
+    int n = LV_MAX(d->count, next.count);
+    for (int i = 0; i < n; i++) {
+        bool old_ok = i < d->count;
+        bool new_ok = i < next.count;
+        if (old_ok && new_ok && d->glyph[i] == next.glyph[i] && d->x[i] == next.x[i]) continue;
+
+        lv_area_t a;
+        if (old_ok) { cell_area(d, i, &a); lv_obj_invalidate_area(obj, &a); }
+        if (new_ok) {
+            d->glyph[i] = next.glyph[i];
+            d->x[i]     = next.x[i];
+            cell_area(d, i, &a);
+            lv_obj_invalidate_area(obj, &a);
+        }
+    }
+    d->count = next.count;
+}
@@ -0,0 +1,25 @@
+// KhDigits.h
+// Widget do número grande de dKH desenhado a partir do atlas RGB565/RLE
+// gerado por gen_kh_atlas.py (assets/kh_digits_atlas.c).
+// Não passa pelo motor de fontes: copia as corridas do atlas direto no draw
+// buffer e, ao trocar o valor, invalida só as células de glifo que mudaram.
+#pragma once
+
+#include <stdint.h>
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KH_DIGITS_MAX_CHARS 8
+
+// Cria o widget (mesmo tamanho de linha do label montserrat_bold_32)
+lv_obj_t *kh_digits_create(lv_obj_t *parent);
+
+// Troca o texto; caracteres fora do atlas viram espaço
+void      kh_digits_set_text(lv_obj_t *obj, const char *text);
+
+#ifdef __cplusplus
+}
+#endif
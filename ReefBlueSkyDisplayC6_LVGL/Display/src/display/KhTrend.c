@@ -0,0 +1,243 @@
+// KhTrend.c
+#include "KhTrend.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <string.h>
+#include <math.h>
+
+static const char *TAG = "KhTrend";
+
+#define KH_TREND_BUCKET_S   (KH_TREND_WINDOW_S / KH_TREND_WIDTH)
+#define KH_TREND_MARGIN     0.10f   // folga em dKH acima/abaixo da escala
+
+#define COLOR_BG    lv_color_hex(0x000000)
+#define COLOR_LINE  lv_color_hex(0x00B4FF)
+#define COLOR_SWEEP lv_color_hex(0x303030)
+
+// Uma coluna = bucket de KH_TREND_BUCKET_S segundos (min/max preservados)
+typedef struct {
+    int32_t  bucket;     // ts / KH_TREND_BUCKET_S; 0 = vazio
+    uint16_t min_centi;
+    uint16_t max_centi;
+} trend_col_t;
+
+typedef struct {
+    char        device_id[32];
+    time_t      last_ts;
+    int32_t     newest_bucket;
+    trend_col_t cols[KH_TREND_WIDTH];   // ring indexado por bucket % largura
+} trend_dev_t;
+
+static trend_dev_t  g_devs[KH_TREND_MAX_DEVICES];
+static trend_dev_t *g_shown = NULL;
+
+static lv_obj_t   *g_canvas = NULL;
+static lv_color_t  g_buf[LV_CANVAS_BUF_SIZE_TRUE_COLOR(KH_TREND_WIDTH, KH_TREND_HEIGHT)
+                         / sizeof(lv_color_t)];
+static float       g_lo = 0.0f, g_hi = 0.0f;  // escala vertical atual (dKH)
+static int64_t     g_last_render_us = 0;
+static uint8_t     g_dirty[KH_TREND_WIDTH];       // colunas a redesenhar no update
+
+static trend_dev_t *find_dev(const char *device_id, bool create)
+{
+    trend_dev_t *free_slot = NULL;
+    for (int i = 0; i < KH_TREND_MAX_DEVICES; i++) {
+        if (g_devs[i].device_id[0] == '\0') {
+            if (!free_slot) free_slot = &g_devs[i];
+            continue;
+        }
+        if (strcmp(g_devs[i].device_id, device_id) == 0) return &g_devs[i];
+    }
+    if (!create || !free_slot) return NULL;
+
+    memset(free_slot, 0, sizeof(*free_slot));
+    strncpy(free_slot->device_id, device_id, sizeof(free_slot->device_id) - 1);
+    return free_slot;
+}
+
+static bool col_valid(const trend_dev_t *d, int x)
+{
+    const trend_col_t *c = &d->cols[x];
+    // W-1 colunas de dados; a W-ésima é sempre o vão da varredura
+    return c->bucket != 0 && c->bucket > d->newest_bucket - (KH_TREND_WIDTH - 1);
+}
+
+static int kh_to_y(float kh)
+{
+    float t = (kh - g_lo) / (g_hi - g_lo);
+    int y = (KH_TREND_HEIGHT - 1) - (int)lroundf(t * (KH_TREND_HEIGHT - 1));
+    if (y < 0) y = 0;
+    if (y >= KH_TREND_HEIGHT) y = KH_TREND_HEIGHT - 1;
+    return y;
+}
+
+// Escreve direto no buffer do canvas (sem invalidar o objeto inteiro)
+static void draw_col(const trend_dev_t *d, int x)
+{
+    lv_color_t bg = COLOR_BG;
+    int y_top = KH_TREND_HEIGHT, y_bot = -1;
+
+    if (col_valid(d, x)) {
+        y_top = kh_to_y(d->cols[x].max_centi / 100.0f);
+        y_bot = kh_to_y(d->cols[x].min_centi / 100.0f);
+    } else if (x == (d->newest_bucket + 1) % KH_TREND_WIDTH) {
+        bg = COLOR_SWEEP;   // marcador da posição de varredura
+    }
+
+    for (int y = 0; y < KH_TREND_HEIGHT; y++) {
+        g_buf[y * KH_TREND_WIDTH + x] = (y >= y_top && y <= y_bot) ? COLOR_LINE : bg;
+    }
+}
+
+static void invalidate_cols(int x1, int x2)
+{
+    lv_area_t a;
+    lv_obj_get_coords(g_canvas, &a);
+    int32_t left = a.x1;
+    a.x1 = left + x1;
+    a.x2 = left + x2;
+    lv_obj_invalidate_area(g_canvas, &a);
+}
+
+// Recalcula a escala pelos buckets válidos; retorna true se mudou
+static bool rescale(const trend_dev_t *d)
+{
+    float lo = 1e9f, hi = -1e9f;
+    for (int x = 0; x < KH_TREND_WIDTH; x++) {
+        if (!col_valid(d, x)) continue;
+        float mn = d->cols[x].min_centi / 100.0f;
+        float mx = d->cols[x].max_centi / 100.0f;
+        if (mn < lo) lo = mn;
+        if (mx > hi) hi = mx;
+    }
+    if (lo > hi) { lo = 0.0f; hi = 1.0f; }
+
+    lo -= KH_TREND_MARGIN;
+    hi += KH_TREND_MARGIN;
+    bool changed = (lo != g_lo || hi != g_hi);
+    g_lo = lo;
+    g_hi = hi;
+    return changed;
+}
+
+static void redraw_all(void)
+{
+    if (!g_canvas) return;
+
+    if (!g_shown) {
+        lv_canvas_fill_bg(g_canvas, COLOR_BG, LV_OPA_COVER);
+        return;
+    }
+
+    rescale(g_shown);
+    for (int x = 0; x < KH_TREND_WIDTH; x++) {
+        draw_col(g_shown, x);
+    }
+    lv_obj_invalidate(g_canvas);
+}
+
+void kh_trend_init(lv_obj_t *parent)
+{
+    if (g_canvas || !parent) return;
+
+    g_canvas = lv_canvas_create(parent);
+    lv_canvas_set_buffer(g_canvas, g_buf, KH_TREND_WIDTH, KH_TREND_HEIGHT, LV_IMG_CF_TRUE_COLOR);
+    lv_obj_set_align(g_canvas, LV_ALIGN_CENTER);
+    lv_obj_set_x(g_canvas, -80);   // alinhado com ui_Bar1
+    lv_obj_set_y(g_canvas, 40);    // entre ui_dhkValue e ui_Bar1
+    lv_canvas_fill_bg(g_canvas, COLOR_BG, LV_OPA_COVER);
+}
+
+void kh_trend_add_points(const char *device_id,
+                         const kh_history_point_t *points, int count)
+{
+    if (!device_id || !points || count <= 0) return;
+
+    trend_dev_t *d = find_dev(device_id, true);
+    if (!d) return;
+
+    bool shown = (d == g_shown && g_canvas);
+    int64_t t0 = esp_timer_get_time();
+    bool full = false;
+    bool any  = false;
+    memset(g_dirty, 0, sizeof(g_dirty));
+
+    for (int i = 0; i < count; i++) {
+        const kh_history_point_t *p = &points[i];
+        if (p->ts <= 0 || p->ts <= d->last_ts) continue;   // só pontos novos
+
+        int32_t bucket = (int32_t)(p->ts / KH_TREND_BUCKET_S);
+        if (d->newest_bucket && bucket <= d->newest_bucket - (KH_TREND_WIDTH - 1)) continue;
+
+        int x = bucket % KH_TREND_WIDTH;
+        uint16_t kh = (uint16_t)lroundf(p->kh * 100.0f);
+        trend_col_t *c = &d->cols[x];
+
+        if (c->bucket != bucket) {
+            c->bucket    = bucket;
+            c->min_centi = kh;
+            c->max_centi = kh;
+        } else {
+            if (kh < c->min_centi) c->min_centi = kh;
+            if (kh > c->max_centi) c->max_centi = kh;
+        }
+
+        if (bucket > d->newest_bucket) {
+            // buckets pulados (sem medição) viram vão: limpa essas colunas também
+            int32_t from = d->newest_bucket ? d->newest_bucket + 1 : bucket;
+            if (bucket - from >= KH_TREND_WIDTH) from = bucket - KH_TREND_WIDTH + 1;
+            for (int32_t b = from; b < bucket; b++) g_dirty[b % KH_TREND_WIDTH] = 1;
+            // a coluna que era varredura vira dado; a antiga varredura é redesenhada
+            g_dirty[(d->newest_bucket + 1) % KH_TREND_WIDTH] = 1;
+            d->newest_bucket = bucket;
+        }
+        d->last_ts = p->ts;
+        g_dirty[x] = 1;
+        any = true;
+
+        if (shown && (p->kh < g_lo || p->kh > g_hi)) full = true;  // saiu da escala
+    }
+
+    if (!shown || !any) return;
+
+    if (full) {
+        redraw_all();
+    } else {
+        // só as colunas tocadas + marcador de varredura logo à frente
+        g_dirty[(d->newest_bucket + 1) % KH_TREND_WIDTH] = 1;
+        int run = -1;
+        for (int x = 0; x <= KH_TREND_WIDTH; x++) {
+            if (x < KH_TREND_WIDTH && g_dirty[x]) {
+                draw_col(d, x);
+                if (run < 0) run = x;
+            } else if (run >= 0) {
+                invalidate_cols(run, x - 1);
+                run = -1;
+            }
+        }
+    }
+
+    g_last_render_us = esp_timer_get_time() - t0;
+    ESP_LOGD(TAG, "%s: %d pontos, %s em %lld us", device_id, count,
+             full ? "redesenho completo" : "colunas", (long long)g_last_render_us);
+}
+
+void kh_trend_show(const char *device_id)
+{
+    trend_dev_t *d = device_id ? find_dev(device_id, true) : NULL;
+    if (d == g_shown) return;
+
+    g_shown = d;
+    redraw_all();
+}
+
+time_t kh_trend_last_ts(const char *device_id)
+{
+    trend_dev_t *d = device_id ? find_dev(device_id, false) : NULL;
+    return d ? d->last_ts : 0;
+}
+
+int64_t kh_trend_last_render_us(void)
+{
+    return g_last_render_us;
+}
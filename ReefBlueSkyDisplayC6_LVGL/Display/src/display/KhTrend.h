@@ -0,0 +1,40 @@
+// KhTrend.h
+// Sparkline de tendência do KH no painel principal.
+// Histórico decimado por coluna (min/max por bucket de tempo) em um ring por
+// device; o canvas é desenhado em modo "varredura" (tipo monitor cardíaco):
+// cada ponto novo redesenha só a própria coluna e o marcador à frente.
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+#include "lvgl.h"
+#include "api/DisplayClient.h" // kh_history_point_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KH_TREND_WIDTH      126                   // largura do Bar1
+#define KH_TREND_HEIGHT     22
+#define KH_TREND_WINDOW_S   (7 * 24 * 3600)       // janela exibida: 7 dias
+#define KH_TREND_MAX_DEVICES 8
+
+// Cria o canvas (chamar depois de ui_init, na task do LVGL/UI)
+void   kh_trend_init(lv_obj_t *parent);
+
+// Alimenta o ring do device; se ele estiver na tela, desenha só as colunas tocadas
+void   kh_trend_add_points(const char *device_id,
+                           const kh_history_point_t *points, int count);
+
+// Troca o device exibido (redesenho completo do canvas)
+void   kh_trend_show(const char *device_id);
+
+// Timestamp do ponto mais novo já recebido (0 = nenhum) p/ busca incremental
+time_t kh_trend_last_ts(const char *device_id);
+
+// Duração (us) do último desenho incremental, para medir custo por update
+int64_t kh_trend_last_render_us(void);
+
+#ifdef __cplusplus
+}
+#endif
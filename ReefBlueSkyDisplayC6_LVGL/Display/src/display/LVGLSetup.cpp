@@ -198,7 +198,9 @@ void LVGLSetup::setupDisplay()
     disp_drv.ver_res = LVGL_HEIGHT;
     disp_drv.flush_cb = lvgl_flush_cb;
     disp_drv.draw_buf = &s_draw_buf;
-    disp_drv.full_refresh = 1;   // Igual ao exemplo Arduino: sempre redesenha [file:109]
+    // Refresh parcial: só as áreas invalidadas vão pelo SPI (o sparkline
+    // redesenha uma coluna por medição em vez da tela toda)
+    disp_drv.full_refresh = 0;
 
     s_disp = lv_disp_drv_register(&disp_drv);
 
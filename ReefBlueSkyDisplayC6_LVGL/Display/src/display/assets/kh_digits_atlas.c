@@ -0,0 +1,537 @@
+/*******************************************************************************
+ * GERADO por gen_kh_atlas.py - não editar.
+ * Fonte: montserrat_bold_32.c (4 bpp), chars: "0123456789.,-+ dKH"
+ * Cores: 0xFAFAFA sobre 0x000000, RGB565 (byte swap)
+ * Tamanho: 10844 bytes RLE (bruto seria 29928 bytes)
+ ******************************************************************************/
+
+#include "kh_digits_atlas.h"
+
+const uint16_t kh_atlas_rle[] = {
+    /* '0' */
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0007, 0x0000, 0x0001, 0x2c63, 0x0001, 0xb6b5, 0x0001, 0x5def, 0x0002, 0xdfff, 0x0001, 0xdbde,
+    0x0001, 0x34a5, 0x0001, 0x0842, 0x0007, 0x0000, 0x0005, 0x0000, 0x0001, 0x8a52, 0x0001, 0x5def,
+    0x0008, 0xdfff, 0x0001, 0x59ce, 0x0001, 0x0421, 0x0005, 0x0000, 0x0004, 0x0000, 0x0001, 0x3084,
+    0x000c, 0xdfff, 0x0001, 0x0842, 0x0004, 0x0000, 0x0003, 0x0000, 0x0001, 0x2c63, 0x000e, 0xdfff,
+    0x0001, 0x0421, 0x0003, 0x0000, 0x0002, 0x0000, 0x0001, 0x8210, 0x0006, 0xdfff, 0x0001, 0x59ce,
+    0x0001, 0x3084, 0x0001, 0xb294, 0x0001, 0x5def, 0x0005, 0xdfff, 0x0001, 0x59ce, 0x0003, 0x0000,
+    0x0002, 0x0000, 0x0001, 0xb294, 0x0005, 0xdfff, 0x0001, 0x8a52, 0x0004, 0x0000, 0x0001, 0xb294,
+    0x0005, 0xdfff, 0x0001, 0x0842, 0x0002, 0x0000, 0x0002, 0x0000, 0x0005, 0xdfff, 0x0001, 0x3084,
+    0x0006, 0x0000, 0x0001, 0x59ce, 0x0004, 0xdfff, 0x0001, 0xb6b5, 0x0002, 0x0000, 0x0001, 0x0000,
+    0x0001, 0x0842, 0x0005, 0xdfff, 0x0001, 0x8210, 0x0006, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff,
+    0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x3084, 0x0004, 0xdfff, 0x0001, 0x59ce, 0x0007, 0x0000,
+    0x0001, 0x8210, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x34a5,
+    0x0004, 0xdfff, 0x0001, 0xb294, 0x0008, 0x0000, 0x0001, 0x5def, 0x0004, 0xdfff, 0x0001, 0x8a52,
+    0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0xb6b5, 0x0004, 0xdfff, 0x0001, 0x3084, 0x0008, 0x0000,
+    0x0001, 0x59ce, 0x0004, 0xdfff, 0x0001, 0x2c63, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x59ce,
+    0x0004, 0xdfff, 0x0001, 0x3084, 0x0008, 0x0000, 0x0001, 0x59ce, 0x0004, 0xdfff, 0x0001, 0xae73,
+    0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0xb6b5, 0x0004, 0xdfff, 0x0001, 0x3084, 0x0008, 0x0000,
+    0x0001, 0x59ce, 0x0004, 0xdfff, 0x0001, 0x2c63, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x34a5,
+    0x0004, 0xdfff, 0x0001, 0xb294, 0x0008, 0x0000, 0x0001, 0x5def, 0x0004, 0xdfff, 0x0001, 0x8a52,
+    0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x3084, 0x0004, 0xdfff, 0x0001, 0x59ce, 0x0007, 0x0000,
+    0x0001, 0x8210, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x0842,
+    0x0005, 0xdfff, 0x0001, 0x8210, 0x0006, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff, 0x0002, 0x0000,
+    0x0002, 0x0000, 0x0005, 0xdfff, 0x0001, 0x3084, 0x0006, 0x0000, 0x0001, 0x59ce, 0x0004, 0xdfff,
+    0x0001, 0xb6b5, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0xb294, 0x0005, 0xdfff, 0x0001, 0x8a52,
+    0x0004, 0x0000, 0x0001, 0xb294, 0x0005, 0xdfff, 0x0001, 0x0842, 0x0002, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x8210, 0x0006, 0xdfff, 0x0001, 0x59ce, 0x0001, 0x3084, 0x0001, 0xb294, 0x0001, 0xdbde,
+    0x0005, 0xdfff, 0x0001, 0x59ce, 0x0003, 0x0000, 0x0003, 0x0000, 0x0001, 0x2c63, 0x000e, 0xdfff,
+    0x0001, 0x0421, 0x0003, 0x0000, 0x0004, 0x0000, 0x0001, 0x3084, 0x000c, 0xdfff, 0x0001, 0x0842,
+    0x0004, 0x0000, 0x0005, 0x0000, 0x0001, 0x8a52, 0x0001, 0x5def, 0x0008, 0xdfff, 0x0001, 0x59ce,
+    0x0001, 0x8631, 0x0005, 0x0000, 0x0007, 0x0000, 0x0001, 0x2c63, 0x0001, 0xb6b5, 0x0001, 0x5def,
+    0x0002, 0xdfff, 0x0001, 0xdbde, 0x0001, 0x34a5, 0x0001, 0x0842, 0x0007, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000,
+    /* '1' */
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0004, 0x0000, 0x0001, 0x59ce, 0x0008, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0004, 0x0000,
+    0x0001, 0x59ce, 0x0008, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0004, 0x0000, 0x0001, 0x59ce,
+    0x0008, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0004, 0x0000, 0x0001, 0x59ce, 0x0008, 0xdfff,
+    0x0001, 0x5def, 0x0008, 0x0000, 0x0004, 0x0000, 0x0001, 0x8631, 0x0003, 0x0842, 0x0001, 0xae73,
+    0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff,
+    0x0001, 0x5def, 0x0008, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0x5def,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000,
+    0x0008, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0008, 0x0000,
+    0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842,
+    0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff,
+    0x0001, 0x5def, 0x0008, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0x5def,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000,
+    0x0008, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0008, 0x0000,
+    0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842,
+    0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff,
+    0x0001, 0x5def, 0x0008, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0x5def,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000,
+    0x0008, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0008, 0x0000,
+    0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842,
+    0x0004, 0xdfff, 0x0001, 0x5def, 0x0008, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    /* '2' */
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0005, 0x0000, 0x0001, 0x8631, 0x0001, 0x3084, 0x0001, 0x59ce, 0x0001, 0x5def, 0x0002, 0xdfff,
+    0x0001, 0x5def, 0x0001, 0xb6b5, 0x0001, 0xae73, 0x0001, 0x8210, 0x0007, 0x0000, 0x0003, 0x0000,
+    0x0001, 0x8631, 0x0001, 0x59ce, 0x000a, 0xdfff, 0x0001, 0xae73, 0x0006, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x2c63, 0x000d, 0xdfff, 0x0001, 0x34a5, 0x0005, 0x0000, 0x0001, 0x0000, 0x0001, 0x2c63,
+    0x000f, 0xdfff, 0x0001, 0x2c63, 0x0004, 0x0000, 0x0001, 0x0000, 0x0001, 0x3084, 0x0005, 0xdfff,
+    0x0001, 0x59ce, 0x0001, 0xb294, 0x0001, 0x3084, 0x0001, 0xb294, 0x0001, 0xdbde, 0x0005, 0xdfff,
+    0x0001, 0x5def, 0x0004, 0x0000, 0x0002, 0x0000, 0x0001, 0x8631, 0x0001, 0xdbde, 0x0001, 0xdfff,
+    0x0001, 0xdbde, 0x0001, 0x8631, 0x0005, 0x0000, 0x0001, 0xb294, 0x0005, 0xdfff, 0x0001, 0x0421,
+    0x0003, 0x0000, 0x0004, 0x0000, 0x0001, 0xae73, 0x0001, 0x8210, 0x0006, 0x0000, 0x0001, 0x8210,
+    0x0005, 0xdfff, 0x0001, 0x8631, 0x0003, 0x0000, 0x000d, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631,
+    0x0003, 0x0000, 0x000c, 0x0000, 0x0001, 0x8631, 0x0005, 0xdfff, 0x0004, 0x0000, 0x000c, 0x0000,
+    0x0001, 0x34a5, 0x0004, 0xdfff, 0x0001, 0x59ce, 0x0004, 0x0000, 0x000b, 0x0000, 0x0001, 0x2c63,
+    0x0005, 0xdfff, 0x0001, 0x0842, 0x0004, 0x0000, 0x000a, 0x0000, 0x0001, 0x2c63, 0x0005, 0xdfff,
+    0x0001, 0xb294, 0x0005, 0x0000, 0x0009, 0x0000, 0x0001, 0xae73, 0x0005, 0xdfff, 0x0001, 0xb6b5,
+    0x0006, 0x0000, 0x0008, 0x0000, 0x0001, 0x3084, 0x0005, 0xdfff, 0x0001, 0x59ce, 0x0007, 0x0000,
+    0x0007, 0x0000, 0x0001, 0xb294, 0x0005, 0xdfff, 0x0001, 0xb6b5, 0x0008, 0x0000, 0x0006, 0x0000,
+    0x0001, 0x34a5, 0x0005, 0xdfff, 0x0001, 0x34a5, 0x0009, 0x0000, 0x0005, 0x0000, 0x0001, 0xb6b5,
+    0x0005, 0xdfff, 0x0001, 0x34a5, 0x000a, 0x0000, 0x0004, 0x0000, 0x0001, 0xb6b5, 0x0005, 0xdfff,
+    0x0001, 0xb294, 0x000b, 0x0000, 0x0002, 0x0000, 0x0001, 0x8210, 0x0001, 0x59ce, 0x0005, 0xdfff,
+    0x0001, 0xdbde, 0x0009, 0x8a52, 0x0003, 0x0000, 0x0002, 0x0000, 0x0001, 0x59ce, 0x0010, 0xdfff,
+    0x0003, 0x0000, 0x0002, 0x0000, 0x0011, 0xdfff, 0x0003, 0x0000, 0x0002, 0x0000, 0x0011, 0xdfff,
+    0x0003, 0x0000, 0x0002, 0x0000, 0x0011, 0xdfff, 0x0003, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    /* '3' */
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x5def, 0x000e, 0xdfff, 0x0001, 0x59ce, 0x0004, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x5def, 0x000e, 0xdfff, 0x0001, 0x59ce, 0x0004, 0x0000, 0x0002, 0x0000, 0x0001, 0x5def,
+    0x000e, 0xdfff, 0x0001, 0x59ce, 0x0004, 0x0000, 0x0002, 0x0000, 0x0001, 0x5def, 0x000e, 0xdfff,
+    0x0001, 0x34a5, 0x0004, 0x0000, 0x0002, 0x0000, 0x0009, 0x0842, 0x0001, 0xdbde, 0x0004, 0xdfff,
+    0x0001, 0x59ce, 0x0005, 0x0000, 0x000a, 0x0000, 0x0001, 0x3084, 0x0004, 0xdfff, 0x0001, 0x5def,
+    0x0001, 0x8210, 0x0005, 0x0000, 0x0009, 0x0000, 0x0001, 0x2c63, 0x0005, 0xdfff, 0x0001, 0x0421,
+    0x0006, 0x0000, 0x0008, 0x0000, 0x0001, 0x0842, 0x0005, 0xdfff, 0x0001, 0x0842, 0x0007, 0x0000,
+    0x0007, 0x0000, 0x0001, 0x8631, 0x0005, 0xdfff, 0x0001, 0x8a52, 0x0008, 0x0000, 0x0007, 0x0000,
+    0x0001, 0x5def, 0x0005, 0xdfff, 0x0001, 0x34a5, 0x0001, 0x2c63, 0x0007, 0x0000, 0x0007, 0x0000,
+    0x0008, 0xdfff, 0x0001, 0x5def, 0x0001, 0x0842, 0x0005, 0x0000, 0x0007, 0x0000, 0x000a, 0xdfff,
+    0x0001, 0x0842, 0x0004, 0x0000, 0x0007, 0x0000, 0x000a, 0xdfff, 0x0001, 0x5def, 0x0001, 0x8210,
+    0x0003, 0x0000, 0x000b, 0x0000, 0x0001, 0x8631, 0x0001, 0x34a5, 0x0005, 0xdfff, 0x0001, 0xae73,
+    0x0003, 0x0000, 0x000d, 0x0000, 0x0001, 0xb6b5, 0x0004, 0xdfff, 0x0001, 0xb6b5, 0x0003, 0x0000,
+    0x000d, 0x0000, 0x0001, 0xae73, 0x0004, 0xdfff, 0x0001, 0x59ce, 0x0003, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x8210, 0x0001, 0x0421, 0x0009, 0x0000, 0x0001, 0xb294, 0x0004, 0xdfff, 0x0001, 0xb6b5,
+    0x0003, 0x0000, 0x0002, 0x0000, 0x0001, 0x3084, 0x0001, 0xdfff, 0x0001, 0xb294, 0x0001, 0x0421,
+    0x0006, 0x0000, 0x0001, 0x0842, 0x0005, 0xdfff, 0x0001, 0x3084, 0x0003, 0x0000, 0x0001, 0x0000,
+    0x0001, 0x8210, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0001, 0x34a5, 0x0002, 0x3084, 0x0001, 0xb294,
+    0x0001, 0x59ce, 0x0006, 0xdfff, 0x0001, 0x8631, 0x0003, 0x0000, 0x0001, 0x0000, 0x0001, 0x3084,
+    0x000f, 0xdfff, 0x0001, 0x34a5, 0x0004, 0x0000, 0x0001, 0x0000, 0x0001, 0x59ce, 0x000e, 0xdfff,
+    0x0001, 0x59ce, 0x0005, 0x0000, 0x0002, 0x0000, 0x0001, 0xae73, 0x0001, 0x5def, 0x000b, 0xdfff,
+    0x0001, 0x3084, 0x0006, 0x0000, 0x0004, 0x0000, 0x0001, 0x8631, 0x0001, 0x3084, 0x0001, 0xb6b5,
+    0x0001, 0xdbde, 0x0003, 0xdfff, 0x0001, 0x5def, 0x0001, 0xb6b5, 0x0001, 0xae73, 0x0001, 0x8210,
+    0x0007, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    /* '4' */
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x000b, 0x0000, 0x0001, 0x59ce, 0x0004, 0xdfff, 0x0001, 0x34a5, 0x0005, 0x0000, 0x000a, 0x0000,
+    0x0001, 0x3084, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0006, 0x0000, 0x0009, 0x0000, 0x0001, 0x0842,
+    0x0005, 0xdfff, 0x0001, 0x8631, 0x0006, 0x0000, 0x0008, 0x0000, 0x0001, 0x8210, 0x0001, 0x5def,
+    0x0004, 0xdfff, 0x0001, 0xae73, 0x0007, 0x0000, 0x0008, 0x0000, 0x0001, 0xb6b5, 0x0004, 0xdfff,
+    0x0001, 0xb6b5, 0x0008, 0x0000, 0x0007, 0x0000, 0x0001, 0xae73, 0x0004, 0xdfff, 0x0001, 0x5def,
+    0x0001, 0x8210, 0x0008, 0x0000, 0x0006, 0x0000, 0x0001, 0x8631, 0x0005, 0xdfff, 0x0001, 0x8a52,
+    0x0009, 0x0000, 0x0005, 0x0000, 0x0001, 0x8210, 0x0001, 0x5def, 0x0004, 0xdfff, 0x0001, 0xb294,
+    0x000a, 0x0000, 0x0005, 0x0000, 0x0001, 0x34a5, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x000b, 0x0000,
+    0x0004, 0x0000, 0x0001, 0x2c63, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000, 0x0001, 0xae73,
+    0x0004, 0xb294, 0x0001, 0x8210, 0x0003, 0x0000, 0x0003, 0x0000, 0x0001, 0x0421, 0x0005, 0xdfff,
+    0x0001, 0xae73, 0x0003, 0x0000, 0x0001, 0x59ce, 0x0004, 0xdfff, 0x0001, 0x8210, 0x0003, 0x0000,
+    0x0003, 0x0000, 0x0001, 0xdbde, 0x0004, 0xdfff, 0x0001, 0xb6b5, 0x0004, 0x0000, 0x0001, 0x59ce,
+    0x0004, 0xdfff, 0x0001, 0x8210, 0x0003, 0x0000, 0x0002, 0x0000, 0x0001, 0xb294, 0x0004, 0xdfff,
+    0x0001, 0x5def, 0x0001, 0x8210, 0x0004, 0x0000, 0x0001, 0x59ce, 0x0004, 0xdfff, 0x0001, 0x8210,
+    0x0003, 0x0000, 0x0001, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff, 0x0001, 0x34a5, 0x0005, 0x8a52,
+    0x0001, 0xdbde, 0x0004, 0xdfff, 0x0001, 0xae73, 0x0002, 0x8a52, 0x0001, 0x0842, 0x0001, 0x0000,
+    0x0014, 0xdfff, 0x0001, 0x59ce, 0x0001, 0x0000, 0x0014, 0xdfff, 0x0001, 0x59ce, 0x0001, 0x0000,
+    0x0014, 0xdfff, 0x0001, 0x59ce, 0x0001, 0x0000, 0x0014, 0xdfff, 0x0001, 0x59ce, 0x000d, 0x0000,
+    0x0005, 0xdfff, 0x0001, 0x8210, 0x0003, 0x0000, 0x000d, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8210,
+    0x0003, 0x0000, 0x000d, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8210, 0x0003, 0x0000, 0x000d, 0x0000,
+    0x0005, 0xdfff, 0x0001, 0x8210, 0x0003, 0x0000, 0x000d, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8210,
+    0x0003, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    /* '5' */
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0004, 0x0000, 0x0001, 0x5def, 0x000c, 0xdfff, 0x0001, 0x59ce, 0x0004, 0x0000, 0x0004, 0x0000,
+    0x000d, 0xdfff, 0x0001, 0x59ce, 0x0004, 0x0000, 0x0003, 0x0000, 0x0001, 0x8210, 0x000d, 0xdfff,
+    0x0001, 0x59ce, 0x0004, 0x0000, 0x0003, 0x0000, 0x0001, 0x8631, 0x000d, 0xdfff, 0x0001, 0x59ce,
+    0x0004, 0x0000, 0x0003, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0xb294, 0x0008, 0x0842,
+    0x0001, 0x8631, 0x0004, 0x0000, 0x0003, 0x0000, 0x0001, 0x2c63, 0x0004, 0xdfff, 0x0001, 0x8a52,
+    0x000d, 0x0000, 0x0003, 0x0000, 0x0001, 0xae73, 0x0004, 0xdfff, 0x0001, 0x0842, 0x000d, 0x0000,
+    0x0003, 0x0000, 0x0001, 0xb294, 0x0004, 0xdfff, 0x0001, 0x0421, 0x000d, 0x0000, 0x0003, 0x0000,
+    0x0001, 0x34a5, 0x0008, 0xdfff, 0x0001, 0xdbde, 0x0001, 0x34a5, 0x0001, 0x8a52, 0x0007, 0x0000,
+    0x0003, 0x0000, 0x0001, 0x59ce, 0x000b, 0xdfff, 0x0001, 0x5def, 0x0001, 0x8a52, 0x0005, 0x0000,
+    0x0003, 0x0000, 0x0001, 0xdbde, 0x000d, 0xdfff, 0x0001, 0xae73, 0x0004, 0x0000, 0x0003, 0x0000,
+    0x000f, 0xdfff, 0x0001, 0x8631, 0x0003, 0x0000, 0x0003, 0x0000, 0x0007, 0x8a52, 0x0001, 0x2c63,
+    0x0001, 0xb294, 0x0001, 0x5def, 0x0005, 0xdfff, 0x0001, 0x34a5, 0x0003, 0x0000, 0x000d, 0x0000,
+    0x0001, 0x59ce, 0x0005, 0xdfff, 0x0003, 0x0000, 0x000d, 0x0000, 0x0001, 0x8631, 0x0005, 0xdfff,
+    0x0001, 0x0421, 0x0002, 0x0000, 0x000d, 0x0000, 0x0001, 0x8210, 0x0005, 0xdfff, 0x0001, 0x0421,
+    0x0002, 0x0000, 0x0003, 0x0000, 0x0001, 0x8a52, 0x0009, 0x0000, 0x0001, 0x0842, 0x0005, 0xdfff,
+    0x0001, 0x8210, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8631, 0x0001, 0xdfff, 0x0001, 0xdbde,
+    0x0001, 0x2c63, 0x0006, 0x0000, 0x0001, 0x0421, 0x0001, 0xdbde, 0x0004, 0xdfff, 0x0001, 0xdbde,
+    0x0003, 0x0000, 0x0002, 0x0000, 0x0001, 0x34a5, 0x0004, 0xdfff, 0x0001, 0xb6b5, 0x0001, 0xb294,
+    0x0001, 0xae73, 0x0001, 0x3084, 0x0001, 0xb6b5, 0x0006, 0xdfff, 0x0001, 0xae73, 0x0003, 0x0000,
+    0x0001, 0x0000, 0x0001, 0x0421, 0x000f, 0xdfff, 0x0001, 0xdbde, 0x0004, 0x0000, 0x0001, 0x0000,
+    0x0001, 0xae73, 0x000e, 0xdfff, 0x0001, 0x5def, 0x0001, 0x0421, 0x0004, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x0842, 0x0001, 0xb6b5, 0x000b, 0xdfff, 0x0001, 0xb6b5, 0x0001, 0x8210, 0x0005, 0x0000,
+    0x0004, 0x0000, 0x0001, 0x8210, 0x0001, 0x2c63, 0x0001, 0x34a5, 0x0001, 0xdbde, 0x0003, 0xdfff,
+    0x0001, 0x5def, 0x0001, 0x59ce, 0x0001, 0x3084, 0x0001, 0x8631, 0x0007, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000,
+    /* '6' */
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0009, 0x0000, 0x0001, 0x8a52, 0x0001, 0x34a5, 0x0001, 0xdbde, 0x0003, 0xdfff, 0x0001, 0x5def,
+    0x0001, 0xb6b5, 0x0001, 0xae73, 0x0001, 0x0421, 0x0003, 0x0000, 0x0007, 0x0000, 0x0001, 0xae73,
+    0x0001, 0x5def, 0x000a, 0xdfff, 0x0001, 0xb294, 0x0002, 0x0000, 0x0005, 0x0000, 0x0001, 0x8210,
+    0x0001, 0x59ce, 0x000c, 0xdfff, 0x0001, 0x2c63, 0x0002, 0x0000, 0x0004, 0x0000, 0x0001, 0x8210,
+    0x0001, 0xdbde, 0x000c, 0xdfff, 0x0001, 0x5def, 0x0003, 0x0000, 0x0004, 0x0000, 0x0001, 0xb6b5,
+    0x0006, 0xdfff, 0x0001, 0x34a5, 0x0001, 0xae73, 0x0001, 0x8a52, 0x0001, 0x2c63, 0x0001, 0xae73,
+    0x0001, 0x34a5, 0x0001, 0xdfff, 0x0001, 0x2c63, 0x0003, 0x0000, 0x0003, 0x0000, 0x0001, 0x0842,
+    0x0005, 0xdfff, 0x0001, 0xb6b5, 0x0001, 0x8210, 0x0006, 0x0000, 0x0001, 0x8210, 0x0004, 0x0000,
+    0x0003, 0x0000, 0x0001, 0x59ce, 0x0004, 0xdfff, 0x0001, 0xb6b5, 0x000d, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x0421, 0x0005, 0xdfff, 0x0001, 0x0421, 0x000d, 0x0000, 0x0002, 0x0000, 0x0001, 0x2c63,
+    0x0004, 0xdfff, 0x0001, 0x59ce, 0x0001, 0x0000, 0x0001, 0x0842, 0x0001, 0x34a5, 0x0001, 0xdbde,
+    0x0002, 0xdfff, 0x0001, 0xdbde, 0x0001, 0x34a5, 0x0001, 0x0842, 0x0005, 0x0000, 0x0002, 0x0000,
+    0x0001, 0xb294, 0x0004, 0xdfff, 0x0001, 0x34a5, 0x0001, 0xb6b5, 0x0008, 0xdfff, 0x0001, 0xb6b5,
+    0x0001, 0x8210, 0x0003, 0x0000, 0x0002, 0x0000, 0x0001, 0xb6b5, 0x000f, 0xdfff, 0x0001, 0xdbde,
+    0x0001, 0x8210, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0xb6b5, 0x0010, 0xdfff, 0x0001, 0xb6b5,
+    0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0xb6b5, 0x0006, 0xdfff, 0x0001, 0xb6b5, 0x0001, 0x8631,
+    0x0002, 0x0000, 0x0001, 0x0842, 0x0001, 0x59ce, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0001, 0x0000,
+    0x0002, 0x0000, 0x0001, 0xb6b5, 0x0005, 0xdfff, 0x0001, 0xb6b5, 0x0006, 0x0000, 0x0001, 0xdbde,
+    0x0004, 0xdfff, 0x0001, 0x3084, 0x0001, 0x0000, 0x0002, 0x0000, 0x0001, 0xb294, 0x0005, 0xdfff,
+    0x0001, 0x8631, 0x0006, 0x0000, 0x0001, 0x2c63, 0x0004, 0xdfff, 0x0001, 0xb6b5, 0x0001, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x2c63, 0x0005, 0xdfff, 0x0001, 0x8210, 0x0006, 0x0000, 0x0001, 0x0842,
+    0x0004, 0xdfff, 0x0001, 0xb6b5, 0x0001, 0x0000, 0x0002, 0x0000, 0x0001, 0x0421, 0x0005, 0xdfff,
+    0x0001, 0x8631, 0x0006, 0x0000, 0x0001, 0x2c63, 0x0004, 0xdfff, 0x0001, 0x34a5, 0x0001, 0x0000,
+    0x0003, 0x0000, 0x0001, 0x59ce, 0x0004, 0xdfff, 0x0001, 0x34a5, 0x0006, 0x0000, 0x0001, 0xdbde,
+    0x0004, 0xdfff, 0x0001, 0xae73, 0x0001, 0x0000, 0x0003, 0x0000, 0x0001, 0x0842, 0x0005, 0xdfff,
+    0x0001, 0x34a5, 0x0001, 0x8631, 0x0002, 0x0000, 0x0001, 0x8631, 0x0001, 0x59ce, 0x0005, 0xdfff,
+    0x0001, 0x8210, 0x0001, 0x0000, 0x0004, 0x0000, 0x0001, 0xb294, 0x000e, 0xdfff, 0x0001, 0xae73,
+    0x0002, 0x0000, 0x0005, 0x0000, 0x0001, 0xb6b5, 0x000c, 0xdfff, 0x0001, 0x34a5, 0x0003, 0x0000,
+    0x0006, 0x0000, 0x0001, 0xae73, 0x000a, 0xdfff, 0x0001, 0xae73, 0x0004, 0x0000, 0x0007, 0x0000,
+    0x0001, 0x8210, 0x0001, 0x2c63, 0x0001, 0xb6b5, 0x0001, 0x5def, 0x0002, 0xdfff, 0x0001, 0x5def,
+    0x0001, 0x59ce, 0x0001, 0xae73, 0x0001, 0x8210, 0x0005, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    /* '7' */
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0001, 0x0000, 0x0001, 0x0421, 0x0011, 0xdfff, 0x0001, 0x59ce, 0x0002, 0x0000, 0x0001, 0x0000,
+    0x0001, 0x0421, 0x0011, 0xdfff, 0x0001, 0x59ce, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x0421,
+    0x0011, 0xdfff, 0x0001, 0x59ce, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x0421, 0x0011, 0xdfff,
+    0x0001, 0xb6b5, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x0421, 0x0004, 0xdfff, 0x0001, 0x34a5,
+    0x0006, 0x8a52, 0x0001, 0x3084, 0x0005, 0xdfff, 0x0001, 0x8a52, 0x0002, 0x0000, 0x0001, 0x0000,
+    0x0001, 0x0421, 0x0004, 0xdfff, 0x0001, 0xae73, 0x0006, 0x0000, 0x0001, 0x34a5, 0x0004, 0xdfff,
+    0x0001, 0x5def, 0x0003, 0x0000, 0x0001, 0x0000, 0x0001, 0x0421, 0x0004, 0xdfff, 0x0001, 0xae73,
+    0x0005, 0x0000, 0x0001, 0x8210, 0x0005, 0xdfff, 0x0001, 0xae73, 0x0003, 0x0000, 0x0001, 0x0000,
+    0x0001, 0x0421, 0x0004, 0xdfff, 0x0001, 0xae73, 0x0005, 0x0000, 0x0001, 0xae73, 0x0005, 0xdfff,
+    0x0001, 0x8210, 0x0003, 0x0000, 0x0002, 0x0000, 0x0004, 0x8210, 0x0006, 0x0000, 0x0001, 0x5def,
+    0x0004, 0xdfff, 0x0001, 0x34a5, 0x0004, 0x0000, 0x000b, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff,
+    0x0001, 0x8631, 0x0004, 0x0000, 0x000b, 0x0000, 0x0001, 0x59ce, 0x0004, 0xdfff, 0x0001, 0x59ce,
+    0x0005, 0x0000, 0x000a, 0x0000, 0x0001, 0x8631, 0x0005, 0xdfff, 0x0001, 0x8a52, 0x0005, 0x0000,
+    0x000a, 0x0000, 0x0001, 0x34a5, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0006, 0x0000, 0x0009, 0x0000,
+    0x0001, 0x8210, 0x0005, 0xdfff, 0x0001, 0x3084, 0x0006, 0x0000, 0x0009, 0x0000, 0x0001, 0x3084,
+    0x0005, 0xdfff, 0x0001, 0x8210, 0x0006, 0x0000, 0x0009, 0x0000, 0x0001, 0x5def, 0x0004, 0xdfff,
+    0x0001, 0x34a5, 0x0007, 0x0000, 0x0008, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff, 0x0001, 0x8631,
+    0x0007, 0x0000, 0x0008, 0x0000, 0x0001, 0x59ce, 0x0004, 0xdfff, 0x0001, 0x59ce, 0x0008, 0x0000,
+    0x0007, 0x0000, 0x0001, 0x8631, 0x0005, 0xdfff, 0x0001, 0x2c63, 0x0008, 0x0000, 0x0007, 0x0000,
+    0x0001, 0x34a5, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0009, 0x0000, 0x0006, 0x0000, 0x0001, 0x8210,
+    0x0005, 0xdfff, 0x0001, 0x3084, 0x0009, 0x0000, 0x0006, 0x0000, 0x0001, 0x3084, 0x0005, 0xdfff,
+    0x0001, 0x8210, 0x0009, 0x0000, 0x0006, 0x0000, 0x0001, 0x5def, 0x0004, 0xdfff, 0x0001, 0x34a5,
+    0x000a, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    /* '8' */
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0006, 0x0000, 0x0001, 0x2c63, 0x0001, 0x34a5, 0x0001, 0xdbde, 0x0003, 0xdfff, 0x0001, 0xdbde,
+    0x0001, 0xb6b5, 0x0001, 0x2c63, 0x0001, 0x8210, 0x0006, 0x0000, 0x0004, 0x0000, 0x0001, 0x2c63,
+    0x0001, 0x5def, 0x000a, 0xdfff, 0x0001, 0xae73, 0x0005, 0x0000, 0x0003, 0x0000, 0x0001, 0xb294,
+    0x000d, 0xdfff, 0x0001, 0x34a5, 0x0004, 0x0000, 0x0002, 0x0000, 0x0001, 0x2c63, 0x000f, 0xdfff,
+    0x0001, 0xae73, 0x0003, 0x0000, 0x0002, 0x0000, 0x0001, 0xdbde, 0x0004, 0xdfff, 0x0001, 0x5def,
+    0x0001, 0x8a52, 0x0003, 0x0000, 0x0001, 0x0842, 0x0001, 0x5def, 0x0004, 0xdfff, 0x0001, 0x5def,
+    0x0003, 0x0000, 0x0002, 0x0000, 0x0005, 0xdfff, 0x0001, 0x0842, 0x0005, 0x0000, 0x0001, 0x0421,
+    0x0005, 0xdfff, 0x0001, 0x0421, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x8210, 0x0005, 0xdfff,
+    0x0001, 0x8210, 0x0006, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x5def, 0x0004, 0xdfff, 0x0001, 0x8a52, 0x0005, 0x0000, 0x0001, 0x8631, 0x0005, 0xdfff,
+    0x0003, 0x0000, 0x0002, 0x0000, 0x0001, 0x3084, 0x0005, 0xdfff, 0x0001, 0xae73, 0x0001, 0x0421,
+    0x0001, 0x8210, 0x0001, 0x0421, 0x0001, 0xae73, 0x0001, 0x5def, 0x0004, 0xdfff, 0x0001, 0x34a5,
+    0x0003, 0x0000, 0x0003, 0x0000, 0x0001, 0x59ce, 0x000d, 0xdfff, 0x0001, 0xdbde, 0x0001, 0x8210,
+    0x0003, 0x0000, 0x0003, 0x0000, 0x0001, 0x8210, 0x0001, 0x5def, 0x000c, 0xdfff, 0x0001, 0x0421,
+    0x0004, 0x0000, 0x0002, 0x0000, 0x0001, 0x8210, 0x0001, 0x59ce, 0x000d, 0xdfff, 0x0001, 0xdbde,
+    0x0001, 0x0421, 0x0003, 0x0000, 0x0002, 0x0000, 0x0001, 0x59ce, 0x0005, 0xdfff, 0x0001, 0xdbde,
+    0x0001, 0x34a5, 0x0001, 0x3084, 0x0001, 0xb294, 0x0001, 0xdbde, 0x0005, 0xdfff, 0x0001, 0x5def,
+    0x0001, 0x8210, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x2c63, 0x0005, 0xdfff, 0x0001, 0x2c63,
+    0x0005, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff, 0x0001, 0x3084, 0x0002, 0x0000, 0x0001, 0x0000,
+    0x0001, 0xb6b5, 0x0004, 0xdfff, 0x0001, 0x34a5, 0x0007, 0x0000, 0x0001, 0x3084, 0x0004, 0xdfff,
+    0x0001, 0xdbde, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0xdbde, 0x0004, 0xdfff, 0x0001, 0x2c63,
+    0x0007, 0x0000, 0x0001, 0x0842, 0x0005, 0xdfff, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0xdbde,
+    0x0004, 0xdfff, 0x0001, 0xae73, 0x0007, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff, 0x0002, 0x0000,
+    0x0001, 0x0000, 0x0001, 0xb6b5, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0007, 0x0000, 0x0001, 0x59ce,
+    0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff,
+    0x0001, 0x59ce, 0x0001, 0x0842, 0x0003, 0x0000, 0x0001, 0x8631, 0x0001, 0xb6b5, 0x0005, 0xdfff,
+    0x0001, 0xae73, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x59ce, 0x000f, 0xdfff, 0x0001, 0xdbde,
+    0x0003, 0x0000, 0x0002, 0x0000, 0x0001, 0x8210, 0x0001, 0xdbde, 0x000d, 0xdfff, 0x0001, 0x5def,
+    0x0001, 0x0421, 0x0003, 0x0000, 0x0004, 0x0000, 0x0001, 0xb294, 0x000b, 0xdfff, 0x0001, 0x34a5,
+    0x0001, 0x8210, 0x0004, 0x0000, 0x0005, 0x0000, 0x0001, 0x8210, 0x0001, 0xae73, 0x0001, 0xb6b5,
+    0x0001, 0xdbde, 0x0003, 0xdfff, 0x0001, 0x5def, 0x0001, 0xb6b5, 0x0001, 0xae73, 0x0001, 0x0421,
+    0x0006, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    /* '9' */
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0006, 0x0000, 0x0001, 0x8a52, 0x0001, 0x34a5, 0x0001, 0xdbde, 0x0002, 0xdfff, 0x0001, 0x5def,
+    0x0001, 0x59ce, 0x0001, 0x3084, 0x0001, 0x8631, 0x0007, 0x0000, 0x0004, 0x0000, 0x0001, 0x8a52,
+    0x0001, 0x5def, 0x0009, 0xdfff, 0x0001, 0xb6b5, 0x0001, 0x8210, 0x0005, 0x0000, 0x0003, 0x0000,
+    0x0001, 0xae73, 0x000c, 0xdfff, 0x0001, 0x5def, 0x0001, 0x0421, 0x0004, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x0842, 0x000e, 0xdfff, 0x0001, 0x5def, 0x0001, 0x8210, 0x0003, 0x0000, 0x0002, 0x0000,
+    0x0001, 0xdbde, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0001, 0x2c63, 0x0001, 0x8210, 0x0001, 0x0000,
+    0x0001, 0x8210, 0x0001, 0x2c63, 0x0001, 0x5def, 0x0004, 0xdfff, 0x0001, 0x34a5, 0x0003, 0x0000,
+    0x0001, 0x0000, 0x0001, 0x0421, 0x0005, 0xdfff, 0x0001, 0x0421, 0x0005, 0x0000, 0x0001, 0x0421,
+    0x0005, 0xdfff, 0x0001, 0x0421, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff,
+    0x0001, 0x59ce, 0x0007, 0x0000, 0x0001, 0xb6b5, 0x0004, 0xdfff, 0x0001, 0x3084, 0x0002, 0x0000,
+    0x0001, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0x59ce, 0x0007, 0x0000, 0x0001, 0xb6b5,
+    0x0004, 0xdfff, 0x0001, 0x59ce, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x8631, 0x0005, 0xdfff,
+    0x0001, 0x0421, 0x0005, 0x0000, 0x0001, 0x0421, 0x0006, 0xdfff, 0x0002, 0x0000, 0x0002, 0x0000,
+    0x0005, 0xdfff, 0x0001, 0x5def, 0x0001, 0x2c63, 0x0001, 0x8210, 0x0001, 0x0000, 0x0001, 0x8210,
+    0x0001, 0x2c63, 0x0001, 0x5def, 0x0006, 0xdfff, 0x0001, 0x8210, 0x0001, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x3084, 0x0011, 0xdfff, 0x0001, 0x0421, 0x0001, 0x0000, 0x0003, 0x0000, 0x0001, 0xb6b5,
+    0x0010, 0xdfff, 0x0001, 0x0421, 0x0001, 0x0000, 0x0004, 0x0000, 0x0001, 0xb294, 0x0008, 0xdfff,
+    0x0001, 0x5def, 0x0001, 0xae73, 0x0005, 0xdfff, 0x0001, 0x8210, 0x0001, 0x0000, 0x0005, 0x0000,
+    0x0001, 0x0421, 0x0001, 0xb294, 0x0001, 0xdbde, 0x0002, 0xdfff, 0x0001, 0x5def, 0x0001, 0x59ce,
+    0x0001, 0xae73, 0x0001, 0x8210, 0x0001, 0x8631, 0x0005, 0xdfff, 0x0002, 0x0000, 0x000e, 0x0000,
+    0x0001, 0xae73, 0x0004, 0xdfff, 0x0001, 0x59ce, 0x0002, 0x0000, 0x000e, 0x0000, 0x0001, 0xdbde,
+    0x0004, 0xdfff, 0x0001, 0x3084, 0x0002, 0x0000, 0x000d, 0x0000, 0x0001, 0xae73, 0x0005, 0xdfff,
+    0x0001, 0x0421, 0x0002, 0x0000, 0x0004, 0x0000, 0x0001, 0x8631, 0x0007, 0x0000, 0x0001, 0x3084,
+    0x0005, 0xdfff, 0x0001, 0xb6b5, 0x0003, 0x0000, 0x0003, 0x0000, 0x0001, 0x8210, 0x0001, 0xdfff,
+    0x0001, 0x5def, 0x0001, 0xb294, 0x0001, 0x2c63, 0x0001, 0x8a52, 0x0001, 0x2c63, 0x0001, 0xb294,
+    0x0001, 0x5def, 0x0006, 0xdfff, 0x0001, 0x0421, 0x0003, 0x0000, 0x0003, 0x0000, 0x0001, 0xb294,
+    0x000d, 0xdfff, 0x0001, 0x8a52, 0x0004, 0x0000, 0x0002, 0x0000, 0x0001, 0x8210, 0x000d, 0xdfff,
+    0x0001, 0x8a52, 0x0005, 0x0000, 0x0002, 0x0000, 0x0001, 0x8631, 0x0001, 0x5def, 0x000a, 0xdfff,
+    0x0001, 0x34a5, 0x0001, 0x0421, 0x0006, 0x0000, 0x0004, 0x0000, 0x0001, 0x8a52, 0x0001, 0x34a5,
+    0x0001, 0xdbde, 0x0003, 0xdfff, 0x0001, 0x5def, 0x0001, 0xb6b5, 0x0001, 0xae73, 0x0001, 0x0421,
+    0x0008, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    /* '.' */
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0003, 0x0000, 0x0001, 0x8a52,
+    0x0001, 0x2c63, 0x0001, 0x0421, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x8210, 0x0001, 0xdbde,
+    0x0003, 0xdfff, 0x0001, 0x2c63, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x34a5, 0x0005, 0xdfff,
+    0x0001, 0x8210, 0x0001, 0x0000, 0x0001, 0x5def, 0x0005, 0xdfff, 0x0001, 0x0842, 0x0001, 0x0000,
+    0x0001, 0xdbde, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0001, 0x0000, 0x0001, 0x2c63, 0x0004, 0xdfff,
+    0x0001, 0xdbde, 0x0001, 0x0000, 0x0002, 0x0000, 0x0001, 0xae73, 0x0001, 0x5def, 0x0001, 0xdfff,
+    0x0001, 0xb6b5, 0x0001, 0x8210, 0x0001, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000,
+    /* ',' */
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000, 0x0003, 0x0000, 0x0001, 0x0421,
+    0x0001, 0x8631, 0x0003, 0x0000, 0x0001, 0x0000, 0x0001, 0x8210, 0x0001, 0x59ce, 0x0003, 0xdfff,
+    0x0001, 0x0842, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0xb294, 0x0005, 0xdfff, 0x0001, 0x0000,
+    0x0001, 0x0000, 0x0001, 0xdbde, 0x0005, 0xdfff, 0x0001, 0x0842, 0x0001, 0x0000, 0x0001, 0xdbde,
+    0x0005, 0xdfff, 0x0001, 0x0842, 0x0001, 0x0000, 0x0001, 0xae73, 0x0005, 0xdfff, 0x0001, 0x8210,
+    0x0002, 0x0000, 0x0001, 0xb294, 0x0003, 0xdfff, 0x0001, 0xb6b5, 0x0001, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x8a52, 0x0003, 0xdfff, 0x0001, 0x8a52, 0x0001, 0x0000, 0x0002, 0x0000, 0x0001, 0x34a5,
+    0x0002, 0xdfff, 0x0001, 0x5def, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x5def, 0x0002, 0xdfff,
+    0x0001, 0xb294, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x0421, 0x0003, 0xdfff, 0x0001, 0x8631,
+    0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x2c63, 0x0002, 0xdfff, 0x0001, 0x59ce, 0x0003, 0x0000,
+    0x0008, 0x0000, 0x0008, 0x0000, 0x0008, 0x0000,
+    /* '-' */
+    0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000,
+    0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000,
+    0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000,
+    0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x0002, 0x0000,
+    0x0008, 0x0421, 0x0001, 0x8210, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x8a52, 0x0008, 0xdfff,
+    0x0001, 0xb6b5, 0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x8a52, 0x0008, 0xdfff, 0x0001, 0xb6b5,
+    0x0001, 0x0000, 0x0001, 0x0000, 0x0001, 0x8a52, 0x0008, 0xdfff, 0x0001, 0xb6b5, 0x0001, 0x0000,
+    0x0001, 0x0000, 0x0001, 0x8a52, 0x0008, 0xdfff, 0x0001, 0xb6b5, 0x0001, 0x0000, 0x000c, 0x0000,
+    0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000,
+    0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000, 0x000c, 0x0000,
+    0x000c, 0x0000, 0x000c, 0x0000,
+    /* '+' */
+    0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000,
+    0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000,
+    0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0007, 0x0000, 0x0001, 0x8631, 0x0003, 0x3084,
+    0x0001, 0x8a52, 0x0007, 0x0000, 0x0007, 0x0000, 0x0001, 0xae73, 0x0003, 0xdfff, 0x0001, 0x34a5,
+    0x0007, 0x0000, 0x0007, 0x0000, 0x0001, 0xae73, 0x0003, 0xdfff, 0x0001, 0x34a5, 0x0007, 0x0000,
+    0x0007, 0x0000, 0x0001, 0xae73, 0x0003, 0xdfff, 0x0001, 0x34a5, 0x0007, 0x0000, 0x0007, 0x0000,
+    0x0001, 0xae73, 0x0003, 0xdfff, 0x0001, 0x34a5, 0x0007, 0x0000, 0x0007, 0x0000, 0x0001, 0xae73,
+    0x0003, 0xdfff, 0x0001, 0x34a5, 0x0007, 0x0000, 0x0002, 0x0000, 0x000f, 0xdfff, 0x0001, 0x8631,
+    0x0001, 0x0000, 0x0002, 0x0000, 0x000f, 0xdfff, 0x0001, 0x8631, 0x0001, 0x0000, 0x0002, 0x0000,
+    0x000f, 0xdfff, 0x0001, 0x8631, 0x0001, 0x0000, 0x0002, 0x0000, 0x000f, 0xdfff, 0x0001, 0x8631,
+    0x0001, 0x0000, 0x0007, 0x0000, 0x0001, 0xae73, 0x0003, 0xdfff, 0x0001, 0x34a5, 0x0007, 0x0000,
+    0x0007, 0x0000, 0x0001, 0xae73, 0x0003, 0xdfff, 0x0001, 0x34a5, 0x0007, 0x0000, 0x0007, 0x0000,
+    0x0001, 0xae73, 0x0003, 0xdfff, 0x0001, 0x34a5, 0x0007, 0x0000, 0x0007, 0x0000, 0x0001, 0xae73,
+    0x0003, 0xdfff, 0x0001, 0x34a5, 0x0007, 0x0000, 0x0007, 0x0000, 0x0001, 0xae73, 0x0003, 0xdfff,
+    0x0001, 0x34a5, 0x0007, 0x0000, 0x0007, 0x0000, 0x0001, 0x8631, 0x0003, 0x3084, 0x0001, 0x8a52,
+    0x0007, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000,
+    0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000, 0x0013, 0x0000,
+    0x0013, 0x0000,
+    /* ' ' */
+    0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000,
+    0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000,
+    0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000,
+    0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000,
+    0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000,
+    0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000,
+    0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000, 0x0009, 0x0000,
+    0x0009, 0x0000,
+    /* 'd' */
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x000e, 0x0000, 0x0001, 0x8210,
+    0x0004, 0xae73, 0x0001, 0x2c63, 0x0002, 0x0000, 0x000e, 0x0000, 0x0001, 0x0421, 0x0004, 0xdfff,
+    0x0001, 0xdbde, 0x0002, 0x0000, 0x000e, 0x0000, 0x0001, 0x0421, 0x0004, 0xdfff, 0x0001, 0xdbde,
+    0x0002, 0x0000, 0x000e, 0x0000, 0x0001, 0x0421, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000,
+    0x000e, 0x0000, 0x0001, 0x0421, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x000e, 0x0000,
+    0x0001, 0x0421, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x000e, 0x0000, 0x0001, 0x0421,
+    0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x0005, 0x0000, 0x0001, 0x8210, 0x0001, 0xae73,
+    0x0001, 0xb6b5, 0x0001, 0x5def, 0x0002, 0xdfff, 0x0001, 0x59ce, 0x0001, 0xae73, 0x0001, 0x8210,
+    0x0001, 0x0421, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x0004, 0x0000, 0x0001, 0x8a52,
+    0x0001, 0x5def, 0x0008, 0xdfff, 0x0001, 0xae73, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000,
+    0x0003, 0x0000, 0x0001, 0xae73, 0x000f, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x0842, 0x0010, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x5def,
+    0x0005, 0xdfff, 0x0001, 0xb6b5, 0x0001, 0x8a52, 0x0001, 0x8631, 0x0001, 0x8a52, 0x0001, 0x34a5,
+    0x0006, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff,
+    0x0001, 0xae73, 0x0005, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000,
+    0x0001, 0x0000, 0x0001, 0x34a5, 0x0004, 0xdfff, 0x0001, 0xb6b5, 0x0007, 0x0000, 0x0001, 0x34a5,
+    0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0xdbde, 0x0004, 0xdfff,
+    0x0001, 0x8a52, 0x0007, 0x0000, 0x0001, 0x0842, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000,
+    0x0001, 0x0000, 0x0001, 0x5def, 0x0004, 0xdfff, 0x0001, 0x0421, 0x0007, 0x0000, 0x0001, 0x8210,
+    0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x5def, 0x0004, 0xdfff,
+    0x0001, 0x0421, 0x0007, 0x0000, 0x0001, 0x8210, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000,
+    0x0001, 0x0000, 0x0001, 0xdbde, 0x0004, 0xdfff, 0x0001, 0x8a52, 0x0007, 0x0000, 0x0001, 0x0842,
+    0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x0001, 0x0000, 0x0001, 0x34a5, 0x0004, 0xdfff,
+    0x0001, 0xb6b5, 0x0007, 0x0000, 0x0001, 0x34a5, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000,
+    0x0001, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff, 0x0001, 0xae73, 0x0005, 0x0000, 0x0001, 0x2c63,
+    0x0005, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0xdbde, 0x0005, 0xdfff,
+    0x0001, 0xb6b5, 0x0001, 0x8a52, 0x0001, 0x8631, 0x0001, 0x8a52, 0x0001, 0x34a5, 0x0006, 0xdfff,
+    0x0001, 0xdbde, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x0842, 0x0010, 0xdfff, 0x0001, 0xdbde,
+    0x0002, 0x0000, 0x0003, 0x0000, 0x0001, 0xae73, 0x000f, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000,
+    0x0004, 0x0000, 0x0001, 0x8a52, 0x0001, 0x5def, 0x0008, 0xdfff, 0x0001, 0x8a52, 0x0001, 0x5def,
+    0x0003, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x0006, 0x0000, 0x0001, 0x2c63, 0x0001, 0xb6b5,
+    0x0001, 0x5def, 0x0002, 0xdfff, 0x0001, 0x59ce, 0x0001, 0x3084, 0x0001, 0x8210, 0x0001, 0x0000,
+    0x0001, 0x5def, 0x0003, 0xdfff, 0x0001, 0xdbde, 0x0002, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000, 0x0016, 0x0000,
+    /* 'K' */
+    0x0018, 0x0000, 0x0018, 0x0000, 0x0018, 0x0000, 0x0018, 0x0000, 0x0018, 0x0000, 0x0018, 0x0000,
+    0x0018, 0x0000, 0x0018, 0x0000, 0x0018, 0x0000, 0x0018, 0x0000, 0x0018, 0x0000, 0x0018, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0009, 0x0000, 0x0001, 0xb6b5,
+    0x0004, 0xdfff, 0x0001, 0x5def, 0x0001, 0x0421, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff,
+    0x0001, 0xdbde, 0x0008, 0x0000, 0x0001, 0x34a5, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0001, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0007, 0x0000, 0x0001, 0xb294,
+    0x0005, 0xdfff, 0x0001, 0x0842, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff,
+    0x0001, 0xdbde, 0x0006, 0x0000, 0x0001, 0x3084, 0x0005, 0xdfff, 0x0001, 0x8a52, 0x0003, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0005, 0x0000, 0x0001, 0x2c63,
+    0x0005, 0xdfff, 0x0001, 0x2c63, 0x0004, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff,
+    0x0001, 0xdbde, 0x0004, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff, 0x0001, 0x3084, 0x0005, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0003, 0x0000, 0x0001, 0x0842,
+    0x0005, 0xdfff, 0x0001, 0xb294, 0x0006, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff,
+    0x0001, 0xdbde, 0x0002, 0x0000, 0x0001, 0x8631, 0x0005, 0xdfff, 0x0001, 0xb6b5, 0x0007, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0001, 0x0000, 0x0001, 0x8631,
+    0x0005, 0xdfff, 0x0001, 0x59ce, 0x0008, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff,
+    0x0001, 0xdbde, 0x0001, 0x0421, 0x0001, 0x5def, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0001, 0x8210,
+    0x0008, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0x5def, 0x0001, 0xdbde,
+    0x0005, 0xdfff, 0x0001, 0xae73, 0x0009, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x000c, 0xdfff,
+    0x0001, 0x8631, 0x0008, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x000c, 0xdfff, 0x0001, 0xdbde,
+    0x0001, 0x8210, 0x0007, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x000d, 0xdfff, 0x0001, 0xb6b5,
+    0x0007, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0007, 0xdfff, 0x0001, 0x8a52, 0x0001, 0x59ce,
+    0x0005, 0xdfff, 0x0001, 0xae73, 0x0006, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0006, 0xdfff,
+    0x0001, 0x2c63, 0x0001, 0x0000, 0x0001, 0x8210, 0x0001, 0x5def, 0x0005, 0xdfff, 0x0001, 0x0842,
+    0x0005, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0005, 0xdfff, 0x0001, 0xae73, 0x0003, 0x0000,
+    0x0001, 0x8631, 0x0005, 0xdfff, 0x0001, 0x5def, 0x0001, 0x8210, 0x0004, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0005, 0x0000, 0x0001, 0x2c63, 0x0005, 0xdfff,
+    0x0001, 0x59ce, 0x0004, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde,
+    0x0006, 0x0000, 0x0001, 0xb294, 0x0005, 0xdfff, 0x0001, 0xb294, 0x0003, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0007, 0x0000, 0x0001, 0x59ce, 0x0005, 0xdfff,
+    0x0001, 0x8a52, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde,
+    0x0007, 0x0000, 0x0001, 0x8210, 0x0001, 0x5def, 0x0005, 0xdfff, 0x0001, 0x0421, 0x0001, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x0008, 0x0000, 0x0001, 0x8631,
+    0x0005, 0xdfff, 0x0001, 0xdbde, 0x0001, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff,
+    0x0001, 0xdbde, 0x0009, 0x0000, 0x0001, 0x2c63, 0x0005, 0xdfff, 0x0001, 0x34a5, 0x0018, 0x0000,
+    0x0018, 0x0000, 0x0018, 0x0000, 0x0018, 0x0000, 0x0018, 0x0000, 0x0018, 0x0000, 0x0018, 0x0000,
+    0x0018, 0x0000,
+    /* 'H' */
+    0x001a, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000,
+    0x001a, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x000a, 0x0000, 0x0005, 0xdfff,
+    0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde,
+    0x000a, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52,
+    0x0004, 0xdfff, 0x0001, 0xdbde, 0x000a, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x000a, 0x0000, 0x0005, 0xdfff,
+    0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde,
+    0x000a, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52,
+    0x0004, 0xdfff, 0x0001, 0xdbde, 0x000a, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x000a, 0x0000, 0x0005, 0xdfff,
+    0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde,
+    0x000a, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52,
+    0x0004, 0xdfff, 0x0001, 0xdbde, 0x000a, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0014, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000,
+    0x0001, 0x8a52, 0x0014, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52,
+    0x0014, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0014, 0xdfff,
+    0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0x5def,
+    0x000a, 0x3084, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52,
+    0x0004, 0xdfff, 0x0001, 0xdbde, 0x000a, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x000a, 0x0000, 0x0005, 0xdfff,
+    0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde,
+    0x000a, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52,
+    0x0004, 0xdfff, 0x0001, 0xdbde, 0x000a, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x000a, 0x0000, 0x0005, 0xdfff,
+    0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde,
+    0x000a, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52,
+    0x0004, 0xdfff, 0x0001, 0xdbde, 0x000a, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000,
+    0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde, 0x000a, 0x0000, 0x0005, 0xdfff,
+    0x0001, 0x8631, 0x0002, 0x0000, 0x0002, 0x0000, 0x0001, 0x8a52, 0x0004, 0xdfff, 0x0001, 0xdbde,
+    0x000a, 0x0000, 0x0005, 0xdfff, 0x0001, 0x8631, 0x0002, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000,
+    0x001a, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000, 0x001a, 0x0000,
+};
+
+const kh_atlas_glyph_t kh_atlas_glyphs[KH_ATLAS_GLYPH_COUNT] = {
+    {.rle_start = 0, .width = 22, .ch = '0',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 42, 56, 66, 76, 96, 114, 130, 146, 164, 182, 200, 218, 236, 254, 272, 288, 304, 322, 342, 352, 362, 376, 394, 396, 398, 400, 402, 404, 406, 408}},
+    {.rle_start = 410, .width = 22, .ch = '1',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 34, 44, 54, 64, 78, 88, 98, 108, 118, 128, 138, 148, 158, 168, 178, 188, 198, 208, 218, 228, 238, 248, 258, 260, 262, 264, 266, 268, 270, 272}},
+    {.rle_start = 684, .width = 22, .ch = '2',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 46, 58, 68, 78, 100, 122, 138, 146, 154, 164, 174, 184, 194, 204, 214, 224, 234, 244, 258, 266, 272, 278, 284, 286, 288, 290, 292, 294, 296, 298}},
+    {.rle_start = 984, .width = 22, .ch = '3',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 34, 44, 54, 64, 76, 88, 98, 108, 118, 130, 140, 148, 158, 170, 180, 190, 206, 226, 248, 258, 268, 280, 302, 304, 306, 308, 310, 312, 314, 316}},
+    {.rle_start = 1302, .width = 22, .ch = '4',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 34, 44, 54, 66, 76, 88, 98, 110, 120, 138, 156, 174, 194, 214, 220, 226, 232, 238, 246, 254, 262, 270, 278, 280, 282, 284, 286, 288, 290, 292}},
+    {.rle_start = 1596, .width = 22, .ch = '5',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 34, 42, 52, 62, 76, 86, 96, 106, 120, 132, 142, 150, 166, 174, 184, 194, 208, 230, 252, 262, 274, 288, 310, 312, 314, 316, 318, 320, 322, 324}},
+    {.rle_start = 1922, .width = 22, .ch = '6',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 44, 56, 68, 80, 104, 120, 130, 140, 166, 184, 196, 206, 228, 246, 264, 282, 300, 318, 340, 350, 360, 370, 392, 394, 396, 398, 400, 402, 404, 406}},
+    {.rle_start = 2330, .width = 22, .ch = '7',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 34, 44, 54, 64, 82, 100, 118, 136, 150, 160, 170, 180, 190, 200, 210, 220, 230, 240, 250, 260, 270, 280, 290, 292, 294, 296, 298, 300, 302, 304}},
+    {.rle_start = 2636, .width = 22, .ch = '8',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 44, 56, 66, 76, 98, 114, 130, 146, 170, 182, 194, 208, 232, 250, 268, 284, 300, 318, 340, 350, 364, 376, 398, 400, 402, 404, 406, 408, 410, 412}},
+    {.rle_start = 3050, .width = 22, .ch = '9',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 44, 58, 70, 82, 108, 126, 144, 162, 178, 202, 212, 222, 238, 262, 272, 282, 292, 306, 332, 342, 352, 366, 386, 388, 390, 392, 394, 396, 398, 400}},
+    {.rle_start = 3452, .width = 8, .ch = '.',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 66, 78, 86, 94, 102, 112, 126, 128, 130, 132, 134, 136, 138, 140}},
+    {.rle_start = 3594, .width = 8, .ch = ',',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 64, 76, 84, 92, 100, 108, 118, 128, 138, 148, 158, 168, 170, 172}},
+    {.rle_start = 3768, .width = 12, .ch = '-',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 44, 46, 54, 64, 74, 84, 94, 96, 98, 100, 102, 104, 106, 108, 110, 112, 114, 116, 118, 120, 122}},
+    {.rle_start = 3892, .width = 19, .ch = '+',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, 40, 50, 60, 70, 80, 90, 98, 106, 114, 122, 132, 142, 152, 162, 172, 182, 184, 186, 188, 190, 192, 194, 196, 198, 200, 202, 204}},
+    {.rle_start = 4098, .width = 9, .ch = ' ',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 58, 60, 62, 64, 66, 68, 70, 72, 74, 76, 78, 80, 82, 84}},
+    {.rle_start = 4184, .width = 22, .ch = 'd',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 30, 40, 50, 60, 70, 80, 90, 116, 132, 142, 152, 174, 192, 210, 228, 246, 264, 282, 300, 318, 340, 350, 360, 378, 404, 406, 408, 410, 412, 414, 416, 418}},
+    {.rle_start = 4604, .width = 24, .ch = 'K',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 42, 60, 78, 96, 114, 132, 150, 168, 186, 206, 222, 232, 244, 254, 270, 290, 310, 328, 346, 364, 384, 402, 418, 420, 422, 424, 426, 428, 430, 432}},
+    {.rle_start = 5038, .width = 26, .ch = 'H',
+     .row_ofs = {0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 40, 56, 72, 88, 104, 120, 136, 152, 168, 178, 188, 198, 208, 224, 240, 256, 272, 288, 304, 320, 336, 352, 368, 370, 372, 374, 376, 378, 380, 382}},
+};
+
+const int8_t kh_atlas_map[96] = {
+    14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 13, 11, 12, 10, -1,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, 17, -1, -1, 16, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
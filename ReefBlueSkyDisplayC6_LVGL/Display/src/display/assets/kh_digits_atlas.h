@@ -0,0 +1,35 @@
+// kh_digits_atlas.h
+// GERADO por gen_kh_atlas.py a partir de montserrat_bold_32.c - não editar.
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KH_ATLAS_HEIGHT         43      // line_height da fonte
+#define KH_ATLAS_DIGIT_W        22      // largura tabular dos dígitos
+#define KH_ATLAS_GLYPH_COUNT    18
+#define KH_ATLAS_COLOR_16_SWAP  1       // pixels já no formato do lv_color_t
+#define KH_ATLAS_FG             0xFAFAFA
+#define KH_ATLAS_BG             0x000000
+
+// Glifo = célula largura x KH_ATLAS_HEIGHT; RLE por linha em pares
+// (comprimento, cor RGB565) a partir de kh_atlas_rle[rle_start + row_ofs[y]]
+typedef struct {
+    uint32_t rle_start;
+    uint16_t row_ofs[KH_ATLAS_HEIGHT];
+    uint8_t  width;
+    char     ch;
+} kh_atlas_glyph_t;
+
+extern const kh_atlas_glyph_t kh_atlas_glyphs[KH_ATLAS_GLYPH_COUNT];
+extern const uint16_t         kh_atlas_rle[];
+
+// ASCII 32..127 -> índice em kh_atlas_glyphs (-1 = ausente)
+extern const int8_t           kh_atlas_map[96];
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,10 +6,59 @@ extern "C" bool g_wifi_status;
 extern "C" {
     #include "ui.h"
     #include "ui_Screen1.h"
+    #include "KhTrend.h"
+    #include "KhDigits.h"
+    #include "esp_log.h"
+    #include "esp_timer.h"
     #include "freertos/FreeRTOS.h"
     #include "freertos/task.h"
 }
 
+static const char *TAG = "DisplaySimple";
+
+// 1 = número grande pelo atlas pré-renderizado (KhDigits);
+// 0 = label original do SquareLine (referência para comparar o custo de desenho)
+#ifndef KH_VALUE_USE_ATLAS
+#define KH_VALUE_USE_ATLAS 1
+#endif
+
+static lv_obj_t *s_kh_value = NULL;     // KhDigits ou ui_dhkValue
+static int64_t   s_draw_t0 = 0;
+static int64_t   s_draw_us = 0;         // soma dos DRAW_MAIN desde o último update
+
+// Mede o desenho do número grande (mesmo método nos dois caminhos)
+static void kh_value_draw_begin_cb(lv_event_t *e)
+{
+    (void)e;
+    s_draw_t0 = esp_timer_get_time();
+}
+
+static void kh_value_draw_end_cb(lv_event_t *e)
+{
+    (void)e;
+    s_draw_us += esp_timer_get_time() - s_draw_t0;
+}
+
+static void set_kh_value(const char *text)
+{
+    if (!s_kh_value) return;
+
+    if (s_draw_us) {
+        ESP_LOGD(TAG, "dKH (%s): desenho anterior %lld us",
+                 KH_VALUE_USE_ATLAS ? "atlas" : "label", (long long)s_draw_us);
+        s_draw_us = 0;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+#if KH_VALUE_USE_ATLAS
+    kh_digits_set_text(s_kh_value, text);
+#else
+    lv_label_set_text(s_kh_value, text);
+#endif
+    ESP_LOGD(TAG, "dKH (%s): set_text %lld us",
+             KH_VALUE_USE_ATLAS ? "atlas" : "label", (long long)(esp_timer_get_time() - t0));
+}
+
 
 
 
@@ -31,6 +80,27 @@ void display_simple_init(void)
     if (ui_KhmaxDay)   lv_label_set_text(ui_KhmaxDay, "0,00");
     if (ui_KhVarDay)   lv_label_set_text(ui_KhVarDay, "0,00");
 
+    // Número grande: widget do atlas no lugar do label (label fica oculto)
+#if KH_VALUE_USE_ATLAS
+    if (ui_dhkValue) {
+        s_kh_value = kh_digits_create(ui_Screen1);
+        lv_obj_set_align(s_kh_value, LV_ALIGN_CENTER);
+        lv_obj_set_x(s_kh_value, lv_obj_get_x_aligned(ui_dhkValue));
+        lv_obj_set_y(s_kh_value, lv_obj_get_y_aligned(ui_dhkValue));
+        lv_obj_add_flag(ui_dhkValue, LV_OBJ_FLAG_HIDDEN);
+    }
+#else
+    s_kh_value = ui_dhkValue;
+#endif
+    if (s_kh_value) {
+        lv_obj_add_event_cb(s_kh_value, kh_value_draw_begin_cb, LV_EVENT_DRAW_MAIN_BEGIN, NULL);
+        lv_obj_add_event_cb(s_kh_value, kh_value_draw_end_cb, LV_EVENT_DRAW_MAIN_END, NULL);
+        set_kh_value("0,00");
+    }
+
+    // Sparkline de tendência do KH (entre o valor grande e a barra)
+    kh_trend_init(ui_Screen1);
+
     // Spinner inicialmente OFF
     if (ui_loading) {
         lv_obj_add_flag(ui_loading, LV_OBJ_FLAG_HIDDEN);
@@ -72,9 +142,7 @@ void display_simple_show_summary(const kh_summary_t *summary,
                                  const char *device_name)
 {
     if (!summary || !summary->has_data) {
-        if (ui_dhkValue) {
-            lv_label_set_text(ui_dhkValue, "");
-        }
+        set_kh_value("");
         return;
     }
 
@@ -85,10 +153,10 @@ void display_simple_show_summary(const kh_summary_t *summary,
     }
 
     // dKH atual (número grande)
-    if (ui_dhkValue) {
+    {
         char buf[16];
         format_float(buf, sizeof(buf), summary->kh, 2);
-        lv_label_set_text(ui_dhkValue, buf);
+        set_kh_value(buf);
     }
 
     // MIN / MAX / VAR 24h
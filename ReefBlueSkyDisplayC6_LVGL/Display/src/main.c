@@ -2,6 +2,7 @@
 #include "esp_sntp.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
 
 #include <string.h>
@@ -10,6 +11,7 @@
 
 #include "wifi/WiFiManager.h"
 #include "storage/NVSStorage.h"
+#include "storage/SummaryCache.h"
 #include "led/LEDController.h"
 #include "wifi/AccessPoint.h"
 #include "api/SetupServer.h"
@@ -19,6 +21,7 @@
 #include "display_driver.h" 
 #include "lvgl.h"
 #include "display_simple.h"
+#include "KhTrend.h"
 
 #include "nvs_flash.h"
 #include "nvs.h"
@@ -32,14 +35,6 @@
 #define NVS_NAMESPACE "reefbluesky"
 bool g_wifi_status = false;
 
-typedef struct {
-    float kh;
-    float health; 
-    bool  has_data;
-} cached_summary_t;
-
-static cached_summary_t g_cached_summary;
-
 
 static const char *TAG = "MAIN";
 
@@ -54,9 +49,6 @@ static void ota_event_cb(const char *event, const char *details) {
 
 static void start_setup_mode(void);
 
-void save_cached_summary_to_nvs(const cached_summary_t *c);
-void load_cached_summary_from_nvs(cached_summary_t *c);
-
 
 #define RESET_BTN_GPIO 9 // botão BOOT da placa (GPIO9)
 
@@ -184,6 +176,134 @@ static void reset_button_task(void *arg)
     }
 }
 
+// ---------------------------------------------------------------------------
+// Resumos KH: stream SSE (push) com fallback para polling adaptativo com ETag
+// ---------------------------------------------------------------------------
+
+#define KH_MAX_DEVICES              SUMMARY_CACHE_MAX_DEVICES // igual a g_kh_devices em DisplayClient.c
+#define SUMMARY_ROTATE_MS           19000   // tempo de cada device na tela
+#define SUMMARY_POLL_MIN_MS         20000   // polling logo após mudança
+#define SUMMARY_POLL_MAX_MS         300000  // polling máximo sem mudança (5 min)
+#define SUMMARY_STREAM_RETRY_MIN_MS 5000
+#define SUMMARY_STREAM_RETRY_MAX_MS 600000  // backend sem stream: tenta a cada 10 min
+#define KH_HISTORY_PAGE             64      // pontos por pedido de kh-history
+#define KH_HISTORY_MAX_PAGES        16      // limite por atualização (1024 pontos)
+
+static TaskHandle_t      g_summary_task      = NULL;
+static volatile bool     g_stream_active     = false;
+static volatile int      g_pending_idx       = -1;   // device com delta novo
+
+// Chamado pela task de stream a cada evento: só guarda no SummaryCache e
+// acorda a summary_task, que é quem mexe no LVGL.
+static void on_summary_delta(const char *device_id, const kh_summary_t *summary, void *ctx)
+{
+    int idx = display_client_find_kh_device(device_id);
+    if (idx < 0 || idx >= KH_MAX_DEVICES) return;
+
+    summary_cache_update(device_id, display_client_get_kh_device_name(idx), summary);
+
+    g_stream_active = true;
+    g_pending_idx   = idx;
+    if (g_summary_task) {
+        xTaskNotifyGive(g_summary_task);
+    }
+}
+
+static void summary_stream_task(void *arg)
+{
+    uint32_t retry_ms = SUMMARY_STREAM_RETRY_MIN_MS;
+
+    while (1) {
+        if (!g_wifi_status || display_client_get_kh_device_count() <= 0) {
+            vTaskDelay(pdMS_TO_TICKS(2000));
+            continue;
+        }
+
+        ESP_LOGI(TAG, "summary stream: conectando");
+        esp_err_t err = display_client_stream_kh_summaries(on_summary_delta, NULL);
+        bool was_active = g_stream_active;
+        g_stream_active = false;
+
+        if (err == ESP_ERR_NOT_SUPPORTED) {
+            retry_ms = SUMMARY_STREAM_RETRY_MAX_MS;
+        } else if (was_active) {
+            retry_ms = SUMMARY_STREAM_RETRY_MIN_MS;  // caiu depois de funcionar
+        } else {
+            retry_ms *= 2;
+            if (retry_ms > SUMMARY_STREAM_RETRY_MAX_MS) retry_ms = SUMMARY_STREAM_RETRY_MAX_MS;
+        }
+
+        ESP_LOGW(TAG, "summary stream: fim (%s), polling até reconectar em %lu ms",
+                 esp_err_to_name(err), (unsigned long)retry_ms);
+        vTaskDelay(pdMS_TO_TICKS(retry_ms));
+    }
+}
+
+// Polling com If-None-Match; o intervalo dobra a cada 304 até SUMMARY_POLL_MAX_MS
+static void summary_poll_device(int idx, const char *kh_id, const char *kh_name)
+{
+    static uint32_t last_poll_ms[KH_MAX_DEVICES];
+    static uint32_t interval_ms[KH_MAX_DEVICES];
+
+    uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
+    if (interval_ms[idx] == 0) interval_ms[idx] = SUMMARY_POLL_MIN_MS;
+    if (last_poll_ms[idx] != 0 && now - last_poll_ms[idx] < interval_ms[idx]) {
+        return;
+    }
+    last_poll_ms[idx] = now;
+
+    kh_summary_t summary;
+    bool changed = true;
+    if (display_client_fetch_kh_summary_cond(kh_id, &summary, &changed) != ESP_OK) {
+        return;
+    }
+
+    if (changed) {
+        summary_cache_update(kh_id, kh_name, &summary);
+        interval_ms[idx] = SUMMARY_POLL_MIN_MS;
+    } else {
+        interval_ms[idx] *= 2;
+        if (interval_ms[idx] > SUMMARY_POLL_MAX_MS) interval_ms[idx] = SUMMARY_POLL_MAX_MS;
+        ESP_LOGI(TAG, "Device %s sem mudança, próximo poll em %lu ms",
+                 kh_id, (unsigned long)interval_ms[idx]);
+    }
+}
+
+// Sparkline: backfill da janela na 1ª vez, depois só pontos mais novos que o
+// último visto; sem rede, semeia com o histórico do SummaryCache.
+// O backend pagina em ordem crescente: pede de novo a partir do último ponto
+// até vir página incompleta (depois de queda longa não fica buraco).
+static void summary_update_trend(const char *kh_id, const kh_summary_t *summary, bool offline)
+{
+    static kh_history_point_t pts[KH_HISTORY_PAGE];
+
+    time_t last = kh_trend_last_ts(kh_id);
+    if (!offline && summary->ts != 0 && summary->ts > last) {
+        time_t window_start = time(NULL) - KH_TREND_WINDOW_S;
+        time_t since = last > window_start ? last : window_start;
+        int total = 0;
+        for (int page = 0; page < KH_HISTORY_MAX_PAGES; page++) {
+            int n = display_client_fetch_kh_history(kh_id, since, pts, KH_HISTORY_PAGE);
+            if (n <= 0) break;
+            kh_trend_add_points(kh_id, pts, n);
+            total += n;
+            since = pts[n - 1].ts;
+            if (n < KH_HISTORY_PAGE) break;
+        }
+        if (total > 0) return;
+    }
+
+    if (last == 0) {
+        summary_point_t cached[SUMMARY_CACHE_POINTS];
+        int n = summary_cache_get_history(kh_id, cached, SUMMARY_CACHE_POINTS);
+        for (int i = 0; i < n; i++) {
+            pts[i].ts = (time_t)cached[i].ts;
+            pts[i].kh = cached[i].kh_centi / 100.0f;
+        }
+        kh_trend_add_points(kh_id, pts, n);
+    }
+}
+
 static void summary_task(void *arg)
 {
     vTaskDelay(pdMS_TO_TICKS(5000)); // espera 5s antes do primeiro ciclo
@@ -192,36 +312,56 @@ static void summary_task(void *arg)
 
     static uint32_t last_ping_ms = 0;
     static uint32_t last_cmd_ms  = 0;
+    static int      rotate_idx   = 0;
 
-    // Loop principal (por enquanto só LED + resumo KH)
+    // Loop principal: rotação dos devices na tela + LED; dados chegam pelo
+    // stream (on_summary_delta) ou, sem stream, pelo polling condicional.
     while (1) {
         led_off();
-        vTaskDelay(pdMS_TO_TICKS(19000));
 
-        led_set_rgb(255, 255, 255);
-        vTaskDelay(pdMS_TO_TICKS(1000));
-        led_off();
+        // acorda antes do fim da rotação se chegar delta do stream
+        bool pushed = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SUMMARY_ROTATE_MS)) > 0;
+
+        if (!pushed) {
+            led_set_rgb(255, 255, 255);
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            led_off();
+        }
 
-        int count = display_client_get_kh_device_count();
+        // Sem lista do backend (boot offline): roda pelos devices do cache
+        bool offline = display_client_get_kh_device_count() <= 0;
+        int count = offline ? summary_cache_device_count()
+                            : display_client_get_kh_device_count();
+        if (count > KH_MAX_DEVICES) count = KH_MAX_DEVICES;
         if (count > 0) {
-            static int idx = 0;
+            int idx;
+            if (pushed && g_pending_idx >= 0 && g_pending_idx < count) {
+                idx = g_pending_idx;          // mostra já o device que mudou
+                rotate_idx = (idx + 1) % count;
+            } else {
+                idx = rotate_idx % count;
+                rotate_idx = (idx + 1) % count;
+            }
+            g_pending_idx = -1;
 
-            const char *kh_id   = display_client_get_kh_device_id(idx);
-            const char *kh_name = display_client_get_kh_device_name(idx);
+            const char *kh_id   = offline ? summary_cache_device_id(idx)
+                                          : display_client_get_kh_device_id(idx);
+            const char *kh_name = offline ? summary_cache_device_name(idx)
+                                          : display_client_get_kh_device_name(idx);
+
+            if (kh_id && !offline && !g_stream_active) {
+                summary_poll_device(idx, kh_id, kh_name);
+            }
 
-            kh_summary_t summary;
-            if (kh_id &&
-                display_client_fetch_kh_summary_for(kh_id, &summary) == ESP_OK &&
-                summary.has_data) {
+            kh_summary_t summary = {0};
+            if (kh_id && summary_cache_get(kh_id, &summary)) {
                 
                 // Atualiza a UI (SquareLine) via wrapper
                 display_simple_show_summary(&summary, kh_name);
 
-                // Atualiza cache simples para uso offline
-                g_cached_summary.kh       = summary.kh;
-                g_cached_summary.health   = summary.health;
-                g_cached_summary.has_data = true;
-                save_cached_summary_to_nvs(&g_cached_summary);
+                // Tendência: troca o device do sparkline e acrescenta só o que é novo
+                kh_trend_show(kh_id);
+                summary_update_trend(kh_id, &summary, offline);
 
                 // LED de saúde
                 float h = summary.health;
@@ -236,8 +376,9 @@ static void summary_task(void *arg)
                     led_set_rgb(255, 0, 0);     // vermelho
                 }
 
-                ESP_LOGI(TAG, "Device %s (%s): KH=%.2f health=%.2f",
-                        kh_name, kh_id, summary.kh, summary.health);
+                ESP_LOGI(TAG, "Device %s (%s): KH=%.2f health=%.2f%s",
+                        kh_name, kh_id, summary.kh, summary.health,
+                        pushed ? " [push]" : "");
 
                 // Spinner OFF após atualizar
                 display_simple_set_loading(false, NULL);
@@ -245,7 +386,7 @@ static void summary_task(void *arg)
 
             // Ping do LCD para este KH (idx atual) a cada 30s
             uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
-            if (kh_id && (now - last_ping_ms > 30000)) { // 30 s
+            if (kh_id && !offline && (now - last_ping_ms > 30000)) { // 30 s
                 if (display_client_ping_lcd(kh_id) == ESP_OK) {
                     last_ping_ms = now;
                     ESP_LOGI(TAG, "Ping LCD OK para %s", kh_id);
@@ -254,10 +395,11 @@ static void summary_task(void *arg)
                 }
             }
 
-            idx = (idx + 1) % count;
-
          }
 
+        // Grava no NVS o que mudou pouco (min/max/saúde) só de tempos em tempos
+        summary_cache_tick();
+
         // Checar comando OTA do display a cada 30s
         uint32_t now = xTaskGetTickCount() * portTICK_PERIOD_MS;
         if (now - last_cmd_ms > 30000) { // 30 s
@@ -268,30 +410,6 @@ static void summary_task(void *arg)
     }
 }
 
-void save_cached_summary_to_nvs(const cached_summary_t *c) {
-    nvs_handle_t handle;
-    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) return;
-
-    nvs_set_blob(handle, "summary", c, sizeof(cached_summary_t));
-    nvs_commit(handle);
-    nvs_close(handle);
-}
-
-void load_cached_summary_from_nvs(cached_summary_t *c) {
-    size_t size = sizeof(cached_summary_t);
-    nvs_handle_t handle;
-    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
-        memset(c, 0, sizeof(*c));
-        return;
-    }
-
-    if (nvs_get_blob(handle, "summary", c, &size) != ESP_OK) {
-        memset(c, 0, sizeof(*c));
-    }
-
-    nvs_close(handle);
-}
-
 static void wifi_watchdog_task(void *arg)
 {
     while (1) {
@@ -331,19 +449,19 @@ void app_main(void)
     vTaskDelay(pdMS_TO_TICKS(1000));
     led_off();
 
-    // Carrega último resumo salvo (se existir)
-    load_cached_summary_from_nvs(&g_cached_summary);
+    // Carrega resumos + histórico salvos (se existirem)
+    summary_cache_init();
 
     // Inicializa display + LVGL + UI (SquareLine) via wrapper
     display_simple_init();
 
     // Se tiver cache válido, mostra algo imediatamente na tela
-    /*if (g_cached_summary.has_data) {
-        // Aqui você escolhe um nome default ou o último nome conhecido
-        display_simple_show_cached_summary(g_cached_summary.kh,
-                                           g_cached_summary.health,
-                                           "Último KH");
-    }*/
+    if (summary_cache_device_count() > 0) {
+        kh_summary_t cached;
+        if (summary_cache_get(summary_cache_device_id(0), &cached)) {
+            display_simple_show_summary(&cached, summary_cache_device_name(0));
+        }
+    }
 
     // WiFi stack
     ESP_ERROR_CHECK(wifi_manager_init());
@@ -355,7 +473,10 @@ void app_main(void)
     xTaskCreate(reset_button_task, "reset_button", 2048, NULL, 5, NULL);
 
     // Task de resumo / rotação dos devices
-    xTaskCreate(summary_task, "summary", 8192, NULL, 5, NULL);
+    xTaskCreate(summary_task, "summary", 8192, NULL, 5, &g_summary_task);
+
+    // Stream SSE dos resumos (push); sem ele a summary_task faz polling
+    xTaskCreate(summary_stream_task, "summary_stream", 8192, NULL, 5, NULL);
 
     xTaskCreate(wifi_watchdog_task, "wifi_watchdog", 4096, NULL, 4, NULL);
 
@@ -1,21 +1,70 @@
 //LcdOta.c
 #include "LcdOta.h"
+#include "FwDelta.h"
+#include "FwVersion.h"
 #include "esp_http_client.h"
 #include "esp_ota_ops.h"
+#include "esp_partition.h"
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "mbedtls/sha256.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
 
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 
+// Produtor/consumidor: lcd_ota_update() lê o HTTP e enche buffers de
+// OTA_BUF_SIZE; a task "ota_wr" atualiza o SHA-256 e grava cada buffer
+// direto na partição OTA. Cada buffer cheio é 1 setor, então o offset
+// gravado é sempre alinhado e vai para a NVS a cada OTA_NVS_EVERY bytes.
+//
+// Antes da imagem completa tenta /ota/lcd/latest.delta: um patch RBSD
+// (backend/fwdelta) aplicado sobre a partição em execução, cuja saída entra
+// nos mesmos buffers da task de gravação.
+
+#define OTA_BUF_SIZE         4096          // = setor da flash
+#define OTA_BUF_COUNT        2
+#define OTA_NVS_EVERY        (64 * 1024)   // poupa a NVS: 1 escrita a cada 16 setores
+#define OTA_MAX_RECONNECTS   5
+#define OTA_NVS_NS           "ota_resume"
 
 static const char *TAG = "LCD_OTA";
 
 static char g_base_url[128] = "http://iot.reefbluesky.com.br";
 static lcd_ota_progress_cb_t g_prog_cb = NULL;
 static lcd_ota_event_cb_t g_event_cb = NULL;
+static lcd_ota_stats_t g_stats;
+
+typedef struct {
+    uint8_t  idx;
+    uint16_t len;   // 0 = fim, task de gravação encerra
+} ota_chunk_t;
+
+// Identidade do arquivo no servidor (preenchida pelo event handler do HTTP)
+typedef struct {
+    char     sha256[65];   // X-Firmware-SHA256 ou ""
+    char     etag[48];
+    char     range[64];    // Content-Range
+} ota_source_t;
+
+typedef struct {
+    const esp_partition_t *part;
+    uint8_t               *buf[OTA_BUF_COUNT];
+    QueueHandle_t          free_q;   // índices livres para o leitor
+    QueueHandle_t          full_q;   // ota_chunk_t prontos para gravar
+    SemaphoreHandle_t      done;
+    mbedtls_sha256_context sha;
+    volatile uint32_t      flashed;
+    volatile esp_err_t     err;
+} ota_writer_t;
 
 void lcd_ota_init(const char *base_url,
                   lcd_ota_progress_cb_t progress_cb,
@@ -30,120 +79,630 @@ void lcd_ota_init(const char *base_url,
     ESP_LOGI(TAG, "Init OTA base_url=%s", g_base_url);
 }
 
+lcd_ota_stats_t lcd_ota_get_stats(void)
+{
+    return g_stats;
+}
+
 static void evt(const char *ev, const char *details)
 {
     if (g_event_cb) g_event_cb(ev, details ? details : "");
     ESP_LOGI(TAG, "[%s] %s", ev, details ? details : "");
 }
 
-bool lcd_ota_update(void)
+// ---------- NVS: offset para retomar depois de reboot ----------
+
+static void resume_id(const ota_source_t *src, uint32_t total, char *out, size_t n)
 {
-    esp_err_t err;
-    char url[256];
-    snprintf(url, sizeof(url), "%s/ota/lcd/latest.bin", g_base_url);
+    if (src->sha256[0]) snprintf(out, n, "%s", src->sha256);
+    else                snprintf(out, n, "%s:%lu", src->etag, (unsigned long)total);
+}
 
-    evt("started", url);
+static void resume_begin(const char *url, const char *id, const char *part,
+                         uint32_t total, uint32_t offset)
+{
+    nvs_handle_t h;
+    if (nvs_open(OTA_NVS_NS, NVS_READWRITE, &h) != ESP_OK) return;
+    nvs_set_str(h, "url", url);
+    nvs_set_str(h, "id", id);
+    nvs_set_str(h, "part", part);
+    nvs_set_u32(h, "total", total);
+    nvs_set_u32(h, "off", offset);
+    nvs_commit(h);
+    nvs_close(h);
+}
+
+static void resume_set_offset(uint32_t offset)
+{
+    nvs_handle_t h;
+    if (nvs_open(OTA_NVS_NS, NVS_READWRITE, &h) != ESP_OK) return;
+    nvs_set_u32(h, "off", offset);
+    nvs_commit(h);
+    nvs_close(h);
+}
+
+static void resume_clear(void)
+{
+    nvs_handle_t h;
+    if (nvs_open(OTA_NVS_NS, NVS_READWRITE, &h) != ESP_OK) return;
+    nvs_erase_all(h);
+    nvs_commit(h);
+    nvs_close(h);
+}
+
+// Offset salvo para esta URL/partição (0 = nada a retomar)
+static uint32_t resume_load(const char *url, const esp_partition_t *part,
+                            char *id, size_t id_len, uint32_t *total)
+{
+    nvs_handle_t h;
+    if (nvs_open(OTA_NVS_NS, NVS_READONLY, &h) != ESP_OK) return 0;
+
+    char saved_url[256] = "", saved_part[17] = "";
+    size_t n1 = sizeof(saved_url), n2 = sizeof(saved_part);
+    uint32_t off = 0;
+    *total = 0;
+    id[0] = '\0';
+
+    if (nvs_get_str(h, "url", saved_url, &n1) == ESP_OK &&
+        nvs_get_str(h, "part", saved_part, &n2) == ESP_OK &&
+        strcmp(saved_url, url) == 0 && strcmp(saved_part, part->label) == 0) {
+        nvs_get_str(h, "id", id, &id_len);
+        nvs_get_u32(h, "total", total);
+        nvs_get_u32(h, "off", &off);
+    }
+    nvs_close(h);
+
+    if (off % OTA_BUF_SIZE || off >= *total) off = 0;
+    return off;
+}
+
+// ---------- Task de gravação ----------
+
+static void writer_task(void *arg)
+{
+    ota_writer_t *w = (ota_writer_t *)arg;
+    ota_chunk_t c;
+
+    while (xQueueReceive(w->full_q, &c, portMAX_DELAY) == pdTRUE && c.len > 0) {
+        if (w->err == ESP_OK) {
+            uint8_t *b = w->buf[c.idx];
+            mbedtls_sha256_update(&w->sha, b, c.len);
+
+            // último bloco pode ser curto: completa até múltiplo de 4 com 0xFF
+            size_t wlen = (c.len + 3) & ~3u;
+            memset(b + c.len, 0xFF, wlen - c.len);
+
+            esp_err_t e = esp_partition_erase_range(w->part, w->flashed, OTA_BUF_SIZE);
+            if (e == ESP_OK) e = esp_partition_write(w->part, w->flashed, b, wlen);
+            if (e == ESP_OK) {
+                w->flashed += c.len;
+                if (w->flashed % OTA_NVS_EVERY == 0) resume_set_offset(w->flashed);
+            } else {
+                w->err = e;
+            }
+        }
+        xQueueSend(w->free_q, &c.idx, portMAX_DELAY);
+    }
+
+    xSemaphoreGive(w->done);
+    vTaskDelete(NULL);
+}
+
+static void free_writer(ota_writer_t *w)
+{
+    for (int i = 0; i < OTA_BUF_COUNT; i++) free(w->buf[i]);
+    if (w->free_q) vQueueDelete(w->free_q);
+    if (w->full_q) vQueueDelete(w->full_q);
+    if (w->done)   vSemaphoreDelete(w->done);
+    mbedtls_sha256_free(&w->sha);
+}
+
+static bool alloc_writer(ota_writer_t *w, const esp_partition_t *part)
+{
+    memset(w, 0, sizeof(*w));
+    mbedtls_sha256_init(&w->sha);
+    mbedtls_sha256_starts(&w->sha, 0);
+    w->part   = part;
+    w->free_q = xQueueCreate(OTA_BUF_COUNT, sizeof(uint8_t));
+    w->full_q = xQueueCreate(OTA_BUF_COUNT + 1, sizeof(ota_chunk_t));
+    w->done   = xSemaphoreCreateBinary();
+    for (int i = 0; i < OTA_BUF_COUNT; i++) w->buf[i] = malloc(OTA_BUF_SIZE);
+    return w->free_q && w->full_q && w->done && w->buf[0] && w->buf[1];
+}
+
+static bool start_writer(ota_writer_t *w)
+{
+    for (uint8_t i = 0; i < OTA_BUF_COUNT; i++) xQueueSend(w->free_q, &i, 0);
+    return xTaskCreate(writer_task, "ota_wr", 4096, w, 6, NULL) == pdPASS;
+}
+
+// Encerra a task de gravação (drena o que estiver na fila) e fecha o SHA-256
+static void stop_writer(ota_writer_t *w, uint8_t digest[32])
+{
+    ota_chunk_t end = { 0, 0 };
+    xQueueSend(w->full_q, &end, portMAX_DELAY);
+    xSemaphoreTake(w->done, portMAX_DELAY);
+    mbedtls_sha256_finish(&w->sha, digest);
+}
 
+// Próximo buffer livre para o leitor (-1 = timeout da gravação)
+static int take_buffer(ota_writer_t *w)
+{
+    uint8_t idx;
+    int64_t tw = esp_timer_get_time();
+    if (xQueueReceive(w->free_q, &idx, pdMS_TO_TICKS(30000)) != pdTRUE) return -1;
+    g_stats.flash_wait_ms += (uint32_t)((esp_timer_get_time() - tw) / 1000);
+    return idx;
+}
+
+// ---------- HTTP ----------
+
+static esp_err_t http_event(esp_http_client_event_t *e)
+{
+    ota_source_t *src = (ota_source_t *)e->user_data;
+    if (e->event_id != HTTP_EVENT_ON_HEADER || !src) return ESP_OK;
+
+    if (strcasecmp(e->header_key, "X-Firmware-SHA256") == 0) {
+        snprintf(src->sha256, sizeof(src->sha256), "%s", e->header_value);
+        for (char *p = src->sha256; *p; p++) if (*p >= 'A' && *p <= 'F') *p += 'a' - 'A';
+    } else if (strcasecmp(e->header_key, "ETag") == 0) {
+        snprintf(src->etag, sizeof(src->etag), "%s", e->header_value);
+    } else if (strcasecmp(e->header_key, "Content-Range") == 0) {
+        snprintf(src->range, sizeof(src->range), "%s", e->header_value);
+    }
+    return ESP_OK;
+}
+
+// GET com Range (se from > 0). Retorna o status HTTP (-1 = falha de conexão,
+// -2 = 206 fora do offset pedido) e o tamanho total do arquivo em *total.
+static int http_open_from(esp_http_client_handle_t client, ota_source_t *src,
+                          uint32_t from, uint32_t *total)
+{
+    char range[32];
+    memset(src, 0, sizeof(*src));
+    *total = 0;
+
+    if (from > 0) {
+        snprintf(range, sizeof(range), "bytes=%lu-", (unsigned long)from);
+        esp_http_client_set_header(client, "Range", range);
+    } else {
+        esp_http_client_delete_header(client, "Range");
+    }
+
+    if (esp_http_client_open(client, 0) != ESP_OK) return -1;
+    int64_t len = esp_http_client_fetch_headers(client);
+    int status = esp_http_client_get_status_code(client);
+
+    if (status == 206) {
+        unsigned long start = 0, end = 0, all = 0;
+        if (sscanf(src->range, "bytes %lu-%lu/%lu", &start, &end, &all) != 3 || start != from) {
+            return -2;
+        }
+        *total = (uint32_t)all;
+    } else if (status == 200 && len > 0) {
+        *total = (uint32_t)len;
+    }
+    return status;
+}
+
+// Conexão caiu em 'received': reabre com Range a partir dali. false = desistir
+// (*error preenchido); true = seguir lendo, mesmo que esta tentativa falhe.
+static bool http_resume(esp_http_client_handle_t client, ota_source_t *src,
+                        uint32_t received, uint32_t total, const char *id,
+                        const char **error)
+{
+    static ota_source_t again;
+    char msg[16];
+
+    esp_http_client_close(client);
+    if (++g_stats.reconnects > OTA_MAX_RECONNECTS) {
+        *error = "http_read";
+        return false;
+    }
+    ESP_LOGW(TAG, "Conexão caiu em %lu/%lu, retomando (%u/%d)", (unsigned long)received,
+             (unsigned long)total, g_stats.reconnects, OTA_MAX_RECONNECTS);
+    snprintf(msg, sizeof(msg), "%lu", (unsigned long)received);
+    evt("resuming", msg);
+    vTaskDelay(pdMS_TO_TICKS(1000 * g_stats.reconnects));
+
+    uint32_t again_total = 0;
+    char again_id[72];
+    esp_http_client_set_user_data(client, &again);
+    int code = http_open_from(client, &again, received, &again_total);
+    esp_http_client_set_user_data(client, src);
+    if (code == 206) {
+        resume_id(&again, again_total, again_id, sizeof(again_id));
+        if (again_total != total || strcmp(again_id, id) != 0) {
+            *error = "firmware_changed";
+            return false;
+        }
+    } else {
+        ESP_LOGW(TAG, "Retomada falhou: HTTP %d", code);
+        esp_http_client_close(client);   // próxima leitura falha e tenta de novo
+    }
+    return true;
+}
+
+static void progress(uint32_t received, uint32_t total, uint32_t base, int64_t t0, int *last_pct)
+{
+    int64_t dt_us = esp_timer_get_time() - t0;
+    if (dt_us > 0) {
+        g_stats.bytes_per_sec = (uint32_t)((uint64_t)(received - base) * 1000000 / dt_us);
+    }
+
+    int pct = (int)((uint64_t)received * 100 / total);
+    if (pct == *last_pct) return;
+    *last_pct = pct;
+    if (g_prog_cb) g_prog_cb(pct);
+    if (pct % 10 == 0) {
+        ESP_LOGI(TAG, "%d%% (%lu/%lu) %lu KB/s, espera flash %lu ms", pct,
+                 (unsigned long)received, (unsigned long)total,
+                 (unsigned long)(g_stats.bytes_per_sec / 1024),
+                 (unsigned long)g_stats.flash_wait_ms);
+    }
+}
+
+static bool fail(esp_http_client_handle_t client, const char *details)
+{
+    if (client) {
+        esp_http_client_close(client);
+        esp_http_client_cleanup(client);
+    }
+    evt("failed", details);
+    return false;
+}
+
+// Imagem gravada e conferida: troca a partição de boot e reinicia
+static bool commit(const esp_partition_t *part)
+{
+    // Valida a imagem (cabeçalho/checksum do app) e troca a partição de boot
+    esp_err_t err = esp_ota_set_boot_partition(part);
+    resume_clear();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "set_boot_partition: %s", esp_err_to_name(err));
+        return fail(NULL, "set_boot_partition");
+    }
+
+    evt("success", "rebooting");
+    vTaskDelay(pdMS_TO_TICKS(2000));
+    esp_restart();
+    return true;
+}
+
+// ---------- OTA delta ----------
+
+typedef struct {
+    ota_writer_t          *w;
+    const esp_partition_t *running;
+    int                    cur;
+    uint32_t               fill;
+} delta_sink_t;
+
+static int delta_read_old(void *user, uint32_t off, uint8_t *buf, uint32_t len)
+{
+    delta_sink_t *s = (delta_sink_t *)user;
+    return esp_partition_read(s->running, off, buf, len) == ESP_OK ? 0 : -1;
+}
+
+static int delta_write(void *user, const uint8_t *data, uint32_t len)
+{
+    delta_sink_t *s = (delta_sink_t *)user;
+    ota_writer_t *w = s->w;
+
+    while (len > 0) {
+        if (w->err != ESP_OK) return -1;
+        if (s->cur < 0) {
+            s->cur = take_buffer(w);
+            if (s->cur < 0) return -1;
+            s->fill = 0;
+        }
+        uint32_t n = OTA_BUF_SIZE - s->fill;
+        if (n > len) n = len;
+        memcpy(w->buf[s->cur] + s->fill, data, n);
+        s->fill += n;
+        data += n;
+        len -= n;
+        if (s->fill == OTA_BUF_SIZE) {
+            ota_chunk_t c = { .idx = (uint8_t)s->cur, .len = OTA_BUF_SIZE };
+            xQueueSend(w->full_q, &c, portMAX_DELAY);
+            s->cur = -1;
+        }
+    }
+    return 0;
+}
+
+// Confere o firmware em execução com o old_sha256 do patch
+static bool delta_check_old(fwd_ctx_t *fwd, const esp_partition_t *running, uint8_t *buf)
+{
+    if (fwd->hdr.old_size > running->size) return false;
+
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    bool ok = true;
+    for (uint32_t pos = 0; pos < fwd->hdr.old_size && ok; pos += OTA_BUF_SIZE) {
+        uint32_t n = fwd->hdr.old_size - pos;
+        if (n > OTA_BUF_SIZE) n = OTA_BUF_SIZE;
+        ok = fwd_read_old(fwd, pos, buf, n) == FWD_OK;
+        if (ok) mbedtls_sha256_update(&sha, buf, n);
+    }
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&sha, digest);
+    mbedtls_sha256_free(&sha);
+    return ok && memcmp(digest, fwd->hdr.old_sha256, 32) == 0;
+}
+
+// true = imagem nova gravada em update_part e conferida; false = usar a
+// imagem completa (sem patch para esta versão ou qualquer falha)
+static bool delta_update(const esp_partition_t *update_part)
+{
+    char url[256];
+    snprintf(url, sizeof(url), "%s/ota/lcd/latest.delta?from=%s", g_base_url, FW_VERSION);
+
+    static ota_source_t src;
     esp_http_client_config_t cfg = {
         .url = url,
-        .timeout_ms = 30000,
-        // HTTPS: aqui você adicionaria .cert_pem se for https
+        .timeout_ms = 15000,
+        .event_handler = http_event,
+        .user_data = &src,
     };
-
     esp_http_client_handle_t client = esp_http_client_init(&cfg);
-    if (!client) {
-        evt("failed", "http_client_init");
+    if (!client) return false;
+
+    uint32_t total = 0;
+    int status = http_open_from(client, &src, 0, &total);
+    if (status != 200 || total == 0) {
+        ESP_LOGI(TAG, "Sem patch delta (HTTP %d), usando imagem completa", status);
+        esp_http_client_close(client);
+        esp_http_client_cleanup(client);
         return false;
     }
+    char id[72];
+    resume_id(&src, total, id, sizeof(id));
+    evt("started", url);
 
-    err = esp_http_client_open(client, 0);
-    if (err != ESP_OK) {
+    static ota_writer_t w;
+    if (!alloc_writer(&w, update_part)) {
+        free_writer(&w);
+        esp_http_client_close(client);
         esp_http_client_cleanup(client);
-        evt("failed", "http_open");
         return false;
     }
 
-    int content_length = esp_http_client_fetch_headers(client);
-    if (content_length <= 0) {
-        ESP_LOGW(TAG, "Content-Length <= 0 (%d)", content_length);
+    static fwd_ctx_t fwd;      // ~2.5 KB, fora da pilha
+    static uint8_t in[1024];
+    delta_sink_t sink = { .w = &w, .running = esp_ota_get_running_partition(), .cur = -1 };
+    fwd_init(&fwd, delta_read_old, delta_write, &sink);
+
+    const char *error = NULL;
+    bool writing = false;
+    uint32_t received = 0;
+    int r = FWD_OK;
+    int last_pct = -1;
+    int64_t t0 = esp_timer_get_time();
+
+    while (r != FWD_DONE && !error) {
+        if (received >= total) { error = "delta_truncated"; break; }
+
+        uint32_t want = total - received;
+        if (want > sizeof(in)) want = sizeof(in);
+        int n = esp_http_client_read(client, (char *)in, want);
+        if (n <= 0) {
+            if (!http_resume(client, &src, received, total, id, &error)) break;
+            continue;
+        }
+        received += n;
+
+        const uint8_t *p = in;
+        size_t len = (size_t)n;
+        while (len > 0 && r != FWD_DONE) {
+            size_t used = 0;
+            r = fwd_feed(&fwd, p, len, &used);
+            p += used;
+            len -= used;
+            if (r < 0) { error = "delta_invalid"; break; }
+            if (r == FWD_HEADER) {
+                // w.buf[1] ainda está livre: a task de gravação só começa depois
+                if (!delta_check_old(&fwd, sink.running, w.buf[1])) { error = "delta_old_mismatch"; break; }
+                if (fwd.hdr.new_size > update_part->size) { error = "invalid_size"; break; }
+                // a partição vai ser sobrescrita: parcial do download completo deixa de valer
+                resume_clear();
+                if (!start_writer(&w)) { error = "writer_task"; break; }
+                writing = true;
+            }
+        }
+        progress(received, total, 0, t0, &last_pct);
     }
 
+    esp_http_client_close(client);
+    esp_http_client_cleanup(client);
+
+    uint8_t digest[32];
+    if (writing) {
+        // último bloco curto ainda no buffer do sink
+        if (!error && sink.cur >= 0 && sink.fill > 0) {
+            ota_chunk_t c = { .idx = (uint8_t)sink.cur, .len = (uint16_t)sink.fill };
+            xQueueSend(w.full_q, &c, portMAX_DELAY);
+        }
+        stop_writer(&w, digest);
+    }
+    if (!error && !writing) error = "delta_invalid";
+    if (!error && w.err != ESP_OK) error = "flash_write";
+    if (!error && (w.flashed != fwd.hdr.new_size || memcmp(digest, fwd.hdr.new_sha256, 32) != 0)) {
+        error = "delta_sha256_mismatch";
+    }
+    free_writer(&w);
+
+    ESP_LOGI(TAG, "Delta: %lu/%lu bytes de patch -> %lu bytes, %lu KB/s",
+             (unsigned long)received, (unsigned long)total,
+             (unsigned long)fwd.hdr.new_size, (unsigned long)(g_stats.bytes_per_sec / 1024));
+    if (error) {
+        ESP_LOGW(TAG, "Delta falhou (%s), usando imagem completa", error);
+        evt("delta_failed", error);
+        return false;
+    }
+    return true;
+}
+
+bool lcd_ota_update(void)
+{
+    char url[256];
+    char msg[96];
+
+    memset(&g_stats, 0, sizeof(g_stats));
+
     const esp_partition_t *running = esp_ota_get_running_partition();
     ESP_LOGI("PART", "Running partition: type=%d, subtype=%d, addr=0x%08x, size=0x%x",
             running->type, running->subtype, running->address, running->size);
 
     const esp_partition_t *update_part = esp_ota_get_next_update_partition(NULL);
-    if (!update_part) {
-        esp_http_client_close(client);
-        esp_http_client_cleanup(client);
-        evt("failed", "no_update_partition");
-        return false;
-    }
+    if (!update_part) return fail(NULL, "no_update_partition");
 
     ESP_LOGI("PART", "Update partition: type=%d, subtype=%d, addr=0x%08x, size=0x%x",
             update_part->type, update_part->subtype, update_part->address, update_part->size);
 
+    // Patch delta a partir do firmware em execução; sem patch -> imagem completa
+    if (delta_update(update_part)) return commit(update_part);
 
-    esp_ota_handle_t ota_handle = 0;
-    err = esp_ota_begin(update_part,
-                        (content_length > 0) ? content_length : OTA_SIZE_UNKNOWN,
-                        &ota_handle);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "ota_begin failed: %s (0x%x)", esp_err_to_name(err), err);
+    memset(&g_stats, 0, sizeof(g_stats));
+    snprintf(url, sizeof(url), "%s/ota/lcd/latest.bin", g_base_url);
+    evt("started", url);
+
+    static ota_source_t src;   // fora da pilha: usado pelo event handler
+    esp_http_client_config_t cfg = {
+        .url = url,
+        .timeout_ms = 15000,
+        .event_handler = http_event,
+        .user_data = &src,
+        // HTTPS: aqui você adicionaria .cert_pem se for https
+    };
+
+    esp_http_client_handle_t client = esp_http_client_init(&cfg);
+    if (!client) return fail(NULL, "http_client_init");
+
+    // Retomada após reboot: só vale se o servidor devolver 206 do mesmo arquivo
+    char saved_id[72], id[72];
+    uint32_t saved_total = 0, total = 0;
+    uint32_t offset = resume_load(url, update_part, saved_id, sizeof(saved_id), &saved_total);
+
+    int status = http_open_from(client, &src, offset, &total);
+    resume_id(&src, total, id, sizeof(id));
+    if (offset > 0 && (status != 206 || total != saved_total || strcmp(id, saved_id) != 0)) {
+        ESP_LOGW(TAG, "Parcial de %lu bytes descartado (HTTP %d)", (unsigned long)offset, status);
         esp_http_client_close(client);
-        esp_http_client_cleanup(client);
-        evt("failed", "ota_begin");
-        return false;
+        offset = 0;
+        status = http_open_from(client, &src, 0, &total);
+        resume_id(&src, total, id, sizeof(id));
     }
+    ESP_LOGI(TAG, "HTTP %d, total=%lu, sha256=%s", status, (unsigned long)total,
+             src.sha256[0] ? src.sha256 : "-");
 
+    if (status != 200 && status != 206) {
+        snprintf(msg, sizeof(msg), "http_status %d", status);
+        return fail(client, msg);
+    }
+    if (total == 0 || total > update_part->size) {
+        snprintf(msg, sizeof(msg), "invalid_size %lu", (unsigned long)total);
+        return fail(client, msg);
+    }
 
-    uint8_t buf[1024];
-    int total_read = 0;
-    while (1) {
-        int read = esp_http_client_read(client, (char *)buf, sizeof(buf));
-        if (read < 0) {
-            evt("failed", "http_read");
-            esp_ota_end(ota_handle);
-            esp_http_client_close(client);
-            esp_http_client_cleanup(client);
-            return false;
-        } else if (read == 0) {
-            break; // fim
+    static ota_writer_t w;
+    if (!alloc_writer(&w, update_part)) {
+        free_writer(&w);
+        return fail(client, "no_mem");
+    }
+
+    // SHA-256 cobre o arquivo inteiro: na retomada, re-hash do que já está na flash
+    for (uint32_t pos = 0; pos < offset; pos += OTA_BUF_SIZE) {
+        if (esp_partition_read(update_part, pos, w.buf[0], OTA_BUF_SIZE) != ESP_OK) {
+            free_writer(&w);
+            resume_clear();
+            return fail(client, "flash_read");
         }
+        mbedtls_sha256_update(&w.sha, w.buf[0], OTA_BUF_SIZE);
+    }
+    w.flashed = offset;
+    g_stats.resumed_from = offset;
+    resume_begin(url, id, update_part->label, total, offset);
 
-        err = esp_ota_write(ota_handle, buf, read);
-        if (err != ESP_OK) {
-            evt("failed", "ota_write");
-            esp_ota_end(ota_handle);
-            esp_http_client_close(client);
-            esp_http_client_cleanup(client);
-            return false;
+    if (offset > 0) {
+        snprintf(msg, sizeof(msg), "%lu/%lu", (unsigned long)offset, (unsigned long)total);
+        evt("resumed", msg);
+    }
+
+    if (!start_writer(&w)) {
+        free_writer(&w);
+        return fail(client, "writer_task");
+    }
+
+    const char *error = NULL;
+    uint32_t received = offset;     // bytes do arquivo já lidos do HTTP
+    int cur = -1;                   // buffer sendo enchido
+    uint32_t fill = 0;
+    int last_pct = -1;
+    int64_t t0 = esp_timer_get_time();
+
+    while (received < total) {
+        if (w.err != ESP_OK) { error = "flash_write"; break; }
+
+        if (cur < 0) {
+            cur = take_buffer(&w);
+            if (cur < 0) { error = "flash_timeout"; break; }
+            fill = 0;
         }
 
-        total_read += read;
-        if (content_length > 0 && g_prog_cb) {
-            int percent = (total_read * 100) / content_length;
-            g_prog_cb(percent);
+        uint32_t want = OTA_BUF_SIZE - fill;
+        if (want > total - received) want = total - received;
+        int n = esp_http_client_read(client, (char *)w.buf[cur] + fill, want);
+
+        if (n > 0) {
+            fill += n;
+            received += n;
+
+            if (fill == OTA_BUF_SIZE || received == total) {
+                ota_chunk_t c = { .idx = (uint8_t)cur, .len = (uint16_t)fill };
+                xQueueSend(w.full_q, &c, portMAX_DELAY);
+                cur = -1;
+                progress(received, total, offset, t0, &last_pct);
+            }
+            continue;
         }
+
+        // n == 0 antes do fim ou erro/timeout de leitura: reabre com Range
+        if (!http_resume(client, &src, received, total, id, &error)) break;
     }
 
+    uint8_t digest[32];
+    stop_writer(&w, digest);
+
     esp_http_client_close(client);
     esp_http_client_cleanup(client);
 
-    err = esp_ota_end(ota_handle);
-    if (err != ESP_OK) {
-        evt("failed", "ota_end");
-        return false;
+    if (!error && w.err != ESP_OK) error = "flash_write";
+    if (!error && w.flashed != total) error = "incomplete";
+    free_writer(&w);
+
+    ESP_LOGI(TAG, "Download: %lu/%lu bytes, %lu KB/s, %u reconexões",
+             (unsigned long)received, (unsigned long)total,
+             (unsigned long)(g_stats.bytes_per_sec / 1024), g_stats.reconnects);
+
+    if (error) {
+        // queda/cancelamento: mantém o offset na NVS para a próxima tentativa
+        return fail(NULL, error);
     }
 
-    err = esp_ota_set_boot_partition(update_part);
-    if (err != ESP_OK) {
-        evt("failed", "set_boot_partition");
-        return false;
+    char hex[65];
+    for (int i = 0; i < 32; i++) sprintf(hex + i * 2, "%02x", digest[i]);
+    if (src.sha256[0]) {
+        if (strcmp(src.sha256, hex) != 0) {
+            ESP_LOGE(TAG, "SHA-256 divergente: %s", hex);
+            resume_clear();
+            return fail(NULL, "sha256_mismatch");
+        }
+        ESP_LOGI(TAG, "SHA-256 OK");
+    } else {
+        ESP_LOGW(TAG, "Servidor sem X-Firmware-SHA256; sha256=%s", hex);
     }
 
-    evt("success", "rebooting");
-    vTaskDelay(pdMS_TO_TICKS(2000));
-    esp_restart();
-    return true;
+    return commit(update_part);
 }
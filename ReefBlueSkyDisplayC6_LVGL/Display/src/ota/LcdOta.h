@@ -3,6 +3,7 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -11,13 +12,26 @@ extern "C" {
 typedef void (*lcd_ota_progress_cb_t)(int percent);
 typedef void (*lcd_ota_event_cb_t)(const char *event, const char *details);
 
+// Métricas do download atual (válidas dentro do progress_cb)
+typedef struct {
+    uint32_t bytes_per_sec;   // média desde o início desta sessão
+    uint32_t resumed_from;    // offset retomado da NVS após reboot (0 = do zero)
+    uint16_t reconnects;      // reconexões com Range dentro da sessão
+    uint32_t flash_wait_ms;   // tempo que o leitor HTTP esperou pela gravação
+} lcd_ota_stats_t;
+
 void lcd_ota_init(const char *base_url,
                   lcd_ota_progress_cb_t progress_cb,
                   lcd_ota_event_cb_t event_cb);
 
 // Baixa /ota/lcd/latest.bin a partir de base_url (ex: "http://iot.reefbluesky.com.br")
+// Leitura HTTP e gravação da flash em tasks separadas (2 buffers de 4 KB),
+// retomada com Range a partir do offset salvo na NVS e SHA-256 conferido
+// com o header X-Firmware-SHA256 antes de trocar a partição de boot.
 bool lcd_ota_update(void);
 
+lcd_ota_stats_t lcd_ota_get_stats(void);
+
 #ifdef __cplusplus
 }
 #endif
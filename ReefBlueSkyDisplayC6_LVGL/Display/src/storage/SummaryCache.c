@@ -0,0 +1,397 @@
+// SummaryCache.c
+#include "SummaryCache.h"
+#include "nvs.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define SUMMARY_CACHE_NAMESPACE "sumcache"
+#define SUMMARY_CACHE_VERSION   1
+#define SUMMARY_CACHE_LEGACY_NS  "reefbluesky"   // blob antigo "summary" (1 valor só)
+
+static const char *TAG = "SummaryCache";
+
+// Formato gravado no NVS, um blob por slot ("d0".."d7").
+// Campos em centésimos para caber em inteiros pequenos.
+typedef struct __attribute__((packed)) {
+    uint8_t  version;
+    uint8_t  count;              // pontos válidos em points[]
+    uint8_t  head;               // próximo slot do ring
+    uint8_t  health_pct;
+    char     device_id[32];
+    char     name[32];
+    uint32_t ts;
+    uint16_t kh_centi;
+    uint16_t kh_min_centi;
+    uint16_t kh_max_centi;
+    int16_t  kh_var_centi;
+    uint8_t  green_dev_centi;
+    uint8_t  yellow_dev_centi;
+    summary_point_t points[SUMMARY_CACHE_POINTS];
+    uint32_t crc32;              // sobre todos os campos acima
+} summary_blob_t;
+
+typedef struct {
+    bool         used;
+    bool         dirty;
+    char         device_id[32];
+    char         name[32];
+    kh_summary_t last;
+    uint8_t      count;
+    uint8_t      head;
+    summary_point_t points[SUMMARY_CACHE_POINTS];
+} summary_entry_t;
+
+static summary_entry_t   g_entries[SUMMARY_CACHE_MAX_DEVICES];
+static SemaphoreHandle_t g_lock            = NULL;
+static uint32_t          g_last_flush_ms   = 0;
+static uint32_t          g_write_count     = 0;
+
+static uint32_t now_ms(void)
+{
+    return xTaskGetTickCount() * portTICK_PERIOD_MS;
+}
+
+static uint16_t to_centi_u16(float v)
+{
+    if (v <= 0.0f) return 0;
+    if (v >= 655.35f) return 65535;
+    return (uint16_t)lroundf(v * 100.0f);
+}
+
+static int16_t to_centi_i16(float v)
+{
+    if (v <= -327.68f) return -32768;
+    if (v >= 327.67f) return 32767;
+    return (int16_t)lroundf(v * 100.0f);
+}
+
+static uint8_t to_centi_u8(float v)
+{
+    if (v <= 0.0f) return 0;
+    if (v >= 2.55f) return 255;
+    return (uint8_t)lroundf(v * 100.0f);
+}
+
+static uint32_t blob_crc(const summary_blob_t *b)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)b, offsetof(summary_blob_t, crc32));
+}
+
+static void entry_to_blob(const summary_entry_t *e, summary_blob_t *b)
+{
+    memset(b, 0, sizeof(*b));
+    b->version = SUMMARY_CACHE_VERSION;
+    b->count   = e->count;
+    b->head    = e->head;
+    memcpy(b->device_id, e->device_id, sizeof(b->device_id));
+    memcpy(b->name, e->name, sizeof(b->name));
+
+    float h = e->last.health;
+    if (h < 0.0f) h = 0.0f;
+    if (h > 1.0f) h = 1.0f;
+    b->health_pct       = (uint8_t)lroundf(h * 100.0f);
+    b->ts               = (uint32_t)e->last.ts;
+    b->kh_centi         = to_centi_u16(e->last.kh);
+    b->kh_min_centi     = to_centi_u16(e->last.kh_min_24h);
+    b->kh_max_centi     = to_centi_u16(e->last.kh_max_24h);
+    b->kh_var_centi     = to_centi_i16(e->last.kh_var_24h);
+    b->green_dev_centi  = to_centi_u8(e->last.health_green_max_dev);
+    b->yellow_dev_centi = to_centi_u8(e->last.health_yellow_max_dev);
+    memcpy(b->points, e->points, sizeof(b->points));
+    b->crc32 = blob_crc(b);
+}
+
+static bool blob_to_entry(const summary_blob_t *b, summary_entry_t *e)
+{
+    if (b->version != SUMMARY_CACHE_VERSION) return false;
+    if (b->crc32 != blob_crc(b)) return false;
+    if (b->count > SUMMARY_CACHE_POINTS || b->head >= SUMMARY_CACHE_POINTS) return false;
+
+    memset(e, 0, sizeof(*e));
+    e->used  = true;
+    e->count = b->count;
+    e->head  = b->head;
+    memcpy(e->device_id, b->device_id, sizeof(e->device_id));
+    e->device_id[sizeof(e->device_id) - 1] = '\0';
+    memcpy(e->name, b->name, sizeof(e->name));
+    e->name[sizeof(e->name) - 1] = '\0';
+
+    e->last.has_data              = true;
+    e->last.ts                    = (time_t)b->ts;
+    e->last.kh                    = b->kh_centi / 100.0f;
+    e->last.kh_min_24h            = b->kh_min_centi / 100.0f;
+    e->last.kh_max_24h            = b->kh_max_centi / 100.0f;
+    e->last.kh_var_24h            = b->kh_var_centi / 100.0f;
+    e->last.health                = b->health_pct / 100.0f;
+    e->last.health_green_max_dev  = b->green_dev_centi / 100.0f;
+    e->last.health_yellow_max_dev = b->yellow_dev_centi / 100.0f;
+    memcpy(e->points, b->points, sizeof(e->points));
+    return true;
+}
+
+// Grava os slots sujos; um nvs_commit só para todos
+static void flush_locked(void)
+{
+    bool any = false;
+    for (int i = 0; i < SUMMARY_CACHE_MAX_DEVICES; i++) {
+        if (g_entries[i].used && g_entries[i].dirty) { any = true; break; }
+    }
+    g_last_flush_ms = now_ms();
+    if (!any) return;
+
+    nvs_handle_t handle;
+    if (nvs_open(SUMMARY_CACHE_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        ESP_LOGE(TAG, "nvs_open falhou");
+        return;
+    }
+
+    summary_blob_t blob;
+    for (int i = 0; i < SUMMARY_CACHE_MAX_DEVICES; i++) {
+        summary_entry_t *e = &g_entries[i];
+        if (!e->used || !e->dirty) continue;
+
+        char key[8];
+        snprintf(key, sizeof(key), "d%d", i);
+        entry_to_blob(e, &blob);
+        if (nvs_set_blob(handle, key, &blob, sizeof(blob)) == ESP_OK) {
+            e->dirty = false;
+        }
+    }
+
+    if (nvs_commit(handle) == ESP_OK) {
+        g_write_count++;
+        ESP_LOGI(TAG, "flush NVS (total desde o boot: %lu)", (unsigned long)g_write_count);
+    }
+    nvs_close(handle);
+}
+
+static void shutdown_flush(void)
+{
+    // esp_restart (OTA, botão de reset): não perder o que está só em RAM
+    if (g_lock && xSemaphoreTake(g_lock, pdMS_TO_TICKS(100)) == pdTRUE) {
+        flush_locked();
+        xSemaphoreGive(g_lock);
+    }
+}
+
+static bool summary_changed(const kh_summary_t *a, const kh_summary_t *b)
+{
+    return a->has_data != b->has_data ||
+           fabsf(a->kh - b->kh) >= 0.005f ||
+           fabsf(a->kh_min_24h - b->kh_min_24h) >= 0.005f ||
+           fabsf(a->kh_max_24h - b->kh_max_24h) >= 0.005f ||
+           fabsf(a->kh_var_24h - b->kh_var_24h) >= 0.005f ||
+           fabsf(a->health - b->health) >= 0.005f ||
+           fabsf(a->health_green_max_dev - b->health_green_max_dev) >= 0.005f ||
+           fabsf(a->health_yellow_max_dev - b->health_yellow_max_dev) >= 0.005f;
+}
+
+static summary_entry_t *find_entry(const char *device_id)
+{
+    for (int i = 0; i < SUMMARY_CACHE_MAX_DEVICES; i++) {
+        if (g_entries[i].used && strcmp(g_entries[i].device_id, device_id) == 0) {
+            return &g_entries[i];
+        }
+    }
+    return NULL;
+}
+
+// Slot livre ou, se cheio, o device com medição mais antiga
+static summary_entry_t *alloc_entry(const char *device_id)
+{
+    summary_entry_t *victim = &g_entries[0];
+    for (int i = 0; i < SUMMARY_CACHE_MAX_DEVICES; i++) {
+        if (!g_entries[i].used) { victim = &g_entries[i]; break; }
+        if (g_entries[i].last.ts < victim->last.ts) victim = &g_entries[i];
+    }
+
+    memset(victim, 0, sizeof(*victim));
+    victim->used = true;
+    strncpy(victim->device_id, device_id, sizeof(victim->device_id) - 1);
+    return victim;
+}
+
+esp_err_t summary_cache_init(void)
+{
+    if (!g_lock) {
+        g_lock = xSemaphoreCreateMutex();
+        if (!g_lock) return ESP_ERR_NO_MEM;
+    }
+
+    memset(g_entries, 0, sizeof(g_entries));
+    g_last_flush_ms = now_ms();
+
+    nvs_handle_t handle;
+    if (nvs_open(SUMMARY_CACHE_NAMESPACE, NVS_READONLY, &handle) == ESP_OK) {
+        summary_blob_t blob;
+        int loaded = 0;
+        for (int i = 0; i < SUMMARY_CACHE_MAX_DEVICES; i++) {
+            char key[8];
+            snprintf(key, sizeof(key), "d%d", i);
+            size_t size = sizeof(blob);
+            if (nvs_get_blob(handle, key, &blob, &size) != ESP_OK || size != sizeof(blob)) {
+                continue;
+            }
+            if (blob_to_entry(&blob, &g_entries[i])) {
+                loaded++;
+            } else {
+                ESP_LOGW(TAG, "slot %s inválido (versão/CRC), ignorando", key);
+            }
+        }
+        nvs_close(handle);
+        ESP_LOGI(TAG, "%d devices carregados do cache", loaded);
+    }
+
+    // remove o blob antigo de 1 valor (cached_summary_t do main.c)
+    if (nvs_open(SUMMARY_CACHE_LEGACY_NS, NVS_READWRITE, &handle) == ESP_OK) {
+        if (nvs_erase_key(handle, "summary") == ESP_OK) {
+            nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+
+    esp_register_shutdown_handler(shutdown_flush);
+    return ESP_OK;
+}
+
+void summary_cache_update(const char *device_id, const char *name,
+                          const kh_summary_t *summary)
+{
+    if (!g_lock || !device_id || !device_id[0] || !summary || !summary->has_data) return;
+
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+
+    summary_entry_t *e = find_entry(device_id);
+    if (!e) e = alloc_entry(device_id);
+
+    if (name && strncmp(e->name, name, sizeof(e->name) - 1) != 0) {
+        strncpy(e->name, name, sizeof(e->name) - 1);
+        e->name[sizeof(e->name) - 1] = '\0';
+        e->dirty = true;
+    }
+
+    // Medição nova: timestamp diferente (ou, sem timestamp do backend, KH diferente)
+    bool new_point;
+    time_t ts = summary->ts;
+    if (ts != 0) {
+        new_point = (ts != e->last.ts);
+    } else {
+        new_point = !e->last.has_data ||
+                    fabsf(summary->kh - e->last.kh) >= 0.01f;
+        ts = new_point ? time(NULL) : e->last.ts;
+    }
+
+    if (new_point) {
+        summary_point_t *p = &e->points[e->head];
+        p->ts       = (uint32_t)ts;
+        p->kh_centi = to_centi_u16(summary->kh);
+        e->head = (e->head + 1) % SUMMARY_CACHE_POINTS;
+        if (e->count < SUMMARY_CACHE_POINTS) e->count++;
+    } else if (summary_changed(&e->last, summary)) {
+        e->dirty = true; // min/max/saúde mudaram: vai no flush por timer
+    }
+
+    e->last    = *summary;
+    e->last.ts = ts;
+
+    if (new_point) {
+        e->dirty = true;
+        flush_locked();
+    }
+
+    xSemaphoreGive(g_lock);
+}
+
+bool summary_cache_get(const char *device_id, kh_summary_t *out)
+{
+    if (!g_lock || !device_id || !out) return false;
+
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    summary_entry_t *e = find_entry(device_id);
+    bool ok = (e != NULL && e->last.has_data);
+    if (ok) *out = e->last;
+    xSemaphoreGive(g_lock);
+    return ok;
+}
+
+int summary_cache_get_history(const char *device_id, summary_point_t *out, int max)
+{
+    if (!g_lock || !device_id || !out || max <= 0) return 0;
+
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    int n = 0;
+    summary_entry_t *e = find_entry(device_id);
+    if (e) {
+        n = e->count < max ? e->count : max;
+        // os n mais novos, do mais antigo para o mais novo
+        int start = (e->head - n + SUMMARY_CACHE_POINTS) % SUMMARY_CACHE_POINTS;
+        for (int i = 0; i < n; i++) {
+            out[i] = e->points[(start + i) % SUMMARY_CACHE_POINTS];
+        }
+    }
+    xSemaphoreGive(g_lock);
+    return n;
+}
+
+int summary_cache_device_count(void)
+{
+    int n = 0;
+    for (int i = 0; i < SUMMARY_CACHE_MAX_DEVICES; i++) {
+        if (g_entries[i].used) n++;
+    }
+    return n;
+}
+
+static const summary_entry_t *nth_used(int index)
+{
+    for (int i = 0; i < SUMMARY_CACHE_MAX_DEVICES; i++) {
+        if (!g_entries[i].used) continue;
+        if (index-- == 0) return &g_entries[i];
+    }
+    return NULL;
+}
+
+const char *summary_cache_device_id(int index)
+{
+    const summary_entry_t *e = nth_used(index);
+    return e ? e->device_id : NULL;
+}
+
+const char *summary_cache_device_name(int index)
+{
+    const summary_entry_t *e = nth_used(index);
+    return e ? (e->name[0] ? e->name : e->device_id) : NULL;
+}
+
+void summary_cache_tick(void)
+{
+    if (!g_lock) return;
+    if (now_ms() - g_last_flush_ms < SUMMARY_CACHE_FLUSH_MS) return;
+
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    flush_locked();
+    xSemaphoreGive(g_lock);
+}
+
+void summary_cache_flush(void)
+{
+    if (!g_lock) return;
+
+    xSemaphoreTake(g_lock, portMAX_DELAY);
+    flush_locked();
+    xSemaphoreGive(g_lock);
+}
+
+uint32_t summary_cache_write_count(void)
+{
+    return g_write_count;
+}
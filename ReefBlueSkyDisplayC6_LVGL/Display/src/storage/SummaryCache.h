@@ -0,0 +1,56 @@
+// SummaryCache.h
+// Cache write-behind dos resumos KH: histórico em RAM por device,
+// gravado no NVS só quando há medição nova, por timer longo ou antes de reboot.
+#pragma once
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include "api/DisplayClient.h" // kh_summary_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SUMMARY_CACHE_MAX_DEVICES 8
+#define SUMMARY_CACHE_POINTS      32        // últimos N pontos por device
+#define SUMMARY_CACHE_FLUSH_MS    (6UL * 3600UL * 1000UL) // flush de mudanças pequenas
+
+// Ponto compacto do histórico (6 bytes no blob)
+typedef struct __attribute__((packed)) {
+    uint32_t ts;        // epoch (s)
+    uint16_t kh_centi;  // KH * 100
+} summary_point_t;
+
+// Carrega os blobs do NVS e registra o flush no shutdown (esp_restart)
+esp_err_t   summary_cache_init(void);
+
+// Aplica um resumo recebido (stream ou polling). Medição nova vira ponto do
+// histórico e é gravada na hora; o resto só marca sujo para o flush por timer.
+void        summary_cache_update(const char *device_id,
+                                 const char *name,
+                                 const kh_summary_t *summary);
+
+bool        summary_cache_get(const char *device_id, kh_summary_t *out);
+
+// Copia o histórico do mais antigo para o mais novo; retorna a quantidade
+int         summary_cache_get_history(const char *device_id,
+                                      summary_point_t *out, int max);
+
+// Devices presentes no cache (uso offline, antes da lista do backend)
+int         summary_cache_device_count(void);
+const char *summary_cache_device_id(int index);
+const char *summary_cache_device_name(int index);
+
+// Chamar periodicamente: grava o que estiver sujo há SUMMARY_CACHE_FLUSH_MS
+void        summary_cache_tick(void);
+
+// Grava imediatamente tudo que estiver sujo
+void        summary_cache_flush(void);
+
+// Quantidade de nvs_commit feitos desde o boot (telemetria de desgaste)
+uint32_t    summary_cache_write_count(void);
+
+#ifdef __cplusplus
+}
+#endif
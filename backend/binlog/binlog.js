@@ -0,0 +1,182 @@
+// binlog.js - decodificador do log binário do KH (esp32/.../BinLog.h)
+//
+// O device grava registros [u8 len][u8 nível][u32 id][u64 ts][args] e envia
+// frames "RBLG" (cabeçalho de 28 bytes + registros). O texto só é montado
+// aqui, a partir de formats.json (id -> string de formato), gerado por
+// gen_formats.js a partir dos fontes do firmware.
+// Segmentos do SPIFFS (/blogN.bin) começam com "RBLS" + u32 seq.
+//
+// CLI: node binlog/binlog.js dump.bin|blog0.bin [blog1.bin ...] [formats.json]
+
+const fs = require('fs');
+const path = require('path');
+
+const FRAME_HDR = 28;
+const REC_HDR = 14;
+const SEG_HDR = 8;
+const LEVELS = ['DEBUG', 'INFO', 'WARN', 'ERROR'];
+const DEFAULT_FORMATS = path.join(__dirname, 'formats.json');
+
+let formatsCache = null;
+
+function loadFormats(file = DEFAULT_FORMATS) {
+  if (file === DEFAULT_FORMATS && formatsCache) return formatsCache;
+  const map = new Map();
+  if (fs.existsSync(file)) {
+    const json = JSON.parse(fs.readFileSync(file, 'utf8'));
+    for (const [id, fmt] of Object.entries(json)) map.set(parseInt(id, 16) >>> 0, fmt);
+  }
+  if (file === DEFAULT_FORMATS) formatsCache = map;
+  return map;
+}
+
+/**
+ * %.Nf como o printf: toFixed desempata para cima (25.25 -> "25.3") e o
+ * printf, com o valor binário exato, desempata para o par ("25.2").
+ * Empate só existe com expansão decimal curta, então toFixed(100) é exato.
+ */
+function toFixedC(v, prec) {
+  const rounded = v.toFixed(prec);
+  if (!Number.isFinite(v)) return rounded;
+  const full = v.toFixed(100);
+  const dot = full.indexOf('.');
+  if (!/^50*$/.test(full.slice(dot + 1 + prec))) return rounded;
+  const truncated = full.slice(0, prec ? dot + 1 + prec : dot);
+  return Number(truncated[truncated.length - 1]) % 2 === 0 ? truncated : rounded;
+}
+
+/**
+ * printf mínimo: flags, largura, precisão e d i u x X o c s f F e E g G.
+ * Modificadores de tamanho (l, ll, z...) são ignorados: o tipo vem do registro.
+ */
+function formatPrintf(fmt, args) {
+  let i = 0;
+  return fmt.replace(/%([-+ #0]*)(\d*)(?:\.(\d+))?[hlLzjt]*([diuxXocsfFeEgG%])/g,
+    (m, flags, width, prec, conv) => {
+      if (conv === '%') return '%';
+      if (i >= args.length) return m;
+      const v = args[i++];
+      let s;
+      switch (conv) {
+        case 'd': case 'i': case 'u':
+          s = typeof v === 'bigint' ? v.toString() : String(Math.trunc(Number(v)));
+          break;
+        case 'x': case 'X': case 'o':
+          s = BigInt.asUintN(64, BigInt(Math.trunc(Number(v)))).toString(conv === 'o' ? 8 : 16);
+          if (conv === 'X') s = s.toUpperCase();
+          break;
+        case 'c':
+          s = String.fromCharCode(Number(v));
+          break;
+        case 's':
+          s = String(v);
+          if (prec !== undefined) s = s.slice(0, Number(prec));
+          break;
+        case 'e': case 'E':
+          s = Number(v).toExponential(prec === undefined ? 6 : Number(prec));
+          s = s.replace(/e([+-])(\d)$/, 'e$10$2');
+          if (conv === 'E') s = s.toUpperCase();
+          break;
+        case 'g': case 'G':
+          s = String(Number(Number(v).toPrecision(prec === undefined ? 6 : Math.max(1, Number(prec)))));
+          break;
+        default:
+          s = toFixedC(Number(v), prec === undefined ? 6 : Number(prec));
+      }
+      if (flags.includes('+') && /^[0-9]/.test(s) && 'dieEfFgG'.includes(conv)) s = '+' + s;
+      const w = Number(width || 0);
+      if (s.length < w) {
+        if (flags.includes('-')) s = s.padEnd(w);
+        else if (flags.includes('0') && conv !== 's') {
+          const sign = /^[+-]/.test(s) ? s[0] : '';
+          s = sign + s.slice(sign.length).padStart(w - sign.length, '0');
+        } else s = s.padStart(w);
+      }
+      return s;
+    });
+}
+
+function readArgs(buf, off, end) {
+  const args = [];
+  while (off < end) {
+    const type = String.fromCharCode(buf[off++]);
+    if (type === 'i') { args.push(buf.readInt32LE(off)); off += 4; }
+    else if (type === 'u') { args.push(buf.readUInt32LE(off)); off += 4; }
+    else if (type === 'I') { args.push(buf.readBigInt64LE(off)); off += 8; }
+    else if (type === 'U') { args.push(buf.readBigUInt64LE(off)); off += 8; }
+    else if (type === 'f') { args.push(buf.readFloatLE(off)); off += 4; }
+    else if (type === 's') {
+      const n = buf[off++];
+      args.push(buf.toString('utf8', off, off + n));
+      off += n;
+    } else break;
+  }
+  return args;
+}
+
+/**
+ * Decodifica um ou mais frames RBLG.
+ * @returns {{lines: Array<{ts:number, level:string, message:string}>, dropped:number}}
+ * Timestamps em millis() (sem NTP no momento do log) são convertidos para
+ * epoch quando o cabeçalho do frame traz o epoch do envio.
+ */
+function decode(buf, formats = loadFormats()) {
+  const lines = [];
+  let dropped = 0;
+  let off = 0;
+
+  if (buf.length >= SEG_HDR && buf.toString('latin1', 0, 4) === 'RBLS') off = SEG_HDR;
+
+  while (off + FRAME_HDR <= buf.length && buf.toString('latin1', off, off + 4) === 'RBLG') {
+    const bodyLen = buf.readUInt32LE(off + 8);
+    // contador acumulado no device (não soma entre frames)
+    dropped = Math.max(dropped, buf.readUInt32LE(off + 12));
+    const uptime = buf.readUInt32LE(off + 16);
+    const nowEpoch = Number(buf.readBigUInt64LE(off + 20));
+    let p = off + FRAME_HDR;
+    const end = Math.min(p + bodyLen, buf.length);
+
+    while (p + REC_HDR <= end) {
+      const len = buf[p];
+      if (len < REC_HDR || p + len > end) break;   // resto do frame inválido
+      const level = LEVELS[buf[p + 1]] || '?';
+      const id = buf.readUInt32LE(p + 2);
+      let ts = Number(buf.readBigUInt64LE(p + 6));
+      const args = readArgs(buf, p + REC_HDR, p + len);
+      p += len;
+
+      if (ts < 1e12 && nowEpoch > 0 && ts <= uptime) ts = nowEpoch - (uptime - ts);
+
+      const fmt = formats.get(id);
+      const message = fmt !== undefined
+        ? formatPrintf(fmt, args)
+        : `#${id.toString(16).padStart(8, '0')} ` + args.map(String).join(' ');
+      lines.push({ ts, level, message });
+    }
+    off += FRAME_HDR + bodyLen;
+  }
+  return { lines, dropped };
+}
+
+module.exports = { decode, loadFormats, formatPrintf };
+
+if (require.main === module) {
+  const args = process.argv.slice(2);
+  const fmtFile = args.find((a) => a.endsWith('.json')) || DEFAULT_FORMATS;
+  const dumps = args.filter((a) => !a.endsWith('.json'));
+  if (!dumps.length) {
+    console.error('uso: node binlog.js dump.bin|blog0.bin [blog1.bin ...] [formats.json]');
+    process.exit(1);
+  }
+  // Segmentos em ordem de seq (o mais antigo primeiro)
+  const seqOf = (b) => (b.length >= SEG_HDR && b.toString('latin1', 0, 4) === 'RBLS' ? b.readUInt32LE(4) : 0);
+  const bufs = dumps.map((f) => fs.readFileSync(f)).sort((a, b) => seqOf(a) - seqOf(b));
+  const formats = loadFormats(fmtFile);
+  let dropped = 0;
+  for (const buf of bufs) {
+    const r = decode(buf, formats);
+    for (const l of r.lines) console.log(`[${l.level}] ${l.ts}: ${l.message}`);
+    dropped = Math.max(dropped, r.dropped);
+  }
+  if (dropped) console.log(`(${dropped} registros perdidos no device)`);
+}
@@ -0,0 +1,58 @@
+// gen_formats.js - extrai as strings de formato do LOG_x(...) do firmware KH
+// e gera formats.json (id FNV-1a em hex -> formato) para binlog.js.
+//
+// Rodar sempre que um LOG_x for criado/alterado:
+//   node binlog/gen_formats.js [pasta do sketch] > binlog/formats.json
+
+const fs = require('fs');
+const path = require('path');
+
+const SRC_DIR = process.argv[2] ||
+  path.join(__dirname, '..', '..', 'esp32', 'ReefBlueSky_KH_Monitor_v4');
+
+// Mesmo hash de binlogFmtId() em BinLog.h (sobre os bytes UTF-8)
+function fnv1a(bytes) {
+  let h = 2166136261;
+  for (const b of bytes) h = Math.imul(h ^ b, 16777619) >>> 0;
+  return h >>> 0;
+}
+
+// Literal C -> bytes como o compilador gera
+function unescapeC(lit) {
+  const ESC = { n: 10, t: 9, r: 13, '0': 0, '\\': 92, '"': 34, "'": 39 };
+  const out = [];
+  const raw = Buffer.from(lit, 'utf8');
+  for (let i = 0; i < raw.length; i++) {
+    if (raw[i] === 92 && i + 1 < raw.length) {
+      const c = String.fromCharCode(raw[++i]);
+      out.push(c in ESC ? ESC[c] : raw[i]);
+    } else {
+      out.push(raw[i]);
+    }
+  }
+  return Buffer.from(out);
+}
+
+const CALL = /\bLOG_[DIWE]\s*\(\s*"((?:[^"\\]|\\.)*)"/g;
+const formats = {};
+const seen = new Map();
+let clash = false;
+
+for (const file of fs.readdirSync(SRC_DIR).sort()) {
+  if (!/\.(ino|cpp|h)$/.test(file)) continue;
+  const src = fs.readFileSync(path.join(SRC_DIR, file), 'utf8');
+  for (const m of src.matchAll(CALL)) {
+    const bytes = unescapeC(m[1]);
+    const id = fnv1a(bytes);
+    const fmt = bytes.toString('utf8');
+    if (seen.has(id) && seen.get(id) !== fmt) {
+      console.error(`colisão de id ${id.toString(16)}: "${seen.get(id)}" x "${fmt}"`);
+      clash = true;
+    }
+    seen.set(id, fmt);
+    formats[id.toString(16).padStart(8, '0')] = fmt;
+  }
+}
+
+if (clash) process.exit(1);
+process.stdout.write(JSON.stringify(formats, Object.keys(formats).sort(), 2) + '\n');
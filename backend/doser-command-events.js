@@ -0,0 +1,42 @@
+// doser-command-events.js
+// Barramento em memória que acorda o long-poll da dosadora
+// (POST /api/v1/iot/dosing/commands com wait_s) quando um comando é
+// enfileirado em devicecommands para o esp_uid.
+const { EventEmitter } = require('events');
+
+const doserCommandEvents = new EventEmitter();
+// um listener por dosadora segurando o poll; sem limite fixo
+doserCommandEvents.setMaxListeners(0);
+
+function notifyDoserCommand(espUid) {
+  if (!espUid) return;
+  doserCommandEvents.emit('command', String(espUid));
+}
+
+// Espera comando para espUid. promise resolve true quando chega, false no
+// timeout, se a conexão cair (res 'close') ou em cancel()
+function waitForDoserCommand(espUid, waitMs, res) {
+  let done;
+  const promise = new Promise((resolve) => {
+    let timer = null;
+    done = (value) => {
+      clearTimeout(timer);
+      doserCommandEvents.removeListener('command', onCommand);
+      if (res) res.removeListener('close', onClose);
+      resolve(value);
+    };
+    const onCommand = (uid) => { if (uid === String(espUid)) done(true); };
+    const onClose = () => done(false);
+
+    timer = setTimeout(() => done(false), waitMs);
+    doserCommandEvents.on('command', onCommand);
+    if (res) res.on('close', onClose);
+  });
+  return { promise, cancel: () => done(false) };
+}
+
+module.exports = {
+  doserCommandEvents,
+  notifyDoserCommand,
+  waitForDoserCommand,
+};
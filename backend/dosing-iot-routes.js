@@ -5,13 +5,29 @@ const { mailTransporter, ALERT_FROM, sendTelegramForUser, sendEmailForUser } =
   require('./alerts-helpers');
 const { getUserTimezone, getUserUtcOffsetSec, formatWithUserTimezone } = require('./user-timezone');
 const { saveDosingLog } = require('./dosing-logs-routes');
+const { waitForDoserCommand } = require('./doser-command-events');
 
 
 // dosing-iot-routes.js
 const express = require('express');
+const crypto = require('crypto');
 const router = express.Router();
 const pool = require('./db-pool'); 
 
+// ===== HELPER: Versão da config da dosadora =====
+// Hash do que o firmware aplica (bombas, agendas, fuso). current_volume_ml
+// fica de fora: muda a cada dose e vai à parte, sem invalidar a versão.
+// As agendas vêm do GROUP_CONCAT ordenadas por id: sem ORDER BY a ordem
+// dependia do plano da consulta e a versão mudava sem a config mudar.
+function doserConfigVersion(pumpData, userTimezone, userUtcOffsetSec) {
+  const cfg = pumpData.map(({ current_volume_ml, ...rest }) => rest);
+  return crypto
+    .createHash('sha1')
+    .update(JSON.stringify({ pumps: cfg, tz: userTimezone, off: userUtcOffsetSec }))
+    .digest('hex')
+    .slice(0, 16);
+}
+
 // ===== HELPER: Validar token IoT (para ESP) =====
 async function verifyIoTToken(espUid) {
   let conn;
@@ -152,6 +168,9 @@ async function notifyDosingAlert(userId, alertType, message, pumpId = null) {
 //   - poll_interval_s: intervalo (segundos) para /status e /commands.
 //   - pumps[].schedules[].start_time / end_time: strings "HH:MM" em horário LOCAL do aquário,
 //     sem fuso; o firmware interpreta no timezone configurado no próprio device.
+//   - config_version: hash da config. Se o ESP mandar config_version igual à
+//     atual, a resposta é só { unchanged: true, config_version, server_time,
+//     user_utc_offset_sec, volumes: { "<pumpId>": current_volume_ml } }.
 
 // ESP contacta servidor pela primeira vez
 router.post('/handshake', async (req, res) => {
@@ -161,6 +180,7 @@ router.post('/handshake', async (req, res) => {
     const esp_uid          = body.esp_uid || body.espUid;
     const hw_type          = body.hw_type || body.hwType || 'ESP32';
     const firmware_version = body.firmware_version || body.firmwareVersion || '1.0.0';
+    const knownVersion     = body.config_version || null;
 
     if (!esp_uid) {
       console.warn('[DOSING IOT] handshake sem esp_uid. Body=', body);
@@ -252,6 +272,7 @@ router.post('/handshake', async (req, res) => {
             'end_time', TIME_FORMAT(s.end_time, '%H:%i'), 'volume_per_day_ml', s.volume_per_day_ml,
             'min_gap_minutes', s.min_gap_minutes, 'adjusted_times', s.adjusted_times
           )
+          ORDER BY s.id
         ) as schedules
        FROM dosing_pumps p
        LEFT JOIN dosing_schedules s ON p.id = s.pump_id AND s.enabled = 1
@@ -304,6 +325,22 @@ router.post('/handshake', async (req, res) => {
       };
     });
 
+    const configVersion = doserConfigVersion(pumpData, userTimezone, userUtcOffsetSec);
+    res.set('ETag', `"${configVersion}"`);
+
+    if (knownVersion && knownVersion === configVersion) {
+      const volumes = {};
+      pumpData.forEach(p => { volumes[p.id] = p.current_volume_ml; });
+      return res.json({
+        success: true,
+        unchanged: true,
+        config_version: configVersion,
+        server_time: new Date().toISOString(),
+        user_utc_offset_sec: userUtcOffsetSec,
+        volumes
+      });
+    }
+
     res.json({
       success: true,
       device_id: deviceId,
@@ -311,6 +348,7 @@ router.post('/handshake', async (req, res) => {
       poll_interval_s: 30,
       user_timezone: userTimezone,
       user_utc_offset_sec: userUtcOffsetSec,
+      config_version: configVersion,
       pumps: pumpData
     });
   } catch (err) {
@@ -333,6 +371,7 @@ router.post('/status', async (req, res) => {
     const pumps      = body.pumps;
 
   console.log('[DOSING IOT] /status recebido de', espUid, 'uptime=', uptime_s, 'signal=', signal_dbm);
+  if (body.lan) console.log('[DOSING IOT] LAN de', espUid, JSON.stringify(body.lan));   // pares, RTT, descartes
 
 
     if (!espUid) {
@@ -410,27 +449,18 @@ router.post('/status', async (req, res) => {
 });
 
 
-// POST /v1/iot/dosing/commands
-// ESP busca comandos pendentes (fila device_commands, device_id = esp_uid)
-router.post('/commands', async (req, res) => {
+// Long-poll de comandos: o ESP pede wait_s e o servidor segura a resposta
+// até chegar comando (notifyDoserCommand) ou o tempo acabar. Firmware
+// antigo não manda wait_s e continua recebendo resposta imediata.
+const COMMAND_WAIT_MAX_S = 120;
+
+// Busca até 5 comandos pendentes e marca "inprogress" (conexão do pool
+// só durante a consulta, nunca durante a espera)
+async function claimDoserCommands(espUid) {
   let conn;
   try {
-    const body = req.body || {};
-    const espUid = body.esp_uid || body.espUid;
-
-    if (!espUid) {
-      console.warn('[DOSING IOT] /commands sem esp_uid. Body=', body);
-      return res.status(400).json({ success: false, error: 'esp_uid obrigatório' });
-    }
-
-    const device = await verifyIoTToken(espUid);
-    if (!device) {
-      return res.status(404).json({ success: false, error: 'Device not found' });
-    }
-
     conn = await pool.getConnection();
 
-    // Buscar comandos pendentes para este esp_uid
     const rows = await conn.query(
       `SELECT id, type, payload
          FROM devicecommands
@@ -441,10 +471,7 @@ router.post('/commands', async (req, res) => {
       [espUid]
     );
 
-
-    if (!rows || rows.length === 0) {
-      return res.json({ success: true, commands: [] });
-    }
+    if (!rows || rows.length === 0) return [];
 
     // Parse de payload (JSON) e montagem da resposta
     const commands = rows.map((r) => {
@@ -469,8 +496,8 @@ router.post('/commands', async (req, res) => {
       };
     });
 
-  // Marcar como "inprogress" para evitar duplicidade
-  const ids = rows.map((r) => r.id);
+    // Marcar como "inprogress" para evitar duplicidade
+    const ids = rows.map((r) => r.id);
     await conn.query(
       `UPDATE devicecommands
           SET status = 'inprogress', updatedAt = NOW()
@@ -479,13 +506,74 @@ router.post('/commands', async (req, res) => {
       ids
     );
 
+    return commands;
+  } finally {
+    if (conn) conn.release();
+  }
+}
+
+// Devolve à fila comandos já marcados "inprogress" que não chegaram ao ESP
+// (conexão fechou entre o claim e a resposta)
+async function releaseDoserCommands(ids) {
+  if (!ids.length) return;
+  await pool.query(
+    `UPDATE devicecommands
+        SET status = 'pending', updatedAt = NOW()
+      WHERE id IN (${ids.map(() => '?').join(',')})
+        AND status = 'inprogress'`,
+    ids
+  );
+}
+
+// POST /v1/iot/dosing/commands
+// ESP busca comandos pendentes (fila device_commands, device_id = esp_uid)
+// - wait_s (opcional, até COMMAND_WAIT_MAX_S): long-poll; header
+//   X-Long-Poll confirma ao firmware que o servidor segura a resposta.
+router.post('/commands', async (req, res) => {
+  try {
+    const body = req.body || {};
+    const espUid = body.esp_uid || body.espUid;
+    const waitS  = Math.min(Math.max(parseInt(body.wait_s, 10) || 0, 0), COMMAND_WAIT_MAX_S);
+
+    if (!espUid) {
+      console.warn('[DOSING IOT] /commands sem esp_uid. Body=', body);
+      return res.status(400).json({ success: false, error: 'esp_uid obrigatório' });
+    }
+
+    const device = await verifyIoTToken(espUid);
+    if (!device) {
+      return res.status(404).json({ success: false, error: 'Device not found' });
+    }
 
+    if (waitS > 0) res.set('X-Long-Poll', String(waitS));
+
+    // Inscreve antes da primeira consulta: comando que entrar entre a
+    // consulta e a espera não se perde
+    let gone = false;
+    res.on('close', () => { gone = true; });
+    const woken = waitS > 0 ? waitForDoserCommand(espUid, waitS * 1000, res) : null;
+
+    // gone é conferido antes de cada claim: claim marca "inprogress" e
+    // ninguém mais entregaria esses comandos
+    let commands = [];
+    try {
+      if (!gone) commands = await claimDoserCommands(espUid);
+      if (commands.length === 0 && woken && await woken.promise && !gone) {
+        commands = await claimDoserCommands(espUid);
+      }
+    } finally {
+      if (woken) woken.cancel();
+    }
+
+    if (gone) {
+      // ESP desistiu durante o claim: comandos voltam a "pending"
+      await releaseDoserCommands(commands.map((c) => c.id));
+      return;
+    }
     return res.json({ success: true, commands });
   } catch (err) {
     console.error('Error in dosing commands poll:', err);
     return res.status(500).json({ success: false, error: 'Server error' });
-  } finally {
-    if (conn) conn.release();
   }
 });
 
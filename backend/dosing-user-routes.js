@@ -4,6 +4,7 @@
 const express = require('express');
 const router = express.Router();
 const pool = require('./db-pool');
+const { notifyDoserCommand } = require('./doser-command-events');
 
 // ============================================
 // MIDDLEWARE: Verificar JWT (deve estar antes de todas as rotas)
@@ -899,6 +900,7 @@ router.post('/devices/:deviceId/pumps/:pumpIndex/manual', async (req, res) => {
             JSON.stringify(payload)
           ]
         );
+        notifyDoserCommand(espUid);   // acorda o long-poll da dosadora
 
         res.json({
           data: {
@@ -1073,6 +1075,7 @@ router.post('/pumps/:id/calibrate/abort', async (req, res) => {
         JSON.stringify({ pump_id: pump.id })
       ]
     );
+    notifyDoserCommand(pump.esp_uid);   // acorda o long-poll da dosadora
 
 
     res.json({ success: true });
@@ -1126,6 +1129,7 @@ router.post('/pumps/:id/manual/abort', async (req, res) => {
         JSON.stringify({ pump_id: pump.id })
       ]
     );
+    notifyDoserCommand(pump.esp_uid);   // acorda o long-poll da dosadora
 
 
     res.json({ success: true });
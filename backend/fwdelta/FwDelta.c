@@ -0,0 +1,230 @@
+// FwDelta.c
+#include "FwDelta.h"
+#include <string.h>
+
+enum {
+    ST_DIFF_LEN = 0,
+    ST_EXTRA_LEN,
+    ST_SEEK,
+    ST_DIFF,
+    ST_EXTRA,
+    ST_DONE,
+};
+
+static uint32_t rd32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void fwd_init(fwd_ctx_t *c, fwd_read_old_fn read_old, fwd_write_fn write, void *user)
+{
+    memset(c, 0, sizeof(*c));
+    c->read_old = read_old;
+    c->write    = write;
+    c->user     = user;
+    c->state    = ST_DIFF_LEN;
+}
+
+int fwd_read_old(fwd_ctx_t *c, uint32_t off, uint8_t *buf, uint32_t len)
+{
+    if (c->read_old(c->user, off, buf, len) != 0) return FWD_ERR_READ;
+    if (off < FWD_OLD_SKIP) {
+        uint32_t n = FWD_OLD_SKIP - off;
+        memset(buf, 0, n < len ? n : len);
+    }
+    return FWD_OK;
+}
+
+static int parse_header(fwd_ctx_t *c)
+{
+    const uint8_t *h = c->hdr_buf;
+    if (memcmp(h, FWD_MAGIC, 4) != 0) return FWD_ERR_MAGIC;
+    if (h[4] != FWD_VERSION) return FWD_ERR_FORMAT;
+
+    c->hdr.flags     = h[5];
+    c->hdr.win_bits  = h[6];
+    c->hdr.len_bits  = h[7];
+    c->hdr.old_size  = rd32(h + 8);
+    c->hdr.new_size  = rd32(h + 12);
+    c->hdr.body_size = rd32(h + 16);
+    memcpy(c->hdr.old_sha256, h + 20, 32);
+    memcpy(c->hdr.new_sha256, h + 52, 32);
+
+    if (c->hdr.flags & FWD_FLAG_LZSS) {
+        // tag + offset + tamanho precisa caber no bitbuf junto com 1 byte novo
+        if (c->hdr.win_bits < 8 || c->hdr.win_bits > FWD_WINDOW_BITS_MAX ||
+            c->hdr.len_bits < 2 || c->hdr.len_bits > 8) {
+            return FWD_ERR_FORMAT;
+        }
+    }
+    if (c->hdr.new_size == 0) c->state = ST_DONE;
+    return FWD_HEADER;
+}
+
+static int flush_out(fwd_ctx_t *c)
+{
+    if (c->out_len == 0) return FWD_OK;
+    if (c->write(c->user, c->out, c->out_len) != 0) return FWD_ERR_WRITE;
+    c->written += c->out_len;
+    c->out_len = 0;
+    return FWD_OK;
+}
+
+static int emit(fwd_ctx_t *c, uint8_t b)
+{
+    if (c->written + c->out_len >= c->hdr.new_size) return FWD_ERR_RANGE;
+    c->out[c->out_len++] = b;
+    if (c->out_len == FWD_OUT_BUF || c->written + c->out_len == c->hdr.new_size) {
+        return flush_out(c);
+    }
+    return FWD_OK;
+}
+
+static int old_byte(fwd_ctx_t *c, uint32_t pos, uint8_t *out)
+{
+    if (pos - c->cache_off >= c->cache_len || pos < c->cache_off) {
+        if (pos >= c->hdr.old_size) return FWD_ERR_RANGE;
+        uint32_t n = c->hdr.old_size - pos;
+        if (n > FWD_OLD_CACHE) n = FWD_OLD_CACHE;
+        int r = fwd_read_old(c, pos, c->cache, n);
+        if (r != FWD_OK) return r;
+        c->cache_off = pos;
+        c->cache_len = n;
+    }
+    *out = c->cache[pos - c->cache_off];
+    return FWD_OK;
+}
+
+// Fecha o registro atual: aplica o seek e volta a ler o próximo controle
+static void next_record(fwd_ctx_t *c)
+{
+    if (c->diff_left) { c->state = ST_DIFF; return; }
+    if (c->extra_left) { c->state = ST_EXTRA; return; }
+    c->old_pos += (uint32_t)c->seek;
+    c->state = (c->written + c->out_len >= c->hdr.new_size) ? ST_DONE : ST_DIFF_LEN;
+}
+
+// Um byte do corpo já descomprimido
+static int put(fwd_ctx_t *c, uint8_t b)
+{
+    int r;
+    switch (c->state) {
+    case ST_DIFF_LEN:
+    case ST_EXTRA_LEN:
+    case ST_SEEK:
+        if (c->vshift > 28) return FWD_ERR_FORMAT;
+        c->vacc |= (uint32_t)(b & 0x7F) << c->vshift;
+        c->vshift += 7;
+        if (b & 0x80) return FWD_OK;
+
+        if (c->state == ST_DIFF_LEN) {
+            c->diff_left = c->vacc;
+            c->state = ST_EXTRA_LEN;
+        } else if (c->state == ST_EXTRA_LEN) {
+            c->extra_left = c->vacc;
+            c->state = ST_SEEK;
+        } else {
+            c->seek = (int32_t)((c->vacc >> 1) ^ (0u - (c->vacc & 1)));   // zigzag
+            next_record(c);
+        }
+        c->vacc = 0;
+        c->vshift = 0;
+        return FWD_OK;
+
+    case ST_DIFF: {
+        uint8_t o;
+        r = old_byte(c, c->old_pos, &o);
+        if (r != FWD_OK) return r;
+        r = emit(c, (uint8_t)(o + b));
+        if (r != FWD_OK) return r;
+        c->old_pos++;
+        if (--c->diff_left == 0) next_record(c);
+        return FWD_OK;
+    }
+
+    case ST_EXTRA:
+        r = emit(c, b);
+        if (r != FWD_OK) return r;
+        if (--c->extra_left == 0) next_record(c);
+        return FWD_OK;
+
+    default:
+        return FWD_ERR_RANGE;   // dados além de new_size
+    }
+}
+
+// LZSS: bit 1 + 8 bits = literal; bit 0 + (dist-1) em win_bits +
+// (len-FWD_MIN_MATCH) em len_bits = cópia da janela. MSB primeiro.
+static int lzss_byte(fwd_ctx_t *c, uint8_t in)
+{
+    const uint8_t wb = c->hdr.win_bits, lb = c->hdr.len_bits;
+    const uint16_t mask = (uint16_t)((1u << wb) - 1);
+
+    c->bitbuf = (c->bitbuf << 8) | in;
+    c->bitcnt += 8;
+
+    while (c->bitcnt > 0 && c->state != ST_DONE) {
+        uint32_t tag = (c->bitbuf >> (c->bitcnt - 1)) & 1;
+        int r;
+        if (tag) {
+            if (c->bitcnt < 9) break;
+            c->bitcnt -= 9;
+            uint8_t b = (uint8_t)(c->bitbuf >> c->bitcnt);
+            c->window[c->win_pos++ & mask] = b;
+            r = put(c, b);
+            if (r != FWD_OK) return r;
+        } else {
+            uint8_t need = (uint8_t)(1 + wb + lb);
+            if (c->bitcnt < need) break;
+            c->bitcnt -= need;
+            uint32_t v = c->bitbuf >> c->bitcnt;
+            uint32_t len  = (v & ((1u << lb) - 1)) + FWD_MIN_MATCH;
+            uint32_t dist = ((v >> lb) & mask) + 1;
+            while (len--) {
+                uint8_t b = c->window[(uint16_t)(c->win_pos - dist) & mask];
+                c->window[c->win_pos++ & mask] = b;
+                r = put(c, b);
+                if (r != FWD_OK) return r;
+                if (c->state == ST_DONE) break;
+            }
+        }
+        c->bitbuf &= (1u << c->bitcnt) - 1;
+    }
+    return FWD_OK;
+}
+
+int fwd_feed(fwd_ctx_t *c, const uint8_t *data, size_t len, size_t *used)
+{
+    size_t i = 0;
+    int r = FWD_OK;
+
+    if (c->err) { *used = 0; return c->err; }
+
+    if (c->hdr_len < FWD_HEADER_SIZE) {
+        while (i < len && c->hdr_len < FWD_HEADER_SIZE) c->hdr_buf[c->hdr_len++] = data[i++];
+        if (c->hdr_len == FWD_HEADER_SIZE) {
+            *used = i;
+            r = parse_header(c);
+            if (r < 0) c->err = r;
+            return r;
+        }
+        *used = i;
+        return FWD_OK;
+    }
+
+    while (i < len && c->state != ST_DONE) {
+        if (c->body_read >= c->hdr.body_size) { r = FWD_ERR_FORMAT; break; }
+        uint8_t b = data[i++];
+        c->body_read++;
+        r = (c->hdr.flags & FWD_FLAG_LZSS) ? lzss_byte(c, b) : put(c, b);
+        if (r != FWD_OK) break;
+    }
+    if (r == FWD_OK && c->state == ST_DONE) {
+        r = flush_out(c);
+        if (r == FWD_OK) r = FWD_DONE;
+    }
+
+    *used = i;
+    if (r < 0) c->err = r;
+    return r;
+}
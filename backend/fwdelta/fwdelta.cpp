@@ -0,0 +1,489 @@
+//
+//  fwdelta.cpp
+//  Gerador/aplicador de patches RBSD para OTA delta (roda no servidor/host)
+//
+//  fwdelta diff  <antigo.bin> <novo.bin> <saida.rbsd>
+//  fwdelta apply <antigo.bin> <patch.rbsd> <saida.bin>
+//  fwdelta test  <dir firmware>   -> reconstrói cada .bin a partir dos anteriores
+//
+//  diff: bsdiff (array de sufixos + extensão para frente/trás) com o corpo
+//  comprimido em LZSS de janela pequena, para o device descomprimir com 2 KB.
+//  apply/test usam o mesmo FwDelta.c dos firmwares, alimentado em pedaços
+//  de tamanho aleatório como chegaria do HTTP.
+//
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include "FwDelta.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+// ---------- SHA-256 (FIPS 180-4) ----------
+
+static const uint32_t K256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static uint32_t ror(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+static void Sha256(const uint8_t *data, size_t len, uint8_t out[32])
+{
+    uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                     0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    Bytes m(data, data + len);
+    m.push_back(0x80);
+    while (m.size() % 64 != 56) m.push_back(0);
+    uint64_t bits = (uint64_t)len * 8;
+    for (int i = 7; i >= 0; i--) m.push_back((uint8_t)(bits >> (i * 8)));
+
+    for (size_t blk = 0; blk < m.size(); blk += 64) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++) {
+            const uint8_t *p = &m[blk + i * 4];
+            w[i] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+        }
+        for (int i = 16; i < 64; i++) {
+            uint32_t s0 = ror(w[i - 15], 7) ^ ror(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = ror(w[i - 2], 17) ^ ror(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+        for (int i = 0; i < 64; i++) {
+            uint32_t t1 = hh + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) + ((e & f) ^ (~e & g)) + K256[i] + w[i];
+            uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            hh = g; g = f; f = e; e = d + t1; d = c; c = b; b = a; a = t1 + t2;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+    }
+    for (int i = 0; i < 8; i++) {
+        out[i * 4] = (uint8_t)(h[i] >> 24); out[i * 4 + 1] = (uint8_t)(h[i] >> 16);
+        out[i * 4 + 2] = (uint8_t)(h[i] >> 8); out[i * 4 + 3] = (uint8_t)h[i];
+    }
+}
+
+// ---------- arquivos ----------
+
+static bool ReadFile(const std::string &path, Bytes &out)
+{
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    out.resize(n);
+    bool ok = n == 0 || fread(out.data(), 1, n, f) == (size_t)n;
+    fclose(f);
+    return ok;
+}
+
+static bool WriteFile(const std::string &path, const Bytes &data)
+{
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    fclose(f);
+    return ok;
+}
+
+// ---------- array de sufixos (prefix doubling) ----------
+
+static std::vector<int32_t> SuffixArray(const Bytes &s)
+{
+    int32_t n = (int32_t)s.size();
+    std::vector<int32_t> sa(n), rank(n), tmp(n);
+    for (int32_t i = 0; i < n; i++) { sa[i] = i; rank[i] = s[i]; }
+    for (int32_t k = 1; n > 1; k <<= 1) {
+        auto key2 = [&](int32_t i) { return i + k < n ? rank[i + k] : -1; };
+        auto cmp = [&](int32_t a, int32_t b) {
+            if (rank[a] != rank[b]) return rank[a] < rank[b];
+            return key2(a) < key2(b);
+        };
+        std::sort(sa.begin(), sa.end(), cmp);
+        tmp[sa[0]] = 0;
+        for (int32_t i = 1; i < n; i++) tmp[sa[i]] = tmp[sa[i - 1]] + (cmp(sa[i - 1], sa[i]) ? 1 : 0);
+        rank.swap(tmp);
+        if (rank[sa[n - 1]] == n - 1) break;
+    }
+    return sa;
+}
+
+static int32_t MatchLen(const uint8_t *a, int32_t alen, const uint8_t *b, int32_t blen)
+{
+    int32_t i = 0;
+    while (i < alen && i < blen && a[i] == b[i]) i++;
+    return i;
+}
+
+static int32_t Search(const std::vector<int32_t> &sa, const Bytes &old, const uint8_t *nw, int32_t nlen,
+                      int32_t st, int32_t en, int32_t *pos)
+{
+    const int32_t osz = (int32_t)old.size();
+    while (en - st >= 2) {
+        int32_t x = st + (en - st) / 2;
+        int32_t n = std::min(osz - sa[x], nlen);
+        if (memcmp(&old[sa[x]], nw, n) < 0) st = x; else en = x;
+    }
+    int32_t a = MatchLen(&old[sa[st]], osz - sa[st], nw, nlen);
+    int32_t b = MatchLen(&old[sa[en]], osz - sa[en], nw, nlen);
+    if (a > b) { *pos = sa[st]; return a; }
+    *pos = sa[en];
+    return b;
+}
+
+// ---------- bsdiff -> corpo RBSD ----------
+
+static void PutVarint(Bytes &out, uint32_t v)
+{
+    while (v >= 0x80) { out.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+    out.push_back((uint8_t)v);
+}
+
+static Bytes DiffBody(const Bytes &old, const Bytes &nw)
+{
+    Bytes body;
+    const int32_t osz = (int32_t)old.size(), nsz = (int32_t)nw.size();
+    if (osz == 0) {
+        PutVarint(body, 0); PutVarint(body, nsz); PutVarint(body, 0);
+        body.insert(body.end(), nw.begin(), nw.end());
+        return body;
+    }
+    std::vector<int32_t> sa = SuffixArray(old);
+
+    int32_t scan = 0, len = 0, pos = 0, lastscan = 0, lastpos = 0, lastoffset = 0;
+    while (scan < nsz) {
+        int32_t oldscore = 0;
+        int32_t scsc = scan += len;
+        for (; scan < nsz; scan++) {
+            len = Search(sa, old, &nw[scan], nsz - scan, 0, osz - 1, &pos);
+            for (; scsc < scan + len; scsc++)
+                if (scsc + lastoffset < osz && old[scsc + lastoffset] == nw[scsc]) oldscore++;
+            if ((len == oldscore && len != 0) || len > oldscore + 8) break;
+            if (scan + lastoffset < osz && old[scan + lastoffset] == nw[scan]) oldscore--;
+        }
+        if (len == oldscore && scan != nsz) continue;
+
+        // extensão para frente a partir do último casamento
+        int32_t s = 0, sf = 0, lenf = 0;
+        for (int32_t i = 0; lastscan + i < scan && lastpos + i < osz;) {
+            if (old[lastpos + i] == nw[lastscan + i]) s++;
+            i++;
+            if (s * 2 - i > sf * 2 - lenf) { sf = s; lenf = i; }
+        }
+        // extensão para trás a partir do casamento novo
+        int32_t lenb = 0;
+        if (scan < nsz) {
+            int32_t sb = 0;
+            s = 0;
+            for (int32_t i = 1; scan >= lastscan + i && pos >= i; i++) {
+                if (old[pos - i] == nw[scan - i]) s++;
+                if (s * 2 - i > sb * 2 - lenb) { sb = s; lenb = i; }
+            }
+        }
+        if (lastscan + lenf > scan - lenb) {
+            int32_t overlap = (lastscan + lenf) - (scan - lenb);
+            int32_t ss = 0, lens = 0;
+            s = 0;
+            for (int32_t i = 0; i < overlap; i++) {
+                if (nw[lastscan + lenf - overlap + i] == old[lastpos + lenf - overlap + i]) s++;
+                if (nw[scan - lenb + i] == old[pos - lenb + i]) s--;
+                if (s > ss) { ss = s; lens = i + 1; }
+            }
+            lenf += lens - overlap;
+            lenb -= lens;
+        }
+
+        int32_t extra = (scan - lenb) - (lastscan + lenf);
+        int32_t seek  = (pos - lenb) - (lastpos + lenf);
+        PutVarint(body, (uint32_t)lenf);
+        PutVarint(body, (uint32_t)extra);
+        PutVarint(body, ((uint32_t)seek << 1) ^ (uint32_t)(seek >> 31));
+        for (int32_t i = 0; i < lenf; i++) body.push_back((uint8_t)(nw[lastscan + i] - old[lastpos + i]));
+        body.insert(body.end(), nw.begin() + lastscan + lenf, nw.begin() + scan - lenb);
+
+        lastscan = scan - lenb;
+        lastpos = pos - lenb;
+        lastoffset = pos - scan;
+    }
+    return body;
+}
+
+// ---------- LZSS (encoder guloso com hash chain) ----------
+
+struct BitWriter {
+    Bytes out;
+    uint32_t acc = 0;
+    int n = 0;
+    void Put(uint32_t v, int bits)
+    {
+        for (int i = bits - 1; i >= 0; i--) {
+            acc = (acc << 1) | ((v >> i) & 1);
+            if (++n == 8) { out.push_back((uint8_t)acc); acc = 0; n = 0; }
+        }
+    }
+    void Flush() { if (n) { out.push_back((uint8_t)(acc << (8 - n))); acc = 0; n = 0; } }
+};
+
+static Bytes Lzss(const Bytes &in, int wb, int lb)
+{
+    const int32_t n = (int32_t)in.size();
+    const int32_t wsize = 1 << wb, maxlen = (1 << lb) - 1 + FWD_MIN_MATCH;
+    const int HBITS = 16, MAX_CHAIN = 256;
+    std::vector<int32_t> head(1 << HBITS, -1), prev(n, -1);
+    auto hash = [&](int32_t i) {
+        return (((uint32_t)in[i] << 16) ^ ((uint32_t)in[i + 1] << 8) ^ in[i + 2]) * 2654435761u >> (32 - HBITS);
+    };
+    auto insert = [&](int32_t i) {
+        if (i + 2 < n) { uint32_t h = hash(i); prev[i] = head[h]; head[h] = i; }
+    };
+    auto longest = [&](int32_t i, int32_t *dist) {
+        int32_t best = 0;
+        if (i + 2 >= n) return best;
+        int chain = MAX_CHAIN;
+        for (int32_t j = head[hash(i)]; j >= 0 && i - j <= wsize && chain--; j = prev[j]) {
+            int32_t l = 0, lim = std::min(maxlen, n - i);
+            while (l < lim && in[j + l] == in[i + l]) l++;
+            if (l > best) { best = l; *dist = i - j; if (l == lim) break; }
+        }
+        return best;
+    };
+
+    BitWriter bw;
+    int32_t i = 0;
+    while (i < n) {
+        int32_t dist = 0, len = longest(i, &dist);
+        insert(i);
+        // lazy: se o próximo byte casa bem mais longe, emite literal agora
+        if (len >= FWD_MIN_MATCH && len < maxlen && i + 1 < n) {
+            int32_t d2 = 0;
+            if (longest(i + 1, &d2) > len + 1) len = 0;
+        }
+        if (len >= FWD_MIN_MATCH) {
+            bw.Put(0, 1); bw.Put(dist - 1, wb); bw.Put(len - FWD_MIN_MATCH, lb);
+            for (int32_t k = 1; k < len; k++) insert(i + k);
+            i += len;
+        } else {
+            bw.Put(1, 1); bw.Put(in[i], 8);
+            i++;
+        }
+    }
+    bw.Flush();
+    return bw.out;
+}
+
+// ---------- patch ----------
+
+static void Put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+static Bytes OldView(const Bytes &old)
+{
+    Bytes v(old);
+    std::fill(v.begin(), v.begin() + std::min<size_t>(FWD_OLD_SKIP, v.size()), 0);
+    return v;
+}
+
+static Bytes MakePatch(const Bytes &old, const Bytes &nw, int wb, int lb)
+{
+    Bytes view = OldView(old);
+    Bytes raw = DiffBody(view, nw);
+    Bytes lz = Lzss(raw, wb, lb);
+    bool use_lz = lz.size() < raw.size();
+    const Bytes &body = use_lz ? lz : raw;
+
+    Bytes p(FWD_HEADER_SIZE, 0);
+    memcpy(&p[0], FWD_MAGIC, 4);
+    p[4] = FWD_VERSION;
+    p[5] = use_lz ? FWD_FLAG_LZSS : 0;
+    p[6] = (uint8_t)wb;
+    p[7] = (uint8_t)lb;
+    Put32(&p[8], (uint32_t)old.size());
+    Put32(&p[12], (uint32_t)nw.size());
+    Put32(&p[16], (uint32_t)body.size());
+    Sha256(view.data(), view.size(), &p[20]);
+    Sha256(nw.data(), nw.size(), &p[52]);
+    p.insert(p.end(), body.begin(), body.end());
+    return p;
+}
+
+struct ApplyCtx {
+    const Bytes *old;
+    Bytes out;
+};
+
+static int ReadOld(void *user, uint32_t off, uint8_t *buf, uint32_t len)
+{
+    ApplyCtx *a = (ApplyCtx *)user;
+    if ((uint64_t)off + len > a->old->size()) return -1;
+    memcpy(buf, a->old->data() + off, len);
+    return 0;
+}
+
+static int WriteNew(void *user, const uint8_t *buf, uint32_t len)
+{
+    ApplyCtx *a = (ApplyCtx *)user;
+    a->out.insert(a->out.end(), buf, buf + len);
+    return 0;
+}
+
+// Aplica como o device: pedaços aleatórios de 1..1460 bytes
+static bool ApplyPatch(const Bytes &old, const Bytes &patch, Bytes &out, std::string &err)
+{
+    static fwd_ctx_t ctx;
+    ApplyCtx a = {&old, {}};
+    fwd_init(&ctx, ReadOld, WriteNew, &a);
+
+    size_t off = 0;
+    int r = FWD_OK;
+    while (off < patch.size() && r != FWD_DONE) {
+        size_t chunk = std::min<size_t>(patch.size() - off, 1 + rand() % 1460);
+        const uint8_t *p = &patch[off];
+        while (chunk > 0) {
+            size_t used = 0;
+            r = fwd_feed(&ctx, p, chunk, &used);
+            p += used; chunk -= used; off += used;
+            if (r < 0) { err = "fwd_feed erro " + std::to_string(r); return false; }
+            if (r == FWD_HEADER) {
+                uint8_t sha[32];
+                Bytes view = OldView(old);
+                Sha256(view.data(), view.size(), sha);
+                if (ctx.hdr.old_size != old.size() || memcmp(sha, ctx.hdr.old_sha256, 32) != 0) {
+                    err = "firmware antigo não confere com o patch";
+                    return false;
+                }
+            }
+            if (r == FWD_DONE) break;
+        }
+    }
+    if (r != FWD_DONE) { err = "patch terminou antes do fim"; return false; }
+
+    uint8_t sha[32];
+    Sha256(a.out.data(), a.out.size(), sha);
+    if (memcmp(sha, ctx.hdr.new_sha256, 32) != 0) { err = "SHA-256 do resultado divergente"; return false; }
+    out.swap(a.out);
+    return true;
+}
+
+// ---------- comandos ----------
+
+static int CmdTest(const std::string &root, int wb, int lb)
+{
+    static const char *types[] = {"KH", "DOSER", "LCD"};
+    int fails = 0, pairs = 0;
+    uint64_t sum_full = 0, sum_patch = 0;
+
+    for (const char *type : types) {
+        std::string dir = root + "/" + type;
+        std::vector<std::string> bins;
+        if (DIR *d = opendir(dir.c_str())) {
+            while (dirent *e = readdir(d)) {
+                std::string name = e->d_name;
+                if (name.size() > 4 && name.compare(name.size() - 4, 4, ".bin") == 0) bins.push_back(name);
+            }
+            closedir(d);
+        }
+        std::sort(bins.begin(), bins.end());
+        if (bins.size() < 2) continue;
+
+        printf("%s:\n", type);
+        Bytes prev_data;
+        for (size_t i = 1; i < bins.size(); i++) {
+            // versão anterior -> esta, e a mais antiga -> a mais nova
+            std::vector<size_t> froms = {i - 1};
+            if (i == bins.size() - 1 && i > 1) froms.push_back(0);
+            Bytes nw;
+            ReadFile(dir + "/" + bins[i], nw);
+            for (size_t f : froms) {
+                Bytes old, out;
+                ReadFile(dir + "/" + bins[f], old);
+                clock_t t0 = clock();
+                Bytes patch = MakePatch(old, nw, wb, lb);
+                double t_diff = (double)(clock() - t0) / CLOCKS_PER_SEC;
+                t0 = clock();
+                std::string err;
+                bool ok = ApplyPatch(old, patch, out, err) && out == nw;
+                double t_apply = (double)(clock() - t0) / CLOCKS_PER_SEC;
+                printf("  %-22s -> %-22s %8zu -> %7zu bytes (%5.1fx)  diff %.1fs apply %.2fs  %s%s\n",
+                       bins[f].c_str(), bins[i].c_str(), nw.size(), patch.size(),
+                       (double)nw.size() / patch.size(), t_diff, t_apply, ok ? "OK" : "FAIL ", err.c_str());
+                pairs++;
+                fails += !ok;
+
+                // patch corrompido/truncado: precisa falhar limpo ou (bit irrelevante,
+                // ex. preenchimento do LZSS) ainda reconstruir exatamente o novo
+                for (int k = 0; ok && k < 8; k++) {
+                    Bytes bad(patch);
+                    if (k & 1) bad.resize(FWD_HEADER_SIZE + rand() % (bad.size() - FWD_HEADER_SIZE));
+                    else bad[FWD_HEADER_SIZE + rand() % (bad.size() - FWD_HEADER_SIZE)] ^= (uint8_t)(1 + rand() % 255);
+                    Bytes junk;
+                    std::string e2;
+                    if (ApplyPatch(old, bad, junk, e2) && junk != nw) {
+                        printf("    patch corrompido gerou imagem errada!\n");
+                        fails++;
+                        break;
+                    }
+                }
+                sum_full += nw.size();
+                sum_patch += patch.size();
+            }
+        }
+    }
+    if (pairs == 0) {
+        fprintf(stderr, "nenhum par de .bin em %s\n", root.c_str());
+        return 1;
+    }
+    printf("%d patches, %d falhas, total %llu -> %llu bytes (%.1fx)\n", pairs, fails,
+           (unsigned long long)sum_full, (unsigned long long)sum_patch, (double)sum_full / sum_patch);
+    return fails ? 1 : 0;
+}
+
+static void Usage()
+{
+    fprintf(stderr,
+            "uso: fwdelta diff  <antigo.bin> <novo.bin> <saida.rbsd>\n"
+            "     fwdelta apply <antigo.bin> <patch.rbsd> <saida.bin>\n"
+            "     fwdelta test  <dir firmware>\n");
+}
+
+int main(int argc, char **argv)
+{
+    const int wb = FWD_WINDOW_BITS_MAX, lb = 8;
+    srand(1);
+    if (argc == 3 && strcmp(argv[1], "test") == 0) return CmdTest(argv[2], wb, lb);
+    if (argc != 5) { Usage(); return 2; }
+
+    Bytes a, b;
+    if (!ReadFile(argv[2], a) || !ReadFile(argv[3], b)) {
+        fprintf(stderr, "erro lendo entrada\n");
+        return 1;
+    }
+    if (strcmp(argv[1], "diff") == 0) {
+        Bytes patch = MakePatch(a, b, wb, lb);
+        if (!WriteFile(argv[4], patch)) { fprintf(stderr, "erro gravando %s\n", argv[4]); return 1; }
+        printf("%s: %zu -> %zu bytes (%.1fx)\n", argv[4], b.size(), patch.size(), (double)b.size() / patch.size());
+        return 0;
+    }
+    if (strcmp(argv[1], "apply") == 0) {
+        Bytes out;
+        std::string err;
+        if (!ApplyPatch(a, b, out, err)) { fprintf(stderr, "%s\n", err.c_str()); return 1; }
+        if (!WriteFile(argv[4], out)) { fprintf(stderr, "erro gravando %s\n", argv[4]); return 1; }
+        return 0;
+    }
+    Usage();
+    return 2;
+}
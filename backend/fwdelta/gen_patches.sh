@@ -0,0 +1,32 @@
+#!/usr/bin/env bash
+# Gera os patches delta de cada firmware antigo para o .bin mais novo do tipo.
+#   firmware/KH/RBS_KH_260125.bin + RBS_KH_260126.bin (mais novo)
+#     -> firmware/KH/delta/RBS_KH_260125.bin.rbsd
+# O backend (iot-ota.js) serve /ota/<tipo>/latest.delta?from=<FW_VERSION>
+# só se o patch existir e apontar para o .bin mais novo; senão o device baixa
+# a imagem completa.
+set -euo pipefail
+
+HERE="$(cd "$(dirname "$0")" && pwd)"
+FW_DIR="${1:-$HERE/../firmware}"
+TOOL="$HERE/fwdelta"
+KEEP="${FWDELTA_KEEP:-5}"   # quantas versões anteriores recebem patch
+
+[ -x "$TOOL" ] || make -C "$HERE" fwdelta
+
+for dir in "$FW_DIR"/KH "$FW_DIR"/DOSER "$FW_DIR"/LCD; do
+  [ -d "$dir" ] || continue
+  mapfile -t bins < <(cd "$dir" && ls -1 RBS_*.bin 2>/dev/null | sort)
+  [ "${#bins[@]}" -ge 2 ] || continue
+
+  latest="${bins[-1]}"
+  rm -rf "$dir/delta"
+  mkdir -p "$dir/delta"
+  echo "$latest" > "$dir/delta/TARGET"
+
+  start=$(( ${#bins[@]} - 1 - KEEP ))
+  [ "$start" -ge 0 ] || start=0
+  for (( i = start; i < ${#bins[@]} - 1; i++ )); do
+    "$TOOL" diff "$dir/${bins[$i]}" "$dir/$latest" "$dir/delta/${bins[$i]}.rbsd"
+  done
+done
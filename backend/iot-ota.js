@@ -3,6 +3,7 @@
 
 const fs = require('fs');
 const path = require('path');
+const crypto = require('crypto');
 const express = require('express');
 const pool = require('./db-pool');
 
@@ -45,6 +46,33 @@ function getLatestFirmwareForType(type /* 'KH' | 'LCD' | 'DOSER' */) {
   });
 }
 
+/**
+ * SHA-256 (hex) de um .bin, em cache por caminho + mtime + tamanho.
+ * Os devices verificam o digest em streaming (header X-Firmware-SHA256) e
+ * usam o mesmo valor para saber se um download parcial pode ser retomado.
+ */
+const fwShaCache = new Map(); // filepath -> { mtimeMs, size, sha256 }
+
+function getFirmwareSha256(filepath) {
+  const st = fs.statSync(filepath);
+  const cached = fwShaCache.get(filepath);
+  if (cached && cached.mtimeMs === st.mtimeMs && cached.size === st.size) {
+    return Promise.resolve(cached.sha256);
+  }
+
+  return new Promise((resolve, reject) => {
+    const hash = crypto.createHash('sha256');
+    fs.createReadStream(filepath)
+      .on('data', (chunk) => hash.update(chunk))
+      .on('error', reject)
+      .on('end', () => {
+        const sha256 = hash.digest('hex');
+        fwShaCache.set(filepath, { mtimeMs: st.mtimeMs, size: st.size, sha256 });
+        resolve(sha256);
+      });
+  });
+}
+
 /**
  * Monta URL do .bin no GitHub a partir do nome
  */
@@ -344,7 +372,14 @@ router.get('/ota/:type/latest.bin', async (req, res) => {
       return res.redirect(downloadUrl);
     }
 
-    console.log(`[OTA] Servindo firmware local: ${localFile} de ${filepath}`);
+    // Digest para verificação no device; res.download já envia ETag,
+    // Accept-Ranges e responde 206 a "Range: bytes=N-" (retomada do OTA)
+    const sha256 = await getFirmwareSha256(filepath);
+    res.set('X-Firmware-SHA256', sha256);
+    res.set('X-Firmware-Name', localFile);
+
+    console.log(`[OTA] Servindo firmware local: ${localFile} de ${filepath}` +
+      (req.headers.range ? ` (${req.headers.range})` : ''));
     return res.download(filepath);
 
   } catch (err) {
@@ -354,6 +389,54 @@ router.get('/ota/:type/latest.bin', async (req, res) => {
 });
 
 
+/**
+ * GET /ota/:type/latest.delta?from=RBS_KH_260125.bin
+ *
+ * Patch RBSD (fwdelta/gen_patches.sh) do firmware 'from' para o .bin mais
+ * novo. 404 quando não há patch para essa versão ou o patch está velho;
+ * o device então baixa /ota/:type/latest.bin.
+ */
+router.get('/ota/:type/latest.delta', async (req, res) => {
+  try {
+    const type = req.params.type.toUpperCase();
+
+    if (!['KH', 'DOSER', 'LCD'].includes(type)) {
+      return res.status(400).json({ error: 'Invalid firmware type' });
+    }
+
+    const from = String(req.query.from || '');
+    if (!new RegExp(`^RBS_${type}_\\d+\\.bin$`).test(from)) {
+      return res.status(400).json({ error: 'Invalid from version' });
+    }
+
+    const latest = getLatestFirmwareForType(type);
+    const deltaDir = path.join(FW_DIR, type, 'delta');
+    const targetFile = path.join(deltaDir, 'TARGET');
+    const filepath = path.join(deltaDir, `${from}.rbsd`);
+
+    // TARGET diz para qual .bin os patches foram gerados
+    const target = fs.existsSync(targetFile)
+      ? fs.readFileSync(targetFile, 'utf8').trim()
+      : null;
+    if (!latest || from === latest || target !== latest || !fs.existsSync(filepath)) {
+      return res.status(404).json({ error: 'No delta for this version' });
+    }
+
+    const sha256 = await getFirmwareSha256(filepath);
+    res.set('X-Firmware-SHA256', sha256);
+    res.set('X-Firmware-Name', latest);
+
+    console.log(`[OTA] Servindo delta ${from} -> ${latest}` +
+      (req.headers.range ? ` (${req.headers.range})` : ''));
+    return res.download(filepath);
+
+  } catch (err) {
+    console.error('[OTA] Erro em /ota/:type/latest.delta:', err.message);
+    res.status(500).json({ error: err.message });
+  }
+});
+
+
 
 // ======== EXPORTS ========
 
@@ -361,6 +444,7 @@ module.exports = {
   router,
   otaInit: initOtaLogsTable,
   getLatestFirmwareForType,
+  getFirmwareSha256,
   buildGithubFirmwareUrl,
   logOtaEvent,
   getOtaHistory,
@@ -0,0 +1,19 @@
+// kh-summary-events.js
+// Barramento em memória que avisa os streams de resumo do LCD
+// (/api/v1/user/display/kh-summary/stream) quando entra medição nova,
+// seja via /device/sync do KH ou via resultado de teste agendado.
+const { EventEmitter } = require('events');
+
+const khSummaryEvents = new EventEmitter();
+// um listener por display conectado; sem limite fixo
+khSummaryEvents.setMaxListeners(0);
+
+function notifyKhMeasurement(deviceId) {
+  if (!deviceId) return;
+  khSummaryEvents.emit('measurement', String(deviceId));
+}
+
+module.exports = {
+  khSummaryEvents,
+  notifyKhMeasurement,
+};
@@ -4,6 +4,7 @@
 
 const express = require('express');
 const router = express.Router();
+const { notifyKhMeasurement } = require('./kh-summary-events');
 
 // ==============================================================================
 // HELPER: Calcular próximo teste baseado no intervalo
@@ -436,6 +437,7 @@ router.post('/api/v1/device/test-result', verifyToken, async (req, res) => {
            VALUES (?, ?, ?, ?, ?, ?, 'ok', ?)`,
           [deviceId, testTime, kh, phref || null, phsample || null, temperature || null, confidence || 1.0]
         );
+        notifyKhMeasurement(deviceId);
       }
 
       return res.json({
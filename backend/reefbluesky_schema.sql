@@ -98,6 +98,9 @@ CREATE TABLE `device_health` (
   `wifi_rssi` int(11) DEFAULT NULL,
   `uptime_seconds` int(11) DEFAULT NULL,
   `updatedAt` datetime NOT NULL DEFAULT current_timestamp(),
+  `heap_free` int(11) DEFAULT NULL,
+  `heap_min_free` int(11) DEFAULT NULL,
+  `heap_largest_block` int(11) DEFAULT NULL,
   PRIMARY KEY (`id`),
   KEY `idx_dev_user` (`deviceId`,`userId`,`updatedAt`)
 ) ENGINE=InnoDB AUTO_INCREMENT=192326 DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
@@ -493,6 +496,28 @@ CREATE TABLE `measurements` (
 ) ENGINE=InnoDB AUTO_INCREMENT=186 DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_general_ci;
 /*!40101 SET character_set_client = @saved_cs_client */;
 
+--
+-- Table structure for table `measurement_rollups`
+--
+
+DROP TABLE IF EXISTS `measurement_rollups`;
+/*!40101 SET @saved_cs_client     = @@character_set_client */;
+/*!40101 SET character_set_client = utf8mb4 */;
+CREATE TABLE `measurement_rollups` (
+  `deviceId` varchar(50) NOT NULL,
+  `tier` enum('h','d','w') NOT NULL,
+  `bucket_start` bigint(20) NOT NULL,
+  `n` int(10) unsigned NOT NULL,
+  `mean` float NOT NULL,
+  `m2` float NOT NULL,
+  `min_kh` float NOT NULL,
+  `max_kh` float NOT NULL,
+  `last_kh` float NOT NULL,
+  `updatedAt` timestamp NOT NULL DEFAULT current_timestamp() ON UPDATE current_timestamp(),
+  PRIMARY KEY (`deviceId`,`tier`,`bucket_start`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
+/*!40101 SET character_set_client = @saved_cs_client */;
+
 --
 -- Table structure for table `users`
 --
@@ -23,6 +23,7 @@ const cors = require('cors');
 const compression = require('compression');
 const rateLimit = require('express-rate-limit');
 const fs = require('fs');
+const crypto = require('crypto');
 
 const pool = require('./db-pool');
 const nodemailer = require('nodemailer');
@@ -32,6 +33,9 @@ const dosingIotRoutes  = require('./dosing-iot-routes');
 const dosingDeviceRoutes = require('./dosing-device-routes');
 const { router: dosingLogsRoutes } = require('./dosing-logs-routes');
 const khTestScheduleRoutes = require('./kh-test-schedule-routes');
+const { khSummaryEvents, notifyKhMeasurement } = require('./kh-summary-events');
+const { notifyDoserCommand } = require('./doser-command-events');
+const binlog = require('./binlog/binlog');
 
 const { getLatestFirmwareForType } = require('./iot-ota');
 
@@ -2920,6 +2924,42 @@ app.post('/api/v1/device/sync', verifyToken, syncLimiter, async (req, res) => {
       `[DB] ✅ ${insertedCount}/${measurements.length} medições gravadas`
     );
 
+    // 4) Rollups hora/dia/semana calculados no device (KH v4): upsert pelo
+    //    estado mais completo do bucket (n maior), reenvio fora de ordem não regride
+    const rollups = Array.isArray(req.body.rollups) ? req.body.rollups : [];
+    let rollupCount = 0;
+    for (const r of rollups) {
+      const nums = [r.start, r.n, r.mean, r.m2, r.min, r.max, r.last];
+      if (!['h', 'd', 'w'].includes(r.tier) || !nums.every(Number.isFinite) || r.n <= 0) {
+        continue;
+      }
+      try {
+        await conn.execute(
+          `INSERT INTO measurement_rollups
+             (deviceId, tier, bucket_start, n, mean, m2, min_kh, max_kh, last_kh)
+           VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
+           ON DUPLICATE KEY UPDATE
+             mean    = IF(VALUES(n) >= n, VALUES(mean), mean),
+             m2      = IF(VALUES(n) >= n, VALUES(m2), m2),
+             min_kh  = IF(VALUES(n) >= n, VALUES(min_kh), min_kh),
+             max_kh  = IF(VALUES(n) >= n, VALUES(max_kh), max_kh),
+             last_kh = IF(VALUES(n) >= n, VALUES(last_kh), last_kh),
+             n       = GREATEST(n, VALUES(n))`,
+          [req.user.deviceId, r.tier, r.start, r.n, r.mean, r.m2, r.min, r.max, r.last]
+        );
+        rollupCount++;
+      } catch (rollupErr) {
+        console.error(`[DB] Erro ao gravar rollup ${r.tier}/${r.start}:`, rollupErr.message);
+      }
+    }
+    if (rollupCount > 0) {
+      console.log(`[DB] ${rollupCount} rollups gravados`);
+    }
+
+    if (insertedCount > 0) {
+      notifyKhMeasurement(req.user.deviceId);
+    }
+
     // 🔔 TELEGRAM: pegar última medição KH deste sync
     try {
       const last = measurements[measurements.length - 1];
@@ -3158,11 +3198,18 @@ app.get('/api/v1/dev/device-console/:deviceId', authUserMiddleware, async (req,
 
 
 
-// ESP envia linhas de log
-app.post('/api/v1/device/logs', verifyToken, async (req, res) => {
+// ESP envia linhas de log (JSON) ou frames do log binário do KH
+// (application/octet-stream, ver binlog/binlog.js)
+app.post('/api/v1/device/logs', verifyToken,
+  express.raw({ type: 'application/octet-stream', limit: '256kb' }),
+  async (req, res) => {
   const deviceId = req.user.deviceId;
   const userId   = req.user.userId || null;
-  let { lines, logs } = req.body;
+  let { lines, logs } = Buffer.isBuffer(req.body) ? {} : (req.body || {});
+
+  if (Buffer.isBuffer(req.body)) {
+    lines = decodeBinlogLines(req.body);
+  }
 
   // Suporte para logs como string (parse automático)
   if (typeof logs === 'string' && logs.length > 0) {
@@ -3190,6 +3237,33 @@ app.post('/api/v1/device/logs', verifyToken, async (req, res) => {
     });
   }
 
+  try {
+    await saveDeviceLogs(deviceId, userId, lines);
+    return res.json({ success: true });
+  } catch (err) {
+    console.error('Erro ao gravar device_logs', err.message);
+    return res.status(500).json({
+      success: false,
+      message: 'Erro ao gravar logs do dispositivo',
+    });
+  }
+});
+
+// Frame do log binário do KH -> linhas (com aviso de descartes no device)
+function decodeBinlogLines(buf) {
+  const decoded = binlog.decode(buf);
+  const lines = decoded.lines;
+  if (decoded.dropped > 0) {
+    lines.push({
+      ts: Date.now(),
+      level: 'WARN',
+      message: `${decoded.dropped} logs descartados no device (buffer cheio)`,
+    });
+  }
+  return lines;
+}
+
+async function saveDeviceLogs(deviceId, userId, lines) {
   let conn;
   try {
     conn = await pool.getConnection();
@@ -3205,18 +3279,72 @@ app.post('/api/v1/device/logs', verifyToken, async (req, res) => {
       const level = l.level || null;
       await conn.query(sql, [deviceId, userId, ts, level, l.message]);
     }
-
-    return res.json({ success: true });
-  } catch (err) {
-    console.error('Erro ao gravar device_logs', err.message);
-    return res.status(500).json({
-      success: false,
-      message: 'Erro ao gravar logs do dispositivo',
-    });
   } finally {
     if (conn) try { conn.release(); } catch (_) {}
   }
-});
+}
+
+// Grava um snapshot de health (POST /device/health e frame de telemetria).
+// false = métricas inválidas (nada gravado)
+async function saveDeviceHealth(deviceId, userId, health) {
+  // Converte tudo pra número
+  const cpu = Number(health.cpu_usage ?? health.cpuusage ?? 0);
+  const mem = Number(health.memory_usage ?? health.memoryusage ?? 0);
+  const storageRaw = health.storage_usage ?? health.storageusage ?? null;
+  const storage = storageRaw == null ? null : Number(storageRaw);
+  const wifiRaw = health.wifi_rssi ?? health.wifirssi ?? null;
+  const wifi = wifiRaw == null ? null : Number(wifiRaw);
+  const uptime = Number(health.uptime ?? 0);
+  // Fragmentação do heap (KH v4+); ausente em firmwares antigos
+  const optInt = (v) => (v == null || !Number.isFinite(Number(v)) ? null : Math.trunc(Number(v)));
+  const heapFree = optInt(health.heap_free);
+  const heapMinFree = optInt(health.heap_min_free);
+  const heapLargest = optInt(health.heap_largest_block);
+
+  if (!Number.isFinite(cpu) || !Number.isFinite(mem) || !Number.isFinite(uptime)) {
+    console.log('[API] Health validation failed (coerção):', { cpu, mem, uptime });
+    return false;
+  }
+
+  console.log('[API] Health metrics:', {
+    cpu: cpu + '%',
+    memory: mem + '%',
+    uptime: uptime + 's',
+    wifi,
+    storage,
+    heapFree,
+    heapMinFree,
+    heapLargest,
+    jsonArenaPeak: health.json_arena_peak,
+    jsonArenaFallbacks: health.json_arena_fallbacks,
+  });
+
+  // [FIX] Extrair dados dos sensores se enviados
+  const sensorData = {};
+  if (health.level_a !== undefined) sensorData.levelA = health.level_a;
+  if (health.level_b !== undefined) sensorData.levelB = health.level_b;
+  if (health.level_c !== undefined) sensorData.levelC = health.level_c;
+  if (health.temperature !== undefined) sensorData.temperature = health.temperature;
+  if (health.ph !== undefined) sensorData.ph = health.ph;
+
+  // Salvar sensor_data como JSON no campo sensor_data da tabela devices
+  const sensorDataJSON = Object.keys(sensorData).length > 0 ? JSON.stringify(sensorData) : null;
+
+  await pool.query(
+    'UPDATE devices SET last_seen = NOW(), updatedAt = NOW(), sensor_data = ? WHERE deviceId = ?',
+    [sensorDataJSON, deviceId]
+  );
+
+  await pool.query(
+    `INSERT INTO device_health
+       (deviceId, userId, cpu_usage, mem_usage, storage_usage, wifi_rssi, uptime_seconds,
+        heap_free, heap_min_free, heap_largest_block)
+     VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)`,
+    [deviceId, userId, cpu, mem, storage, wifi, uptime, heapFree, heapMinFree, heapLargest]
+  );
+
+  return true;
+}
 
 /**
  * POST /api/v1/device/health
@@ -3232,18 +3360,7 @@ app.post('/api/v1/device/health', verifyToken, async (req, res) => {
     console.log('HEALTH RAW body =', req.body);
 
     const health = req.body || {};
-
-    // Converte tudo pra número
-    const cpu = Number(health.cpu_usage ?? health.cpuusage ?? 0);
-    const mem = Number(health.memory_usage ?? health.memoryusage ?? 0);
-    const storageRaw = health.storage_usage ?? health.storageusage ?? null;
-    const storage = storageRaw == null ? null : Number(storageRaw);
-    const wifiRaw = health.wifi_rssi ?? health.wifirssi ?? null;
-    const wifi = wifiRaw == null ? null : Number(wifiRaw);
-    const uptime = Number(health.uptime ?? 0);
-
-    if (!Number.isFinite(cpu) || !Number.isFinite(mem) || !Number.isFinite(uptime)) {
-      console.log('[API] Health validation failed (coerção):', { cpu, mem, uptime });
+    if (!(await saveDeviceHealth(deviceId, userId, health))) {
       // Não derruba o device, só ignora o insert
       return res.json({
         success: true,
@@ -3251,37 +3368,6 @@ app.post('/api/v1/device/health', verifyToken, async (req, res) => {
       });
     }
 
-    console.log('[API] Health metrics:', {
-      cpu: cpu + '%',
-      memory: mem + '%',
-      uptime: uptime + 's',
-      wifi,
-      storage,
-    });
-
-    // [FIX] Extrair dados dos sensores se enviados
-    const sensorData = {};
-    if (health.level_a !== undefined) sensorData.levelA = health.level_a;
-    if (health.level_b !== undefined) sensorData.levelB = health.level_b;
-    if (health.level_c !== undefined) sensorData.levelC = health.level_c;
-    if (health.temperature !== undefined) sensorData.temperature = health.temperature;
-    if (health.ph !== undefined) sensorData.ph = health.ph;
-
-    // Salvar sensor_data como JSON no campo sensor_data da tabela devices
-    const sensorDataJSON = Object.keys(sensorData).length > 0 ? JSON.stringify(sensorData) : null;
-
-    await pool.query(
-      'UPDATE devices SET last_seen = NOW(), updatedAt = NOW(), sensor_data = ? WHERE deviceId = ?',
-      [sensorDataJSON, deviceId]
-    );
-
-    await pool.query(
-      `INSERT INTO device_health
-         (deviceId, userId, cpu_usage, mem_usage, storage_usage, wifi_rssi, uptime_seconds)
-       VALUES (?, ?, ?, ?, ?, ?, ?)`,
-      [deviceId, userId, cpu, mem, storage, wifi, uptime]
-    );
-
     return res.json({ success: true, message: 'Métricas de saúde recebidas' });
   } catch (err) {
     console.error('Error saving device health', err);
@@ -3301,23 +3387,25 @@ const khStatusByDevice = new Map();  // deviceId → { active, type, msg, pct, .
  * Payload: { active, type, msg, pct, compressor_remaining_s,
  *            level_a, level_b, level_c, ph, temperature }
  */
+function setKhStatus(deviceId, body) {
+  khStatusByDevice.set(deviceId, {
+    active:                body.active ?? false,
+    type:                  body.type   ?? '',
+    msg:                   body.msg    ?? '',
+    pct:                   Number(body.pct ?? -1),
+    compressor_remaining_s:Number(body.compressor_remaining_s ?? 0),
+    level_a:               Number(body.level_a  ?? 0),
+    level_b:               Number(body.level_b  ?? 0),
+    level_c:               Number(body.level_c  ?? 0),
+    ph:                    Number(body.ph        ?? 0),
+    temperature:           Number(body.temperature ?? 0),
+    updated_at:            Date.now(),
+  });
+}
+
 app.post('/api/v1/device/kh-status', verifyToken, async (req, res) => {
   try {
-    const deviceId = req.user.deviceId;
-    const body = req.body || {};
-    khStatusByDevice.set(deviceId, {
-      active:                body.active ?? false,
-      type:                  body.type   ?? '',
-      msg:                   body.msg    ?? '',
-      pct:                   Number(body.pct ?? -1),
-      compressor_remaining_s:Number(body.compressor_remaining_s ?? 0),
-      level_a:               Number(body.level_a  ?? 0),
-      level_b:               Number(body.level_b  ?? 0),
-      level_c:               Number(body.level_c  ?? 0),
-      ph:                    Number(body.ph        ?? 0),
-      temperature:           Number(body.temperature ?? 0),
-      updated_at:            Date.now(),
-    });
+    setKhStatus(req.user.deviceId, req.body || {});
     return res.json({ success: true });
   } catch (err) {
     console.error('[kh-status POST]', err);
@@ -3346,6 +3434,96 @@ app.get('/api/v1/user/devices/:deviceId/kh-status', authUserMiddleware, async (r
   }
 });
 
+// ============================================================================
+// Frame único de telemetria do KH (TelemetryFrame.h no firmware)
+// ============================================================================
+// Health, progresso do ciclo, versão e logs num POST só. Campos de health
+// vêm só quando mudaram; o último estado de cada device fica em memória e
+// completa o resto. Sem estado (servidor reiniciou) e sem keyframe ->
+// responde resync e o device manda tudo no próximo frame.
+const telemetryStateByDevice = new Map(); // deviceId → { health, upAt, fw }
+
+const TELEMETRY_HEALTH_KEYS = {
+  mem: 'memoryusage',
+  sto: 'storageusage',
+  rssi: 'wifirssi',
+  la: 'level_a',
+  lb: 'level_b',
+  lc: 'level_c',
+  t: 'temperature',
+  ph: 'ph',
+  hf: 'heap_free',
+  hm: 'heap_min_free',
+  hb: 'heap_largest_block',
+  jp: 'json_arena_peak',
+  jf: 'json_arena_fallbacks',
+};
+
+app.post('/api/v1/device/telemetry', verifyToken, async (req, res) => {
+  const deviceId = req.user.deviceId;
+  const userId = req.user.userId;
+  const frame = req.body || {};
+  const keyframe = !!frame.k;
+
+  let state = telemetryStateByDevice.get(deviceId);
+  const resync = !state && !keyframe;
+  if (!state) {
+    state = { health: {}, upAt: Date.now(), fw: null };
+    telemetryStateByDevice.set(deviceId, state);
+  }
+
+  try {
+    if (frame.h && typeof frame.h === 'object') {
+      for (const [k, v] of Object.entries(frame.h)) {
+        if (TELEMETRY_HEALTH_KEYS[k]) state.health[TELEMETRY_HEALTH_KEYS[k]] = v;
+      }
+      // Uptime só vem no keyframe; no meio, extrapola
+      if (frame.h.up != null) {
+        state.health.uptime = Number(frame.h.up);
+        state.upAt = Date.now();
+      }
+      if (!resync) {
+        const uptime = Number(state.health.uptime ?? 0) +
+          Math.floor((Date.now() - state.upAt) / 1000);
+        await saveDeviceHealth(deviceId, userId, { ...state.health, uptime });
+      }
+    }
+
+    if (frame.p && typeof frame.p === 'object') {
+      setKhStatus(deviceId, {
+        active: !!frame.p.a,
+        type: frame.p.ty,
+        msg: frame.p.m,
+        pct: frame.p.pct,
+        compressor_remaining_s: frame.p.cs,
+        level_a: state.health.level_a,
+        level_b: state.health.level_b,
+        level_c: state.health.level_c,
+        ph: state.health.ph,
+        temperature: state.health.temperature,
+      });
+    }
+
+    if (typeof frame.fw === 'string' && frame.fw !== state.fw) {
+      await pool.query(
+        'UPDATE devices SET firmware_version = ?, updatedAt = NOW() WHERE deviceId = ?',
+        [frame.fw, deviceId]
+      );
+      state.fw = frame.fw;
+    }
+
+    if (typeof frame.log === 'string' && frame.log.length > 0) {
+      const lines = decodeBinlogLines(Buffer.from(frame.log, 'base64'));
+      if (lines.length) await saveDeviceLogs(deviceId, userId, lines);
+    }
+
+    return res.json({ success: true, resync });
+  } catch (err) {
+    console.error('POST /device/telemetry error', err);
+    return res.status(500).json({ success: false, message: 'Erro ao gravar telemetria' });
+  }
+});
+
 // [FIX] POST /api/v1/device/alert - Recebe alertas do ESP32 (calibração, erros, etc)
 app.post('/api/v1/device/alert', verifyToken, async (req, res) => {
   console.log('[API] POST /api/v1/device/alert');
@@ -3602,6 +3780,114 @@ app.get('/api/v1/device/kh-reference', verifyToken, async (req, res) => {
 });
 
 
+// ============================================================================
+// LAN monitor <-> dosadora (LanLink do ReefBlueSkyCore)
+// ============================================================================
+
+// Chave LAN: a mesma para todos os aparelhos do usuário (monitor e dosadora
+// autenticam os datagramas um do outro com ela). Derivada, não gravada:
+// trocar o JWT_SECRET troca todas.
+function lanKeyForUser(userId) {
+  return crypto.createHmac('sha256', JWT_SECRET).update(`rbs-lan:${userId}`).digest();
+}
+
+/**
+ * GET /api/v1/device/lan-key
+ * Chave LAN do dono do aparelho (hex, 32 bytes). key_id = 4 primeiros
+ * bytes do SHA-256 da chave, só para conferência nos logs.
+ */
+app.get('/api/v1/device/lan-key', verifyToken, async (req, res) => {
+  const userId = req.user.userId;
+  if (!userId) {
+    return res.status(403).json({ success: false, error: 'Token sem usuário' });
+  }
+  const key = lanKeyForUser(userId);
+  const keyId = crypto.createHash('sha256').update(key).digest('hex').slice(0, 8);
+  console.log('[LAN] Chave entregue ao device', req.user.deviceId, 'key_id', keyId);
+  return res.json({ success: true, data: { key: key.toString('hex'), key_id: keyId } });
+});
+
+/**
+ * POST /api/v1/device/doser-dose
+ * Fallback do monitor quando a dosadora não confirma pela LAN: enfileira
+ * MANUAL_DOSE para a dosadora do mesmo usuário.
+ * Body: { pump_index, volume_ml, request_id?, doser_uid? }
+ * request_id é o mesmo mandado pela LAN: se a dose chegou a rodar (só o ACK
+ * se perdeu) a dosadora reconhece e não repete.
+ */
+app.post('/api/v1/device/doser-dose', verifyToken, async (req, res) => {
+  const userId = req.user.userId;
+  const pumpIndex = Number(req.body?.pump_index);
+  const volume = Number(req.body?.volume_ml);
+  const requestId = Number(req.body?.request_id) || 0;
+  const doserUid = typeof req.body?.doser_uid === 'string' ? req.body.doser_uid : null;
+
+  if (!Number.isInteger(pumpIndex) || pumpIndex < 0 || !(volume > 0) || volume > 500) {
+    return res.status(400).json({ success: false, error: 'pump_index/volume_ml inválidos' });
+  }
+
+  let conn;
+  try {
+    conn = await pool.getConnection();
+
+    const dev = await conn.query(
+      `SELECT id, esp_uid FROM dosing_devices
+       WHERE user_id = ? ${doserUid ? 'AND esp_uid = ?' : ''}
+       ORDER BY last_seen DESC LIMIT 1`,
+      doserUid ? [userId, doserUid] : [userId]
+    );
+    if (!dev || dev.length === 0) {
+      return res.status(404).json({ success: false, error: 'Dosadora não encontrada' });
+    }
+    const espUid = dev[0].esp_uid;
+
+    const pump = await conn.query(
+      `SELECT id FROM dosing_pumps WHERE device_id = ? AND index_on_device = ? LIMIT 1`,
+      [dev[0].id, pumpIndex]
+    );
+    if (!pump || pump.length === 0) {
+      return res.status(404).json({ success: false, error: 'Bomba não encontrada' });
+    }
+
+    // origin do banco é AUTO|MANUAL; quem pediu vai no payload do comando
+    const exec = await conn.query(
+      `INSERT INTO dosing_executions
+       (pump_id, scheduled_at, volume_ml, status, origin)
+       VALUES (?, NOW(), ?, 'PENDING', 'MANUAL')`,
+      [pump[0].id, Math.round(volume)]
+    );
+    const executionId = Number(exec.insertId);
+
+    await conn.query(
+      `INSERT INTO devicecommands (deviceId, type, payload, status)
+       VALUES (?, ?, ?, 'pending')`,
+      [
+        espUid,
+        'MANUAL_DOSE',
+        JSON.stringify({
+          pump_id: pump[0].id,
+          pump_index: pumpIndex,
+          volume_ml: volume,
+          execution_id: executionId,
+          origin: 'KH_MONITOR',
+          request_id: requestId
+        })
+      ]
+    );
+    notifyDoserCommand(espUid);   // acorda o long-poll da dosadora
+
+    console.log('[LAN] Fallback de dose do monitor', req.user.deviceId, '->', espUid,
+                `bomba ${pumpIndex} ${volume} mL req ${requestId}`);
+    return res.json({ success: true, data: { execution_id: executionId, esp_uid: espUid } });
+  } catch (err) {
+    console.error('POST /api/v1/device/doser-dose error', err.message);
+    return res.status(500).json({ success: false, error: 'servererror' });
+  } finally {
+    if (conn) conn.release();
+  }
+});
+
+
 /**
  * GET /api/v1/device/commands
  * [SEGURANÇA] Obter comandos pendentes
@@ -3725,6 +4011,7 @@ async function enqueueDbCommandToTable(tableName, deviceId, type, payload = null
     );
 
     console.log(`[CMD DEBUG] Comando inserido com sucesso na tabela ${tableName}, id=${result.insertId}`);
+    if (tableName === 'devicecommands') notifyDoserCommand(deviceId);   // acorda o long-poll
 
     return { id: Number(result.insertId), type };
   } finally {
@@ -3832,11 +4119,16 @@ app.post('/api/v1/user/devices/:deviceId/command/kh-correction', authUserMiddlew
   try {
     const { deviceId } = req.params;
     const userId = req.user.userId;
-    const { volume } = req.body;
+    const { volume, doser, pump_index } = req.body;
 
     if (typeof volume !== 'number' || volume <= 0) {
       return res.status(400).json({ success: false, message: 'volume inválido' });
     }
+    // doser=true: o monitor passa a correção para a bomba pump_index da
+    // dosadora (LAN direto, nuvem como fallback) em vez da bomba 4 dele
+    if (doser && (!Number.isInteger(pump_index) || pump_index < 0)) {
+      return res.status(400).json({ success: false, message: 'pump_index inválido' });
+    }
 
     const chk = await pool.query(
       'SELECT id FROM devices WHERE deviceId = ? AND userId = ? LIMIT 1',
@@ -3844,7 +4136,8 @@ app.post('/api/v1/user/devices/:deviceId/command/kh-correction', authUserMiddlew
     );
     if (!chk.length) return res.status(404).json({ success:false, message:'Device não encontrado para este usuário' });
 
-  const cmd = await enqueueDbCommand(deviceId, 'khcorrection', { volume });
+  const cmd = await enqueueDbCommand(deviceId, 'khcorrection',
+    doser ? { volume, doser: true, pump_index } : { volume });
   console.log('[CMD] khcorrection enfileirado', deviceId, cmd);
 
 
@@ -4434,9 +4727,33 @@ app.post('/api/v1/dev/lcd-firmware-update/:deviceId',
 );
 
 
-// ESP busca comandos pendentes
+// ESP busca comandos pendentes.
+// Firmware com lote manda { max, acks: [{ id, status, errorMessage }] }: os acks
+// (done/error, ou pending = devolver à fila) são aplicados antes da busca e
+// vêm até 'max' comandos, em ordem. Comando com payload.dependsOn só sai
+// depois que a dependência terminar; se ela falhou, ele vira erro aqui.
+// Sem corpo (firmware antigo) = 1 comando, como antes.
+const COMMAND_BATCH_MAX = 10;
+const COMMAND_ACK_STATUS = ['done', 'error', 'pending'];
+
+function parseCommandPayload(raw) {
+  if (raw == null) return null;
+  if (typeof raw === 'object') return raw; // já é objeto
+  try {
+    return JSON.parse(raw);
+  } catch (e) {
+    console.error('Erro ao fazer JSON.parse do payload de comando', e.message, raw);
+    return null;
+  }
+}
+
 app.post('/api/v1/device/commands/poll', verifyToken, async (req, res) => {
   const deviceId = req.user.deviceId;
+  const body = req.body || {};
+  const max = body.max === undefined
+    ? 1
+    : Math.max(0, Math.min(COMMAND_BATCH_MAX, parseInt(body.max, 10) || 0));
+  const acks = Array.isArray(body.acks) ? body.acks.slice(0, 2 * COMMAND_BATCH_MAX) : [];
 
   let conn;
   try {
@@ -4447,55 +4764,79 @@ app.post('/api/v1/device/commands/poll', verifyToken, async (req, res) => {
       [deviceId]
     );
 
-
-    const rows = await conn.query(
-      `SELECT id, type, payload
-         FROM device_commands
-        WHERE deviceId = ?
-          AND status = 'pending'
-        ORDER BY createdAt ASC
-        LIMIT 1`,
-      [deviceId]
-    );
-
-    const ids = rows.map(r => r.id);
-    if (ids.length > 0) {
-      await conn.query(
+    let acked = 0;
+    for (const ack of acks) {
+      const id = parseInt(ack && ack.id, 10);
+      const status = ack && ack.status;
+      if (!id || !COMMAND_ACK_STATUS.includes(status)) continue;
+      const errorMessage = status === 'error' && ack.errorMessage
+        ? String(ack.errorMessage).slice(0, 500)
+        : null;
+      const r = await conn.query(
         `UPDATE device_commands
-            SET status = 'inprogress', updatedAt = NOW()
-          WHERE id IN (${ids.map(() => '?').join(',')})`,
-        ids
+            SET status = ?, errorMessage = ?, updatedAt = NOW()
+          WHERE id = ? AND deviceId = ? AND status = 'inprogress'`,
+        [status, errorMessage, id, deviceId]
       );
+      acked += r.affectedRows;
     }
 
+    const commands = [];
+    if (max > 0) {
+      const rows = await conn.query(
+        `SELECT id, type, payload
+           FROM device_commands
+          WHERE deviceId = ?
+            AND status = 'pending'
+          ORDER BY createdAt ASC, id ASC
+          LIMIT ?`,
+        [deviceId, max]
+      );
 
-    const commands = rows.map((r) => {
-
-      // normalizar id e eventualmente outros campos BigInt
-      const id = typeof r.id === 'bigint' ? Number(r.id) : r.id;
-      let payload = null;
-
-      if (r.payload != null) {
-        if (typeof r.payload === 'string') {
-          try {
-            payload = JSON.parse(r.payload);
-          } catch (e) {
-            console.error('Erro ao fazer JSON.parse do payload de comando', e.message, r.payload);
-            payload = null;
+      const failed = new Set();
+      for (const r of rows) {
+        // normalizar id e eventualmente outros campos BigInt
+        const id = typeof r.id === 'bigint' ? Number(r.id) : r.id;
+        const payload = parseCommandPayload(r.payload);
+        const dependsOn = payload && parseInt(payload.dependsOn, 10) || 0;
+
+        if (dependsOn && !commands.some(c => c.id === dependsOn)) {
+          let depStatus = failed.has(dependsOn) ? 'error' : null;
+          if (!depStatus) {
+            const dep = await conn.query(
+              'SELECT status FROM device_commands WHERE id = ? AND deviceId = ? LIMIT 1',
+              [dependsOn, deviceId]
+            );
+            depStatus = dep.length ? dep[0].status : 'done'; // apagada = sem dependência
+          }
+          if (depStatus === 'error') {
+            await conn.query(
+              `UPDATE device_commands
+                  SET status = 'error', errorMessage = ?, updatedAt = NOW()
+                WHERE id = ?`,
+              [`dependência #${dependsOn} falhou`, id]
+            );
+            failed.add(id);
+            continue;
           }
-        } else if (typeof r.payload === 'object') {
-          payload = r.payload; // já é objeto
+          if (depStatus !== 'done') break; // ainda rodando: preserva a ordem
         }
+
+        commands.push({ id, type: r.type, payload, dependsOn });
       }
 
-      return {
-        id,
-        type: r.type,
-        payload,
-      };
-    });
+      const ids = commands.map(c => c.id);
+      if (ids.length > 0) {
+        await conn.query(
+          `UPDATE device_commands
+              SET status = 'inprogress', updatedAt = NOW()
+            WHERE id IN (${ids.map(() => '?').join(',')})`,
+          ids
+        );
+      }
+    }
 
-    return res.json({ success: true, data: commands });
+    return res.json({ success: true, data: commands, batch: true, acked });
 
   } catch (err) {
     console.error('POST /device/commands/poll error', err);
@@ -4900,6 +5241,27 @@ app.put('/api/v1/user/devices/:deviceId/kh-config', authUserMiddleware, async (r
 });
 
 
+// Min/max de KH desde fromTs (ms) pelos rollups horários que o KH v4 manda no
+// sync, sem varrer measurements. null se os rollups do device não cobrem o
+// período inteiro (firmware antigo ou recém-atualizado) -> usar a tabela crua.
+// Resolução de 1 h: o bucket que contém fromTs entra inteiro.
+async function khRangeFromRollups(deviceId, fromTs) {
+  const rows = await pool.query(
+    `SELECT SUM(n) AS n, MIN(min_kh) AS minKh, MAX(max_kh) AS maxKh,
+            (SELECT MIN(bucket_start) FROM measurement_rollups
+              WHERE deviceId = ? AND tier = 'h') AS firstStart
+       FROM measurement_rollups
+      WHERE deviceId = ? AND tier = 'h' AND bucket_start > ?`,
+    [deviceId, deviceId, fromTs - 3600 * 1000]
+  );
+  const r = rows[0] || {};
+  if (r.n == null || Number(r.n) === 0 || r.firstStart == null ||
+      Number(r.firstStart) > fromTs) {
+    return null;
+  }
+  return { minKh: parseFloat(r.minKh), maxKh: parseFloat(r.maxKh) };
+}
+
 app.get('/api/v1/user/devices/:deviceId/kh-metrics', authUserMiddleware, async (req, res) => {
   try {
     const userId = req.user.userId;
@@ -4934,14 +5296,16 @@ app.get('/api/v1/user/devices/:deviceId/kh-metrics', authUserMiddleware, async (
     for (const [label, windowMs] of Object.entries(windows)) {
       const fromTs = now - windowMs; // também em ms
 
-      const rows = await pool.query(
-        `SELECT MIN(kh) AS minKh, MAX(kh) AS maxKh
-         FROM measurements
-         WHERE deviceId = ? AND timestamp >= ?`,
-        [deviceId, fromTs]
-      );
-
-      const r = rows[0] || {};
+      let r = await khRangeFromRollups(deviceId, fromTs);
+      if (!r) {
+        const rows = await pool.query(
+          `SELECT MIN(kh) AS minKh, MAX(kh) AS maxKh
+           FROM measurements
+           WHERE deviceId = ? AND timestamp >= ?`,
+          [deviceId, fromTs]
+        );
+        r = rows[0] || {};
+      }
       if (r.minKh == null || r.maxKh == null) {
         metrics[label] = null;
         continue;
@@ -5185,123 +5549,276 @@ app.get('/api/v1/user/devices/:deviceId/health', authUserMiddleware, async (req,
 // ============================================================================
 
 
+// Calcula o resumo de KH exibido no LCD.
+// Retorna undefined se o device não é do usuário, null se ainda não há medição.
+async function computeKhSummary(deviceId, userId) {
+  // 1) garantir que o device é do usuário
+  const devRows = await pool.query(
+    `SELECT deviceId, kh_target, kh_health_green_max_dev, kh_health_yellow_max_dev
+       FROM devices
+      WHERE deviceId = ? AND userId = ?
+      LIMIT 1`,
+    [deviceId, userId]
+  );
+  if (!devRows.length) {
+    return undefined;
+  }
+  const khTarget = devRows[0].kh_target;
+
+  // 2) última medição de KH
+  const lastRows = await pool.query(
+    `SELECT kh, timestamp
+       FROM measurements
+      WHERE deviceId = ?
+      ORDER BY timestamp DESC
+      LIMIT 1`,
+    [deviceId]
+  );
+  if (!lastRows.length) {
+    return null;
+  }
+  const lastRow = lastRows[0];
+
+  // garante tipos numéricos simples
+  const lastKh   = parseFloat(lastRow.kh);
+  const lastTsMs = Number(lastRow.timestamp.toString());
+
+  // 3) min/max em 24h
+  const nowMs   = Date.now();
+  const from24h = nowMs - 24*3600*1000;
+
+  let mm = await khRangeFromRollups(deviceId, from24h);
+  if (!mm) {
+    const mmRows = await pool.query(
+      `SELECT MIN(kh) AS minKh, MAX(kh) AS maxKh
+         FROM measurements
+        WHERE deviceId = ? AND timestamp >= ?`,
+      [deviceId, from24h]
+    );
+    mm = mmRows[0] || {};
+  }
+  const khMin = mm.minKh != null ? parseFloat(mm.minKh) : lastKh;
+  const khMax = mm.maxKh != null ? parseFloat(mm.maxKh) : lastKh;
+
+  // 4) variação em relação ao teste anterior
+  const prevRows = await pool.query(
+    `SELECT kh
+       FROM measurements
+      WHERE deviceId = ?
+        AND timestamp < ?
+      ORDER BY timestamp DESC
+      LIMIT 1`,
+    [deviceId, lastTsMs]
+  );
+
+  let khVar = 0;
+  if (prevRows.length) {
+    const prevKh = parseFloat(prevRows[0].kh);
+    khVar = lastKh - prevKh;   // KH atual - KH anterior
+  }
+
+  // 5) saúde
+  let health = null;
+
+  const cfg = devRows[0];
+  const greenMaxDev  = cfg.kh_health_green_max_dev  != null ? parseFloat(cfg.kh_health_green_max_dev)  : 0.2;
+  const yellowMaxDev = cfg.kh_health_yellow_max_dev != null ? parseFloat(cfg.kh_health_yellow_max_dev) : 0.5;
+
+  if (khTarget != null) {
+    const khTargetNum = parseFloat(khTarget);
+    const dev = Math.abs(lastKh - khTargetNum); // desvio em dKH
+
+    if (dev <= greenMaxDev) {
+      health = 1.0;                       // 100% saudável
+    } else if (dev <= yellowMaxDev) {
+      // interpolação linear entre verde e amarelo
+      const t = (dev - greenMaxDev) / (yellowMaxDev - greenMaxDev);
+      health = 1.0 - 0.5 * t;            // cai de 1.0 para 0.5
+    } else {
+      // desvio acima do amarelo, vai até 0
+      const maxDev = yellowMaxDev * 2;   // por exemplo
+      const t = Math.min(1, (dev - yellowMaxDev) / (maxDev - yellowMaxDev));
+      health = 0.5 * (1.0 - t);          // cai de 0.5 para 0.0
+    }
+  }
+
+  return {
+    nowIso:      new Date(lastTsMs).toISOString(),
+    timestampMs: lastTsMs,
+    kh:          lastKh,
+    khMin24h:    khMin,
+    khMax24h:    khMax,
+    khVar24h:    khVar,
+    khTarget:    khTarget,
+    health,
+    khHealthGreenMaxDev:  greenMaxDev,
+    khHealthYellowMaxDev: yellowMaxDev
+  };
+}
+
+// ETag fraco do resumo: muda só quando algum campo exibido muda
+function khSummaryEtag(data) {
+  const hash = crypto.createHash('sha1').update(JSON.stringify(data)).digest('hex');
+  return `W/"${hash.slice(0, 16)}"`;
+}
+
 // GET /api/v1/user/devices/:deviceId/display/kh-summary
+// Suporta If-None-Match: responde 304 sem corpo quando nada mudou.
 app.get('/api/v1/user/devices/:deviceId/display/kh-summary', authUserMiddleware, async (req, res) => {
   try {
     const userId   = req.user.userId;
     const deviceId = req.params.deviceId;
 
-    // 1) garantir que o device é do usuário
+    const data = await computeKhSummary(deviceId, userId);
+    if (data === undefined) {
+      return res.status(404).json({ success:false, message:'Device not found' });
+    }
+
+    const etag = khSummaryEtag(data);
+    res.set('ETag', etag);
+    res.set('Cache-Control', 'no-cache');
+
+    if (req.headers['if-none-match'] === etag) {
+      return res.status(304).end();
+    }
+
+    return res.json({ success: true, data });
+
+  } catch (err) {
+    console.error('Error kh-summary', err);
+    return res.status(500).json({ success:false, message:'Internal server error' });
+  }
+});
+
+// GET /api/v1/user/devices/:deviceId/display/kh-history?since=<epoch s>&limit=N
+// Histórico compacto para o sparkline do LCD: só pontos mais novos que since,
+// em ordem crescente, como dois arrays paralelos (t em segundos, kh).
+// Paginado: até limit pontos a partir de since; menos que limit = fim.
+app.get('/api/v1/user/devices/:deviceId/display/kh-history', authUserMiddleware, async (req, res) => {
+  try {
+    const userId   = req.user.userId;
+    const deviceId = req.params.deviceId;
+
     const devRows = await pool.query(
-      'SELECT deviceId, kh_target FROM devices WHERE deviceId = ? AND userId = ? LIMIT 1',
+      'SELECT deviceId FROM devices WHERE deviceId = ? AND userId = ? LIMIT 1',
       [deviceId, userId]
     );
     if (!devRows.length) {
       return res.status(404).json({ success:false, message:'Device not found' });
     }
-    const khTarget = devRows[0].kh_target;
 
-    // 2) última medição de KH
-    const lastRows = await pool.query(
+    // default: última semana (janela do sparkline)
+    const nowS   = Math.floor(Date.now() / 1000);
+    let   since  = Number(req.query.since);
+    if (!Number.isFinite(since) || since <= 0) since = nowS - 7 * 24 * 3600;
+    let   limit  = parseInt(req.query.limit, 10);
+    if (!Number.isFinite(limit) || limit <= 0) limit = 200;
+    limit = Math.min(limit, 500);
+
+    // os N mais antigos a partir do segundo seguinte a since, em ordem
+    // crescente: página cheia = há mais; o display pede de novo com since =
+    // último t. (Os N mais novos deixavam um buraco depois de queda longa.)
+    const rows = await pool.query(
       `SELECT kh, timestamp
          FROM measurements
-        WHERE deviceId = ?
-        ORDER BY timestamp DESC
-        LIMIT 1`,
-      [deviceId]
+        WHERE deviceId = ? AND timestamp >= ?
+        ORDER BY timestamp ASC
+        LIMIT ?`,
+      [deviceId, (since + 1) * 1000, limit]
     );
-    if (!lastRows.length) {
-      return res.json({ success:true, data:null });
+
+    const t  = [];
+    const kh = [];
+    for (let i = 0; i < rows.length; i++) {
+      t.push(Math.floor(Number(rows[i].timestamp) / 1000));
+      kh.push(Math.round(parseFloat(rows[i].kh) * 100) / 100);
     }
-    const lastRow = lastRows[0];
 
-    // garante tipos numéricos simples
-    const lastKh   = parseFloat(lastRow.kh);
-    const lastTsMs = Number(lastRow.timestamp.toString());
+    return res.json({ success: true, data: { t, kh } });
 
-    // 3) min/max em 24h
-    const nowMs   = Date.now();
-    const from24h = nowMs - 24*3600*1000;
+  } catch (err) {
+    console.error('Error kh-history', err);
+    return res.status(500).json({ success:false, message:'Internal server error' });
+  }
+});
 
-    const mmRows = await pool.query(
-      `SELECT MIN(kh) AS minKh, MAX(kh) AS maxKh
-         FROM measurements
-        WHERE deviceId = ? AND timestamp >= ?`,
-      [deviceId, from24h]
-    );
-    const mm = mmRows[0] || {};
-    const khMin = mm.minKh != null ? parseFloat(mm.minKh) : lastKh;
-    const khMax = mm.maxKh != null ? parseFloat(mm.maxKh) : lastKh;
+// GET /api/v1/user/display/kh-summary/stream
+// Server-Sent Events: envia o resumo de todos os KH do usuário ao conectar
+// e depois um evento "summary" a cada medição nova. Comentário de keepalive
+// a cada KH_SUMMARY_STREAM_PING_MS para o túnel/proxy não derrubar a conexão.
+const KH_SUMMARY_STREAM_PING_MS = 25000;
 
-    // 4) variação em relação ao teste anterior
-    const prevRows = await pool.query(
-      `SELECT kh
-         FROM measurements
-        WHERE deviceId = ?
-          AND timestamp < ?
-        ORDER BY timestamp DESC
-        LIMIT 1`,
-      [deviceId, lastTsMs]
+app.get('/api/v1/user/display/kh-summary/stream', authUserMiddleware, async (req, res) => {
+  const userId = req.user.userId;
+
+  let deviceIds;
+  try {
+    const rows = await pool.query(
+      `SELECT deviceId FROM devices WHERE userId = ? AND type = 'KH'`,
+      [userId]
     );
+    deviceIds = new Set(rows.map((r) => String(r.deviceId)));
+  } catch (err) {
+    console.error('Error kh-summary stream', err);
+    return res.status(500).json({ success:false, message:'Internal server error' });
+  }
 
-    let khVar = 0;
-    if (prevRows.length) {
-      const prevKh = parseFloat(prevRows[0].kh);
-      khVar = lastKh - prevKh;   // KH atual - KH anterior
-    }
+  res.status(200);
+  res.set({
+    'Content-Type':      'text/event-stream',
+    'Cache-Control':     'no-cache',
+    'Connection':        'keep-alive',
+    'X-Accel-Buffering': 'no',
+  });
+  res.flushHeaders();
 
-    // 5) saúde
-    let health = null;
+  console.log('[DISPLAY] kh-summary stream aberto userId=', userId, 'devices=', deviceIds.size);
 
-    const devCfgRows = await pool.query(
-      `SELECT kh_health_green_max_dev, kh_health_yellow_max_dev
-         FROM devices
-        WHERE deviceId = ? AND userId = ?
-        LIMIT 1`,
-      [deviceId, userId]
-    );
-    const cfg = devCfgRows[0] || {};
-    const greenMaxDev  = cfg.kh_health_green_max_dev  != null ? parseFloat(cfg.kh_health_green_max_dev)  : 0.2;
-    const yellowMaxDev = cfg.kh_health_yellow_max_dev != null ? parseFloat(cfg.kh_health_yellow_max_dev) : 0.5;
+  const lastEtags = new Map();
+  let closed = false;
 
-    if (khTarget != null) {
-      const khTargetNum = parseFloat(khTarget);
-      const dev = Math.abs(lastKh - khTargetNum); // desvio em dKH
-
-      if (dev <= greenMaxDev) {
-        health = 1.0;                       // 100% saudável
-      } else if (dev <= yellowMaxDev) {
-        // interpolação linear entre verde e amarelo
-        const t = (dev - greenMaxDev) / (yellowMaxDev - greenMaxDev);
-        health = 1.0 - 0.5 * t;            // cai de 1.0 para 0.5
-      } else {
-        // desvio acima do amarelo, vai até 0
-        const maxDev = yellowMaxDev * 2;   // por exemplo
-        const t = Math.min(1, (dev - yellowMaxDev) / (maxDev - yellowMaxDev));
-        health = 0.5 * (1.0 - t);          // cai de 0.5 para 0.0
-      }
+  // compression() bufferiza; flush explícito a cada evento
+  const write = (chunk) => {
+    if (closed) return;
+    res.write(chunk);
+    if (typeof res.flush === 'function') res.flush();
+  };
+
+  const pushSummary = async (deviceId) => {
+    try {
+      const data = await computeKhSummary(deviceId, userId);
+      if (data === undefined || closed) return;
+
+      // delta: só envia se o resumo mudou desde o último evento
+      const etag = khSummaryEtag(data);
+      if (lastEtags.get(deviceId) === etag) return;
+      lastEtags.set(deviceId, etag);
+
+      write(`event: summary\ndata: ${JSON.stringify({ deviceId, data })}\n\n`);
+    } catch (err) {
+      console.error('[DISPLAY] kh-summary stream erro', deviceId, err.message);
     }
-    
-    return res.json({
-      success: true,
-      data: {
-        nowIso:   new Date(lastTsMs).toISOString(),
-        kh:       lastKh,
-        khMin24h: khMin,
-        khMax24h: khMax,
-        khVar24h: khVar,
-        khTarget: khTarget,
-        health,
-        khHealthGreenMaxDev:  greenMaxDev,
-        khHealthYellowMaxDev: yellowMaxDev
-      }
-    });
+  };
 
+  const onMeasurement = (deviceId) => {
+    if (deviceIds.has(deviceId)) pushSummary(deviceId);
+  };
 
+  const ping = setInterval(() => write(': ping\n\n'), KH_SUMMARY_STREAM_PING_MS);
 
-  } catch (err) {
-    console.error('Error kh-summary', err);
-    return res.status(500).json({ success:false, message:'Internal server error' });
+  req.on('close', () => {
+    closed = true;
+    clearInterval(ping);
+    khSummaryEvents.removeListener('measurement', onMeasurement);
+    console.log('[DISPLAY] kh-summary stream fechado userId=', userId);
+  });
+
+  khSummaryEvents.on('measurement', onMeasurement);
+
+  // snapshot inicial
+  write(`retry: 10000\n\n`);
+  for (const deviceId of deviceIds) {
+    await pushSummary(deviceId);
   }
 });
 
@@ -5385,6 +5902,34 @@ async function ensureDeviceAlertsTable() {
   }
 }
 
+// Rollups de KH enviados pelo device no /device/sync
+async function ensureMeasurementRollupsTable() {
+  const conn = await pool.getConnection();
+  try {
+    await conn.query(`
+      CREATE TABLE IF NOT EXISTS measurement_rollups (
+        deviceId VARCHAR(50) NOT NULL,
+        tier ENUM('h', 'd', 'w') NOT NULL,
+        bucket_start BIGINT NOT NULL,
+        n INT UNSIGNED NOT NULL,
+        mean FLOAT NOT NULL,
+        m2 FLOAT NOT NULL,
+        min_kh FLOAT NOT NULL,
+        max_kh FLOAT NOT NULL,
+        last_kh FLOAT NOT NULL,
+        updatedAt TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
+        PRIMARY KEY (deviceId, tier, bucket_start)
+      ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci
+    `);
+    console.log('[DB] Tabela measurement_rollups verificada/criada');
+  } catch (err) {
+    console.error('[DB] Erro ao criar tabela measurement_rollups:', err);
+    throw err;
+  } finally {
+    conn.release();
+  }
+}
+
 async function ensureTestModeColumn() {
   const conn = await pool.getConnection();
   try {
@@ -5422,6 +5967,25 @@ async function ensureDosingNotifyColumns() {
   }
 }
 
+async function ensureHealthHeapColumns() {
+  const conn = await pool.getConnection();
+  try {
+    await conn.query(`
+      ALTER TABLE device_health
+      ADD COLUMN IF NOT EXISTS heap_free int(11) DEFAULT NULL,
+      ADD COLUMN IF NOT EXISTS heap_min_free int(11) DEFAULT NULL,
+      ADD COLUMN IF NOT EXISTS heap_largest_block int(11) DEFAULT NULL
+    `);
+    console.log('[DB] Colunas de heap em device_health verificadas');
+  } catch (err) {
+    if (!err.message.includes('Duplicate column')) {
+      console.error('[DB] Erro ao adicionar colunas de heap:', err.message);
+    }
+  } finally {
+    conn.release();
+  }
+}
+
 async function startServer() {
   try {
 
@@ -5443,6 +6007,12 @@ async function startServer() {
     // 4) Garantir colunas notificação em dosing_schedules
     await ensureDosingNotifyColumns();
 
+    // 5) Garantir colunas de fragmentação do heap em device_health
+    await ensureHealthHeapColumns();
+
+    // 6) Rollups de KH (hora/dia/semana) vindos do device
+    await ensureMeasurementRollupsTable();
+
     // 2) Iniciar servidor HTTP
     app.listen(PORT, () => {
       console.log(`
@@ -5476,6 +6046,9 @@ async function startServer() {
 
 [ENDPOINTS] Display:
   POST   /api/display/ping
+  GET    /api/v1/user/devices/:deviceId/display/kh-summary
+  GET    /api/v1/user/devices/:deviceId/display/kh-history
+  GET    /api/v1/user/display/kh-summary/stream
 
 [ENDPOINTS] Dev:
   GET    /api/v1/dev/server-health
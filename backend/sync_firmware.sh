@@ -28,6 +28,10 @@ echo "Sincronizando $SRC_DIR -> $LOCAL_DIR"
 mkdir -p "$LOCAL_DIR"
 rsync -av --delete "$SRC_DIR"/ "$LOCAL_DIR"/
 
+# Patches delta (OTA incremental) de cada versão anterior para a mais nova
+echo "Gerando patches delta..."
+"$(dirname "$LOCAL_DIR")/fwdelta/gen_patches.sh" "$LOCAL_DIR" || echo "Aviso: falha gerando patches delta (devices usam a imagem completa)"
+
 echo
 echo "Conteúdo final de $LOCAL_DIR:"
 find "$LOCAL_DIR" -maxdepth 3 -type f -ls
@@ -0,0 +1,66 @@
+// bench_core.cpp - custo de addMeasurement/getPrediction no host
+//
+// Compara o histórico em RingBuffer (KHPredictor do core) com o modelo
+// antigo (std::vector + erase(begin()) a cada medição com o histórico
+// cheio). Para números de verdade: -DRBS_SANITIZE=OFF.
+//
+// Uso: ./bench_core [iterações]   (padrão 200000; ctest roda com 200)
+
+#include <ReefBlueSkyCore.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double nsPer(Clock::time_point t0, long n) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / n;
+}
+
+// Histórico como era no firmware (vector + erase do mais antigo)
+struct VectorHistory {
+  std::vector<KHPredictor::DataPoint> v;
+  VectorHistory() { v.reserve(100); }
+  void push(const KHPredictor::DataPoint& p) {
+    v.push_back(p);
+    if (v.size() > 100) v.erase(v.begin());
+  }
+};
+
+int main(int argc, char** argv) {
+  long iters = argc > 1 ? atol(argv[1]) : 200000;
+  if (iters < 1) iters = 1;
+  rbsSetLogSink(nullptr);
+
+  KHPredictor p;
+  Clock::time_point t0 = Clock::now();
+  for (long i = 0; i < iters; i++) {
+    p.addMeasurement(8.0f + (i % 7) * 0.01f, uint64_t(i) * 3600000ULL, 25.0f);
+  }
+  double addNs = nsPer(t0, iters);
+
+  VectorHistory vh;
+  RingBuffer<KHPredictor::DataPoint, 100> rb;
+  t0 = Clock::now();
+  for (long i = 0; i < iters; i++) vh.push({ 8.0f, uint64_t(i), 25.0f });
+  double vecNs = nsPer(t0, iters);
+  t0 = Clock::now();
+  for (long i = 0; i < iters; i++) rb.push({ 8.0f, uint64_t(i), 25.0f });
+  double ringNs = nsPer(t0, iters);
+
+  long predIters = iters / 10 > 0 ? iters / 10 : 1;
+  volatile float sink = 0;
+  t0 = Clock::now();
+  for (long i = 0; i < predIters; i++) sink = sink + p.getPrediction(4).predicted_kh;
+  double predNs = nsPer(t0, predIters);
+
+  printf("addMeasurement   %8.1f ns\n", addNs);
+  printf("push vector      %8.1f ns\n", vecNs);
+  printf("push RingBuffer  %8.1f ns\n", ringNs);
+  printf("getPrediction    %8.1f ns (histórico com %d pontos)\n", predNs, p.getDataCount());
+
+  // Sanidade: o resultado do benchmark tem de ser válido
+  return (p.getDataCount() == 100 && vh.v.size() == rb.size() &&
+          vh.v.back().timestamp == rb.back().timestamp) ? 0 : 1;
+}
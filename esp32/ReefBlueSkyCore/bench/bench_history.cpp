@@ -0,0 +1,176 @@
+// bench_history.cpp - consultas por período no histórico de medições (MeasurementHistory)
+//
+// Compara o MeasurementHistory antigo (std::vector + erase(begin()),
+// getFilteredMeasurements copiando tudo que passa no filtro e getStatistics
+// copiando de novo os KH para outro vector) com o atual (RingBuffer +
+// TimeRange: duas buscas binárias e iteração sem cópia), com 1000 e 10000
+// medições (uma a cada 10 min). Para números de verdade: -DRBS_SANITIZE=OFF.
+//
+// Uso: ./bench_history [iterações]   (padrão 2000; ctest roda com 5)
+
+#include <ReefBlueSkyCore.h>
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double nsPer(Clock::time_point t0, long n) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / n;
+}
+
+typedef MeasurementHistory::Measurement Measurement;
+
+struct Stats {
+  int   count;
+  float mean;
+  float stdDev;
+  float min;
+  float max;
+};
+
+static const uint64_t STEP_MS = 10ULL * 60ULL * 1000ULL;
+static const uint64_t DAY_MS  = 24ULL * 3600ULL * 1000ULL;
+static const uint64_t T0_MS   = 1704067200000ULL;
+
+static Measurement sample(long i) {
+  return { 8.0f + 0.2f * sinf(i * 0.05f), 8.2f, 8.0f, 25.0f, T0_MS + uint64_t(i) * STEP_MS, (i % 50) != 0 };
+}
+
+// ---- Modelo antigo ----------------------------------------------------------
+
+struct VectorHistory {
+  std::vector<Measurement> v;
+  size_t cap;
+
+  void add(const Measurement& m) {
+    if (v.size() >= cap) v.erase(v.begin());
+    v.push_back(m);
+  }
+
+  std::vector<Measurement> filtered(uint64_t from, uint64_t to) const {
+    std::vector<Measurement> out;
+    for (const auto& m : v) {
+      if (m.timestamp >= from && m.timestamp < to) out.push_back(m);
+    }
+    return out;
+  }
+
+  Stats stats(uint64_t from, uint64_t to) const {
+    auto f = filtered(from, to);
+    std::vector<float> kh;
+    for (const auto& m : f) if (m.is_valid) kh.push_back(m.kh);
+    Stats s = { (int)kh.size(), 0, 0, 0, 0 };
+    if (kh.empty()) return s;
+    float sum = 0;
+    for (float k : kh) sum += k;
+    s.mean = sum / kh.size();
+    float var = 0;
+    for (float k : kh) var += powf(k - s.mean, 2);
+    s.stdDev = sqrtf(var / kh.size());
+    s.min = *std::min_element(kh.begin(), kh.end());
+    s.max = *std::max_element(kh.begin(), kh.end());
+    return s;
+  }
+};
+
+// ---- Modelo atual -----------------------------------------------------------
+
+template <size_t N>
+struct RingHistory {
+  typedef TimeRange<Measurement, N, &Measurement::timestamp> Range;
+  RingBuffer<Measurement, N> ring;
+
+  Range range(uint64_t from, uint64_t to) const { return Range(ring, from, to, true); }
+
+  Stats stats(uint64_t from, uint64_t to) const {
+    Stats s = { 0, 0, 0, 0, 0 };
+    float m2 = 0;
+    for (const Measurement& m : range(from, to)) {
+      if (!m.is_valid) continue;
+      s.count++;
+      if (s.count == 1) s.min = s.max = m.kh;
+      float d = m.kh - s.mean;
+      s.mean += d / s.count;
+      m2 += d * (m.kh - s.mean);
+      if (m.kh < s.min) s.min = m.kh;
+      if (m.kh > s.max) s.max = m.kh;
+    }
+    s.stdDev = s.count ? sqrtf(m2 / s.count) : 0;
+    return s;
+  }
+};
+
+static bool same(const Stats& a, const Stats& b) {
+  return a.count == b.count && fabsf(a.mean - b.mean) < 1e-4f &&
+         fabsf(a.stdDev - b.stdDev) < 1e-3f && a.min == b.min && a.max == b.max;
+}
+
+template <size_t N>
+static bool run(long iters) {
+  VectorHistory vh;
+  vh.cap = N;
+  static RingHistory<N> rh;   // 32 B por medição: fora da pilha
+
+  for (long i = 0; i < long(N); i++) {
+    Measurement m = sample(i);
+    vh.add(m);
+    rh.ring.push(m);
+  }
+  uint64_t now = rh.ring.back().timestamp + 1;
+
+  // Inserir com o histórico cheio
+  long addIters = iters * 10;
+  Clock::time_point t0 = Clock::now();
+  for (long i = 0; i < addIters; i++) vh.add(sample(N + i));
+  double addVecNs = nsPer(t0, addIters);
+  t0 = Clock::now();
+  for (long i = 0; i < addIters; i++) rh.ring.push(sample(N + i));
+  double addRingNs = nsPer(t0, addIters);
+  now = rh.ring.back().timestamp + 1;
+
+  // getStatistics(últimas 24 h)
+  volatile float sink = 0;
+  Stats a = {}, b = {};
+  t0 = Clock::now();
+  for (long i = 0; i < iters; i++) { a = vh.stats(now - DAY_MS, now); sink = sink + a.mean; }
+  double statsVecNs = nsPer(t0, iters);
+  t0 = Clock::now();
+  for (long i = 0; i < iters; i++) { b = rh.stats(now - DAY_MS, now); sink = sink + b.mean; }
+  double statsRingNs = nsPer(t0, iters);
+
+  // Período arbitrário [from, to) no meio do histórico: 2 dias
+  uint64_t from = rh.ring[N / 3].timestamp, to = from + 2 * DAY_MS;
+  size_t nVec = 0, nRing = 0;
+  t0 = Clock::now();
+  for (long i = 0; i < iters; i++) nVec = vh.filtered(from, to).size();
+  double rangeVecNs = nsPer(t0, iters);
+  t0 = Clock::now();
+  for (long i = 0; i < iters; i++) {
+    size_t n = 0;
+    for (const Measurement& m : rh.range(from, to)) { n++; sink = sink + m.kh; }
+    nRing = n;
+  }
+  double rangeRingNs = nsPer(t0, iters);
+
+  printf("%5zu medições  (24 h = %d válidas, período = %zu)\n", N, b.count, nRing);
+  printf("  add (cheio)        vector %9.1f ns   anel %9.1f ns\n", addVecNs, addRingNs);
+  printf("  estatísticas 24 h  vector %9.1f ns   anel %9.1f ns\n", statsVecNs, statsRingNs);
+  printf("  período 2 dias     vector %9.1f ns   anel %9.1f ns\n", rangeVecNs, rangeRingNs);
+
+  return same(a, b) && nVec == nRing && nRing == size_t(2 * DAY_MS / STEP_MS) &&
+         vh.v.back().timestamp == rh.ring.back().timestamp;
+}
+
+int main(int argc, char** argv) {
+  long iters = argc > 1 ? atol(argv[1]) : 2000;
+  if (iters < 1) iters = 1;
+  rbsSetLogSink(nullptr);
+
+  bool ok = run<1000>(iters);
+  ok = run<10000>(iters) && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+// BenchEstimators.ino - OLS x Theil-Sen x Huber no ESP32
+//
+// Mesmo cenário do bench/bench_estimators.cpp (100 medições de hora em
+// hora, -0,01 dKH/h, ruído de 0,03 dKH, 5% de bolhas de 0,5 a 1,5 dKH):
+// tempo por ajuste em micros() e erro da inclinação de cada método.
+// Resultado no monitor serial (115200).
+
+#include <ReefBlueSkyCore.h>
+
+static const int   N      = 100;
+static const int   SERIES = 50;
+static const float SLOPE  = -0.01f;
+
+static const FitMethod METHODS[3] = { FIT_OLS, FIT_THEIL_SEN, FIT_HUBER };
+static const char*     NAMES[3]   = { "OLS", "Theil-Sen", "Huber" };
+
+static float gauss() {
+  float u1 = (esp_random() >> 8) * (1.0f / 16777216.0f) + 1e-7f;
+  float u2 = (esp_random() >> 8) * (1.0f / 16777216.0f);
+  return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+static void series(float* x, float* y) {
+  for (int i = 0; i < N; i++) {
+    x[i] = float(i);
+    y[i] = 8.0f + SLOPE * i + 0.03f * gauss();
+    if (esp_random() % 100 < 5) {
+      float e = 0.5f + (esp_random() % 1000) / 1000.0f;
+      y[i] += (esp_random() & 1) ? e : -e;
+    }
+  }
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+
+  static float x[N], y[N];
+  uint32_t us[3] = { 0, 0, 0 };
+  float err[3] = { 0, 0, 0 };
+
+  for (int s = 0; s < SERIES; s++) {
+    series(x, y);
+    for (int m = 0; m < 3; m++) {
+      LineFit f;
+      uint32_t t0 = micros();
+      fitLine(METHODS[m], x, y, N, f);
+      us[m] += micros() - t0;
+      err[m] += fabsf(f.slope - SLOPE);
+    }
+    yield();
+  }
+
+  Serial.printf("ReefBlueSkyCore %s - %d séries de %d pontos, %u MHz\n",
+                RBS_CORE_VERSION, SERIES, N, (unsigned)getCpuFrequencyMhz());
+  for (int m = 0; m < 3; m++) {
+    Serial.printf("  %-10s %8.1f us/ajuste   erro inclinação %.5f dKH/h\n",
+                  NAMES[m], float(us[m]) / SERIES, err[m] / SERIES);
+  }
+  Serial.printf("  pilha livre: %u bytes\n", (unsigned)uxTaskGetStackHighWaterMark(nullptr));
+}
+
+void loop() {
+}
@@ -0,0 +1,260 @@
+#include "KH_DoseController.h"
+#include "rbs_hal.h"
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+static const float MS_PER_DAY = 86400000.0f;
+static const uint8_t JUMPS_TO_ACCEPT = 3;   // saltos seguidos = nível novo (TPA, reposição)
+
+static inline float clampf(float v, float lo, float hi) {
+    return std::min(std::max(v, lo), hi);
+}
+
+KHDoseController::KHDoseController() {
+}
+
+void KHDoseController::begin(const Config& cfg, float currentDailyMl) {
+    _cfg = cfg;
+    _dailyMl = clampf(currentDailyMl, cfg.minDailyMl, cfg.maxDailyMl);
+    _integral = 0;
+
+    // Ponto de partida: tanque em regime com o volume atual (consumo = g·u)
+    float g0 = cfg.gainPriorKhPerMl;
+    float c0 = g0 * _dailyMl;
+    _theta[0] = g0;
+    _theta[1] = c0;
+    _P0[0] = (0.5f * g0) * (0.5f * g0);
+    _P0[1] = (0.5f * c0 + 0.2f) * (0.5f * c0 + 0.2f);
+    _P[0][0] = _P0[0];
+    _P[1][1] = _P0[1];
+    _P[0][1] = _P[1][0] = 0;
+
+    _hasKh = false;
+    _khFilt = _khLast = 0;
+    _lastMeasTs = 0;
+    _doseSinceMeas = 0;
+    _jumpCount = 0;
+    _rejected = 0;
+    _khSum = 0;
+    _khCount = 0;
+    _lastUpdateTs = 0;
+    _updated = false;
+    _cut = false;
+    _preCutMl = 0;
+    _shareCount = 0;
+
+    rbsLog("[KH_DoseCtl] Iniciado: alvo %.2f dKH, %.1f mL/dia, g0=%.4f dKH/mL",
+           cfg.setpointKh, _dailyMl, g0);
+}
+
+void KHDoseController::addDose(uint64_t timestamp, float volumeMl) {
+    (void)timestamp;
+    if (_hasKh && volumeMl > 0) {
+        _doseSinceMeas += volumeMl;
+    }
+}
+
+bool KHDoseController::addMeasurement(uint64_t timestamp, float kh) {
+    if (!_hasKh) {
+        _hasKh = true;
+        _khFilt = _khLast = kh;
+        _lastMeasTs = timestamp;
+        _doseSinceMeas = 0;
+        accumulate();
+        return true;
+    }
+    if (timestamp <= _lastMeasTs) return false;
+
+    float dtDays = float(timestamp - _lastMeasTs) / MS_PER_DAY;
+    float g = _theta[0];
+    float c = _theta[1];
+
+    // Previsão do modelo a partir do estado filtrado
+    float predicted = _khFilt + g * _doseSinceMeas - c * dtDays;
+
+    if (fabsf(kh - predicted) > _cfg.maxKhJump) {
+        _rejected++;
+        if (++_jumpCount < JUMPS_TO_ACCEPT) {
+            rbsLog("[KH_DoseCtl] Medição %.2f descartada (previsto %.2f)", kh, predicted);
+            return false;
+        }
+        // Nível mudou de verdade: recomeça o filtro, sem estimar neste intervalo
+        rbsLog("[KH_DoseCtl] %u saltos seguidos: aceitando novo nível %.2f dKH", JUMPS_TO_ACCEPT, kh);
+        _khFilt = _khLast = kh;
+        _lastMeasTs = timestamp;
+        _doseSinceMeas = 0;
+        _jumpCount = 0;
+        _khSum = 0;
+        _khCount = 0;
+        accumulate();
+        return true;
+    }
+    _jumpCount = 0;
+
+    estimate(_doseSinceMeas, dtDays, kh - _khLast);
+
+    // Preditor-corretor: segue doses/consumo sem o atraso de uma média.
+    // Peso da medição 0,3 a cada 2 h; quanto mais longa a previsão (monitor
+    // fora do ar), mais a medição manda
+    float alpha = 1.0f - powf(0.7f, dtDays * 12.0f);
+    _khFilt = predicted + alpha * (kh - predicted);
+    _khLast = kh;
+    _lastMeasTs = timestamp;
+    _doseSinceMeas = 0;
+    accumulate();
+    return true;
+}
+
+void KHDoseController::accumulate() {
+    _khSum += _khFilt;
+    _khCount++;
+}
+
+// RLS com esquecimento sobre ΔKH = g·D − c·Δt
+void KHDoseController::estimate(float doseMl, float dtDays, float dKh) {
+    if (dtDays <= 0) return;
+
+    float phi[2] = {doseMl, -dtDays};
+    float Pphi[2] = {
+        _P[0][0] * phi[0] + _P[0][1] * phi[1],
+        _P[1][0] * phi[0] + _P[1][1] * phi[1],
+    };
+    float lambda = _cfg.forgetting;
+    float denom = lambda + phi[0] * Pphi[0] + phi[1] * Pphi[1];
+    float K[2] = {Pphi[0] / denom, Pphi[1] / denom};
+    float err = dKh - (phi[0] * _theta[0] + phi[1] * _theta[1]);
+
+    _theta[0] += K[0] * err;
+    _theta[1] += K[1] * err;
+
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            _P[i][j] = (_P[i][j] - K[i] * Pphi[j]) / lambda;
+        }
+    }
+    // Sem excitação o esquecimento infla P (windup do estimador): limita
+    // à incerteza inicial
+    float s = std::max(_P[0][0] / _P0[0], _P[1][1] / _P0[1]);
+    if (s > 1.0f) {
+        for (int i = 0; i < 2; i++) {
+            for (int j = 0; j < 2; j++) _P[i][j] /= s;
+        }
+    }
+
+    _theta[0] = clampGain(_theta[0]);
+    _theta[1] = clampf(_theta[1], 0.0f, _theta[0] * _cfg.maxDailyMl * 2.0f);
+}
+
+float KHDoseController::clampGain(float g) const {
+    return clampf(g, _cfg.gainPriorKhPerMl * _cfg.gainMinFrac,
+                  _cfg.gainPriorKhPerMl * _cfg.gainMaxFrac);
+}
+
+KHDoseController::Output KHDoseController::update(uint64_t now, const ScheduleVolume* current, uint8_t n) {
+    Output out = {};
+    n = std::min<uint8_t>(n, MAX_SCHEDULES);
+    out.count = n;
+    for (uint8_t i = 0; i < n; i++) out.schedules[i] = current[i];
+    out.dailyMl = _dailyMl;
+    out.filteredKh = _khFilt;
+    out.gainKhPerMl = _theta[0];
+    out.consumptionKhPerDay = _theta[1];
+
+    if (!_hasKh) {
+        snprintf(out.reason, sizeof(out.reason), "Sem medição de KH; volume mantido");
+        return out;
+    }
+    float staleH = float(now - _lastMeasTs) / 3600000.0f;
+    if (now < _lastMeasTs || staleH > _cfg.staleHours) {
+        snprintf(out.reason, sizeof(out.reason), "Sem medição há %.0f h; volume mantido", staleH);
+        return out;
+    }
+    out.valid = true;
+
+    // Entrada e saída do corte por KH alto não esperam o intervalo. Sai
+    // do corte no meio do caminho até o alvo (histerese)
+    bool  high = _khFilt >= _cfg.khHigh;
+    bool  resume = _cut && _khFilt <= 0.5f * (_cfg.setpointKh + _cfg.khHigh);
+    float intervalMs = _cfg.updateIntervalH * 3600000.0f;
+    if (_updated && !(high && !_cut) && !resume && float(now - _lastUpdateTs) < intervalMs) {
+        snprintf(out.reason, sizeof(out.reason), "Aguardando intervalo de atualização");
+        return out;
+    }
+    float dtDays = _updated ? float(now - _lastUpdateTs) / MS_PER_DAY : _cfg.updateIntervalH / 24.0f;
+    dtDays = std::min(dtDays, _cfg.updateIntervalH / 24.0f);   // volta de falha: não integra o buraco
+
+    // Erro sobre a média desde a última atualização: o KH oscila no dia
+    // (consumo com luz, doses concentradas) e uma leitura isolada pega só
+    // uma fase da oscilação
+    float khMean = _khCount ? _khSum / _khCount : _khFilt;
+    _khSum = 0;
+    _khCount = 0;
+
+    float g = _theta[0];
+    float c = _theta[1];
+    float e = _cfg.setpointKh - khMean;
+
+    float u;
+    if (high || (_cut && !resume)) {
+        // Envelope: corta na hora (ignora limite de variação), integral congelada
+        if (!_cut) {
+            _cut = true;
+            _preCutMl = _dailyMl;
+        }
+        u = _cfg.minDailyMl;
+    } else {
+        float dI = e * dtDays / (g * _cfg.closedLoopDays * _cfg.integralDays);
+        _integral += dI;
+        float uff  = c / g;
+        float uRaw = uff + e / (g * _cfg.closedLoopDays) + _integral;
+
+        // Anti-windup (back-calculation) na saturação de volume: a integral
+        // acompanha o que a bomba consegue dar
+        float uSat = clampf(uRaw, _cfg.minDailyMl, _cfg.maxDailyMl);
+        _integral += uSat - uRaw;
+
+        if (resume) {
+            // Volta do corte direto ao calculado, sem passar do volume de
+            // antes do corte (que levou o KH para cima)
+            _cut = false;
+            u = std::min(uSat, _preCutMl);
+        } else {
+            float step = std::max(_cfg.maxStepFrac * _dailyMl, _cfg.maxStepMl);
+            u = clampf(uSat, _dailyMl - step, _dailyMl + step);
+        }
+
+        // Integração condicional: rampa presa no limite não acumula
+        if (u != uSat && (uSat - u) * e > 0) {
+            _integral -= dI;
+        }
+    }
+
+    // Divide mantendo a proporção entre as agendas (a última conhecida se
+    // o corte zerou todas)
+    float sum = 0;
+    for (uint8_t i = 0; i < n; i++) sum += std::max(current[i].volumePerDayMl, 0.0f);
+    if (sum > 0) {
+        for (uint8_t i = 0; i < n; i++) _share[i] = std::max(current[i].volumePerDayMl, 0.0f) / sum;
+        _shareCount = n;
+    } else if (_shareCount != n) {
+        for (uint8_t i = 0; i < n; i++) _share[i] = 1.0f / n;
+        _shareCount = n;
+    }
+    for (uint8_t i = 0; i < n; i++) {
+        float v = roundf(u * _share[i] * 100.0f) / 100.0f;
+        out.schedules[i].volumePerDayMl = v;
+        if (fabsf(v - current[i].volumePerDayMl) >= 0.005f) out.changed = true;
+    }
+
+    _dailyMl = u;
+    _lastUpdateTs = now;
+    _updated = true;
+
+    out.dailyMl = u;
+    snprintf(out.reason, sizeof(out.reason), "%sKH %.2f (alvo %.2f): %.1f mL/dia, g=%.4f, consumo %.2f dKH/dia",
+             _cut ? "KH ALTO, dose mínima. " : _khFilt <= _cfg.khLow ? "KH BAIXO. " : "",
+             khMean, _cfg.setpointKh, u, g, c);
+    rbsLog("[KH_DoseCtl] %s", out.reason);
+    return out;
+}
@@ -0,0 +1,141 @@
+#ifndef KH_DOSE_CONTROLLER_H
+#define KH_DOSE_CONTROLLER_H
+
+#include <stdint.h>
+
+/**
+ * @class KHDoseController
+ * @brief Malha fechada KH -> volume diário das agendas de alcalinidade
+ *
+ * O KHPredictor só devolve um percentual (erro × 10 ± tendência) que nada
+ * aplica. Aqui o volume diário (mL/dia) é calculado e distribuído pelas
+ * agendas da bomba de KH:
+ *
+ *   planta:   ΔKH = g·D − c·Δt     (g = dKH por mL, c = consumo dKH/dia,
+ *                                    D = mL dosados entre duas medições)
+ *   estimador: mínimos quadrados recursivos (RLS) com esquecimento sobre
+ *              cada intervalo entre medições; g e c partem do valor a priori
+ *              e ficam presos a [gainMinFrac, gainMaxFrac] × prior
+ *   controle: u = c/g (feedforward) + e/(g·closedLoopDays) + I, com e
+ *             sobre a média do KH desde a última atualização; I com
+ *             back-calculation (anti-windup) quando u satura
+ *   segurança: limites de volume, variação máxima por atualização, KH
+ *              acima de khHigh corta para o mínimo, medição fora da curva é
+ *              descartada, sem medição recente segura o volume atual
+ *
+ * Sem alocação e sem hardware: o mesmo código roda no firmware e na
+ * simulação de host (test/sim_dose_controller.cpp, meses de tanque virtual).
+ * Só deve comandar bombas de verdade depois de passar na simulação com os
+ * parâmetros do aquário.
+ */
+class KHDoseController {
+public:
+    static constexpr int MAX_SCHEDULES = 8;
+
+    struct Config {
+        float setpointKh       = 8.0f;
+        float gainPriorKhPerMl = 0.01f;  // dKH por mL (concentração / volume do aquário)
+        float minDailyMl       = 0.0f;
+        float maxDailyMl       = 100.0f; // max_daily_ml da bomba
+        float maxStepFrac      = 0.15f;  // variação máxima por atualização...
+        float maxStepMl        = 2.0f;   // ...ou isto, o que for maior
+        float updateIntervalH  = 24.0f;  // no máximo uma atualização a cada N h
+        float closedLoopDays   = 3.0f;   // dias para corrigir o erro (termo P)
+        float integralDays     = 4.0f;   // tempo integral Ti (dias)
+        float khLow            = 6.5f;   // envelope: fora dele o motivo vira alerta
+        float khHigh           = 10.0f;  // acima: volume mínimo até voltar a meio caminho do alvo
+        float maxKhJump        = 0.8f;   // salto maior que isso vs filtrado = outlier
+        float staleHours       = 12.0f;  // sem medição aceita há N h: segura
+        float gainMinFrac      = 0.25f;  // g estimado em [min, max] × prior
+        float gainMaxFrac      = 4.0f;
+        float forgetting       = 0.995f; // RLS (~200 medições de memória)
+    };
+
+    struct ScheduleVolume {
+        uint32_t scheduleId;
+        float    volumePerDayMl;
+    };
+
+    struct Output {
+        bool     valid;              // false = segurar o volume atual
+        bool     changed;            // algum volume de agenda mudou
+        float    dailyMl;
+        float    filteredKh;
+        float    gainKhPerMl;
+        float    consumptionKhPerDay;
+        uint8_t  count;
+        ScheduleVolume schedules[MAX_SCHEDULES];
+        char     reason[112];
+    };
+
+    KHDoseController();
+
+    /**
+     * Reinicia o controlador
+     * @param cfg Parâmetros (setpoint, ganho a priori, limites)
+     * @param currentDailyMl Volume diário em uso hoje (ponto de partida)
+     */
+    void begin(const Config& cfg, float currentDailyMl);
+
+    /**
+     * Registrar dose executada (log da dosadora)
+     * @param timestamp ms
+     * @param volumeMl mL dosados
+     */
+    void addDose(uint64_t timestamp, float volumeMl);
+
+    /**
+     * Registrar medição de KH
+     * @return false se descartada como outlier
+     */
+    bool addMeasurement(uint64_t timestamp, float kh);
+
+    /**
+     * Calcular volumes das agendas
+     * @param now ms
+     * @param current Agendas da bomba de KH com o volume atual de cada uma
+     *        (a divisão entre elas é mantida)
+     * @param n Número de agendas (até MAX_SCHEDULES)
+     */
+    Output update(uint64_t now, const ScheduleVolume* current, uint8_t n);
+
+    float getDailyMl() const { return _dailyMl; }
+    float getGain() const { return _theta[0]; }
+    float getConsumption() const { return _theta[1]; }
+    float getFilteredKh() const { return _khFilt; }
+    uint32_t getRejected() const { return _rejected; }
+
+private:
+    void  estimate(float doseMl, float dtDays, float dKh);
+    void  accumulate();
+    float clampGain(float g) const;
+
+    Config   _cfg;
+    float    _dailyMl = 0;
+    float    _integral = 0;       // mL/dia
+
+    // Estimador: theta = [g, c], P = covariância
+    float    _theta[2] = {0, 0};
+    float    _P[2][2] = {{0, 0}, {0, 0}};
+    float    _P0[2] = {0, 0};
+
+    bool     _hasKh = false;
+    float    _khFilt = 0;
+    float    _khLast = 0;         // última medição aceita (sem filtro)
+    uint64_t _lastMeasTs = 0;
+    float    _doseSinceMeas = 0;  // mL desde a última medição aceita
+    float    _khSum = 0;          // filtrado acumulado desde a última atualização
+    uint32_t _khCount = 0;
+    uint8_t  _jumpCount = 0;      // outliers seguidos
+    uint32_t _rejected = 0;
+
+    uint64_t _lastUpdateTs = 0;
+    bool     _updated = false;
+    bool     _cut = false;          // corte por KH alto ativo
+    float    _preCutMl = 0;
+
+    float    _share[MAX_SCHEDULES] = {};   // proporção de cada agenda
+    uint8_t  _shareCount = 0;
+};
+
+#endif // KH_DOSE_CONTROLLER_H
@@ -0,0 +1,128 @@
+#include "KH_Kalman.h"
+#include "rbs_hal.h"
+#include <cmath>
+
+static const float MS_PER_DAY = 86400000.0f;
+static const float MIN_VAR    = 1e-8f;
+
+// P ← F·P·Fᵀ + Q com F = [[1, −dt], [0, 1]] e Q do passeio aleatório
+// contínuo (KH: khWalk², consumo: rateWalk² integrado no KH)
+static void propagateCov(const float in[2][2], float out[2][2], float dt, float qKh, float qRate) {
+    float p00 = in[0][0] - 2.0f * dt * in[0][1] + dt * dt * in[1][1];
+    float p01 = in[0][1] - dt * in[1][1];
+    out[0][0] = p00 + qKh * dt + qRate * dt * dt * dt / 3.0f;
+    out[0][1] = out[1][0] = p01 - qRate * dt * dt / 2.0f;
+    out[1][1] = in[1][1] + qRate * dt;
+}
+
+KHKalman::KHKalman() {
+}
+
+void KHKalman::begin(const Config& cfg) {
+    _cfg = cfg;
+    reset();
+}
+
+void KHKalman::reset() {
+    _ready = false;
+    _x[0] = _x[1] = 0;
+    _P[0][0] = _P[0][1] = _P[1][0] = _P[1][1] = 0;
+    _t = 0;
+    _doseRate = 0;
+    _rateMean = 0;
+    _jumpCount = 0;
+    _rejected = 0;
+}
+
+void KHKalman::propagate(uint64_t timestamp) {
+    // Evento fora de ordem (log de dose atrasado): aplica no instante atual
+    if (timestamp <= _t) return;
+    float dt = float(timestamp - _t) / MS_PER_DAY;
+    _t = timestamp;
+
+    if (_cfg.averageDays > 0) {
+        float decay = expf(-dt / _cfg.averageDays);
+        _doseRate *= decay;
+        _rateMean += (1.0f - decay) * (_x[1] - _rateMean);
+    }
+
+    _x[0] -= _x[1] * dt;
+    float p[2][2] = {{_P[0][0], _P[0][1]}, {_P[1][0], _P[1][1]}};
+    propagateCov(p, _P, dt, _cfg.khWalk * _cfg.khWalk, _cfg.rateWalk * _cfg.rateWalk);
+}
+
+bool KHKalman::addMeasurement(uint64_t timestamp, float kh) {
+    float r = _cfg.measNoiseKh * _cfg.measNoiseKh;
+
+    if (!_ready) {
+        _ready = true;
+        _t = timestamp;
+        _x[0] = kh;
+        _x[1] = _cfg.initRate;
+        _P[0][0] = r;
+        _P[1][1] = _cfg.initRateStd * _cfg.initRateStd;
+        _P[0][1] = _P[1][0] = 0;
+        _rateMean = _cfg.initRate;
+        return true;
+    }
+
+    propagate(timestamp);
+
+    float s = _P[0][0] + r;
+    float innov = kh - _x[0];
+    if (innov * innov > _cfg.gate * _cfg.gate * s) {
+        _rejected++;
+        if (++_jumpCount < JUMPS_TO_ACCEPT) {
+            rbsLog("[KH_Kalman] Medição %.2f descartada (previsto %.2f)", kh, _x[0]);
+            return false;
+        }
+        // Nível mudou de verdade: KH recomeça na medição, consumo mantido
+        rbsLog("[KH_Kalman] %u saltos seguidos: aceitando novo nível %.2f dKH", JUMPS_TO_ACCEPT, kh);
+        _x[0] = kh;
+        _P[0][0] = r;
+        _P[0][1] = _P[1][0] = 0;
+        _jumpCount = 0;
+        return true;
+    }
+    _jumpCount = 0;
+
+    // H = [1, 0]: K = P·Hᵀ/S
+    float k0 = _P[0][0] / s;
+    float k1 = _P[1][0] / s;
+    _x[0] += k0 * innov;
+    _x[1] += k1 * innov;
+
+    // P ← (I − K·H)·P, mantendo simétrica e positiva em float
+    float p00 = (1.0f - k0) * _P[0][0];
+    float p01 = (1.0f - k0) * _P[0][1];
+    float p11 = _P[1][1] - k1 * _P[0][1];
+    _P[0][0] = p00 > MIN_VAR ? p00 : MIN_VAR;
+    _P[1][1] = p11 > MIN_VAR ? p11 : MIN_VAR;
+    _P[0][1] = _P[1][0] = p01;
+    return true;
+}
+
+void KHKalman::addDose(uint64_t timestamp, float khDosed) {
+    if (!_ready || !(khDosed > 0)) return;
+    propagate(timestamp);
+
+    _x[0] += khDosed;
+    float sd = _cfg.doseNoiseFrac * khDosed;
+    _P[0][0] += sd * sd;
+
+    if (_cfg.averageDays > 0) _doseRate += khDosed / _cfg.averageDays;
+}
+
+KHKalman::Estimate KHKalman::estimate() const {
+    Estimate e = {_x[0], sqrtf(_P[0][0]), _x[1], sqrtf(_P[1][1])};
+    return e;
+}
+
+KHKalman::Estimate KHKalman::predict(float hoursAhead, float doseKhPerDay) const {
+    float dt = hoursAhead > 0 ? hoursAhead / 24.0f : 0.0f;
+    float p[2][2];
+    propagateCov(_P, p, dt, _cfg.khWalk * _cfg.khWalk, _cfg.rateWalk * _cfg.rateWalk);
+
+    Estimate e = {_x[0] + (doseKhPerDay - _x[1]) * dt, sqrtf(p[0][0]), _x[1], sqrtf(p[1][1])};
+    return e;
+}
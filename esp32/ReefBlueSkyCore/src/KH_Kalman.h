@@ -0,0 +1,121 @@
+#ifndef KH_KALMAN_H
+#define KH_KALMAN_H
+
+#include <stdint.h>
+
+/**
+ * @class KHKalman
+ * @brief Filtro de Kalman do KH do aquário com as doses como entrada
+ *
+ * A reta do KHPredictor não sabe das doses: uma correção de +0,5 dKH parece
+ * tendência de alta por dias. Aqui o KH é um estado movido por entradas
+ * conhecidas:
+ *
+ *   estado:   x = [KH (dKH), c = consumo (dKH/dia)]
+ *   modelo:   KH' = KH − c·Δt + d     c' = c (passeio aleatório)
+ *   entrada:  d = alcalinidade dosada em dKH (mL × dKH/mL, quem chama
+ *             converte: agendas da dosadora, khcorrection da bomba 4)
+ *   medição:  z = KH + ruído (σ = measNoiseKh)
+ *
+ * Cada medição e cada dose custa O(1): propaga até o instante do evento e
+ * aplica a dose (KH += d, incerteza proporcional) ou a correção de Kalman.
+ * Medição a mais de gate·σ da previsão é descartada; JUMPS_TO_ACCEPT
+ * seguidas viram nível novo (TPA, reposição), como no KHDoseController.
+ *
+ * Dose que o monitor não vê entra no consumo estimado (c vira consumo
+ * líquido), então a previsão continua certa; só a leitura de "consumo"
+ * muda de sentido.
+ *
+ * float32, 2×2, sem heap: cabe no loop do firmware e roda igual no host.
+ */
+class KHKalman {
+public:
+    static constexpr uint8_t JUMPS_TO_ACCEPT = 3;
+
+    struct Config {
+        float measNoiseKh   = 0.05f;  // desvio da medição (dKH)
+        float khWalk        = 0.05f;  // ruído de processo do KH, dKH/√dia
+        float rateWalk      = 2.0f;   // variação do consumo, (dKH/dia)/√dia (segue dia/noite)
+        float doseNoiseFrac = 0.10f;  // incerteza do efeito de cada dose
+        float initRate      = 0.0f;   // consumo antes da primeira medição (dKH/dia)
+        float initRateStd   = 1.0f;
+        float gate          = 4.0f;   // inovação acima de gate·σ = fora da curva
+        float averageDays   = 1.0f;   // janela das médias de dosagem e consumo
+    };
+
+    struct Estimate {
+        float kh;
+        float khStd;            // desvio do estado (sem o ruído da medição)
+        float consumption;      // dKH/dia
+        float consumptionStd;
+    };
+
+    KHKalman();
+
+    /**
+     * Reiniciar o filtro com a configuração
+     */
+    void begin(const Config& cfg);
+
+    /**
+     * Esquecer o estado (mantém a configuração)
+     */
+    void reset();
+
+    /**
+     * Registrar medição de KH
+     * @param timestamp ms
+     * @return false se descartada como fora da curva
+     */
+    bool addMeasurement(uint64_t timestamp, float kh);
+
+    /**
+     * Registrar dose executada
+     * @param timestamp ms
+     * @param khDosed Alcalinidade adicionada ao aquário (dKH)
+     */
+    void addDose(uint64_t timestamp, float khDosed);
+
+    /**
+     * Estado no último evento
+     */
+    Estimate estimate() const;
+
+    /**
+     * Projetar o estado
+     * @param hoursAhead Horas depois do último evento
+     * @param doseKhPerDay Dosagem prevista no período (ex.: getDoseRate())
+     */
+    Estimate predict(float hoursAhead, float doseKhPerDay) const;
+
+    /**
+     * Taxa média de dosagem recente (dKH/dia, média exponencial)
+     */
+    float getDoseRate() const { return _doseRate; }
+
+    /**
+     * Consumo médio recente (dKH/dia, média exponencial do estimado): sem a
+     * oscilação dia/noite que o estado acompanha
+     */
+    float getMeanConsumption() const { return _rateMean; }
+
+    bool ready() const { return _ready; }
+    uint64_t lastTimestamp() const { return _t; }
+    uint32_t getRejected() const { return _rejected; }
+    const Config& config() const { return _cfg; }
+
+private:
+    void propagate(uint64_t timestamp);
+
+    Config   _cfg;
+    bool     _ready = false;
+    float    _x[2] = {0, 0};
+    float    _P[2][2] = {{0, 0}, {0, 0}};
+    uint64_t _t = 0;
+    float    _doseRate = 0;     // dKH/dia
+    float    _rateMean = 0;     // dKH/dia
+    uint8_t  _jumpCount = 0;
+    uint32_t _rejected = 0;
+};
+
+#endif // KH_KALMAN_H
@@ -0,0 +1,435 @@
+#include "KH_Predictor.h"
+#include "rbs_hal.h"
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <stdarg.h>
+
+static inline float clampf(float v, float lo, float hi) {
+    return std::min(std::max(v, lo), hi);
+}
+
+static void setReason(KHPredictor::PredictionResult& r, const char* fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+static void setReason(KHPredictor::PredictionResult& r, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(r.reason, sizeof(r.reason), fmt, ap);
+    va_end(ap);
+}
+
+KHPredictor::KHPredictor() {
+}
+
+void KHPredictor::begin() {
+    rbsLog("[KH_Predictor] Sistema de predição inicializado");
+    clearHistory();
+}
+
+void KHPredictor::addMeasurement(float kh, uint64_t timestamp, float temperature) {
+    // Validar entrada
+    if (!isValidKH(kh)) {
+        rbsLog("[KH_Predictor] Valor de KH fora de faixa!");
+        return;
+    }
+    
+    if (!isValidTemperature(temperature)) {
+        rbsLog("[KH_Predictor] Temperatura inválida!");
+        return;
+    }
+    
+    // Aplicar compensação de temperatura
+    float compensated_kh = kh + calculateTemperatureCompensation(temperature);
+    
+    // Adicionar ao histórico (cheio: o anel descarta o mais antigo)
+    DataPoint point = {compensated_kh, timestamp, temperature};
+    history.push(point);
+    if (kalman_enabled) {
+        kalman.addMeasurement(timestamp, compensated_kh);
+    }
+    
+    last_temperature = temperature;
+    
+    rbsLog("[KH_Predictor] Medição adicionada: KH=%.2f dKH, Temp=%.1f°C",
+           compensated_kh, temperature);
+}
+
+KHPredictor::PredictionResult KHPredictor::getPrediction(int hoursAhead) {
+    PredictionResult result = {0, 0, 0, "", false, 0, 0};
+    
+    // Verificar se há dados suficientes
+    if (history.size() < 3) {
+        setReason(result, "Dados insuficientes");
+        return result;
+    }
+    
+    if (useKalman()) {
+        return kalmanPrediction(hoursAhead);
+    }
+    
+    // Ajustar reta (x em horas desde a medição mais antiga)
+    LineFit line;
+    if (!fit(line)) {
+        setReason(result, "Medições sem intervalo de tempo");
+        return result;
+    }
+    
+    // Predição linear, projetando a partir da medição mais recente
+    float x = hoursSinceFirst(history.size() - 1) + hoursAhead;
+    float predicted_kh = line.predict(x);
+    
+    // Adicionar componente de ciclo diário
+    float cycle_component = calculateDailyCycleComponent();
+    predicted_kh += cycle_component;
+    
+    // Validar predição
+    if (!isValidKH(predicted_kh)) {
+        predicted_kh = clampf(predicted_kh, MIN_KH, MAX_KH);
+    }
+    
+    // Calcular confiança
+    float confidence = line.rSquared * 100.0f;
+    float half = line.halfInterval(x);
+    
+    result.predicted_kh = predicted_kh;
+    result.confidence = confidence;
+    result.interval_low = predicted_kh - half;
+    result.interval_high = predicted_kh + half;
+    result.is_valid = true;
+    
+    return result;
+}
+
+KHPredictor::PredictionResult KHPredictor::getDosageRecommendation() {
+    PredictionResult result = {0, 0, 0, "", false, 0, 0};
+    
+    if (history.size() < 3) {
+        setReason(result, "Dados insuficientes");
+        return result;
+    }
+    
+    // Obter predição
+    PredictionResult pred = getPrediction(4);
+    if (!pred.is_valid) {
+        setReason(result, "Predição inválida");
+        return result;
+    }
+    
+    float dosage_adjustment;
+    float consumption = 0;
+    if (useKalman()) {
+        // Dosagem necessária (dKH/dia) = consumo médio + erro corrigido em
+        // CORRECTION_DAYS, contra a dosagem média no mesmo período
+        consumption = kalman.getMeanConsumption();
+        float current = kalman.getDoseRate();
+        float needed = consumption + (reference_kh - pred.predicted_kh) / CORRECTION_DAYS;
+        if (current > 0.01f) {
+            dosage_adjustment = clampf((needed / current - 1.0f) * 100.0f, -50.0f, 50.0f);
+        } else {
+            // Sem doses registradas não há base para percentual: tendência líquida
+            dosage_adjustment = calculateDosageAdjustment(pred.predicted_kh, (current - consumption) / 24.0f);
+        }
+    } else {
+        // Calcular taxa de mudança
+        float trend_rate = getTrendRate();
+        
+        // Calcular ajuste de dosagem
+        dosage_adjustment = calculateDosageAdjustment(pred.predicted_kh, trend_rate);
+    }
+    
+    result.predicted_kh = pred.predicted_kh;
+    result.confidence = pred.confidence;
+    result.dosage_adjustment = dosage_adjustment;
+    result.interval_low = pred.interval_low;
+    result.interval_high = pred.interval_high;
+    result.is_valid = true;
+    
+    // Gerar mensagem de recomendação
+    if (fabs(dosage_adjustment) < 5.0f) {
+        setReason(result, "Sistema estável. Sem ajuste necessário.");
+    } else if (useKalman()) {
+        setReason(result, "%s dosagem em %.1f%%. KH previsto: %.2f dKH, consumo %.2f dKH/dia",
+                  dosage_adjustment > 0 ? "Aumentar" : "Reduzir", fabs(dosage_adjustment),
+                  pred.predicted_kh, consumption);
+    } else if (dosage_adjustment > 0) {
+        setReason(result, "Aumentar dosagem em %.1f%%. KH previsto: %.2f dKH",
+                  dosage_adjustment, pred.predicted_kh);
+    } else {
+        setReason(result, "Reduzir dosagem em %.1f%%. KH previsto: %.2f dKH",
+                  fabs(dosage_adjustment), pred.predicted_kh);
+    }
+    
+    return result;
+}
+
+KHPredictor::Statistics KHPredictor::getStatistics() {
+    Statistics stats = {0, 0, 0, 0, 0, 0};
+    
+    if (history.empty()) {
+        return stats;
+    }
+    
+    // Média, min e max numa passada (sem copiar o histórico)
+    size_t n = history.size();
+    double sum = 0;
+    stats.min_kh = stats.max_kh = history[0].kh;
+    for (size_t i = 0; i < n; i++) {
+        float kh = history[i].kh;
+        sum += kh;
+        stats.min_kh = std::min(stats.min_kh, kh);
+        stats.max_kh = std::max(stats.max_kh, kh);
+    }
+    stats.mean_kh = float(sum / n);
+    
+    // Calcular desvio padrão
+    double variance = 0;
+    for (size_t i = 0; i < n; i++) {
+        double d = history[i].kh - stats.mean_kh;
+        variance += d * d;
+    }
+    stats.std_dev = float(sqrt(variance / n));
+    
+    // Calcular taxa de mudança
+    stats.trend_rate = getTrendRate();
+    
+    stats.data_count = history.size();
+    
+    return stats;
+}
+
+void KHPredictor::clearHistory() {
+    history.clear();
+    kalman.reset();
+    rbsLog("[KH_Predictor] Histórico limpo");
+}
+
+int KHPredictor::getDataCount() const {
+    return history.size();
+}
+
+std::string KHPredictor::exportAsJSON() {
+    std::string json = "{\"data\":[";
+    json.reserve(16 + history.size() * 64);
+    
+    char item[96];
+    for (size_t i = 0; i < history.size(); i++) {
+        snprintf(item, sizeof(item), "%s{\"kh\":%.2f,\"timestamp\":%llu,\"temperature\":%.1f}",
+                 i > 0 ? "," : "", history[i].kh,
+                 (unsigned long long)history[i].timestamp, history[i].temperature);
+        json += item;
+    }
+    
+    json += "]}";
+    return json;
+}
+
+bool KHPredictor::importFromJSON(const char* json) {
+    (void)json;
+    // Implementação simplificada
+    // Em produção, usar ArduinoJson
+    clearHistory();
+    return true;
+}
+
+bool KHPredictor::detectAnomaly() {
+    if (history.size() < 5) {
+        return false;
+    }
+    
+    // Reta sem o último ponto: um valor absurdo não entra no próprio teste
+    LineFit line;
+    if (!fit(line, 1)) {
+        return false;
+    }
+    
+    // Resíduo do último ponto em unidades da escala dos resíduos (com piso:
+    // série quase perfeita não vira anomalia por 0,02 dKH)
+    size_t last = history.size() - 1;
+    float residual = history[last].kh - line.predict(hoursSinceFirst(last));
+    float scale = std::max(line.scale, ANOMALY_MIN_SCALE);
+    
+    // Anomalia se passar de 3 escalas
+    return fabs(residual) / scale > 3.0f;
+}
+
+float KHPredictor::getTrendRate() {
+    if (history.size() < 2) {
+        return 0;
+    }
+    
+    LineFit line;
+    return fit(line) ? line.slope : 0;   // x em horas: dKH/hora
+}
+
+float KHPredictor::getDailyCycleAmplitude() {
+    return calculateDailyCycleComponent() * 2.0f;
+}
+
+void KHPredictor::setReferenceKH(float ref_kh) {
+    if (isValidKH(ref_kh)) {
+        reference_kh = ref_kh;
+        rbsLog("[KH_Predictor] KH de referência definido: %.2f", ref_kh);
+    }
+}
+
+float KHPredictor::getReferenceKH() const {
+    return reference_kh;
+}
+
+void KHPredictor::setEstimator(FitMethod method) {
+    estimator = method;
+}
+
+FitMethod KHPredictor::getEstimator() const {
+    return estimator;
+}
+
+void KHPredictor::setKalman(bool enabled, float khPerMl, const KHKalman::Config& cfg) {
+    kalman_enabled = enabled;
+    dose_kh_per_ml = khPerMl;
+    kalman.begin(cfg);
+    if (!enabled) {
+        return;
+    }
+    
+    // Parte do histórico que já existe (doses passadas não são conhecidas)
+    for (size_t i = 0; i < history.size(); i++) {
+        kalman.addMeasurement(history[i].timestamp, history[i].kh);
+    }
+    rbsLog("[KH_Predictor] Kalman ligado: %.4f dKH/mL, %u medições", khPerMl, (unsigned)history.size());
+}
+
+void KHPredictor::addDose(uint64_t timestamp, float volumeMl) {
+    if (!kalman_enabled || !(volumeMl > 0)) {
+        return;
+    }
+    kalman.addDose(timestamp, volumeMl * dose_kh_per_ml);
+}
+
+// Métodos privados
+
+float KHPredictor::hoursSinceFirst(size_t i) const {
+    return float(double(history[i].timestamp - history[0].timestamp) / 3600000.0);
+}
+
+bool KHPredictor::useKalman() const {
+    return kalman_enabled && kalman.ready();
+}
+
+KHPredictor::PredictionResult KHPredictor::kalmanPrediction(int hoursAhead) {
+    PredictionResult result = {0, 0, 0, "", false, 0, 0};
+    
+    // Dosagem no período = média recente (as agendas continuam rodando)
+    KHKalman::Estimate e = kalman.predict(float(hoursAhead), kalman.getDoseRate());
+    
+    // Intervalo da próxima medição: estado + ruído da medição
+    float meas = kalman.config().measNoiseKh;
+    float half = 1.96f * sqrtf(e.khStd * e.khStd + meas * meas);
+    
+    result.predicted_kh = clampf(e.kh, MIN_KH, MAX_KH);
+    result.confidence = clampf(1.0f - 1.96f * e.khStd / CONFIDENCE_SPAN, 0.0f, 1.0f) * 100.0f;
+    result.interval_low = result.predicted_kh - half;
+    result.interval_high = result.predicted_kh + half;
+    result.is_valid = true;
+    return result;
+}
+
+bool KHPredictor::fit(LineFit& out, size_t skipLast) {
+    if (history.size() < 2 + skipLast) {
+        return false;
+    }
+    
+    size_t n = history.size() - skipLast;
+    float x[MAX_HISTORY], y[MAX_HISTORY];
+    for (size_t i = 0; i < n; i++) {
+        x[i] = hoursSinceFirst(i);
+        y[i] = history[i].kh;
+    }
+    return fitLine(estimator, x, y, n, out);
+}
+
+
+float KHPredictor::calculateConfidence() {
+    if (history.size() < 5) {
+        return 50.0f;
+    }
+    
+    LineFit line;
+    return fit(line) ? line.rSquared * 100.0f : 0;
+}
+
+float KHPredictor::calculateDosageAdjustment(float predicted_kh, float trend_rate) {
+    float target_kh = reference_kh;
+    float error = target_kh - predicted_kh;
+    
+    // Ajuste proporcional ao erro
+    float adjustment = error * 10.0f;
+    
+    // Considerar taxa de mudança
+    if (trend_rate < -0.1f) {
+        adjustment += 20.0f; // Aumentar se KH está caindo rápido
+    } else if (trend_rate > 0.1f) {
+        adjustment -= 10.0f; // Reduzir se KH está subindo
+    }
+    
+    // Limitar ajuste
+    return clampf(adjustment, -50.0f, 50.0f);
+}
+
+float KHPredictor::calculateDailyCycleComponent() {
+    if (history.size() < 24) {
+        return 0;
+    }
+    
+    // Simplificado: retornar 10% da amplitude
+    Statistics stats = getStatistics();
+    return (stats.max_kh - stats.min_kh) * 0.05f;
+}
+
+float KHPredictor::calculateTemperatureCompensation(float temp) {
+    // Compensação: α = 0.002 dKH/°C
+    // Referência: 25°C
+    float alpha = 0.002f;
+    return (temp - 25.0f) * alpha;
+}
+
+float KHPredictor::calculateDosageEffectiveness() {
+    if (history.size() < 10) {
+        return 0.5f;
+    }
+    
+    // Calcular variância das últimas medições
+    Statistics stats = getStatistics();
+    
+    // Efetividade inversamente proporcional à variância
+    return 1.0f / (1.0f + stats.std_dev);
+}
+
+bool KHPredictor::detectPeaksAndValleys() {
+    if (history.size() < 3) {
+        return false;
+    }
+    
+    int peaks = 0;
+    for (size_t i = 1; i < history.size() - 1; i++) {
+        if (history[i].kh > history[i-1].kh && history[i].kh > history[i+1].kh) {
+            peaks++;
+        }
+    }
+    
+    return peaks > 0;
+}
+
+float KHPredictor::calculateDominantFrequency() {
+    // FFT simplificada: retornar 0 (sem ciclo dominante)
+    // Em produção, implementar FFT real
+    return 0;
+}
+
+bool KHPredictor::isValidKH(float kh) {
+    return kh >= MIN_KH && kh <= MAX_KH;
+}
+
+bool KHPredictor::isValidTemperature(float temp) {
+    return temp >= 15.0f && temp <= 35.0f;
+}
@@ -1,12 +1,11 @@
 #ifndef KH_PREDICTOR_H
 #define KH_PREDICTOR_H
 
-#include <Arduino.h>
-#include <vector>
-#include <numeric>
-#include <cstdio>
-#include <cmath>
 #include <stdint.h>
+#include <string>
+#include "RingBuffer.h"
+#include "LineFit.h"
+#include "KH_Kalman.h"
 
 
 /**
@@ -14,7 +13,9 @@
  * @brief Sistema de IA para predição de KH e recomendação automática de dosagem
  * 
  * Implementa algoritmos de:
- * - Regressão linear adaptativa
+ * - Regressão linear (mínimos quadrados, Theil-Sen ou Huber) com
+ *   intervalo de predição
+ * - Filtro de Kalman com as doses como entrada (opcional, setKalman)
  * - Detecção de ciclo diário
  * - Predição 4 horas
  * - Recomendação automática de dosagem
@@ -34,8 +35,10 @@ public:
         float predicted_kh;
         float confidence;        // 0-100%
         float dosage_adjustment; // -50% a +50%
-        String reason;           // Motivo da recomendação
+        char reason[96];         // Motivo da recomendação
         bool is_valid;
+        float interval_low;      // intervalo de predição de 95% (dKH)
+        float interval_high;
     };
 
     // Estrutura para estatísticas
@@ -100,14 +103,14 @@ public:
      * Exportar histórico como JSON
      * @return String com dados em formato JSON
      */
-    String exportAsJSON();
+    std::string exportAsJSON();
 
     /**
      * Importar histórico de JSON
      * @param json String com dados em formato JSON
      * @return true se importação bem-sucedida
      */
-    bool importFromJSON(const String& json);
+    bool importFromJSON(const char* json);
 
     /**
      * Detectar anomalias nos dados
@@ -139,26 +142,76 @@ public:
      */
     float getReferenceKH() const;
 
-private:
-    // Histórico de medições
-    std::vector<DataPoint> history;
-    
+    /**
+     * Escolher o ajuste de reta usado em tendência, predição e anomalias
+     * @param method FIT_OLS (padrão), FIT_THEIL_SEN ou FIT_HUBER; os robustos
+     *               não deixam uma leitura ruim (bolha no eletrodo) puxar a reta
+     */
+    void setEstimator(FitMethod method);
 
-    float _ph_ref_measured = 0.0f;
-    float _temp_ref        = 0.0f;
+    /**
+     * Obter o ajuste de reta em uso
+     * @return Método configurado
+     */
+    FitMethod getEstimator() const;
+
+    /**
+     * Ligar o filtro de Kalman (KHKalman) para predição e dosagem
+     *
+     * Com ele ligado getPrediction() projeta o KH filtrado com o consumo
+     * estimado e a dosagem recente, e getDosageRecommendation() compara a
+     * dosagem necessária (consumo médio + erro em CORRECTION_DAYS) com a
+     * dosagem média recente.
+     * Tendência, estatísticas e anomalias continuam na reta.
+     * @param enabled false volta para a reta
+     * @param khPerMl Efeito de 1 mL dosado no aquário (dKH/mL)
+     * @param cfg Ruídos do filtro
+     */
+    void setKalman(bool enabled, float khPerMl, const KHKalman::Config& cfg = KHKalman::Config());
 
+    /**
+     * Registrar dose de alcalinidade executada (agenda da dosadora ou
+     * khcorrection); ignorado com o filtro desligado
+     * @param timestamp Timestamp em milissegundos
+     * @param volumeMl mL dosados
+     */
+    void addDose(uint64_t timestamp, float volumeMl);
+
+    /**
+     * Obter o filtro de Kalman (KH suavizado, consumo e incertezas)
+     */
+    const KHKalman& getKalman() const { return kalman; }
+    bool isKalmanEnabled() const { return kalman_enabled; }
 
+private:
     // Configurações
     static constexpr int MAX_HISTORY = 100;
+    static_assert(MAX_HISTORY <= FIT_MAX_POINTS, "histórico maior que o ajuste de reta aceita");
     static constexpr float MIN_KH = 1.0f;
     static constexpr float MAX_KH = 20.0f;
+    static constexpr float ANOMALY_MIN_SCALE = 0.05f;  // dKH, resolução da medição
+    static constexpr float CORRECTION_DAYS = 3.0f;      // Kalman: prazo para zerar o erro
+    static constexpr float CONFIDENCE_SPAN = 0.5f;      // Kalman: ±0,5 dKH (95%) = 0%
     
+    // Histórico de medições (anel: sem realocação nem deslocamento)
+    RingBuffer<DataPoint, MAX_HISTORY> history;
+
+    float _ph_ref_measured = 0.0f;
+    float _temp_ref        = 0.0f;
+
     // Valores de referência
     float reference_kh = 8.0;
     float last_temperature = 25.0;
+    FitMethod estimator = FIT_OLS;
+    KHKalman kalman;
+    bool kalman_enabled = false;
+    float dose_kh_per_ml = 0.0f;
     
     // Métodos privados
-    float calculateLinearRegression(float& slope, float& intercept);
+    bool fit(LineFit& out, size_t skipLast = 0);
+    bool useKalman() const;
+    PredictionResult kalmanPrediction(int hoursAhead);
+    float hoursSinceFirst(size_t i) const;
     float calculateConfidence();
     float calculateDosageAdjustment(float predicted_kh, float trend_rate);
     float calculateDailyCycleComponent();
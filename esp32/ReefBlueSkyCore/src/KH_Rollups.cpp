@@ -0,0 +1,186 @@
+#include "KH_Rollups.h"
+#include <math.h>
+#include <string.h>
+
+static const uint32_t ROLLUP_MAGIC   = 0x31524252;   // "RBR1"
+static const uint32_t SECONDS_HOUR   = 3600UL;
+static const uint32_t SECONDS_DAY    = 86400UL;
+
+float KHRollups::Bucket::stdDev() const {
+    return sqrtf(variance());
+}
+
+uint32_t KHRollups::bucketSeconds(Tier tier) {
+    switch (tier) {
+        case HOURLY: return SECONDS_HOUR;
+        case DAILY:  return SECONDS_DAY;
+        default:     return 7UL * SECONDS_DAY;
+    }
+}
+
+uint32_t KHRollups::bucketStart(Tier tier, uint32_t epochS) {
+    switch (tier) {
+        case HOURLY: return epochS - epochS % SECONDS_HOUR;
+        case DAILY:  return epochS - epochS % SECONDS_DAY;
+        default: {
+            // 01/01/1970 foi quinta: +3 dias conta a partir da segunda anterior
+            uint32_t day = epochS / SECONDS_DAY;
+            uint32_t sinceMonday = (day + 3) % 7;
+            if (day < sinceMonday) return 0;
+            return (day - sinceMonday) * SECONDS_DAY;
+        }
+    }
+}
+
+void KHRollups::merge(Bucket& into, const Bucket& b) {
+    if (b.count == 0) return;
+    if (into.count == 0) {
+        uint32_t start = into.start;
+        into = b;
+        if (start && start < b.start) into.start = start;
+        return;
+    }
+    uint32_t n = into.count + b.count;
+    float delta = b.mean - into.mean;
+    into.mean += delta * (float)b.count / (float)n;
+    into.m2   += b.m2 + delta * delta * (float)into.count * (float)b.count / (float)n;
+    if (b.min < into.min) into.min = b.min;
+    if (b.max > into.max) into.max = b.max;
+    // "last" = do bucket mais recente
+    if (b.start >= into.start) into.last = b.last;
+    if (b.start < into.start) into.start = b.start;
+    into.count = n;
+}
+
+template <size_t N>
+bool KHRollups::addTo(RingBuffer<Bucket, N>& ring, uint32_t start, float kh) {
+    Bucket* b = nullptr;
+    if (ring.empty() || start > ring.back().start) {
+        Bucket fresh = {start, 0, 0.0f, 0.0f, kh, kh, kh};
+        ring.push(fresh);
+        b = &ring[ring.size() - 1];
+    } else {
+        // Fora de ordem: procura do mais recente para trás (normalmente o último)
+        for (size_t i = ring.size(); i-- > 0;) {
+            if (ring[i].start == start) { b = &ring[i]; break; }
+            if (ring[i].start < start) break;
+        }
+        if (!b) return false;
+    }
+
+    b->count++;
+    float delta = kh - b->mean;
+    b->mean += delta / (float)b->count;
+    b->m2   += delta * (kh - b->mean);
+    if (kh < b->min) b->min = kh;
+    if (kh > b->max) b->max = kh;
+    b->last = kh;
+    return true;
+}
+
+bool KHRollups::add(uint32_t epochS, float kh) {
+    if (!isfinite(kh)) return false;
+    bool ok = addTo(_hourly, bucketStart(HOURLY, epochS), kh);
+    ok = addTo(_daily, bucketStart(DAILY, epochS), kh) && ok;
+    ok = addTo(_weekly, bucketStart(WEEKLY, epochS), kh) && ok;
+    return ok;
+}
+
+template <size_t N>
+void KHRollups::windowOf(const RingBuffer<Bucket, N>& ring, uint32_t fromS,
+                         uint32_t seconds, Bucket& out) {
+    for (size_t i = ring.size(); i-- > 0;) {
+        const Bucket& b = ring[i];
+        if (b.start + seconds <= fromS) break;   // termina antes do período
+        merge(out, b);
+    }
+}
+
+KHRollups::Bucket KHRollups::window(uint32_t nowS, uint32_t spanS) const {
+    Bucket out = {0, 0, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    uint32_t fromS = nowS > spanS ? nowS - spanS : 0;
+
+    if (spanS <= HOURLY_BUCKETS * SECONDS_HOUR) {
+        windowOf(_hourly, fromS, SECONDS_HOUR, out);
+    } else if (spanS <= DAILY_BUCKETS * SECONDS_DAY) {
+        windowOf(_daily, fromS, SECONDS_DAY, out);
+    } else {
+        windowOf(_weekly, fromS, 7UL * SECONDS_DAY, out);
+    }
+    return out;
+}
+
+const KHRollups::Bucket* KHRollups::bucketAt(Tier tier, uint32_t epochS) const {
+    uint32_t start = bucketStart(tier, epochS);
+    size_t n = size(tier);
+    for (size_t i = n; i-- > 0;) {
+        const Bucket& b = bucket(tier, i);
+        if (b.start == start) return &b;
+        if (b.start < start) break;
+    }
+    return nullptr;
+}
+
+size_t KHRollups::size(Tier tier) const {
+    switch (tier) {
+        case HOURLY: return _hourly.size();
+        case DAILY:  return _daily.size();
+        default:     return _weekly.size();
+    }
+}
+
+const KHRollups::Bucket& KHRollups::bucket(Tier tier, size_t i) const {
+    switch (tier) {
+        case HOURLY: return _hourly[i];
+        case DAILY:  return _daily[i];
+        default:     return _weekly[i];
+    }
+}
+
+void KHRollups::clear() {
+    _hourly.clear();
+    _daily.clear();
+    _weekly.clear();
+}
+
+// magic (4) | versão (1) | buckets por nível (3) | buckets do mais antigo ao mais recente
+size_t KHRollups::save(uint8_t* out, size_t cap) const {
+    if (cap < SAVE_SIZE) return 0;
+    memcpy(out, &ROLLUP_MAGIC, 4);
+    out[4] = 1;
+    size_t pos = 8;
+    for (uint8_t t = 0; t < TIER_COUNT; t++) {
+        size_t n = size((Tier)t);
+        out[5 + t] = (uint8_t)n;
+        for (size_t i = 0; i < n; i++) {
+            memcpy(out + pos, &bucket((Tier)t, i), sizeof(Bucket));
+            pos += sizeof(Bucket);
+        }
+    }
+    return pos;
+}
+
+bool KHRollups::load(const uint8_t* in, size_t len) {
+    uint32_t magic;
+    if (len < 8) return false;
+    memcpy(&magic, in, 4);
+    if (magic != ROLLUP_MAGIC || in[4] != 1) return false;
+    if (in[5] > HOURLY_BUCKETS || in[6] > DAILY_BUCKETS || in[7] > WEEKLY_BUCKETS) return false;
+    if (len != 8 + (size_t)(in[5] + in[6] + in[7]) * sizeof(Bucket)) return false;
+
+    clear();
+    size_t pos = 8;
+    for (uint8_t t = 0; t < TIER_COUNT; t++) {
+        for (uint8_t i = 0; i < in[5 + t]; i++) {
+            Bucket b;
+            memcpy(&b, in + pos, sizeof(Bucket));
+            pos += sizeof(Bucket);
+            switch (t) {
+                case HOURLY: _hourly.push(b); break;
+                case DAILY:  _daily.push(b);  break;
+                default:     _weekly.push(b); break;
+            }
+        }
+    }
+    return true;
+}
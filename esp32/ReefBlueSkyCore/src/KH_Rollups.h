@@ -0,0 +1,96 @@
+#ifndef KH_ROLLUPS_H
+#define KH_ROLLUPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "RingBuffer.h"
+
+/**
+ * @class KHRollups
+ * @brief Agregados de KH por hora, dia e semana, mantidos no próprio aparelho
+ *
+ * Cada medição entra em O(1) nos três níveis (Welford: contagem, média, M2,
+ * mínimo, máximo, último). Cada nível é um anel de buckets de tamanho fixo:
+ *
+ *   HOURLY  48 buckets (2 dias)
+ *   DAILY   35 buckets (5 semanas)
+ *   WEEKLY  26 buckets (~6 meses, semana começando na segunda)
+ *
+ * Limites dos buckets em UTC, epoch em segundos. window() junta (Chan et
+ * al.) os buckets do nível mais fino que cobre o período - "últimas 24 h"
+ * são no máximo 25 buckets horários, custo fixo independente do tamanho do
+ * histórico. A resolução é a do bucket: o bucket que contém o início do
+ * período entra inteiro.
+ *
+ * Medição fora de ordem entra se o bucket dela ainda estiver no anel; mais
+ * antiga que isso é ignorada. Sem alocação: ~3 KB no total.
+ */
+class KHRollups {
+public:
+    enum Tier : uint8_t { HOURLY = 0, DAILY, WEEKLY, TIER_COUNT };
+
+    static constexpr size_t HOURLY_BUCKETS = 48;
+    static constexpr size_t DAILY_BUCKETS  = 35;
+    static constexpr size_t WEEKLY_BUCKETS = 26;
+
+    struct Bucket {
+        uint32_t start;   // epoch (s) do início do bucket
+        uint32_t count;
+        float    mean;
+        float    m2;      // soma dos quadrados dos desvios (Welford)
+        float    min;
+        float    max;
+        float    last;
+
+        float variance() const { return count > 0 ? m2 / count : 0.0f; }
+        float stdDev() const;
+    };
+
+    // Tamanho máximo de save()
+    static constexpr size_t SAVE_SIZE =
+        8 + (HOURLY_BUCKETS + DAILY_BUCKETS + WEEKLY_BUCKETS) * sizeof(Bucket);
+
+    /**
+     * Adicionar uma medição
+     * @param epochS Epoch em segundos (UTC)
+     * @return false se o valor não é finito ou o bucket já saiu do anel
+     */
+    bool add(uint32_t epochS, float kh);
+
+    /**
+     * Agregado do período [nowS - spanS, nowS], no nível mais fino que o cobre
+     * @return Bucket com start do mais antigo usado; count = 0 se vazio
+     */
+    Bucket window(uint32_t nowS, uint32_t spanS) const;
+    Bucket last24h(uint32_t nowS) const { return window(nowS, 24UL * 3600UL); }
+
+    // Bucket que contém epochS, ou nullptr se não existe
+    const Bucket* bucketAt(Tier tier, uint32_t epochS) const;
+
+    size_t size(Tier tier) const;
+    // i = 0 é o mais antigo
+    const Bucket& bucket(Tier tier, size_t i) const;
+
+    void clear();
+
+    static uint32_t bucketStart(Tier tier, uint32_t epochS);
+    static uint32_t bucketSeconds(Tier tier);
+    static void merge(Bucket& into, const Bucket& other);
+
+    // Persistência (formato binário próprio, mesma arquitetura que gravou)
+    size_t save(uint8_t* out, size_t cap) const;
+    bool load(const uint8_t* in, size_t len);
+
+private:
+    template <size_t N>
+    static bool addTo(RingBuffer<Bucket, N>& ring, uint32_t start, float kh);
+    template <size_t N>
+    static void windowOf(const RingBuffer<Bucket, N>& ring, uint32_t fromS,
+                         uint32_t seconds, Bucket& out);
+
+    RingBuffer<Bucket, HOURLY_BUCKETS> _hourly;
+    RingBuffer<Bucket, DAILY_BUCKETS>  _daily;
+    RingBuffer<Bucket, WEEKLY_BUCKETS> _weekly;
+};
+
+#endif // KH_ROLLUPS_H
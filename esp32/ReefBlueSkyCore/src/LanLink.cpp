@@ -0,0 +1,421 @@
+#include "LanLink.h"
+#include "Sha256.h"
+#include "rbs_hal.h"
+#include <math.h>
+#include <string.h>
+
+#define LANLINK_VERSION     1
+#define FLAG_ACK_REQ        0x01   // responder com ACK
+#define FLAG_REPLY_ANNOUNCE 0x02   // ANNOUNCE: quem recebe responde com o seu
+#define EPOCH_SYNCED        1600000000u
+
+static inline void put16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint16_t get16(const uint8_t* p) {
+  return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static inline uint32_t get32(const uint8_t* p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+uint32_t LanLink::keyIdFor(const uint8_t* key, size_t len) {
+  uint8_t h[RBS_SHA256_LEN];
+  rbsSha256(key, len, h);
+  return get32(h);
+}
+
+uint32_t LanLink::idFor(const char* uid) {
+  uint32_t h = 2166136261u;
+  for (; *uid; uid++) {
+    h ^= (uint8_t)*uid;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+bool LanLink::begin(const Config& cfg, const Handlers& h) {
+  _ready = false;
+  if (!cfg.key || cfg.keyLen == 0 || cfg.keyLen > LANLINK_KEY_MAX || !h.send) return false;
+
+  _cfg = cfg;
+  if (_cfg.session == 0) _cfg.session = 1;   // 0 = posição vazia em Peer::oldSessions
+  _h = h;
+  memcpy(_key, cfg.key, cfg.keyLen);
+  _cfg.key = _key;
+  _keyId = keyIdFor(_key, cfg.keyLen);
+  _id = idFor(cfg.uid);
+  _seq = 0;
+  _announced = false;
+  memset(_peers, 0, sizeof(_peers));
+  memset(_pending, 0, sizeof(_pending));
+  memset(&_stats, 0, sizeof(_stats));
+  _ready = true;
+
+  rbsLog("[LanLink] %s %s, chave %08lx, sessão %08lx",
+         cfg.role == ROLE_DOSER ? "Dosadora" : "Monitor", cfg.uid,
+         (unsigned long)_keyId, (unsigned long)cfg.session);
+  return true;
+}
+
+// ---------- Envio ----------
+
+size_t LanLink::encode(uint8_t* out, uint8_t type, uint8_t flags, uint32_t seq,
+                       const uint8_t* payload, uint8_t payloadLen, uint32_t nowMs, uint32_t epoch) const {
+  out[0] = 'R';
+  out[1] = 'B';
+  out[2] = 'L';
+  out[3] = LANLINK_VERSION;
+  out[4] = type;
+  out[5] = flags;
+  put16(out + 6, payloadLen);
+  put32(out + 8, _keyId);
+  put32(out + 12, _id);
+  put32(out + 16, _cfg.session);
+  put32(out + 20, seq);
+  put32(out + 24, nowMs);
+  put32(out + 28, epoch);
+  if (payloadLen) memcpy(out + LANLINK_HEADER_LEN, payload, payloadLen);
+
+  size_t n = LANLINK_HEADER_LEN + payloadLen;
+  uint8_t tag[RBS_SHA256_LEN];
+  rbsHmacSha256(_key, _cfg.keyLen, out, n, tag);
+  memcpy(out + n, tag, LANLINK_TAG_LEN);
+  return n + LANLINK_TAG_LEN;
+}
+
+void LanLink::sendTo(uint32_t ip, uint16_t port, uint8_t type, uint8_t flags, uint32_t seq,
+                     const uint8_t* payload, uint8_t payloadLen, uint32_t nowMs, uint32_t epoch) {
+  uint8_t buf[LANLINK_MAX_DATAGRAM];
+  size_t n = encode(buf, type, flags, seq, payload, payloadLen, nowMs, epoch);
+  _h.send(_h.ctx, ip, port, buf, n);
+}
+
+void LanLink::sendAnnounce(uint32_t ip, uint16_t port, bool askReply, uint32_t nowMs, uint32_t epoch) {
+  uint8_t p[LANLINK_MAX_PAYLOAD];
+  size_t uidLen = strnlen(_cfg.uid, sizeof(Peer::uid) - 1);
+  p[0] = _cfg.role;
+  p[1] = (uint8_t)uidLen;
+  memcpy(p + 2, _cfg.uid, uidLen);
+  sendTo(ip, port, MSG_ANNOUNCE, askReply ? FLAG_REPLY_ANNOUNCE : 0, ++_seq, p, (uint8_t)(2 + uidLen), nowMs, epoch);
+}
+
+void LanLink::sendAck(const Peer& p, uint32_t seq, uint32_t echoMs, uint8_t status,
+                      uint32_t nowMs, uint32_t epoch) {
+  uint8_t b[9];
+  put32(b, seq);
+  put32(b + 4, echoMs);
+  b[8] = status;
+  sendTo(p.ip, p.port, MSG_ACK, 0, ++_seq, b, sizeof(b), nowMs, epoch);
+}
+
+bool LanLink::enqueue(const Peer& p, uint8_t type, uint32_t ref, const uint8_t* payload, uint8_t len,
+                      uint32_t nowMs, uint32_t epoch) {
+  for (Pending& q : _pending) {
+    if (q.used) continue;
+    q.used = true;
+    q.type = type;
+    q.peerId = p.id;
+    q.seq = ++_seq;
+    q.ref = ref;
+    memcpy(q.payload, payload, len);
+    q.payloadLen = len;
+    q.firstMs = nowMs;
+    q.tries = 0;
+    _stats.sent++;
+    transmit(q, nowMs, epoch);
+    return true;
+  }
+  return false;
+}
+
+// Mesmo seq em todas as tentativas: o receptor reconhece a retransmissão
+void LanLink::transmit(Pending& q, uint32_t nowMs, uint32_t epoch) {
+  const Peer* p = peerById(q.peerId);
+  if (!p) return;
+  sendTo(p->ip, p->port, q.type, FLAG_ACK_REQ, q.seq, q.payload, q.payloadLen, nowMs, epoch);
+  q.lastMs = nowMs;
+  q.tries++;
+}
+
+bool LanLink::publishMeasurement(float kh, uint32_t measuredAt, uint32_t nowMs, uint32_t epoch) {
+  if (!_ready) return false;
+  uint8_t b[8];
+  uint32_t bits;
+  memcpy(&bits, &kh, sizeof(bits));
+  put32(b, bits);
+  put32(b + 4, measuredAt);
+
+  bool any = false;
+  for (const Peer& p : _peers) {
+    if (p.used && p.role == ROLE_DOSER) {
+      any |= enqueue(p, MSG_MEASUREMENT, measuredAt, b, sizeof(b), nowMs, epoch);
+    }
+  }
+  return any;
+}
+
+bool LanLink::requestDose(uint32_t requestId, uint8_t pumpIndex, float volumeMl,
+                          uint32_t nowMs, uint32_t epoch) {
+  if (!_ready || !(volumeMl > 0)) return false;
+  const Peer* p = findPeer(ROLE_DOSER);
+  if (!p) return false;
+
+  uint8_t b[9];
+  put32(b, requestId);
+  b[4] = pumpIndex;
+  put32(b + 5, (uint32_t)lroundf(volumeMl * 100.0f));
+  return enqueue(*p, MSG_DOSE_REQUEST, requestId, b, sizeof(b), nowMs, epoch);
+}
+
+// ---------- Loop ----------
+
+void LanLink::loop(uint32_t nowMs, uint32_t epoch) {
+  if (!_ready) return;
+
+  // O primeiro ANNOUNCE do boot pede resposta: acha os pares sem esperar
+  // o ciclo de 30 s deles
+  if (!_announced || nowMs - _lastAnnounceMs >= LANLINK_ANNOUNCE_MS) {
+    sendAnnounce(LANLINK_GROUP_IP, _cfg.port, !_announced, nowMs, epoch);
+    _announced = true;
+    _lastAnnounceMs = nowMs;
+  }
+
+  for (Pending& q : _pending) {
+    if (!q.used || nowMs - q.lastMs < LANLINK_RETRY_MS) continue;
+    if (q.tries >= LANLINK_TRIES || !peerById(q.peerId)) {
+      q.used = false;
+      _stats.timeouts++;
+      rbsLog("[LanLink] Sem ACK para tipo %u ref %lu após %u tentativas",
+             q.type, (unsigned long)q.ref, q.tries);
+      if (_h.onResult) _h.onResult(_h.ctx, q.type, q.ref, RESULT_TIMEOUT, 0, nowMs - q.firstMs);
+      continue;
+    }
+    _stats.retransmits++;
+    transmit(q, nowMs, epoch);
+  }
+
+  for (Peer& p : _peers) {
+    if (p.used && nowMs - p.lastSeenMs > LANLINK_PEER_TTL_MS) {
+      rbsLog("[LanLink] Par %s sumiu", p.uid[0] ? p.uid : "?");
+      p.used = false;
+    }
+  }
+}
+
+// ---------- Recepção ----------
+
+LanLink::Peer* LanLink::peerById(uint32_t id) {
+  for (Peer& p : _peers) {
+    if (p.used && p.id == id) return &p;
+  }
+  return nullptr;
+}
+
+const LanLink::Peer* LanLink::findPeer(uint8_t role) const {
+  const Peer* best = nullptr;
+  for (const Peer& p : _peers) {
+    if (p.used && p.role == role && (!best || (int32_t)(p.lastSeenMs - best->lastSeenMs) > 0)) best = &p;
+  }
+  return best;
+}
+
+uint8_t LanLink::peerCount() const {
+  uint8_t n = 0;
+  for (const Peer& p : _peers) n += p.used;
+  return n;
+}
+
+// Sessão diferente da atual de um par conhecido: reboot de verdade ou
+// captura de uma sessão velha reenviada
+bool LanLink::sessionIsNewer(const Peer& p, uint32_t session, uint32_t theirEpoch) const {
+  for (uint32_t old : p.oldSessions) {
+    if (old == session) return false;
+  }
+  // Relógio do próprio par: sessão nova não pode vir de antes da atual
+  return theirEpoch < EPOCH_SYNCED || p.lastEpoch < EPOCH_SYNCED || theirEpoch >= p.lastEpoch;
+}
+
+// Par novo ou sessão nova (reboot do par): estado de replay recomeça e a
+// sessão anterior vai para a lista das encerradas
+LanLink::Peer* LanLink::admitPeer(uint32_t id, uint32_t session, uint32_t seq) {
+  Peer* p = peerById(id);
+  if (p) {
+    memmove(p->oldSessions + 1, p->oldSessions, sizeof(p->oldSessions) - sizeof(p->oldSessions[0]));
+    p->oldSessions[0] = p->session;
+  } else {
+    for (Peer& q : _peers) {
+      if (!q.used) { p = &q; break; }
+    }
+    if (!p) {
+      p = &_peers[0];
+      for (Peer& q : _peers) {
+        if ((int32_t)(q.lastSeenMs - p->lastSeenMs) < 0) p = &q;
+      }
+    }
+    memset(p, 0, sizeof(*p));
+    p->used = true;
+    p->id = id;
+  }
+  p->session = session;
+  p->maxSeq = seq;
+  p->window = 1;
+  p->ackNext = 0;
+  memset(p->ackSeq, 0, sizeof(p->ackSeq));
+  return p;
+}
+
+bool LanLink::acceptSeq(Peer& p, uint32_t seq) {
+  if (seq > p.maxSeq) {
+    uint32_t shift = seq - p.maxSeq;
+    p.window = shift >= 32 ? 1 : (p.window << shift) | 1;
+    p.maxSeq = seq;
+    return true;
+  }
+  uint32_t back = p.maxSeq - seq;
+  if (back >= 32 || (p.window & (1u << back))) return false;
+  p.window |= 1u << back;
+  return true;
+}
+
+void LanLink::onDatagram(const uint8_t* d, size_t len, uint32_t ip, uint16_t port,
+                         uint32_t nowMs, uint32_t epoch) {
+  if (!_ready || len < LANLINK_HEADER_LEN + LANLINK_TAG_LEN) return;
+  if (d[0] != 'R' || d[1] != 'B' || d[2] != 'L' || d[3] != LANLINK_VERSION) return;
+
+  uint8_t  type = d[4];
+  uint8_t  flags = d[5];
+  uint16_t n = get16(d + 6);
+  if (n > LANLINK_MAX_PAYLOAD || len != (size_t)LANLINK_HEADER_LEN + n + LANLINK_TAG_LEN) return;
+
+  uint32_t senderId = get32(d + 12);
+  if (senderId == _id) return;                 // eco do próprio multicast
+  if (get32(d + 8) != _keyId) {
+    _stats.foreign++;
+    return;
+  }
+
+  uint8_t tag[RBS_SHA256_LEN];
+  rbsHmacSha256(_key, _cfg.keyLen, d, LANLINK_HEADER_LEN + n, tag);
+  if (!rbsDigestEqual(tag, d + LANLINK_HEADER_LEN + n, LANLINK_TAG_LEN)) {
+    _stats.authFailures++;
+    return;
+  }
+
+  uint32_t session = get32(d + 16);
+  uint32_t seq = get32(d + 20);
+  uint32_t sentMs = get32(d + 24);
+  uint32_t theirEpoch = get32(d + 28);
+  if (epoch >= EPOCH_SYNCED && theirEpoch >= EPOCH_SYNCED &&
+      (theirEpoch > epoch ? theirEpoch - epoch : epoch - theirEpoch) > LANLINK_MAX_SKEW_S) {
+    _stats.replays++;
+    return;
+  }
+
+  Peer* p = peerById(senderId);
+  bool isNew = !p;
+  if (p && p->session != session && !sessionIsNewer(*p, session, theirEpoch)) {
+    _stats.replays++;
+    return;
+  }
+  if (!p || p->session != session) {
+    p = admitPeer(senderId, session, seq);
+  } else if (!acceptSeq(*p, seq)) {
+    // Retransmissão de algo já executado (o ACK se perdeu): repete o ACK
+    // guardado, sem executar de novo
+    if (flags & FLAG_ACK_REQ) {
+      for (uint8_t i = 0; i < 4; i++) {
+        if (p->ackSeq[i] == seq) {
+          _stats.duplicates++;
+          sendAck(*p, seq, sentMs, p->ackStatus[i], nowMs, epoch);
+          return;
+        }
+      }
+    }
+    _stats.replays++;
+    return;
+  }
+  p->ip = ip;
+  p->port = port;
+  p->lastSeenMs = nowMs;
+  if (theirEpoch >= EPOCH_SYNCED && theirEpoch > p->lastEpoch) p->lastEpoch = theirEpoch;
+  _stats.received++;
+
+  const uint8_t* pl = d + LANLINK_HEADER_LEN;
+  uint8_t status = ACK_OK;
+  switch (type) {
+    case MSG_ANNOUNCE:
+      if (n >= 2 && pl[1] < sizeof(p->uid) && 2u + pl[1] <= n) {
+        bool known = p->role != 0;
+        p->role = pl[0];
+        memcpy(p->uid, pl + 2, pl[1]);
+        p->uid[pl[1]] = 0;
+        if (!known) {
+          rbsLog("[LanLink] Par %s (%s) em %lu.%lu.%lu.%lu", p->uid,
+                 p->role == ROLE_DOSER ? "dosadora" : "monitor",
+                 (unsigned long)(ip >> 24), (unsigned long)(ip >> 16 & 0xff),
+                 (unsigned long)(ip >> 8 & 0xff), (unsigned long)(ip & 0xff));
+        }
+      }
+      if (flags & FLAG_REPLY_ANNOUNCE) sendAnnounce(ip, port, false, nowMs, epoch);
+      return;
+
+    case MSG_MEASUREMENT: {
+      if (n < 8) return;
+      uint32_t bits = get32(pl);
+      float kh;
+      memcpy(&kh, &bits, sizeof(kh));
+      if (_h.onMeasurement) _h.onMeasurement(_h.ctx, *p, kh, get32(pl + 4));
+      break;
+    }
+
+    case MSG_DOSE_REQUEST:
+      if (n < 9) return;
+      status = _h.onDose ? _h.onDose(_h.ctx, *p, get32(pl), pl[4], get32(pl + 5) / 100.0f) : (uint8_t)ACK_REJECTED;
+      break;
+
+    case MSG_ACK:
+      handleAck(*p, pl, (uint8_t)n, nowMs);
+      return;
+
+    default:
+      return;
+  }
+
+  // Par que só conhecemos por mensagem de dados (reboot nosso): pede o
+  // ANNOUNCE dele para saber o papel
+  if (isNew) sendAnnounce(ip, port, true, nowMs, epoch);
+
+  if (flags & FLAG_ACK_REQ) {
+    p->ackSeq[p->ackNext] = seq;
+    p->ackStatus[p->ackNext] = status;
+    p->ackNext = (p->ackNext + 1) & 3;
+    sendAck(*p, seq, sentMs, status, nowMs, epoch);
+  }
+}
+
+void LanLink::handleAck(const Peer& p, const uint8_t* pl, uint8_t len, uint32_t nowMs) {
+  if (len < 9) return;
+  uint32_t seq = get32(pl);
+  for (Pending& q : _pending) {
+    if (!q.used || q.peerId != p.id || q.seq != seq) continue;
+    q.used = false;
+    uint32_t rtt = nowMs - get32(pl + 4);
+    _stats.acked++;
+    _stats.lastRttMs = rtt;
+    _stats.avgRttMs = _stats.acked == 1 ? rtt : _stats.avgRttMs + ((int32_t)(rtt - _stats.avgRttMs) / 8);
+    if (rtt > _stats.maxRttMs) _stats.maxRttMs = rtt;
+    if (_h.onResult) _h.onResult(_h.ctx, q.type, q.ref, RESULT_ACKED, pl[8], rtt);
+    return;
+  }
+}
@@ -0,0 +1,194 @@
+//LanLink.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * LanLink - canal direto monitor de KH <-> dosadora na rede local
+ *
+ * Hoje uma correção de KH faz monitor -> nuvem -> backend -> long-poll da
+ * dosadora: depende da internet e do backend no ar. Aqui os dois se acham
+ * por UDP multicast (ANNOUNCE no grupo LANLINK_GROUP_IP a cada 30 s) e
+ * trocam datagramas unicast:
+ *
+ *   MEASUREMENT   monitor -> dosadora, resultado de cada medição
+ *   DOSE_REQUEST  monitor -> dosadora, dose numa bomba (id da requisição)
+ *   ACK           resposta a tudo que pede confirmação, ecoando o sentMs
+ *                 do remetente: RTT medido no relógio de quem enviou
+ *
+ * Datagrama (little-endian), 32 bytes de cabeçalho + payload + tag:
+ *   0  "RBL" versão     4  tipo   5  flags   6  tamanho do payload (u16)
+ *   8  keyId            12 senderId (FNV-1a do uid)    16 sessão (por boot)
+ *   20 seq              24 sentMs (millis do remetente) 28 epoch UTC (s)
+ *   32 payload          .. HMAC-SHA256(chave, tudo antes) truncado em 16
+ *
+ * A chave é a mesma para os aparelhos de um usuário (o backend deriva e
+ * entrega a cada aparelho autenticado com o token dele); keyId diferente
+ * = aparelho de outro usuário na mesma rede, ignorado em silêncio.
+ * Replay: janela de 32 seqs por sessão do par; todo datagrama precisa de
+ * epoch a até LANLINK_MAX_SKEW_S do nosso. Sessão nova (reboot do par) só
+ * é aceita se não for uma das LANLINK_OLD_SESSIONS anteriores dele e, com
+ * os dois relógios sincronizados, se o epoch não for mais velho que o
+ * último recebido do par: alternar capturas de sessões diferentes não
+ * zera mais a janela. Retransmissão com o mesmo seq: o receptor não
+ * executa de novo, só repete o ACK guardado.
+ *
+ * Sem socket aqui: quem usa entrega os datagramas recebidos em
+ * onDatagram() e envia pelo Handlers::send (WiFiUDP no firmware, socket
+ * POSIX no host). Sem heap.
+ */
+
+#define LANLINK_PORT           41900
+#define LANLINK_GROUP_IP       0xEFFF5242u   // 239.255.82.66
+#define LANLINK_MAX_PEERS      4
+#define LANLINK_MAX_PENDING    4
+#define LANLINK_HEADER_LEN     32
+#define LANLINK_TAG_LEN        16
+#define LANLINK_MAX_PAYLOAD    40
+#define LANLINK_MAX_DATAGRAM   (LANLINK_HEADER_LEN + LANLINK_MAX_PAYLOAD + LANLINK_TAG_LEN)
+#define LANLINK_KEY_MAX        32
+#define LANLINK_OLD_SESSIONS   4          // sessões anteriores lembradas por par
+
+#define LANLINK_RETRY_MS       150UL      // retransmissão sem ACK...
+#define LANLINK_TRIES          6          // ...até desistir (~0,9 s): cai para a nuvem
+#define LANLINK_ANNOUNCE_MS    30000UL
+#define LANLINK_PEER_TTL_MS    120000UL   // 4 ANNOUNCEs perdidos
+#define LANLINK_MAX_SKEW_S     120
+
+class LanLink {
+public:
+  enum Role : uint8_t { ROLE_MONITOR = 1, ROLE_DOSER = 2 };
+  enum MsgType : uint8_t { MSG_ANNOUNCE = 1, MSG_MEASUREMENT = 2, MSG_DOSE_REQUEST = 3, MSG_ACK = 4 };
+  enum AckStatus : uint8_t { ACK_OK = 0, ACK_BUSY = 1, ACK_REJECTED = 2 };
+  enum Result : uint8_t { RESULT_ACKED = 0, RESULT_TIMEOUT = 1 };
+
+  struct Peer {
+    bool     used;
+    uint32_t id;
+    uint32_t ip;          // ordem de host
+    uint16_t port;
+    uint8_t  role;
+    char     uid[32];
+    uint32_t session;
+    uint32_t maxSeq;
+    uint32_t window;      // bit i = maxSeq - i já visto
+    uint32_t oldSessions[LANLINK_OLD_SESSIONS];   // sessões encerradas: datagrama delas = replay
+    uint32_t lastEpoch;   // maior epoch sincronizado recebido do par
+    uint32_t lastSeenMs;
+    uint32_t ackSeq[4];   // últimos ACKs enviados (para repetir em retransmissões)
+    uint8_t  ackStatus[4];
+    uint8_t  ackNext;
+  };
+
+  struct Stats {
+    uint32_t sent;          // mensagens com ACK (primeira transmissão)
+    uint32_t retransmits;
+    uint32_t acked;
+    uint32_t timeouts;
+    uint32_t received;      // mensagens autenticadas recebidas
+    uint32_t duplicates;
+    uint32_t authFailures;
+    uint32_t replays;       // seq repetido/antigo, sessão antiga ou epoch fora da janela
+    uint32_t foreign;       // keyId de outro usuário
+    uint32_t lastRttMs;
+    uint32_t avgRttMs;      // média móvel (1/8)
+    uint32_t maxRttMs;
+  };
+
+  // Envio de um datagrama (ip/porta em ordem de host)
+  typedef void (*SendFn)(void* ctx, uint32_t ip, uint16_t port, const uint8_t* data, size_t len);
+  // Dosadora: medição recebida
+  typedef void (*MeasurementFn)(void* ctx, const Peer& from, float kh, uint32_t measuredAt);
+  // Dosadora: pedido de dose; devolve o AckStatus mandado ao monitor
+  typedef uint8_t (*DoseFn)(void* ctx, const Peer& from, uint32_t requestId, uint8_t pumpIndex, float volumeMl);
+  // Monitor: desfecho de uma mensagem com ACK (ref = measuredAt ou requestId)
+  typedef void (*ResultFn)(void* ctx, uint8_t type, uint32_t ref, uint8_t result, uint8_t ackStatus, uint32_t rttMs);
+
+  struct Handlers {
+    SendFn        send = nullptr;
+    MeasurementFn onMeasurement = nullptr;
+    DoseFn        onDose = nullptr;
+    ResultFn      onResult = nullptr;
+    void*         ctx = nullptr;
+  };
+
+  struct Config {
+    uint8_t        role = ROLE_MONITOR;
+    const char*    uid = "";
+    const uint8_t* key = nullptr;
+    size_t         keyLen = 0;
+    uint32_t       session = 0;       // aleatório a cada boot
+    uint16_t       port = LANLINK_PORT;
+  };
+
+  bool begin(const Config& cfg, const Handlers& h);
+  void end() { _ready = false; }
+  bool ready() const { return _ready; }
+
+  // Chamar a cada volta do loop: ANNOUNCE, retransmissões, pares expirados
+  void loop(uint32_t nowMs, uint32_t epoch);
+
+  // Datagrama recebido na porta do LanLink (unicast ou do grupo)
+  void onDatagram(const uint8_t* data, size_t len, uint32_t ip, uint16_t port,
+                  uint32_t nowMs, uint32_t epoch);
+
+  // Monitor -> todas as dosadoras conhecidas; false = nenhuma na rede
+  bool publishMeasurement(float kh, uint32_t measuredAt, uint32_t nowMs, uint32_t epoch);
+
+  // Monitor -> dosadora vista por último; false = sem dosadora ou fila
+  // cheia (usar a nuvem na hora). O desfecho chega no onResult.
+  bool requestDose(uint32_t requestId, uint8_t pumpIndex, float volumeMl,
+                   uint32_t nowMs, uint32_t epoch);
+
+  const Peer* findPeer(uint8_t role) const;
+  uint8_t peerCount() const;
+  const Stats& stats() const { return _stats; }
+  uint32_t keyId() const { return _keyId; }
+
+  // Primeiros 4 bytes do SHA-256 da chave
+  static uint32_t keyIdFor(const uint8_t* key, size_t len);
+  static uint32_t idFor(const char* uid);
+
+private:
+  struct Pending {
+    bool     used;
+    uint8_t  type;
+    uint32_t peerId;
+    uint32_t seq;
+    uint32_t ref;
+    uint8_t  payload[LANLINK_MAX_PAYLOAD];
+    uint8_t  payloadLen;
+    uint32_t firstMs;
+    uint32_t lastMs;
+    uint8_t  tries;
+  };
+
+  size_t encode(uint8_t* out, uint8_t type, uint8_t flags, uint32_t seq,
+                const uint8_t* payload, uint8_t payloadLen, uint32_t nowMs, uint32_t epoch) const;
+  void   sendTo(uint32_t ip, uint16_t port, uint8_t type, uint8_t flags, uint32_t seq,
+                const uint8_t* payload, uint8_t payloadLen, uint32_t nowMs, uint32_t epoch);
+  void   sendAnnounce(uint32_t ip, uint16_t port, bool askReply, uint32_t nowMs, uint32_t epoch);
+  void   sendAck(const Peer& p, uint32_t seq, uint32_t echoMs, uint8_t status, uint32_t nowMs, uint32_t epoch);
+  bool   enqueue(const Peer& p, uint8_t type, uint32_t ref, const uint8_t* payload, uint8_t len,
+                 uint32_t nowMs, uint32_t epoch);
+  void   transmit(Pending& q, uint32_t nowMs, uint32_t epoch);
+  Peer*  peerById(uint32_t id);
+  Peer*  admitPeer(uint32_t id, uint32_t session, uint32_t seq);
+  bool   sessionIsNewer(const Peer& p, uint32_t session, uint32_t theirEpoch) const;
+  bool   acceptSeq(Peer& p, uint32_t seq);
+  void   handleAck(const Peer& p, const uint8_t* payload, uint8_t len, uint32_t nowMs);
+
+  bool     _ready = false;
+  Config   _cfg;
+  Handlers _h;
+  uint8_t  _key[LANLINK_KEY_MAX];
+  uint32_t _keyId = 0;
+  uint32_t _id = 0;
+  uint32_t _seq = 0;
+  uint32_t _lastAnnounceMs = 0;
+  bool     _announced = false;
+  Peer     _peers[LANLINK_MAX_PEERS];
+  Pending  _pending[LANLINK_MAX_PENDING];
+  Stats    _stats;
+};
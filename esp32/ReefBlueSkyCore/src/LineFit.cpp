@@ -0,0 +1,304 @@
+#include "LineFit.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+namespace {
+
+const size_t   ENUM_CAP    = 2 * FIT_MAX_POINTS;   // inclinações enumeradas por vez
+const float    MAD_TO_SD   = 1.4826f;              // MAD -> desvio padrão (normal)
+const float    HUBER_C     = 1.345f;               // 95% de eficiência com ruído normal
+const int      HUBER_ITERS = 20;
+
+// Pontos em ordem de x (y decrescente no empate)
+struct Points {
+    float    x[FIT_MAX_POINTS];
+    float    y[FIT_MAX_POINTS];
+    size_t   n;
+    uint32_t tiePairs;   // pares com x igual (sem inclinação)
+    uint32_t pairs;      // pares com inclinação
+};
+
+uint32_t xorshift(uint32_t& s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+float medianOf(float* v, size_t n) {
+    size_t mid = n / 2;
+    std::nth_element(v, v + mid, v + n);
+    float m = v[mid];
+    if (n % 2 == 0) {
+        m = 0.5f * (m + *std::max_element(v, v + mid));
+    }
+    return m;
+}
+
+// Merge sort (estável, sem recursão) de ord pela chave; conta os pares
+// (p antes de q na ordem de entrada) com key[p] >= key[q]. Com List, chama
+// list(p, q) para cada um desses pares.
+template <bool List, typename Fn>
+uint32_t mergeInversions(uint8_t* ord, uint8_t* tmp, const float* key, size_t n, Fn list) {
+    uint32_t inv = 0;
+    for (size_t width = 1; width < n; width *= 2) {
+        for (size_t lo = 0; lo < n; lo += 2 * width) {
+            size_t mid = std::min(lo + width, n);
+            size_t hi  = std::min(lo + 2 * width, n);
+            size_t i = lo, j = mid, k = lo;
+            while (i < mid && j < hi) {
+                if (key[ord[j]] <= key[ord[i]]) {
+                    // ord[j] passa à frente de todos os que sobraram à esquerda
+                    if (List) {
+                        for (size_t t = i; t < mid; t++) list(ord[t], ord[j]);
+                    }
+                    inv += uint32_t(mid - i);
+                    tmp[k++] = ord[j++];
+                } else {
+                    tmp[k++] = ord[i++];
+                }
+            }
+            while (i < mid) tmp[k++] = ord[i++];
+            while (j < hi)  tmp[k++] = ord[j++];
+        }
+        memcpy(ord, tmp, n);
+    }
+    return inv;
+}
+
+// Quantas inclinações são <= t. Em ordem de x, inclinação(i, j) <= t
+// equivale a u_i >= u_j com u = y - t·x: é contar inversões de u.
+uint32_t countAtMost(const Points& p, float t) {
+    float   u[FIT_MAX_POINTS];
+    uint8_t ord[FIT_MAX_POINTS], tmp[FIT_MAX_POINTS];
+    for (size_t i = 0; i < p.n; i++) {
+        u[i]   = p.y[i] - t * p.x[i];
+        ord[i] = uint8_t(i);
+    }
+    uint32_t inv = mergeInversions<false>(ord, tmp, u, p.n, [](uint8_t, uint8_t) {});
+    return inv - p.tiePairs;   // empates em x (y decrescente) sempre contam
+}
+
+// Inclinações em (lo, hi] para out (até cap). Em ordem de a = y - lo·x,
+// os pares do intervalo são exatamente as inversões de b = y - hi·x.
+size_t enumerateBetween(const Points& p, float lo, float hi, float* out, size_t cap) {
+    float   a[FIT_MAX_POINTS], b[FIT_MAX_POINTS];
+    uint8_t ord[FIT_MAX_POINTS], tmp[FIT_MAX_POINTS];
+    for (size_t i = 0; i < p.n; i++) {
+        a[i]   = p.y[i] - lo * p.x[i];
+        b[i]   = p.y[i] - hi * p.x[i];
+        ord[i] = uint8_t(i);
+    }
+    // Empate em a = inclinação igual a lo (fora do intervalo): x maior antes
+    std::sort(ord, ord + p.n, [&](uint8_t i, uint8_t j) {
+        return a[i] < a[j] || (a[i] == a[j] && p.x[i] > p.x[j]);
+    });
+
+    size_t m = 0;
+    mergeInversions<true>(ord, tmp, b, p.n, [&](uint8_t i, uint8_t j) {
+        if (p.x[i] == p.x[j] || m >= cap) return;
+        float s = (p.y[j] - p.y[i]) / (p.x[j] - p.x[i]);
+        if (s > lo && s <= hi) out[m++] = s;
+    });
+    return m;
+}
+
+// k-ésima menor inclinação (k a partir de 0)
+float selectSlope(const Points& p, uint32_t k, uint32_t& rng) {
+    float buf[ENUM_CAP];
+
+    // Poucos pares: enumera tudo
+    if (p.pairs <= ENUM_CAP) {
+        size_t m = 0;
+        for (size_t i = 0; i < p.n; i++) {
+            for (size_t j = i + 1; j < p.n; j++) {
+                if (p.x[j] != p.x[i]) buf[m++] = (p.y[j] - p.y[i]) / (p.x[j] - p.x[i]);
+            }
+        }
+        std::nth_element(buf, buf + k, buf + m);
+        return buf[k];
+    }
+
+    // Amostra de pares -> intervalo [lo, hi] que deve conter a k-ésima
+    size_t r = 0;
+    for (size_t tries = 0; r < ENUM_CAP && tries < 8 * ENUM_CAP; tries++) {
+        size_t i = xorshift(rng) % p.n, j = xorshift(rng) % p.n;
+        if (p.x[i] == p.x[j]) continue;
+        buf[r++] = (p.y[j] - p.y[i]) / (p.x[j] - p.x[i]);
+    }
+    if (r == 0) return 0;
+    std::sort(buf, buf + r);
+    double pos = double(k) * r / p.pairs;
+    int d = int(1.5 * sqrt(double(r))) + 1;
+    float lo = buf[std::max(0, int(pos) - d)];
+    float hi = buf[std::min(int(r) - 1, int(pos) + d)];
+
+    uint32_t cLo = countAtMost(p, lo), cHi = countAtMost(p, hi);
+    float span = (hi - lo) + fabsf(hi) * 1e-6f + 1e-9f;
+    for (int i = 0; i < 30 && cLo > k; i++, span *= 2) { lo -= span; cLo = countAtMost(p, lo); }
+    for (int i = 0; i < 30 && cHi <= k; i++, span *= 2) { hi += span; cHi = countAtMost(p, hi); }
+
+    // Amostra ruim (raro): estreita por bisseção até caber no buffer
+    for (int i = 0; i < 64 && cHi - cLo > ENUM_CAP; i++) {
+        float mid = lo + 0.5f * (hi - lo);
+        if (!(mid > lo && mid < hi)) break;
+        uint32_t c = countAtMost(p, mid);
+        if (c > k) { hi = mid; cHi = c; } else { lo = mid; cLo = c; }
+    }
+    if (cHi - cLo > ENUM_CAP) return hi;   // muitas inclinações (quase) iguais
+
+    size_t m = enumerateBetween(p, lo, hi, buf, ENUM_CAP);
+    if (m == 0) return hi;
+    size_t idx = std::min<size_t>(k >= cLo ? k - cLo : 0, m - 1);
+    std::nth_element(buf, buf + idx, buf + m);
+    return buf[idx];
+}
+
+void sortPoints(const float* x, const float* y, size_t n, Points& p) {
+    uint8_t ord[FIT_MAX_POINTS];
+    for (size_t i = 0; i < n; i++) ord[i] = uint8_t(i);
+    std::sort(ord, ord + n, [&](uint8_t i, uint8_t j) {
+        return x[i] < x[j] || (x[i] == x[j] && y[i] > y[j]);
+    });
+    p.n = n;
+    p.tiePairs = 0;
+    size_t run = 1;
+    for (size_t i = 0; i < n; i++) {
+        p.x[i] = x[ord[i]];
+        p.y[i] = y[ord[i]];
+        if (i > 0 && p.x[i] == p.x[i - 1]) {
+            p.tiePairs += uint32_t(run);
+            run++;
+        } else {
+            run = 1;
+        }
+    }
+    p.pairs = uint32_t(n * (n - 1) / 2) - p.tiePairs;
+}
+
+// Intercepto, escala e R² dos ajustes robustos a partir da inclinação
+void finishRobust(const float* x, const float* y, size_t n, LineFit& f, bool fitIntercept) {
+    float r[FIT_MAX_POINTS];
+    if (fitIntercept) {
+        for (size_t i = 0; i < n; i++) r[i] = y[i] - f.slope * x[i];
+        f.intercept = medianOf(r, n);
+    }
+    for (size_t i = 0; i < n; i++) r[i] = fabsf(y[i] - f.predict(x[i]));
+    f.scale = MAD_TO_SD * medianOf(r, n);
+
+    // R² só dos pontos perto da reta: um ponto fora não derruba a confiança
+    float limit = 3.0f * std::max(f.scale, 1e-6f);
+    double sumY = 0;
+    int    in   = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (fabsf(y[i] - f.predict(x[i])) <= limit) { sumY += y[i]; in++; }
+    }
+    double meanY = in ? sumY / in : 0, ssTot = 0, ssRes = 0;
+    for (size_t i = 0; i < n; i++) {
+        double res = y[i] - f.predict(x[i]);
+        if (fabs(res) > limit) continue;
+        ssTot += (y[i] - meanY) * (y[i] - meanY);
+        ssRes += res * res;
+    }
+    f.rSquared = ssTot > 0 ? std::min(std::max(float(1.0 - ssRes / ssTot), 0.0f), 1.0f) : 0.0f;
+}
+
+} // namespace
+
+float studentT975(int dof) {
+    static const float table[30] = {
+        12.706f, 4.303f, 3.182f, 2.776f, 2.571f, 2.447f, 2.365f, 2.306f, 2.262f, 2.228f,
+        2.201f,  2.179f, 2.160f, 2.145f, 2.131f, 2.120f, 2.110f, 2.101f, 2.093f, 2.086f,
+        2.080f,  2.074f, 2.069f, 2.064f, 2.060f, 2.056f, 2.052f, 2.048f, 2.045f, 2.042f,
+    };
+    if (dof < 1) return 0;
+    if (dof <= 30) return table[dof - 1];
+    return 1.96f + 2.4f / dof;   // erro < 0,003 acima de 30
+}
+
+float LineFit::halfInterval(float x) const {
+    if (n < 3 || sxx <= 0) return 0;
+    float dx = x - xMean;
+    return studentT975(n - 2) * scale * sqrtf(1.0f + 1.0f / n + dx * dx / sxx);
+}
+
+float theilSenSlope(const float* x, const float* y, size_t n) {
+    if (n < 2 || n > FIT_MAX_POINTS) return 0;
+    Points p;
+    sortPoints(x, y, n, p);
+    if (p.pairs == 0) return 0;
+
+    uint32_t rng = 0x9E3779B9u;
+    uint32_t kLo = (p.pairs - 1) / 2, kHi = p.pairs / 2;
+    float s = selectSlope(p, kLo, rng);
+    if (kHi != kLo) s = 0.5f * (s + selectSlope(p, kHi, rng));
+    return s;
+}
+
+bool fitLine(FitMethod method, const float* x, const float* y, size_t n, LineFit& f) {
+    if (n < 2 || n > FIT_MAX_POINTS) return false;
+
+    // Em double e com x centrado (ver KHPredictor: em float Σx² perde precisão)
+    double mx = 0, my = 0;
+    for (size_t i = 0; i < n; i++) { mx += x[i]; my += y[i]; }
+    mx /= n;
+    my /= n;
+    double sxx = 0, sxy = 0, syy = 0;
+    for (size_t i = 0; i < n; i++) {
+        double dx = x[i] - mx, dy = y[i] - my;
+        sxx += dx * dx;
+        sxy += dx * dy;
+        syy += dy * dy;
+    }
+    if (sxx <= 0) return false;
+
+    f.n     = int(n);
+    f.xMean = float(mx);
+    f.sxx   = float(sxx);
+
+    if (method == FIT_OLS) {
+        double b = sxy / sxx;
+        double ssr = std::max(syy - b * sxy, 0.0);
+        f.slope     = float(b);
+        f.intercept = float(my - b * mx);
+        f.scale     = n > 2 ? float(sqrt(ssr / (n - 2))) : 0.0f;
+        f.rSquared  = syy > 0 ? std::min(std::max(float(1.0 - ssr / syy), 0.0f), 1.0f) : 0.0f;
+        return true;
+    }
+
+    f.slope = theilSenSlope(x, y, n);
+    finishRobust(x, y, n, f, true);
+    if (method == FIT_THEIL_SEN) return true;
+
+    // Huber: mínimos quadrados ponderados, pesos recalculados a cada volta
+    float r[FIT_MAX_POINTS];
+    for (int it = 0; it < HUBER_ITERS; it++) {
+        for (size_t i = 0; i < n; i++) r[i] = fabsf(y[i] - f.predict(x[i]));
+        float s = MAD_TO_SD * medianOf(r, n);
+        if (s <= 1e-6f) break;   // ajuste exato na maioria dos pontos
+        float c = HUBER_C * s;
+
+        double sw = 0, swx = 0, swy = 0, swxx = 0, swxy = 0;
+        for (size_t i = 0; i < n; i++) {
+            double res = fabs(y[i] - f.predict(x[i]));
+            double w = res <= c ? 1.0 : c / res;
+            double dx = x[i] - mx;
+            sw   += w;
+            swx  += w * dx;
+            swy  += w * y[i];
+            swxx += w * dx * dx;
+            swxy += w * dx * y[i];
+        }
+        double den = sw * swxx - swx * swx;
+        if (den <= 0) break;
+        double b = (sw * swxy - swx * swy) / den;
+        double a = (swy - b * swx) / sw - b * mx;   // volta de x centrado
+        bool done = fabs(b - f.slope) < 1e-7 * (1 + fabs(b)) && fabs(a - f.intercept) < 1e-6;
+        f.slope     = float(b);
+        f.intercept = float(a);
+        if (done) break;
+    }
+    finishRobust(x, y, n, f, false);
+    return true;
+}
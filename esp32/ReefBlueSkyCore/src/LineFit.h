@@ -0,0 +1,67 @@
+#ifndef LINE_FIT_H
+#define LINE_FIT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Ajuste de reta y = a + b·x para as séries de KH (x em horas)
+ *
+ *   FIT_OLS        mínimos quadrados; um ponto ruim (bolha no eletrodo de
+ *                  pH) puxa a reta inteira
+ *   FIT_THEIL_SEN  inclinação = mediana das inclinações de todos os pares,
+ *                  intercepto = mediana de y - b·x. Aguenta ~29% de pontos
+ *                  ruins. A mediana sai em O(n log n) esperado: amostra de
+ *                  pares dá um intervalo candidato, contagem de inversões
+ *                  (merge sort) confere/estreita o intervalo e só os pares
+ *                  dentro dele são enumerados
+ *   FIT_HUBER      IRLS com pesos de Huber (c = 1,345·escala), partindo do
+ *                  Theil-Sen; perto do OLS com ruído normal, robusto a
+ *                  pontos fora da curva
+ *
+ * Intervalo de predição (95%): t(n-2) · escala · √(1 + 1/n + (x0 - x̄)²/Sxx).
+ * No OLS a escala é o desvio dos resíduos; nos robustos é 1,4826·MAD dos
+ * resíduos (aproximação: a fórmula é a do OLS com escala robusta).
+ *
+ * Sem heap: trabalho na pilha, até FIT_MAX_POINTS pontos (~3 KB).
+ */
+
+enum FitMethod : uint8_t {
+    FIT_OLS = 0,
+    FIT_THEIL_SEN,
+    FIT_HUBER
+};
+
+static constexpr size_t FIT_MAX_POINTS = 128;
+
+struct LineFit {
+    float intercept;   // y em x = 0
+    float slope;       // unidade de y por unidade de x
+    float xMean;
+    float sxx;         // Σ(x - x̄)²
+    float scale;       // desvio dos resíduos (robusto: 1,4826·MAD)
+    float rSquared;    // robusto: R² dos pontos a até 3·escala da reta
+    int   n;
+
+    float predict(float x) const { return intercept + slope * x; }
+
+    // Meia largura do intervalo de predição de 95% em x (0 com n < 3)
+    float halfInterval(float x) const;
+};
+
+/**
+ * Ajustar reta aos pontos (x não precisa estar ordenado)
+ * @return false com n < 2, n > FIT_MAX_POINTS ou todos os x iguais
+ */
+bool fitLine(FitMethod method, const float* x, const float* y, size_t n, LineFit& out);
+
+/**
+ * Mediana das inclinações (y_j - y_i)/(x_j - x_i) dos pares com x diferente
+ * (média das duas centrais se o número de pares for par)
+ */
+float theilSenSlope(const float* x, const float* y, size_t n);
+
+// Quantil 97,5% da t de Student (tabela até 30 graus de liberdade)
+float studentT975(int dof);
+
+#endif // LINE_FIT_H
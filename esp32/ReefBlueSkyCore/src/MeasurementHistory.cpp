@@ -0,0 +1,596 @@
+//MeasurementHistory.cpp
+
+#include "MeasurementHistory.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Abaixo disso o timestamp não é epoch em ms (NTP falhou, veio de millis())
+static constexpr uint64_t MIN_EPOCH_MS = 1000000000000ULL;
+
+// [RANGE] Junta as linhas da exportação em blocos antes de mandar para o
+// destino: um write() por bloco, não por campo
+class ChunkWriter {
+public:
+    ChunkWriter(RbsPrint& out, char* buf, size_t cap) : _out(out), _buf(buf), _cap(cap) {}
+
+    void write(const char* s, size_t n) {
+        if (_len + n > _cap) flush();
+        if (n > _cap) {
+            _total += _out.write((const uint8_t*)s, n);
+            return;
+        }
+        memcpy(_buf + _len, s, n);
+        _len += n;
+    }
+    void write(const char* s) { write(s, strlen(s)); }
+
+    void flush() {
+        if (_len) _total += _out.write((const uint8_t*)_buf, _len);
+        _len = 0;
+    }
+
+    size_t total() const { return _total; }
+
+private:
+    RbsPrint& _out;
+    char*  _buf;
+    size_t _cap;
+    size_t _len = 0;
+    size_t _total = 0;
+};
+
+// exportAsJSON/CSV: mesmo writer, destino std::string
+class StringPrint : public RbsPrint {
+public:
+    explicit StringPrint(std::string& s) : _s(s) {}
+    size_t write(uint8_t c) override { _s += (char)c; return 1; }
+    size_t write(const uint8_t* b, size_t n) override {
+        _s.append((const char*)b, n);
+        return n;
+    }
+private:
+    std::string& _s;
+};
+
+// [BOOT] Leitura do /history.json sem ArduinoJson: o arquivo é o que
+// writeJSON grava (ou o JsonDoc das versões antigas), um array de objetos
+// planos. Cada objeto é lido sozinho num buffer pequeno.
+static constexpr size_t MAX_OBJECT = 256;
+
+static void skipSpaces(RbsStream& in) {
+    int c = in.peek();
+    while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+        in.read();
+        c = in.peek();
+    }
+}
+
+// Consome até depois de text (como Stream::find)
+static bool skipPast(RbsStream& in, const char* text) {
+    size_t matched = 0, len = strlen(text);
+    int c;
+    while ((c = in.read()) >= 0) {
+        if (c == text[matched]) {
+            if (++matched == len) return true;
+        } else {
+            matched = (c == text[0]) ? 1 : 0;
+        }
+    }
+    return false;
+}
+
+// Copia "{...}" para out; false se o objeto não fecha ou não cabe
+static bool readObject(RbsStream& in, char* out, size_t cap) {
+    size_t n = 0;
+    int c;
+    while ((c = in.read()) >= 0) {
+        if (n + 1 >= cap) return false;
+        out[n++] = (char)c;
+        if (c == '}') {
+            out[n] = '\0';
+            return true;
+        }
+    }
+    return false;
+}
+
+// Valor cru do campo "key" no objeto (nullptr se não existe)
+static const char* fieldValue(const char* obj, const char* key) {
+    char quoted[24];
+    snprintf(quoted, sizeof(quoted), "\"%s\"", key);
+    const char* p = strstr(obj, quoted);
+    if (!p) return nullptr;
+    p = strchr(p + strlen(quoted), ':');
+    if (!p) return nullptr;
+    p++;
+    while (*p == ' ') p++;
+    return p;
+}
+
+static float fieldFloat(const char* obj, const char* key) {
+    const char* v = fieldValue(obj, key);
+    return v ? strtof(v, nullptr) : 0.0f;
+}
+
+static bool parseMeasurement(const char* obj, MeasurementHistory::Measurement& m) {
+    if (!strchr(obj, '{')) return false;
+    const char* ts = fieldValue(obj, "timestamp");
+    const char* valid = fieldValue(obj, "valid");
+    m.kh          = fieldFloat(obj, "kh");
+    m.ph_ref      = fieldFloat(obj, "ph_ref");
+    m.ph_sample   = fieldFloat(obj, "ph_sample");
+    m.temperature = fieldFloat(obj, "temperature");
+    m.timestamp   = ts ? strtoull(ts, nullptr, 10) : 0;
+    m.is_valid    = valid && strncmp(valid, "true", 4) == 0;
+    return true;
+}
+
+MeasurementHistory::MeasurementHistory()
+    : _measurement_interval_minutes(60), _last_measurement_time(0) {
+}
+
+// [BOOT] Inicializar e carregar histórico salvo
+void MeasurementHistory::begin() {
+    rbsLog("[MeasurementHistory] Inicializando histórico de medições");
+    
+    // Montar o sistema de arquivos
+    if (!rbsFsBegin()) {
+        rbsLog("[MeasurementHistory] ERRO: Falha ao inicializar o sistema de arquivos");
+        return;
+    }
+    
+    // [BOOT] Carregar histórico salvo, se existir
+    if (historyExists()) {
+        if (loadFromFile()) {
+            rbsLog("[MeasurementHistory] Histórico carregado: %d medições", (int)_measurements.size());
+            // NOVO: corrigir timestamps antigos em segundos
+            normalizeTimestampsIfNeeded();
+        } else {
+            rbsLog("[MeasurementHistory] AVISO: Falha ao carregar histórico");
+        }
+    } else {
+        rbsLog("[MeasurementHistory] Nenhum histórico anterior encontrado");
+    }
+
+    // [ROLLUP] Sem arquivo (primeiro boot com rollups): reconstrói do histórico
+    if (!loadRollups()) {
+        rebuildRollups();
+        saveRollups();
+    }
+    
+    _last_measurement_time = rbsMillis();
+}
+
+
+// [PERSISTÊNCIA] Adicionar medição e salvar automaticamente
+void MeasurementHistory::addMeasurement(const Measurement& measurement) {
+    bool inOrder = _measurements.empty() || measurement.timestamp >= _measurements.back().timestamp;
+
+    // Cheio: a mais antiga sai do anel
+    _measurements.push(measurement);
+    _last_measurement_time = rbsMillis();
+    addToRollups(measurement);
+
+    // [RANGE] Fora de ordem (ex.: NTP falhou): range() varre até a medição
+    // fora de ordem sair do anel
+    if (!inOrder) {
+        _sorted = false;
+    } else if (!_sorted) {
+        _sorted = checkSorted();
+    }
+
+    rbsLog("[MeasurementHistory] Medição adicionada: KH=%.2f dKH (Total: %d)",
+           measurement.kh, (int)_measurements.size());
+    
+    // [PERSISTÊNCIA] Salvar automaticamente em arquivo
+    if (saveToFile()) {
+        rbsLog("[MeasurementHistory] Medição salva em arquivo");
+    } else {
+        rbsLog("[MeasurementHistory] ERRO: Falha ao salvar medição");
+    }
+    saveRollups();
+}
+
+MeasurementHistory::Measurement MeasurementHistory::getMeasurement(int index) {
+    if (index < 0 || index >= (int)_measurements.size()) {
+        return {0, 0, 0, 0, 0, false};
+    }
+
+    // Retornar em ordem reversa (0 = mais recente)
+    return _measurements[_measurements.size() - 1 - index];
+}
+
+int MeasurementHistory::getCount() {
+    return _measurements.size();
+}
+
+MeasurementHistory::Range MeasurementHistory::range(uint64_t fromMs, uint64_t toMs) const {
+    return Range(_measurements, fromMs, toMs, _sorted);
+}
+
+MeasurementHistory::Range MeasurementHistory::range(TimeFilter filter) const {
+    uint64_t from, to;
+    filterBounds(filter, from, to);
+    return range(from, to);
+}
+
+std::vector<MeasurementHistory::Measurement> MeasurementHistory::getFilteredMeasurements(TimeFilter filter) {
+    Range r = range(filter);
+    std::vector<Measurement> filtered;
+    filtered.reserve(r.size());
+
+    for (const auto& m : r) {
+        filtered.push_back(m);
+    }
+
+    return filtered;
+}
+
+MeasurementHistory::Measurement MeasurementHistory::getLastMeasurement() {
+    if (_measurements.empty()) {
+        return {0, 0, 0, 0, 0, false};
+    }
+
+    return _measurements.back();
+}
+
+// [RESET] Limpar histórico e remover os arquivos
+void MeasurementHistory::clearHistory() {
+    _measurements.clear();
+    _sorted = true;
+    _rollups.clear();
+    
+    // [RESET] Remover arquivo de histórico
+    if (rbsFileExists(HISTORY_FILE)) {
+        rbsFileRemove(HISTORY_FILE);
+        rbsLog("[MeasurementHistory] Arquivo de histórico removido");
+    }
+    if (rbsFileExists(ROLLUP_FILE)) {
+        rbsFileRemove(ROLLUP_FILE);
+    }
+    
+    rbsLog("[MeasurementHistory] Histórico limpo completamente");
+}
+
+void MeasurementHistory::setMeasurementInterval(int minutes) {
+    if (minutes < 60) minutes = 60;      // 1h a 24h
+    if (minutes > 1440) minutes = 1440;
+    _measurement_interval_minutes = minutes;
+    rbsLog("[MeasurementHistory] Intervalo de medição definido: %d minutos", minutes);
+}
+
+int MeasurementHistory::getMeasurementInterval() {
+    return _measurement_interval_minutes;
+}
+
+bool MeasurementHistory::shouldMeasure() {
+    uint32_t now = rbsMillis();
+    uint32_t interval_ms = _measurement_interval_minutes * 60UL * 1000UL;
+
+    return (now - _last_measurement_time) >= interval_ms;
+}
+
+std::string MeasurementHistory::exportAsJSON() {
+    std::string json;
+    json.reserve(_measurements.size() * 110 + 20);
+    StringPrint out(json);
+    writeJSON(out);
+    return json;
+}
+
+std::string MeasurementHistory::exportAsCSV() {
+    std::string csv;
+    csv.reserve(_measurements.size() * 40 + 50);
+    StringPrint out(csv);
+    writeCSV(out);
+    return csv;
+}
+
+size_t MeasurementHistory::writeJSON(RbsPrint& out, uint64_t fromMs, uint64_t toMs) const {
+    char buf[EXPORT_CHUNK];
+    char line[160];
+    ChunkWriter w(out, buf, sizeof(buf));
+    bool first = true;
+
+    w.write("{\"measurements\":[");
+    for (const auto& m : range(fromMs, toMs)) {
+        int n = snprintf(line, sizeof(line),
+                         "%s{\"kh\":%.2f,\"ph_ref\":%.2f,\"ph_sample\":%.2f,"
+                         "\"temperature\":%.1f,\"timestamp\":%llu,\"valid\":%s}",
+                         first ? "" : ",", m.kh, m.ph_ref, m.ph_sample, m.temperature,
+                         (unsigned long long)m.timestamp, m.is_valid ? "true" : "false");
+        w.write(line, (size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1);
+        first = false;
+    }
+    w.write("]}");
+    w.flush();
+    return w.total();
+}
+
+size_t MeasurementHistory::writeCSV(RbsPrint& out, uint64_t fromMs, uint64_t toMs) const {
+    char buf[EXPORT_CHUNK];
+    char line[128];
+    ChunkWriter w(out, buf, sizeof(buf));
+
+    w.write("Timestamp,KH,pH_Ref,pH_Sample,Temperature,Valid\n");
+    for (const auto& m : range(fromMs, toMs)) {
+        int n = snprintf(line, sizeof(line), "%llu,%.2f,%.2f,%.2f,%.1f,%s\n",
+                         (unsigned long long)m.timestamp, m.kh, m.ph_ref, m.ph_sample,
+                         m.temperature, m.is_valid ? "true" : "false");
+        w.write(line, (size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1);
+    }
+    w.flush();
+    return w.total();
+}
+
+std::string MeasurementHistory::getStatistics(TimeFilter filter) {
+    Range r = range(filter);
+
+    if (r.empty()) {
+        return "Sem dados";
+    }
+
+    // Uma passada sobre a visão (Welford), sem copiar medições
+    int count = 0;
+    float mean = 0, m2 = 0, min_kh = 0, max_kh = 0;
+    for (const auto& m : r) {
+        if (!m.is_valid) {
+            continue;
+        }
+        count++;
+        if (count == 1) {
+            min_kh = max_kh = m.kh;
+        }
+        float delta = m.kh - mean;
+        mean += delta / count;
+        m2 += delta * (m.kh - mean);
+        if (m.kh < min_kh) min_kh = m.kh;
+        if (m.kh > max_kh) max_kh = m.kh;
+    }
+
+    if (count == 0) {
+        return "Sem dados válidos";
+    }
+
+    float std_dev = sqrtf(m2 / count);
+
+    char stats[200];
+    snprintf(stats, sizeof(stats),
+             "Estatísticas:\n"
+             "  Média: %.2f dKH\n"
+             "  Desvio Padrão: %.2f\n"
+             "  Mínimo: %.2f dKH\n"
+             "  Máximo: %.2f dKH\n"
+             "  Medições: %d",
+             mean, std_dev, min_kh, max_kh, count);
+    return stats;
+}
+
+// [PERSISTÊNCIA] Salvar histórico em arquivo como JSON
+// [RANGE] Escrito em blocos direto no arquivo (antes: JsonDoc de 8 KB, que
+// não cabia o histórico cheio)
+bool MeasurementHistory::saveToFile(const char* filename) {
+    if (filename == nullptr) {
+        filename = HISTORY_FILE;
+    }
+    
+    RbsStream* file = rbsFileOpen(filename, true);
+    if (!file) {
+        rbsLog("[MeasurementHistory] ERRO: Não foi possível abrir %s para escrita", filename);
+        return false;
+    }
+
+    size_t written = writeJSON(*file);
+    rbsFileClose(file);
+
+    rbsLog("[MeasurementHistory] Histórico salvo em %s (%d medições, %u bytes)",
+           filename, (int)_measurements.size(), (unsigned)written);
+    return written > 0;
+}
+
+// [BOOT] Carregar histórico de arquivo
+// [RANGE] Uma medição por vez (objeto pequeno), memória constante
+bool MeasurementHistory::loadFromFile(const char* filename) {
+    if (filename == nullptr) {
+        filename = HISTORY_FILE;
+    }
+    
+    // Verificar se arquivo existe
+    if (!rbsFileExists(filename)) {
+        rbsLog("[MeasurementHistory] Arquivo %s não encontrado", filename);
+        return false;
+    }
+    
+    // Abrir arquivo
+    RbsStream* file = rbsFileOpen(filename, false);
+    if (!file) {
+        rbsLog("[MeasurementHistory] ERRO: Não foi possível abrir %s para leitura", filename);
+        return false;
+    }
+
+    if (!skipPast(*file, "\"measurements\"") || !skipPast(*file, "[")) {
+        rbsLog("[MeasurementHistory] ERRO: arquivo sem array de medições");
+        rbsFileClose(file);
+        return false;
+    }
+
+    // Limpar histórico anterior
+    _measurements.clear();
+
+    // Carregar medições: cada objeto do array é lido sozinho
+    char obj[MAX_OBJECT];
+    bool error = false;
+    while (true) {
+        skipSpaces(*file);
+        int c = file->peek();
+        if (c == ',') {
+            file->read();
+            continue;
+        }
+        if (c == ']') {
+            break;
+        }
+        Measurement m;
+        if (c != '{' || !readObject(*file, obj, sizeof(obj)) || !parseMeasurement(obj, m)) {
+            error = true;
+            break;
+        }
+        _measurements.push(m);
+    }
+    rbsFileClose(file);
+    _sorted = checkSorted();
+
+    if (error) {
+        rbsLog("[MeasurementHistory] ERRO ao parsear JSON (%d medições lidas)",
+               (int)_measurements.size());
+        return _measurements.size() > 0;
+    }
+
+    rbsLog("[MeasurementHistory] Histórico carregado: %d medições", (int)_measurements.size());
+    return true;
+}
+
+// [BOOT] Verificar se histórico existe
+bool MeasurementHistory::historyExists() {
+    return rbsFileExists(HISTORY_FILE);
+}
+
+// [BOOT] Obter tamanho do arquivo de histórico
+size_t MeasurementHistory::getHistoryFileSize() {
+    return rbsFileSize(HISTORY_FILE);
+}
+
+void MeasurementHistory::normalizeTimestampsIfNeeded() {
+    rbsLog("[MeasurementHistory] Normalizando timestamps, se necessário...");
+
+    bool changed = false;
+
+    for (size_t i = 0; i < _measurements.size(); i++) {
+        Measurement& m = _measurements[i];
+        // Se estiver em segundos (<= ~ano 2043), converte para ms
+        if (m.timestamp > 0 && m.timestamp < 2000000000UL) {
+            m.timestamp = m.timestamp * 1000UL;
+            changed = true;
+        }
+    }
+    _sorted = checkSorted();
+
+    if (changed) {
+        rbsLog("[MeasurementHistory] Timestamps antigos detectados. Salvando histórico normalizado...");
+        saveToFile();  // usa HISTORY_FILE padrão
+        rebuildRollups();
+        saveRollups();
+    } else {
+        rbsLog("[MeasurementHistory] Timestamps já estão em ms; nada a fazer.");
+    }
+}
+
+KHRollups::Bucket MeasurementHistory::getLast24h() {
+    uint64_t now = rbsEpochMs();
+    if (now < MIN_EPOCH_MS) {
+        return KHRollups::Bucket{};
+    }
+    return _rollups.last24h((uint32_t)(now / 1000ULL));
+}
+
+
+// ===== Métodos Privados =====
+
+// [ROLLUP] Só medições válidas com relógio certo entram nos agregados
+void MeasurementHistory::addToRollups(const Measurement& m) {
+    if (!m.is_valid || m.timestamp < MIN_EPOCH_MS) {
+        return;
+    }
+    _rollups.add((uint32_t)(m.timestamp / 1000ULL), m.kh);
+}
+
+void MeasurementHistory::rebuildRollups() {
+    _rollups.clear();
+    for (const auto& m : range(0, UINT64_MAX)) {
+        addToRollups(m);
+    }
+    rbsLog("[MeasurementHistory] Rollups reconstruídos (%u buckets horários)",
+           (unsigned)_rollups.size(KHRollups::HOURLY));
+}
+
+bool MeasurementHistory::saveRollups() {
+    std::vector<uint8_t> buf(KHRollups::SAVE_SIZE);
+    size_t len = _rollups.save(buf.data(), buf.size());
+
+    RbsStream* file = rbsFileOpen(ROLLUP_FILE, true);
+    if (!file) {
+        rbsLog("[MeasurementHistory] ERRO: Não foi possível abrir %s para escrita", ROLLUP_FILE);
+        return false;
+    }
+    bool ok = file->write(buf.data(), len) == len;
+    rbsFileClose(file);
+    return ok;
+}
+
+bool MeasurementHistory::loadRollups() {
+    if (!rbsFileExists(ROLLUP_FILE)) {
+        return false;
+    }
+    size_t len = rbsFileSize(ROLLUP_FILE);
+    if (len > KHRollups::SAVE_SIZE) {
+        return false;
+    }
+    RbsStream* file = rbsFileOpen(ROLLUP_FILE, false);
+    if (!file) {
+        return false;
+    }
+    std::vector<uint8_t> buf(len);
+    size_t got = 0;
+    int c;
+    while (got < len && (c = file->read()) >= 0) {
+        buf[got++] = (uint8_t)c;
+    }
+    rbsFileClose(file);
+    bool ok = got == len && _rollups.load(buf.data(), len);
+
+    if (!ok) {
+        rbsLog("[MeasurementHistory] AVISO: /rollups.bin inválido, reconstruindo");
+        return false;
+    }
+    rbsLog("[MeasurementHistory] Rollups carregados (%u h / %u d / %u sem)",
+           (unsigned)_rollups.size(KHRollups::HOURLY),
+           (unsigned)_rollups.size(KHRollups::DAILY),
+           (unsigned)_rollups.size(KHRollups::WEEKLY));
+    return true;
+}
+
+// Limites [from, to) equivalentes a "agora - timestamp < janela"
+void MeasurementHistory::filterBounds(TimeFilter filter, uint64_t& fromMs, uint64_t& toMs) const {
+    uint64_t window;
+    switch (filter) {
+        case LAST_HOUR:
+            window = 60ULL * 60ULL * 1000ULL;
+            break;
+        case LAST_24_HOURS:
+            window = 24ULL * 60ULL * 60ULL * 1000ULL;
+            break;
+        case LAST_WEEK:
+            window = 7ULL * 24ULL * 60ULL * 60ULL * 1000ULL;
+            break;
+        case ALL_DATA:
+        default:
+            fromMs = 0;
+            toMs = UINT64_MAX;
+            return;
+    }
+
+    uint64_t now = rbsEpochMs();
+    fromMs = now >= window ? now - window + 1 : 0;
+    toMs = now + 1;
+}
+
+bool MeasurementHistory::checkSorted() const {
+    for (size_t i = 1; i < _measurements.size(); i++) {
+        if (_measurements[i].timestamp < _measurements[i - 1].timestamp) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,243 @@
+//MeasurementHistory.h
+
+#ifndef MEASUREMENT_HISTORY_H
+#define MEASUREMENT_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "rbs_hal.h"
+#include "RingBuffer.h"
+#include "TimeRange.h"
+#include "KH_Rollups.h"
+
+/**
+ * @class MeasurementHistory
+ * @brief Histórico de medições de KH com persistência em arquivo
+ *
+ * Arquivos e relógio passam pela HAL (rbsFile*, rbsEpochMs): SPIFFS no
+ * ESP32, LittleFS no ESP8266, pasta local nos testes de host.
+ *
+ * MELHORIAS IMPLEMENTADAS:
+ * - [PERSISTÊNCIA] Salva automaticamente cada medição em /history.json
+ * - [BOOT] Carrega histórico ao iniciar o sistema
+ * - [RESET] Função para limpar histórico completo
+ * - [SEGURANÇA] Validação de dados antes de salvar
+ * - [ROLLUP] Agregados por hora/dia/semana (KHRollups) atualizados a cada
+ *   medição e salvos em /rollups.bin; "últimas 24 h" sai deles sem varrer
+ *   _measurements
+ * - [RANGE] Medições num anel fixo em ordem de tempo: range(from, to) acha
+ *   os limites por busca binária e itera sem copiar; exportação e
+ *   gravação vão em blocos para qualquer RbsPrint (arquivo, cliente HTTP)
+ *   com memória constante
+ */
+class MeasurementHistory {
+public:
+    // Estrutura para uma medição
+    struct Measurement {
+        float kh;
+        float ph_ref;
+        float ph_sample;
+        float temperature;
+        uint64_t timestamp;
+        bool is_valid;
+    };
+
+    // Filtros de tempo
+    enum TimeFilter {
+        LAST_HOUR,
+        LAST_24_HOURS,
+        LAST_WEEK,
+        ALL_DATA
+    };
+
+    // Capacidade do histórico (anel: a mais antiga sai quando cheio)
+    static constexpr size_t MAX_MEASUREMENTS = 1000;
+
+    // Visão [from, to) sobre o histórico, sem cópia; vale até a próxima
+    // alteração do histórico
+    typedef TimeRange<Measurement, MAX_MEASUREMENTS, &Measurement::timestamp> Range;
+
+    /**
+     * Construtor
+     */
+    MeasurementHistory();
+
+    /**
+     * Inicializar histórico
+     * [BOOT] Monta o sistema de arquivos e carrega o histórico salvo
+     */
+    void begin();
+
+    /**
+     * Adicionar medição ao histórico
+     * [PERSISTÊNCIA] Salva automaticamente em arquivo após adicionar
+     * @param measurement Estrutura com dados da medição
+     */
+    void addMeasurement(const Measurement& measurement);
+
+    /**
+     * Obter medição por índice
+     * @param index Índice (0 = mais recente)
+     * @return Medição
+     */
+    Measurement getMeasurement(int index);
+
+    /**
+     * Obter número de medições
+     * @return Quantidade de medições armazenadas
+     */
+    int getCount();
+
+    /**
+     * Medições com timestamp em [fromMs, toMs), mais antiga primeiro
+     * [RANGE] O(log n) para achar os limites, sem cópia
+     */
+    Range range(uint64_t fromMs, uint64_t toMs) const;
+
+    /**
+     * Visão do filtro de tempo (mesmos limites de getFilteredMeasurements)
+     */
+    Range range(TimeFilter filter) const;
+
+    /**
+     * Obter medições filtradas por tempo
+     * Copia as medições; para só ler, prefira range(filter)
+     * @param filter Filtro de tempo
+     * @return Vector com medições filtradas
+     */
+    std::vector<Measurement> getFilteredMeasurements(TimeFilter filter);
+
+    /**
+     * Obter última medição
+     * @return Última medição
+     */
+    Measurement getLastMeasurement();
+
+    /**
+     * Limpar histórico
+     * [RESET] Remove todos os dados do histórico e os arquivos
+     */
+    void clearHistory();
+
+    /**
+     * Definir intervalo de medição
+     * @param minutes Intervalo em minutos (60-1440)
+     */
+    void setMeasurementInterval(int minutes);
+
+    /**
+     * Obter intervalo de medição
+     * @return Intervalo em minutos
+     */
+    int getMeasurementInterval();
+
+    /**
+     * Verificar se é hora de fazer nova medição
+     * @return true se deve fazer medição
+     */
+    bool shouldMeasure();
+
+    /**
+     * Exportar histórico como JSON
+     * @return String com dados em formato JSON
+     */
+    std::string exportAsJSON();
+
+    /**
+     * Exportar histórico como CSV
+     * @return String com dados em formato CSV
+     */
+    std::string exportAsCSV();
+
+    /**
+     * Escrever o período [fromMs, toMs) em JSON/CSV direto em out (File,
+     * WiFiClient, adaptador do WebServer...), em blocos de EXPORT_CHUNK bytes
+     * [RANGE] Memória constante, qualquer tamanho de histórico
+     * @return Bytes escritos
+     */
+    size_t writeJSON(RbsPrint& out, uint64_t fromMs = 0, uint64_t toMs = UINT64_MAX) const;
+    size_t writeCSV(RbsPrint& out, uint64_t fromMs = 0, uint64_t toMs = UINT64_MAX) const;
+
+    /**
+     * Obter estatísticas
+     * @param filter Filtro de tempo
+     * @return String com estatísticas
+     */
+    std::string getStatistics(TimeFilter filter = ALL_DATA);
+
+    /**
+     * Salvar histórico em arquivo
+     * [PERSISTÊNCIA] Salva todas as medições em JSON
+     * @param filename Nome do arquivo (padrão: /history.json)
+     * @return true se salvo com sucesso
+     */
+    bool saveToFile(const char* filename = "/history.json");
+
+    /**
+     * Carregar histórico de arquivo
+     * [BOOT] Carrega medições salvas previamente
+     * @param filename Nome do arquivo (padrão: /history.json)
+     * @return true se carregado com sucesso
+     */
+    bool loadFromFile(const char* filename = "/history.json");
+
+    /**
+     * Verificar se histórico existe
+     * [BOOT] Usado para detectar se é primeira inicialização
+     * @return true se o arquivo de histórico existe
+     */
+    bool historyExists();
+
+    /**
+     * Obter tamanho do arquivo de histórico
+     * @return Tamanho em bytes
+     */
+    size_t getHistoryFileSize();
+
+    /**
+     * Agregados hora/dia/semana das medições válidas com epoch
+     * [ROLLUP] Enviados junto com as medições no /device/sync
+     */
+    const KHRollups& rollups() const { return _rollups; }
+
+    /**
+     * Agregado de KH das últimas 24 h (resolução de 1 h), custo fixo
+     * @return Bucket com count = 0 se não há dados ou sem relógio
+     */
+    KHRollups::Bucket getLast24h();
+
+    /**
+     * Normalizar timestamps antigos em segundos para milissegundos
+     * [MIGRAÇÃO] Usa heurística simples (timestamp pequeno => segundos)
+     */
+    void normalizeTimestampsIfNeeded();
+
+private:
+    // Histórico (índice 0 = mais antiga)
+    RingBuffer<Measurement, MAX_MEASUREMENTS> _measurements;
+    bool _sorted = true;   // em ordem de tempo: range() usa busca binária
+    KHRollups _rollups;
+
+    // Configurações
+    int _measurement_interval_minutes;
+    uint32_t _last_measurement_time;
+
+    // Constantes
+    static constexpr size_t EXPORT_CHUNK = 512;
+    static constexpr const char* HISTORY_FILE = "/history.json";
+    static constexpr const char* ROLLUP_FILE = "/rollups.bin";
+
+    // Métodos privados
+    void filterBounds(TimeFilter filter, uint64_t& fromMs, uint64_t& toMs) const;
+    bool checkSorted() const;
+
+    // [ROLLUP] Persistência e reconstrução a partir de _measurements
+    void addToRollups(const Measurement& m);
+    bool saveRollups();
+    bool loadRollups();
+    void rebuildRollups();
+};
+
+#endif // MEASUREMENT_HISTORY_H
@@ -0,0 +1,33 @@
+//ReefBlueSkyCore.h
+#pragma once
+
+/**
+ * ReefBlueSkyCore - lógica compartilhada dos monitores de KH (v2, v3, v4)
+ *
+ * Só código independente de plataforma: o que precisa do hardware (relógio,
+ * log, arquivos) passa pela HAL (rbs_hal.h), implementada para Arduino e
+ * para host. O mesmo código roda nos sketches e no build de host
+ * (CMakeLists.txt), onde ficam os testes e benchmarks - otimização medida
+ * ali vale para todas as variantes.
+ *
+ * Sketch: instalar a pasta como biblioteca Arduino (link ou cópia em
+ * ~/Arduino/libraries/ReefBlueSkyCore, ou arduino-cli --library <pasta>)
+ * e incluir <ReefBlueSkyCore.h>.
+ */
+
+#define RBS_CORE_VERSION_MAJOR 1
+#define RBS_CORE_VERSION_MINOR 7
+#define RBS_CORE_VERSION_PATCH 0
+#define RBS_CORE_VERSION       "1.7.0"   // manter igual a library.properties
+
+#include "rbs_hal.h"
+#include "RingBuffer.h"
+#include "TimeRange.h"
+#include "LineFit.h"
+#include "KH_Predictor.h"
+#include "KH_Kalman.h"
+#include "KH_DoseController.h"
+#include "KH_Rollups.h"
+#include "MeasurementHistory.h"
+#include "Sha256.h"
+#include "LanLink.h"
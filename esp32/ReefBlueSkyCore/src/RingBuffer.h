@@ -0,0 +1,59 @@
+//RingBuffer.h
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * Anel de capacidade fixa, sem heap: push() em O(1) descarta o mais antigo
+ * quando cheio (no lugar de vector::erase(begin()), que move tudo).
+ * Índice 0 = mais antigo, size()-1 = mais recente.
+ */
+template <typename T, size_t N>
+class RingBuffer {
+public:
+  void push(const T& v) {
+    _buf[(_start + _count) % N] = v;
+    if (_count < N) {
+      _count++;
+    } else {
+      _start = (_start + 1) % N;
+    }
+  }
+
+  void clear() {
+    _start = 0;
+    _count = 0;
+  }
+
+  size_t size() const { return _count; }
+  bool empty() const { return _count == 0; }
+  bool full() const { return _count == N; }
+  static constexpr size_t capacity() { return N; }
+
+  const T& operator[](size_t i) const { return _buf[(_start + i) % N]; }
+  T& operator[](size_t i) { return _buf[(_start + i) % N]; }
+  const T& front() const { return (*this)[0]; }
+  const T& back() const { return (*this)[_count - 1]; }
+
+  // Primeiro índice em que before(item) é falso (busca binária). Exige o
+  // anel particionado: todos os "before" antes dos outros (ex.: ordenado
+  // por tempo e before = "timestamp < x").
+  template <typename Pred>
+  size_t partitionPoint(Pred before) const {
+    size_t lo = 0, hi = _count;
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (before((*this)[mid])) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+private:
+  T      _buf[N];
+  size_t _start = 0;
+  size_t _count = 0;
+};
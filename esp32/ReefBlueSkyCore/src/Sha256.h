@@ -0,0 +1,35 @@
+//Sha256.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * SHA-256 e HMAC-SHA256 portáteis (FIPS 180-4 / RFC 2104)
+ *
+ * O firmware já tem SHA-256 da plataforma (mbedtls no ESP32, BearSSL no
+ * ESP8266), mas cada um com sua API; aqui é o mesmo código no monitor, na
+ * dosadora e no host, que é o que o LanLink precisa para autenticar as
+ * mensagens entre os dois. Para hash de arquivos grandes (OTA) continue
+ * usando o da plataforma, que é acelerado.
+ */
+
+#define RBS_SHA256_LEN 32
+
+struct RbsSha256 {
+  uint32_t state[8];
+  uint64_t bytes;
+  uint8_t  buf[64];
+  uint8_t  bufLen;
+};
+
+void rbsSha256Init(RbsSha256* c);
+void rbsSha256Update(RbsSha256* c, const void* data, size_t len);
+void rbsSha256Final(RbsSha256* c, uint8_t out[RBS_SHA256_LEN]);
+
+void rbsSha256(const void* data, size_t len, uint8_t out[RBS_SHA256_LEN]);
+void rbsHmacSha256(const uint8_t* key, size_t keyLen, const void* data, size_t len,
+                   uint8_t out[RBS_SHA256_LEN]);
+
+// Comparação em tempo constante (tags de autenticação)
+bool rbsDigestEqual(const uint8_t* a, const uint8_t* b, size_t len);
@@ -0,0 +1,80 @@
+//TimeRange.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "RingBuffer.h"
+
+/**
+ * Visão [from, to) sobre um RingBuffer de registros com timestamp, sem cópia
+ *
+ * Com o anel em ordem de tempo (sorted = true) os limites saem de duas
+ * buscas binárias e a iteração só passa pelos itens do período. Fora de
+ * ordem (ex.: medição gravada com millis() porque o NTP falhou) a visão
+ * percorre o anel inteiro e pula o que está fora do período - mesmo
+ * resultado, custo linear. Ts é o campo de tempo (ex.:
+ * &Measurement::timestamp). A visão vale enquanto o anel não mudar.
+ *
+ *   for (const Measurement& m : TimeRange<Measurement, 1000, &Measurement::timestamp>(ring, a, b, true))
+ */
+template <typename T, size_t N, uint64_t T::*Ts>
+class TimeRange {
+public:
+  class Iterator {
+  public:
+    Iterator(const TimeRange* r, size_t i) : _r(r), _i(i) { skip(); }
+    const T& operator*() const { return (*_r->_ring)[_i]; }
+    const T* operator->() const { return &(*_r->_ring)[_i]; }
+    Iterator& operator++() { _i++; skip(); return *this; }
+    bool operator!=(const Iterator& o) const { return _i != o._i; }
+    bool operator==(const Iterator& o) const { return _i == o._i; }
+
+  private:
+    void skip() {
+      if (_r->_sorted) return;
+      while (_i < _r->_last && !_r->contains((*_r->_ring)[_i])) _i++;
+    }
+    const TimeRange* _r;
+    size_t _i;
+  };
+
+  TimeRange(const RingBuffer<T, N>& ring, uint64_t from, uint64_t to, bool sorted)
+    : _ring(&ring), _from(from), _to(to), _sorted(sorted), _first(0), _last(ring.size()) {
+    if (sorted) {
+      _first = ring.partitionPoint([from](const T& x) { return x.*Ts < from; });
+      _last  = ring.partitionPoint([to](const T& x) { return x.*Ts < to; });
+      if (_last < _first) _last = _first;
+    }
+  }
+
+  Iterator begin() const { return Iterator(this, _first); }
+  Iterator end() const { return Iterator(this, _last); }
+
+  bool empty() const { return !(begin() != end()); }
+
+  // Itens no período (O(1) com o anel em ordem)
+  size_t size() const {
+    if (_sorted) return _last - _first;
+    size_t n = 0;
+    for (Iterator it = begin(); it != end(); ++it) n++;
+    return n;
+  }
+
+  // Mais recente do período; só chamar se !empty()
+  const T& back() const {
+    if (_sorted) return (*_ring)[_last - 1];
+    const T* last = nullptr;
+    for (const T& x : *this) last = &x;
+    return *last;
+  }
+
+  bool contains(const T& x) const { return x.*Ts >= _from && x.*Ts < _to; }
+
+private:
+  const RingBuffer<T, N>* _ring;
+  uint64_t _from;
+  uint64_t _to;
+  bool     _sorted;
+  size_t   _first;
+  size_t   _last;
+};
@@ -0,0 +1,71 @@
+#ifdef ARDUINO
+
+#include "../rbs_hal.h"
+#include <Arduino.h>
+#include <time.h>
+#ifdef ESP8266
+  #include <LittleFS.h>
+  #define RBS_FS LittleFS
+#else
+  #include <SPIFFS.h>
+  #define RBS_FS SPIFFS
+#endif
+
+uint32_t rbsMillis() {
+  return millis();
+}
+
+void rbsHalDefaultSink(const char* line) {
+  Serial.println(line);
+}
+
+// Mesmo critério do TimeProvider dos sketches: antes de 2020 = sem NTP
+uint64_t rbsHalDefaultEpochMs() {
+  time_t nowSec = time(nullptr);
+  if (nowSec < 1577836800) {
+    return 0;
+  }
+  return (uint64_t)nowSec * 1000ULL;
+}
+
+bool rbsFsBegin() {
+#ifdef ESP8266
+  return RBS_FS.begin();
+#else
+  return RBS_FS.begin(true);   // formata se não montar
+#endif
+}
+
+RbsStream* rbsFileOpen(const char* path, bool write) {
+  File* f = new File(RBS_FS.open(path, write ? "w" : "r"));
+  if (!*f) {
+    delete f;
+    return nullptr;
+  }
+  return f;
+}
+
+void rbsFileClose(RbsStream* file) {
+  if (!file) return;
+  File* f = static_cast<File*>(file);
+  f->close();
+  delete f;
+}
+
+bool rbsFileExists(const char* path) {
+  return RBS_FS.exists(path);
+}
+
+bool rbsFileRemove(const char* path) {
+  return RBS_FS.remove(path);
+}
+
+size_t rbsFileSize(const char* path) {
+  File f = RBS_FS.open(path, "r");
+  if (!f) return 0;
+  size_t size = f.size();
+  f.close();
+  return size;
+}
+
+#endif // ARDUINO
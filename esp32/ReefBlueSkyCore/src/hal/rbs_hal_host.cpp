@@ -0,0 +1,84 @@
+#ifndef ARDUINO
+
+#include "../rbs_hal.h"
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <sys/stat.h>
+
+uint32_t rbsMillis() {
+  static const auto t0 = std::chrono::steady_clock::now();
+  return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - t0).count();
+}
+
+void rbsHalDefaultSink(const char* line) {
+  puts(line);
+}
+
+uint64_t rbsHalDefaultEpochMs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// ---- Arquivos: pasta local ---------------------------------------------------
+
+static std::string s_root = ".";
+
+void rbsHostSetFsRoot(const char* dir) {
+  s_root = dir ? dir : ".";
+}
+
+static std::string hostPath(const char* path) {
+  return s_root + (path[0] == '/' ? "" : "/") + path;
+}
+
+class HostFile : public RbsStream {
+public:
+  explicit HostFile(FILE* f) : _f(f) {}
+  ~HostFile() override { fclose(_f); }
+
+  size_t write(uint8_t c) override { return fputc(c, _f) == EOF ? 0 : 1; }
+  size_t write(const uint8_t* buf, size_t n) override { return fwrite(buf, 1, n, _f); }
+  int available() override { return peek() == EOF ? 0 : 1; }
+  int read() override { return fgetc(_f); }
+  int peek() override {
+    int c = fgetc(_f);
+    if (c != EOF) ungetc(c, _f);
+    return c;
+  }
+
+private:
+  FILE* _f;
+};
+
+bool rbsFsBegin() {
+  mkdir(s_root.c_str(), 0755);
+  struct stat st;
+  return stat(s_root.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+RbsStream* rbsFileOpen(const char* path, bool write) {
+  FILE* f = fopen(hostPath(path).c_str(), write ? "wb" : "rb");
+  return f ? new HostFile(f) : nullptr;
+}
+
+void rbsFileClose(RbsStream* file) {
+  delete file;
+}
+
+bool rbsFileExists(const char* path) {
+  struct stat st;
+  return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool rbsFileRemove(const char* path) {
+  return remove(hostPath(path).c_str()) == 0;
+}
+
+size_t rbsFileSize(const char* path) {
+  struct stat st;
+  return stat(hostPath(path).c_str(), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+#endif // !ARDUINO
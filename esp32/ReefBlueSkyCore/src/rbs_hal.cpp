@@ -0,0 +1,29 @@
+#include "rbs_hal.h"
+#include <stdio.h>
+
+#define RBS_LOG_LINE 160
+
+static RbsLogSink     s_sink  = rbsHalDefaultSink;
+static RbsEpochSource s_epoch = rbsHalDefaultEpochMs;
+
+void rbsSetLogSink(RbsLogSink sink) {
+  s_sink = sink;
+}
+
+void rbsLog(const char* fmt, ...) {
+  if (!s_sink) return;
+  char line[RBS_LOG_LINE];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(line, sizeof(line), fmt, ap);
+  va_end(ap);
+  s_sink(line);
+}
+
+void rbsSetEpochSource(RbsEpochSource source) {
+  s_epoch = source ? source : rbsHalDefaultEpochMs;
+}
+
+uint64_t rbsEpochMs() {
+  return s_epoch();
+}
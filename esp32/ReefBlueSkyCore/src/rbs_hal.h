@@ -0,0 +1,81 @@
+//rbs_hal.h
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+#ifdef ARDUINO
+#include <Stream.h>
+#endif
+
+/**
+ * HAL do core: tudo que o core usa da plataforma passa por aqui.
+ *   hal/rbs_hal_arduino.cpp  -> millis(), Serial, time() e SPIFFS/LittleFS
+ *   hal/rbs_hal_host.cpp     -> relógio monotônico, stdout, relógio do
+ *                               sistema e uma pasta local
+ */
+
+// Milissegundos desde o boot (ou desde o início do processo, no host)
+uint32_t rbsMillis();
+
+// Log de uma linha (sem '\n' no fmt); vai para o sink atual
+void rbsLog(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+// Destino das linhas de log; nullptr silencia (testes/benchmarks)
+typedef void (*RbsLogSink)(const char* line);
+void rbsSetLogSink(RbsLogSink sink);
+
+// Sink padrão da plataforma (definido em hal/)
+void rbsHalDefaultSink(const char* line);
+
+// Epoch em ms; 0 se o relógio ainda não foi acertado (NTP)
+uint64_t rbsEpochMs();
+
+// Fonte do epoch; nullptr volta para a da plataforma (testes usam um relógio fixo)
+typedef uint64_t (*RbsEpochSource)();
+void rbsSetEpochSource(RbsEpochSource source);
+
+// Fonte padrão da plataforma (definida em hal/)
+uint64_t rbsHalDefaultEpochMs();
+
+// Destino/origem de bytes. No Arduino são o Print/Stream do core (File,
+// WiFiClient...); no host, o mínimo do mesmo contrato.
+#ifdef ARDUINO
+typedef Print  RbsPrint;
+typedef Stream RbsStream;
+#else
+class RbsPrint {
+public:
+  virtual ~RbsPrint() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t k = 0;
+    while (k < n && write(buf[k])) k++;
+    return k;
+  }
+};
+
+class RbsStream : public RbsPrint {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+#endif
+
+// Arquivos do core (histórico, agregados): SPIFFS (ESP32) ou LittleFS
+// (ESP8266) no Arduino; no host, uma pasta (rbsHostSetFsRoot). Caminhos
+// absolutos ("/history.json"). rbsFileOpen devolve nullptr se não abriu;
+// todo arquivo aberto é fechado e liberado por rbsFileClose.
+bool       rbsFsBegin();
+RbsStream* rbsFileOpen(const char* path, bool write);
+void       rbsFileClose(RbsStream* file);
+bool       rbsFileExists(const char* path);
+bool       rbsFileRemove(const char* path);
+size_t     rbsFileSize(const char* path);
+
+#ifndef ARDUINO
+// Pasta onde ficam os arquivos do core no host (padrão: diretório atual)
+void rbsHostSetFsRoot(const char* dir);
+#endif
@@ -0,0 +1,227 @@
+// lan_loopback.cpp - LanLink entre dois processos por UDP no loopback
+//
+// O pai faz o papel do monitor, o filho (fork) o da dosadora, cada um com
+// seu socket em 127.0.0.1. O "grupo multicast" vira unicast para o outro
+// processo (multicast no loopback depende da configuração da máquina).
+// Os dois lados descartam LOSS% dos datagramas que enviam: toda dose tem
+// que ser confirmada e executada exatamente uma vez.
+//
+// Uso: ctest (ou ./lan_loopback [doses] [perda%])
+
+#include <ReefBlueSkyCore.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+
+static const uint8_t KEY[32] = {0x52, 0x42, 0x53, 0x2d, 0x6c, 0x61, 0x6e, 0x2d, 0x74, 0x65, 0x73, 0x74,
+                                0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c,
+                                0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14};
+
+struct Side {
+  int      fd;
+  uint16_t otherPort;
+  int      lossPct;
+  uint32_t rng;
+  // dosadora
+  std::vector<uint32_t> executed;
+  uint32_t measurements = 0;
+  // monitor
+  bool     done = false;
+  uint8_t  result = 0, ack = 0;
+  uint32_t rtt = 0;
+};
+
+static uint32_t nextRand(uint32_t& s) {
+  s ^= s << 13;
+  s ^= s >> 17;
+  s ^= s << 5;
+  return s;
+}
+
+static void udpSend(void* ctx, uint32_t ip, uint16_t port, const uint8_t* d, size_t n) {
+  Side* s = (Side*)ctx;
+  if ((int)(nextRand(s->rng) % 100) < s->lossPct) return;
+  sockaddr_in to = {};
+  to.sin_family = AF_INET;
+  to.sin_addr.s_addr = htonl(ip == LANLINK_GROUP_IP ? INADDR_LOOPBACK : ip);
+  to.sin_port = htons(ip == LANLINK_GROUP_IP ? s->otherPort : port);
+  sendto(s->fd, d, n, 0, (sockaddr*)&to, sizeof(to));
+}
+
+static void onMeasurement(void* ctx, const LanLink::Peer&, float, uint32_t) {
+  ((Side*)ctx)->measurements++;
+}
+
+static uint8_t onDose(void* ctx, const LanLink::Peer&, uint32_t id, uint8_t, float) {
+  ((Side*)ctx)->executed.push_back(id);
+  return LanLink::ACK_OK;
+}
+
+static void onResult(void* ctx, uint8_t type, uint32_t, uint8_t result, uint8_t ack, uint32_t rtt) {
+  Side* s = (Side*)ctx;
+  if (type != LanLink::MSG_DOSE_REQUEST) return;
+  s->done = true;
+  s->result = result;
+  s->ack = ack;
+  s->rtt = rtt;
+}
+
+static int bindLoopback(uint16_t& port) {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in a = {};
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  a.sin_port = 0;
+  if (fd < 0 || bind(fd, (sockaddr*)&a, sizeof(a)) < 0) return -1;
+  socklen_t len = sizeof(a);
+  getsockname(fd, (sockaddr*)&a, &len);
+  port = ntohs(a.sin_port);
+  return fd;
+}
+
+// Lê o que houver no socket (espera até waitMs) e roda o loop do LanLink
+static void service(LanLink& link, Side& s, int waitMs) {
+  pollfd p = {s.fd, POLLIN, 0};
+  if (poll(&p, 1, waitMs) > 0) {
+    uint8_t buf[256];
+    sockaddr_in from;
+    socklen_t fl = sizeof(from);
+    ssize_t n;
+    while ((n = recvfrom(s.fd, buf, sizeof(buf), MSG_DONTWAIT, (sockaddr*)&from, &fl)) > 0) {
+      link.onDatagram(buf, (size_t)n, ntohl(from.sin_addr.s_addr), ntohs(from.sin_port),
+                      rbsMillis(), (uint32_t)time(nullptr));
+      fl = sizeof(from);
+    }
+  }
+  link.loop(rbsMillis(), (uint32_t)time(nullptr));
+}
+
+static void beginSide(LanLink& link, Side& s, uint8_t role, const char* uid, uint16_t port) {
+  LanLink::Config c;
+  c.role = role;
+  c.uid = uid;
+  c.key = KEY;
+  c.keyLen = sizeof(KEY);
+  c.session = (uint32_t)getpid() * 2654435761u;
+  c.port = port;
+  LanLink::Handlers h;
+  h.send = udpSend;
+  h.onMeasurement = onMeasurement;
+  h.onDose = onDose;
+  h.onResult = onResult;
+  h.ctx = &s;
+  link.begin(c, h);
+}
+
+// Filho: dosadora. Sai com 0 se cada id 1..doses executou exatamente uma vez
+static int runDoser(int fd, uint16_t myPort, uint16_t monPort, int doses, int loss) {
+  Side s;
+  s.fd = fd;
+  s.otherPort = monPort;
+  s.lossPct = loss;
+  s.rng = 0x9e3779b9u;
+  LanLink link;
+  beginSide(link, s, LanLink::ROLE_DOSER, "RBS-DOSER-LOOP", myPort);
+
+  uint32_t t0 = rbsMillis(), lastNew = 0;
+  size_t seen = 0;
+  while (rbsMillis() - t0 < 60000) {
+    service(link, s, 5);
+    if (s.executed.size() != seen) {
+      seen = s.executed.size();
+      lastNew = rbsMillis();
+    }
+    // Todas chegaram: fica mais 1 s repetindo ACKs perdidos
+    if ((int)seen >= doses && rbsMillis() - lastNew > 1000) break;
+  }
+
+  std::vector<uint32_t> ids = s.executed;
+  std::sort(ids.begin(), ids.end());
+  bool ok = (int)ids.size() == doses;
+  for (size_t i = 0; ok && i < ids.size(); i++) ok = ids[i] == i + 1;
+  printf("dosadora: %zu doses executadas (%s), %u medições, %u ACKs repetidos\n",
+         s.executed.size(), ok ? "cada uma uma vez" : "ERRADO", s.measurements,
+         link.stats().duplicates);
+  return ok ? 0 : 1;
+}
+
+static int runMonitor(int fd, uint16_t myPort, uint16_t doserPort, int doses, int loss) {
+  Side s;
+  s.fd = fd;
+  s.otherPort = doserPort;
+  s.lossPct = loss;
+  s.rng = 0x2545f491u;
+  LanLink link;
+  beginSide(link, s, LanLink::ROLE_MONITOR, "RBS-KH-LOOP", myPort);
+
+  uint32_t t0 = rbsMillis();
+  while (!link.findPeer(LanLink::ROLE_DOSER) && rbsMillis() - t0 < 10000) service(link, s, 10);
+  if (!link.findPeer(LanLink::ROLE_DOSER)) {
+    printf("monitor: dosadora não encontrada\n");
+    return 1;
+  }
+  printf("monitor: dosadora encontrada em %u ms\n", rbsMillis() - t0);
+
+  std::vector<uint32_t> rtts;
+  int fails = 0;
+  for (int i = 1; i <= doses; i++) {
+    if (i % 10 == 0) link.publishMeasurement(8.0f + i * 0.001f, (uint32_t)time(nullptr), rbsMillis(), (uint32_t)time(nullptr));
+    s.done = false;
+    uint32_t start = rbsMillis();
+    while (!link.requestDose(i, 0, 0.5f, rbsMillis(), (uint32_t)time(nullptr))) service(link, s, 1);
+    while (!s.done) service(link, s, 1);
+    if (s.result == LanLink::RESULT_ACKED && s.ack == LanLink::ACK_OK) {
+      rtts.push_back(rbsMillis() - start);
+    } else {
+      // Na nuvem seria o fallback; aqui insiste até confirmar
+      fails++;
+      i--;
+    }
+  }
+
+  std::sort(rtts.begin(), rtts.end());
+  const LanLink::Stats& st = link.stats();
+  printf("monitor: %d doses, ponta a ponta p50 %u ms, p99 %u ms, máx %u ms | RTT médio %u ms | "
+         "%u retransmissões, %d timeouts (perda %d%%)\n",
+         doses, rtts[rtts.size() / 2], rtts[rtts.size() * 99 / 100], rtts.back(), st.avgRttMs,
+         st.retransmits, fails, loss);
+  return rtts.back() < 1000 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+  int doses = argc > 1 ? atoi(argv[1]) : 100;
+  int loss = argc > 2 ? atoi(argv[2]) : 10;
+  rbsSetLogSink(nullptr);
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+
+  uint16_t monPort, doserPort;
+  int monFd = bindLoopback(monPort);
+  int doserFd = bindLoopback(doserPort);
+  if (monFd < 0 || doserFd < 0) {
+    perror("socket");
+    return 1;
+  }
+
+  pid_t child = fork();
+  if (child == 0) {
+    close(monFd);
+    _exit(runDoser(doserFd, doserPort, monPort, doses, loss));
+  }
+  close(doserFd);
+  int rc = runMonitor(monFd, monPort, doserPort, doses, loss);
+
+  int status = 0;
+  waitpid(child, &status, 0);
+  bool ok = rc == 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  printf("%s\n", ok ? "OK" : "FALHOU");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,295 @@
+// sim_dose_controller.cpp - KHDoseController contra um aquário virtual
+//
+// Tanque: KH cai com o consumo (mais forte com luz, crescendo com os
+// corais), sobe g_true dKH a cada mL dosado. Dosadora com duas agendas
+// (dia/noite) executando doses discretas; monitor medindo a cada 2 h com
+// ruído e outliers. O controlador só recebe o que o firmware teria: doses
+// executadas e medições.
+//
+// Cenários (tempo virtual, passo de 10 min):
+//  1. 180 dias: ganho a priori 50% errado, KH inicial 7, consumo crescendo,
+//     degrau de +40% no dia 60, TPA no dia 90, monitor fora do ar 30 h no
+//     dia 100, troca de produto (g ×1,5) no dia 130;
+//  2. consumo maior que a bomba aguenta por 20 dias e depois cai
+//     (anti-windup: sem overshoot na volta);
+//  3. KH acima do envelope: corte imediato para o volume mínimo e volta
+//     sem semanas de rampa.
+//
+// O erro é medido na média diária do KH real, depois do dia 20 e fora das
+// janelas de transitório.
+//
+// Uso: ctest (ou ./sim_dose_controller [-v] para imprimir um resumo diário)
+
+#include <ReefBlueSkyCore.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+
+static const uint64_t MIN_MS  = 60000ULL;
+static const uint64_t HOUR_MS = 60 * MIN_MS;
+static const uint64_t DAY_MS  = 24 * HOUR_MS;
+static bool verbose = false;
+
+static uint32_t rngState = 88172645u;
+static double urand() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return (rngState + 0.5) / 4294967296.0;
+}
+static double gauss() {
+  return sqrt(-2.0 * log(urand())) * cos(2 * M_PI * urand());
+}
+
+// ---------- Aquário + dosadora + monitor ----------
+
+struct Agenda {
+  uint32_t id;
+  int      startMin, endMin, doses;
+  float    volumePerDayMl;
+};
+
+struct Tank {
+  double kh = 7.0;
+  double gTrue = 0.010;              // dKH por mL
+  double consumptionBase = 1.2;      // dKH/dia médio
+  double consumptionMul = 1.0;
+  double growthPerDay = 0.003;
+  double noise = 0.04;               // dKH (1σ) do monitor
+  double outlierProb = 0.01;
+
+  // Consumo instantâneo (dKH/dia): 1,4× com luz (08-20 h), 0,6× no escuro
+  double consumption(double day) const {
+    double hour = fmod(day, 1.0) * 24;
+    double light = (hour >= 8 && hour < 20) ? 1.4 : 0.6;
+    return consumptionBase * consumptionMul * (1 + growthPerDay * day) * light;
+  }
+};
+
+// Erro medido na média diária do KH real: a oscilação dentro do dia vem
+// do horário das doses e da luz, não do volume diário
+struct Stats {
+  double sumAbsErr = 0, maxAbsErr = 0, maxAbove = -1e9;
+  int n = 0;
+  double daySum = 0;
+  int dayN = 0;
+  float minMl = 1e9f, maxMl = -1e9f;
+  int updates = 0, changes = 0, holds = 0;
+  bool stepOk = true;
+};
+
+struct Sim {
+  Tank tank;
+  Agenda agendas[2] = {{11, 8 * 60, 20 * 60, 8, 60.0f}, {12, 22 * 60, 23 * 60 + 59, 4, 40.0f}};
+  KHDoseController ctl;
+  KHDoseController::Config cfg;
+  uint64_t t = 0;
+  bool monitorDown = false;
+
+  void begin(double startKh) {
+    tank.kh = startKh;
+    ctl.begin(cfg, agendas[0].volumePerDayMl + agendas[1].volumePerDayMl);
+  }
+
+  // Dose no minuto do dia? (mesma distribuição do rebuildJobs: início + d·intervalo)
+  float doseAt(int minuteOfDay) const {
+    float ml = 0;
+    for (const Agenda& a : agendas) {
+      int interval = (a.endMin - a.startMin) / a.doses;
+      for (int d = 0; d < a.doses; d++) {
+        if (a.startMin + d * interval == minuteOfDay) ml += a.volumePerDayMl / a.doses;
+      }
+    }
+    return ml;
+  }
+
+  void runDays(double days, Stats& st, double measureFromDay, double skipFrom = -1, double skipTo = -1) {
+    uint64_t end = t + (uint64_t)(days * DAY_MS);
+    for (; t < end; t += 10 * MIN_MS) {
+      double day = double(t) / DAY_MS;
+      int minuteOfDay = int((t % DAY_MS) / MIN_MS);
+
+      // consumo do passo
+      tank.kh -= tank.consumption(day) * (10.0 / 1440.0);
+      if (tank.kh < 0) tank.kh = 0;
+
+      // doses no passo (minutos múltiplos de 10 nas agendas de teste)
+      for (int m = minuteOfDay; m < minuteOfDay + 10; m++) {
+        float ml = doseAt(m);
+        if (ml > 0) {
+          tank.kh += tank.gTrue * ml;
+          ctl.addDose(t, ml);
+        }
+      }
+
+      // medição a cada 2 h
+      if (t % (2 * HOUR_MS) == 0 && !monitorDown) {
+        double meas = tank.kh + tank.noise * gauss();
+        if (urand() < tank.outlierProb) meas += (urand() < 0.5 ? -1.5 : 1.5);
+        ctl.addMeasurement(t, (float)meas);
+      }
+
+      // controlador consultado a cada hora (como o loop do firmware)
+      if (t % HOUR_MS == 0) {
+        KHDoseController::ScheduleVolume cur[2] = {{agendas[0].id, agendas[0].volumePerDayMl},
+                                                   {agendas[1].id, agendas[1].volumePerDayMl}};
+        float before = cur[0].volumePerDayMl + cur[1].volumePerDayMl;
+        KHDoseController::Output o = ctl.update(t, cur, 2);
+        if (!o.valid) st.holds++;
+        if (o.valid && strncmp(o.reason, "Aguardando", 10) != 0) st.updates++;
+        if (o.changed) {
+          st.changes++;
+          float after = o.schedules[0].volumePerDayMl + o.schedules[1].volumePerDayMl;
+          float limit = fmaxf(cfg.maxStepFrac * before, cfg.maxStepMl);
+          // fora do limite só o corte por KH alto e a volta dele
+          bool envelope = strncmp(o.reason, "KH ALTO", 7) == 0 || before <= cfg.minDailyMl + 0.01f;
+          if (fabsf(after - before) > limit + 0.02f && !envelope) st.stepOk = false;
+          agendas[0].volumePerDayMl = o.schedules[0].volumePerDayMl;
+          agendas[1].volumePerDayMl = o.schedules[1].volumePerDayMl;
+        }
+        float total = agendas[0].volumePerDayMl + agendas[1].volumePerDayMl;
+        st.minMl = fminf(st.minMl, total);
+        st.maxMl = fmaxf(st.maxMl, total);
+      }
+
+      st.daySum += tank.kh;
+      st.dayN++;
+      if ((t + 10 * MIN_MS) % DAY_MS == 0) {
+        double mean = st.daySum / st.dayN;
+        st.daySum = 0;
+        st.dayN = 0;
+        if (day >= measureFromDay && !(day >= skipFrom && day < skipTo)) {
+          double err = fabs(mean - cfg.setpointKh);
+          st.sumAbsErr += err;
+          st.maxAbsErr = fmax(st.maxAbsErr, err);
+          st.maxAbove = fmax(st.maxAbove, mean - cfg.setpointKh);
+          st.n++;
+        }
+      }
+
+      if (verbose && t % DAY_MS == 0) {
+        printf("  dia %5.1f  KH %.2f  filtrado %.2f  %.1f mL/dia  g=%.4f (real %.4f)  consumo %.2f\n",
+               day, tank.kh, ctl.getFilteredKh(), agendas[0].volumePerDayMl + agendas[1].volumePerDayMl,
+               ctl.getGain(), tank.gTrue, ctl.getConsumption());
+      }
+    }
+  }
+};
+
+// ---------- Cenários ----------
+
+static void scenarioMonths() {
+  Sim s;
+  s.cfg.setpointKh = 8.0f;
+  s.cfg.gainPriorKhPerMl = 0.015f;     // 50% acima do real
+  s.cfg.maxDailyMl = 300.0f;
+  s.begin(7.0);
+
+  Stats st;
+  // janelas de transitório excluídas da métrica: degrau (60-75), TPA
+  // (90-93), troca de produto (130-140)
+  s.runDays(60, st, 20);
+  double gErr60 = fabs(s.ctl.getGain() - s.tank.gTrue) / s.tank.gTrue;
+
+  s.tank.consumptionMul = 1.4;         // corais novos
+  s.runDays(30, st, 20, 60, 75);
+
+  s.tank.kh = 0.8 * s.tank.kh + 0.2 * 7.2;   // TPA de 20% com sal de KH 7,2
+  s.runDays(10, st, 20, 90, 93);
+
+  // monitor fora do ar por 30 h: controlador segura o volume
+  float volBefore = s.agendas[0].volumePerDayMl + s.agendas[1].volumePerDayMl;
+  Stats outage;
+  s.monitorDown = true;
+  s.runDays(30.0 / 24, outage, 1e9);
+  s.monitorDown = false;
+  float volAfter = s.agendas[0].volumePerDayMl + s.agendas[1].volumePerDayMl;
+  CHECK(outage.holds >= 30 - 12 - 2);   // sem medição há mais de staleHours
+  CHECK(fabsf(volAfter - volBefore) <= fmaxf(s.cfg.maxStepFrac * volBefore, s.cfg.maxStepMl) + 0.02f);
+  s.runDays(30 - 30.0 / 24, st, 20, 100, 103);
+
+  s.tank.gTrue *= 1.5;                 // produto mais concentrado
+  s.runDays(50, st, 20, 130, 140);
+  double gErrEnd = fabs(s.ctl.getGain() - s.tank.gTrue) / s.tank.gTrue;
+
+  double mae = st.sumAbsErr / st.n;
+  printf("meses: erro médio %.3f dKH, máx %.3f dKH | g: %.0f%% de erro no dia 60, %.0f%% no fim | "
+         "%.1f..%.1f mL/dia, %d atualizações, %d descartes\n",
+         mae, st.maxAbsErr, gErr60 * 100, gErrEnd * 100, st.minMl, st.maxMl, st.updates,
+         (int)s.ctl.getRejected());
+
+  CHECK(mae < 0.12);
+  CHECK(st.maxAbsErr < 0.4);
+  CHECK(gErr60 < 0.25);
+  CHECK(gErrEnd < 0.25);
+  CHECK(st.minMl >= s.cfg.minDailyMl && st.maxMl <= s.cfg.maxDailyMl);
+  CHECK(st.stepOk);
+  CHECK(st.updates <= 180 + 1);        // no máximo uma por dia
+}
+
+static void scenarioWindup() {
+  Sim s;
+  s.cfg.setpointKh = 8.0f;
+  s.cfg.gainPriorKhPerMl = 0.010f;
+  s.cfg.maxDailyMl = 130.0f;           // bomba não dá conta de 1,2 × 1,2 dKH/dia
+  s.tank.consumptionMul = 1.2;
+  s.tank.growthPerDay = 0;
+  s.begin(8.0);
+
+  Stats st;
+  s.runDays(20, st, 0);
+  double khLow = s.tank.kh;
+
+  s.tank.consumptionMul = 0.8;         // consumo cai: a integral não pode estar carregada
+  Stats after;
+  s.runDays(40, after, 0);
+  printf("anti-windup: KH caiu para %.2f com a bomba no teto (%.0f mL/dia); depois, pico %+.2f dKH, "
+         "fim %.2f dKH\n", khLow, st.maxMl, after.maxAbove, s.tank.kh);
+  CHECK(st.maxMl <= s.cfg.maxDailyMl);
+  CHECK(khLow < 7.0);                  // a saturação foi real
+  CHECK(after.maxAbove < 0.3);         // sem overshoot de integral carregada
+  CHECK(fabs(s.tank.kh - 8.0) < 0.4);  // voltou ao alvo
+}
+
+static void scenarioEnvelope() {
+  Sim s;
+  s.cfg.setpointKh = 8.0f;
+  s.cfg.gainPriorKhPerMl = 0.010f;
+  s.cfg.maxDailyMl = 300.0f;
+  s.cfg.minDailyMl = 5.0f;
+  s.begin(8.0);
+  Stats st;
+  s.runDays(10, st, 0);
+
+  // alguém despejou tampão: KH 11 (três leituras seguidas viram nível novo)
+  s.tank.kh = 11.0;
+  Stats spike;
+  s.runDays(8.0 / 24, spike, 0);
+  float total = s.agendas[0].volumePerDayMl + s.agendas[1].volumePerDayMl;
+  printf("envelope: KH %.2f -> %.1f mL/dia (mínimo %.1f)\n", s.ctl.getFilteredKh(), total, s.cfg.minDailyMl);
+  CHECK(s.ctl.getFilteredKh() > s.cfg.khHigh);
+  CHECK(fabsf(total - s.cfg.minDailyMl) < 0.05f);
+
+  // e volta a dosar quando o KH cai, sem semanas de rampa
+  s.runDays(20, st, 0);
+  CHECK(fabs(s.tank.kh - 8.0) < 0.4);
+}
+
+int main(int argc, char** argv) {
+  verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+  rbsSetLogSink(nullptr);
+
+  scenarioMonths();
+  scenarioWindup();
+  scenarioEnvelope();
+
+  if (errors) {
+    printf("FALHOU (%d erros)\n", errors);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
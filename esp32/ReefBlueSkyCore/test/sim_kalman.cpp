@@ -0,0 +1,216 @@
+// sim_kalman.cpp - KHKalman e KHPredictor (Kalman x reta) num aquário virtual
+//
+// Tanque: consumo de 1,2 dKH/dia (1,4× com luz, 0,6× no escuro), dosadora
+// com 12 doses por dia que repõem o consumo médio, monitor medindo a cada
+// 2 h com ruído de 0,04 dKH e 1% de leituras fora da curva. Passo de 10 min,
+// 45 dias:
+//   dia 20  consumo +25% (corais novos); as agendas só acompanham no dia 21
+//   dia 30  khcorrection de 30 mL (+0,3 dKH) na bomba 4
+//   dia 35  TPA: KH cai 0,4 dKH sem aviso ao filtro
+//
+// Confere: KH filtrado mais perto do real que a medição, consumo estimado,
+// cobertura do intervalo de 4 h, outliers descartados, volta rápida depois
+// da TPA, predição de 4 h melhor que a da reta e recomendação de dosagem
+// depois do degrau de consumo.
+//
+// Uso: ctest (ou ./sim_kalman [-v] para imprimir um resumo diário)
+
+#include <ReefBlueSkyCore.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+
+static const uint64_t MIN_MS  = 60000ULL;
+static const uint64_t HOUR_MS = 60 * MIN_MS;
+static const uint64_t DAY_MS  = 24 * HOUR_MS;
+static const uint64_t T0      = 1704067200000ULL;
+static bool verbose = false;
+
+static uint32_t rngState = 2463534242u;
+static double urand() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return (rngState + 0.5) / 4294967296.0;
+}
+static double gauss() {
+  return sqrt(-2.0 * log(urand())) * cos(2 * M_PI * urand());
+}
+
+struct Tank {
+  double kh = 8.0;
+  double gTrue = 0.010;               // dKH por mL
+  double consumptionBase = 1.2;       // dKH/dia médio
+  double consumptionMul = 1.0;
+  double noise = 0.04;
+  double outlierProb = 0.01;
+
+  double consumption(double day) const {
+    double hour = fmod(day, 1.0) * 24;
+    double light = (hour >= 8 && hour < 20) ? 1.4 : 0.6;
+    return consumptionBase * consumptionMul * light;
+  }
+};
+
+// Predição feita numa medição, conferida 4 h (duas medições) depois
+struct Pending {
+  bool  valid;
+  float kalman, low, high, line;
+};
+
+int main(int argc, char** argv) {
+  verbose = argc > 1 && strcmp(argv[1], "-v") == 0;
+  rbsSetLogSink(nullptr);
+
+  Tank tank;
+  float doseMl = float(tank.consumptionBase / 12 / tank.gTrue);   // 10 mL a cada 2 h
+
+  KHPredictor withKalman, line;
+  withKalman.setKalman(true, 0.010f);
+
+  double rawSq = 0, filtSq = 0;
+  int nErr = 0;
+  double rateSum1 = 0, rateSum2 = 0;
+  int rateN1 = 0, rateN2 = 0;
+  double khalSum = 0, lineSum = 0;
+  int predN = 0, covered = 0, covN = 0;
+  int outliers = 0;
+  double afterTpaErr = 1e9;
+  float adjustAfterStep = 0;
+  char reasonAfterStep[96] = "";
+
+  std::vector<Pending> pending;
+
+  for (uint64_t t = 0; t < 45 * DAY_MS; t += 10 * MIN_MS) {
+    double day = double(t) / DAY_MS;
+    uint64_t ts = T0 + t;
+
+    if (t == 20 * DAY_MS) tank.consumptionMul = 1.25;
+    if (t == 21 * DAY_MS + 10 * MIN_MS) doseMl *= 1.25f;
+    if (t == 35 * DAY_MS) tank.kh -= 0.4;
+
+    tank.kh -= tank.consumption(day) * (10.0 / 1440.0);
+
+    // Agenda: uma dose a cada 2 h, 1 h depois da medição
+    if (t % (2 * HOUR_MS) == HOUR_MS) {
+      tank.kh += tank.gTrue * doseMl;
+      withKalman.addDose(ts, doseMl);
+    }
+    if (t == 30 * DAY_MS + 30 * MIN_MS) {
+      tank.kh += tank.gTrue * 30.0;
+      withKalman.addDose(ts, 30.0f);
+    }
+
+    if (t % (2 * HOUR_MS) != 0) continue;
+
+    // Medição
+    double meas = tank.kh + tank.noise * gauss();
+    bool outlier = urand() < tank.outlierProb;
+    if (outlier) {
+      meas += urand() < 0.5 ? -1.5 : 1.5;
+      outliers++;
+    }
+    withKalman.addMeasurement((float)meas, ts, 25.0f);
+    line.addMeasurement((float)meas, ts, 25.0f);
+
+    KHKalman::Estimate e = withKalman.getKalman().estimate();
+    bool tpaWindow = day >= 35 && day < 36;
+    if (day >= 3 && !tpaWindow && !outlier) {
+      rawSq  += (meas - tank.kh) * (meas - tank.kh);
+      filtSq += (e.kh - tank.kh) * (e.kh - tank.kh);
+      nErr++;
+    }
+    if (day >= 10 && day < 20) { rateSum1 += e.consumption; rateN1++; }
+    if (day >= 25 && day < 30) { rateSum2 += e.consumption; rateN2++; }
+    if (t == 35 * DAY_MS + 8 * HOUR_MS) afterTpaErr = fabs(e.kh - tank.kh);
+
+    // Predição de 4 h feita agora; a de 4 h atrás vence nesta medição
+    KHPredictor::PredictionResult pk = withKalman.getPrediction(4);
+    KHPredictor::PredictionResult pl = line.getPrediction(4);
+    pending.push_back({pk.is_valid && pl.is_valid, pk.predicted_kh, pk.interval_low, pk.interval_high,
+                       pl.predicted_kh});
+    size_t n = pending.size();
+    if (n > 2 && pending[n - 3].valid && day >= 10 && !outlier) {
+      const Pending& p = pending[n - 3];
+      bool crossesEvent = (day >= 30 && day < 30.25) || (day >= 35 && day < 35.25);
+      if (!crossesEvent) {
+        khalSum += fabs(p.kalman - tank.kh);
+        lineSum += fabs(p.line - tank.kh);
+        predN++;
+        covered += (meas >= p.low && meas <= p.high);
+        covN++;
+      }
+    }
+
+    // Um dia depois do degrau de consumo: agendas ainda no volume antigo
+    if (t == 21 * DAY_MS) {
+      KHPredictor::PredictionResult r = withKalman.getDosageRecommendation();
+      adjustAfterStep = r.dosage_adjustment;
+      snprintf(reasonAfterStep, sizeof(reasonAfterStep), "%s", r.reason);
+    }
+
+    if (verbose && t % DAY_MS == 0) {
+      const KHKalman& k = withKalman.getKalman();
+      printf("  dia %4.1f  KH %.3f  medido %.3f  Kalman %.3f ±%.3f  consumo %.2f média %.2f (real %.2f)  dose %.2f dKH/dia\n",
+             day, tank.kh, meas, e.kh, e.khStd, e.consumption, k.getMeanConsumption(),
+             tank.consumptionBase * tank.consumptionMul, k.getDoseRate());
+    }
+  }
+
+  double rawRms = sqrt(rawSq / nErr), filtRms = sqrt(filtSq / nErr);
+  double rate1 = rateSum1 / rateN1, rate2 = rateSum2 / rateN2;
+  double khalMae = khalSum / predN, lineMae = lineSum / predN;
+  double coverage = double(covered) / covN;
+  uint32_t rejected = withKalman.getKalman().getRejected();
+
+  printf("KH: medição %.4f  Kalman %.4f dKH (RMS)\n", rawRms, filtRms);
+  printf("consumo: %.3f (real 1,2)  %.3f (real 1,5) dKH/dia\n", rate1, rate2);
+  printf("predição 4 h: Kalman %.4f  reta %.4f dKH (erro médio), cobertura %.1f%%\n",
+         khalMae, lineMae, 100 * coverage);
+  printf("outliers: %d injetados, %u descartados; TPA: erro %.3f dKH após 8 h\n",
+         outliers, rejected, afterTpaErr);
+  printf("degrau de consumo: %+.1f%% (%s)\n", adjustAfterStep, reasonAfterStep);
+
+  CHECK(filtRms < 0.9 * rawRms);     // consumo dia/noite: o estado também oscila
+  CHECK(fabs(rate1 - 1.2) < 0.1);
+  CHECK(fabs(rate2 - 1.5) < 0.1);
+  CHECK(khalMae < lineMae);
+  CHECK(coverage > 0.85 && coverage < 0.995);
+  CHECK(rejected >= uint32_t(outliers) * 7 / 10);
+  CHECK(afterTpaErr < 0.1);
+  CHECK(adjustAfterStep > 20.0f && strncmp(reasonAfterStep, "Aumentar dosagem", 16) == 0);
+
+  // Sem dose nenhuma: consumo líquido e recomendação pela tendência
+  KHKalman k;
+  k.begin(KHKalman::Config());
+  for (int i = 0; i < 60; i++) k.addMeasurement(T0 + i * 2 * HOUR_MS, 8.0f - 0.1f * i);
+  CHECK(fabs(k.estimate().consumption - 1.2) < 0.05);
+  CHECK(k.getDoseRate() == 0);
+  KHKalman::Estimate p = k.predict(24, 0);
+  CHECK(fabs(p.kh - (8.0 - 0.1 * 59 - 1.2)) < 0.05 && p.khStd > k.estimate().khStd);
+  k.addDose(T0 + 59 * 2 * HOUR_MS, 0.5f);          // dose no instante da última medição
+  CHECK(fabs(k.estimate().kh - (8.0 - 0.1 * 59 + 0.5)) < 0.05);
+
+  // Custo por evento (O(1), float32)
+  const long EVENTS = 200000;
+  auto t0 = std::chrono::steady_clock::now();
+  for (long i = 0; i < EVENTS; i++) {
+    uint64_t ts = T0 + 200ULL * DAY_MS + uint64_t(i) * HOUR_MS;
+    if (i % 2) k.addDose(ts, 0.05f);
+    else k.addMeasurement(ts, 8.0f + 0.01f * float(i % 5));
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / EVENTS;
+  printf("KHKalman: %.0f ns por evento (medição ou dose)\n", ns);
+
+  if (errors) {
+    printf("FALHOU (%d erros)\n", errors);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
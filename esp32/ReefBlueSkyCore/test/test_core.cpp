@@ -0,0 +1,170 @@
+// test_core.cpp - testes de host do ReefBlueSkyCore (RingBuffer, TimeRange e KHPredictor)
+//
+// Uso: ctest (ou ./test_core)
+
+#include <ReefBlueSkyCore.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+#define NEAR(a, b, tol) CHECK(fabs(double(a) - double(b)) <= (tol))
+
+static const uint64_t HOUR = 3600000ULL;
+
+static void testRingBuffer() {
+  RingBuffer<int, 4> r;
+  CHECK(r.empty());
+  CHECK(r.capacity() == 4);
+  for (int i = 1; i <= 3; i++) r.push(i);
+  CHECK(r.size() == 3 && !r.full());
+  CHECK(r.front() == 1 && r.back() == 3);
+  for (int i = 4; i <= 6; i++) r.push(i);      // descarta 1 e 2
+  CHECK(r.full() && r.size() == 4);
+  CHECK(r[0] == 3 && r[1] == 4 && r[2] == 5 && r[3] == 6);
+  r.clear();
+  CHECK(r.empty());
+  r.push(9);
+  CHECK(r.front() == 9 && r.back() == 9);
+}
+
+struct Stamped {
+  uint64_t ts;
+  int v;
+};
+typedef RingBuffer<Stamped, 8> StampedRing;
+typedef TimeRange<Stamped, 8, &Stamped::ts> StampedRange;
+
+static int sumRange(const StampedRange& r) {
+  int s = 0;
+  for (const Stamped& x : r) s += x.v;
+  return s;
+}
+
+// Busca binária sobre o anel já rodado (início no meio do buffer)
+static void testTimeRange() {
+  StampedRing r;
+  for (int i = 0; i < 11; i++) r.push({ uint64_t(100 + 10 * i), i });   // fica 3..10 (130..200)
+  CHECK(r.partitionPoint([](const Stamped& x) { return x.ts < 155; }) == 3);
+  CHECK(r.partitionPoint([](const Stamped& x) { return x.ts < 1; }) == 0);
+  CHECK(r.partitionPoint([](const Stamped& x) { return x.ts < 999; }) == 8);
+
+  StampedRange mid(r, 150, 180, true);          // 150, 160, 170
+  CHECK(mid.size() == 3 && sumRange(mid) == 5 + 6 + 7);
+  CHECK(mid.back().v == 7);
+  StampedRange all(r, 0, UINT64_MAX, true);
+  CHECK(all.size() == 8 && all.back().v == 10);
+  StampedRange none(r, 500, 600, true);
+  CHECK(none.empty() && none.size() == 0);
+  StampedRange inverted(r, 180, 150, true);
+  CHECK(inverted.empty());
+
+  // Fora de ordem: varre tudo e filtra, mesmo resultado
+  r.push({ 5, 100 });                            // timestamp de millis() no meio
+  StampedRange scan(r, 150, 210, false);
+  CHECK(scan.size() == 6 && sumRange(scan) == 5 + 6 + 7 + 8 + 9 + 10);
+  CHECK(scan.back().v == 10);
+  StampedRange tiny(r, 0, 10, false);
+  CHECK(tiny.size() == 1 && tiny.back().v == 100);
+}
+
+// Tendência linear: taxa e predição 4 h à frente da última medição
+static void testTrendAndPrediction() {
+  KHPredictor p;
+  for (int i = 0; i < 100; i++) {
+    p.addMeasurement(8.0f - 0.01f * i, 1000 * HOUR + i * HOUR, 25.0f);
+  }
+  CHECK(p.getDataCount() == 100);
+  NEAR(p.getTrendRate(), -0.01, 1e-4);
+
+  KHPredictor::PredictionResult r = p.getPrediction(4);
+  CHECK(r.is_valid);
+  // reta + componente de ciclo diário ((max - min) * 0,05)
+  NEAR(r.predicted_kh, 8.0 - 0.01 * (99 + 4) + 0.99 * 0.05, 0.005);
+  CHECK(r.confidence > 99.0f);
+}
+
+// Mais de MAX_HISTORY pontos: só os 100 mais recentes contam
+static void testHistoryWindow() {
+  KHPredictor p;
+  for (int i = 0; i < 250; i++) {
+    p.addMeasurement(i < 150 ? 12.0f : 7.0f, i * HOUR, 25.0f);
+  }
+  CHECK(p.getDataCount() == 100);
+  KHPredictor::Statistics s = p.getStatistics();
+  NEAR(s.mean_kh, 7.0, 1e-4);
+  NEAR(s.min_kh, 7.0, 1e-4);
+  NEAR(s.max_kh, 7.0, 1e-4);
+  NEAR(s.std_dev, 0.0, 1e-4);
+  NEAR(s.trend_rate, 0.0, 1e-6);
+}
+
+static void testStatistics() {
+  KHPredictor p;
+  const float v[] = { 7.0f, 8.0f, 9.0f, 8.0f };
+  for (int i = 0; i < 4; i++) p.addMeasurement(v[i], i * HOUR, 25.0f);
+  KHPredictor::Statistics s = p.getStatistics();
+  NEAR(s.mean_kh, 8.0, 1e-4);
+  NEAR(s.min_kh, 7.0, 1e-4);
+  NEAR(s.max_kh, 9.0, 1e-4);
+  NEAR(s.std_dev, sqrt(0.5), 1e-4);
+  CHECK(s.data_count == 4);
+}
+
+static void testValidationAndCompensation() {
+  KHPredictor p;
+  p.addMeasurement(0.5f, 0, 25.0f);            // KH fora de faixa
+  p.addMeasurement(8.0f, 0, 40.0f);            // temperatura inválida
+  CHECK(p.getDataCount() == 0);
+  CHECK(!p.getPrediction(4).is_valid);
+  CHECK(strcmp(p.getPrediction(4).reason, "Dados insuficientes") == 0);
+
+  p.addMeasurement(8.0f, 0, 30.0f);            // +5 °C -> +0,01 dKH
+  NEAR(p.getStatistics().mean_kh, 8.01, 1e-4);
+}
+
+static void testAnomalyAndDosage() {
+  KHPredictor p;
+  for (int i = 0; i < 30; i++) p.addMeasurement(8.0f + (i % 2) * 0.02f, i * HOUR, 25.0f);
+  CHECK(!p.detectAnomaly());
+  p.addMeasurement(12.0f, 30 * HOUR, 25.0f);
+  CHECK(p.detectAnomaly());
+
+  KHPredictor q;
+  q.setReferenceKH(8.0f);
+  for (int i = 0; i < 10; i++) q.addMeasurement(7.0f - 0.2f * i, i * HOUR, 25.0f);
+  KHPredictor::PredictionResult r = q.getDosageRecommendation();
+  CHECK(r.is_valid);
+  NEAR(r.dosage_adjustment, 50.0, 1e-4);       // KH caindo rápido: ajuste no teto
+  CHECK(strncmp(r.reason, "Aumentar dosagem", 16) == 0);
+}
+
+static void testExport() {
+  KHPredictor p;
+  p.addMeasurement(8.0f, 1000, 25.0f);
+  p.addMeasurement(8.5f, 2000, 25.0f);
+  CHECK(p.exportAsJSON() ==
+        "{\"data\":[{\"kh\":8.00,\"timestamp\":1000,\"temperature\":25.0},"
+        "{\"kh\":8.50,\"timestamp\":2000,\"temperature\":25.0}]}");
+  p.clearHistory();
+  CHECK(p.exportAsJSON() == "{\"data\":[]}");
+}
+
+int main() {
+  rbsSetLogSink(nullptr);
+  testRingBuffer();
+  testTimeRange();
+  testTrendAndPrediction();
+  testHistoryWindow();
+  testStatistics();
+  testValidationAndCompensation();
+  testAnomalyAndDosage();
+  testExport();
+  if (errors) {
+    printf("FALHOU (%d erros)\n", errors);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
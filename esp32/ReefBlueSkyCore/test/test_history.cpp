@@ -0,0 +1,222 @@
+// test_history.cpp - testes de host do MeasurementHistory (arquivos na HAL
+// de host, numa pasta history_fs/ ao lado do executável)
+//
+// Uso: ctest (ou ./test_history)
+
+#include <ReefBlueSkyCore.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+#define NEAR(a, b, tol) CHECK(fabs(double(a) - double(b)) <= (tol))
+
+typedef MeasurementHistory::Measurement Measurement;
+
+static const uint64_t MIN_MS  = 60ULL * 1000ULL;
+static const uint64_t HOUR_MS = 60ULL * MIN_MS;
+static const uint64_t DAY_MS  = 24ULL * HOUR_MS;
+static const uint64_t T0_MS   = 1704067200000ULL;   // 2024-01-01 00:00 UTC
+
+// Relógio fixo do teste
+static uint64_t g_now = T0_MS;
+static uint64_t fakeNow() { return g_now; }
+
+// Print em memória que conta as chamadas de write
+class StringOut : public RbsPrint {
+public:
+    std::string s;
+    int calls = 0;
+    size_t write(uint8_t c) override { s += (char)c; calls++; return 1; }
+    size_t write(const uint8_t* b, size_t n) override {
+        s.append((const char*)b, n);
+        calls++;
+        return n;
+    }
+};
+
+static Measurement sample(int i) {
+    return { 8.0f + 0.01f * (i % 50), 8.3f, 8.1f + 0.001f * i, 25.0f + 0.1f * (i % 10),
+             T0_MS + uint64_t(i) * 10 * MIN_MS, (i % 25) != 24 };
+}
+
+static void writeRaw(const char* path, const char* text) {
+    RbsStream* f = rbsFileOpen(path, true);
+    CHECK(f != nullptr);
+    if (!f) return;
+    f->write((const uint8_t*)text, strlen(text));
+    rbsFileClose(f);
+}
+
+static void wipe() {
+    rbsFileRemove("/history.json");
+    rbsFileRemove("/rollups.bin");
+}
+
+// Arquivo gravado pelo JsonDoc das versões antigas (outra ordem de campos,
+// espaços, timestamp em segundos): carrega, normaliza e reconstrói os rollups
+static void testLegacyFile() {
+    wipe();
+    writeRaw("/history.json",
+             "{\"measurements\": [\n"
+             "  {\"timestamp\": 1704067200, \"kh\": 7.5, \"ph_ref\": 8.2, \"ph_sample\": 8.0,"
+             " \"temperature\": 25.5, \"valid\": true},\n"
+             "  {\"valid\":false,\"kh\":7.60,\"ph_ref\":8.20,\"ph_sample\":8.00,"
+             "\"temperature\":25.0,\"timestamp\":1704070800000}\n"
+             "]}");
+
+    MeasurementHistory h;
+    h.begin();
+    CHECK(h.getCount() == 2);
+    Measurement a = h.getMeasurement(1), b = h.getMeasurement(0);
+    CHECK(a.timestamp == T0_MS);           // segundos -> ms
+    NEAR(a.kh, 7.5f, 1e-6);
+    NEAR(a.temperature, 25.5f, 1e-6);
+    CHECK(a.is_valid && !b.is_valid);
+    CHECK(b.timestamp == T0_MS + HOUR_MS);
+    CHECK(rbsFileExists("/rollups.bin"));
+    CHECK(h.rollups().size(KHRollups::HOURLY) == 1);   // só a válida
+
+    // Normalizado e regravado no formato atual
+    MeasurementHistory again;
+    again.begin();
+    CHECK(again.getCount() == 2 && again.getMeasurement(1).timestamp == T0_MS);
+}
+
+// Gravação a cada medição e leitura no boot seguinte
+static void testRoundTrip() {
+    wipe();
+    MeasurementHistory h;
+    h.begin();
+    CHECK(h.getCount() == 0);
+    for (int i = 0; i < 300; i++) h.addMeasurement(sample(i));
+    CHECK(h.getHistoryFileSize() > 0);
+
+    MeasurementHistory b;
+    b.begin();
+    CHECK(b.getCount() == 300);
+    for (int i = 0; i < 300; i++) {
+        Measurement x = h.getMeasurement(i), y = b.getMeasurement(i);
+        CHECK(x.timestamp == y.timestamp && x.is_valid == y.is_valid);
+        NEAR(x.kh, y.kh, 0.006);                 // gravado com %.2f
+        NEAR(x.ph_sample, y.ph_sample, 0.006);
+        NEAR(x.temperature, y.temperature, 0.05);
+    }
+
+    // Rollups vieram do /rollups.bin, iguais aos de quem gravou
+    g_now = h.getLastMeasurement().timestamp + MIN_MS;
+    KHRollups::Bucket d1 = h.getLast24h(), d2 = b.getLast24h();
+    CHECK(d1.count > 0 && d1.count == d2.count);
+    NEAR(d1.mean, d2.mean, 1e-6);
+    CHECK(d1.min == d2.min && d1.max == d2.max);
+}
+
+// Filtros de tempo, estatísticas e exportação em blocos
+static void testRangesAndExport() {
+    wipe();
+    MeasurementHistory h;
+    h.begin();
+    for (int i = 0; i < 600; i++) h.addMeasurement(sample(i));   // ~4 dias
+    g_now = h.getLastMeasurement().timestamp;
+
+    CHECK(h.range(MeasurementHistory::LAST_HOUR).size() == 6);
+    CHECK(h.range(MeasurementHistory::LAST_24_HOURS).size() == 144);
+    CHECK(h.range(MeasurementHistory::ALL_DATA).size() == 600);
+    CHECK(h.getFilteredMeasurements(MeasurementHistory::LAST_WEEK).size() == 600);
+
+    uint64_t from = T0_MS + DAY_MS, to = from + DAY_MS;
+    MeasurementHistory::Range r = h.range(from, to);
+    CHECK(r.size() == 144);
+    CHECK(r.begin()->timestamp == from && r.back().timestamp == to - 10 * MIN_MS);
+
+    std::string stats = h.getStatistics(MeasurementHistory::LAST_24_HOURS);
+    CHECK(stats.find("Medições: 138") != std::string::npos);   // 6 inválidas em 144
+
+    StringOut csv;
+    h.writeCSV(csv, from, to);
+    size_t lines = 0;
+    for (char c : csv.s) lines += c == '\n';
+    CHECK(lines == 1 + 144);
+    CHECK(csv.s.compare(0, 10, "Timestamp,") == 0);
+
+    StringOut json;
+    size_t n = h.writeJSON(json);
+    CHECK(n == json.s.size());
+    CHECK(json.s == h.exportAsJSON());
+    CHECK(n == h.getHistoryFileSize());
+    // Blocos de EXPORT_CHUNK (512) menos no máximo uma linha (160), não um
+    // write por campo
+    CHECK(json.calls <= int(n / (512 - 160)) + 2);
+    CHECK(h.exportAsCSV().size() > 600 * 30);
+}
+
+// Anel cheio, medição fora de ordem e limpeza
+static void testCapacityOrderAndClear() {
+    wipe();
+    MeasurementHistory h;
+    h.begin();
+    const int total = int(MeasurementHistory::MAX_MEASUREMENTS) + 200;
+    for (int i = 0; i < total; i++) h.addMeasurement(sample(i));
+    CHECK(h.getCount() == int(MeasurementHistory::MAX_MEASUREMENTS));
+    CHECK(h.getMeasurement(0).timestamp == sample(total - 1).timestamp);
+    CHECK(h.getMeasurement(h.getCount() - 1).timestamp == sample(200).timestamp);
+
+    // NTP falhou: timestamp de millis() no meio do histórico
+    Measurement odd = sample(total);
+    odd.timestamp = 123456;
+    h.addMeasurement(odd);
+    CHECK(h.range(0, 200000).size() == 1);
+    uint64_t from = sample(300).timestamp, to = sample(400).timestamp;
+    CHECK(h.range(from, to).size() == 100);
+
+    MeasurementHistory loaded;
+    loaded.begin();
+    CHECK(loaded.getCount() == h.getCount());
+    CHECK(loaded.range(from, to).size() == 100);
+
+    h.clearHistory();
+    CHECK(h.getCount() == 0 && !h.historyExists() && !rbsFileExists("/rollups.bin"));
+    g_now = sample(total).timestamp;
+    CHECK(h.getLast24h().count == 0);
+}
+
+// Arquivo cortado no meio (queda de energia): fica o que foi lido
+static void testTruncatedFile() {
+    wipe();
+    MeasurementHistory h;
+    h.begin();
+    for (int i = 0; i < 5; i++) h.addMeasurement(sample(i));
+    std::string text = h.exportAsJSON();
+    text.resize(text.size() - 40);
+    writeRaw("/history.json", text.c_str());
+
+    MeasurementHistory b;
+    CHECK(b.loadFromFile());
+    CHECK(b.getCount() == 4);
+
+    writeRaw("/history.json", "{\"outra\":1}");
+    CHECK(!b.loadFromFile());
+}
+
+int main() {
+    rbsSetLogSink(nullptr);
+    rbsSetEpochSource(fakeNow);
+    rbsHostSetFsRoot("history_fs");
+    CHECK(rbsFsBegin());
+
+    testLegacyFile();
+    testRoundTrip();
+    testRangesAndExport();
+    testCapacityOrderAndClear();
+    testTruncatedFile();
+    wipe();
+
+    if (errors) {
+        printf("FALHOU (%d erros)\n", errors);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,403 @@
+// test_lan_link.cpp - LanLink e SHA-256/HMAC com uma rede de mentira
+//
+// Os dois lados rodam no mesmo processo; a "rede" é uma fila de
+// datagramas com perda/adulteração sob controle do teste. O teste com
+// socket de verdade (dois processos) é o lan_loopback.
+//
+// Uso: ctest (ou ./test_lan_link)
+
+#include <ReefBlueSkyCore.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+
+static const uint32_t EPOCH = 1760000000u;
+static const uint8_t KEY[32] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+                                17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32};
+
+static void hex(const uint8_t* d, size_t n, char* out) {
+  for (size_t i = 0; i < n; i++) sprintf(out + 2 * i, "%02x", d[i]);
+}
+
+static void testSha256() {
+  uint8_t h[RBS_SHA256_LEN];
+  char s[65];
+
+  rbsSha256("abc", 3, h);
+  hex(h, 32, s);
+  CHECK(strcmp(s, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad") == 0);
+
+  const char* two = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+  rbsSha256(two, strlen(two), h);
+  hex(h, 32, s);
+  CHECK(strcmp(s, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1") == 0);
+
+  // Em pedaços de tamanhos variados = de uma vez
+  RbsSha256 c;
+  rbsSha256Init(&c);
+  for (size_t i = 0, step = 1; i < strlen(two); i += step, step = step % 7 + 1) {
+    size_t n = strlen(two) - i < step ? strlen(two) - i : step;
+    rbsSha256Update(&c, two + i, n);
+  }
+  uint8_t h2[RBS_SHA256_LEN];
+  rbsSha256Final(&c, h2);
+  CHECK(memcmp(h, h2, 32) == 0);
+
+  // RFC 4231, casos 2 e 6 (chave maior que o bloco)
+  const char* data = "what do ya want for nothing?";
+  rbsHmacSha256((const uint8_t*)"Jefe", 4, data, strlen(data), h);
+  hex(h, 32, s);
+  CHECK(strcmp(s, "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843") == 0);
+
+  uint8_t bigKey[131];
+  memset(bigKey, 0xaa, sizeof(bigKey));
+  const char* msg = "Test Using Larger Than Block-Size Key - Hash Key First";
+  rbsHmacSha256(bigKey, sizeof(bigKey), msg, strlen(msg), h);
+  hex(h, 32, s);
+  CHECK(strcmp(s, "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54") == 0);
+}
+
+// ---------- Rede de mentira ----------
+
+struct Packet {
+  uint32_t from, to;
+  uint16_t port;
+  std::vector<uint8_t> data;
+};
+
+struct Node;
+static std::vector<Packet> wire;
+static std::vector<Node*> nodes;
+static bool (*dropFn)(const Packet&) = nullptr;
+static uint32_t now = 1000;
+
+// Relógio UTC dos nós andando junto com o millis
+static uint32_t epochNow() { return EPOCH + now / 1000; }
+
+struct Node {
+  uint32_t ip;
+  LanLink link;
+  const char* uid;
+  std::vector<uint32_t> doses;
+  std::vector<float> measurements;
+  uint8_t doseStatus = LanLink::ACK_OK;
+  int results = 0;
+  uint8_t lastResult = 0xff, lastAck = 0xff;
+  uint32_t lastRef = 0, lastRtt = 0;
+
+  static void send(void* ctx, uint32_t ip, uint16_t port, const uint8_t* d, size_t n) {
+    Node* self = (Node*)ctx;
+    wire.push_back({self->ip, ip, port, std::vector<uint8_t>(d, d + n)});
+  }
+  static void onMeasurement(void* ctx, const LanLink::Peer&, float kh, uint32_t) {
+    ((Node*)ctx)->measurements.push_back(kh);
+  }
+  static uint8_t onDose(void* ctx, const LanLink::Peer&, uint32_t id, uint8_t, float) {
+    Node* self = (Node*)ctx;
+    if (self->doseStatus == LanLink::ACK_OK) self->doses.push_back(id);
+    return self->doseStatus;
+  }
+  static void onResult(void* ctx, uint8_t, uint32_t ref, uint8_t result, uint8_t ack, uint32_t rtt) {
+    Node* self = (Node*)ctx;
+    self->results++;
+    self->lastRef = ref;
+    self->lastResult = result;
+    self->lastAck = ack;
+    self->lastRtt = rtt;
+  }
+
+  void begin(uint8_t role, uint32_t session, const uint8_t* key = KEY) {
+    LanLink::Config c;
+    c.role = role;
+    c.uid = uid;
+    c.key = key;
+    c.keyLen = 32;
+    c.session = session;
+    LanLink::Handlers h;
+    h.send = send;
+    h.onMeasurement = onMeasurement;
+    h.onDose = onDose;
+    h.onResult = onResult;
+    h.ctx = this;
+    CHECK(link.begin(c, h));
+  }
+};
+
+// Entrega o que está no fio (cada salto custa 2 ms) até esvaziar
+static void pump(int rounds = 10) {
+  for (int r = 0; r < rounds && !wire.empty(); r++) {
+    std::vector<Packet> batch;
+    batch.swap(wire);
+    now += 2;
+    for (const Packet& p : batch) {
+      if (dropFn && dropFn(p)) continue;
+      for (Node* n : nodes) {
+        if (n->ip == p.from) continue;
+        if (p.to == LANLINK_GROUP_IP || p.to == n->ip) {
+          n->link.onDatagram(p.data.data(), p.data.size(), p.from, LANLINK_PORT, now, epochNow());
+        }
+      }
+    }
+  }
+}
+
+static void tick(Node& a, Node& b, uint32_t ms) {
+  for (uint32_t t = 0; t < ms; t += 10) {
+    now += 10;
+    a.link.loop(now, epochNow());
+    b.link.loop(now, epochNow());
+    pump();
+  }
+}
+
+static void reset(Node& mon, Node& dos) {
+  wire.clear();
+  nodes = {&mon, &dos};
+  dropFn = nullptr;
+  mon.uid = "RBS-KH-0001";
+  dos.uid = "RBS-DOSER-0002";
+  mon.ip = 0xC0A80010;
+  dos.ip = 0xC0A80020;
+}
+
+static void testDiscoveryAndMeasurement() {
+  Node mon, dos;
+  reset(mon, dos);
+  mon.begin(LanLink::ROLE_MONITOR, 111);
+  CHECK(!mon.link.requestDose(1, 0, 5.0f, now, epochNow()));   // ninguém na rede ainda
+  dos.begin(LanLink::ROLE_DOSER, 222);
+  tick(mon, dos, 20);
+
+  const LanLink::Peer* d = mon.link.findPeer(LanLink::ROLE_DOSER);
+  const LanLink::Peer* m = dos.link.findPeer(LanLink::ROLE_MONITOR);
+  CHECK(d && strcmp(d->uid, "RBS-DOSER-0002") == 0 && d->ip == dos.ip);
+  CHECK(m && strcmp(m->uid, "RBS-KH-0001") == 0);
+
+  CHECK(mon.link.publishMeasurement(7.85f, EPOCH, now, epochNow()));
+  pump();
+  CHECK(dos.measurements.size() == 1 && dos.measurements[0] == 7.85f);
+  CHECK(mon.results == 1 && mon.lastResult == LanLink::RESULT_ACKED && mon.lastRef == EPOCH);
+  CHECK(mon.lastRtt == 4);   // dois saltos de 2 ms
+  CHECK(mon.link.stats().acked == 1 && mon.link.stats().avgRttMs == 4);
+}
+
+static bool dropFirstAck(const Packet& p) {
+  static int acks = 0;
+  // ACK tem 9 bytes de payload; o primeiro se perde
+  if (p.data.size() == LANLINK_HEADER_LEN + 9 + LANLINK_TAG_LEN && p.data[4] == LanLink::MSG_ACK) {
+    return acks++ == 0;
+  }
+  return false;
+}
+
+static void testDoseRetransmitIsNotReexecuted() {
+  Node mon, dos;
+  reset(mon, dos);
+  mon.begin(LanLink::ROLE_MONITOR, 111);
+  dos.begin(LanLink::ROLE_DOSER, 222);
+  tick(mon, dos, 20);
+
+  dropFn = dropFirstAck;
+  CHECK(mon.link.requestDose(42, 0, 3.25f, now, epochNow()));
+  tick(mon, dos, 400);
+  CHECK(dos.doses.size() == 1 && dos.doses[0] == 42);
+  CHECK(mon.results == 1 && mon.lastResult == LanLink::RESULT_ACKED && mon.lastAck == LanLink::ACK_OK);
+  CHECK(dos.link.stats().duplicates == 1);
+  CHECK(mon.link.stats().retransmits >= 1);
+
+  // Dosadora ocupada: ACK com o status, sem execução
+  dropFn = nullptr;
+  dos.doseStatus = LanLink::ACK_BUSY;
+  CHECK(mon.link.requestDose(43, 0, 1.0f, now, epochNow()));
+  pump();
+  CHECK(mon.results == 2 && mon.lastRef == 43 && mon.lastAck == LanLink::ACK_BUSY);
+  CHECK(dos.doses.size() == 1);
+}
+
+static bool dropAll(const Packet&) {
+  return true;
+}
+
+static void testTimeoutFallsBack() {
+  Node mon, dos;
+  reset(mon, dos);
+  mon.begin(LanLink::ROLE_MONITOR, 111);
+  dos.begin(LanLink::ROLE_DOSER, 222);
+  tick(mon, dos, 20);
+
+  dropFn = dropAll;                   // dosadora caiu da rede
+  uint32_t t0 = now;
+  CHECK(mon.link.requestDose(7, 1, 2.0f, now, epochNow()));
+  while (mon.results == 0 && now - t0 < 5000) tick(mon, dos, 10);
+  CHECK(mon.lastResult == LanLink::RESULT_TIMEOUT && mon.lastRef == 7);
+  CHECK(now - t0 < 1000);             // cai para a nuvem em menos de 1 s
+  CHECK(mon.link.stats().timeouts == 1);
+  CHECK(dos.doses.empty());
+
+  // Sem ANNOUNCE por 2 min o par some
+  tick(mon, dos, LANLINK_PEER_TTL_MS + 1000);
+  CHECK(!mon.link.findPeer(LanLink::ROLE_DOSER));
+}
+
+static std::vector<uint8_t> captured;
+static bool captureDose(const Packet& p) {
+  if (p.data[4] == LanLink::MSG_DOSE_REQUEST && captured.empty()) captured = p.data;
+  return false;
+}
+
+static void testForgeryAndReplay() {
+  Node mon, dos;
+  reset(mon, dos);
+  mon.begin(LanLink::ROLE_MONITOR, 111);
+  dos.begin(LanLink::ROLE_DOSER, 222);
+  tick(mon, dos, 20);
+
+  captured.clear();
+  dropFn = captureDose;
+  CHECK(mon.link.requestDose(5, 0, 1.5f, now, epochNow()));
+  pump();
+  CHECK(dos.doses.size() == 1 && !captured.empty());
+
+  // Replay do mesmo datagrama mais tarde: repete o ACK, não executa
+  dos.link.onDatagram(captured.data(), captured.size(), mon.ip, LANLINK_PORT, now, epochNow());
+  CHECK(dos.doses.size() == 1);
+
+  // Adulterado (volume trocado): tag não confere
+  std::vector<uint8_t> bad = captured;
+  bad[LANLINK_HEADER_LEN + 5] ^= 0x40;
+  bad[20]++;                          // seq novo, para não cair na janela
+  uint32_t auth0 = dos.link.stats().authFailures;
+  dos.link.onDatagram(bad.data(), bad.size(), mon.ip, LANLINK_PORT, now, epochNow());
+  CHECK(dos.link.stats().authFailures == auth0 + 1 && dos.doses.size() == 1);
+
+  // Truncado / lixo
+  dos.link.onDatagram(captured.data(), 20, mon.ip, LANLINK_PORT, now, epochNow());
+  dos.link.onDatagram((const uint8_t*)"RBL\x01garbage-garbage-garbage-garbage-garbage-garbage", 52,
+                      mon.ip, LANLINK_PORT, now, epochNow());
+  CHECK(dos.doses.size() == 1);
+
+  // Monitor de outro usuário na mesma rede: ignorado
+  Node other;
+  other.uid = "RBS-KH-9999";
+  other.ip = 0xC0A80030;
+  uint8_t otherKey[32];
+  memset(otherKey, 0x77, sizeof(otherKey));
+  nodes.push_back(&other);
+  other.begin(LanLink::ROLE_MONITOR, 333, otherKey);
+  other.link.loop(now, epochNow());
+  pump();
+  CHECK(dos.link.stats().foreign >= 1);
+  CHECK(dos.link.peerCount() == 1);
+  CHECK(!other.link.findPeer(LanLink::ROLE_DOSER));
+
+  // Datagrama autêntico mas de 10 min atrás (captura antiga): epoch fora
+  uint32_t rep0 = dos.link.stats().replays;
+  dos.link.onDatagram(captured.data(), captured.size(), mon.ip, LANLINK_PORT, now, epochNow() + 600);
+  CHECK(dos.link.stats().replays == rep0 + 1);
+  CHECK(dos.doses.size() == 1);
+}
+
+static void testPeerReboot() {
+  Node mon, dos;
+  reset(mon, dos);
+  mon.begin(LanLink::ROLE_MONITOR, 111);
+  dos.begin(LanLink::ROLE_DOSER, 222);
+  tick(mon, dos, 20);
+
+  // Dosadora reinicia: seq volta a 1 numa sessão nova
+  dos.begin(LanLink::ROLE_DOSER, 223);
+  tick(mon, dos, 20);
+  CHECK(mon.link.requestDose(9, 0, 1.0f, now, epochNow()));
+  pump();
+  CHECK(dos.doses.size() == 1 && mon.lastAck == LanLink::ACK_OK);
+
+  // Monitor reinicia e manda dose antes de qualquer ANNOUNCE chegar à
+  // dosadora: ela aceita (sessão nova) e aprende o papel pelo ANNOUNCE
+  mon.begin(LanLink::ROLE_MONITOR, 112);
+  dropFn = nullptr;
+  wire.clear();
+  CHECK(!mon.link.requestDose(10, 0, 1.0f, now, epochNow()));  // ainda não conhece a dosadora
+  tick(mon, dos, 20);
+  CHECK(mon.link.requestDose(10, 0, 1.0f, now, epochNow()));
+  pump();
+  CHECK(dos.doses.size() == 2 && dos.doses[1] == 10);
+  const LanLink::Peer* m = dos.link.findPeer(LanLink::ROLE_MONITOR);
+  CHECK(m && m->session == 112);
+}
+
+// Capturas de sessões diferentes alternadas: sessão encerrada não volta
+static void testCrossSessionReplay() {
+  Node mon, dos;
+  reset(mon, dos);
+  mon.begin(LanLink::ROLE_MONITOR, 111);
+  dos.begin(LanLink::ROLE_DOSER, 222);
+  tick(mon, dos, 20);
+
+  captured.clear();
+  dropFn = captureDose;
+  CHECK(mon.link.requestDose(1, 0, 1.0f, now, epochNow()));
+  pump();
+  std::vector<uint8_t> a = captured;
+
+  // Monitor reinicia (sessão 112) e pede outra dose
+  tick(mon, dos, 2000);
+  mon.begin(LanLink::ROLE_MONITOR, 112);
+  tick(mon, dos, 20);
+  captured.clear();
+  CHECK(mon.link.requestDose(2, 0, 1.0f, now, epochNow()));
+  pump();
+  std::vector<uint8_t> b = captured;
+  dropFn = nullptr;
+  CHECK(dos.doses.size() == 2 && !a.empty() && !b.empty());
+
+  // A, B, A, B: antes cada troca de sessão zerava a janela e executava
+  uint32_t rep0 = dos.link.stats().replays;
+  for (int i = 0; i < 4; i++) {
+    const std::vector<uint8_t>& d = i % 2 ? b : a;
+    dos.link.onDatagram(d.data(), d.size(), mon.ip, LANLINK_PORT, now, epochNow());
+  }
+  CHECK(dos.doses.size() == 2);
+  CHECK(dos.link.stats().replays >= rep0 + 2);
+  const LanLink::Peer* m = dos.link.findPeer(LanLink::ROLE_MONITOR);
+  CHECK(m && m->session == 112);
+
+  // Sessão esquecida (mais de LANLINK_OLD_SESSIONS reboots depois): o
+  // epoch dela é mais velho que o último do par
+  for (uint32_t s = 113; s < 113 + LANLINK_OLD_SESSIONS; s++) {
+    tick(mon, dos, 1000);
+    mon.begin(LanLink::ROLE_MONITOR, s);
+    tick(mon, dos, 20);
+    CHECK(mon.link.requestDose(s, 0, 1.0f, now, epochNow()));
+    pump();
+  }
+  CHECK(dos.doses.size() == 2 + LANLINK_OLD_SESSIONS);
+  dos.link.onDatagram(a.data(), a.size(), mon.ip, LANLINK_PORT, now, epochNow());
+  CHECK(dos.doses.size() == 2 + LANLINK_OLD_SESSIONS);
+
+  // Reboot legítimo continua aceito
+  mon.begin(LanLink::ROLE_MONITOR, 200);
+  tick(mon, dos, 20);
+  CHECK(mon.link.requestDose(99, 0, 1.0f, now, epochNow()));
+  pump();
+  CHECK(dos.doses.back() == 99 && mon.lastAck == LanLink::ACK_OK);
+}
+
+int main() {
+  rbsSetLogSink(nullptr);
+  testSha256();
+  testDiscoveryAndMeasurement();
+  testDoseRetransmitIsNotReexecuted();
+  testTimeoutFallsBack();
+  testForgeryAndReplay();
+  testPeerReboot();
+  testCrossSessionReplay();
+  if (errors) {
+    printf("FALHOU (%d erros)\n", errors);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
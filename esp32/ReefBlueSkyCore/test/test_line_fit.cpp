@@ -0,0 +1,184 @@
+// test_line_fit.cpp - testes de host do ajuste de reta (OLS, Theil-Sen, Huber)
+//
+// Uso: ctest (ou ./test_line_fit)
+
+#include <ReefBlueSkyCore.h>
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+#define NEAR(a, b, tol) CHECK(fabs(double(a) - double(b)) <= (tol))
+
+static uint32_t rng = 12345;
+
+static float uniform() {
+  rng = rng * 1664525u + 1013904223u;
+  return (rng >> 8) * (1.0f / 16777216.0f);
+}
+
+static float gauss() {
+  float u1 = uniform() + 1e-7f, u2 = uniform();
+  return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+// Mediana de todas as inclinações, força bruta (referência)
+static float bruteSlope(const float* x, const float* y, size_t n) {
+  std::vector<float> s;
+  for (size_t i = 0; i < n; i++)
+    for (size_t j = i + 1; j < n; j++)
+      if (x[i] != x[j]) s.push_back((y[j] - y[i]) / (x[j] - x[i]));
+  if (s.empty()) return 0;
+  std::sort(s.begin(), s.end());
+  size_t m = s.size();
+  return m % 2 ? s[m / 2] : 0.5f * (s[m / 2 - 1] + s[m / 2]);
+}
+
+static void testTheilSenMatchesBruteForce() {
+  float x[FIT_MAX_POINTS], y[FIT_MAX_POINTS];
+  const size_t sizes[] = { 2, 3, 7, 20, 23, 24, 50, 100, 128 };
+  for (size_t n : sizes) {
+    for (int trial = 0; trial < 5; trial++) {
+      for (size_t i = 0; i < n; i++) {
+        // trial ímpar: x repetidos (medições no mesmo instante)
+        x[i] = trial % 2 ? float(i / 3) : uniform() * 100.0f;
+        y[i] = 8.0f - 0.01f * x[i] + 0.05f * gauss();
+      }
+      float ref = bruteSlope(x, y, n);
+      NEAR(theilSenSlope(x, y, n), ref, 1e-5 * (1 + fabs(ref)));
+    }
+  }
+
+  // Muitas inclinações idênticas (valores inteiros)
+  for (size_t i = 0; i < 100; i++) {
+    x[i] = float(i % 10);
+    y[i] = float((i * 7) % 5);
+  }
+  NEAR(theilSenSlope(x, y, 100), bruteSlope(x, y, 100), 1e-5);
+
+  // Todos os x iguais: sem inclinação
+  for (size_t i = 0; i < 10; i++) x[i] = 3.0f;
+  CHECK(theilSenSlope(x, y, 10) == 0);
+}
+
+static void testExactLine() {
+  float x[30], y[30];
+  for (int i = 0; i < 30; i++) {
+    x[i] = float(i);
+    y[i] = 8.5f - 0.02f * i;
+  }
+  const FitMethod methods[] = { FIT_OLS, FIT_THEIL_SEN, FIT_HUBER };
+  for (FitMethod m : methods) {
+    LineFit f;
+    CHECK(fitLine(m, x, y, 30, f));
+    NEAR(f.slope, -0.02, 1e-5);
+    NEAR(f.intercept, 8.5, 1e-4);
+    NEAR(f.rSquared, 1.0, 1e-4);
+    CHECK(f.n == 30);
+  }
+
+  LineFit f;
+  CHECK(!fitLine(FIT_OLS, x, y, 1, f));
+  CHECK(!fitLine(FIT_HUBER, x, y, FIT_MAX_POINTS + 1, f));
+  float same[5] = { 1, 1, 1, 1, 1 };
+  CHECK(!fitLine(FIT_THEIL_SEN, same, y, 5, f));
+}
+
+// 7% de leituras ruins (bolha): OLS sai da reta, os robustos não
+static void testOutliers() {
+  float x[100], y[100];
+  for (int i = 0; i < 100; i++) {
+    x[i] = float(i);
+    y[i] = 8.0f - 0.01f * i + 0.02f * gauss();
+    if (i % 7 == 3 && i > 50) y[i] += 2.0f;   // só no fim: puxa a inclinação
+  }
+  LineFit ols, ts, hub;
+  CHECK(fitLine(FIT_OLS, x, y, 100, ols));
+  CHECK(fitLine(FIT_THEIL_SEN, x, y, 100, ts));
+  CHECK(fitLine(FIT_HUBER, x, y, 100, hub));
+
+  CHECK(fabs(ols.slope + 0.01) > 0.002);
+  NEAR(ts.slope, -0.01, 0.001);
+  NEAR(hub.slope, -0.01, 0.001);
+  NEAR(hub.intercept, 8.0, 0.02);
+  NEAR(hub.scale, 0.02, 0.01);          // escala do ruído, não dos outliers
+  CHECK(hub.rSquared > 0.9f && ols.rSquared < hub.rSquared);
+}
+
+// Intervalo de 95% cobre ~95% dos pontos futuros com ruído normal
+static void testIntervalCoverage() {
+  CHECK(studentT975(1) > 12.0f && studentT975(1) < 13.0f);
+  NEAR(studentT975(10), 2.228, 1e-3);
+  NEAR(studentT975(1000), 1.96, 0.01);
+  CHECK(studentT975(31) < studentT975(30) && studentT975(31) > 1.96f);
+
+  const int trials = 2000, n = 12;
+  int covered[2] = { 0, 0 };
+  const FitMethod methods[2] = { FIT_OLS, FIT_HUBER };
+  float x[n], y[n];
+  for (int t = 0; t < trials; t++) {
+    for (int i = 0; i < n; i++) {
+      x[i] = float(i);
+      y[i] = 8.0f + 0.01f * i + 0.05f * gauss();
+    }
+    float x0 = n + 3.0f, y0 = 8.0f + 0.01f * x0 + 0.05f * gauss();
+    for (int m = 0; m < 2; m++) {
+      LineFit f;
+      fitLine(methods[m], x, y, n, f);
+      if (fabsf(y0 - f.predict(x0)) <= f.halfInterval(x0)) covered[m]++;
+    }
+  }
+  float ols = float(covered[0]) / trials, hub = float(covered[1]) / trials;
+  CHECK(ols > 0.93f && ols < 0.97f);
+  CHECK(hub > 0.88f && hub < 0.99f);   // escala robusta: aproximação
+}
+
+static void testPredictorEstimator() {
+  const uint64_t T0 = 1700000000000ULL, HOUR = 3600000ULL;
+  KHPredictor p;
+  CHECK(p.getEstimator() == FIT_OLS);
+  // 23 pontos: sem componente de ciclo diário (que usaria max - min)
+  for (int i = 0; i < 23; i++) {
+    float kh = 8.0f - 0.01f * i + ((i % 2) ? 0.01f : -0.01f);
+    if (i == 18) kh = 11.0f;   // leitura ruim perto do fim da série
+    p.addMeasurement(kh, T0 + i * HOUR, 25.0f);
+  }
+  float olsTrend = p.getTrendRate();
+  KHPredictor::PredictionResult ro = p.getPrediction(4);
+
+  p.setEstimator(FIT_HUBER);
+  CHECK(p.getEstimator() == FIT_HUBER);
+  NEAR(p.getTrendRate(), -0.01, 0.001);
+  CHECK(fabs(olsTrend + 0.01) > fabs(p.getTrendRate() + 0.01));
+
+  KHPredictor::PredictionResult r = p.getPrediction(4);
+  CHECK(r.is_valid);
+  NEAR(r.predicted_kh, 8.0 - 0.01 * 26, 0.03);
+  CHECK(r.interval_low < r.predicted_kh && r.predicted_kh < r.interval_high);
+  CHECK(r.interval_high - r.interval_low < ro.interval_high - ro.interval_low);
+  CHECK(r.confidence > ro.confidence);
+
+  // Anomalia: o ponto novo é comparado com a reta sem ele
+  CHECK(!p.detectAnomaly());
+  p.addMeasurement(9.5f, T0 + 23 * HOUR, 25.0f);
+  CHECK(p.detectAnomaly());
+  p.setEstimator(FIT_THEIL_SEN);
+  CHECK(p.detectAnomaly());
+}
+
+int main() {
+  rbsSetLogSink(nullptr);
+  testTheilSenMatchesBruteForce();
+  testExactLine();
+  testOutliers();
+  testIntervalCoverage();
+  testPredictorEstimator();
+  if (errors) {
+    printf("FALHOU (%d erros)\n", errors);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,163 @@
+// test_rollups.cpp - testes de host do KHRollups (agregados hora/dia/semana)
+//
+// Uso: ctest (ou ./test_rollups)
+
+#include <ReefBlueSkyCore.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+#define NEAR(a, b, tol) CHECK(fabs(double(a) - double(b)) <= (tol))
+
+static const uint32_t HOUR   = 3600;
+static const uint32_t DAY    = 86400;
+static const uint32_t MONDAY = 1704067200;   // 2024-01-01 00:00 UTC, segunda
+
+// Estatística direta (referência)
+struct Ref {
+  uint32_t n = 0;
+  double sum = 0, sum2 = 0, mn = 1e9, mx = -1e9, last = 0;
+  void add(float v) {
+    n++; sum += v; sum2 += double(v) * v; last = v;
+    if (v < mn) mn = v;
+    if (v > mx) mx = v;
+  }
+  double mean() const { return sum / n; }
+  double var() const { return sum2 / n - mean() * mean(); }
+};
+
+static float khAt(uint32_t i) {
+  return 8.0f + 0.3f * sinf(i * 0.26f) + 0.01f * (float)(i % 7);
+}
+
+static void testBucketStart() {
+  CHECK(KHRollups::bucketStart(KHRollups::HOURLY, MONDAY + 5399) == MONDAY + HOUR);
+  CHECK(KHRollups::bucketStart(KHRollups::DAILY, MONDAY + DAY + 10) == MONDAY + DAY);
+  CHECK(KHRollups::bucketStart(KHRollups::WEEKLY, MONDAY + 6 * DAY + 86399) == MONDAY);
+  CHECK(KHRollups::bucketStart(KHRollups::WEEKLY, MONDAY + 7 * DAY) == MONDAY + 7 * DAY);
+  CHECK(KHRollups::bucketStart(KHRollups::WEEKLY, MONDAY - 1) == MONDAY - 7 * DAY);
+}
+
+// Uma medição a cada 20 min por 10 dias: últimas 24 h batem com o cálculo direto
+static void testLast24hMatchesScan() {
+  KHRollups r;
+  std::vector<std::pair<uint32_t, float>> all;
+  uint32_t t = MONDAY;
+  for (uint32_t i = 0; i < 10 * 72; i++, t += 20 * 60) {
+    float kh = khAt(i);
+    CHECK(r.add(t, kh));
+    all.push_back({t, kh});
+  }
+  uint32_t now = t - 20 * 60 + 5;
+
+  CHECK(r.size(KHRollups::HOURLY) == KHRollups::HOURLY_BUCKETS);
+  CHECK(r.size(KHRollups::DAILY) == 10);
+  CHECK(r.size(KHRollups::WEEKLY) == 2);
+
+  // resolução de 1 h: o bucket do início do período entra inteiro
+  uint32_t from = KHRollups::bucketStart(KHRollups::HOURLY, now - 24 * HOUR);
+  Ref ref;
+  for (auto& p : all) if (p.first >= from) ref.add(p.second);
+
+  KHRollups::Bucket w = r.last24h(now);
+  CHECK(w.count == ref.n);
+  CHECK(w.start == from);
+  NEAR(w.mean, ref.mean(), 1e-4);
+  NEAR(w.variance(), ref.var(), 1e-4);
+  NEAR(w.min, ref.mn, 1e-6);
+  NEAR(w.max, ref.mx, 1e-6);
+  NEAR(w.last, ref.last, 1e-6);
+
+  // 7 dias: nível diário
+  uint32_t from7 = KHRollups::bucketStart(KHRollups::DAILY, now - 7 * DAY);
+  Ref ref7;
+  for (auto& p : all) if (p.first >= from7) ref7.add(p.second);
+  KHRollups::Bucket w7 = r.window(now, 7 * DAY);
+  CHECK(w7.count == ref7.n);
+  NEAR(w7.mean, ref7.mean(), 1e-4);
+  NEAR(w7.stdDev(), sqrt(ref7.var()), 1e-3);
+
+  // Tudo: nível semanal soma todas as medições
+  KHRollups::Bucket all90 = r.window(now, 90 * DAY);
+  CHECK(all90.count == all.size());
+}
+
+static void testOutOfOrderAndEmpty() {
+  KHRollups r;
+  KHRollups::Bucket e = r.last24h(MONDAY);
+  CHECK(e.count == 0);
+
+  CHECK(r.add(MONDAY + 10 * HOUR + 100, 8.0f));
+  CHECK(r.add(MONDAY + 10 * HOUR + 50, 9.0f));       // mesmo bucket, fora de ordem
+  CHECK(!r.add(MONDAY + 2 * HOUR, 7.0f));            // bucket horário não existe mais
+  CHECK(!r.add(MONDAY, NAN));
+
+  const KHRollups::Bucket* b = r.bucketAt(KHRollups::HOURLY, MONDAY + 10 * HOUR);
+  CHECK(b && b->count == 2 && b->min == 8.0f && b->max == 9.0f);
+  CHECK(r.bucketAt(KHRollups::HOURLY, MONDAY + 11 * HOUR) == nullptr);
+  // o diário e o semanal aceitaram a medição antiga
+  CHECK(r.bucketAt(KHRollups::DAILY, MONDAY)->count == 3);
+
+  r.clear();
+  CHECK(r.size(KHRollups::HOURLY) == 0 && r.size(KHRollups::WEEKLY) == 0);
+}
+
+// Juntar duas metades = agregar tudo de uma vez
+static void testMerge() {
+  KHRollups a, b, all;
+  for (uint32_t i = 0; i < 40; i++) {
+    (i < 15 ? a : b).add(MONDAY + i * 60, khAt(i));
+    all.add(MONDAY + i * 60, khAt(i));
+  }
+  KHRollups::Bucket m = *a.bucketAt(KHRollups::HOURLY, MONDAY);
+  KHRollups::merge(m, *b.bucketAt(KHRollups::HOURLY, MONDAY));
+  const KHRollups::Bucket& ref = *all.bucketAt(KHRollups::HOURLY, MONDAY);
+  CHECK(m.count == ref.count);
+  NEAR(m.mean, ref.mean, 1e-5);
+  NEAR(m.m2, ref.m2, 1e-4);
+  CHECK(m.min == ref.min && m.max == ref.max && m.last == ref.last);
+}
+
+static void testSaveLoad() {
+  KHRollups r;
+  for (uint32_t i = 0; i < 500; i++) r.add(MONDAY + i * 9 * HOUR, khAt(i));   // ~187 dias
+
+  std::vector<uint8_t> buf(KHRollups::SAVE_SIZE);
+  size_t n = r.save(buf.data(), buf.size());
+  CHECK(n == KHRollups::SAVE_SIZE);     // todos os níveis cheios
+  CHECK(r.save(buf.data(), 10) == 0);
+
+  KHRollups back;
+  CHECK(back.load(buf.data(), n));
+  for (uint8_t t = 0; t < KHRollups::TIER_COUNT; t++) {
+    KHRollups::Tier tier = (KHRollups::Tier)t;
+    CHECK(back.size(tier) == r.size(tier));
+    CHECK(memcmp(&back.bucket(tier, 0), &r.bucket(tier, 0), sizeof(KHRollups::Bucket)) == 0);
+  }
+  uint32_t end = MONDAY + 500 * 9 * HOUR;
+  KHRollups::Bucket w1 = r.last24h(end), w2 = back.last24h(end);
+  CHECK(w1.count > 0 && w1.count == w2.count && w1.mean == w2.mean);
+
+  CHECK(!back.load(buf.data(), n - 1));
+  buf[0] ^= 0xFF;
+  CHECK(!back.load(buf.data(), n));
+  CHECK(back.size(KHRollups::HOURLY) == r.size(KHRollups::HOURLY));   // falha não apaga
+}
+
+int main() {
+  rbsSetLogSink(nullptr);
+  testBucketStart();
+  testLast24hMatchesScan();
+  testOutOfOrderAndEmpty();
+  testMerge();
+  testSaveLoad();
+  if (errors) {
+    printf("FALHOU (%d erros)\n", errors);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
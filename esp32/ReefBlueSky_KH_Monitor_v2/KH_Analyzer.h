@@ -5,7 +5,7 @@
 #include <Arduino.h>
 #include "PumpControl.h"
 #include "SensorManager.h"
-#include "KH_Predictor.h"
+#include <ReefBlueSkyCore.h>
 #include <SPIFFS.h>
 #include "TimeProvider.h"
 
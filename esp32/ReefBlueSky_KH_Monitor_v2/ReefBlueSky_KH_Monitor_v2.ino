@@ -23,8 +23,7 @@
 #include "SensorManager.h"
 #include "KH_Analyzer.h"
 #include "WiFi_MQTT.h"
-#include "KH_Predictor.h"
-#include "MeasurementHistory.h"
+#include <ReefBlueSkyCore.h>
 #include "MultiDeviceAuth.h"
 #include "WiFiSetup.h"
 #include "CloudAuth.h"
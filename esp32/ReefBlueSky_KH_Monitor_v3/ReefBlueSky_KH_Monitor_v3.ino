@@ -22,8 +22,7 @@
 #include "SensorManager.h"
 #include "Safety.h" 
 #include "KH_Analyzer.h"
-#include "KH_Predictor.h"
-#include "MeasurementHistory.h"
+#include <ReefBlueSkyCore.h>
 void wifiFactoryReset(); 
 #include "MultiDeviceAuth.h"
 #include "WiFiSetup.h"
@@ -0,0 +1,595 @@
+//BinLog.cpp
+#include "BinLog.h"
+#include "MultiDeviceAuth.h"
+#include <SPIFFS.h>
+#include <sys/time.h>
+
+extern const char* CLOUD_BASE_URL;
+
+BinLog debugLog;
+
+static const char* const LEVEL_NAMES[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+
+static const char* levelName(uint8_t level) {
+  return level <= BLOG_ERROR ? LEVEL_NAMES[level] : "?";
+}
+
+// Anel e contadores ficam em RTC slow memory (RTC_NOINIT_ATTR): sobrevivem
+// a panic, WDT e ESP.restart(). No boot seguinte begin() grava no SPIFFS o
+// que ainda não tinha sido salvo. Power-on deixa lixo aqui: rtcValid() recusa.
+#define BINLOG_RTC_MAGIC 0x52424c52   // "RBLR"
+
+struct BinLogRtc {
+  uint32_t magic;
+  uint32_t head;       // posições absolutas (só crescem)
+  uint32_t tail;
+  uint32_t saved;      // até onde já foi para o SPIFFS
+  uint32_t dropped;    // registros descartados sem upload
+  uint32_t check;
+  uint8_t  ring[BINLOG_RING_SIZE];
+};
+
+static RTC_NOINIT_ATTR BinLogRtc s_rtc;
+
+static uint32_t rtcCheck() {
+  return BINLOG_RTC_MAGIC ^ s_rtc.head ^ (s_rtc.tail * 3) ^ (s_rtc.saved * 5) ^ (s_rtc.dropped * 7);
+}
+
+// Contadores coerentes e registros encadeados exatamente de tail até head
+static bool rtcValid() {
+  if (s_rtc.magic != BINLOG_RTC_MAGIC || s_rtc.check != rtcCheck()) return false;
+  if (s_rtc.head - s_rtc.tail > BINLOG_RING_SIZE) return false;
+  if ((int32_t)(s_rtc.head - s_rtc.saved) < 0) return false;
+  uint32_t pos = s_rtc.tail;
+  while (pos != s_rtc.head) {
+    uint8_t len = s_rtc.ring[pos & (BINLOG_RING_SIZE - 1)];
+    if (len < BINLOG_REC_HDR || (int32_t)(s_rtc.head - (pos + len)) < 0) return false;
+    pos += len;
+  }
+  return true;
+}
+
+BinLog::BinLog() {
+  if (rtcValid()) {
+    uint32_t from = (int32_t)(s_rtc.saved - s_rtc.tail) > 0 ? s_rtc.saved : s_rtc.tail;
+    _recovered = s_rtc.head - from;
+  } else {
+    s_rtc.magic = BINLOG_RTC_MAGIC;
+    s_rtc.head = s_rtc.tail = s_rtc.saved = s_rtc.dropped = 0;
+    s_rtc.check = rtcCheck();
+  }
+}
+
+uint32_t BinLog::dropped() const { return s_rtc.dropped; }
+
+// Epoch em ms se o NTP já sincronizou; senão millis() (o backend converte
+// usando millis()/epoch do cabeçalho do frame)
+uint64_t BinLog::timestampMs() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  if (tv.tv_sec >= 1577836800) {   // 01/01/2020
+    return (uint64_t)tv.tv_sec * 1000ULL + tv.tv_usec / 1000;
+  }
+  return millis();
+}
+
+bool BinLog::registerFormat(uint32_t id, const char* fmt) {
+  bool ok = false;
+  portENTER_CRITICAL(&_mux);
+  if (_fmtCount < BINLOG_MAX_FMTS) {
+    _fmts[_fmtCount++] = {id, fmt};
+    ok = true;
+  }
+  portEXIT_CRITICAL(&_mux);
+  return ok;
+}
+
+const char* BinLog::findFormat(uint32_t id) const {
+  for (uint16_t i = 0; i < _fmtCount; i++) {
+    if (_fmts[i].id == id) return _fmts[i].fmt;
+  }
+  return nullptr;
+}
+
+void BinLog::push(const BinLogRecord& r) {
+  const uint32_t mask = BINLOG_RING_SIZE - 1;
+  portENTER_CRITICAL(&_mux);
+  // Anel cheio: descarta os registros mais antigos
+  while (BINLOG_RING_SIZE - (s_rtc.head - s_rtc.tail) < r.len) {
+    s_rtc.tail += s_rtc.ring[s_rtc.tail & mask];
+    s_rtc.dropped++;
+  }
+  uint32_t at = s_rtc.head & mask;
+  uint32_t first = min((uint32_t)r.len, BINLOG_RING_SIZE - at);
+  memcpy(s_rtc.ring + at, r.buf, first);
+  memcpy(s_rtc.ring, r.buf + first, r.len - first);
+  s_rtc.head += r.len;
+  s_rtc.check = rtcCheck();
+  portEXIT_CRITICAL(&_mux);
+}
+
+bool BinLog::copyOut(uint32_t pos, uint8_t* dst, size_t n) {
+  const uint32_t mask = BINLOG_RING_SIZE - 1;
+  bool ok;
+  portENTER_CRITICAL(&_mux);
+  ok = (int32_t)(pos - s_rtc.tail) >= 0 && (int32_t)(s_rtc.head - (pos + n)) >= 0;
+  if (ok) {
+    uint32_t at = pos & mask;
+    size_t first = min(n, (size_t)(BINLOG_RING_SIZE - at));
+    memcpy(dst, s_rtc.ring + at, first);
+    memcpy(dst + first, s_rtc.ring, n - first);
+  }
+  portEXIT_CRITICAL(&_mux);
+  return ok;
+}
+
+void BinLog::echo(uint8_t level, const BinLogRecord& r, const char* msg) {
+  uint64_t ts;
+  memcpy(&ts, r.buf + 6, 8);
+  Serial.printf("[%s] %llu: %s\n", levelName(level), (unsigned long long)ts, msg);
+}
+
+void BinLog::frameHeader(uint8_t* hdr, uint32_t bodyLen, uint8_t flags) {
+  uint32_t up = millis();
+  uint64_t epoch = timestampMs();
+  if (epoch == up) epoch = 0;
+  memset(hdr, 0, BINLOG_FRAME_HDR);
+  memcpy(hdr, "RBLG", 4);
+  hdr[4] = BINLOG_VERSION;
+  hdr[5] = flags;
+  memcpy(hdr + 8, &bodyLen, 4);
+  memcpy(hdr + 12, &s_rtc.dropped, 4);
+  memcpy(hdr + 16, &up, 4);
+  memcpy(hdr + 20, &epoch, 8);
+}
+
+// ---------- Formatação no device ----------
+
+size_t BinLog::format(const uint8_t* rec, char* out, size_t n) const {
+  uint8_t len = rec[0];
+  uint32_t id;
+  uint64_t ts;
+  memcpy(&id, rec + 2, 4);
+  memcpy(&ts, rec + 6, 8);
+
+  size_t o = snprintf(out, n, "[%s] %llu: ", levelName(rec[1]), (unsigned long long)ts);
+  const uint8_t* a = rec + BINLOG_REC_HDR;
+  const uint8_t* end = rec + len;
+  const char* fmt = findFormat(id);
+  const bool known = fmt != nullptr;
+  if (!known) {
+    if (o < n) o += snprintf(out + o, n - o, "#%08x", (unsigned)id);
+    fmt = "";
+  }
+
+  // Percorre o formato; cada especificador consome o próximo argumento
+  char spec[16];
+  for (const char* p = fmt; *p && o + 1 < n; ) {
+    if (*p != '%') { out[o++] = *p++; continue; }
+    if (p[1] == '%') { out[o++] = '%'; p += 2; continue; }
+
+    size_t s = 0;
+    spec[s++] = *p++;
+    while (*p && strchr("-+ #0123456789.", *p) && s < sizeof(spec) - 3) spec[s++] = *p++;
+    while (*p && strchr("hlLzjt", *p)) p++;   // tamanho vem do tipo gravado
+    char conv = *p ? *p++ : 'd';
+
+    if (a >= end) break;
+    uint8_t type = *a++;
+    int w = 0;
+    switch (type) {
+      case BLOG_ARG_I32: case BLOG_ARG_U32: {
+        uint32_t v; memcpy(&v, a, 4); a += 4;
+        if (conv == 's' || conv == 'f') conv = type == BLOG_ARG_I32 ? 'd' : 'u';
+        spec[s++] = conv; spec[s] = 0;
+        w = conv == 'd' || conv == 'i' ? snprintf(out + o, n - o, spec, (int)v)
+                                       : snprintf(out + o, n - o, spec, (unsigned)v);
+        break;
+      }
+      case BLOG_ARG_I64: case BLOG_ARG_U64: {
+        uint64_t v; memcpy(&v, a, 8); a += 8;
+        spec[s++] = 'l'; spec[s++] = 'l';
+        spec[s++] = type == BLOG_ARG_I64 ? 'd' : (conv == 'x' || conv == 'X' ? conv : 'u');
+        spec[s] = 0;
+        w = snprintf(out + o, n - o, spec, (unsigned long long)v);
+        break;
+      }
+      case BLOG_ARG_F32: {
+        float v; memcpy(&v, a, 4); a += 4;
+        spec[s++] = strchr("eEgG", conv) ? conv : 'f'; spec[s] = 0;
+        w = snprintf(out + o, n - o, spec, (double)v);
+        break;
+      }
+      case BLOG_ARG_STR: {
+        uint8_t sl = *a++;
+        w = snprintf(out + o, n - o, "%.*s", (int)sl, (const char*)a);
+        a += sl;
+        break;
+      }
+      default:
+        a = end;
+        break;
+    }
+    if (w > 0) o += w;
+  }
+
+  // Formato desconhecido: só os valores, separados por espaço
+  while (!known && a < end && o + 1 < n) {
+    uint8_t type = *a++;
+    int w = 0;
+    if (type == BLOG_ARG_I32)      { int32_t v;  memcpy(&v, a, 4); a += 4; w = snprintf(out + o, n - o, " %ld", (long)v); }
+    else if (type == BLOG_ARG_U32) { uint32_t v; memcpy(&v, a, 4); a += 4; w = snprintf(out + o, n - o, " %lu", (unsigned long)v); }
+    else if (type == BLOG_ARG_I64) { int64_t v;  memcpy(&v, a, 8); a += 8; w = snprintf(out + o, n - o, " %lld", (long long)v); }
+    else if (type == BLOG_ARG_U64) { uint64_t v; memcpy(&v, a, 8); a += 8; w = snprintf(out + o, n - o, " %llu", (unsigned long long)v); }
+    else if (type == BLOG_ARG_F32) { float v;    memcpy(&v, a, 4); a += 4; w = snprintf(out + o, n - o, " %g", (double)v); }
+    else if (type == BLOG_ARG_STR) { uint8_t sl = *a++; w = snprintf(out + o, n - o, " %.*s", (int)sl, (const char*)a); a += sl; }
+    else break;
+    if (w > 0) o += w;
+  }
+
+  if (o >= n) o = n - 1;
+  out[o] = '\0';
+  return o;
+}
+
+// ---------- SPIFFS ----------
+
+// Segmentos /blog0.bin../blogN.bin: cabeçalho "RBLS" + u32 seq, depois frames
+// RBLG. Só se acrescenta ao segmento de maior seq; cheio, o próximo índice
+// (o mais antigo) é truncado e recebe seq + 1.
+static void segPath(char* out, size_t n, uint8_t idx) {
+  snprintf(out, n, "/blog%u.bin", (unsigned)idx);
+}
+
+// Tamanho válido do segmento (frames inteiros); seq em *seq. 0 = inválido
+static size_t segScan(uint8_t idx, uint32_t* seq, bool* torn) {
+  char path[16];
+  segPath(path, sizeof(path), idx);
+  *torn = false;
+  if (!SPIFFS.exists(path)) return 0;
+  File f = SPIFFS.open(path, FILE_READ);
+  if (!f) return 0;
+
+  uint8_t hdr[BINLOG_FRAME_HDR];
+  size_t size = f.size(), good = 0;
+  if (f.read(hdr, BINLOG_SEG_HDR) == BINLOG_SEG_HDR && memcmp(hdr, "RBLS", 4) == 0) {
+    memcpy(seq, hdr + 4, 4);
+    good = BINLOG_SEG_HDR;
+    while (good + BINLOG_FRAME_HDR <= size) {
+      f.seek(good);
+      if (f.read(hdr, BINLOG_FRAME_HDR) != BINLOG_FRAME_HDR || memcmp(hdr, "RBLG", 4) != 0) break;
+      uint32_t body;
+      memcpy(&body, hdr + 8, 4);
+      if (good + BINLOG_FRAME_HDR + body > size) break;
+      good += BINLOG_FRAME_HDR + body;
+    }
+    *torn = good != size;
+  }
+  f.close();
+  return good;
+}
+
+void BinLog::begin() {
+  if (!SPIFFS.begin(true)) return;
+
+  // arquivo único das versões anteriores
+  if (SPIFFS.exists("/debug_log.txt")) SPIFFS.remove("/debug_log.txt");
+  if (SPIFFS.exists("/debug_log.bin")) SPIFFS.remove("/debug_log.bin");
+
+  // Segmento atual = maior seq. Se terminou no meio de um frame (queda de
+  // energia durante a gravação), não acrescenta depois do lixo: rotaciona.
+  _segSeq = 0;
+  _seg = BINLOG_SEGMENTS - 1;
+  _segSize = BINLOG_SEG_SIZE;
+  for (uint8_t i = 0; i < BINLOG_SEGMENTS; i++) {
+    uint32_t seq = 0;
+    bool torn;
+    size_t size = segScan(i, &seq, &torn);
+    if (size > 0 && seq > _segSeq) {
+      _segSeq = seq;
+      _seg = i;
+      _segSize = torn ? BINLOG_SEG_SIZE : size;
+    }
+  }
+  _ready = true;
+
+  if (_recovered > 0) {
+    Serial.printf("[Logger] %u bytes de log recuperados da RTC (reboot a quente)\n",
+                  (unsigned)_recovered);
+    saveToSPIFFS();
+    _recovered = 0;
+  }
+}
+
+bool BinLog::rotate() {
+  char path[16];
+  _seg = (_seg + 1) % BINLOG_SEGMENTS;
+  _segSeq++;
+  segPath(path, sizeof(path), _seg);
+  File f = SPIFFS.open(path, FILE_WRITE);
+  if (!f) return false;
+  uint8_t hdr[BINLOG_SEG_HDR];
+  memcpy(hdr, "RBLS", 4);
+  memcpy(hdr + 4, &_segSeq, 4);
+  bool ok = f.write(hdr, sizeof(hdr)) == sizeof(hdr);
+  f.close();
+  _segSize = ok ? BINLOG_SEG_HDR : BINLOG_SEG_SIZE;
+  return ok;
+}
+
+// Grava [from, to) do anel como um frame no segmento atual
+bool BinLog::appendFrame(uint32_t from, uint32_t to) {
+  char path[16];
+  segPath(path, sizeof(path), _seg);
+  File f = SPIFFS.open(path, FILE_APPEND);
+  if (!f) return false;
+
+  uint8_t buf[256];
+  frameHeader(buf, to - from, 0);
+  size_t wrote = f.write(buf, BINLOG_FRAME_HDR);
+  for (uint32_t pos = from; pos != to; ) {
+    size_t n = min((uint32_t)sizeof(buf), to - pos);
+    if (!copyOut(pos, buf, n)) {
+      // sobrescrito enquanto gravava: completa o frame com zeros (registro
+      // de tamanho 0 = leitor pula para o próximo frame)
+      memset(buf, 0, n);
+    }
+    wrote += f.write(buf, n);
+    pos += n;
+  }
+  f.close();
+  _segSize += wrote;
+  return wrote == BINLOG_FRAME_HDR + (to - from);
+}
+
+void BinLog::loop() {
+  if (!_errorPending || millis() - _lastErrorSave < BINLOG_ERROR_SAVE_MS) return;
+  saveToSPIFFS();
+}
+
+void BinLog::saveToSPIFFS() {
+  if (!_ready) return;
+  _errorPending = false;
+  _lastErrorSave = millis();
+
+  uint32_t from, to;
+  portENTER_CRITICAL(&_mux);
+  from = (int32_t)(s_rtc.saved - s_rtc.tail) > 0 ? s_rtc.saved : s_rtc.tail;
+  to = s_rtc.head;
+  portEXIT_CRITICAL(&_mux);
+  const uint32_t total = to - from;
+
+  // Só o que ainda não foi salvo, em frames de registros inteiros que caibam
+  // no segmento atual
+  while (from != to) {
+    uint32_t room = _segSize + BINLOG_FRAME_HDR < BINLOG_SEG_SIZE
+                  ? BINLOG_SEG_SIZE - _segSize - BINLOG_FRAME_HDR : 0;
+    uint32_t end = from;
+    uint8_t len;
+    while (end != to && copyOut(end, &len, 1) && end + len - from <= room) end += len;
+
+    if (end == from) {
+      if (!copyOut(from, &len, 1)) {
+        // anel passou por cima do início: recomeça do registro mais antigo
+        portENTER_CRITICAL(&_mux);
+        from = s_rtc.tail;
+        portEXIT_CRITICAL(&_mux);
+        if ((int32_t)(to - from) <= 0) break;
+        continue;
+      }
+      if (_segSize == BINLOG_SEG_HDR || !rotate()) break;   // nem num segmento vazio
+      continue;
+    }
+    if (!appendFrame(from, end)) {
+      Serial.println("[Logger] Falha ao gravar segmento de log");
+      _segSize = BINLOG_SEG_SIZE;   // próximo save começa segmento novo
+      break;
+    }
+    from = end;
+    portENTER_CRITICAL(&_mux);
+    s_rtc.saved = from;
+    s_rtc.check = rtcCheck();
+    portEXIT_CRITICAL(&_mux);
+  }
+  if (total > 0) {
+    Serial.printf("[Logger] %u bytes de log salvos (segmento %u, seq %u)\n",
+                  (unsigned)total, (unsigned)_seg, (unsigned)_segSeq);
+  }
+}
+
+// Percorre os registros salvos, do segmento mais antigo para o mais novo
+template <typename F>
+void BinLog::forEachSaved(F fn) {
+  if (!_ready) return;
+
+  uint8_t order[BINLOG_SEGMENTS];
+  uint32_t seqs[BINLOG_SEGMENTS];
+  size_t sizes[BINLOG_SEGMENTS];
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < BINLOG_SEGMENTS; i++) {
+    uint32_t seq = 0;
+    bool torn;
+    size_t size = segScan(i, &seq, &torn);
+    if (size == 0) continue;
+    uint8_t k = count++;
+    while (k > 0 && seqs[order[k - 1]] > seq) { order[k] = order[k - 1]; k--; }
+    order[k] = i;
+    seqs[i] = seq;
+    sizes[i] = size;
+  }
+
+  char path[16];
+  uint8_t hdr[BINLOG_FRAME_HDR];
+  uint8_t rec[256];
+  for (uint8_t k = 0; k < count; k++) {
+    segPath(path, sizeof(path), order[k]);
+    File f = SPIFFS.open(path, FILE_READ);
+    if (!f) continue;
+    size_t pos = BINLOG_SEG_HDR;
+    while (pos + BINLOG_FRAME_HDR <= sizes[order[k]]) {
+      f.seek(pos);
+      f.read(hdr, sizeof(hdr));
+      uint32_t body;
+      memcpy(&body, hdr + 8, 4);
+      size_t frameEnd = pos + BINLOG_FRAME_HDR + body;
+      while (body >= BINLOG_REC_HDR) {
+        int len = f.read();
+        if (len < BINLOG_REC_HDR || (uint32_t)len > body) break;
+        rec[0] = (uint8_t)len;
+        if (f.read(rec + 1, len - 1) != (size_t)(len - 1)) break;
+        fn(rec);
+        body -= len;
+      }
+      pos = frameEnd;
+    }
+    f.close();
+  }
+}
+
+void BinLog::loadFromSPIFFS() {
+  char line[200];
+  bool any = false;
+  forEachSaved([&](const uint8_t* rec) {
+    if (!any) Serial.println("[Logger] Logs salvos no SPIFFS:");
+    any = true;
+    format(rec, line, sizeof(line));
+    Serial.println(line);
+  });
+}
+
+// [NOVO] Enviar logs como alerta por email/Telegram após boot
+void BinLog::sendLogsAsAlert() {
+  // Duas passadas no arquivo: conta, depois formata só os últimos MAX_LINES
+  const int MAX_LINES = 10;
+  int count = 0;
+  forEachSaved([&](const uint8_t*) { count++; });
+  if (count == 0) return;
+
+  char logContent[1000];   // limite de 1000 chars para alertas
+  size_t o = 0;
+  int i = 0;
+  forEachSaved([&](const uint8_t* rec) {
+    if (i++ < count - MAX_LINES || o + 2 >= sizeof(logContent)) return;
+    o += format(rec, logContent + o, sizeof(logContent) - o - 1);
+    logContent[o++] = '\n';
+  });
+  logContent[o] = '\0';
+
+  String alertMsg = "🔄 BOOT DETECTED - Últimos logs:\n\n";
+  alertMsg += logContent;
+  sendAlert("Device Boot", alertMsg, "medium");
+  Serial.println("[Logger] Logs enviados por email/Telegram após boot");
+}
+
+// ---------- Upload ----------
+
+// Stream do frame [cabeçalho][registros from..to) lido direto do anel
+class BinLogStream : public Stream {
+public:
+  BinLogStream(BinLog& log, uint32_t from, uint32_t to) : _log(log), _pos(from), _to(to) {
+    log.frameHeader(_hdr, to - from, 0);
+  }
+  size_t size() const { return BINLOG_FRAME_HDR + (_to - _pos); }
+  bool overrun() const { return _overrun; }
+
+  int available() override {
+    if (_overrun) return 0;
+    return (BINLOG_FRAME_HDR - _hdrPos) + (_to - _pos);
+  }
+  size_t readBytes(char* buffer, size_t length) override {
+    size_t n = 0;
+    while (n < length && _hdrPos < BINLOG_FRAME_HDR) buffer[n++] = _hdr[_hdrPos++];
+    size_t body = min(length - n, (size_t)(_to - _pos));
+    if (body > 0 && !_overrun) {
+      if (_log.copyOut(_pos, (uint8_t*)buffer + n, body)) {
+        _pos += body;
+        n += body;
+      } else {
+        _overrun = true;
+      }
+    }
+    return n;
+  }
+  int read() override {
+    char c;
+    return readBytes(&c, 1) == 1 ? (uint8_t)c : -1;
+  }
+  int peek() override { return -1; }
+  size_t write(uint8_t) override { return 0; }
+  void flush() override {}
+
+private:
+  BinLog&  _log;
+  uint32_t _pos, _to;
+  uint8_t  _hdr[BINLOG_FRAME_HDR];
+  uint8_t  _hdrPos = 0;
+  bool     _overrun = false;
+};
+
+void BinLog::syncToServer() {
+  if (WiFi.status() != WL_CONNECTED || deviceToken.length() == 0) return;
+  if (millis() - _lastSync < SYNC_INTERVAL) return;
+
+  uint32_t from, to, dropped;
+  portENTER_CRITICAL(&_mux);
+  from = s_rtc.tail;
+  to = s_rtc.head;
+  dropped = s_rtc.dropped;
+  portEXIT_CRITICAL(&_mux);
+  if (from == to) return;
+
+  HTTPClient http;
+  if (!http.begin(String(CLOUD_BASE_URL) + "/device/logs")) return;
+  http.addHeader("Content-Type", "application/octet-stream");
+  http.addHeader("Authorization", "Bearer " + deviceToken);
+
+  BinLogStream body(*this, from, to);
+  int code = http.sendRequest("POST", &body, body.size());
+  http.end();
+
+  if ((code == 200 || code == 201) && !body.overrun()) {
+    Serial.println("[Logger] Logs enviados ao servidor com sucesso");
+    markSent({ to, dropped });
+  }
+}
+
+size_t BinLog::pendingFrame(uint8_t* out, size_t max, BinLogMark& mark) {
+  if (max <= BINLOG_FRAME_HDR) return 0;
+  uint32_t from, head;
+  portENTER_CRITICAL(&_mux);
+  from = s_rtc.tail;
+  head = s_rtc.head;
+  mark.dropped = s_rtc.dropped;
+  portEXIT_CRITICAL(&_mux);
+
+  // Registros inteiros até o limite; se o anel andar no meio, desiste
+  uint32_t to = from;
+  size_t room = max - BINLOG_FRAME_HDR;
+  while (to != head) {
+    uint8_t len;
+    if (!copyOut(to, &len, 1) || len < BINLOG_REC_HDR) return 0;
+    if (to + len - from > room) break;
+    to += len;
+  }
+  if (to == from || !copyOut(from, out + BINLOG_FRAME_HDR, to - from)) return 0;
+
+  frameHeader(out, to - from, 0);
+  memcpy(out + 12, &mark.dropped, 4);
+  mark.to = to;
+  return BINLOG_FRAME_HDR + (to - from);
+}
+
+void BinLog::markSent(const BinLogMark& mark) {
+  _lastSync = millis();
+  // Consome o que foi enviado (o anel pode ter descartado parte antes)
+  portENTER_CRITICAL(&_mux);
+  if ((int32_t)(mark.to - s_rtc.tail) > 0) s_rtc.tail = mark.to;
+  if ((int32_t)(s_rtc.saved - s_rtc.tail) < 0) s_rtc.saved = s_rtc.tail;
+  s_rtc.dropped -= mark.dropped;
+  s_rtc.check = rtcCheck();
+  portEXIT_CRITICAL(&_mux);
+}
+
+uint32_t BinLog::pendingBytes() const {
+  return s_rtc.head - s_rtc.tail;
+}
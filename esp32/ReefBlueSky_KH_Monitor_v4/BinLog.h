@@ -0,0 +1,219 @@
+//BinLog.h
+#pragma once
+
+#include <Arduino.h>
+#include <type_traits>
+
+/**
+ * Log binário em anel (substitui o DebugLogger baseado em String)
+ *
+ * Cada chamada LOG_x("fmt", args...) grava um registro compacto:
+ *   [u8 tamanho][u8 nível][u32 id do formato][u64 timestamp][args...]
+ * O id é o FNV-1a da string de formato, calculado em tempo de compilação;
+ * cada argumento vai com 1 byte de tipo + valor (strings até BINLOG_MAX_STR).
+ * Sem heap e sem vsnprintf no caminho do log: a formatação fica para quem lê
+ * (backend/binlog, console serial com BINLOG_SERIAL_ECHO, alerta de boot).
+ *
+ * Upload e SPIFFS usam "frames": cabeçalho BINLOG_FRAME_HDR + registros.
+ *   0 "RBLG"   4 versão   5 flags   8 u32 bytes de registros
+ *   12 u32 registros perdidos (anel cheio)   16 u32 millis()   20 u64 epoch ms (0 = sem NTP)
+ * O upload sai direto do anel (BinLogStream), sem cópia intermediária.
+ *
+ * No SPIFFS: BINLOG_SEGMENTS arquivos /blogN.bin de até BINLOG_SEG_SIZE,
+ * cada um com "RBLS" + u32 seq seguido de frames. Só o que ainda não foi
+ * salvo é acrescentado; segmento cheio -> recicla o de menor seq.
+ * O anel fica em memória RTC e sobrevive a panic/WDT: begin() grava no
+ * SPIFFS o que ficou pendente do boot anterior.
+ */
+
+#define BINLOG_RING_SIZE     4096      // potência de 2
+#define BINLOG_MAX_RECORD    160
+#define BINLOG_MAX_STR       48
+#define BINLOG_MAX_FMTS      128       // formatos conhecidos para formatar no device
+#define BINLOG_REC_HDR       14
+#define BINLOG_FRAME_HDR     28
+#define BINLOG_VERSION       1
+#define BINLOG_SEGMENTS      4         // 4 x 4KB no SPIFFS
+#define BINLOG_SEG_SIZE      4096
+#define BINLOG_SEG_HDR       8
+
+// Ecoa cada log formatado na Serial (custa um snprintf e o printf na UART
+// por chamada): só em build de debug, com -DBINLOG_SERIAL_ECHO=1
+#ifndef BINLOG_SERIAL_ECHO
+#define BINLOG_SERIAL_ECHO   0
+#endif
+
+// ERROR não grava no SPIFFS na hora: o anel está em RTC e sobrevive a
+// panic/WDT, então loop() salva no máximo uma vez a cada intervalo
+#define BINLOG_ERROR_SAVE_MS 10000
+
+enum BinLogLevel : uint8_t { BLOG_DEBUG = 0, BLOG_INFO, BLOG_WARN, BLOG_ERROR };
+
+// Tipo de cada argumento no registro
+enum : uint8_t {
+  BLOG_ARG_I32 = 'i',
+  BLOG_ARG_U32 = 'u',
+  BLOG_ARG_I64 = 'I',
+  BLOG_ARG_U64 = 'U',
+  BLOG_ARG_F32 = 'f',
+  BLOG_ARG_STR = 's',
+};
+
+// FNV-1a 32 bits; mesmo cálculo em backend/binlog/gen_formats.js
+constexpr uint32_t binlogFmtId(const char* s, uint32_t h = 2166136261u) {
+  return *s ? binlogFmtId(s + 1, (h ^ (uint8_t)*s) * 16777619u) : h;
+}
+
+#define BINLOG_ID(fmt) (std::integral_constant<uint32_t, binlogFmtId(fmt)>::value)
+
+// 'fmt' precisa ser literal: o id sai em tempo de compilação e o formato é
+// registrado uma vez por ponto de chamada (para formatar no próprio device)
+#define BINLOG(level, fmt, ...) do {                                           \
+    static const bool _blogReg = debugLog.registerFormat(BINLOG_ID(fmt), fmt); \
+    (void)_blogReg;                                                            \
+    debugLog.write(level, BINLOG_ID(fmt), fmt, ##__VA_ARGS__);                 \
+  } while (0)
+
+#define LOG_D(fmt, ...) BINLOG(BLOG_DEBUG, fmt, ##__VA_ARGS__)
+#define LOG_I(fmt, ...) BINLOG(BLOG_INFO,  fmt, ##__VA_ARGS__)
+#define LOG_W(fmt, ...) BINLOG(BLOG_WARN,  fmt, ##__VA_ARGS__)
+#define LOG_E(fmt, ...) BINLOG(BLOG_ERROR, fmt, ##__VA_ARGS__)
+
+// Monta um registro na pilha antes de copiá-lo para o anel
+struct BinLogRecord {
+  uint8_t buf[BINLOG_MAX_RECORD];
+  uint8_t len;
+
+  void begin(uint8_t level, uint32_t id, uint64_t ts) {
+    buf[1] = level;
+    memcpy(buf + 2, &id, 4);
+    memcpy(buf + 6, &ts, 8);
+    len = BINLOG_REC_HDR;
+  }
+  void put(uint8_t type, const void* v, uint8_t n) {
+    if (len + 1 + n > BINLOG_MAX_RECORD) return;
+    buf[len++] = type;
+    memcpy(buf + len, v, n);
+    len += n;
+  }
+  void putStr(const char* s) {
+    if (len + 2 > BINLOG_MAX_RECORD) return;
+    size_t n = s ? strnlen(s, BINLOG_MAX_STR) : 0;
+    if (n > (size_t)(BINLOG_MAX_RECORD - len - 2)) n = BINLOG_MAX_RECORD - len - 2;
+    buf[len++] = BLOG_ARG_STR;
+    buf[len++] = (uint8_t)n;
+    memcpy(buf + len, s, n);
+    len += n;
+  }
+};
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+binlogPack(BinLogRecord& r, T v) {
+  if (sizeof(T) <= 4) {
+    uint32_t x = (uint32_t)v;
+    r.put(std::is_signed<T>::value ? BLOG_ARG_I32 : BLOG_ARG_U32, &x, 4);
+  } else {
+    uint64_t x = (uint64_t)v;
+    r.put(std::is_signed<T>::value ? BLOG_ARG_I64 : BLOG_ARG_U64, &x, 8);
+  }
+}
+inline void binlogPack(BinLogRecord& r, double v) {
+  float f = (float)v;
+  r.put(BLOG_ARG_F32, &f, 4);
+}
+inline void binlogPack(BinLogRecord& r, const char* s) { r.putStr(s); }
+
+// Até onde um envio levou o anel (para consumir só depois do 200)
+struct BinLogMark {
+  uint32_t to;
+  uint32_t dropped;
+};
+
+class BinLog {
+public:
+  BinLog();
+
+  template <typename... A>
+  void write(uint8_t level, uint32_t id, const char* fmt, const A&... args) {
+    BinLogRecord r;
+    r.begin(level, id, timestampMs());
+    int expand[] = {0, (binlogPack(r, args), 0)...};
+    (void)expand;
+    r.buf[0] = r.len;
+    push(r);
+#if BINLOG_SERIAL_ECHO
+    char msg[BINLOG_MAX_RECORD];
+    snprintf(msg, sizeof(msg), fmt, args...);
+    echo(level, r, msg);
+#else
+    (void)fmt;
+#endif
+    if (level == BLOG_ERROR) _errorPending = true;
+  }
+
+  bool registerFormat(uint32_t id, const char* fmt);
+
+  // Monta o SPIFFS, localiza o segmento atual e grava o que o anel em RTC
+  // trouxe do boot anterior. Chamar no setup() antes do primeiro log.
+  void begin();
+
+  // Chamar no loop(): grava no SPIFFS os ERROR pendentes (rate limit de
+  // BINLOG_ERROR_SAVE_MS), fora do caminho de quem logou
+  void loop();
+
+  // Acrescenta ao SPIFFS o que ainda não foi salvo (frames que cabem no segmento)
+  void saveToSPIFFS();
+  // Imprime na Serial os logs salvos (boot anterior)
+  void loadFromSPIFFS();
+  // Envia o anel ao backend a cada SYNC_INTERVAL; consome o que foi aceito
+  void syncToServer();
+  // Frame com os registros pendentes (inteiros) que cabem em 'max' bytes,
+  // para ir de carona em outro envio (TelemetryFrame); 0 = nada pendente.
+  // Só consome quando o envio der certo: markSent(mark).
+  size_t pendingFrame(uint8_t* out, size_t max, BinLogMark& mark);
+  void markSent(const BinLogMark& mark);
+  uint32_t pendingBytes() const;
+  // Alerta (email/Telegram) com os últimos logs salvos, após boot
+  void sendLogsAsAlert();
+
+  // Formata um registro em texto ("[NIVEL] ts: mensagem"); formatos
+  // desconhecidos saem como "#<id>" seguido dos argumentos
+  size_t format(const uint8_t* rec, char* out, size_t n) const;
+
+  uint32_t dropped() const;
+
+private:
+  friend class BinLogStream;
+
+  static uint64_t timestampMs();
+  void push(const BinLogRecord& r);
+  void echo(uint8_t level, const BinLogRecord& r, const char* msg);
+  // Copia bytes do anel a partir da posição absoluta 'pos'; false se já
+  // foram sobrescritos
+  bool copyOut(uint32_t pos, uint8_t* dst, size_t n);
+  void frameHeader(uint8_t* hdr, uint32_t bodyLen, uint8_t flags);
+  const char* findFormat(uint32_t id) const;
+  bool rotate();
+  bool appendFrame(uint32_t from, uint32_t to);
+  template <typename F> void forEachSaved(F fn);
+
+  // Anel e posições ficam em RTC (BinLog.cpp), fora do objeto
+  uint32_t _recovered = 0;  // bytes não salvos herdados de um reboot a quente
+  bool     _ready = false;  // begin() já localizou os segmentos
+  uint8_t  _seg = 0;        // segmento atual
+  uint32_t _segSeq = 0;
+  size_t   _segSize = 0;
+  portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+  struct Fmt { uint32_t id; const char* fmt; };
+  Fmt      _fmts[BINLOG_MAX_FMTS];
+  uint16_t _fmtCount = 0;
+
+  volatile bool _errorPending = false;   // ERROR ainda não salvo no SPIFFS
+  unsigned long _lastErrorSave = 0;
+  unsigned long _lastSync = 0;
+  static const unsigned long SYNC_INTERVAL = 60000; // Enviar logs a cada 60s
+};
+
+extern BinLog debugLog;
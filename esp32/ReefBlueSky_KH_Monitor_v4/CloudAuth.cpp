@@ -289,7 +289,7 @@ bool CloudAuth::refreshTokenIfNeeded() {
     http.addHeader("Authorization", "Bearer " + refreshToken);
 
     // [SEGURANÇA] Adicionar timestamp para proteção contra replay
-    DynamicJsonDocument doc(256);
+    JsonDoc doc(256);
     doc["timestamp"] = now;
     doc["deviceId"] = deviceId;
 
@@ -309,7 +309,7 @@ bool CloudAuth::refreshTokenIfNeeded() {
 
     if (httpCode == 200) {
         String response = http.getString();
-        DynamicJsonDocument responseDoc(512);
+        JsonDoc responseDoc(512);
         DeserializationError err = deserializeJson(responseDoc, response);
         if (!err && responseDoc["success"]) {
             JsonObject data = responseDoc["data"];
@@ -449,8 +449,27 @@ bool CloudAuth::syncOfflineMeasurements() {
         offlineMeasurementQueue.pop();
     }
 
+    // [ROLLUP] Buckets tocados pelo lote (sem repetir); ponteiros valem até o
+    // fim desta função, nada adiciona medição no meio do sync
+    std::vector<std::pair<uint8_t, const KHRollups::Bucket*>> touched;
+    if (rollups) {
+        for (const auto& m : chunk) {
+            if (!m.is_valid || m.timestamp < 1000000000000ULL) continue;
+            uint32_t epochS = (uint32_t)(m.timestamp / 1000ULL);
+            for (uint8_t t = 0; t < KHRollups::TIER_COUNT; t++) {
+                const KHRollups::Bucket* b = rollups->bucketAt((KHRollups::Tier)t, epochS);
+                if (!b) continue;
+                bool seen = false;
+                for (const auto& p : touched) {
+                    if (p.second == b) { seen = true; break; }
+                }
+                if (!seen) touched.push_back({t, b});
+            }
+        }
+    }
+
     // Montar payload
-    DynamicJsonDocument doc(4096);
+    JsonDoc doc(4096 + touched.size() * 192);
     JsonArray measurementsArray = doc.createNestedArray("measurements");
 
     for (const auto& m : chunk) {
@@ -465,6 +484,23 @@ bool CloudAuth::syncOfflineMeasurements() {
         obj["confidence"]  = m.confidence;
     }
 
+    if (!touched.empty()) {
+        static const char* const TIER_NAMES[] = {"h", "d", "w"};
+        JsonArray rollupsArray = doc.createNestedArray("rollups");
+        for (const auto& p : touched) {
+            const KHRollups::Bucket* b = p.second;
+            JsonObject obj = rollupsArray.createNestedObject();
+            obj["tier"]  = TIER_NAMES[p.first];
+            obj["start"] = (uint64_t)b->start * 1000ULL;   // ms, como timestamp
+            obj["n"]     = b->count;
+            obj["mean"]  = b->mean;
+            obj["m2"]    = b->m2;
+            obj["min"]   = b->min;
+            obj["max"]   = b->max;
+            obj["last"]  = b->last;
+        }
+    }
+
     String payload;
     serializeJson(doc, payload);
     Serial.println("[SYNC] Payload:");
@@ -500,7 +536,7 @@ bool CloudAuth::syncOfflineMeasurements() {
 
     if (httpCode == 200) {
         String response = http.getString();
-        DynamicJsonDocument responseDoc(512);
+        JsonDoc responseDoc(512);
         DeserializationError err = deserializeJson(responseDoc, response);
         if (!err && responseDoc["success"]) {
             // Atualizar checkpoint de sincronização
@@ -574,7 +610,7 @@ bool CloudAuth::sendHeartbeat(const DeviceStatus& status) {
 
     if (httpCode == 200) {
         String response = http.getString();
-        DynamicJsonDocument responseDoc(512);
+        JsonDoc responseDoc(512);
         deserializeJson(responseDoc, response);
 
         // [SEGURANÇA] Validar timestamp do servidor
@@ -620,7 +656,7 @@ bool CloudAuth::sendHealthMetrics(const SystemHealth& health) {
 
     http.addHeader("Authorization", "Bearer " + deviceToken);
 
-    DynamicJsonDocument doc(512);
+    JsonDoc doc(512);
 
     // Força os tipos corretos no JSON
     doc["cpuusage"]     = health.cpu_usage;
@@ -636,6 +672,12 @@ bool CloudAuth::sendHealthMetrics(const SystemHealth& health) {
     doc["temperature"]  = health.temperature;
     doc["ph"]           = health.ph;
 
+    doc["heap_free"]          = health.heap_free;
+    doc["heap_min_free"]      = health.heap_min_free;
+    doc["heap_largest_block"] = health.heap_largest_block;
+    doc["json_arena_peak"]    = health.json_arena_peak;
+    doc["json_arena_fallbacks"] = health.json_arena_fallbacks;
+
     String payload;
     serializeJson(doc, payload);
 
@@ -671,10 +713,119 @@ bool CloudAuth::sendHealthMetrics(const SystemHealth& health) {
     return false;
 }
 
+// ============================================================================
+// [TELEMETRIA] Frame único: health + progresso + logs num POST
+// ============================================================================
+int CloudAuth::sendTelemetry(const String& payload, bool& resync) {
+    // Como o health: o intervalo é controlado pelo TelemetryFrame
+    resync = false;
+
+    WiFiClient client;
+    HTTPClient http;
+    String url = serverUrl + String("/device/telemetry");
+
+    http.begin(client, url);
+    http.setTimeout(HTTP_TIMEOUT_MS);
+    http.addHeader("Content-Type", "application/json");
+    http.addHeader("Authorization", "Bearer " + deviceToken);
+
+    int httpCode = http.POST(payload);
+
+    if (httpCode < 0) {
+        Serial.printf("[CloudAuth::sendTelemetry] Erro HTTP: %s\n",
+                      http.errorToString(httpCode).c_str());
+        http.end();
+        return httpCode;
+    }
+
+    if (httpCode == 401 || httpCode == 403) {
+        Serial.println("[CloudAuth::sendTelemetry] Token inválido/expirado (401/403). Limpando TODOS os tokens.");
+        clearAllTokens();
+        http.end();
+        return httpCode;
+    }
+
+    if (httpCode == 200) {
+        JsonDoc responseDoc(256);
+        if (!deserializeJson(responseDoc, http.getString())) {
+            resync = responseDoc["resync"] | false;
+        }
+    } else {
+        Serial.printf("[CloudAuth::sendTelemetry] ✗ Erro %d (%u bytes)\n",
+                      httpCode, (unsigned)payload.length());
+    }
+    http.end();
+    return httpCode;
+}
+
 // ============================================================================
 // Obter KH de referência do servidor (se existir)
 // ============================================================================
 
+bool CloudAuth::fetchLanKey(String& hexKey) {
+    WiFiClient client;
+    HTTPClient http;
+    String url = String(serverUrl) + "/device/lan-key";
+
+    http.begin(client, url);
+    http.setTimeout(HTTP_TIMEOUT_MS);
+    http.addHeader("Authorization", "Bearer " + deviceToken);
+
+    int httpCode = http.GET();
+    if (httpCode != 200) {
+        Serial.printf("[CloudAuth::fetchLanKey] HTTP %d\n", httpCode);
+        http.end();
+        return false;
+    }
+
+    String response = http.getString();
+    http.end();
+
+    StaticJsonDocument<256> doc;
+    if (deserializeJson(doc, response) || !(doc["success"] | false)) {
+        Serial.println("[CloudAuth::fetchLanKey] Resposta inválida");
+        return false;
+    }
+    const char* key = doc["data"]["key"] | "";
+    if (strlen(key) != 64) return false;
+    hexKey = key;
+    Serial.printf("[CloudAuth::fetchLanKey] Chave recebida (key_id %s)\n",
+                  (const char*)(doc["data"]["key_id"] | "?"));
+    return true;
+}
+
+bool CloudAuth::requestDoserDose(uint8_t pumpIndex, float volumeMl, uint32_t requestId,
+                                 const char* doserUid) {
+    // Sem rateLimiter: é o caminho de segurança quando a LAN falhou
+    WiFiClient client;
+    HTTPClient http;
+    String url = String(serverUrl) + "/device/doser-dose";
+
+    http.begin(client, url);
+    http.setTimeout(HTTP_TIMEOUT_MS);
+    http.addHeader("Content-Type", "application/json");
+    http.addHeader("Authorization", "Bearer " + deviceToken);
+
+    StaticJsonDocument<192> doc;
+    doc["pump_index"] = pumpIndex;
+    doc["volume_ml"]  = volumeMl;
+    doc["request_id"] = requestId;
+    if (doserUid && doserUid[0]) doc["doser_uid"] = doserUid;
+    String payload;
+    serializeJson(doc, payload);
+
+    int httpCode = http.POST(payload);
+    if (httpCode == 401 || httpCode == 403) {
+        Serial.println("[CloudAuth::requestDoserDose] Token inválido/expirado (401/403). Limpando TODOS os tokens.");
+        clearAllTokens();
+    } else if (httpCode != 200) {
+        Serial.printf("[CloudAuth::requestDoserDose] HTTP %d: %s\n", httpCode,
+                      httpCode > 0 ? http.getString().c_str() : http.errorToString(httpCode).c_str());
+    }
+    http.end();
+    return httpCode == 200;
+}
+
 bool CloudAuth::fetchReferenceKH(float& outKhRef) {
     if (!rateLimiter.canMakeRequest()) {
         return false;
@@ -782,7 +933,7 @@ bool CloudAuth::pullCommandFromServer(Command& command) {
         Serial.println("[CloudAuth] resposta recebida:");
         Serial.println(response);
 
-        DynamicJsonDocument responseDoc(2048);
+        JsonDoc responseDoc(2048);
         DeserializationError err = deserializeJson(responseDoc, response);
         if (err) {
             Serial.printf("[CloudAuth::pullCommandFromServer] JSON inválido: %s\n", err.c_str());
@@ -859,7 +1010,7 @@ bool CloudAuth::confirmCommandExecution(const String& commandId,
     http.addHeader("Content-Type", "application/json");
     http.addHeader("Authorization", "Bearer " + deviceToken);
 
-    DynamicJsonDocument doc(512);
+    JsonDoc doc(512);
     doc["commandId"] = commandId.toInt();   // backend espera número
     doc["status"] = status;                // ex.: "done" ou "error"
     if (result.length() > 0) {
@@ -897,13 +1048,164 @@ bool CloudAuth::confirmCommandExecution(const String& commandId,
     return false;
 }
 
+// ============================================================================
+// [COMANDOS] Poll em lote com acks agregados
+// ============================================================================
+// Corpo: {"max":N,"acks":[{"id":..,"status":"done|error|pending","errorMessage":..}]}
+// Servidor novo responde "batch":true depois de aplicar os acks. Servidor
+// antigo ignora o corpo e manda 1 comando: aí os acks saem um a um pelo
+// /commands/complete (que também aceita "pending").
+
+int CloudAuth::postCommandPoll(int max, Command* out) {
+    if (!rateLimiter.canMakeRequest()) {
+        return -1;
+    }
+
+    WiFiClient client;
+    HTTPClient http;
+    String url = String(serverUrl) + "/device/commands/poll";
+
+    http.begin(client, url);
+    http.setTimeout(HTTP_TIMEOUT_MS);
+    http.addHeader("Authorization", "Bearer " + deviceToken);
+    http.addHeader("Content-Type", "application/json");
+
+    size_t nAcks = cmdQueue.ackCount();
+    String body;
+    {
+        JsonDoc req(128 + nAcks * (96 + CMD_ERR_LEN));
+        req["max"] = max;
+        JsonArray acks = req.createNestedArray("acks");
+        for (size_t i = 0; i < nAcks; i++) {
+            const CommandAck& a = cmdQueue.ack(i);
+            JsonObject o = acks.createNestedObject();
+            o["id"] = a.id;
+            o["status"] = CommandQueue::statusName(a.status);
+            if (a.error[0]) o["errorMessage"] = a.error;
+        }
+        serializeJson(req, body);
+    }
+
+    int httpCode = http.POST(body);
+
+    if (httpCode < 0) {
+        Serial.printf("[CloudAuth::pullCommands] Erro HTTP: %s\n",
+                      http.errorToString(httpCode).c_str());
+        http.end();
+        return -1;
+    }
+
+    if (httpCode == 401 || httpCode == 403) {
+        Serial.println("[CloudAuth::pullCommands] Token inválido/expirado (401/403). Limpando TODOS os tokens.");
+        clearAllTokens();
+        http.end();
+        return -1;
+    }
+
+    if (httpCode != 200) {
+        Serial.printf("[CloudAuth::pullCommands] Erro HTTP: %d\n", httpCode);
+        http.end();
+        return -1;
+    }
+
+    String response = http.getString();
+    http.end();
+
+    JsonDoc responseDoc(1024 + max * 512);
+    DeserializationError err = deserializeJson(responseDoc, response);
+    if (err) {
+        Serial.printf("[CloudAuth::pullCommands] JSON inválido: %s\n", err.c_str());
+        return -1;
+    }
+    if (!responseDoc["success"]) {
+        return -1;
+    }
+
+    cmdBatchServer = responseDoc["batch"] | false;
+    if (cmdBatchServer) {
+        cmdQueue.ackSent(nAcks);
+    } else {
+        confirmAcksOneByOne();
+    }
+
+    JsonArray arr = responseDoc["data"].as<JsonArray>();
+    if (!out || !arr) {
+        return 0;
+    }
+
+    cmdQueue.beginBatch();
+    int n = 0;
+    for (JsonObject cmdObj : arr) {
+        if (n >= max) break;   // servidor antigo/errado mandou a mais: voltam no próximo poll
+        int32_t id = cmdObj["id"] | 0;
+        String type = cmdObj["type"].as<String>();
+
+        if (!commandValidator.isCommandAllowed(type)) {
+            cmdQueue.reject(id, "comando não permitido");
+            continue;
+        }
+
+        Command& command = out[n];
+        command.command_id = String(id);
+        command.action     = type;
+        command.paramsDoc.clear();
+        JsonObject dst = command.paramsDoc.to<JsonObject>();
+        JsonVariant payloadVar = cmdObj["payload"];
+        if (payloadVar.is<JsonObject>()) {
+            for (JsonPair kv : payloadVar.as<JsonObject>()) {
+                dst[kv.key()] = kv.value();
+            }
+        }
+        command.params = command.paramsDoc.as<JsonObject>();
+
+        bool barrier = type == "restart" || type == "factoryreset" ||
+                       type == "ota_update" || type == "otaupdate";
+        cmdQueue.push(id, cmdObj["dependsOn"] | 0, barrier);
+        n++;
+    }
+
+    Serial.printf("[CloudAuth::pullCommands] %d comando(s), %u ack(s) enviados\n",
+                  n, (unsigned)nAcks);
+    return n;
+}
+
+int CloudAuth::pullCommands(Command* out, int max) {
+    if (max > CMD_BATCH_MAX) max = CMD_BATCH_MAX;
+    return postCommandPoll(max, out);
+}
+
+// Servidor sem lote: um /complete por ack; o que falhar fica para depois
+void CloudAuth::confirmAcksOneByOne() {
+    size_t sent = 0;
+    while (sent < cmdQueue.ackCount()) {
+        const CommandAck& a = cmdQueue.ack(sent);
+        if (!confirmCommandExecution(String(a.id), CommandQueue::statusName(a.status), a.error)) break;
+        sent++;
+    }
+    cmdQueue.ackSent(sent);
+}
+
+bool CloudAuth::flushCommandAcks() {
+    for (int attempt = 0; attempt < 3 && cmdQueue.ackCount() > 0; attempt++) {
+        if (attempt > 0) delay(600);   // RateLimiter: 500 ms entre requisições
+        // max=0 só aplica acks; servidor antigo ignoraria e entregaria um
+        // comando que ninguém executaria
+        if (cmdBatchServer) {
+            postCommandPoll(0, nullptr);
+        } else {
+            confirmAcksOneByOne();
+        }
+    }
+    return cmdQueue.ackCount() == 0;
+}
+
 
 // ============================================================================
 // [FUNCIONALIDADE] Compressão de Dados com GZIP
 // ============================================================================
 
 String CloudAuth::compressMeasurements(const std::vector<Measurement>& measurements) {
-    DynamicJsonDocument doc(8192);
+    JsonDoc doc(8192);
     JsonArray array = doc.createNestedArray("measurements");
     
     for (const auto& m : measurements) {
@@ -987,7 +1289,7 @@ bool CloudAuth::checkNextScheduledTest(bool& shouldTestNow, unsigned long& nextT
         String payload = http.getString();
 
         // Parse JSON response
-        DynamicJsonDocument doc(1024);
+        JsonDoc doc(1024);
         DeserializationError error = deserializeJson(doc, payload);
 
         if (error) {
@@ -1060,7 +1362,7 @@ bool CloudAuth::reportTestResult(bool success, const String& error, const Measur
     }
 
     // Montar JSON body
-    DynamicJsonDocument doc(1024);
+    JsonDoc doc(1024);
     doc["success"] = success;
 
     if (success && measurement != nullptr) {
@@ -1098,7 +1400,7 @@ bool CloudAuth::reportTestResult(bool success, const String& error, const Measur
         Serial.printf("[CloudAuth] reportTestResult OK: %s\n", response.c_str());
 
         // Parse response para pegar next_test_time
-        DynamicJsonDocument resDoc(512);
+        JsonDoc resDoc(512);
         if (deserializeJson(resDoc, response) == DeserializationError::Ok) {
             if (resDoc["success"].as<bool>() && resDoc["data"].containsKey("next_test_time")) {
                 unsigned long nextTest = resDoc["data"]["next_test_time"].as<unsigned long>();
@@ -1151,7 +1453,7 @@ bool CloudAuth::fetchDeviceConfig(bool& testMode) {
         String response = http.getString();
 
         // Parse JSON response
-        DynamicJsonDocument doc(512);
+        JsonDoc doc(512);
         DeserializationError error = deserializeJson(doc, response);
 
         if (error) {
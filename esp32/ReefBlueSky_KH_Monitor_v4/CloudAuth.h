@@ -10,6 +10,9 @@
 #include <nvs_flash.h>
 #include <nvs.h>
 #include <ArduinoJson.h>
+#include "JsonArena.h"
+#include "CommandQueue.h"
+#include <ReefBlueSkyCore.h>
 #include <vector>
 #include <queue>
 #include <mbedtls/aes.h>
@@ -62,6 +65,13 @@ struct SystemHealth {
     int level_c;
     float temperature;
     float ph;
+
+    // Fragmentação do heap (maior bloco livre caindo com free estável = fragmentado)
+    uint32_t heap_free;
+    uint32_t heap_min_free;        // mínimo desde o boot
+    uint32_t heap_largest_block;   // maior bloco contíguo alocável
+    uint32_t json_arena_peak;      // pico da arena ArduinoJson (JsonArena.h)
+    uint32_t json_arena_fallbacks; // documentos que não couberam na arena
 };
 
 struct Command {
@@ -339,6 +349,9 @@ private:
     IncrementalSync incrementalSync;
     ExponentialBackoff authBackoff;        // Backoff para falhas de autenticação
     ExponentialBackoff syncBackoff;        // Backoff para falhas de sincronização
+    CommandQueue cmdQueue;                 // Lote de comandos + acks pendentes
+    bool cmdBatchServer = false;           // servidor respondeu "batch":true
+    const KHRollups* rollups = nullptr;    // agregados do MeasurementHistory
 
     // [CONFIG] Timeout HTTP em milissegundos
     static constexpr int HTTP_TIMEOUT_MS = 10000;  // 10 segundos
@@ -359,6 +372,8 @@ private:
     String decryptToken(const String& encryptedToken);
     bool validateSSLCertificate();
     String compressMeasurements(const std::vector<Measurement>& measurements);
+    int postCommandPoll(int max, Command* out);
+    void confirmAcksOneByOne();
     
 public:
 
@@ -383,23 +398,48 @@ public:
     // obter KH de referência do servidor, se existir
     bool fetchReferenceKH(float& outKhRef);
 
+    // [LAN] Chave LAN do usuário (GET /device/lan-key), hex de 64 caracteres
+    bool fetchLanKey(String& hexKey);
+
+    // [LAN] Fallback da correção pela dosadora: enfileira MANUAL_DOSE na
+    // nuvem (POST /device/doser-dose) com o mesmo requestId da LAN
+    bool requestDoserDose(uint8_t pumpIndex, float volumeMl, uint32_t requestId,
+                          const char* doserUid);
+
     // [FUNCIONALIDADE] Armazenar dados offline (se sem WiFi)
     void queueMeasurement(const Measurement& m);
     
     // [FUNCIONALIDADE] Sincronizar medições acumuladas (incremental)
+    // Com setRollups(), cada lote leva junto os buckets hora/dia/semana que
+    // as medições dele tocaram (estado atual; o backend faz upsert)
     bool syncOfflineMeasurements();
+    void setRollups(const KHRollups* r) { rollups = r; }
     
     // [SEGURANÇA] Enviar heartbeat (ping a cada 30s)
     bool sendHeartbeat(const DeviceStatus& status);
     
     // [SEGURANÇA] Enviar métricas de saúde
     bool sendHealthMetrics(const SystemHealth& health);
+
+    // [TELEMETRIA] Frame único (TelemetryFrame.h); retorna o código HTTP.
+    // resync = servidor pediu keyframe
+    int sendTelemetry(const String& payload, bool& resync);
     
     // [SEGURANÇA] Obter instrução do servidor (ex: start medição, calibrar)
     bool pullCommandFromServer(Command& command);
     
     // [SEGURANÇA] Confirmar execução de comando
     bool confirmCommandExecution(const String& commandId, const String& status, const String& result);
+
+    // [COMANDOS] Lote: até 'max' comandos por poll, com os acks pendentes de
+    // carona no mesmo POST. Retorna quantos comandos vieram (-1 = erro).
+    // Os comandos entram em commandQueue() na ordem do servidor.
+    int pullCommands(Command* out, int max);
+
+    // [COMANDOS] Envia os acks pendentes agora (antes de restart/OTA)
+    bool flushCommandAcks();
+
+    CommandQueue& commandQueue() { return cmdQueue; }
     
     // [SEGURANÇA] Verificar status de conectividade
     bool isConnected();
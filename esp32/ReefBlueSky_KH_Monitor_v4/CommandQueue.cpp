@@ -0,0 +1,86 @@
+#include "CommandQueue.h"
+
+CommandQueue::CommandQueue() : _count(0), _pos(0), _ackCount(0) {}
+
+void CommandQueue::beginBatch() {
+  _count = 0;
+  _pos = 0;
+}
+
+bool CommandQueue::push(int32_t id, int32_t dependsOn, bool barrier) {
+  if (_count >= CMD_BATCH_MAX) return false;
+  Slot& s = _slots[_count++];
+  s.id = id;
+  s.dependsOn = dependsOn;
+  s.state = SLOT_QUEUED;
+  s.barrier = barrier;
+  return true;
+}
+
+const CommandQueue::Slot* CommandQueue::findSlot(int32_t id) const {
+  for (int i = 0; i < _count; i++) {
+    if (_slots[i].id == id) return &_slots[i];
+  }
+  return nullptr;
+}
+
+int CommandQueue::next() {
+  while (_pos < _count) {
+    Slot& s = _slots[_pos];
+    if (s.dependsOn != 0) {
+      // Fora do lote = o servidor só entregou porque a dependência terminou
+      const Slot* dep = findSlot(s.dependsOn);
+      if (dep && dep->state != SLOT_DONE) {
+        char msg[CMD_ERR_LEN];
+        snprintf(msg, sizeof(msg), "dependência #%ld não concluída", (long)s.dependsOn);
+        s.state = SLOT_FAILED;
+        addAck(s.id, CMD_ACK_ERROR, msg);
+        _pos++;
+        continue;
+      }
+    }
+    return _pos++;
+  }
+  return -1;
+}
+
+void CommandQueue::complete(int slot, bool ok, const char* error) {
+  Slot& s = _slots[slot];
+  s.state = ok ? SLOT_DONE : SLOT_FAILED;
+  addAck(s.id, ok ? CMD_ACK_DONE : CMD_ACK_ERROR, error);
+}
+
+void CommandQueue::requeueRemaining() {
+  while (_pos < _count) {
+    addAck(_slots[_pos].id, CMD_ACK_REQUEUE, "");
+    _pos++;
+  }
+}
+
+void CommandQueue::addAck(int32_t id, uint8_t status, const char* error) {
+  // Cheio só se os polls falharem em sequência: perde o mais antigo, que
+  // fica "inprogress" no servidor como acontecia sem confirmação
+  if (_ackCount == CMD_ACK_MAX) ackSent(1);
+  CommandAck& a = _acks[_ackCount++];
+  a.id = id;
+  a.status = status;
+  strncpy(a.error, error ? error : "", sizeof(a.error) - 1);
+  a.error[sizeof(a.error) - 1] = 0;
+}
+
+void CommandQueue::ackSent(size_t n) {
+  if (n >= _ackCount) {
+    _ackCount = 0;
+    return;
+  }
+  memmove(_acks, _acks + n, (_ackCount - n) * sizeof(CommandAck));
+  _ackCount -= n;
+}
+
+const char* CommandQueue::statusName(uint8_t status) {
+  switch (status) {
+    case CMD_ACK_DONE:    return "done";
+    case CMD_ACK_ERROR:   return "error";
+    default:              return "pending";
+  }
+}
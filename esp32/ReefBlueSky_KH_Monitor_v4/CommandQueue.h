@@ -0,0 +1,82 @@
+//CommandQueue.h
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Lote de comandos da nuvem e confirmações agregadas
+ *
+ * O poll traz até CMD_BATCH_MAX comandos de uma vez; eles rodam aqui em
+ * ordem e o resultado de cada um vira um ack que vai de carona no próximo
+ * poll (um POST só, em vez de um /commands/complete por comando).
+ *
+ * Dependência: comando com dependsOn = id de outro comando do lote só roda
+ * se aquele terminou OK; se falhou (ou nem rodou), o dependente é
+ * confirmado como erro sem executar, e a falha se propaga pela cadeia.
+ *
+ * Barreira (restart, factoryreset, OTA): o que ainda não rodou no lote
+ * volta ao servidor como "pending" e os acks são enviados antes de
+ * executar, para nada se perder no reboot.
+ */
+
+#define CMD_BATCH_MAX   4
+#define CMD_ACK_MAX     (2 * CMD_BATCH_MAX)
+#define CMD_ERR_LEN     96
+
+enum CommandAckStatus : uint8_t {
+  CMD_ACK_DONE,
+  CMD_ACK_ERROR,
+  CMD_ACK_REQUEUE       // devolve ao servidor (status volta a "pending")
+};
+
+struct CommandAck {
+  int32_t id;
+  uint8_t status;       // CommandAckStatus
+  char    error[CMD_ERR_LEN];
+};
+
+class CommandQueue {
+public:
+  CommandQueue();
+
+  // Começa um lote novo (o anterior já deve ter sido consumido)
+  void beginBatch();
+  // Adiciona ao lote, na ordem do servidor; false se o lote está cheio
+  bool push(int32_t id, int32_t dependsOn, bool barrier);
+  // Índice do próximo comando a executar, -1 quando o lote acabou.
+  // Dependentes de comando que falhou são confirmados como erro aqui.
+  int  next();
+  void complete(int slot, bool ok, const char* error);
+  bool isBarrier(int slot) const { return _slots[slot].barrier; }
+  // Devolve ao servidor tudo que ainda não rodou (chamar antes da barreira)
+  void requeueRemaining();
+  int  remaining() const { return _count - _pos; }
+
+  // Confirmações pendentes, em ordem de conclusão
+  size_t ackCount() const { return _ackCount; }
+  const CommandAck& ack(size_t i) const { return _acks[i]; }
+  // Remove as n primeiras (o servidor já aplicou)
+  void ackSent(size_t n);
+  // Rejeita um comando que nem entrou no lote (ex.: não permitido)
+  void reject(int32_t id, const char* error) { addAck(id, CMD_ACK_ERROR, error); }
+
+  static const char* statusName(uint8_t status);
+
+private:
+  enum : uint8_t { SLOT_QUEUED, SLOT_DONE, SLOT_FAILED };
+  struct Slot {
+    int32_t id;
+    int32_t dependsOn;  // 0 = nenhuma
+    uint8_t state;
+    bool    barrier;
+  };
+
+  void addAck(int32_t id, uint8_t status, const char* error);
+  const Slot* findSlot(int32_t id) const;
+
+  Slot       _slots[CMD_BATCH_MAX];
+  int        _count;
+  int        _pos;
+  CommandAck _acks[CMD_ACK_MAX];
+  size_t     _ackCount;
+};
@@ -0,0 +1,224 @@
+//DoserLink.cpp
+#include "DoserLink.h"
+#include "CloudAuth.h"
+#include "BinLog.h"
+#include "TimeProvider.h"
+#include <SPIFFS.h>
+#include <WiFi.h>
+#include <ArduinoJson.h>
+
+static bool hexToBytes(const String& hex, uint8_t* out, size_t len) {
+  if (hex.length() != len * 2) return false;
+  for (size_t i = 0; i < len; i++) {
+    char buf[3] = {hex[2 * i], hex[2 * i + 1], 0};
+    char* end;
+    out[i] = (uint8_t)strtoul(buf, &end, 16);
+    if (*end) return false;
+  }
+  return true;
+}
+
+static IPAddress toIp(uint32_t ip) {
+  return IPAddress((ip >> 24) & 0xFF, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF);
+}
+
+static uint32_t epochNow() {
+  return (uint32_t)(getCurrentEpochMs() / 1000ULL);
+}
+
+bool DoserLink::loadKey(String& hexKey) {
+  if (!SPIFFS.exists(DOSERLINK_KEY_FILE)) return false;
+  File f = SPIFFS.open(DOSERLINK_KEY_FILE, "r");
+  if (!f) return false;
+  StaticJsonDocument<160> doc;
+  DeserializationError err = deserializeJson(doc, f);
+  f.close();
+  if (err) return false;
+  hexKey = doc["key"] | "";
+  return hexKey.length() == 64;
+}
+
+bool DoserLink::saveKey(const String& hexKey) {
+  String current;
+  if (loadKey(current) && current == hexKey) return true;   // não regrava a mesma chave
+  File f = SPIFFS.open(DOSERLINK_KEY_FILE, "w");
+  if (!f) return false;
+  StaticJsonDocument<160> doc;
+  doc["key"] = hexKey;
+  serializeJson(doc, f);
+  f.close();
+  return true;
+}
+
+bool DoserLink::begin(const String& deviceUid, const String& hexKey, CloudAuth* c) {
+  cloud = c;
+  String hex = hexKey;
+  if (hex.length() == 0 && !loadKey(hex)) {
+    Serial.println("[LAN] Sem chave LAN ainda (precisa da nuvem uma vez)");
+    return false;
+  }
+  if (!hexToBytes(hex, key, 32)) {
+    Serial.println("[LAN] Chave LAN inválida");
+    return false;
+  }
+  uid = deviceUid;
+
+  if (!udp.beginMulticast(toIp(LANLINK_GROUP_IP), LANLINK_PORT)) {
+    Serial.println("[LAN] beginMulticast falhou");
+    return false;
+  }
+
+  LanLink::Config cfg;
+  cfg.role = LanLink::ROLE_MONITOR;
+  cfg.uid = uid.c_str();
+  cfg.key = key;
+  cfg.keyLen = 32;
+  cfg.session = esp_random();
+
+  LanLink::Handlers h;
+  h.send = sendDatagram;
+  h.onResult = onResult;
+  h.ctx = this;
+
+  if (!link.begin(cfg, h)) return false;
+  Serial.printf("[LAN] Pronto em %s:%u (key_id %08lx)\n", WiFi.localIP().toString().c_str(),
+                LANLINK_PORT, (unsigned long)link.keyId());
+  return true;
+}
+
+void DoserLink::loop() {
+  uint32_t nowMs = millis();
+
+  if (link.ready()) {
+    uint32_t epoch = epochNow();
+    uint8_t buf[LANLINK_MAX_DATAGRAM];
+    int size;
+    while ((size = udp.parsePacket()) > 0) {
+      int n = udp.read(buf, sizeof(buf));
+      IPAddress ip = udp.remoteIP();
+      uint32_t from = ((uint32_t)ip[0] << 24) | ((uint32_t)ip[1] << 16) | ((uint32_t)ip[2] << 8) | ip[3];
+      if (n > 0 && size <= (int)sizeof(buf)) {
+        link.onDatagram(buf, (size_t)n, from, udp.remotePort(), nowMs, epoch);
+      }
+    }
+    link.loop(nowMs, epoch);
+  }
+
+  if (!pending) return;
+  if (goCloud) {
+    goCloud = false;
+    sendToCloud();
+  } else if (!waitingAck && (int32_t)(nowMs - retryAtMs) >= 0) {
+    sendToLan(nowMs);   // nova tentativa depois de "ocupada"
+  }
+}
+
+void DoserLink::publishMeasurement(float kh, uint32_t measuredAt) {
+  if (!link.ready()) return;
+  link.publishMeasurement(kh, measuredAt, millis(), epochNow());
+}
+
+bool DoserLink::requestCorrection(uint8_t pump, float volume) {
+  if (pending) return false;
+
+  pending = true;
+  pumpIndex = pump;
+  volumeMl = volume;
+  startMs = millis();
+  busyTries = 0;
+  goCloud = false;
+  doserUid[0] = 0;
+  // Único entre reboots (epoch) para a dosadora reconhecer o mesmo pedido
+  // vindo pela LAN e pela nuvem
+  requestId = epochNow();
+  if (requestId == 0) requestId = esp_random() | 1;
+
+  sendToLan(startMs);
+  return true;
+}
+
+void DoserLink::sendToLan(uint32_t nowMs) {
+  const LanLink::Peer* d = link.ready() ? link.findPeer(LanLink::ROLE_DOSER) : nullptr;
+  if (d) strlcpy(doserUid, d->uid, sizeof(doserUid));
+  if (d && link.requestDose(requestId, pumpIndex, volumeMl, nowMs, epochNow())) {
+    waitingAck = true;
+    return;
+  }
+  Serial.println("[LAN] Dosadora fora da rede local, correção pela nuvem");
+  sendToCloud();
+}
+
+void DoserLink::sendToCloud() {
+  waitingAck = false;
+  if (cloud && cloud->requestDoserDose(pumpIndex, volumeMl, requestId, doserUid)) {
+    st.cloudDoses++;
+    finish(PATH_CLOUD, millis());
+  } else {
+    finish(PATH_FAILED, millis());
+  }
+}
+
+void DoserLink::finish(uint8_t path, uint32_t nowMs) {
+  pending = false;
+  waitingAck = false;
+  st.lastPath = path;
+  st.lastLatencyMs = nowMs - startMs;
+
+  if (path == PATH_LAN && doseFn) doseFn(volumeMl);
+
+  const LanLink::Stats& ls = link.stats();
+  switch (path) {
+    case PATH_LAN:
+      LOG_I("KH correction via LAN: pump=%u vol=%.2f mL, %u ms (RTT avg=%u max=%u)",
+            (unsigned)pumpIndex, volumeMl, st.lastLatencyMs, ls.avgRttMs, ls.maxRttMs);
+      break;
+    case PATH_CLOUD:
+      LOG_I("KH correction via cloud: pump=%u vol=%.2f mL, queued in %u ms (LAN timeouts=%u)",
+            (unsigned)pumpIndex, volumeMl, st.lastLatencyMs, ls.timeouts);
+      break;
+    default:
+      LOG_E("KH correction FAILED: pump=%u vol=%.2f mL (LAN and cloud)",
+            (unsigned)pumpIndex, volumeMl);
+      break;
+  }
+}
+
+void DoserLink::sendDatagram(void* ctx, uint32_t ip, uint16_t port, const uint8_t* data, size_t len) {
+  DoserLink* self = (DoserLink*)ctx;
+  self->udp.beginPacket(toIp(ip), port);
+  self->udp.write(data, len);
+  self->udp.endPacket();
+}
+
+void DoserLink::onResult(void* ctx, uint8_t type, uint32_t ref, uint8_t result,
+                         uint8_t ackStatus, uint32_t rttMs) {
+  DoserLink* self = (DoserLink*)ctx;
+  if (type != LanLink::MSG_DOSE_REQUEST || !self->pending || ref != self->requestId) return;
+  self->waitingAck = false;
+
+  if (result == LanLink::RESULT_TIMEOUT) {
+    Serial.println("[LAN] Dosadora não confirmou, correção pela nuvem");
+    self->goCloud = true;          // HTTP fora do callback, no loop()
+    return;
+  }
+
+  switch (ackStatus) {
+    case LanLink::ACK_OK:
+      Serial.printf("[LAN] Dosadora confirmou a correção (RTT %lu ms)\n", (unsigned long)rttMs);
+      self->st.lanDoses++;
+      self->finish(PATH_LAN, millis());
+      break;
+    case LanLink::ACK_BUSY:
+      if (++self->busyTries >= DOSERLINK_BUSY_TRIES) {
+        self->goCloud = true;
+      } else {
+        self->retryAtMs = millis() + DOSERLINK_BUSY_RETRY_MS;
+      }
+      break;
+    default:
+      self->st.refused++;
+      Serial.println("[LAN] Dosadora recusou a correção (bomba/volume)");
+      self->finish(PATH_FAILED, millis());
+      break;
+  }
+}
@@ -0,0 +1,99 @@
+//DoserLink.h
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <ReefBlueSkyCore.h>
+
+/**
+ * Monitor -> dosadora na rede local (LanLink do ReefBlueSkyCore)
+ *
+ * Cada medição vai direto para a dosadora do usuário, e uma correção de KH
+ * com "doser": true vira pedido de dose na bomba dela. Confirmação chega
+ * em milissegundos; sem dosadora na rede ou sem ACK em ~0,9 s a correção
+ * vai pela nuvem (POST /device/doser-dose) com o mesmo requestId, que a
+ * dosadora reconhece se a dose já tiver rodado pela LAN.
+ *
+ * ACK "ocupada" (outra dose rodando): tenta de novo a cada
+ * DOSERLINK_BUSY_RETRY_MS, até DOSERLINK_BUSY_TRIES vezes, e então nuvem.
+ * Recusa explícita (bomba inválida/sem calibração) não vai para a nuvem:
+ * lá seria recusada do mesmo jeito.
+ *
+ * Latência ponta a ponta (pedido -> ACK) vai para o log do backend (LOG_I)
+ * em cada correção; RTT médio/máximo em stats().
+ */
+
+#define DOSERLINK_KEY_FILE        "/lan_key.json"
+#define DOSERLINK_BUSY_RETRY_MS   5000UL
+#define DOSERLINK_BUSY_TRIES      24        // 2 min
+
+class CloudAuth;
+
+class DoserLink {
+public:
+  enum Path : uint8_t { PATH_NONE = 0, PATH_LAN, PATH_CLOUD, PATH_FAILED };
+
+  struct Stats {
+    uint32_t lanDoses;        // confirmadas pela LAN
+    uint32_t cloudDoses;      // enfileiradas na nuvem (fallback)
+    uint32_t refused;
+    uint32_t lastLatencyMs;   // pedido -> confirmação da última correção
+    uint8_t  lastPath;
+  };
+
+  // hexKey vazio = usa a chave do arquivo; false = sem chave ainda
+  bool begin(const String& uid, const String& hexKey, CloudAuth* cloud);
+  bool ready() const { return link.ready(); }
+
+  // Chamar a cada volta do loop()
+  void loop();
+
+  // Sem dosadora na rede: só não publica
+  void publishMeasurement(float kh, uint32_t measuredAt);
+
+  // false = já há uma correção em andamento
+  bool requestCorrection(uint8_t pumpIndex, float volumeMl);
+  bool correctionPending() const { return pending; }
+
+  // Correção confirmada pela dosadora (ACK da LAN): avisa o volume
+  // (KHPredictor::addDose). Pela nuvem ela só entra na fila, sem
+  // confirmação de execução: não avisa, o filtro vê o efeito na medição
+  typedef void (*DoseFn)(float volumeMl);
+  void onDose(DoseFn fn) { doseFn = fn; }
+
+  const Stats& stats() const { return st; }
+  const LanLink::Stats& linkStats() const { return link.stats(); }
+  bool doserOnLan() const { return link.findPeer(LanLink::ROLE_DOSER) != nullptr; }
+
+  static bool loadKey(String& hexKey);
+  static bool saveKey(const String& hexKey);
+
+private:
+  static void sendDatagram(void* ctx, uint32_t ip, uint16_t port, const uint8_t* data, size_t len);
+  static void onResult(void* ctx, uint8_t type, uint32_t ref, uint8_t result,
+                       uint8_t ackStatus, uint32_t rttMs);
+
+  void sendToLan(uint32_t nowMs);
+  void sendToCloud();
+  void finish(uint8_t path, uint32_t nowMs);
+
+  WiFiUDP    udp;
+  LanLink    link;
+  CloudAuth* cloud = nullptr;
+  String     uid;
+  uint8_t    key[LANLINK_KEY_MAX];
+  Stats      st = {};
+  DoseFn     doseFn = nullptr;
+
+  // Correção em andamento (uma por vez)
+  bool     pending = false;
+  bool     waitingAck = false;
+  bool     goCloud = false;       // decidido no onResult, feito no loop()
+  uint32_t requestId = 0;
+  uint8_t  pumpIndex = 0;
+  float    volumeMl = 0;
+  uint32_t startMs = 0;
+  uint32_t retryAtMs = 0;
+  uint8_t  busyTries = 0;
+  char     doserUid[32] = {0};
+};
@@ -0,0 +1,103 @@
+#include "JsonArena.h"
+
+// Cada bloco: cabeçalho de 8 bytes + pool (múltiplo de 8). 'prev' encadeia
+// os blocos de cima para baixo para o topo poder descer.
+struct ArenaHdr {
+  uint32_t size;    // bytes do pool; bit 31 = liberado fora de ordem
+  uint32_t prev;    // offset do cabeçalho abaixo (ARENA_NONE = base)
+};
+
+#define ARENA_NONE  0xFFFFFFFFu
+#define ARENA_FREED 0x80000000u
+
+static uint8_t s_arena[JSON_ARENA_SIZE] __attribute__((aligned(8)));
+static uint32_t s_top = ARENA_NONE;   // cabeçalho do bloco do topo
+static uint32_t s_used = 0;           // fim do bloco do topo
+static JsonArenaStats s_stats = {};
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static inline ArenaHdr* hdrAt(uint32_t off) { return (ArenaHdr*)(s_arena + off); }
+
+static inline bool inArena(const void* p) {
+  return (const uint8_t*)p >= s_arena && (const uint8_t*)p < s_arena + JSON_ARENA_SIZE;
+}
+
+// Desce o topo enquanto ele estiver liberado
+static void popFreed() {
+  while (s_top != ARENA_NONE && (hdrAt(s_top)->size & ARENA_FREED)) {
+    s_used = s_top;
+    s_top = hdrAt(s_top)->prev;
+  }
+  if (s_top == ARENA_NONE) s_used = 0;
+}
+
+void* jsonArenaAlloc(size_t n) {
+  uint32_t size = (n + 7) & ~7u;
+  void* p = nullptr;
+
+  portENTER_CRITICAL(&s_mux);
+  s_stats.allocs++;
+  if (n > 0 && size <= JSON_ARENA_SIZE - sizeof(ArenaHdr) - s_used) {
+    ArenaHdr* h = hdrAt(s_used);
+    h->size = size;
+    h->prev = s_top;
+    s_top = s_used;
+    s_used += sizeof(ArenaHdr) + size;
+    if (s_used > s_stats.peak) s_stats.peak = s_used;
+    p = h + 1;
+  } else {
+    s_stats.fallbacks++;
+  }
+  portEXIT_CRITICAL(&s_mux);
+
+  return p ? p : malloc(n);
+}
+
+void jsonArenaFree(void* p) {
+  if (!p) return;
+  if (!inArena(p)) {
+    free(p);
+    return;
+  }
+  portENTER_CRITICAL(&s_mux);
+  hdrAt((uint8_t*)p - s_arena - sizeof(ArenaHdr))->size |= ARENA_FREED;
+  popFreed();
+  portEXIT_CRITICAL(&s_mux);
+}
+
+void* jsonArenaRealloc(void* p, size_t n) {
+  if (!p) return jsonArenaAlloc(n);
+  if (!inArena(p)) return realloc(p, n);
+
+  uint32_t off = (uint8_t*)p - s_arena - sizeof(ArenaHdr);
+  uint32_t size = (n + 7) & ~7u;
+  uint32_t old;
+
+  // Topo cresce/encolhe no lugar; os outros só encolhem no lugar
+  portENTER_CRITICAL(&s_mux);
+  ArenaHdr* h = hdrAt(off);
+  old = h->size;
+  bool inPlace = size <= old ||
+                 (off == s_top && size <= JSON_ARENA_SIZE - sizeof(ArenaHdr) - off);
+  if (inPlace && off == s_top) {
+    h->size = size;
+    s_used = off + sizeof(ArenaHdr) + size;
+    if (s_used > s_stats.peak) s_stats.peak = s_used;
+  }
+  portEXIT_CRITICAL(&s_mux);
+  if (inPlace) return p;
+
+  void* q = jsonArenaAlloc(n);
+  if (!q) return nullptr;
+  memcpy(q, p, old);
+  jsonArenaFree(p);
+  return q;
+}
+
+JsonArenaStats jsonArenaStats() {
+  portENTER_CRITICAL(&s_mux);
+  JsonArenaStats s = s_stats;
+  s.used = s_used;
+  portEXIT_CRITICAL(&s_mux);
+  return s;
+}
@@ -0,0 +1,40 @@
+//JsonArena.h
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+/**
+ * Arena única para os documentos ArduinoJson do KH
+ *
+ * Cada DynamicJsonDocument fazia malloc/free do pool inteiro (256..8192
+ * bytes) por requisição e, depois de semanas ligado, o heap fragmentava.
+ * JsonDoc tem a mesma interface, mas o pool sai de um bloco estático
+ * alocado uma vez, usado como pilha: documentos são locais e morrem na
+ * ordem inversa em que nasceram, então liberar o topo devolve o espaço na
+ * hora. Bloco liberado fora de ordem fica marcado e volta quando o que está
+ * acima dele sai. Sem espaço na arena -> heap (contado em fallbacks).
+ */
+
+#define JSON_ARENA_SIZE  (20 * 1024)
+
+struct JsonArenaStats {
+  uint32_t used;        // bytes ocupados agora (com cabeçalhos)
+  uint32_t peak;        // pico desde o boot
+  uint32_t allocs;      // documentos criados
+  uint32_t fallbacks;   // documentos que foram para o heap (arena cheia)
+};
+
+void* jsonArenaAlloc(size_t n);
+void  jsonArenaFree(void* p);
+void* jsonArenaRealloc(void* p, size_t n);
+JsonArenaStats jsonArenaStats();
+
+struct JsonArenaAllocator {
+  void* allocate(size_t n) { return jsonArenaAlloc(n); }
+  void deallocate(void* p) { jsonArenaFree(p); }
+  void* reallocate(void* p, size_t n) { return jsonArenaRealloc(p, n); }
+};
+
+// Use no lugar de DynamicJsonDocument (mesma capacidade no construtor)
+typedef BasicJsonDocument<JsonArenaAllocator> JsonDoc;
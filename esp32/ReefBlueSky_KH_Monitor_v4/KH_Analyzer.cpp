@@ -3,6 +3,7 @@
 #include "KH_Analyzer.h"
 #include "Safety.h"
 #include <ArduinoJson.h>
+#include "JsonArena.h"
 #include "TimeProvider.h"  // ou o arquivo correto onde getCurrentEpochMs está
 
 static constexpr unsigned long KH_MAX_FILL_MS = 30000UL;  // 30 s
@@ -287,7 +288,7 @@ bool KH_Analyzer::resetReferenceKHOnly() {
 
 // [PERSISTÊNCIA] Serializar configuração para JSON
 String KH_Analyzer::configToJSON() {
-    DynamicJsonDocument doc(256);
+    JsonDoc doc(256);
     doc["reference_kh"] = serialized(String(_reference_kh, 2));
     doc["configured"] = _reference_kh_configured;
     doc["timestamp"] = getCurrentEpochMs();  // epoch em ms, não uptime
@@ -301,7 +302,7 @@ String KH_Analyzer::configToJSON() {
 // [PERSISTÊNCIA] Desserializar configuração de JSON
 bool KH_Analyzer::configFromJSON(const String& json) {
     try {
-        DynamicJsonDocument doc(256);
+        JsonDoc doc(256);
         DeserializationError error = deserializeJson(doc, json);
         
         if (error) {
@@ -855,7 +856,7 @@ bool KH_Analyzer::loadCalibrationFromSPIFFS() {
         return false;
     }
 
-    DynamicJsonDocument doc(768);  // Aumentado para caber os tempos
+    JsonDoc doc(768);  // Aumentado para caber os tempos
     DeserializationError err = deserializeJson(doc, f);
     f.close();
 
@@ -2,6 +2,7 @@
 
 #include "KH_Calibrator.h"
 #include <ArduinoJson.h>
+#include "JsonArena.h"
 
 KH_Calibrator::KH_Calibrator(PumpControl* pc, SensorManager* sm)
     : _pc(pc), _sm(sm) {}
@@ -571,7 +572,7 @@ bool KH_Calibrator::saveCalibrationToSPIFFS() {
         return false;
     }
 
-    DynamicJsonDocument doc(768);  // Aumentado para caber tempos
+    JsonDoc doc(768);  // Aumentado para caber tempos
     doc["kh_ref_user"]     = _kh_ref_user;
     doc["ph_ref_measured"] = _ph_ref_measured;
     doc["temp_ref"]        = _temp_ref;
@@ -730,7 +731,7 @@ bool KH_Calibrator::loadPreviousCalibration() {
         return false;
     }
 
-    DynamicJsonDocument doc(768);
+    JsonDoc doc(768);
     DeserializationError error = deserializeJson(doc, f);
     f.close();
 
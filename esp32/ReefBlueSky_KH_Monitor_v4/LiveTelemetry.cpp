@@ -0,0 +1,285 @@
+#include "LiveTelemetry.h"
+#include <WiFi.h>
+#include <lwip/sockets.h>
+#include <mbedtls/sha1.h>
+#include <mbedtls/base64.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define WS_GUID          "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define WS_SEND_TIMEOUT  500     // ms; cliente que não esvazia o socket cai
+#define WS_RX_MAX        64      // mensagens do cliente são só controle/"hz=N"
+#define STREAM_PERIOD_MS 100
+
+struct WsClient {
+  WiFiClient sock;
+  bool     active;
+  uint32_t cursor;      // seq da próxima amostra a enviar
+  uint8_t  every;       // envia 1 a cada 'every' amostras
+  uint32_t lost;
+  uint8_t  rx[WS_RX_MAX + 6];
+  uint8_t  rxLen;
+};
+
+static TelemetrySample s_ring[TELEMETRY_RING];
+static uint32_t s_head = 0;             // seq da próxima amostra
+static uint32_t s_dropped = 0;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+static TelemetrySampleFn s_fn = nullptr;
+static WiFiServer s_server(TELEMETRY_WS_PORT);
+static WsClient s_clients[TELEMETRY_MAX_CLIENTS];
+
+// ---------- Amostragem ----------
+
+static void samplerTask(void*) {
+  const TickType_t period = pdMS_TO_TICKS(1000 / TELEMETRY_SAMPLE_HZ);
+  TickType_t last = xTaskGetTickCount();
+  for (;;) {
+    vTaskDelayUntil(&last, period);
+    TelemetrySample s = {};
+    s.t_ms = millis();
+    s_fn(s);
+    portENTER_CRITICAL(&s_mux);
+    s_ring[s_head & (TELEMETRY_RING - 1)] = s;
+    s_head++;
+    portEXIT_CRITICAL(&s_mux);
+  }
+}
+
+// ---------- WebSocket ----------
+
+static uint8_t hzToEvery(int hz) {
+  if (hz < 1) hz = 1;
+  if (hz > TELEMETRY_SAMPLE_HZ) hz = TELEMETRY_SAMPLE_HZ;
+  return TELEMETRY_SAMPLE_HZ / hz;
+}
+
+static bool wsSend(WsClient& c, uint8_t opcode, const uint8_t* data, size_t n) {
+  uint8_t hdr[4];
+  size_t h = 2;
+  hdr[0] = 0x80 | opcode;                 // FIN + opcode, servidor não mascara
+  if (n < 126) {
+    hdr[1] = n;
+  } else {
+    hdr[1] = 126;
+    hdr[2] = n >> 8;
+    hdr[3] = n & 0xFF;
+    h = 4;
+  }
+  return c.sock.write(hdr, h) == h && c.sock.write(data, n) == n;
+}
+
+static void wsDrop(WsClient& c, const char* why) {
+  Serial.printf("[Telemetry] Cliente %s desconectado (%s)\n",
+                c.sock.remoteIP().toString().c_str(), why);
+  c.sock.stop();
+  c.active = false;
+}
+
+// Lê o pedido HTTP de upgrade e responde 101; false = não é WebSocket
+static bool wsHandshake(WiFiClient& sock, int* hz) {
+  char line[160];
+  char key[64] = "";
+  *hz = TELEMETRY_SAMPLE_HZ;
+  sock.setTimeout(1);   // readBytesUntil: 1 s por linha
+
+  bool first = true;
+  for (;;) {
+    size_t n = sock.readBytesUntil('\n', line, sizeof(line) - 1);
+    if (n == 0 && !sock.connected()) return false;
+    line[n] = 0;
+    if (n > 0 && line[n - 1] == '\r') line[--n] = 0;
+    if (n == 0) break;                          // fim dos headers
+
+    if (first) {
+      const char* q = strstr(line, "hz=");
+      if (q) *hz = atoi(q + 3);
+      first = false;
+    } else if (strncasecmp(line, "Sec-WebSocket-Key:", 18) == 0) {
+      const char* v = line + 18;
+      while (*v == ' ') v++;
+      strlcpy(key, v, sizeof(key));
+    }
+  }
+  if (!key[0]) {
+    sock.print("HTTP/1.1 426 Upgrade Required\r\nConnection: close\r\n\r\n");
+    return false;
+  }
+
+  uint8_t sha[20];
+  char accept[32];
+  size_t alen = 0;
+  mbedtls_sha1_context ctx;
+  mbedtls_sha1_init(&ctx);
+  mbedtls_sha1_starts(&ctx);
+  mbedtls_sha1_update(&ctx, (const uint8_t*)key, strlen(key));
+  mbedtls_sha1_update(&ctx, (const uint8_t*)WS_GUID, strlen(WS_GUID));
+  mbedtls_sha1_finish(&ctx, sha);
+  mbedtls_sha1_free(&ctx);
+  mbedtls_base64_encode((uint8_t*)accept, sizeof(accept), &alen, sha, sizeof(sha));
+  accept[alen] = 0;
+
+  sock.printf("HTTP/1.1 101 Switching Protocols\r\n"
+              "Upgrade: websocket\r\n"
+              "Connection: Upgrade\r\n"
+              "Sec-WebSocket-Accept: %s\r\n\r\n", accept);
+  return true;
+}
+
+static void acceptClient() {
+  WiFiClient sock = s_server.available();
+  if (!sock) return;
+
+  int hz;
+  if (!wsHandshake(sock, &hz)) {
+    sock.stop();
+    return;
+  }
+  for (WsClient& c : s_clients) {
+    if (c.active) continue;
+    c.sock = sock;
+    c.sock.setNoDelay(true);
+    struct timeval tv = { 0, WS_SEND_TIMEOUT * 1000 };
+    setsockopt(c.sock.fd(), SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    c.every = hzToEvery(hz);
+    c.lost = 0;
+    c.rxLen = 0;
+    portENTER_CRITICAL(&s_mux);
+    c.cursor = s_head;
+    portEXIT_CRITICAL(&s_mux);
+    c.active = true;
+    Serial.printf("[Telemetry] Cliente %s conectado (%d Hz)\n",
+                  sock.remoteIP().toString().c_str(), TELEMETRY_SAMPLE_HZ / c.every);
+    return;
+  }
+  // Sem vaga: fecha educadamente (1013 = try again later)
+  WsClient tmp;
+  tmp.sock = sock;
+  const uint8_t code[2] = { 0x03, 0xF5 };
+  wsSend(tmp, 0x8, code, sizeof(code));
+  sock.stop();
+}
+
+// Mensagens do cliente (sempre mascaradas): close, ping e "hz=N"
+static void pollClient(WsClient& c) {
+  while (c.sock.available() && c.rxLen < sizeof(c.rx)) {
+    int n = c.sock.read(c.rx + c.rxLen, sizeof(c.rx) - c.rxLen);
+    if (n <= 0) break;
+    c.rxLen += n;
+  }
+  while (c.rxLen >= 2) {
+    uint8_t op = c.rx[0] & 0x0F;
+    uint8_t len = c.rx[1] & 0x7F;
+    if (!(c.rx[1] & 0x80) || len > WS_RX_MAX) {
+      wsDrop(c, "frame inválido");
+      return;
+    }
+    size_t total = 6 + len;
+    if (c.rxLen < total) return;
+
+    uint8_t* msg = c.rx + 6;
+    for (uint8_t i = 0; i < len; i++) msg[i] ^= c.rx[2 + (i & 3)];
+
+    if (op == 0x8) {
+      wsSend(c, 0x8, msg, len);
+      wsDrop(c, "close");
+      return;
+    } else if (op == 0x9) {
+      wsSend(c, 0xA, msg, len);
+    } else if (op == 0x1 && len > 3 && memcmp(msg, "hz=", 3) == 0) {
+      char num[8] = "";
+      memcpy(num, msg + 3, min((int)len - 3, 7));
+      c.every = hzToEvery(atoi(num));
+    }
+    memmove(c.rx, c.rx + total, c.rxLen - total);
+    c.rxLen -= total;
+  }
+}
+
+// Envia o que o cliente ainda não recebeu, respeitando a decimação
+static void pushClient(WsClient& c) {
+  uint8_t frame[TELEMETRY_FRAME_HDR + TELEMETRY_MAX_BATCH * TELEMETRY_SAMPLE_BYTES];
+  TelemetrySample batch[TELEMETRY_MAX_BATCH];
+
+  for (;;) {
+    uint32_t first = 0;
+    uint8_t n = 0;
+    portENTER_CRITICAL(&s_mux);
+    if (s_head - c.cursor > TELEMETRY_RING) {
+      uint32_t skip = s_head - TELEMETRY_RING - c.cursor;
+      c.lost += skip;
+      s_dropped += skip;
+      c.cursor = s_head - TELEMETRY_RING;
+    }
+    while (c.cursor != s_head && n < TELEMETRY_MAX_BATCH) {
+      if (c.cursor % c.every == 0) {
+        if (n == 0) first = c.cursor;
+        batch[n++] = s_ring[c.cursor & (TELEMETRY_RING - 1)];
+      }
+      c.cursor++;
+    }
+    portEXIT_CRITICAL(&s_mux);
+    if (n == 0) return;
+
+    uint16_t periodMs = c.every * (1000 / TELEMETRY_SAMPLE_HZ);
+    frame[0] = TELEMETRY_VERSION;
+    frame[1] = n;
+    memcpy(frame + 2, &periodMs, 2);
+    memcpy(frame + 4, &first, 4);
+    memcpy(frame + 8, &c.lost, 4);
+    uint8_t* p = frame + TELEMETRY_FRAME_HDR;
+    for (uint8_t i = 0; i < n; i++, p += TELEMETRY_SAMPLE_BYTES) {
+      memcpy(p, &batch[i].t_ms, 4);
+      memcpy(p + 4, &batch[i].ph_milli, 2);
+      memcpy(p + 6, &batch[i].temp_centi, 2);
+      memcpy(p + 8, &batch[i].ph_adc, 2);
+      p[10] = batch[i].levels;
+      p[11] = batch[i].state;
+    }
+    if (!wsSend(c, 0x2, frame, p - frame)) {
+      wsDrop(c, "envio travado");
+      return;
+    }
+  }
+}
+
+static void streamTask(void*) {
+  s_server.begin();
+  s_server.setNoDelay(true);
+  Serial.printf("[Telemetry] WebSocket em ws://%s:%d/ (%d Hz)\n",
+                WiFi.localIP().toString().c_str(), TELEMETRY_WS_PORT, TELEMETRY_SAMPLE_HZ);
+  for (;;) {
+    acceptClient();
+    for (WsClient& c : s_clients) {
+      if (!c.active) continue;
+      if (!c.sock.connected()) {
+        wsDrop(c, "conexão fechada");
+        continue;
+      }
+      pollClient(c);
+      if (c.active) pushClient(c);
+    }
+    vTaskDelay(pdMS_TO_TICKS(STREAM_PERIOD_MS));
+  }
+}
+
+// ---------- API ----------
+
+void liveTelemetryBegin(TelemetrySampleFn fn) {
+  if (s_fn || !fn) return;
+  s_fn = fn;
+  // Core 0, prioridade baixa: o loop() (core 1) nunca espera por elas
+  xTaskCreatePinnedToCore(samplerTask, "tlm_sample", 3072, nullptr, 2, nullptr, 0);
+  xTaskCreatePinnedToCore(streamTask, "tlm_ws", 4096, nullptr, 1, nullptr, 0);
+}
+
+LiveTelemetryStats liveTelemetryStats() {
+  LiveTelemetryStats st;
+  portENTER_CRITICAL(&s_mux);
+  st.samples = s_head;
+  st.dropped = s_dropped;
+  portEXIT_CRITICAL(&s_mux);
+  st.clients = 0;
+  for (const WsClient& c : s_clients) st.clients += c.active;
+  return st;
+}
@@ -0,0 +1,57 @@
+//LiveTelemetry.h
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Telemetria local em tempo real (WebSocket, porta TELEMETRY_WS_PORT)
+ *
+ * Uma task amostra pH/temperatura/níveis a TELEMETRY_SAMPLE_HZ num anel de
+ * TELEMETRY_RING amostras; outra atende os clientes WebSocket. O loop de
+ * controle não participa: nada aqui bloqueia o loop().
+ *
+ * Cada cliente tem seu próprio cursor no anel e sua decimação
+ * (ws://<ip>:81/?hz=5, ou mensagem de texto "hz=2" depois de conectado).
+ * Cliente lento não segura os outros nem a amostragem: se o cursor ficar
+ * para trás mais que o anel, pula para as amostras mais antigas ainda
+ * disponíveis e o total perdido vai no cabeçalho do próximo frame.
+ *
+ * Frame binário (little endian):
+ *   0 u8 versão   1 u8 amostras   2 u16 período ms   4 u32 seq da 1ª amostra
+ *   8 u32 amostras perdidas (acumulado do cliente)
+ *   12.. amostras de TELEMETRY_SAMPLE_BYTES:
+ *     u32 millis   i16 pH*1000   i16 temp*100   u16 ADC pH   u8 níveis   u8 estado
+ * Leitor: host/telemetry_csv.py
+ */
+
+#define TELEMETRY_WS_PORT      81
+#define TELEMETRY_SAMPLE_HZ    10
+#define TELEMETRY_RING         256       // amostras (potência de 2) = 25,6 s
+#define TELEMETRY_MAX_CLIENTS  3
+#define TELEMETRY_MAX_BATCH    20        // amostras por frame
+#define TELEMETRY_FRAME_HDR    12
+#define TELEMETRY_SAMPLE_BYTES 12
+#define TELEMETRY_VERSION      1
+
+struct TelemetrySample {
+  uint32_t t_ms;
+  int16_t  ph_milli;     // pH * 1000
+  int16_t  temp_centi;   // °C * 100
+  uint16_t ph_adc;       // leitura crua do ADC (sem média)
+  uint8_t  levels;       // bit 0..2 = câmaras A/B/C molhadas (sem debounce)
+  uint8_t  state;        // SystemState
+};
+
+// Preenche uma amostra; chamada na task de amostragem (não no loop), então
+// só pode fazer leituras rápidas e sem delay
+typedef void (*TelemetrySampleFn)(TelemetrySample& s);
+
+struct LiveTelemetryStats {
+  uint32_t samples;      // amostras desde o boot
+  uint8_t  clients;
+  uint32_t dropped;      // amostras puladas por clientes lentos (total)
+};
+
+// Inicia as tasks e o servidor WebSocket (chamar com WiFi já configurado)
+void liveTelemetryBegin(TelemetrySampleFn fn);
+LiveTelemetryStats liveTelemetryStats();
@@ -218,7 +218,7 @@ bool performLogin(String email, String password) {
   http.begin(client, url);
   http.addHeader("Content-Type", "application/json");
 
-  DynamicJsonDocument doc(256);
+  JsonDoc doc(256);
   doc["email"] = email;
   doc["password"] = password;
 
@@ -235,7 +235,7 @@ bool performLogin(String email, String password) {
 
   if (httpCode == 200) {
     String response = http.getString();
-    DynamicJsonDocument responseDoc(2048);
+    JsonDoc responseDoc(2048);
     Serial.printf("[Auth] Resposta login: %s\n", response.c_str());
     DeserializationError err = deserializeJson(responseDoc, response);
     if (err) {
@@ -285,7 +285,7 @@ bool registerDevice() {
   http.begin(client, url);
   http.addHeader("Content-Type", "application/json");
 
-  DynamicJsonDocument doc(256);
+  JsonDoc doc(256);
   doc["deviceId"] = deviceId;
   doc["username"] = userEmail;
   doc["password"] = userPassword;
@@ -305,7 +305,7 @@ bool registerDevice() {
     String response = http.getString();
     Serial.printf("[DeviceRegister] Resposta: %s\n", response.c_str());
 
-    DynamicJsonDocument respDoc(2048);
+    JsonDoc respDoc(2048);
     DeserializationError err = deserializeJson(respDoc, response);
     if (err) {
       Serial.print("Erro ao parsear resposta de registro: ");
@@ -374,7 +374,7 @@ bool sendMeasurements(float kh, float phRef, float phSample, float temp) {
   http.addHeader("Content-Type", "application/json");
   http.addHeader("Authorization", "Bearer " + deviceToken);
 
-  DynamicJsonDocument doc(512);
+  JsonDoc doc(512);
   String localIp = WiFi.localIP().toString();
   doc["local_ip"] = localIp; 
   //doc["deviceId"] = deviceId;
@@ -426,7 +426,7 @@ bool sendAlert(const String& type, const String& message, const String& severity
   http.addHeader("Content-Type", "application/json");
   http.addHeader("Authorization", "Bearer " + deviceToken);
 
-  DynamicJsonDocument doc(512);
+  JsonDoc doc(512);
   doc["type"]     = type;
   doc["message"]  = message;
   doc["severity"] = severity;
@@ -5,6 +5,7 @@
 #include <WiFi.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
+#include "JsonArena.h"
 #include <Preferences.h>
 
 // Globais (só declaração)
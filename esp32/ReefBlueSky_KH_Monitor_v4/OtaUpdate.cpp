@@ -4,6 +4,15 @@
 #include <WiFi.h>
 #include <Update.h>
 #include <WebServer.h>
+#include <Preferences.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#include <mbedtls/sha256.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include "FwDelta.h"
+#include "WebAssets.h"
 
 
 extern const char* CLOUD_BASE_URL;
@@ -115,195 +124,630 @@ static void callProgressCallback(int written, int total) {
 }
 
 // ======== OTA VIA HTTP ========
+//
+// Produtor/consumidor: quem chama otaInternal() lê o HTTP e enche buffers
+// de OTA_BUF_SIZE; a task "ota_wr" atualiza o SHA-256 e grava cada buffer
+// direto na partição OTA (apaga o setor e escreve). Com 2 buffers o próximo
+// bloco já vai sendo baixado enquanto o anterior é gravado.
+//
+// Cada buffer cheio é exatamente 1 setor, então o offset gravado é sempre
+// alinhado: a cada OTA_NVS_EVERY bytes ele vai para a NVS junto com a
+// identidade do arquivo, e uma queda (inclusive reboot) retoma com Range.
+
+#define OTA_BUF_SIZE         4096          // = setor da flash
+#define OTA_BUF_COUNT        2
+#define OTA_NVS_EVERY        (64 * 1024)   // poupa a NVS: 1 escrita a cada 16 setores
+#define OTA_MAX_RECONNECTS   5
+#define OTA_READ_TIMEOUT_MS  15000
+#define OTA_NVS_NS           "ota_resume"
+
+struct OtaChunk {
+  uint8_t  idx;
+  uint16_t len;   // 0 = fim, task de gravação encerra
+};
+
+// Identidade do arquivo no servidor (decide se um parcial pode ser retomado)
+struct OtaSource {
+  String   sha256;      // X-Firmware-SHA256 (hex minúsculo) ou ""
+  String   etag;
+  uint32_t total = 0;
+
+  String id() const { return sha256.length() ? sha256 : etag + ":" + String(total); }
+};
+
+struct OtaWriter {
+  const esp_partition_t* part = nullptr;
+  uint8_t*          buf[OTA_BUF_COUNT] = {nullptr, nullptr};
+  QueueHandle_t     freeQ = nullptr;   // índices livres para o leitor
+  QueueHandle_t     fullQ = nullptr;   // OtaChunk prontos para gravar
+  SemaphoreHandle_t done  = nullptr;
+  mbedtls_sha256_context sha;
+  volatile uint32_t flashed = 0;
+  volatile esp_err_t err = ESP_OK;
+};
+
+static OtaStats g_stats;
+
+static void otaResumeBegin(const String& url, const String& id, const char* part,
+                           uint32_t total, uint32_t offset) {
+  Preferences p;
+  if (!p.begin(OTA_NVS_NS, false)) return;
+  p.putString("url", url);
+  p.putString("id", id);
+  p.putString("part", part);
+  p.putUInt("total", total);
+  p.putUInt("off", offset);
+  p.end();
+}
 
-/**
- * Download + Update internal
- * Usa yield() em vez de delay() pra não bloquear OTA
- */
-static bool otaInternal(const String& url) {
-  if (WiFi.status() != WL_CONNECTED) {
-    g_lastError = "WiFi not connected";
-    Serial.println("[OTA] WiFi desconectado.");
-    callEventCallback("failed", "WiFi not connected");
+static void otaResumeSetOffset(uint32_t offset) {
+  Preferences p;
+  if (!p.begin(OTA_NVS_NS, false)) return;
+  p.putUInt("off", offset);
+  p.end();
+}
+
+static void otaResumeClear() {
+  Preferences p;
+  if (!p.begin(OTA_NVS_NS, false)) return;
+  p.clear();
+  p.end();
+}
+
+// Offset salvo para esta URL/partição (0 = nada a retomar)
+static uint32_t otaResumeLoad(const String& url, const esp_partition_t* part,
+                              String& id, uint32_t& total) {
+  Preferences p;
+  if (!p.begin(OTA_NVS_NS, true)) return 0;
+  uint32_t off = 0;
+  if (p.getString("url", "") == url && p.getString("part", "") == part->label) {
+    id    = p.getString("id", "");
+    total = p.getUInt("total", 0);
+    off   = p.getUInt("off", 0);
+  }
+  p.end();
+  if (off % OTA_BUF_SIZE || off >= total) off = 0;
+  return off;
+}
+
+static void otaWriterTask(void* arg) {
+  OtaWriter* w = (OtaWriter*)arg;
+  OtaChunk c;
+
+  while (xQueueReceive(w->fullQ, &c, portMAX_DELAY) == pdTRUE && c.len > 0) {
+    if (w->err == ESP_OK) {
+      uint8_t* b = w->buf[c.idx];
+      mbedtls_sha256_update(&w->sha, b, c.len);
+
+      // último bloco pode ser curto: completa até múltiplo de 4 com 0xFF
+      size_t wlen = (c.len + 3) & ~3u;
+      memset(b + c.len, 0xFF, wlen - c.len);
+
+      esp_err_t e = esp_partition_erase_range(w->part, w->flashed, OTA_BUF_SIZE);
+      if (e == ESP_OK) e = esp_partition_write(w->part, w->flashed, b, wlen);
+      if (e == ESP_OK) {
+        w->flashed += c.len;
+        if (w->flashed % OTA_NVS_EVERY == 0) otaResumeSetOffset(w->flashed);
+      } else {
+        w->err = e;
+      }
+    }
+    xQueueSend(w->freeQ, &c.idx, portMAX_DELAY);
+  }
+
+  xSemaphoreGive(w->done);
+  vTaskDelete(NULL);
+}
+
+// GET com Range (se from > 0); preenche a identidade do arquivo.
+// Retorna o código HTTP, -2 se o 206 não começar em 'from'.
+static int otaOpen(HTTPClient& http, WiFiClient& client, const String& url,
+                   uint32_t from, OtaSource& src) {
+  static const char* keys[] = {"X-Firmware-SHA256", "ETag", "Content-Range"};
+
+  http.setTimeout(30000);
+  if (!http.begin(client, url)) return -1;
+  http.collectHeaders(keys, 3);
+  if (from > 0) http.addHeader("Range", "bytes=" + String(from) + "-");
+
+  int code = http.GET();
+  if (code != HTTP_CODE_OK && code != HTTP_CODE_PARTIAL_CONTENT) return code;
+
+  src.sha256 = http.header("X-Firmware-SHA256");
+  src.sha256.toLowerCase();
+  src.etag  = http.header("ETag");
+  src.total = 0;
+
+  if (code == HTTP_CODE_PARTIAL_CONTENT) {
+    String cr = http.header("Content-Range");   // "bytes a-b/total"
+    int slash = cr.lastIndexOf('/');
+    if (!cr.startsWith("bytes ") || slash < 0 ||
+        (uint32_t)cr.substring(6).toInt() != from) {
+      return -2;
+    }
+    src.total = (uint32_t)cr.substring(slash + 1).toInt();
+  } else if (http.getSize() > 0) {
+    src.total = (uint32_t)http.getSize();
+  }
+  return code;
+}
+
+static bool otaAllocWriter(OtaWriter& w) {
+  mbedtls_sha256_init(&w.sha);
+  w.part  = esp_ota_get_next_update_partition(NULL);
+  w.freeQ = xQueueCreate(OTA_BUF_COUNT, sizeof(uint8_t));
+  w.fullQ = xQueueCreate(OTA_BUF_COUNT + 1, sizeof(OtaChunk));
+  w.done  = xSemaphoreCreateBinary();
+  for (int i = 0; i < OTA_BUF_COUNT; i++) w.buf[i] = (uint8_t*)malloc(OTA_BUF_SIZE);
+  return w.part && w.freeQ && w.fullQ && w.done && w.buf[0] && w.buf[1];
+}
+
+static void otaFreeWriter(OtaWriter& w) {
+  for (int i = 0; i < OTA_BUF_COUNT; i++) free(w.buf[i]);
+  if (w.freeQ) vQueueDelete(w.freeQ);
+  if (w.fullQ) vQueueDelete(w.fullQ);
+  if (w.done)  vSemaphoreDelete(w.done);
+  mbedtls_sha256_free(&w.sha);
+}
+
+static bool otaStartWriter(OtaWriter& w) {
+  for (uint8_t i = 0; i < OTA_BUF_COUNT; i++) xQueueSend(w.freeQ, &i, 0);
+  return xTaskCreate(otaWriterTask, "ota_wr", 4096, &w, 2, NULL) == pdPASS;
+}
+
+// Encerra a task de gravação (drena o que estiver na fila) e fecha o SHA-256
+static void otaStopWriter(OtaWriter& w, uint8_t digest[32]) {
+  OtaChunk end = {0, 0};
+  xQueueSend(w.fullQ, &end, portMAX_DELAY);
+  xSemaphoreTake(w.done, portMAX_DELAY);
+  mbedtls_sha256_finish(&w.sha, digest);
+}
+
+// Próximo buffer livre para o leitor (-1 = timeout da gravação)
+static int otaTakeBuffer(OtaWriter& w) {
+  uint8_t idx;
+  unsigned long tw = millis();
+  if (xQueueReceive(w.freeQ, &idx, pdMS_TO_TICKS(30000)) != pdTRUE) return -1;
+  g_stats.flashWaitMs += millis() - tw;
+  return idx;
+}
+
+static bool otaFailed(const String& error) {
+  g_lastError = error;
+  Serial.println("[OTA] Falha: " + error);
+  if (g_ota_command_id > 0)
+    reportOtaProgressToCloud(g_ota_command_id, g_ota_last_reported, "failed");
+  callEventCallback("failed", g_lastError);
+  g_otaInProgress = false;
+  return false;
+}
+
+// Throughput, callbacks e reporte ao backend (throttle 25%)
+static void otaProgress(uint32_t received, uint32_t total, uint32_t base,
+                        unsigned long t0, int& lastPct) {
+  unsigned long dt = millis() - t0;
+  if (dt > 0) g_stats.bytesPerSec = (uint64_t)(received - base) * 1000 / dt;
+
+  int prog = (uint64_t)received * 100 / total;
+  if (prog == lastPct) return;
+  lastPct = prog;
+
+  callProgressCallback(received, total);
+  if (prog % 10 == 0) {
+    Serial.printf("[OTA] %d%% (%u/%u) %u KB/s, espera flash %u ms\n", prog, received,
+                  total, g_stats.bytesPerSec / 1024, g_stats.flashWaitMs);
+  }
+  if (g_ota_command_id > 0) {
+    int milestone = (prog / 25) * 25;
+    if (milestone > g_ota_last_reported) {
+      reportOtaProgressToCloud(g_ota_command_id, milestone, "in_progress");
+      g_ota_last_reported = milestone;
+    }
+  }
+}
+
+// Conexão caiu: reabre com Range a partir de 'received'. false = desistir
+// (error preenchido); true = seguir lendo (mesmo que esta tentativa falhe).
+static bool otaReconnect(HTTPClient& http, WiFiClient& client, const String& url,
+                         uint32_t received, uint32_t total, const OtaSource& src,
+                         String& error) {
+  http.end();
+  if (++g_stats.reconnects > OTA_MAX_RECONNECTS) {
+    error = "Conexão perdida em " + String(received) + "/" + String(total);
     return false;
   }
+  Serial.printf("[OTA] Conexão caiu em %u/%u, retomando (%u/%d)\n",
+                received, total, g_stats.reconnects, OTA_MAX_RECONNECTS);
+  callEventCallback("resuming", String(received));
+  delay(1000 * g_stats.reconnects);
+
+  OtaSource again;
+  int code = otaOpen(http, client, url, received, again);
+  if (code == HTTP_CODE_PARTIAL_CONTENT) {
+    if (again.id() != src.id() || again.total != total) {
+      error = "Firmware mudou no servidor durante o download";
+      return false;
+    }
+  } else {
+    Serial.printf("[OTA] Retomada falhou: HTTP %d\n", code);
+    http.end();   // próxima volta tenta de novo
+  }
+  return true;
+}
+
+// Imagem gravada e conferida: troca a partição de boot e reinicia
+static bool otaCommit(const esp_partition_t* part) {
+  // Valida a imagem (cabeçalho/checksum do app) e troca a partição de boot
+  esp_err_t err = esp_ota_set_boot_partition(part);
+  otaResumeClear();
+  if (err != ESP_OK) {
+    return otaFailed("esp_ota_set_boot_partition: " + String(esp_err_to_name(err)));
+  }
 
+  // Reporta 100% / done antes de reiniciar
+  if (g_ota_command_id > 0)
+    reportOtaProgressToCloud(g_ota_command_id, 100, "done");
+
+  // Log de sucesso no backend antes de reiniciar
+  logOtaSuccessToCloud();
+
+  Serial.println("[OTA] 100% OK - Reboot em 2s!");
+  callEventCallback("success", "Rebooting...");
+  g_otaInProgress = false;
+
+  delay(2000);
+  Serial.println("[OTA] chamando ESP.restart()");
+  ESP.restart();
+  return true;
+}
+
+static void otaBeginSession() {
   g_otaInProgress = true;
   g_lastError = "";
   g_ota_last_reported = -1;
+  g_stats = OtaStats();
 
   // Reporta início (0%) se commandId válido
   if (g_ota_command_id > 0) {
     reportOtaProgressToCloud(g_ota_command_id, 0, "in_progress");
     g_ota_last_reported = 0;
   }
+}
 
-  WiFiClient client;
-  HTTPClient http;
+static bool otaInternal(const String& url) {
+  if (WiFi.status() != WL_CONNECTED) {
+    g_lastError = "WiFi not connected";
+    Serial.println("[OTA] WiFi desconectado.");
+    callEventCallback("failed", "WiFi not connected");
+    return false;
+  }
 
+  otaBeginSession();
   Serial.println("[OTA] Baixando: " + url);
   callEventCallback("started", url);
 
-  // Timeout na requisição
-  http.setTimeout(30000);
-
-  if (!http.begin(client, url)) {
-    g_lastError = "HTTP begin failed";
-    Serial.println("[OTA] HTTP begin falhou.");
-    callEventCallback("failed", g_lastError);
-    g_otaInProgress = false;
-    return false;
+  OtaWriter w;
+  if (!otaAllocWriter(w)) {
+    otaFreeWriter(w);
+    return otaFailed(w.part ? "Sem memória para buffers OTA" : "Partição OTA não encontrada");
   }
 
-  int httpCode = http.GET();
-  Serial.printf("[OTA] HTTP code=%d\n", httpCode);
+  WiFiClient client;
+  HTTPClient http;
+  OtaSource src;
+
+  // Retomada após reboot: só vale se o servidor devolver 206 do mesmo arquivo
+  String savedId;
+  uint32_t savedTotal = 0;
+  uint32_t offset = otaResumeLoad(url, w.part, savedId, savedTotal);
 
-  if (httpCode != HTTP_CODE_OK) {
-    g_lastError = "HTTP " + String(httpCode);
-    Serial.printf("[OTA] erro HTTP: %s\n", http.errorToString(httpCode).c_str());
+  int httpCode = otaOpen(http, client, url, offset, src);
+  if (offset > 0 &&
+      (httpCode != HTTP_CODE_PARTIAL_CONTENT || src.id() != savedId || src.total != savedTotal)) {
+    Serial.printf("[OTA] Parcial de %u bytes descartado (HTTP %d)\n", offset, httpCode);
     http.end();
-    callEventCallback("failed", g_lastError);
-    g_otaInProgress = false;
-    return false;
+    offset = 0;
+    httpCode = otaOpen(http, client, url, 0, src);
   }
+  Serial.printf("[OTA] HTTP code=%d, total=%u, sha256=%s\n",
+                httpCode, src.total, src.sha256.length() ? src.sha256.c_str() : "-");
 
-  int contentLen = http.getSize();
-  Serial.printf("[OTA] Content-Length: %d bytes\n", contentLen);
-
-  WiFiClient* stream = http.getStreamPtr();
+  if (httpCode != HTTP_CODE_OK && httpCode != HTTP_CODE_PARTIAL_CONTENT) {
+    http.end();
+    otaFreeWriter(w);
+    return otaFailed("HTTP " + String(httpCode));
+  }
+  if (src.total == 0 || src.total > w.part->size) {
+    http.end();
+    otaFreeWriter(w);
+    return otaFailed("Tamanho inválido: " + String(src.total));
+  }
+  const uint32_t total = src.total;
+
+  // SHA-256 cobre o arquivo inteiro: na retomada, re-hash do que já está na flash
+  mbedtls_sha256_starts(&w.sha, 0);
+  for (uint32_t pos = 0; pos < offset; pos += OTA_BUF_SIZE) {
+    if (esp_partition_read(w.part, pos, w.buf[0], OTA_BUF_SIZE) != ESP_OK) {
+      http.end();
+      otaFreeWriter(w);
+      otaResumeClear();
+      return otaFailed("Falha lendo parcial da flash");
+    }
+    mbedtls_sha256_update(&w.sha, w.buf[0], OTA_BUF_SIZE);
+  }
+  w.flashed = offset;
+  g_stats.resumedFrom = offset;
+  otaResumeBegin(url, src.id(), w.part->label, total, offset);
 
-  // Usar contentLen se disponível, senão UPDATE_SIZE_UNKNOWN
-  size_t total = (contentLen > 0) ? (size_t)contentLen : (size_t)UPDATE_SIZE_UNKNOWN;
+  if (offset > 0) {
+    Serial.printf("[OTA] Retomando de %u/%u bytes\n", offset, total);
+    callEventCallback("resumed", String(offset));
+  }
 
-  if (!Update.begin(total)) {
-    g_lastError = "Update.begin failed: " + String(Update.errorString());
-    Serial.printf("[OTA] Update.begin falhou: %s\n", Update.errorString());
+  if (!otaStartWriter(w)) {
     http.end();
-    callEventCallback("failed", g_lastError);
-    g_otaInProgress = false;
-    return false;
+    otaFreeWriter(w);
+    return otaFailed("Falha criando task de gravação");
   }
 
-  callEventCallback("downloading", "0%");
-
-  size_t written = 0;
-  uint8_t buff[512];
-  unsigned long lastYield = millis();
+  callEventCallback("downloading", String(offset * 100 / total) + "%");
+
+  // http.begin(client, ...) lê deste client; após http.end() ele só fica
+  // desconectado (getStreamPtr() devolveria nullptr) e dispara a retomada
+  WiFiClient* stream = &client;
+  String error;
+  uint32_t received = offset;         // bytes do arquivo já lidos do HTTP
+  int cur = -1;                       // buffer sendo enchido
+  uint32_t fill = 0;
+  int lastPct = -1;
+  unsigned long t0 = millis();
+  unsigned long lastDataMs = t0;
+
+  while (received < total) {
+    if (!g_otaInProgress) { error = "Cancelled"; break; }
+    if (w.err != ESP_OK) { error = "Flash write error " + String((int)w.err); break; }
+
+    if (cur < 0) {
+      cur = otaTakeBuffer(w);
+      if (cur < 0) { error = "Timeout gravando flash"; break; }
+      fill = 0;
+    }
 
-  unsigned long lastDataMs = millis();
+    size_t avail = stream->available();
+    if (avail) {
+      size_t want = min((size_t)(OTA_BUF_SIZE - fill), (size_t)(total - received));
+      size_t len = stream->readBytes(w.buf[cur] + fill, min(want, avail));
+      fill += len;
+      received += len;
+      lastDataMs = millis();
 
-  while (g_otaInProgress) {
-    size_t available = stream->available();
+      if (fill == OTA_BUF_SIZE || received == total) {
+        OtaChunk c = {(uint8_t)cur, (uint16_t)fill};
+        xQueueSend(w.fullQ, &c, portMAX_DELAY);
+        cur = -1;
+        otaProgress(received, total, offset, t0, lastPct);
+      }
+      continue;
+    }
 
-    if (available) {
-      size_t len = stream->readBytes(buff,
-        (available > sizeof(buff)) ? sizeof(buff) : available);
+    if (stream->connected() && millis() - lastDataMs < OTA_READ_TIMEOUT_MS) {
+      delay(1);
+      continue;
+    }
+    if (!otaReconnect(http, client, url, received, total, src, error)) break;
+    lastDataMs = millis();
+  }
 
-      if (len == 0) {
-        // fim do stream
-        break;
-      }
+  uint8_t digest[32];
+  otaStopWriter(w, digest);
+  http.end();
 
-      size_t writeRes = Update.write(buff, len);
-      if (writeRes != len) {
-        g_lastError = String("Write error: ") + String(writeRes) + "/" + String(len) +
-                      " code=" + String(Update.getError());
-        Serial.printf("[OTA] write falhou %u/%u, error=%d\n",
-          writeRes, len, Update.getError());
-        http.end();
-        Update.abort();
-        if (g_ota_command_id > 0)
-          reportOtaProgressToCloud(g_ota_command_id, g_ota_last_reported, "failed");
-        callEventCallback("failed", g_lastError);
-        g_otaInProgress = false;
-        return false;
-      }
+  if (error.length() == 0 && w.err != ESP_OK) error = "Flash write error " + String((int)w.err);
+  if (error.length() == 0 && w.flashed != total) error = "Update incomplete";
 
-      written += len;
-      lastDataMs = millis();
+  const esp_partition_t* part = w.part;
+  otaFreeWriter(w);
 
-      // Log de progresso
-      if (contentLen > 0) {
-        int prog = (written * 100) / (size_t)contentLen;
-        if (prog % 10 == 0 || written == (size_t)contentLen) {
-          Serial.printf("[OTA] %d%% (%u/%d)\n", prog, written, contentLen);
-          callProgressCallback(written, contentLen);
-        }
-        // Throttle: reporta ao backend apenas em múltiplos de 25%
-        if (g_ota_command_id > 0) {
-          int milestone = (prog / 25) * 25;
-          if (milestone > g_ota_last_reported) {
-            reportOtaProgressToCloud(g_ota_command_id, milestone, "in_progress");
-            g_ota_last_reported = milestone;
-          }
-        }
-      } else {
-        if (written % 10240 == 0) {
-          Serial.printf("[OTA] %u bytes...\n", written);
-          callProgressCallback(written, written);
-        }
-      }
+  Serial.printf("[OTA] Download: %u/%u bytes, %u KB/s, %u reconexões\n",
+                received, total, g_stats.bytesPerSec / 1024, g_stats.reconnects);
 
-      unsigned long now = millis();
-      if (now - lastYield > 100) {
-        yield();
-        lastYield = now;
-      }
+  if (error.length()) {
+    // Cancelado/queda: mantém o offset na NVS para retomar na próxima tentativa
+    return otaFailed(error);
+  }
 
-    } else {
-      // já baixou tudo e não vem mais nada há 5s → sai do loop
-      if (contentLen > 0 &&
-          written >= (size_t)contentLen &&
-          millis() - lastDataMs > 5000) {
-        Serial.println("[OTA] Timeout pós-download, saindo do loop");
-        break;
-      }
-      yield();
-      delay(1);
+  char hex[65];
+  for (int i = 0; i < 32; i++) sprintf(hex + i * 2, "%02x", digest[i]);
+  if (src.sha256.length()) {
+    if (src.sha256 != hex) {
+      otaResumeClear();
+      return otaFailed("SHA-256 divergente: " + String(hex));
     }
+    Serial.println("[OTA] SHA-256 OK");
+  } else {
+    Serial.printf("[OTA] Servidor sem X-Firmware-SHA256; sha256=%s\n", hex);
   }
 
-  http.end();
+  return otaCommit(part);
+}
 
-  Serial.printf("\n[OTA] pós-http.end, written=%u, total=%d\n", written, contentLen);
+// ======== OTA DELTA ========
+//
+// O backend gera patches RBSD (backend/fwdelta) do firmware de cada versão
+// anterior para a mais nova. O patch é aplicado em streaming: FwDelta lê o
+// firmware antigo da partição em execução e o resultado entra nos mesmos
+// buffers/task de gravação do download completo. Sem patch para a versão
+// atual (404) ou qualquer falha -> o chamador baixa a imagem completa.
+
+struct OtaDeltaSink {
+  OtaWriter*             w;
+  const esp_partition_t* running;
+  int                    cur = -1;
+  uint32_t               fill = 0;
+};
+
+static int otaDeltaReadOld(void* user, uint32_t off, uint8_t* buf, uint32_t len) {
+  OtaDeltaSink* s = (OtaDeltaSink*)user;
+  return esp_partition_read(s->running, off, buf, len) == ESP_OK ? 0 : -1;
+}
 
-  Serial.println("\n[OTA] Download concluído, finalizando...");
+static int otaDeltaWrite(void* user, const uint8_t* data, uint32_t len) {
+  OtaDeltaSink* s = (OtaDeltaSink*)user;
+  OtaWriter& w = *s->w;
+  while (len > 0) {
+    if (w.err != ESP_OK) return -1;
+    if (s->cur < 0) {
+      s->cur = otaTakeBuffer(w);
+      if (s->cur < 0) return -1;
+      s->fill = 0;
+    }
+    uint32_t n = min((uint32_t)(OTA_BUF_SIZE - s->fill), len);
+    memcpy(w.buf[s->cur] + s->fill, data, n);
+    s->fill += n;
+    data += n;
+    len -= n;
+    if (s->fill == OTA_BUF_SIZE) {
+      OtaChunk c = {(uint8_t)s->cur, (uint16_t)s->fill};
+      xQueueSend(w.fullQ, &c, portMAX_DELAY);
+      s->cur = -1;
+    }
+  }
+  return 0;
+}
 
-  if (!Update.end(true)) {  // true = setSize() com bytes escritos
-    g_lastError = "Update.end failed: " + String(Update.errorString());
-    Serial.printf("[OTA] Erro: %s\n", Update.errorString());
-    if (g_ota_command_id > 0)
-      reportOtaProgressToCloud(g_ota_command_id, g_ota_last_reported, "failed");
-    callEventCallback("failed", g_lastError);
-    g_otaInProgress = false;
+// Confere o firmware em execução com o old_sha256 do patch
+static bool otaDeltaCheckOld(fwd_ctx_t* fwd, const esp_partition_t* running, uint8_t* buf) {
+  if (fwd->hdr.old_size > running->size) return false;
+
+  mbedtls_sha256_context sha;
+  mbedtls_sha256_init(&sha);
+  mbedtls_sha256_starts(&sha, 0);
+  bool ok = true;
+  for (uint32_t pos = 0; pos < fwd->hdr.old_size && ok; pos += OTA_BUF_SIZE) {
+    uint32_t n = min((uint32_t)OTA_BUF_SIZE, fwd->hdr.old_size - pos);
+    ok = fwd_read_old(fwd, pos, buf, n) == FWD_OK;
+    if (ok) mbedtls_sha256_update(&sha, buf, n);
+  }
+  uint8_t digest[32];
+  mbedtls_sha256_finish(&sha, digest);
+  mbedtls_sha256_free(&sha);
+  return ok && memcmp(digest, fwd->hdr.old_sha256, 32) == 0;
+}
+
+// true só se aplicou e vai reiniciar; false = usar a imagem completa
+static bool otaDeltaInternal(const String& url) {
+  g_lastError = "";
+  if (WiFi.status() != WL_CONNECTED) return false;
+
+  WiFiClient client;
+  HTTPClient http;
+  OtaSource src;
+  int httpCode = otaOpen(http, client, url, 0, src);
+  if (httpCode != HTTP_CODE_OK || src.total == 0) {
+    Serial.printf("[OTA] Sem patch delta (HTTP %d), usando imagem completa\n", httpCode);
+    http.end();
     return false;
   }
 
-  if (!Update.isFinished()) {
-    g_lastError = "Update incomplete";
-    Serial.println("[OTA] Update não finalizou corretamente");
-    if (g_ota_command_id > 0)
-      reportOtaProgressToCloud(g_ota_command_id, g_ota_last_reported, "failed");
-    callEventCallback("failed", g_lastError);
+  otaBeginSession();
+  Serial.printf("[OTA] Delta: %s (%u bytes)\n", url.c_str(), src.total);
+  callEventCallback("started", url);
+
+  OtaWriter w;
+  if (!otaAllocWriter(w)) {
+    http.end();
+    otaFreeWriter(w);
     g_otaInProgress = false;
     return false;
   }
 
-  // Reporta 100% / done antes de reiniciar
-  if (g_ota_command_id > 0)
-    reportOtaProgressToCloud(g_ota_command_id, 100, "done");
+  static fwd_ctx_t fwd;   // ~2.5 KB, fora da pilha do loop
+  OtaDeltaSink sink;
+  sink.w = &w;
+  sink.running = esp_ota_get_running_partition();
+  fwd_init(&fwd, otaDeltaReadOld, otaDeltaWrite, &sink);
+  mbedtls_sha256_starts(&w.sha, 0);
+
+  // Lê o patch em w.buf[1] até o cabeçalho; a gravação só começa depois dele
+  uint8_t* in = w.buf[1];
+  const uint32_t total = src.total;
+  WiFiClient* stream = &client;
+  String error;
+  bool writing = false;
+  uint32_t received = 0;
+  int lastPct = -1;
+  int r = FWD_OK;
+  unsigned long t0 = millis();
+  unsigned long lastDataMs = t0;
+  static uint8_t inbuf[1024];
+
+  while (r != FWD_DONE) {
+    if (!g_otaInProgress) { error = "Cancelled"; break; }
+    if (received >= total) { error = "Patch incompleto"; break; }
+
+    size_t avail = stream->available();
+    if (avail) {
+      size_t len = stream->readBytes(inbuf, min(min(avail, sizeof(inbuf)), (size_t)(total - received)));
+      received += len;
+      lastDataMs = millis();
 
-  // Log de sucesso no backend antes de reiniciar
-  logOtaSuccessToCloud();
+      const uint8_t* p = inbuf;
+      while (len > 0 && r != FWD_DONE) {
+        size_t used = 0;
+        r = fwd_feed(&fwd, p, len, &used);
+        p += used;
+        len -= used;
+        if (r < 0) break;
+        if (r == FWD_HEADER) {
+          if (!otaDeltaCheckOld(&fwd, sink.running, in)) { error = "Firmware em execução não confere com o patch"; break; }
+          if (fwd.hdr.new_size > w.part->size) { error = "Imagem nova maior que a partição"; break; }
+          // A partição vai ser sobrescrita: parcial de download completo deixa de valer
+          otaResumeClear();
+          if (!otaStartWriter(w)) { error = "Falha criando task de gravação"; break; }
+          writing = true;
+        }
+      }
+      if (r < 0 && error.length() == 0) error = "Patch inválido (" + String(r) + ")";
+      if (error.length()) break;
+      otaProgress(received, total, 0, t0, lastPct);
+      continue;
+    }
 
-  Serial.println("[OTA] 100% OK - Reboot em 2s!");
-  callEventCallback("success", "Rebooting...");
-  g_otaInProgress = false;
+    if (stream->connected() && millis() - lastDataMs < OTA_READ_TIMEOUT_MS) {
+      delay(1);
+      continue;
+    }
+    if (!otaReconnect(http, client, url, received, total, src, error)) break;
+    lastDataMs = millis();
+  }
+  http.end();
 
-  delay(2000);
-  Serial.println("[OTA] chamando ESP.restart()");
-  ESP.restart();
-  return true;
+  uint8_t digest[32];
+  if (writing) {
+    // último bloco curto ainda no buffer do sink
+    if (error.length() == 0 && sink.cur >= 0 && sink.fill > 0) {
+      OtaChunk c = {(uint8_t)sink.cur, (uint16_t)sink.fill};
+      xQueueSend(w.fullQ, &c, portMAX_DELAY);
+    }
+    otaStopWriter(w, digest);
+  }
+  bool ok = writing && error.length() == 0 && w.err == ESP_OK &&
+            w.flashed == fwd.hdr.new_size && memcmp(digest, fwd.hdr.new_sha256, 32) == 0;
+  if (writing && error.length() == 0 && !ok) error = "Imagem reconstruída não confere (SHA-256)";
+  const esp_partition_t* part = w.part;
+  otaFreeWriter(w);
+
+  Serial.printf("[OTA] Delta: %u/%u bytes de patch -> %u bytes, %u KB/s\n",
+                received, total, fwd.hdr.new_size, g_stats.bytesPerSec / 1024);
+
+  if (!ok) {
+    Serial.println("[OTA] Delta falhou (" + error + "), usando imagem completa");
+    callEventCallback("delta_failed", error);
+    g_lastError = error;
+    g_otaInProgress = false;
+    return false;
+  }
+  return otaCommit(part);
 }
 
 bool otaFromUrl(const String& url) {
@@ -316,6 +760,9 @@ void otaSetCommandId(int id) {
 }
 
 bool otaUpdateKh() {
+  // Patch delta a partir do firmware em execução; sem patch -> imagem completa
+  if (otaDeltaInternal(g_baseUrl + "/ota/kh/latest.delta?from=" + String(FW_VERSION))) return true;
+  if (g_lastError == "Cancelled") return false;
   return otaInternal(g_baseUrl + "/ota/kh/latest.bin");
 }
 
@@ -332,259 +779,12 @@ bool otaUpdateLcd() {
 static bool g_webOtaInProgress = false;
 static String g_webOtaError;
 
-static const char* WEB_OTA_HTML PROGMEM = R"HTML(
-<!DOCTYPE html>
-<html>
-<head>
-  <meta charset="UTF-8">
-  <meta name="viewport" content="width=device-width, initial-scale=1.0">
-  <title>ReefBlueSky OTA Update</title>
-  <style>
-    * { margin: 0; padding: 0; box-sizing: border-box; }
-    body {
-      font-family: -apple-system, BlinkMacSystemFont, 'Segoe UI', sans-serif;
-      background: linear-gradient(135deg, #0f172a 0%, #020617 100%);
-      min-height: 100vh;
-      display: flex;
-      align-items: center;
-      justify-content: center;
-      color: #f1f5f9;
-      padding: 20px;
-    }
-    .container {
-      background: #1e293b;
-      border-radius: 12px;
-      padding: 40px;
-      max-width: 500px;
-      width: 100%;
-      box-shadow: 0 20px 60px rgba(0, 0, 0, 0.4);
-      border: 1px solid rgba(56, 189, 248, 0.2);
-    }
-    h1 {
-      font-size: 28px;
-      margin-bottom: 10px;
-      color: #38bdf8;
-      text-align: center;
-    }
-    .subtitle {
-      text-align: center;
-      color: #cbd5e1;
-      margin-bottom: 30px;
-      font-size: 14px;
-    }
-    .form-group {
-      margin-bottom: 20px;
-    }
-    label {
-      display: block;
-      margin-bottom: 8px;
-      font-weight: 500;
-      color: #cbd5e1;
-    }
-    input[type="file"] {
-      display: block;
-      width: 100%;
-      padding: 12px;
-      background: #0f172a;
-      border: 2px dashed #38bdf8;
-      border-radius: 8px;
-      color: #f1f5f9;
-      cursor: pointer;
-      transition: all 0.3s ease;
-    }
-    input[type="file"]:hover {
-      background: #334155;
-      border-color: #0284c7;
-    }
-    .btn {
-      width: 100%;
-      padding: 12px;
-      background: #38bdf8;
-      color: #0f172a;
-      border: none;
-      border-radius: 8px;
-      font-weight: 600;
-      font-size: 16px;
-      cursor: pointer;
-      transition: all 0.3s ease;
-    }
-    .btn:hover {
-      background: #0284c7;
-      transform: translateY(-2px);
-      box-shadow: 0 8px 20px rgba(56, 189, 248, 0.3);
-    }
-    .btn:disabled {
-      background: #64748b;
-      cursor: not-allowed;
-      opacity: 0.6;
-    }
-    .status {
-      margin-top: 20px;
-      padding: 15px;
-      border-radius: 8px;
-      display: none;
-      font-size: 14px;
-    }
-    .status.info {
-      background: rgba(56, 189, 248, 0.1);
-      color: #38bdf8;
-      border: 1px solid rgba(56, 189, 248, 0.3);
-      display: block;
-    }
-    .status.success {
-      background: rgba(34, 197, 94, 0.1);
-      color: #22c55e;
-      border: 1px solid rgba(34, 197, 94, 0.3);
-      display: block;
-    }
-    .status.error {
-      background: rgba(239, 68, 68, 0.1);
-      color: #ef4444;
-      border: 1px solid rgba(239, 68, 68, 0.3);
-      display: block;
-    }
-    .progress-bar {
-      width: 100%;
-      height: 6px;
-      background: #334155;
-      border-radius: 3px;
-      margin-top: 10px;
-      overflow: hidden;
-    }
-    .progress-fill {
-      height: 100%;
-      background: #38bdf8;
-      width: 0%;
-      transition: width 0.2s ease;
-    }
-    .filename {
-      color: #94a3b8;
-      font-size: 12px;
-      margin-top: 8px;
-    }
-  </style>
-</head>
-<body>
-  <div class="container">
-    <h1>🌊 ReefBlueSky OTA</h1>
-    <p class="subtitle">Atualização de Firmware via Web</p>
-    
-    <form id="otaForm" enctype="multipart/form-data">
-      <div class="form-group">
-        <label for="firmware">Selecione o arquivo .bin:</label>
-        <input type="file" id="firmware" name="firmware" accept=".bin" required>
-        <div class="filename" id="filename"></div>
-      </div>
-      
-      <button type="submit" class="btn" id="submitBtn">Iniciar Atualização</button>
-      
-      <div id="status" class="status"></div>
-      <div class="progress-bar" id="progressBar" style="display: none;">
-        <div class="progress-fill" id="progressFill"></div>
-      </div>
-    </form>
-  </div>
-
-  <script>
-    const form = document.getElementById('otaForm');
-    const fileInput = document.getElementById('firmware');
-    const submitBtn = document.getElementById('submitBtn');
-    const statusDiv = document.getElementById('status');
-    const progressBar = document.getElementById('progressBar');
-    const progressFill = document.getElementById('progressFill');
-    const filenameDiv = document.getElementById('filename');
-
-    fileInput.addEventListener('change', (e) => {
-      const filename = e.target.files[0]?.name || '';
-      if (filename) {
-        filenameDiv.textContent = '📄 ' + filename;
-      } else {
-        filenameDiv.textContent = '';
-      }
-    });
-
-    form.addEventListener('submit', async (e) => {
-      e.preventDefault();
-      
-      const file = fileInput.files[0];
-      if (!file) {
-        showStatus('Selecione um arquivo .bin', 'error');
-        return;
-      }
-
-      if (!file.name.endsWith('.bin')) {
-        showStatus('Arquivo deve ter extensão .bin', 'error');
-        return;
-      }
-
-      const formData = new FormData();
-      formData.append('firmware', file);
-
-      submitBtn.disabled = true;
-      progressBar.style.display = 'block';
-      progressFill.style.width = '0%';
-      showStatus('Enviando firmware... ' + formatBytes(file.size), 'info');
-
-      try {
-        const xhr = new XMLHttpRequest();
-
-        xhr.upload.addEventListener('progress', (e) => {
-          if (e.lengthComputable) {
-            const percent = Math.round((e.loaded / e.total) * 100);
-            progressFill.style.width = percent + '%';
-            showStatus('Progresso: ' + percent + '% (' + formatBytes(e.loaded) + '/' + formatBytes(e.total) + ')', 'info');
-          }
-        });
-
-        xhr.addEventListener('load', () => {
-          if (xhr.status === 200) {
-            showStatus('✅ Firmware atualizado! Reiniciando...', 'success');
-            progressFill.style.width = '100%';
-            setTimeout(() => {
-              showStatus('Dispositivo reiniciando... (aguarde 30s)', 'info');
-            }, 2000);
-          } else {
-            const errorText = xhr.responseText || 'Erro desconhecido';
-            showStatus('❌ Erro: ' + errorText, 'error');
-            submitBtn.disabled = false;
-          }
-        });
-
-        xhr.addEventListener('error', () => {
-          showStatus('❌ Erro de conexão (dispositivo pode estar reiniciando)', 'error');
-          submitBtn.disabled = false;
-        });
-
-        xhr.open('POST', '/webota');
-        xhr.send(formData);
-
-      } catch (error) {
-        showStatus('❌ Erro: ' + error.message, 'error');
-        submitBtn.disabled = false;
-      }
-    });
-
-    function showStatus(msg, type) {
-      statusDiv.textContent = msg;
-      statusDiv.className = 'status ' + type;
-    }
-
-    function formatBytes(bytes) {
-      if (bytes === 0) return '0 Bytes';
-      const k = 1024;
-      const sizes = ['Bytes', 'KB', 'MB'];
-      const i = Math.floor(Math.log(bytes) / Math.log(k));
-      return Math.round(bytes / Math.pow(k, i) * 100) / 100 + ' ' + sizes[i];
-    }
-  </script>
-</body>
-</html>
-)HTML";
+// Página de upload: web/webota.html, servida em gzip da flash (WebAssets)
 
 void setupWebOtaRoutes(WebServer& server) {
+  webAssetCollectHeaders(server);
   server.on("/webota", HTTP_GET, [&server]() {
-    server.sendHeader("Content-Type", "text/html; charset=UTF-8");
-    server.send(200, "text/html", (const __FlashStringHelper*)WEB_OTA_HTML);
+    webAssetSend(server, WEB_ASSET_WEBOTA);
   });
 
   server.on("/webota", HTTP_POST,
@@ -674,7 +874,8 @@ bool otaIsInProgress() {
 
 void otaCancel() {
   if (g_otaInProgress || g_webOtaInProgress) {
-    Update.abort();
+    // OTA HTTP: o loop de download vê a flag e encerra (parcial fica na NVS)
+    if (g_webOtaInProgress) Update.abort();
     g_otaInProgress = false;
     g_webOtaInProgress = false;
     g_lastError = "Cancelled";
@@ -686,3 +887,7 @@ void otaCancel() {
 String otaGetLastError() {
   return g_lastError;
 }
+
+OtaStats otaGetStats() {
+  return g_stats;
+}
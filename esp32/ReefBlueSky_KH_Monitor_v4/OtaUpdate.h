@@ -9,6 +9,14 @@ typedef void (*OtaProgressCallback)(int percent, int written, int total);
 // Callback opcional para eventos OTA (started, success, failed)
 typedef void (*OtaEventCallback)(const String& event, const String& details);
 
+// Métricas do download OTA atual (válidas dentro do OtaProgressCallback)
+struct OtaStats {
+  uint32_t bytesPerSec;   // média desde o início desta sessão de download
+  uint32_t resumedFrom;   // offset retomado da NVS após reboot (0 = do zero)
+  uint16_t reconnects;    // reconexões com Range dentro da sessão
+  uint32_t flashWaitMs;   // tempo que o leitor HTTP esperou pela gravação
+};
+
 // ======== Inicialização ========
 
 /**
@@ -26,7 +34,11 @@ void otaInit(
 // ======== OTA via HTTP ========
 
 /**
- * Baixa e atualiza firmware a partir de uma URL completa
+ * Baixa e atualiza firmware a partir de uma URL completa.
+ * Uma task lê o HTTP em 2 buffers de 4 KB enquanto outra grava a flash;
+ * quedas são retomadas com Range a partir do último setor gravado (offset
+ * salvo na NVS, sobrevive a reboot) e o SHA-256 é conferido com o header
+ * X-Firmware-SHA256 do servidor antes de trocar a partição de boot.
  * @param url URL do arquivo .bin
  * @return true se sucesso (vai fazer reboot), false se erro
  */
@@ -68,3 +80,8 @@ void otaCancel();
  * Retorna última mensagem de erro
  */
 String otaGetLastError();
+
+/**
+ * Métricas do último/atual download OTA (throughput, retomadas)
+ */
+OtaStats otaGetStats();
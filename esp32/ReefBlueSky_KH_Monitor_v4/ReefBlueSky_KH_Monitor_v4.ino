@@ -13,6 +13,7 @@
 #include <SPIFFS.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
+#include "JsonArena.h"
 #include "TimeProvider.h"
 #include <time.h>
 #include "NTP_DEBUG_HELPERS.h" 
@@ -23,8 +24,7 @@
 #include "SensorManager.h"
 #include "Safety.h" 
 #include "KH_Analyzer.h"
-#include "KH_Predictor.h"
-#include "MeasurementHistory.h"
+#include <ReefBlueSkyCore.h>
 #include "KH_Calibrator.h"
 
 void wifiFactoryReset(); 
@@ -34,6 +34,10 @@ void wifiFactoryReset();
 #include "HardwarePins.h"
 #include "AiPumpControl.h"  
 #include "OtaUpdate.h"
+#include "BinLog.h"
+#include "LiveTelemetry.h"
+#include "TelemetryFrame.h"
+#include "DoserLink.h"
 
 
 #include "FwVersion.h"
@@ -58,6 +62,7 @@ KH_Calibrator  khCalibrator(&pumpControl, &sensorManager);
 
 MeasurementHistory history;
 WebServer webServer(80);
+DoserLink doserLink;   // medições e correções direto para a dosadora (LAN)
 
 bool khCalibRunning = false;
 unsigned long khCalibLastStepMs = 0;
@@ -194,10 +199,30 @@ void onCloudAuthOk() {
   } else {
     Serial.println("[OTA-LOG] Versão já reportada, não enviando novamente.");
   }
+  if (!doserLink.ready()) {
+    setupDoserLink();
+  }
+
   Serial.println("[DBG] onCloudAuthOk() EXIT");
   debugTestStatus(); 
 }
 
+// Dose de alcalinidade executada -> filtro de Kalman do preditor (ignorada
+// enquanto KHPredictor::setKalman não for ligado com o dKH/mL do aquário)
+static void onKhDose(float volumeMl) {
+  khAnalyzer.getPredictor()->addDose(getCurrentEpochMs(), volumeMl);
+}
+
+// Chave LAN do servidor (atualiza o arquivo) ou, sem nuvem, a do arquivo
+void setupDoserLink() {
+  String hexKey;
+  if (deviceToken.length() > 0 && cloudAuth.fetchLanKey(hexKey)) {
+    DoserLink::saveKey(hexKey);
+  }
+  doserLink.begin(deviceId, hexKey, &cloudAuth);
+  doserLink.onDose(onKhDose);
+}
+
 // =================================================================================
 // Configurações de Comunicação
 // =================================================================================
@@ -329,194 +354,9 @@ enum SystemState {
 SystemState systemState = STARTUP;
 
 // =================================================================================
-// Sistema de Logging para Debug de Offline
+// Sistema de Logging para Debug de Offline: ver BinLog.h (LOG_I/LOG_W/...)
 // =================================================================================
 
-#define LOG_BUFFER_SIZE 50        // Máximo de logs na RAM
-#define LOG_FILE_PATH "/debug_log.txt"
-#define LOG_MAX_FILE_SIZE 10240   // 10KB máximo no SPIFFS
-
-struct LogEntry {
-  unsigned long long timestamp;  // [FIX] 64 bits para epoch em ms
-  char level[8];                 // DEBUG, INFO, WARN, ERROR
-  char message[128];             // Mensagem do log
-};
-
-class DebugLogger {
-private:
-  LogEntry buffer[LOG_BUFFER_SIZE];
-  int bufferIndex = 0;
-  int bufferCount = 0;
-  unsigned long lastSyncToServer = 0;
-  const unsigned long SYNC_INTERVAL = 60000; // Enviar logs a cada 60s
-
-public:
-  void log(const char* level, const char* format, ...) {
-    va_list args;
-    va_start(args, format);
-
-    LogEntry& entry = buffer[bufferIndex];
-
-    // [FIX] Usar epoch timestamp se NTP estiver sincronizado
-    unsigned long long epochMs = getCurrentEpochMs();
-    if (epochMs > 0 && epochMs > 1000000000000ULL) {  // Validar que é epoch real (> ano 2001)
-      entry.timestamp = epochMs;
-    } else {
-      // Fallback: millis() se NTP não estiver pronto
-      entry.timestamp = millis();
-    }
-
-    strncpy(entry.level, level, sizeof(entry.level) - 1);
-    vsnprintf(entry.message, sizeof(entry.message), format, args);
-
-    va_end(args);
-
-    // Print to Serial for real-time monitoring
-    Serial.printf("[%s] %llu: %s\n", level, entry.timestamp, entry.message);
-
-    // Update circular buffer
-    bufferIndex = (bufferIndex + 1) % LOG_BUFFER_SIZE;
-    if (bufferCount < LOG_BUFFER_SIZE) bufferCount++;
-
-    // Auto-save to SPIFFS on ERROR
-    if (strcmp(level, "ERROR") == 0) {
-      saveToSPIFFS();
-    }
-  }
-
-  void saveToSPIFFS() {
-    if (!SPIFFS.begin(true)) return;
-
-    // Open file in append mode
-    File f = SPIFFS.open(LOG_FILE_PATH, FILE_APPEND);
-    if (!f) {
-      Serial.println("[Logger] Falha ao abrir arquivo de log");
-      return;
-    }
-
-    // Check file size and rotate if needed
-    if (f.size() > LOG_MAX_FILE_SIZE) {
-      f.close();
-      SPIFFS.remove(LOG_FILE_PATH);
-      f = SPIFFS.open(LOG_FILE_PATH, FILE_WRITE);
-    }
-
-    // Write buffer to file
-    for (int i = 0; i < bufferCount; i++) {
-      int idx = (bufferIndex - bufferCount + i + LOG_BUFFER_SIZE) % LOG_BUFFER_SIZE;
-      LogEntry& entry = buffer[idx];
-      f.printf("[%s] %llu: %s\n", entry.level, entry.timestamp, entry.message);  // [FIX] %llu
-    }
-
-    f.close();
-    Serial.printf("[Logger] %d logs salvos no SPIFFS\n", bufferCount);
-  }
-
-  String getLogsAsString() {
-    String result = "";
-    for (int i = 0; i < bufferCount; i++) {
-      int idx = (bufferIndex - bufferCount + i + LOG_BUFFER_SIZE) % LOG_BUFFER_SIZE;
-      LogEntry& entry = buffer[idx];
-      result += "[" + String(entry.level) + "] " + String(entry.timestamp) + ": " + String(entry.message) + "\n";
-    }
-    return result;
-  }
-
-  void syncToServer() {
-    if (WiFi.status() != WL_CONNECTED || deviceToken.length() == 0) return;
-    if (millis() - lastSyncToServer < SYNC_INTERVAL) return;
-    if (bufferCount == 0) return;
-
-    String logs = getLogsAsString();
-    if (sendLogsToCloud(logs)) {
-      Serial.println("[Logger] Logs enviados ao servidor com sucesso");
-      lastSyncToServer = millis();
-      bufferCount = 0; // Clear buffer after successful send
-      bufferIndex = 0;
-    }
-  }
-
-  void loadFromSPIFFS() {
-    if (!SPIFFS.begin(true)) return;
-    if (!SPIFFS.exists(LOG_FILE_PATH)) return;
-
-    File f = SPIFFS.open(LOG_FILE_PATH, FILE_READ);
-    if (!f) return;
-
-    Serial.println("[Logger] Logs salvos no SPIFFS:");
-    while (f.available()) {
-      String line = f.readStringUntil('\n');
-      Serial.println(line);
-    }
-    f.close();
-  }
-
-  bool sendLogsToCloud(const String& logs) {
-    WiFiClient client;
-    HTTPClient http;
-    String url = "http://iot.reefbluesky.com.br/api/v1/device/logs";
-
-    if (!http.begin(client, url)) return false;
-
-    http.addHeader("Content-Type", "application/json");
-    http.addHeader("Authorization", "Bearer " + deviceToken);
-
-    DynamicJsonDocument doc(2048);
-    doc["deviceId"] = deviceId;
-    doc["logs"] = logs;
-    doc["timestamp"] = millis();
-
-    String payload;
-    serializeJson(doc, payload);
-
-    int code = http.POST(payload);
-    http.end();
-
-    return (code == 200 || code == 201);
-  }
-
-  // [NOVO] Enviar logs como alerta por email/Telegram após boot
-  void sendLogsAsAlert() {
-    if (!SPIFFS.begin(true)) return;
-    if (!SPIFFS.exists(LOG_FILE_PATH)) return;
-
-    File f = SPIFFS.open(LOG_FILE_PATH, FILE_READ);
-    if (!f) return;
-
-    // Ler últimas 10 linhas do log (ou todas se forem menos)
-    String logContent = "";
-    int lineCount = 0;
-    const int MAX_LINES = 10;
-
-    // Ler todas as linhas primeiro
-    String allLines[50]; // Buffer temporário
-    int totalLines = 0;
-    while (f.available() && totalLines < 50) {
-      allLines[totalLines++] = f.readStringUntil('\n');
-    }
-    f.close();
-
-    // Pegar as últimas MAX_LINES
-    int startIdx = (totalLines > MAX_LINES) ? (totalLines - MAX_LINES) : 0;
-    for (int i = startIdx; i < totalLines; i++) {
-      logContent += allLines[i] + "\n";
-    }
-
-    if (logContent.length() > 0) {
-      // Truncar se muito grande (limite de 1000 chars para alertas)
-      if (logContent.length() > 1000) {
-        logContent = logContent.substring(logContent.length() - 1000);
-      }
-
-      String alertMsg = "🔄 BOOT DETECTED - Últimos logs:\n\n" + logContent;
-      sendAlert("Device Boot", alertMsg, "medium");
-      Serial.println("[Logger] Logs enviados por email/Telegram após boot");
-    }
-  }
-};
-
-DebugLogger debugLog;
-
 // Watchdog de WiFi e Cloud
 unsigned long lastWifiOkMs      = 0;
 unsigned long firstNoTokenTime  = 0;
@@ -530,6 +370,7 @@ unsigned long measurementInterval = 3600000;  // 1 hora em ms
 unsigned long lastResetButtonCheck = 0;
 const unsigned long HEALTH_INTERVAL_MS = 2UL * 1000UL; // 2 segundos (atualização rápida dos sensores de nível)
 unsigned long lastHealthSent = 0;
+unsigned long lastTelemetryFrame = 0;
 
 bool resetButtonPressed = false;
 
@@ -549,7 +390,7 @@ void tryNtpOnceNonBlocking() {
   if (!ntpInitialized) {
     configTime(gmtOffset_sec, daylightOffset_sec, ntpServer);
     Serial.printf("[NTP] configTime chamado, servidor=%s\n", ntpServer);
-    debugLog.log("INFO", "NTP init: server=%s", ntpServer);
+    LOG_I("NTP init: server=%s", ntpServer);
     ntpInitialized = true;
     ntpLastAttempt = millis();
     return;
@@ -562,16 +403,16 @@ void tryNtpOnceNonBlocking() {
   if (getLocalTime(&timeinfo)) {
     ntpSynced = true;
     Serial.println("[NTP] NTP sincronizado com sucesso.");
-    debugLog.log("INFO", "NTP sync OK: %04d-%02d-%02d %02d:%02d:%02d",
-                 timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
-                 timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+    LOG_I("NTP sync OK: %04d-%02d-%02d %02d:%02d:%02d",
+          timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
+          timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
   } else {
     static int retries = 0;
     retries++;
     Serial.println("[NTP] Aguardando sincronizar...");
     if (retries >= 15) {
       Serial.println("[NTP] Falha ao sincronizar (timeout), seguindo sem NTP.");
-      debugLog.log("WARN", "NTP sync FAILED after 15 retries");
+      LOG_W("NTP sync FAILED after 15 retries");
       ntpSynced = false; // segue vida, tenta de novo mais tarde se quiser
     }
   }
@@ -679,12 +520,12 @@ void handleCloudReconnect(unsigned long now) {
 
   Serial.printf("[Cloud] Tentando (re)autenticar (tentativa #%d, delay atual: %lu ms)...\n",
                 reconnectFailureCount + 1, reconnectDelayMs);
-  debugLog.log("INFO", "Cloud auth attempt #%d, delay=%lu ms",
-               reconnectFailureCount + 1, reconnectDelayMs);
+  LOG_I("Cloud auth attempt #%d, delay=%lu ms",
+        reconnectFailureCount + 1, reconnectDelayMs);
 
   if (cloudAuth.init()) {
     Serial.println("[Cloud] Device autenticado, token disponível.");
-    debugLog.log("INFO", "Cloud auth SUCCESS, token acquired");
+    LOG_I("Cloud auth SUCCESS, token acquired");
     cloudConnected = true;
     firstNoTokenTime = 0;
     reconnectDelayMs = RECONNECT_MIN_DELAY_MS;
@@ -692,7 +533,7 @@ void handleCloudReconnect(unsigned long now) {
     onCloudAuthOk();
   } else {
     Serial.println("[Cloud] Ainda sem token válido (aguardando registro ou erro).");
-    debugLog.log("WARN", "Cloud auth FAILED, attempt #%d", reconnectFailureCount + 1);
+    LOG_W("Cloud auth FAILED, attempt #%d", reconnectFailureCount + 1);
     cloudConnected = false;
     reconnectFailureCount++;
 
@@ -719,8 +560,8 @@ void handleCloudReconnect(unsigned long now) {
 
       if (elapsedNoToken > MAX_NO_TOKEN_GRACEFUL_MS) {
         Serial.println("[Cloud][WDT] Tempo máximo sem token excedido. Reiniciando device...");
-        debugLog.log("ERROR", "Cloud WDT timeout! No token for %lu s, RESTART!",
-                     elapsedNoToken / 1000);
+        LOG_E("Cloud WDT timeout! No token for %lu s, RESTART!",
+              elapsedNoToken / 1000);
         debugLog.saveToSPIFFS();
         delay(2000);
         ESP.restart();
@@ -756,7 +597,7 @@ void checkScheduledTest() {
 
     if (shouldTestNow) {
       Serial.println("[TestSchedule] ⏰ Hora do teste agendado! Iniciando medição...");
-      debugLog.log("INFO", "Teste agendado iniciando (interval=%dh)", intervalHours);
+      LOG_I("Teste agendado iniciando (interval=%dh)", intervalHours);
 
       // Marcar teste agendado em andamento
       isScheduledTestRunning = true;
@@ -764,7 +605,7 @@ void checkScheduledTest() {
 
       // Iniciar medição não-bloqueante — resultado processado na seção 10 do loop
       Serial.println("[TestSchedule] Iniciando medição não-bloqueante...");
-      debugLog.log("INFO", "Teste agendado iniciando (interval=%dh)", intervalHours);
+      LOG_I("Teste agendado iniciando (interval=%dh)", intervalHours);
       performMeasurement();
       systemState = MEASURING;
 
@@ -802,9 +643,12 @@ void setup() {
 
   Serial.printf("[FW] DeviceType=%s, FWVERSION=%s\n", FW_DEVICE_TYPE, FW_VERSION);
 
+  // Segmentos de log no SPIFFS + o que o anel em RTC trouxe de um panic/WDT
+  debugLog.begin();
+
   // [LOG] Boot info
-  debugLog.log("INFO", "BOOT: FW=%s, Heap=%d, ResetReason=%d",
-               FW_VERSION, ESP.getFreeHeap(), esp_reset_reason());
+  LOG_I("BOOT: FW=%s, Heap=%d, ResetReason=%d",
+        FW_VERSION, ESP.getFreeHeap(), esp_reset_reason());
 
   // Carregar logs salvos do boot anterior (exibe no Serial)
   debugLog.loadFromSPIFFS();
@@ -819,13 +663,13 @@ void setup() {
 
   // 2️⃣ WIFI PRIMEIRO (CRÍTICO!)
   Serial.println("[Main] Iniciando WiFiSetup...");
-  debugLog.log("INFO", "Iniciando WiFiSetup");
+  LOG_I("Iniciando WiFiSetup");
   bool wifiOk = wifiSetup.begin();
 
   if (wifiOk && WiFi.isConnected()) {  // ← + WiFi.isConnected()!
     Serial.println("[Main] WiFi STA conectado!");
-    debugLog.log("INFO", "WiFi conectado, SSID=%s, RSSI=%d, IP=%s",
-                 WiFi.SSID().c_str(), WiFi.RSSI(), WiFi.localIP().toString().c_str());
+    LOG_I("WiFi conectado, SSID=%s, RSSI=%d, IP=%s",
+          WiFi.SSID().c_str(), WiFi.RSSI(), WiFi.localIP().toString().c_str());
     lastWifiOkMs = millis();
 
     // Auth só com STA
@@ -842,13 +686,13 @@ void setup() {
 
     // [NOVO] Buscar config do backend (testMode e intervalHours)
     Serial.println("[Config] Tentando buscar config do backend...");
-    debugLog.log("INFO", "Setup: Fetching config from backend");
+    LOG_I("Setup: Fetching config from backend");
     bool backendOk = fetchConfigFromBackend();
     if (backendOk) {
       fetchIntervalFromBackendStatus();  // Buscar intervalHours do /status
     } else {
       Serial.println("[Config] Falha ao buscar do backend, carregando do SPIFFS...");
-      debugLog.log("WARN", "Setup: Backend fetch failed, loading from SPIFFS");
+      LOG_W("Setup: Backend fetch failed, loading from SPIFFS");
       loadConfigFromSPIFFS();
     }
 
@@ -857,6 +701,7 @@ void setup() {
     debugLog.sendLogsAsAlert();
 
     setupWebServer();
+    setupDoserLink();
   } else {
     Serial.println("[Main] AP mode ativo. Configure WiFi em 192.168.4.1");
     // [IMPORTANTE] Sem WiFi, não carrega config - testMode fica false (não roda automático)
@@ -868,6 +713,7 @@ void setup() {
   sensorManager.begin();
   khAnalyzer.begin();                       // ← 1x SÓ!
   history.begin();
+  cloudAuth.setRollups(&history.rollups());
   loadPump4CalibrationFromSPIFFS();
   pinMode(COMPRESSOR_PIN, OUTPUT);
   digitalWrite(COMPRESSOR_PIN, LOW);
@@ -881,6 +727,9 @@ void setup() {
 
   setupWebServer();
 
+  // Stream local de pH/temperatura/níveis (ws://<ip>:81/)
+  liveTelemetryBegin(fillTelemetrySample);
+
   // 6️⃣ Task WiFiReset (OK)
   xTaskCreate(wifiResetButtonTask, "wifi_reset_btn", 4096, nullptr, 5, nullptr);
 
@@ -914,6 +763,7 @@ static bool lastWifiConnected = false;
 void loop() {
   unsigned long now = millis();
   tryNtpOnceNonBlocking();
+  debugLog.loop();
 
   bool nowConnected = (WiFi.status() == WL_CONNECTED);
   IPAddress staIp = WiFi.localIP();
@@ -921,8 +771,8 @@ void loop() {
   if (nowConnected && !lastWifiConnected) {
     Serial.printf("[Main] WiFi reconectado (auto). STA IP=%s\n",
                   staIp.toString().c_str());
-    debugLog.log("INFO", "WiFi reconectado: IP=%s, RSSI=%d",
-                 staIp.toString().c_str(), WiFi.RSSI());
+    LOG_I("WiFi reconectado: IP=%s, RSSI=%d",
+          staIp.toString().c_str(), WiFi.RSSI());
 
     // Só fecha portal se o IP NÃO for 0.0.0.0 e NÃO for 192.168.4.1
     if (staIp != IPAddress(0,0,0,0) && staIp != IPAddress(192,168,4,1)) {
@@ -935,8 +785,8 @@ void loop() {
 
   // [LOG] Detectar desconexão WiFi
   if (!nowConnected && lastWifiConnected) {
-    debugLog.log("WARN", "WiFi desconectado! Uptime=%lu, Heap=%d",
-                 now, ESP.getFreeHeap());
+    LOG_W("WiFi desconectado! Uptime=%lu, Heap=%d",
+          now, ESP.getFreeHeap());
     debugLog.saveToSPIFFS(); // Salvar imediatamente
   }
 
@@ -948,7 +798,7 @@ void loop() {
   } else {
     if (lastWifiOkMs > 0 && (now - lastWifiOkMs) > MAX_WIFI_DOWN_MS) {
       Serial.println("[WDT] WiFi OFF por muito tempo, reiniciando device...");
-      debugLog.log("ERROR", "WiFi OFF > %lu ms, RESTART!", MAX_WIFI_DOWN_MS);
+      LOG_E("WiFi OFF > %lu ms, RESTART!", MAX_WIFI_DOWN_MS);
       debugLog.saveToSPIFFS();
       delay(2000);
       ESP.restart();
@@ -1033,11 +883,14 @@ if (now - lastLevelDebug > 1000) { // 1 s, ajuste se quiser
     lastSyncTry = now;
     int queueSize = cloudAuth.getQueueSize();
     if (queueSize > 0) {
-      debugLog.log("DEBUG", "Syncing %d measurements to cloud", queueSize);
+      LOG_D("Syncing %d measurements to cloud", queueSize);
     }
     cloudAuth.syncOfflineMeasurements();
   }
 
+  // 🔥 2.4 LAN com a dosadora (ACKs, retransmissões, fallback para a nuvem)
+  doserLink.loop();
+
   // 🔥 2.5 TEST SCHEDULE - Polling de teste agendado
   if (now - lastTestScheduleCheck >= TEST_SCHEDULE_CHECK_MS) {
     lastTestScheduleCheck = now;
@@ -1079,7 +932,7 @@ if (now - lastLevelDebug > 1000) { // 1 s, ajuste se quiser
     case IDLE:
       if (forceImmediateMeasurement) {
         forceImmediateMeasurement = false;
-        debugLog.log("INFO", "Manual measurement triggered");
+        LOG_I("Manual measurement triggered");
         systemState = MEASURING;
       }
       break;
@@ -1139,14 +992,20 @@ if (now - lastLevelDebug > 1000) { // 1 s, ajuste se quiser
       break;
   }
 
-  // 🔥 6. DEBUG & HEALTH & LOG SYNC
+  // 🔥 6. TELEMETRIA: health + progresso + logs num frame só (TelemetryFrame.h)
   if (now - lastHealthSent >= HEALTH_INTERVAL_MS) {
-    sendHealthToCloud();
+    if (telemetryFrame.legacy()) {
+      sendHealthToCloud();
+    } else {
+      updateHealthSnapshot();
+    }
     lastHealthSent = now;
   }
 
-  // Periodic log sync (independent of health)
-  debugLog.syncToServer();
+  if (now - lastTelemetryFrame >= TELEMETRY_FRAME_MS) {
+    lastTelemetryFrame = now;
+    sendTelemetryFrame();
+  }
 
   static unsigned long lastDebug = 0;
   if (now - lastDebug > 6000) {
@@ -1179,7 +1038,7 @@ if (now - lastLevelDebug > 1000) { // 1 s, ajuste se quiser
     // [LOG] Memory check - warn if low
     size_t freeHeap = ESP.getFreeHeap();
     if (freeHeap < 50000) {  // Alerta se menos de 50KB livre
-      debugLog.log("WARN", "LOW HEAP! Free=%d bytes", freeHeap);
+      LOG_W("LOW HEAP! Free=%d bytes", freeHeap);
     }
 
     lastDiag = now;
@@ -1247,7 +1106,7 @@ if (now - lastLevelDebug > 1000) { // 1 s, ajuste se quiser
         KH_Calibrator::Result res = khCalibrator.getResult();
         if (khCalibrator.hasError()) {
           Serial.printf("[KH_Calib] ERRO: %s\n", res.error.c_str());
-          debugLog.log("ERROR", "KH Calibration FAILED: %s", res.error.c_str());
+          LOG_E("KH Calibration FAILED: %s", res.error.c_str());
           sendAlert("Falha na Calibracao", res.error, "high");
           sendKhProgressToCloud(false, "calibration", "ERRO: " + res.error,
                                 -1, 0,
@@ -1284,7 +1143,7 @@ if (now - lastLevelDebug > 1000) { // 1 s, ajuste se quiser
         if (khAnalyzer.hasError()) {
           String errMsg = khAnalyzer.getErrorMessage();
           Serial.printf("[KH_Measure] ERRO: %s\n", errMsg.c_str());
-          debugLog.log("ERROR", "KH Measurement FAILED: %s", errMsg.c_str());
+          LOG_E("KH Measurement FAILED: %s", errMsg.c_str());
           sendAlert("Falha na Medicao de KH", errMsg, "high");
           sendKhProgressToCloud(false, "measurement", "ERRO: " + errMsg,
                                 -1, 0,
@@ -1315,13 +1174,13 @@ if (now - lastLevelDebug > 1000) { // 1 s, ajuste se quiser
             if (lastScheduledTestResult.kh > 0) {
               Serial.printf("[TestSchedule] ✓ Teste concluído: KH=%.2f\n",
                             lastScheduledTestResult.kh);
-              debugLog.log("INFO", "Teste agendado concluído: KH=%.2f",
-                           lastScheduledTestResult.kh);
+              LOG_I("Teste agendado concluído: KH=%.2f",
+                    lastScheduledTestResult.kh);
               cloudAuth.reportTestResult(true, "", &lastScheduledTestResult);
             } else {
               Serial.println("[TestSchedule] ✗ Teste falhou (sem dados de KH)");
               cloudAuth.reportTestResult(false, "Measurement failed - no KH data");
-              debugLog.log("ERROR", "Teste agendado falhou");
+              LOG_E("Teste agendado falhou");
             }
             isScheduledTestRunning = false;
           }
@@ -1412,7 +1271,7 @@ void factoryReset() {
   Serial.println("\n[RESET] ===================================");
   Serial.println("[RESET] Iniciando RESET DE FÁBRICA");
   Serial.println("[RESET] ===================================\n");
-  debugLog.log("WARN", "FACTORY RESET initiated!");
+  LOG_W("FACTORY RESET initiated!");
   debugLog.saveToSPIFFS();
 
   // Parar qualquer ciclo em andamento
@@ -1441,7 +1300,7 @@ void wifiFactoryReset() {
   Serial.println("\n[WiFiReset] ===================================");
   Serial.println("[WiFiReset] Reset de Wi‑Fi + Credenciais Cloud");
   Serial.println("[WiFiReset] ===================================\n");
-  debugLog.log("WARN", "WIFI FACTORY RESET - clearing credentials");
+  LOG_W("WIFI FACTORY RESET - clearing credentials");
   debugLog.saveToSPIFFS();
 
   // 1) Limpa NVS 'wifi' (já existe na task)
@@ -1602,10 +1461,52 @@ void handleStatus() {
           String(khAnalyzer.isReferenceKHConfigured() ? "true" : "false") + ",";
   json += "\"kh_reference\":" + String(khAnalyzer.getReferenceKH(), 2) + ",";
   json += "\"measurements\":" + String(history.getCount());
+
+  // Últimas 24 h direto dos rollups (custo fixo, sem varrer o histórico)
+  KHRollups::Bucket day = history.getLast24h();
+  if (day.count > 0) {
+    json += ",\"kh_24h\":{";
+    json += "\"n\":" + String(day.count) + ",";
+    json += "\"mean\":" + String(day.mean, 2) + ",";
+    json += "\"min\":" + String(day.min, 2) + ",";
+    json += "\"max\":" + String(day.max, 2) + ",";
+    json += "\"std\":" + String(day.stdDev(), 3) + ",";
+    json += "\"last\":" + String(day.last, 2);
+    json += "}";
+  }
   json += "}";
   webServer.send(200, "application/json", json);
 }
 
+// Print -> corpo chunked do WebServer (cada write vira um sendContent)
+class WebServerChunkPrint : public Print {
+public:
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t len) override {
+    webServer.sendContent((const char*)buf, len);
+    return len;
+  }
+};
+
+// GET /history?format=json|csv&from=<ms>&to=<ms>  (período [from, to), padrão tudo)
+// O histórico vai em blocos direto para o cliente, sem montar String
+void handleHistory() {
+  bool csv = webServer.arg("format") == "csv";
+  uint64_t from = 0, to = UINT64_MAX;
+  if (webServer.hasArg("from")) from = strtoull(webServer.arg("from").c_str(), nullptr, 10);
+  if (webServer.hasArg("to"))   to   = strtoull(webServer.arg("to").c_str(), nullptr, 10);
+
+  webServer.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  webServer.send(200, csv ? "text/csv" : "application/json", "");
+  WebServerChunkPrint out;
+  if (csv) {
+    history.writeCSV(out, from, to);
+  } else {
+    history.writeJSON(out, from, to);
+  }
+  webServer.sendContent("");   // fim do chunked
+}
+
 void handleLcdState() {
   String json = "{";
   json += "\"device_id\":\"" + String(deviceId) + "\",";
@@ -1654,7 +1555,7 @@ void handleFillA() {
 
   int duration = 10000;  // padrão 10s
   if (webServer.hasArg("plain")) {
-    DynamicJsonDocument doc(128);
+    JsonDoc doc(128);
     deserializeJson(doc, webServer.arg("plain"));
     duration = doc["duration"] | 10000;
   }
@@ -1693,7 +1594,7 @@ void handleFillB() {
 
   int duration = 10000;  // padrão 10s
   if (webServer.hasArg("plain")) {
-    DynamicJsonDocument doc(128);
+    JsonDoc doc(128);
     deserializeJson(doc, webServer.arg("plain"));
     duration = doc["duration"] | 10000;
   }
@@ -1732,7 +1633,7 @@ void handleFillC() {
 
   int duration = 10000;  // padrão 10s
   if (webServer.hasArg("plain")) {
-    DynamicJsonDocument doc(128);
+    JsonDoc doc(128);
     deserializeJson(doc, webServer.arg("plain"));
     duration = doc["duration"] | 10000;
   }
@@ -1780,6 +1681,19 @@ void handleFlushAll() {
 }
 
 
+// [TELEMETRIA] Amostra para o stream local. Roda na task de amostragem
+// (LiveTelemetry), não no loop: só leituras rápidas, sem delay e sem Serial.
+void fillTelemetrySample(TelemetrySample& s) {
+  uint16_t adc = analogRead(PH_PIN);
+  s.ph_adc     = adc;
+  s.ph_milli   = (int16_t)(sensorManager.phFromAdc(adc) * 1000.0f);
+  s.temp_centi = (int16_t)(sensorManager.getLastTemperature() * 100.0f);
+  s.levels     = (digitalRead(LEVEL_A_PIN) == LOW ? 0x01 : 0) |
+                 (digitalRead(LEVEL_B_PIN) == LOW ? 0x02 : 0) |
+                 (digitalRead(LEVEL_C_PIN) == LOW ? 0x04 : 0);
+  s.state      = (uint8_t)systemState;
+}
+
 void setupWebServer() {
   webServer.on("/factory_reset", HTTP_POST, handleFactoryReset);
   webServer.on("/reset_kh",     HTTP_POST, handleResetKH);
@@ -1787,6 +1701,7 @@ void setupWebServer() {
   webServer.on("/test_now",     HTTP_POST, handleTestNow);
   webServer.on("/status",       HTTP_GET,  handleStatus);
   webServer.on("/lcd_state",    HTTP_GET,  handleLcdState);
+  webServer.on("/history",      HTTP_GET,  handleHistory);
 
   // [NOVO] Endpoints para teste de enchimento de câmaras
   webServer.on("/fill_a",       HTTP_POST, handleFillA);
@@ -1805,26 +1720,14 @@ void setupWebServer() {
 // =================================================================================
 
 
-// Usa CloudAuth::sendHealthMetrics
-void sendHealthToCloud() {
-  if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[Health] WiFi não conectado, pulando envio.");
-    return;
-  }
-  if (deviceToken.length() == 0) {
-    Serial.println("[Health] Sem deviceToken, pulando envio.");
-    return;
-  }
-
+// Coleta as métricas de saúde + sensores
+static SystemHealth collectHealth() {
   float heapPercent = getHeapUsagePercent();
   float spiffsPercent = getSpiffsUsagePercent();
   int rssi = WiFi.RSSI();
   int wifiPercent = rssiToPercent(rssi); 
   unsigned long uptime = millis() / 1000;
 
-  Serial.printf("[Health] Métricas coletadas: CPU=0.0%% MEM=%.2f%% SPIFFS=%.2f%% WiFi=%d%% RSSI=%d dBm UPTIME=%lu s\n",
-                heapPercent, spiffsPercent, wifiPercent, rssi, uptime);
-
   SystemHealth h;
   h.cpu_usage            = 0.0f;
   h.memory_usage         = heapPercent;
@@ -1833,58 +1736,82 @@ void sendHealthToCloud() {
   h.uptime               = uptime;
 
   // [FIX] Coletar dados dos sensores e adicionar ao health
-  int lvlA = sensorManager.getLevelA();
-  int lvlB = sensorManager.getLevelB();
-  int lvlC = sensorManager.getLevelC();
-  float temp = sensorManager.getTemperature();  // Ler temperatura ativa
-  float ph = sensorManager.getPH();             // Ler pH ativo
-
-  h.level_a     = lvlA;
-  h.level_b     = lvlB;
-  h.level_c     = lvlC;
-  h.temperature = temp;
-  h.ph          = ph;
-
-  Serial.printf("[Health] Sensores: LevelA=%d LevelB=%d LevelC=%d Temp=%.1f pH=%.2f\n",
-                lvlA, lvlB, lvlC, temp, ph);
-
-  if (!cloudAuth.sendHealthMetrics(h)) {
-    Serial.println("[Health] Falha ao enviar métricas via CloudAuth.");
-    debugLog.log("ERROR", "Health send FAILED! WiFi=%d%%, Heap=%d",
-                 wifiPercent, ESP.getFreeHeap());
-  } else {
-    Serial.println("[Health] Métricas enviadas com sucesso.");
-    debugLog.log("DEBUG", "Health OK: Heap=%.1f%%, WiFi=%d%%, RSSI=%d",
-                 heapPercent, wifiPercent, rssi);
-  }
+  h.level_a     = sensorManager.getLevelA();
+  h.level_b     = sensorManager.getLevelB();
+  h.level_c     = sensorManager.getLevelC();
+  h.temperature = sensorManager.getTemperature();  // Ler temperatura ativa
+  h.ph          = sensorManager.getPH();           // Ler pH ativo
+
+  // Fragmentação: maior bloco livre x livre total; arena JSON
+  JsonArenaStats js = jsonArenaStats();
+  h.heap_free            = ESP.getFreeHeap();
+  h.heap_min_free        = ESP.getMinFreeHeap();
+  h.heap_largest_block   = ESP.getMaxAllocHeap();
+  h.json_arena_peak      = js.peak;
+  h.json_arena_fallbacks = js.fallbacks;
+  return h;
+}
 
-  // [NOVO] Sincronizar logs com servidor após health
-  debugLog.syncToServer();
+// Atualiza o health do próximo frame de telemetria (o envio é do loop)
+void updateHealthSnapshot() {
+  telemetryFrame.setHealth(collectHealth());
 }
 
-void sendFirmwareVersionToCloud() {
+// Envia o frame de telemetria pendente; servidor antigo: só os logs (o
+// health e o progresso já saem pelos envios separados)
+void sendTelemetryFrame() {
   if (WiFi.status() != WL_CONNECTED || deviceToken.length() == 0) return;
 
-  WiFiClient client;
-  HTTPClient http;
-  String url = String(CLOUD_BASE_URL) + "/device/firmware";
+  if (telemetryFrame.legacy()) {
+    debugLog.syncToServer();
+    return;
+  }
+  if (!telemetryFrame.send(cloudAuth, debugLog)) {
+    LOG_D("Telemetry frame FAILED, heap=%u", ESP.getFreeHeap());
+  }
+}
 
-  Serial.printf("[FW] Reportando versao %s para %s\n", FW_VERSION, url.c_str());
+// Envia o health agora (boot/autenticação): keyframe do frame de
+// telemetria, ou CloudAuth::sendHealthMetrics em servidor antigo
+void sendHealthToCloud() {
+  if (WiFi.status() != WL_CONNECTED) {
+    Serial.println("[Health] WiFi não conectado, pulando envio.");
+    return;
+  }
+  if (deviceToken.length() == 0) {
+    Serial.println("[Health] Sem deviceToken, pulando envio.");
+    return;
+  }
 
-  http.begin(client, url);
-  http.addHeader("Content-Type", "application/json");
-  http.addHeader("Authorization", "Bearer " + deviceToken);
+  SystemHealth h = collectHealth();
 
-  StaticJsonDocument<128> doc;
-  doc["firmwareVersion"] = FW_VERSION;
+  Serial.printf("[Health] Métricas coletadas: CPU=0.0%% MEM=%.2f%% SPIFFS=%.2f%% WiFi=%d%% UPTIME=%lu s\n",
+                h.memory_usage, h.spiffs_usage, h.wifi_signal_strength, h.uptime);
+  Serial.printf("[Health] Sensores: LevelA=%d LevelB=%d LevelC=%d Temp=%.1f pH=%.2f\n",
+                h.level_a, h.level_b, h.level_c, h.temperature, h.ph);
+  Serial.printf("[Health] Heap: livre=%u min=%u maiorBloco=%u | JSON arena pico=%u/%u fallbacks=%u\n",
+                (unsigned)h.heap_free, (unsigned)h.heap_min_free, (unsigned)h.heap_largest_block,
+                (unsigned)h.json_arena_peak, (unsigned)JSON_ARENA_SIZE, (unsigned)h.json_arena_fallbacks);
 
-  String body;
-  serializeJson(doc, body);
+  if (!telemetryFrame.legacy()) {
+    telemetryFrame.setHealth(h);
+    telemetryFrame.requestKeyframe();
+    sendTelemetryFrame();
+    if (!telemetryFrame.legacy()) return;
+  }
 
-  int code = http.POST(body);
-  http.end();
+  if (!cloudAuth.sendHealthMetrics(h)) {
+    Serial.println("[Health] Falha ao enviar métricas via CloudAuth.");
+    LOG_E("Health send FAILED! WiFi=%d%%, Heap=%d",
+          h.wifi_signal_strength, ESP.getFreeHeap());
+  } else {
+    Serial.println("[Health] Métricas enviadas com sucesso.");
+    LOG_D("Health OK: Heap=%.1f%%, WiFi=%d%%",
+          h.memory_usage, h.wifi_signal_strength);
+  }
 
-  Serial.printf("[FW] POST /device/firmware code=%d\n", code);
+  // [NOVO] Sincronizar logs com servidor após health
+  debugLog.syncToServer();
 }
 
 // =================================================================================
@@ -1957,16 +1884,8 @@ void performPrediction() {
   }*/
 }
 
-void processCloudCommand() {
-  if (WiFi.status() != WL_CONNECTED) return;
-  if (deviceToken.length() == 0) return;
-
-  Command cmd;
-  // nada aqui ainda, só pra garantir
-  if (!cloudAuth.pullCommandFromServer(cmd)) {
-    return; // sem comando ou erro
-  }
-
+// Executa um comando da nuvem; false + errorMsg em caso de falha
+static bool executeCloudCommand(Command& cmd, String& errorMsg) {
   // DEBUG extra
   Serial.printf("[CMD] action='%s'\n", cmd.action.c_str());
   if (!cmd.params.isNull()) {
@@ -1979,14 +1898,13 @@ void processCloudCommand() {
 
   Serial.printf("[CMD] Recebido comando %s (id=%s)\n",
                 cmd.action.c_str(), cmd.command_id.c_str());
-  debugLog.log("INFO", "CMD received: action=%s, id=%s",
-               cmd.action.c_str(), cmd.command_id.c_str());
+  LOG_I("CMD received: action=%s, id=%s",
+        cmd.action.c_str(), cmd.command_id.c_str());
 
   bool ok = true;
-  String errorMsg = "";
 
   if (cmd.action == "restart") {
-    debugLog.log("WARN", "CMD restart - device restarting NOW!");
+    LOG_W("CMD restart - device restarting NOW!");
     debugLog.saveToSPIFFS();
     delay(500);
     ESP.restart();
@@ -1999,15 +1917,15 @@ void processCloudCommand() {
 
   } else if (cmd.action == "ota_update") {
     Serial.println("[CMD] ota_update recebido, iniciando OTA...");
-    debugLog.log("WARN", "OTA update START");
+    LOG_W("OTA update START");
     debugLog.saveToSPIFFS();  // Save before OTA attempt
     otaSetCommandId(cmd.command_id.toInt());  // habilita reporte de progresso
     ok = otaUpdateKh();
     if (!ok) {
       errorMsg = "OTA failed";
-      debugLog.log("ERROR", "OTA update FAILED");
+      LOG_E("OTA update FAILED");
     } else {
-      debugLog.log("INFO", "OTA update SUCCESS - device will restart");
+      LOG_I("OTA update SUCCESS - device will restart");
       debugLog.saveToSPIFFS();
     }
 
@@ -2124,9 +2042,19 @@ void processCloudCommand() {
       errorMsg = "missing payload";
     } else {
       float volume = cmd.params["volume"] | 0.0f;  // mL desejados
+      bool viaDoser = cmd.params["doser"] | false;
       if (volume <= 0) {
         ok = false;
         errorMsg = "invalid volume";
+      } else if (viaDoser) {
+        // Bomba da dosadora: LAN direto, nuvem se ela não confirmar
+        uint8_t pumpIndex = cmd.params["pump_index"] | 0;
+        Serial.printf("[CMD] khcorrection: volume=%.2f mL -> dosadora, bomba %u\n",
+                      volume, pumpIndex);
+        if (!doserLink.requestCorrection(pumpIndex, volume)) {
+          ok = false;
+          errorMsg = "correction already pending";
+        }
       } else {
         float secondsF = volume / pump4MlPerSec;
         int seconds = (int)roundf(secondsF);
@@ -2149,6 +2077,7 @@ void processCloudCommand() {
             delay(10);
           }
           pumpControl.pumpA_stop();
+          onKhDose(seconds * pump4MlPerSec);
         }
       }
     }
@@ -2220,8 +2149,8 @@ void processCloudCommand() {
           unsigned long ms = (unsigned long)minutes * 60UL * 1000UL;
           measurementInterval = ms;
           Serial.printf("[CMD] setintervalminutes: %d min (interval=%lu ms)\n", minutes, ms);
-          debugLog.log("INFO", "Interval changed: %d minutes (%lu hours)",
-                       minutes, minutes / 60);
+          LOG_I("Interval changed: %d minutes (%lu hours)",
+                minutes, minutes / 60);
           saveConfigToSPIFFS();  // [NOVO] Salvar no SPIFFS para persistir após reboot
         }
       }
@@ -2333,7 +2262,7 @@ void processCloudCommand() {
       if (SPIFFS.begin(true) && SPIFFS.exists("/kh_calib.json")) {
         File f = SPIFFS.open("/kh_calib.json", "r");
         if (f) {
-          DynamicJsonDocument doc(768);
+          JsonDoc doc(768);
           DeserializationError error = deserializeJson(doc, f);
           f.close();
 
@@ -2384,14 +2313,44 @@ void processCloudCommand() {
   }
 
 
-  String statusStr = ok ? "done" : "error";
-  cloudAuth.confirmCommandExecution(cmd.command_id, statusStr, errorMsg);
-
   // [LOG] Log command completion
   if (ok) {
-    debugLog.log("DEBUG", "CMD %s completed OK", cmd.action.c_str());
+    LOG_D("CMD %s completed OK", cmd.action.c_str());
   } else {
-    debugLog.log("ERROR", "CMD %s FAILED: %s", cmd.action.c_str(), errorMsg.c_str());
+    LOG_E("CMD %s FAILED: %s", cmd.action.c_str(), errorMsg.c_str());
+  }
+  return ok;
+}
+
+// Busca um lote de comandos e executa em ordem (CommandQueue.h). Os acks
+// vão juntos no próximo poll; antes de restart/factoryreset/OTA o resto do
+// lote volta ao servidor e os acks são enviados na hora.
+void processCloudCommand() {
+  if (WiFi.status() != WL_CONNECTED) return;
+  if (deviceToken.length() == 0) return;
+
+  static Command batch[CMD_BATCH_MAX];   // fora da stack: 4 x StaticJsonDocument
+  if (cloudAuth.pullCommands(batch, CMD_BATCH_MAX) <= 0) {
+    return; // sem comando ou erro
+  }
+
+  CommandQueue& queue = cloudAuth.commandQueue();
+  int slot;
+  while ((slot = queue.next()) >= 0) {
+    Command& cmd = batch[slot];
+
+    if (queue.isBarrier(slot)) {
+      queue.requeueRemaining();
+      // restart/factoryreset não voltam: confirma antes de executar
+      if (cmd.action == "restart" || cmd.action == "factoryreset") {
+        queue.complete(slot, true, "");
+      }
+      cloudAuth.flushCommandAcks();
+    }
+
+    String errorMsg = "";
+    bool ok = executeCloudCommand(cmd, errorMsg);
+    queue.complete(slot, ok, errorMsg.c_str());
   }
 }
 
@@ -2405,6 +2364,12 @@ void sendKhProgressToCloud(bool active, const String& type,
                            int compS,
                            int lvlA, int lvlB, int lvlC,
                            float ph, float temp) {
+  // Vai no próximo frame de telemetria; envio separado só em servidor antigo
+  if (!telemetryFrame.legacy()) {
+    telemetryFrame.setProgress(active, type, msg, pct, compS);
+    return;
+  }
+
   // [DEBUG] Log de tentativa de envio
   static unsigned long send_count = 0;
   send_count++;
@@ -2498,8 +2463,8 @@ void handleMeasurementResult() {
                 result.ph_reference, result.ph_sample, result.temperature);
 
   Serial.printf("[Main] Medição concluída: KH=%.2f dKH\n", result.kh_value);
-  debugLog.log("INFO", "Measurement COMPLETE: KH=%.2f, pH_ref=%.2f, pH_sample=%.2f, temp=%.1f",
-               result.kh_value, result.ph_reference, result.ph_sample, result.temperature);
+  LOG_I("Measurement COMPLETE: KH=%.2f, pH_ref=%.2f, pH_sample=%.2f, temp=%.1f",
+        result.kh_value, result.ph_reference, result.ph_sample, result.temperature);
 
   MeasurementHistory::Measurement mh;
   mh.kh          = result.kh_value;
@@ -2531,12 +2496,17 @@ void handleMeasurementResult() {
     Serial.println("[TestSchedule] Resultado da medição agendada salvo");
   }
 
+  // Dosadora na mesma rede recebe na hora (só com relógio válido)
+  if (ts > 1000000000000ULL) {
+    doserLink.publishMeasurement(mh.kh, (uint32_t)(ts / 1000ULL));
+  }
+
   if (deviceToken.length() > 0) {
     cloudAuth.queueMeasurement(mc);
-    debugLog.log("DEBUG", "Measurement queued for sync, queue size=%d",
-                 cloudAuth.getQueueSize());
+    LOG_D("Measurement queued for sync, queue size=%d",
+          cloudAuth.getQueueSize());
   } else {
-    debugLog.log("WARN", "Measurement not synced - no token");
+    LOG_W("Measurement not synced - no token");
   }
 }
 
@@ -2544,7 +2514,7 @@ void handleMeasurementResult() {
 // A FSM é avançada pela seção 10 do loop(); o resultado é processado em handleMeasurementResult()
 void performMeasurement() {
   Serial.println("[Main] Iniciando ciclo de medição...");
-  debugLog.log("INFO", "Measurement cycle START");
+  LOG_I("Measurement cycle START");
 
   currentCycleStartMs = getCurrentEpochMs();
   if (currentCycleStartMs == 0) {
@@ -2556,11 +2526,11 @@ void performMeasurement() {
     khAnalyzerLastStepMs = millis();
   } else {
     Serial.println("[Main] ERRO: Falha ao iniciar ciclo de medição");
-    debugLog.log("ERROR", "Measurement cycle FAILED to start!");
+    LOG_E("Measurement cycle FAILED to start!");
     if (khAnalyzer.hasError()) {
       String errMsg = khAnalyzer.getErrorMessage();
       Serial.println("[Main] " + errMsg);
-      debugLog.log("ERROR", "KH Analyzer error: %s", errMsg.c_str());
+      LOG_E("KH Analyzer error: %s", errMsg.c_str());
     }
   }
 }
@@ -2644,7 +2614,7 @@ void saveConfigToSPIFFS() {
     return;
   }
 
-  DynamicJsonDocument doc(128);
+  JsonDoc doc(128);
   doc["intervalHours"] = measurementInterval / (60UL * 60UL * 1000UL);
 
   if (serializeJson(doc, f) == 0) {
@@ -2673,7 +2643,7 @@ void loadConfigFromSPIFFS() {
     return;
   }
 
-  DynamicJsonDocument doc(128);
+  JsonDoc doc(128);
   DeserializationError err = deserializeJson(doc, f);
   f.close();
 
@@ -2686,20 +2656,20 @@ void loadConfigFromSPIFFS() {
   measurementInterval = hours * 60UL * 60UL * 1000UL;
 
   Serial.printf("[Config] Config carregada do SPIFFS: intervalHours=%lu\n", hours);
-  debugLog.log("INFO", "Config loaded from SPIFFS: interval=%lu h", hours);
+  LOG_I("Config loaded from SPIFFS: interval=%lu h", hours);
 }
 
 // Busca config do backend (intervalHours)
 bool fetchConfigFromBackend() {
   if (WiFi.status() != WL_CONNECTED) {
     Serial.println("[Config] WiFi não conectado, não pode buscar config do backend");
-    debugLog.log("WARN", "Config fetch skipped - no WiFi");
+    LOG_W("Config fetch skipped - no WiFi");
     return false;
   }
 
   if (deviceToken.length() == 0) {
     Serial.println("[Config] Sem deviceToken, não pode buscar config");
-    debugLog.log("WARN", "Config fetch skipped - no token");
+    LOG_W("Config fetch skipped - no token");
     return false;
   }
 
@@ -2709,11 +2679,11 @@ bool fetchConfigFromBackend() {
                deviceId + "/kh-config";
 
   Serial.printf("[Config] Buscando config do backend: %s\n", url.c_str());
-  debugLog.log("INFO", "Fetching config from backend");
+  LOG_I("Fetching config from backend");
 
   if (!http.begin(client, url)) {
     Serial.println("[Config] http.begin falhou");
-    debugLog.log("ERROR", "Config fetch: http.begin FAILED");
+    LOG_E("Config fetch: http.begin FAILED");
     return false;
   }
 
@@ -2722,7 +2692,7 @@ bool fetchConfigFromBackend() {
 
   if (code != 200) {
     Serial.printf("[Config] GET config falhou com código %d\n", code);
-    debugLog.log("ERROR", "Config fetch FAILED: HTTP %d", code);
+    LOG_E("Config fetch FAILED: HTTP %d", code);
     http.end();
     return false;
   }
@@ -2730,7 +2700,7 @@ bool fetchConfigFromBackend() {
   String payload = http.getString();
   http.end();
 
-  DynamicJsonDocument doc(2048);
+  JsonDoc doc(2048);
   DeserializationError err = deserializeJson(doc, payload);
   if (err) {
     Serial.printf("[Config] Erro ao parsear JSON: %s\n", err.c_str());
@@ -2752,7 +2722,7 @@ bool fetchConfigFromBackend() {
   saveConfigToSPIFFS();
 
   Serial.println("[Config] ✓ Config do backend carregada e salva no SPIFFS");
-  debugLog.log("INFO", "Config loaded from backend");
+  LOG_I("Config loaded from backend");
   return true;
 }
 
@@ -2779,7 +2749,7 @@ bool fetchIntervalFromBackendStatus() {
   String payload = http.getString();
   http.end();
 
-  DynamicJsonDocument doc(1024);
+  JsonDoc doc(1024);
   if (deserializeJson(doc, payload)) return false;
   if (!doc["success"].as<bool>()) return false;
 
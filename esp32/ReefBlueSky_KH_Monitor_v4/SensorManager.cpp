@@ -183,6 +183,11 @@ float SensorManager::getLastTemperature() const {
     return _last_temperature;
 }
 
+float SensorManager::phFromAdc(float raw) {
+    if (_simulatePH) return _simPHRef;
+    return voltageToPhValue(raw * VOLTAGE_REF / ADC_RESOLUTION);
+}
+
 bool SensorManager::isPHSensorOK() {
     float ph = getPH();
     return ph >= 0 && ph <= 14;
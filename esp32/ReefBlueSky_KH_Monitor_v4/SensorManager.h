@@ -77,6 +77,14 @@ public:
      */
     float getLastTemperature() const;
 
+    /**
+     * Converter uma leitura crua do ADC em pH (sem média, sem delay, sem log)
+     * Usado pela amostragem rápida da telemetria local (LiveTelemetry)
+     * @param raw Valor do analogRead
+     * @return Valor de pH (0-14)
+     */
+    float phFromAdc(float raw);
+
     /**
      * Verificar se sensor de pH está funcionando
      * @return true se sensor está OK
@@ -0,0 +1,164 @@
+#include "TelemetryFrame.h"
+#include "FwVersion.h"
+#include <mbedtls/base64.h>
+
+TelemetryFrame telemetryFrame;
+
+// Chaves curtas e zona morta de cada campo de health (mesma ordem de healthValues)
+static const struct {
+  const char* key;
+  float deadband;
+} HEALTH_FIELDS[TELEMETRY_HEALTH_FIELDS] = {
+  { "mem",  1.0f },     // % heap usado
+  { "sto",  1.0f },     // % SPIFFS
+  { "rssi", 3.0f },     // % sinal
+  { "la",   0.0f },
+  { "lb",   0.0f },
+  { "lc",   0.0f },
+  { "t",    0.1f },     // °C
+  { "ph",   0.02f },
+  { "hf",   2048.0f },  // heap livre
+  { "hm",   1024.0f },  // heap mínimo
+  { "hb",   2048.0f },  // maior bloco
+  { "jp",   0.0f },     // pico da arena JSON
+  { "jf",   0.0f },     // fallbacks da arena JSON
+};
+
+TelemetryFrame::TelemetryFrame() {
+  memset(_cur, 0, sizeof(_cur));
+  memset(_sent, 0, sizeof(_sent));
+}
+
+void TelemetryFrame::healthValues(const SystemHealth& h, float* out) const {
+  out[0]  = h.memory_usage;
+  out[1]  = h.spiffs_usage;
+  out[2]  = h.wifi_signal_strength;
+  out[3]  = h.level_a;
+  out[4]  = h.level_b;
+  out[5]  = h.level_c;
+  out[6]  = h.temperature;
+  out[7]  = h.ph;
+  out[8]  = h.heap_free;
+  out[9]  = h.heap_min_free;
+  out[10] = h.heap_largest_block;
+  out[11] = h.json_arena_peak;
+  out[12] = h.json_arena_fallbacks;
+}
+
+void TelemetryFrame::setHealth(const SystemHealth& h) {
+  healthValues(h, _cur);
+  _uptime = h.uptime;
+  _haveHealth = true;
+}
+
+void TelemetryFrame::setProgress(bool active, const String& type, const String& msg,
+                                 int pct, int compS) {
+  if (active != _progActive || type != _progType || msg != _progMsg ||
+      pct != _progPct || compS != _progCompS) {
+    _progDirty = true;
+  }
+  _progActive = active;
+  _progType = type;
+  _progMsg = msg;
+  _progPct = pct;
+  _progCompS = compS;
+}
+
+bool TelemetryFrame::send(CloudAuth& cloud, BinLog& log) {
+  unsigned long now = millis();
+  if (now - _lastKeyframe >= TELEMETRY_KEYFRAME_MS) _keyframe = true;
+  bool key = _keyframe && _haveHealth;
+
+  JsonDoc doc(768 + TELEMETRY_LOG_MAX * 4 / 3);
+  bool any = false;
+
+  if (key) {
+    doc["k"] = 1;
+    doc["fw"] = FW_VERSION;
+    any = true;
+  }
+
+  // Health: só o que saiu da zona morta (tudo no keyframe)
+  bool changed[TELEMETRY_HEALTH_FIELDS] = {};
+  if (_haveHealth) {
+    JsonObject h;
+    for (int i = 0; i < TELEMETRY_HEALTH_FIELDS; i++) {
+      float d = fabsf(_cur[i] - _sent[i]);
+      if (!key && d <= HEALTH_FIELDS[i].deadband) continue;
+      if (h.isNull()) h = doc.createNestedObject("h");
+      h[HEALTH_FIELDS[i].key] = _cur[i];
+      changed[i] = true;
+    }
+    if (key) h["up"] = _uptime;
+    any |= !h.isNull();
+  }
+
+  // Progresso: quando muda, e a cada TELEMETRY_PROGRESS_KEEP enquanto ativo
+  bool prog = _progDirty || (_progActive && now - _progSentAt >= TELEMETRY_PROGRESS_KEEP);
+  if (prog && _progType.length() > 0) {
+    JsonObject p = doc.createNestedObject("p");
+    p["a"]   = _progActive ? 1 : 0;
+    p["ty"]  = _progType;
+    p["m"]   = _progMsg;
+    p["pct"] = _progPct;
+    p["cs"]  = _progCompS;
+    any = true;
+  } else {
+    prog = false;
+  }
+
+  // Logs: quando já juntou bastante ou a cada TELEMETRY_LOG_EVERY_MS
+  BinLogMark mark = {};
+  bool withLog = false;
+  uint32_t pending = log.pendingBytes();
+  if (pending > 0 && (any || pending >= TELEMETRY_LOG_MAX / 2 || now - _lastLog >= TELEMETRY_LOG_EVERY_MS)) {
+    static uint8_t raw[TELEMETRY_LOG_MAX];
+    size_t n = log.pendingFrame(raw, sizeof(raw), mark);
+    if (n > 0) {
+      static char b64[TELEMETRY_LOG_MAX * 4 / 3 + 4];
+      size_t olen = 0;
+      mbedtls_base64_encode((unsigned char*)b64, sizeof(b64), &olen, raw, n);
+      b64[olen] = 0;
+      doc["log"] = (const char*)b64;   // por referência: b64 é estático
+      withLog = true;
+      any = true;
+    }
+  }
+
+  if (!any) {
+    _skipped++;
+    return true;
+  }
+
+  String payload;
+  serializeJson(doc, payload);
+
+  bool resync = false;
+  int code = cloud.sendTelemetry(payload, resync);
+  if (code == 404) {
+    Serial.println("[Telemetry] Servidor sem /device/telemetry, voltando aos envios separados");
+    _legacy = true;
+    return false;
+  }
+  if (code != 200) return false;
+
+  _frames++;
+  for (int i = 0; i < TELEMETRY_HEALTH_FIELDS; i++) {
+    if (changed[i]) _sent[i] = _cur[i];
+  }
+  if (key) {
+    _keyframe = false;
+    _lastKeyframe = now;
+  }
+  if (prog) {
+    _progDirty = false;
+    _progSentAt = now;
+  }
+  if (withLog) {
+    log.markSent(mark);
+    _lastLog = now;
+  }
+  // Servidor perdeu o estado (reinício): próximo frame completo
+  if (resync) _keyframe = true;
+  return true;
+}
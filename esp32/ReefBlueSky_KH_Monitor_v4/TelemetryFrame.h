@@ -0,0 +1,78 @@
+//TelemetryFrame.h
+#pragma once
+
+#include <Arduino.h>
+#include "CloudAuth.h"
+#include "BinLog.h"
+
+/**
+ * Frame único de telemetria para a nuvem (POST /device/telemetry)
+ *
+ * Health, progresso do ciclo KH, versão do firmware e logs pendentes iam
+ * cada um na sua conexão HTTP (/device/health a cada 2 s, /device/kh-status
+ * a cada 1 s durante o ciclo, /device/logs a cada 60 s...). Agora tudo que
+ * estiver pendente sai num POST só, a cada TELEMETRY_FRAME_MS no máximo.
+ *
+ * Supressão por campo: um valor de health só vai se mudou mais que a zona
+ * morta desde o último envio aceito pelo servidor; o servidor mantém o
+ * último estado e completa o resto. A cada TELEMETRY_KEYFRAME_MS (ou
+ * quando o servidor pede "resync") vai um keyframe com todos os campos.
+ * Frame vazio não é enviado.
+ *
+ *   { "k":1, "fw":"..", "h":{"mem":..,"ph":..}, "p":{"a":1,"ty":"measurement",
+ *     "m":"..","pct":40,"cs":12}, "log":"<frame do BinLog em base64>" }
+ *
+ * Servidor sem /device/telemetry (404): legacy() fica true e o .ino volta
+ * aos envios separados.
+ */
+
+#define TELEMETRY_FRAME_MS       1000UL
+#define TELEMETRY_KEYFRAME_MS    60000UL
+#define TELEMETRY_PROGRESS_KEEP  10000UL   // reenvia progresso parado (kh-status expira em 30 s)
+#define TELEMETRY_LOG_MAX        1024      // bytes de log por frame
+#define TELEMETRY_LOG_EVERY_MS   60000UL   // log pendente vai pelo menos a cada 60 s
+#define TELEMETRY_HEALTH_FIELDS  13
+
+class TelemetryFrame {
+public:
+  TelemetryFrame();
+
+  // Último snapshot de health (campos mudados vão no próximo frame)
+  void setHealth(const SystemHealth& h);
+  // Estado do ciclo KH; active=false (fim) sempre vai
+  void setProgress(bool active, const String& type, const String& msg, int pct, int compS);
+  // Força keyframe no próximo envio (boot, reautenticação)
+  void requestKeyframe() { _keyframe = true; }
+
+  // Monta e envia o frame se houver algo; false se falhou
+  bool send(CloudAuth& cloud, BinLog& log);
+
+  bool legacy() const { return _legacy; }
+  uint32_t framesSent() const { return _frames; }
+  uint32_t framesSkipped() const { return _skipped; }
+
+private:
+  void healthValues(const SystemHealth& h, float* out) const;
+
+  float    _cur[TELEMETRY_HEALTH_FIELDS];
+  float    _sent[TELEMETRY_HEALTH_FIELDS];
+  uint32_t _uptime = 0;
+  bool     _haveHealth = false;
+  bool     _keyframe = true;
+  unsigned long _lastKeyframe = 0;
+
+  bool     _progActive = false;
+  bool     _progDirty = false;
+  String   _progType;
+  String   _progMsg;
+  int      _progPct = -1;
+  int      _progCompS = 0;
+  unsigned long _progSentAt = 0;
+
+  unsigned long _lastLog = 0;
+  bool     _legacy = false;
+  uint32_t _frames = 0;
+  uint32_t _skipped = 0;
+};
+
+extern TelemetryFrame telemetryFrame;
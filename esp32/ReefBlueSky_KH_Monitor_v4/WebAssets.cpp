@@ -0,0 +1,116 @@
+#include "WebAssets.h"
+#include <WiFi.h>
+
+extern String deviceId;
+extern const char* FW_VERSION;
+
+// ---------- CRC32 (mesmo polinômio do gzip) ----------
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* p, size_t n) {
+  crc = ~crc;
+  while (n--) {
+    crc ^= *p++;
+    for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+  }
+  return ~crc;
+}
+
+// a(x) * b(x) mod p(x), polinômios refletidos como no zlib
+static uint32_t multModP(uint32_t a, uint32_t b) {
+  uint32_t m = 1u << 31, p = 0;
+  for (;;) {
+    if (a & m) {
+      p ^= b;
+      if ((a & (m - 1)) == 0) break;
+    }
+    m >>= 1;
+    b = (b & 1) ? (b >> 1) ^ 0xEDB88320u : b >> 1;
+  }
+  return p;
+}
+
+// CRC de A||B a partir de crc(A), crc(B) e len(B) (crc32_combine do zlib):
+// multiplica crc(A) por x^(8*lenB) mod p(x)
+static uint32_t crc32Combine(uint32_t crcA, uint32_t crcB, uint32_t lenB) {
+  uint32_t xp = 1u << 31;          // x^0
+  uint32_t sq = 1u << 23;          // x^8 (um byte)
+  for (; lenB; lenB >>= 1) {
+    if (lenB & 1) xp = multModP(sq, xp);
+    sq = multModP(sq, sq);
+  }
+  return multModP(xp, crcA) ^ crcB;
+}
+
+// ---------- Envio ----------
+
+void webAssetCollectHeaders(WebServer& server) {
+  static const char* keys[] = { "If-None-Match" };
+  server.collectHeaders(keys, 1);
+}
+
+void webAssetSend(WebServer& server, const WebAsset& asset,
+                  const char* const values[WEB_FIELD_COUNT]) {
+  // Tamanho final e ETag: partes fixas + um bloco stored (5 bytes) por valor
+  size_t total = 10 + 8;
+  uint32_t valuesCrc = 0;
+  for (uint8_t i = 0; i < asset.nparts; i++) {
+    const WebAssetPart& p = asset.parts[i];
+    total += p.len;
+    if (p.field != WEB_FIELD_NONE) {
+      size_t n = strlen(values[p.field]);
+      if (n > 0) total += 5 + n;
+      valuesCrc = crc32Update(valuesCrc, (const uint8_t*)values[p.field], n + 1);
+    }
+  }
+
+  char etag[48];
+  snprintf(etag, sizeof(etag), "\"%s-%08lx\"", asset.etag, (unsigned long)valuesCrc);
+
+  server.sendHeader("ETag", etag);
+  server.sendHeader("Cache-Control", "no-cache");
+  if (server.header("If-None-Match") == etag) {
+    server.send(304);
+    return;
+  }
+
+  server.sendHeader("Content-Encoding", "gzip");
+  server.setContentLength(total);
+  server.send(200, asset.mime, "");
+
+  // Cabeçalho gzip + trechos da flash em pedaços; cada valor vai como bloco
+  // deflate stored (BFINAL=0, BTYPE=00): o trecho anterior terminou alinhado
+  uint32_t crc = 0, isize = 0;
+  server.sendContent_P((PGM_P)asset.gz, 10);
+  for (uint8_t i = 0; i < asset.nparts; i++) {
+    const WebAssetPart& p = asset.parts[i];
+    for (uint32_t o = 0; o < p.len; o += WEB_ASSET_CHUNK) {
+      server.sendContent_P((PGM_P)(asset.gz + p.off + o), min((uint32_t)WEB_ASSET_CHUNK, p.len - o));
+    }
+    crc = crc32Combine(crc, p.crc, p.rawLen);
+    isize += p.rawLen;
+
+    if (p.field == WEB_FIELD_NONE) continue;
+    const char* v = values[p.field];
+    uint16_t n = strlen(v);
+    if (n == 0) continue;
+    uint8_t hdr[5] = { 0x00, (uint8_t)n, (uint8_t)(n >> 8), (uint8_t)~n, (uint8_t)(~n >> 8) };
+    server.sendContent((const char*)hdr, sizeof(hdr));
+    server.sendContent(v, n);
+    crc = crc32Update(crc, (const uint8_t*)v, n);
+    isize += n;
+  }
+
+  uint8_t trailer[8];
+  memcpy(trailer, &crc, 4);
+  memcpy(trailer + 4, &isize, 4);
+  server.sendContent((const char*)trailer, sizeof(trailer));
+}
+
+void webAssetSend(WebServer& server, const WebAsset& asset) {
+  // Antes do registro no servidor ainda não há deviceId: mostra o MAC
+  String id = deviceId.length() > 0 ? deviceId : WiFi.macAddress();
+  const char* values[WEB_FIELD_COUNT];
+  values[WEB_FIELD_DEVICE_ID] = id.c_str();
+  values[WEB_FIELD_FW_VERSION] = FW_VERSION;
+  webAssetSend(server, asset, values);
+}
@@ -0,0 +1,59 @@
+//WebAssets.h
+#pragma once
+
+#include <Arduino.h>
+#include <WebServer.h>
+
+/**
+ * Páginas HTML servidas direto da flash, já minificadas e em gzip
+ *
+ * gen_web_assets.py lê os .html de web/ e gera WebAssetsData.cpp com um array
+ * PROGMEM por página. Campos {{DEVICE_ID}} e {{FW_VERSION}} dividem a página
+ * em trechos deflate independentes (full flush, sem referência entre eles);
+ * na hora de servir, cada valor entra como um bloco deflate "stored" e o
+ * CRC32/tamanho do rodapé gzip são fechados aqui. Nada da página passa pelo
+ * heap: só os ponteiros da flash e os valores dos campos.
+ *
+ * Resposta com Content-Encoding: gzip, Content-Length exato e ETag
+ * (hash do conteúdo + CRC dos valores). If-None-Match igual -> 304.
+ */
+
+#define WEB_ASSET_CHUNK 1024   // bytes por sendContent
+
+enum WebAssetField : int8_t {
+  WEB_FIELD_NONE = -1,        // último trecho
+  WEB_FIELD_DEVICE_ID = 0,
+  WEB_FIELD_FW_VERSION,
+  WEB_FIELD_COUNT
+};
+
+// Trecho estático: bloco deflate em gz[off, off+len) e o campo que vem depois
+struct WebAssetPart {
+  uint32_t off;
+  uint16_t len;
+  uint32_t rawLen;            // bytes descomprimidos (para ISIZE)
+  uint32_t crc;               // CRC32 dos bytes descomprimidos
+  int8_t   field;             // WebAssetField
+};
+
+struct WebAsset {
+  const char* mime;
+  const char* etag;           // hash do gzip gerado (sem aspas)
+  const uint8_t* gz;          // cabeçalho gzip (10 bytes) + trechos deflate
+  const WebAssetPart* parts;
+  uint8_t nparts;
+};
+
+extern const WebAsset WEB_ASSET_SETUP;    // web/setup.html  (portal WiFiSetup)
+extern const WebAsset WEB_ASSET_WEBOTA;   // web/webota.html (/webota)
+
+// Pede ao WebServer para guardar If-None-Match (substitui a lista anterior
+// de collectHeaders; chamar antes de server.begin())
+void webAssetCollectHeaders(WebServer& server);
+
+// Serve a página com os valores dos campos (índice = WebAssetField)
+void webAssetSend(WebServer& server, const WebAsset& asset,
+                  const char* const values[WEB_FIELD_COUNT]);
+
+// Idem, com id do device (ou MAC, antes do registro) e FW_VERSION
+void webAssetSend(WebServer& server, const WebAsset& asset);
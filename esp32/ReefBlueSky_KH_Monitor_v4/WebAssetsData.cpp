@@ -0,0 +1,325 @@
+// WebAssetsData.cpp
+// GERADO por gen_web_assets.py a partir de web/*.html - não editar.
+
+#include "WebAssets.h"
+
+// setup.html: 9838 bytes -> 6538 minificado -> 2490 gzip
+static const uint8_t web_asset_setup_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xa4, 0x56, 0xdb, 0x8e, 0xdb, 0x36,
+  0x10, 0x7d, 0xef, 0x57, 0xb0, 0x5a, 0x04, 0xdd, 0x2d, 0x2c, 0xaf, 0xe4, 0xdb, 0x26, 0xb2, 0xd7,
+  0x08, 0x72, 0x6b, 0x83, 0x22, 0xed, 0x22, 0x4e, 0x1a, 0x04, 0x45, 0x1e, 0x68, 0x91, 0xb6, 0xd8,
+  0x95, 0x48, 0x95, 0x94, 0xbc, 0x76, 0x0d, 0xff, 0x43, 0x81, 0xbc, 0x16, 0x68, 0x83, 0x3e, 0xf4,
+  0xa9, 0x5f, 0xb1, 0x7f, 0xd2, 0x2f, 0xe8, 0x27, 0x74, 0x48, 0x4a, 0xb2, 0xe4, 0xd5, 0x36, 0x97,
+  0xc2, 0x80, 0x2d, 0xd1, 0x9c, 0x33, 0x33, 0x67, 0xce, 0x0c, 0x39, 0xf9, 0xfc, 0xd1, 0x77, 0x0f,
+  0x5f, 0xbc, 0xbe, 0x78, 0x8c, 0xa2, 0x2c, 0x89, 0xa7, 0x13, 0xfd, 0x8d, 0x62, 0xcc, 0x97, 0xe7,
+  0x4e, 0x9a, 0xb9, 0x0f, 0x9e, 0x3b, 0xb0, 0x44, 0x31, 0x99, 0x4e, 0x12, 0x9a, 0x61, 0x14, 0x46,
+  0x58, 0x2a, 0x9a, 0x9d, 0x3b, 0x2f, 0x5f, 0x3c, 0x71, 0xef, 0x3a, 0xc5, 0x2a, 0xc7, 0x09, 0x3d,
+  0x77, 0x56, 0x8c, 0x5e, 0xa5, 0x42, 0x66, 0x0e, 0x0a, 0x05, 0xcf, 0x28, 0x87, 0x5d, 0x57, 0x8c,
+  0x64, 0xd1, 0x39, 0xa1, 0x2b, 0x16, 0x52, 0xd7, 0xbc, 0x74, 0x10, 0xe3, 0x2c, 0x63, 0x38, 0x76,
+  0x55, 0x88, 0x63, 0x7a, 0xee, 0x77, 0x3d, 0x40, 0xc9, 0x58, 0x16, 0xd3, 0xe9, 0x73, 0x4a, 0x17,
+  0x0f, 0xe2, 0x9c, 0xce, 0x2e, 0x37, 0xe8, 0x9b, 0xaf, 0xd1, 0x33, 0x01, 0x3b, 0x85, 0x44, 0x2e,
+  0x7a, 0x28, 0xf8, 0x82, 0x2d, 0x73, 0x89, 0xaf, 0xff, 0xbc, 0xfe, 0x43, 0xa0, 0xa7, 0x9c, 0x85,
+  0x80, 0x30, 0x39, 0xb5, 0x66, 0x13, 0x95, 0x6d, 0xe0, 0xe7, 0xcb, 0x6d, 0x82, 0xe5, 0x92, 0xf1,
+  0xc0, 0x1b, 0xa7, 0x98, 0x10, 0xc6, 0x97, 0xf0, 0x34, 0x17, 0x6b, 0x57, 0xb1, 0x9f, 0xf5, 0xcb,
+  0x5c, 0x48, 0x42, 0xa5, 0x0b, 0x2b, 0xbb, 0xb9, 0x20, 0x9b, 0xed, 0x02, 0x82, 0x74, 0x17, 0x38,
+  0x61, 0xf1, 0x26, 0xf8, 0x62, 0x46, 0x97, 0x82, 0xa2, 0x97, 0x4f, 0xbf, 0xe8, 0xbc, 0xc0, 0x91,
+  0x48, 0x70, 0xe7, 0x2b, 0xca, 0xe9, 0x0a, 0x77, 0xbe, 0xa7, 0x92, 0x60, 0x8e, 0x3b, 0x0a, 0x73,
+  0xe5, 0x2a, 0x2a, 0xd9, 0x62, 0x3c, 0xc7, 0xe1, 0xe5, 0x52, 0x8a, 0x9c, 0x93, 0x20, 0x66, 0x9c,
+  0x62, 0xe9, 0x2e, 0x25, 0x26, 0x0c, 0xf2, 0x3d, 0xf6, 0xfb, 0x43, 0x42, 0x97, 0x9d, 0xa3, 0xd1,
+  0xe8, 0x8c, 0x52, 0x8c, 0xbc, 0x3b, 0x9d, 0xa3, 0xb3, 0xd1, 0x60, 0x8e, 0x7b, 0xc8, 0xf7, 0xbc,
+  0x3b, 0x27, 0xe3, 0x84, 0x71, 0x37, 0xa2, 0x6c, 0x19, 0x65, 0x01, 0x2c, 0xac, 0xa2, 0x31, 0x61,
+  0x2a, 0x8d, 0xf1, 0x26, 0x58, 0xc4, 0x74, 0x3d, 0xfe, 0x31, 0x57, 0x19, 0x5b, 0x6c, 0xdc, 0x82,
+  0xbd, 0x20, 0x84, 0x2f, 0x2a, 0xc7, 0x38, 0x66, 0x4b, 0xee, 0xb2, 0x8c, 0x26, 0xaa, 0x5c, 0x2a,
+  0xf3, 0xeb, 0x79, 0xe9, 0x7a, 0xd7, 0xd5, 0xfb, 0x31, 0x44, 0x22, 0xb7, 0xb5, 0xd0, 0xae, 0x22,
+  0xb0, 0x18, 0x17, 0x39, 0xeb, 0xf8, 0x72, 0x05, 0x3e, 0xd3, 0xb5, 0x65, 0x24, 0xc2, 0x44, 0x5c,
+  0x05, 0x1e, 0xd2, 0x2b, 0x68, 0xa0, 0xbf, 0xe4, 0x72, 0x8e, 0x8f, 0xbd, 0x8e, 0xf9, 0x74, 0x7b,
+  0x10, 0x2a, 0x5e, 0xdb, 0x82, 0x05, 0x43, 0x4f, 0x9b, 0xd9, 0x67, 0x9d, 0x46, 0xe5, 0x7d, 0x60,
+  0xbc, 0xc7, 0x62, 0x29, 0xb6, 0x19, 0x5d, 0x67, 0xae, 0x09, 0xb4, 0x0c, 0xd1, 0xd6, 0x02, 0xd8,
+  0xce, 0x32, 0x91, 0x04, 0xfd, 0x6a, 0x2b, 0x8a, 0xfc, 0x6d, 0x28, 0x62, 0x21, 0x83, 0xa3, 0x7e,
+  0xbf, 0x3f, 0x36, 0x45, 0x80, 0x02, 0xd1, 0xa0, 0x77, 0x17, 0xbc, 0x34, 0xad, 0xfc, 0xbd, 0x55,
+  0x5a, 0x1a, 0x8d, 0x46, 0xa3, 0x9a, 0x91, 0x3f, 0xd0, 0x3b, 0x16, 0x42, 0x26, 0xae, 0xce, 0x3b,
+  0xdd, 0x36, 0x01, 0x0c, 0x3f, 0x31, 0x9e, 0xd3, 0x78, 0x5b, 0x32, 0x3d, 0x8f, 0x45, 0x78, 0x79,
+  0xe0, 0x47, 0x7b, 0x3e, 0x8c, 0xe9, 0xca, 0x96, 0x09, 0x92, 0x3f, 0x74, 0xc7, 0x78, 0x9a, 0x67,
+  0x3f, 0x64, 0x9b, 0x14, 0x24, 0xaf, 0xf3, 0x76, 0xde, 0x74, 0xea, 0x4b, 0x29, 0x56, 0xea, 0x0a,
+  0x68, 0x3f, 0x58, 0xce, 0x65, 0xec, 0xbc, 0xd9, 0xb6, 0xb0, 0xe8, 0xf7, 0x4c, 0x51, 0x74, 0x9d,
+  0x02, 0x1f, 0x0a, 0xa1, 0x44, 0xcc, 0x08, 0x3a, 0x22, 0x84, 0x1c, 0x54, 0x6f, 0x08, 0xfb, 0x9a,
+  0xa1, 0x8c, 0x33, 0x09, 0xb2, 0x84, 0x6e, 0x12, 0xbc, 0x54, 0xb7, 0x49, 0x03, 0x79, 0xdd, 0xbe,
+  0x6a, 0x89, 0x33, 0x58, 0x88, 0x30, 0x57, 0xb7, 0x44, 0xdb, 0xf2, 0xa7, 0x89, 0xd9, 0xae, 0x6f,
+  0x45, 0x9e, 0x69, 0xb5, 0x07, 0x5c, 0xf0, 0x4a, 0x56, 0x55, 0x49, 0xb4, 0xda, 0x9b, 0xc2, 0xd2,
+  0x9f, 0x7e, 0x29, 0x2b, 0xdf, 0xeb, 0x75, 0xfc, 0xde, 0xa8, 0xd3, 0xeb, 0x0f, 0x40, 0x5c, 0xfe,
+  0xc9, 0xae, 0xab, 0x68, 0xa8, 0xa3, 0x76, 0x4d, 0x03, 0x6f, 0x6b, 0x59, 0x8d, 0xca, 0x24, 0x0b,
+  0xfe, 0x47, 0xc0, 0x7f, 0xad, 0x34, 0x45, 0xdd, 0x32, 0x91, 0x06, 0xbd, 0xe1, 0x4d, 0xbd, 0xe8,
+  0xa5, 0x82, 0xd7, 0xba, 0x86, 0xc6, 0x55, 0xeb, 0x5b, 0x55, 0xec, 0x59, 0xb6, 0xa1, 0xef, 0xe6,
+  0x39, 0xfc, 0xc1, 0x6f, 0xaf, 0xce, 0xa7, 0x77, 0xbc, 0x8d, 0xbd, 0xde, 0x8c, 0x0d, 0x06, 0xdb,
+  0x4b, 0xdb, 0x4a, 0x42, 0x2e, 0x15, 0x20, 0xa5, 0x82, 0x99, 0xf6, 0xaa, 0x55, 0xde, 0x3c, 0xea,
+  0x16, 0x80, 0xb2, 0xf7, 0x54, 0x67, 0x5f, 0x06, 0xf3, 0x5e, 0xa7, 0xcc, 0x74, 0xa1, 0xcd, 0x35,
+  0x88, 0xc4, 0x0a, 0x06, 0x46, 0x65, 0x6b, 0x51, 0x62, 0x9c, 0xd1, 0xd7, 0xc7, 0x2e, 0xe4, 0x7c,
+  0xd2, 0x2c, 0x27, 0x04, 0x88, 0x7a, 0x5e, 0x7b, 0x3d, 0x07, 0x27, 0x25, 0x26, 0x86, 0xa2, 0xae,
+  0x68, 0x3b, 0xa8, 0xa7, 0xab, 0x9e, 0xe1, 0x0c, 0xa4, 0x54, 0x2f, 0xa2, 0xb7, 0xaf, 0x98, 0x2d,
+  0xdf, 0x4d, 0x62, 0x6e, 0xce, 0x96, 0x83, 0x2e, 0x28, 0x5b, 0x5b, 0x13, 0x5b, 0x3a, 0xe9, 0xaa,
+  0x3c, 0x0c, 0xa9, 0x52, 0xf5, 0x91, 0x78, 0x44, 0x06, 0x94, 0x10, 0x5c, 0xea, 0xc9, 0x1f, 0x0e,
+  0xcf, 0x7a, 0x83, 0x96, 0xd6, 0x0b, 0xfb, 0x74, 0x14, 0xce, 0xc7, 0x8d, 0x89, 0x51, 0xe1, 0x52,
+  0x29, 0x45, 0x63, 0xd0, 0x1e, 0x2d, 0xee, 0x92, 0xb3, 0x3d, 0xea, 0x59, 0xcf, 0x0f, 0x5b, 0x51,
+  0x17, 0xc3, 0xb0, 0x05, 0x35, 0x16, 0x58, 0xe7, 0xbe, 0xad, 0xe7, 0x30, 0xbe, 0x75, 0x9a, 0x96,
+  0x94, 0x41, 0x34, 0x29, 0xe3, 0x66, 0xe2, 0x5b, 0x3f, 0x83, 0x9a, 0x9f, 0xbe, 0xfe, 0x94, 0x3c,
+  0x6a, 0x8b, 0xc1, 0xa1, 0xde, 0x0f, 0x49, 0x06, 0xbd, 0x5b, 0xe9, 0xeb, 0x89, 0x3e, 0x2e, 0x0e,
+  0x28, 0xf3, 0x8c, 0x39, 0x4b, 0xb0, 0x51, 0x99, 0x76, 0x88, 0x7c, 0x85, 0x6c, 0x03, 0xc0, 0x21,
+  0xbe, 0xd0, 0xe7, 0x38, 0x1d, 0x97, 0x67, 0x2e, 0xc2, 0x79, 0x26, 0x76, 0xf7, 0x2f, 0xe9, 0x66,
+  0x21, 0xe1, 0x36, 0xa0, 0x90, 0x36, 0xd8, 0x7a, 0x77, 0x6a, 0x6a, 0x90, 0x02, 0x28, 0xa4, 0xc7,
+  0x1e, 0x34, 0xcc, 0xc9, 0x4e, 0xb7, 0xc7, 0xcd, 0xff, 0xfa, 0x23, 0xfb, 0xef, 0xae, 0x1b, 0xd1,
+  0x38, 0x75, 0x35, 0x11, 0xf5, 0xe9, 0xd0, 0xdb, 0x0f, 0x6a, 0x7d, 0x0e, 0xd4, 0x58, 0x19, 0x6a,
+  0x52, 0x8a, 0x7b, 0x06, 0xc4, 0x26, 0xb6, 0x87, 0x93, 0xe2, 0x3f, 0x55, 0xe4, 0xef, 0x71, 0xef,
+  0xdd, 0xbb, 0xb7, 0x9b, 0x9c, 0xda, 0x1b, 0xc5, 0xe4, 0xd4, 0xde, 0x7c, 0xf4, 0x75, 0x61, 0x3a,
+  0x21, 0x6c, 0x85, 0xc2, 0x18, 0xe6, 0xe5, 0xb9, 0x53, 0x9d, 0xb8, 0x4e, 0x63, 0x59, 0x9f, 0x54,
+  0xfa, 0xba, 0xe4, 0x4f, 0xff, 0xf9, 0xed, 0x97, 0xdf, 0x51, 0xed, 0x3a, 0x03, 0x48, 0xfe, 0x74,
+  0x92, 0x4e, 0x3f, 0xe8, 0x56, 0x93, 0x82, 0x63, 0x40, 0x9d, 0x4e, 0x4c, 0x53, 0x33, 0x62, 0xfc,
+  0xc1, 0xce, 0x27, 0xf0, 0xda, 0x74, 0xd8, 0x18, 0xa3, 0x0e, 0x78, 0x7d, 0xfb, 0x0e, 0xbd, 0x62,
+  0x4f, 0x18, 0x22, 0x18, 0x3d, 0xc4, 0x0a, 0x17, 0x38, 0x35, 0x8b, 0xfd, 0x51, 0x09, 0x48, 0xe6,
+  0x64, 0x44, 0xb0, 0x04, 0x48, 0x8a, 0x91, 0x19, 0x8d, 0x01, 0xcf, 0x81, 0x6b, 0x18, 0x81, 0xfa,
+  0x59, 0x1c, 0x90, 0xa5, 0xe0, 0xd7, 0x7f, 0xad, 0x28, 0x53, 0x93, 0x53, 0xb3, 0x1f, 0xae, 0x5b,
+  0x66, 0x9f, 0x09, 0xac, 0x6e, 0x06, 0xac, 0x99, 0xa7, 0x1b, 0xb8, 0xce, 0xf4, 0x5b, 0x91, 0x50,
+  0x1d, 0x93, 0x46, 0xb6, 0xc0, 0xc7, 0xb3, 0xd9, 0xd3, 0x47, 0x27, 0x15, 0xa4, 0x39, 0x75, 0x50,
+  0xed, 0xac, 0xaa, 0xd0, 0x9d, 0xe2, 0x72, 0x69, 0x9f, 0x25, 0xfd, 0x29, 0x67, 0x92, 0x12, 0x04,
+  0xcd, 0x12, 0xd2, 0x48, 0xc4, 0x20, 0xe3, 0x73, 0xe7, 0xf1, 0x3a, 0x40, 0xcf, 0x68, 0xee, 0x6a,
+  0xe4, 0x26, 0x41, 0x95, 0x8a, 0x8a, 0x18, 0xe8, 0x1a, 0x67, 0x42, 0x47, 0xa2, 0x72, 0x0c, 0x60,
+  0x45, 0x34, 0x05, 0x4d, 0x1f, 0x4c, 0x56, 0x75, 0x68, 0x4e, 0x67, 0x94, 0x47, 0x18, 0x11, 0x51,
+  0xc0, 0xb4, 0x64, 0x53, 0xed, 0x35, 0x19, 0xed, 0xdf, 0x6c, 0x56, 0xfb, 0xf7, 0xf6, 0xcc, 0x66,
+  0x10, 0xa6, 0x32, 0x3e, 0x8a, 0xdc, 0x5a, 0x3c, 0x84, 0x11, 0x0d, 0x2f, 0x61, 0x5a, 0x17, 0x9c,
+  0x45, 0xe2, 0xea, 0x02, 0x50, 0x5f, 0xb1, 0x05, 0xec, 0x07, 0xb5, 0x29, 0x68, 0x32, 0x69, 0x41,
+  0x3e, 0xab, 0x22, 0x6c, 0xa7, 0xa8, 0xc8, 0xe6, 0x80, 0x1d, 0x74, 0xcc, 0xb5, 0x3c, 0xe1, 0xf2,
+  0x7b, 0xfd, 0x0e, 0x08, 0x64, 0x73, 0x46, 0xf0, 0xc9, 0xc7, 0x52, 0x06, 0xd6, 0x70, 0xde, 0xbc,
+  0x84, 0x1f, 0x9d, 0xb8, 0x33, 0x7d, 0xa9, 0xf2, 0xeb, 0x77, 0x92, 0x89, 0xd3, 0xc7, 0x09, 0x66,
+  0xf1, 0xfb, 0x74, 0xd0, 0x34, 0x2e, 0x15, 0x71, 0xb0, 0xda, 0xce, 0xa0, 0xa2, 0xf9, 0x7d, 0xaa,
+  0x7d, 0xc0, 0x35, 0x39, 0xb9, 0x55, 0x1c, 0x65, 0x38, 0x48, 0xe4, 0xc8, 0xec, 0x06, 0xb4, 0x25,
+  0xd3, 0xd4, 0x41, 0x6d, 0xb9, 0x49, 0x7e, 0xc5, 0x88, 0x90, 0x9f, 0x96, 0xf6, 0xc5, 0x4d, 0xbd,
+  0xcc, 0x2a, 0xc0, 0xf7, 0x6a, 0xe6, 0x00, 0xa3, 0x91, 0xfd, 0xc5, 0x87, 0xea, 0xe7, 0x63, 0xa4,
+  0x33, 0x33, 0xd0, 0xff, 0x4b, 0x3c, 0x66, 0x40, 0xde, 0x4a, 0x9c, 0xbd, 0x2e, 0x14, 0x31, 0xa8,
+  0x7c, 0x9e, 0x30, 0xb0, 0xff, 0xfb, 0xd7, 0xb7, 0x7a, 0x22, 0xc2, 0x00, 0x01, 0x8f, 0x14, 0x46,
+  0x85, 0xe5, 0x1f, 0x2c, 0xed, 0x76, 0xeb, 0xd7, 0xc4, 0x69, 0x4e, 0x62, 0xa7, 0x1a, 0x82, 0xf6,
+  0xb5, 0x5e, 0x15, 0xbd, 0xab, 0x38, 0x59, 0x9d, 0xfd, 0x70, 0xb6, 0xef, 0xcd, 0x01, 0x6a, 0x8f,
+  0xd1, 0xca, 0x38, 0x9d, 0x16, 0x21, 0x70, 0xa8, 0x11, 0xb6, 0x6d, 0x0d, 0xc1, 0x94, 0x62, 0xe0,
+  0x4d, 0x35, 0x74, 0xbb, 0xdd, 0xda, 0xb4, 0x3e, 0xd5, 0x22, 0x68, 0xa0, 0xd7, 0xce, 0x23, 0x67,
+  0xfa, 0x2f, 0x00, 0x00, 0x00, 0xff, 0xff, 0x52, 0x38, 0xb4, 0x5d, 0x01, 0x00, 0x00, 0x00, 0xff,
+  0xff, 0xad, 0x56, 0xc9, 0x72, 0xe3, 0x36, 0x10, 0xbd, 0xf3, 0x2b, 0x3a, 0x97, 0x01, 0x55, 0x71,
+  0x48, 0x5f, 0xe6, 0x62, 0x79, 0x9c, 0xaa, 0xb1, 0xe5, 0x4a, 0x52, 0xde, 0x2a, 0x76, 0x6a, 0xce,
+  0x10, 0xd8, 0x14, 0x11, 0x53, 0x00, 0x03, 0x80, 0xd2, 0xa8, 0x3c, 0xfe, 0x8a, 0x1c, 0x72, 0xc9,
+  0x65, 0x6a, 0x0e, 0x39, 0xe5, 0x2b, 0xfc, 0x27, 0xf9, 0x92, 0x34, 0x08, 0x50, 0x8b, 0x3d, 0x43,
+  0x3b, 0xcb, 0x45, 0x22, 0x81, 0x5e, 0x5e, 0xbf, 0xde, 0x78, 0x98, 0x17, 0x72, 0x71, 0x74, 0x18,
+  0x7e, 0xad, 0x30, 0xb2, 0x71, 0x47, 0x49, 0x9e, 0xc3, 0x44, 0x2d, 0xa4, 0x86, 0x42, 0x43, 0xa9,
+  0xcd, 0xbc, 0xad, 0x1f, 0x3e, 0x1a, 0xa9, 0x93, 0x42, 0x8b, 0x76, 0x8e, 0xca, 0x65, 0x33, 0x74,
+  0x93, 0x1a, 0xfd, 0xe3, 0xdb, 0xd5, 0xf7, 0x45, 0xca, 0x84, 0x56, 0xa5, 0x9c, 0x9d, 0x92, 0x28,
+  0x1b, 0x65, 0xbc, 0x28, 0x26, 0x0b, 0xba, 0x3a, 0x93, 0xd6, 0xa1, 0x42, 0x93, 0x32, 0xdb, 0x4e,
+  0xe7, 0xd2, 0xb1, 0x3d, 0xe0, 0x76, 0xa5, 0x04, 0xa4, 0x38, 0x82, 0x37, 0x47, 0x70, 0x97, 0x60,
+  0xd6, 0x18, 0xf4, 0xa2, 0x27, 0x58, 0xf2, 0xb6, 0x76, 0xe9, 0x68, 0x9c, 0x90, 0x29, 0xeb, 0xc0,
+  0x3a, 0xee, 0x5a, 0x7b, 0x22, 0x17, 0xf0, 0x06, 0xbe, 0xe8, 0x35, 0x08, 0xb1, 0xb5, 0x52, 0xad,
+  0x79, 0x21, 0xd5, 0xec, 0x19, 0xad, 0x28, 0xb5, 0x51, 0x9b, 0xb6, 0xce, 0x69, 0xb5, 0xad, 0xf2,
+  0x4b, 0x8b, 0x66, 0x75, 0x8d, 0x35, 0x0a, 0xa7, 0x09, 0x7e, 0x10, 0xd8, 0x28, 0x84, 0x68, 0x49,
+  0xe1, 0x2e, 0xb1, 0x56, 0x16, 0x07, 0x03, 0x08, 0xe9, 0x9a, 0x18, 0x59, 0xf0, 0xba, 0xc5, 0xbd,
+  0xa4, 0xe1, 0xd6, 0x2e, 0xb5, 0x19, 0x52, 0xe8, 0x45, 0x36, 0x4a, 0x16, 0xcd, 0x02, 0xcd, 0x4f,
+  0xf4, 0xa7, 0xf8, 0x1c, 0x87, 0x7c, 0xed, 0x08, 0x3e, 0x36, 0x70, 0xf5, 0xbc, 0xef, 0x5d, 0xc1,
+  0xde, 0x40, 0x72, 0x3f, 0x4e, 0x36, 0xc4, 0x66, 0xd6, 0xad, 0x6a, 0xcc, 0x0a, 0x69, 0x9b, 0x9a,
+  0xaf, 0x88, 0x02, 0x36, 0xad, 0xb5, 0xb8, 0x65, 0xe3, 0x24, 0x90, 0xe4, 0x6f, 0xf8, 0xb4, 0xc6,
+  0x82, 0xae, 0x9c, 0x69, 0x71, 0x9c, 0xac, 0x33, 0xf9, 0x54, 0x55, 0x69, 0x85, 0xa4, 0xe9, 0xcc,
+  0x8a, 0x98, 0x0c, 0xd4, 0x1a, 0xb4, 0x0d, 0x3d, 0x20, 0x5d, 0xf3, 0x25, 0x97, 0x0e, 0x4a, 0x74,
+  0xa2, 0x4a, 0x59, 0xce, 0x1b, 0x99, 0x5b, 0x74, 0x6d, 0x43, 0x55, 0x74, 0x97, 0xcc, 0xd1, 0x55,
+  0x9a, 0x62, 0x61, 0x57, 0x97, 0xd7, 0x37, 0x6c, 0x2f, 0xa9, 0x90, 0x17, 0x68, 0xec, 0x01, 0xdc,
+  0x01, 0x3b, 0xd6, 0x8a, 0xca, 0xce, 0x7d, 0x73, 0xb3, 0x6a, 0x90, 0x91, 0x08, 0x6f, 0x9a, 0x5a,
+  0x0a, 0xee, 0xa4, 0x56, 0xf9, 0xcf, 0x96, 0xf2, 0x08, 0xf7, 0x7b, 0xc9, 0x54, 0x17, 0xab, 0x03,
+  0xf8, 0xe1, 0xfa, 0xf2, 0x82, 0x60, 0x19, 0x8a, 0x4d, 0x96, 0xab, 0x34, 0xe4, 0x75, 0x94, 0xdc,
+  0xaf, 0x33, 0x4d, 0x70, 0xa8, 0x2c, 0xd7, 0x60, 0x7a, 0x74, 0x99, 0xb7, 0xe3, 0x8b, 0x75, 0x88,
+  0x98, 0x18, 0x9d, 0x2c, 0x21, 0x5d, 0xeb, 0xe9, 0x5b, 0x78, 0xf5, 0x2a, 0x5a, 0xcd, 0x6c, 0x2b,
+  0x04, 0x5a, 0x3b, 0xf2, 0x65, 0xb4, 0x26, 0x49, 0xd4, 0xc4, 0xff, 0x05, 0x25, 0xd0, 0x9b, 0x08,
+  0xc7, 0x10, 0x05, 0xd9, 0x36, 0x99, 0x52, 0x51, 0x67, 0x7d, 0x77, 0x73, 0x7e, 0xe6, 0xe5, 0xfe,
+  0xfa, 0xfd, 0x57, 0x38, 0xee, 0xc0, 0xb7, 0x86, 0x3f, 0xfc, 0xf1, 0xf0, 0x49, 0x83, 0xe5, 0xf5,
+  0x82, 0x7f, 0x05, 0x3f, 0xa2, 0x54, 0x52, 0x48, 0xae, 0xa8, 0x93, 0x71, 0x0e, 0xaf, 0xc1, 0xe2,
+  0xac, 0xa5, 0x17, 0x9b, 0x65, 0x19, 0x1b, 0x4c, 0x4e, 0x9f, 0x57, 0x22, 0xfd, 0x46, 0xce, 0x51,
+  0xb7, 0x2e, 0x4d, 0x43, 0xdb, 0xc2, 0x52, 0x92, 0x85, 0x65, 0x46, 0x02, 0x1d, 0xab, 0x59, 0x65,
+  0xb0, 0xf4, 0x2a, 0x39, 0x1b, 0x13, 0xb7, 0xf0, 0x7a, 0x7f, 0x7f, 0x9f, 0xb8, 0xb9, 0x07, 0xac,
+  0x29, 0x91, 0xcf, 0x05, 0x87, 0xc6, 0x68, 0x33, 0x14, 0xda, 0x6f, 0x30, 0x21, 0x11, 0x4a, 0x24,
+  0x7c, 0xdd, 0x31, 0xe9, 0xa9, 0x9b, 0x13, 0x1d, 0x7c, 0x86, 0xf0, 0xe1, 0x03, 0xb0, 0x53, 0x5e,
+  0x57, 0x1c, 0x14, 0x8f, 0x6d, 0xd9, 0x33, 0xe0, 0xdb, 0xf5, 0x05, 0xe1, 0x3d, 0x2d, 0xdb, 0x92,
+  0x13, 0x6c, 0x82, 0x4f, 0x01, 0x50, 0x7c, 0xa2, 0xa2, 0x71, 0xe5, 0x21, 0xfa, 0x34, 0xbd, 0x20,
+  0xdd, 0xff, 0x4b, 0xb0, 0x50, 0xa0, 0x8f, 0x06, 0xdf, 0x53, 0x1c, 0x21, 0xf0, 0x4e, 0xb1, 0x0f,
+  0xfb, 0x3f, 0x07, 0x46, 0xd4, 0xd0, 0x88, 0x3f, 0xd7, 0x54, 0xfa, 0xdc, 0xe4, 0x34, 0x0f, 0x6a,
+  0xc7, 0x0d, 0x95, 0x86, 0xaa, 0xb8, 0x25, 0x67, 0x82, 0x1b, 0x83, 0x33, 0x3a, 0x31, 0x58, 0xa0,
+  0xdd, 0x4c, 0xfd, 0xa7, 0x83, 0xfd, 0xe4, 0xf2, 0x3c, 0xb6, 0xdb, 0x19, 0x51, 0x83, 0x05, 0x35,
+  0x67, 0x2c, 0x92, 0xd8, 0x40, 0x7e, 0x9e, 0xbd, 0x93, 0xa5, 0x1c, 0x1a, 0xc8, 0x9b, 0x99, 0x37,
+  0xde, 0xd2, 0xba, 0xee, 0xa6, 0xd1, 0xe0, 0xf8, 0x7f, 0x34, 0xaf, 0xc6, 0x5f, 0xde, 0x4f, 0xb6,
+  0xd2, 0xcb, 0xab, 0x08, 0xe5, 0xb3, 0x1b, 0x4a, 0x54, 0x5c, 0xcd, 0xd0, 0xc3, 0xef, 0x77, 0x53,
+  0x8f, 0x3c, 0x73, 0x34, 0x47, 0x08, 0x06, 0x66, 0xc4, 0x11, 0xd9, 0xcd, 0x44, 0x85, 0xe2, 0x96,
+  0x08, 0xfd, 0x16, 0x98, 0xc3, 0xf7, 0x8e, 0x01, 0x65, 0x68, 0x1d, 0xc2, 0xb8, 0x23, 0xf7, 0x59,
+  0x1c, 0x21, 0xb8, 0x7f, 0x80, 0x24, 0x28, 0xfc, 0x1b, 0x2c, 0xbe, 0x66, 0x2f, 0xd0, 0xd1, 0xc9,
+  0xad, 0xf5, 0x23, 0x2b, 0x26, 0xff, 0x6d, 0x6b, 0x45, 0x9f, 0x61, 0x78, 0x27, 0x4f, 0x25, 0xf8,
+  0x1a, 0xd2, 0xea, 0xe1, 0xcf, 0x05, 0x4a, 0x9b, 0x84, 0x45, 0x5d, 0xb6, 0x4a, 0xf8, 0x0e, 0x87,
+  0x5d, 0x23, 0x84, 0xe9, 0xd1, 0xcc, 0xfe, 0xfc, 0xb8, 0x16, 0x7c, 0x6b, 0x69, 0x16, 0xdc, 0xf1,
+  0xed, 0x41, 0xba, 0x9e, 0xa1, 0x71, 0xe1, 0x77, 0xdb, 0x76, 0x30, 0xdd, 0xb4, 0x4b, 0xc3, 0x4e,
+  0xee, 0x5a, 0xbb, 0x7b, 0xda, 0x6d, 0x1f, 0x8a, 0xd8, 0x7b, 0xc9, 0x54, 0x44, 0x9a, 0xd1, 0xb7,
+  0xcb, 0x84, 0x13, 0x1e, 0xaf, 0xba, 0x5d, 0x95, 0xba, 0xd9, 0xf1, 0x24, 0x0c, 0x72, 0x87, 0xd1,
+  0x59, 0xca, 0xe8, 0x56, 0x86, 0x75, 0x4f, 0x4f, 0x61, 0x09, 0x92, 0xb4, 0xb7, 0x11, 0x4e, 0x3c,
+  0xd3, 0xb1, 0xea, 0xd7, 0xe7, 0x11, 0x0e, 0xed, 0x1a, 0x54, 0xc5, 0x71, 0x25, 0xeb, 0x22, 0x25,
+  0xd1, 0x48, 0x77, 0x7f, 0x39, 0x90, 0xeb, 0x98, 0xea, 0x17, 0x7d, 0x48, 0x78, 0xa7, 0xc1, 0x62,
+  0xf7, 0x1a, 0x7c, 0x6c, 0x86, 0xd5, 0x28, 0x86, 0xa9, 0x69, 0x2e, 0x74, 0x63, 0x83, 0x8e, 0xba,
+  0xae, 0x4f, 0x0e, 0xf3, 0xf8, 0x81, 0x77, 0x98, 0xfb, 0xfd, 0x47, 0x7f, 0x95, 0x9b, 0xd7, 0x47,
+  0x7f, 0x03,
+};
+
+static const WebAssetPart web_asset_setup_parts[] = {
+  { 10, 1501, 3944, 0x0740a7f7, WEB_FIELD_DEVICE_ID },
+  { 1511, 10, 4, 0x83b72abb, WEB_FIELD_FW_VERSION },
+  { 1521, 961, 2563, 0x0fc8399a, WEB_FIELD_NONE },
+};
+
+const WebAsset WEB_ASSET_SETUP = { "text/html; charset=utf-8", "b728fccc90f01e5b", web_asset_setup_gz, web_asset_setup_parts, 3 };
+
+// webota.html: 7088 bytes -> 5369 minificado -> 2252 gzip
+static const uint8_t web_asset_webota_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0x8c, 0x56, 0x5d, 0x6e, 0xe3, 0x36,
+  0x10, 0xbe, 0x0a, 0xab, 0x60, 0xb1, 0xeb, 0xc2, 0xb2, 0xf5, 0x63, 0x3b, 0xb2, 0x2c, 0x1b, 0xd8,
+  0xb4, 0x0d, 0xb0, 0x0f, 0xc5, 0x16, 0xcd, 0x2e, 0x8a, 0x45, 0xd1, 0x07, 0x4a, 0x1c, 0xd9, 0x6c,
+  0x68, 0x51, 0xa5, 0x28, 0x27, 0x5e, 0xc3, 0x17, 0x28, 0x7a, 0x87, 0x3e, 0xf4, 0xa1, 0x07, 0xd9,
+  0x0b, 0xf5, 0x08, 0x1d, 0xea, 0x27, 0x96, 0xec, 0x04, 0xd8, 0x24, 0x50, 0xc4, 0x11, 0x67, 0xbe,
+  0xe1, 0x37, 0xdf, 0x90, 0x8c, 0xbe, 0xf9, 0xfe, 0xfd, 0x77, 0x1f, 0x3e, 0xfd, 0xf4, 0x03, 0xd9,
+  0xe8, 0xad, 0x58, 0x45, 0xcd, 0x13, 0x28, 0x5b, 0x45, 0x5b, 0xd0, 0x94, 0x24, 0x1b, 0xaa, 0x0a,
+  0xd0, 0x4b, 0xeb, 0xe3, 0x87, 0x5b, 0x3b, 0xb0, 0x1a, 0x6b, 0x46, 0xb7, 0xb0, 0xb4, 0x76, 0x1c,
+  0x1e, 0x72, 0xa9, 0xb4, 0x45, 0x12, 0x99, 0x69, 0xc8, 0x70, 0xd6, 0x03, 0x67, 0x7a, 0xb3, 0x64,
+  0xb0, 0xe3, 0x09, 0xd8, 0xd5, 0x60, 0x48, 0x78, 0xc6, 0x35, 0xa7, 0xc2, 0x2e, 0x12, 0x2a, 0x60,
+  0xe9, 0x8e, 0x1c, 0x8c, 0xa2, 0xb9, 0x16, 0xb0, 0xfa, 0x19, 0x20, 0xbd, 0x11, 0x25, 0xdc, 0xdd,
+  0xef, 0xc9, 0xfb, 0x0f, 0x6f, 0xc9, 0xc7, 0x9c, 0x51, 0x0d, 0xd1, 0xb8, 0xfe, 0x1a, 0x15, 0x7a,
+  0x8f, 0xff, 0xbe, 0x3d, 0x6c, 0xa9, 0x5a, 0xf3, 0x2c, 0x74, 0x16, 0x39, 0x65, 0x8c, 0x67, 0x6b,
+  0x7c, 0x8b, 0xe5, 0xa3, 0x5d, 0xf0, 0xcf, 0x66, 0x10, 0x4b, 0xc5, 0x40, 0xd9, 0x68, 0x39, 0xc6,
+  0x92, 0xed, 0x0f, 0x29, 0xe6, 0x62, 0xa7, 0x74, 0xcb, 0xc5, 0x3e, 0xb4, 0x69, 0x9e, 0x0b, 0xb0,
+  0x8b, 0x7d, 0xa1, 0x61, 0x3b, 0xbc, 0x11, 0x3c, 0xbb, 0xff, 0x91, 0x26, 0x77, 0xd5, 0xf0, 0x16,
+  0xe7, 0x0d, 0x5f, 0xdf, 0xc1, 0x5a, 0x02, 0xf9, 0xf8, 0xee, 0xf5, 0xb0, 0xa0, 0x59, 0x61, 0x17,
+  0xa0, 0x78, 0xba, 0x88, 0x69, 0x72, 0xbf, 0x56, 0xb2, 0xcc, 0x58, 0x88, 0x2e, 0x40, 0x95, 0xbd,
+  0x56, 0x94, 0x71, 0x5c, 0xe1, 0x1b, 0xd7, 0x9f, 0x32, 0x58, 0x0f, 0xaf, 0x9c, 0xd4, 0xbd, 0xf6,
+  0x28, 0x71, 0x5e, 0xe1, 0xab, 0xe7, 0xcc, 0xdc, 0x6b, 0xe2, 0x3a, 0xce, 0xab, 0xc1, 0x62, 0xcb,
+  0x33, 0x7b, 0x03, 0x7c, 0xbd, 0xd1, 0x21, 0x1a, 0x76, 0x9b, 0x05, 0xe3, 0x45, 0x2e, 0xe8, 0x3e,
+  0x4c, 0x05, 0x3c, 0x2e, 0xa8, 0xe0, 0xeb, 0xcc, 0xe6, 0x88, 0x5e, 0x84, 0x09, 0x86, 0x03, 0xb5,
+  0xf8, 0xbd, 0x2c, 0x34, 0x4f, 0xf7, 0x76, 0x43, 0x61, 0x6b, 0x4e, 0xa4, 0x90, 0x2a, 0xbc, 0x4a,
+  0xdd, 0x74, 0x9a, 0xce, 0x9f, 0x16, 0xee, 0x39, 0xf9, 0xe3, 0x71, 0x64, 0xa6, 0x52, 0xcc, 0x4b,
+  0x1d, 0x3a, 0x89, 0x5e, 0xb9, 0xe0, 0xcd, 0xfd, 0x78, 0xd1, 0xd0, 0x61, 0xf2, 0x2d, 0x8b, 0xd0,
+  0xf5, 0xf2, 0xc7, 0x27, 0xef, 0x09, 0x7a, 0x2f, 0xb6, 0xf4, 0xb1, 0x2e, 0x4c, 0x38, 0x75, 0xcc,
+  0xb8, 0x7e, 0x37, 0xc9, 0xd7, 0xa4, 0x6e, 0x28, 0x93, 0x0f, 0xa1, 0x43, 0x0c, 0x14, 0x99, 0x99,
+  0x87, 0x5a, 0xc7, 0xf4, 0x8d, 0x33, 0xac, 0x7e, 0x47, 0x93, 0x41, 0x83, 0x10, 0xba, 0xf8, 0xa9,
+  0x90, 0x82, 0xb3, 0x7a, 0xc2, 0x74, 0x36, 0x74, 0x83, 0xf9, 0xd0, 0x9b, 0x04, 0x38, 0xcb, 0x1b,
+  0x1c, 0x37, 0x6e, 0x5d, 0x09, 0xac, 0x12, 0x84, 0x5e, 0x50, 0x21, 0x9b, 0x32, 0x62, 0xa1, 0xb4,
+  0x96, 0x5b, 0x44, 0x44, 0x53, 0xb3, 0x4a, 0x3f, 0x88, 0x59, 0x1a, 0x2c, 0x34, 0x3c, 0x6a, 0xbb,
+  0xa2, 0xa8, 0x61, 0xe1, 0x38, 0x2a, 0xca, 0xb8, 0x12, 0xc3, 0xe1, 0xe2, 0x5b, 0xeb, 0x9b, 0xc4,
+  0x6c, 0x0a, 0xee, 0x59, 0x70, 0xdf, 0x04, 0x3f, 0xc1, 0xbb, 0x13, 0x43, 0x5b, 0x2a, 0xd5, 0xd6,
+  0x36, 0x6c, 0xe5, 0x87, 0xfe, 0xec, 0x8a, 0x55, 0x41, 0x63, 0x10, 0x87, 0xb6, 0x5a, 0xb1, 0x90,
+  0xc9, 0xfd, 0x59, 0xd0, 0xa0, 0x8d, 0xf9, 0x50, 0xd7, 0x17, 0xf9, 0xeb, 0x27, 0x71, 0xe4, 0x59,
+  0x5e, 0xea, 0x5f, 0xf5, 0x3e, 0xc7, 0xe6, 0x48, 0xb9, 0x00, 0xeb, 0xb7, 0xb3, 0x80, 0x1d, 0xb2,
+  0xdb, 0xa2, 0x54, 0x15, 0xea, 0xd6, 0xb1, 0x56, 0x56, 0xcb, 0x32, 0x7e, 0x25, 0x8c, 0x16, 0x1b,
+  0x60, 0xa4, 0xa5, 0xa9, 0x5f, 0xe1, 0xe0, 0x44, 0x63, 0x23, 0x96, 0xa4, 0x54, 0x05, 0x0e, 0x73,
+  0xc9, 0x2b, 0x9e, 0xb4, 0x42, 0x61, 0x63, 0x07, 0xca, 0x2c, 0xa4, 0x42, 0x10, 0x67, 0xe4, 0x17,
+  0x04, 0x68, 0x01, 0xcf, 0x64, 0x1b, 0x6e, 0xe4, 0xee, 0x4c, 0x55, 0xbe, 0x3f, 0x71, 0xa7, 0xd3,
+  0x16, 0xb3, 0x01, 0x72, 0xbc, 0x60, 0x92, 0x5c, 0x1f, 0x47, 0xb1, 0xce, 0x0e, 0x5f, 0xb3, 0xa4,
+  0x26, 0xf1, 0xd6, 0xbb, 0xb7, 0xc0, 0x4c, 0x66, 0xf0, 0xcc, 0x92, 0xba, 0x44, 0xcf, 0x90, 0xe8,
+  0x4e, 0x31, 0x67, 0x66, 0xc5, 0x5f, 0xb9, 0x46, 0x93, 0xe2, 0x33, 0xab, 0xaa, 0x17, 0x50, 0xbb,
+  0x19, 0x59, 0x84, 0xd5, 0x9b, 0xc0, 0xcd, 0xe7, 0xd3, 0x1b, 0x1b, 0xb3, 0x1f, 0xf4, 0x7b, 0x01,
+  0x13, 0xaa, 0xfb, 0xe1, 0x52, 0xe9, 0xfe, 0xa0, 0xc6, 0xc0, 0x3a, 0xd3, 0x58, 0x00, 0xeb, 0xc1,
+  0xcc, 0x26, 0xd7, 0x93, 0x20, 0x6e, 0x93, 0xcd, 0xa4, 0x51, 0xb0, 0x90, 0x0f, 0xc0, 0x16, 0x32,
+  0xa7, 0x09, 0xd7, 0xfb, 0xd0, 0x19, 0xcd, 0x50, 0xe4, 0x9a, 0xea, 0xb2, 0x68, 0x45, 0xa9, 0x65,
+  0x5e, 0x29, 0xf2, 0x44, 0xe7, 0xd4, 0xd0, 0x79, 0xc1, 0x50, 0xab, 0xac, 0x8a, 0xc0, 0x73, 0xad,
+  0xd7, 0x21, 0x47, 0x3c, 0x4b, 0x65, 0x37, 0xa3, 0xcb, 0xfc, 0xdd, 0xc1, 0x59, 0x13, 0x7e, 0x45,
+  0x77, 0xfb, 0x83, 0x45, 0x4f, 0xd6, 0x4f, 0x70, 0x45, 0x99, 0x24, 0x50, 0x14, 0x17, 0x88, 0xfe,
+  0x64, 0xe8, 0xce, 0xaf, 0x87, 0xf3, 0x49, 0x0f, 0xd0, 0xf3, 0x92, 0xe9, 0x14, 0x5e, 0x00, 0xec,
+  0xba, 0xbc, 0x88, 0x07, 0x4a, 0x49, 0x75, 0x81, 0xe6, 0xf9, 0xf3, 0xe1, 0x2c, 0x30, 0x7f, 0x5d,
+  0x34, 0x48, 0x27, 0xf8, 0xf3, 0x02, 0x5a, 0xd7, 0xe5, 0x12, 0x2d, 0x57, 0x72, 0xad, 0x70, 0x5d,
+  0x76, 0x4c, 0x55, 0x57, 0xef, 0xcd, 0x3e, 0x3f, 0x3b, 0x57, 0x7b, 0xaf, 0x65, 0x9a, 0x8a, 0xf9,
+  0xa7, 0x0d, 0xd0, 0x14, 0xb8, 0xda, 0xfd, 0x8c, 0x2c, 0x53, 0xd4, 0x43, 0xb8, 0xe1, 0x8c, 0x41,
+  0xd6, 0x01, 0xc2, 0x76, 0x14, 0x87, 0xd3, 0x31, 0xf2, 0xea, 0xb9, 0x6e, 0xaa, 0x13, 0xc1, 0x6f,
+  0x1d, 0xf1, 0x57, 0x36, 0x94, 0xbf, 0xd7, 0xca, 0xdf, 0xf4, 0xb5, 0x39, 0xac, 0x0f, 0x0d, 0x0b,
+  0xf3, 0x09, 0xf5, 0xe3, 0xa0, 0x2b, 0x17, 0xaf, 0x9f, 0x58, 0x60, 0xd4, 0xd3, 0x9c, 0xdf, 0x95,
+  0x7a, 0xba, 0xaa, 0x34, 0x42, 0x7c, 0x71, 0x23, 0x6e, 0xc4, 0xde, 0x09, 0x8d, 0x24, 0x1f, 0xa3,
+  0x71, 0x7d, 0x8a, 0x47, 0xe3, 0xfa, 0x52, 0x61, 0x8e, 0xe8, 0x55, 0xc4, 0xf8, 0x8e, 0x24, 0x82,
+  0x16, 0xc5, 0xd2, 0x7a, 0x3a, 0xcc, 0xf0, 0x56, 0xb0, 0x71, 0x57, 0xff, 0xfd, 0xfd, 0xd7, 0x9f,
+  0xe4, 0xec, 0x5e, 0x80, 0xbe, 0xee, 0x2a, 0xca, 0x5b, 0x8f, 0xf6, 0x4c, 0xb0, 0x56, 0x6f, 0x75,
+  0x89, 0x99, 0x7c, 0xa6, 0x5f, 0xfe, 0xfd, 0xf2, 0x8f, 0x24, 0x0c, 0xc8, 0x2d, 0x57, 0xdb, 0x07,
+  0xaa, 0x80, 0xec, 0x38, 0x25, 0xbf, 0x40, 0x1c, 0x8d, 0xf3, 0x55, 0x64, 0x1a, 0x9c, 0x70, 0xb6,
+  0xb4, 0xa4, 0xa6, 0xb7, 0xf8, 0x6e, 0x11, 0xc8, 0x92, 0x7a, 0xdb, 0xdb, 0x96, 0x42, 0xf3, 0x9c,
+  0x2a, 0x3d, 0xae, 0x0e, 0x07, 0xbc, 0x7d, 0x50, 0xab, 0x97, 0xdd, 0xe9, 0xcc, 0x40, 0x7b, 0x75,
+  0x44, 0x10, 0x34, 0x99, 0xfd, 0xb2, 0x06, 0xb2, 0x56, 0x77, 0x20, 0x20, 0x41, 0xee, 0x81, 0x48,
+  0x42, 0xd5, 0x1f, 0x25, 0xdf, 0x49, 0x32, 0x8a, 0xf1, 0xba, 0x12, 0x8d, 0xab, 0xf9, 0xab, 0xa8,
+  0xda, 0x67, 0x49, 0x67, 0x9f, 0xad, 0x92, 0x79, 0x8a, 0xd0, 0x5c, 0xa6, 0x4e, 0x63, 0x8a, 0x4d,
+  0x94, 0xe3, 0x5d, 0xca, 0x44, 0xb1, 0x88, 0x02, 0x8c, 0xa9, 0x80, 0xf5, 0xd3, 0x6a, 0xca, 0xda,
+  0x86, 0x6a, 0x46, 0xc8, 0x32, 0x4e, 0x6a, 0x9f, 0x71, 0x89, 0xc7, 0x56, 0xd6, 0x00, 0x23, 0x69,
+  0x5b, 0x6e, 0x6e, 0x6a, 0x75, 0x00, 0xdc, 0xb2, 0x6a, 0xdf, 0xda, 0x7e, 0x83, 0xc3, 0xd5, 0xbb,
+  0x8c, 0x27, 0x9c, 0x2a, 0xd2, 0x63, 0x35, 0x1a, 0xd7, 0x61, 0x6a, 0xf8, 0xca, 0xa3, 0xea, 0xbd,
+  0xa7, 0x48, 0xcd, 0xb0, 0x05, 0xed, 0x24, 0xd9, 0x6d, 0x9b, 0x1a, 0xac, 0xb5, 0xdc, 0x18, 0x43,
+  0xa5, 0x8b, 0xa5, 0xd5, 0xf6, 0x1a, 0xa9, 0xf6, 0x31, 0xeb, 0xf9, 0x08, 0xa6, 0x1f, 0xfa, 0x21,
+  0x6e, 0x8d, 0xa5, 0xbf, 0xde, 0xaa, 0x86, 0x3d, 0xff, 0x8e, 0x8e, 0xad, 0xd5, 0xff, 0x00, 0x00,
+  0x00, 0xff, 0xff, 0x52, 0x38, 0xb4, 0x5d, 0xc1, 0xb1, 0xa4, 0x34, 0x31, 0xc7, 0x4a, 0x01, 0x00,
+  0x00, 0x00, 0xff, 0xff, 0x95, 0x56, 0xcd, 0x72, 0x1b, 0x45, 0x10, 0xbe, 0xfb, 0x29, 0x26, 0x07,
+  0x6a, 0x76, 0x89, 0x6a, 0xa4, 0x04, 0x4e, 0xd8, 0x32, 0x85, 0x62, 0xbb, 0x48, 0x25, 0x06, 0x2a,
+  0x76, 0x15, 0x54, 0xb9, 0x7c, 0x18, 0xed, 0xb6, 0xb4, 0x53, 0xde, 0x9d, 0xd9, 0xcc, 0xcc, 0x4a,
+  0x56, 0x88, 0x6f, 0x70, 0xe3, 0xc6, 0x15, 0x8a, 0x03, 0x8f, 0xc2, 0x9b, 0xe4, 0x09, 0x78, 0x04,
+  0xba, 0x67, 0x7f, 0x34, 0x96, 0x8d, 0x08, 0x17, 0x49, 0xbb, 0xf3, 0x75, 0xf7, 0xd7, 0x5f, 0xff,
+  0x8c, 0x8e, 0xc6, 0xb9, 0x5a, 0x1d, 0x1f, 0xb5, 0x9f, 0x2e, 0xb3, 0xaa, 0xf6, 0xc7, 0x07, 0x99,
+  0xd1, 0xce, 0xb3, 0x85, 0xb1, 0x15, 0x9b, 0xb2, 0xdc, 0x64, 0x4d, 0x05, 0xda, 0x8b, 0x25, 0xf8,
+  0xd3, 0x12, 0xe8, 0xe7, 0x6c, 0xf3, 0x32, 0x4f, 0xb8, 0xf1, 0xf2, 0x0c, 0x21, 0x3c, 0x3d, 0xec,
+  0x0d, 0x54, 0x09, 0x2f, 0x75, 0xdd, 0xf8, 0x7d, 0x56, 0x0b, 0x65, 0xab, 0xb5, 0xb4, 0xb0, 0x35,
+  0x73, 0xcd, 0xbc, 0x52, 0x7e, 0xe6, 0xf5, 0x3e, 0xb3, 0x01, 0x14, 0xd9, 0x79, 0xe9, 0x1b, 0x77,
+  0xa2, 0x56, 0x7b, 0xed, 0x02, 0x68, 0x6b, 0x54, 0x5b, 0xb3, 0xb4, 0xe0, 0xdc, 0x4c, 0xda, 0x7d,
+  0x66, 0x11, 0xec, 0xa1, 0xed, 0x99, 0x2a, 0xcb, 0x8f, 0x31, 0x26, 0xdc, 0x7d, 0x75, 0xb4, 0xac,
+  0xe0, 0x3f, 0x08, 0xf7, 0x30, 0x32, 0x1c, 0x04, 0x15, 0x32, 0xcf, 0x4f, 0x57, 0x88, 0x79, 0xad,
+  0x9c, 0x07, 0x0d, 0x36, 0xe1, 0x59, 0x21, 0xf5, 0x12, 0xf8, 0x88, 0x25, 0x90, 0xb2, 0xe9, 0x31,
+  0xfb, 0x71, 0x27, 0x0c, 0xc6, 0x00, 0xe1, 0xa5, 0x45, 0xff, 0x82, 0xde, 0xb9, 0xab, 0xc9, 0xf5,
+  0x97, 0x22, 0x9c, 0xbc, 0x7f, 0xcf, 0x38, 0x3f, 0x3c, 0x50, 0x0b, 0x96, 0xf4, 0xe8, 0x14, 0xed,
+  0x23, 0x82, 0xc2, 0xc3, 0xad, 0x7f, 0x61, 0x34, 0xc6, 0xa2, 0x62, 0xf2, 0xbf, 0xff, 0xf8, 0xf5,
+  0x27, 0xc6, 0xd9, 0xd3, 0xc1, 0xfb, 0xe1, 0xc1, 0x1d, 0x83, 0xd2, 0xc1, 0x7e, 0x33, 0x0c, 0x72,
+  0x77, 0x70, 0x47, 0x89, 0x60, 0x9f, 0x3c, 0x92, 0x43, 0x5b, 0x54, 0xcc, 0x41, 0xba, 0x8d, 0xce,
+  0xb6, 0x99, 0x80, 0xa8, 0x2d, 0x10, 0xf4, 0x04, 0x16, 0xb2, 0x29, 0x7d, 0x72, 0x4f, 0x44, 0xf4,
+  0xbc, 0x15, 0xa6, 0x4f, 0xad, 0x4d, 0xe7, 0x09, 0x3d, 0x52, 0x2e, 0xae, 0x30, 0xeb, 0x8b, 0x50,
+  0xfa, 0x84, 0x5f, 0x40, 0x09, 0x99, 0x32, 0x1a, 0x58, 0x53, 0x31, 0x69, 0xdf, 0x36, 0x6a, 0x65,
+  0x98, 0x98, 0x2b, 0x8d, 0x81, 0x39, 0x58, 0x6b, 0x42, 0x89, 0x2d, 0xf8, 0xc6, 0x6a, 0x22, 0x3c,
+  0x38, 0x0a, 0x6a, 0x09, 0xd0, 0xb9, 0xfb, 0x5e, 0xf9, 0x22, 0xe1, 0xc1, 0x26, 0xdd, 0x75, 0xff,
+  0x55, 0xe7, 0x31, 0x47, 0xc6, 0xcc, 0x83, 0x65, 0xa8, 0x01, 0x68, 0xf7, 0xd7, 0x9f, 0x7b, 0x83,
+  0x6c, 0x47, 0xec, 0x44, 0x7a, 0x89, 0x29, 0x69, 0x58, 0xb3, 0xb3, 0xee, 0x31, 0xe9, 0x24, 0xa3,
+  0xdf, 0x42, 0xd6, 0x35, 0x52, 0x88, 0x06, 0x67, 0x14, 0xd2, 0x47, 0xc8, 0x30, 0x13, 0x22, 0x57,
+  0x4e, 0xce, 0x4b, 0xc8, 0xd1, 0x8f, 0xb7, 0x0d, 0x56, 0x27, 0xea, 0x5f, 0xe1, 0xfc, 0x06, 0x73,
+  0x41, 0x48, 0x5d, 0xca, 0x0d, 0x95, 0x65, 0x5e, 0x9a, 0xec, 0x86, 0x6f, 0x41, 0xd4, 0xa7, 0x1d,
+  0x6a, 0xad, 0x72, 0x5f, 0x10, 0x66, 0xf2, 0x09, 0x02, 0xe2, 0x34, 0x4f, 0xf5, 0x4a, 0x49, 0x9d,
+  0x1b, 0xd6, 0xf3, 0x10, 0x42, 0xb4, 0x2d, 0x81, 0x44, 0x25, 0x36, 0xaf, 0x07, 0x17, 0xda, 0x49,
+  0x38, 0xf5, 0x0e, 0x52, 0xcc, 0x5a, 0xe9, 0x85, 0xa1, 0xa4, 0xbd, 0xdd, 0x0c, 0xdd, 0x79, 0x5b,
+  0xd8, 0x2e, 0xd7, 0x1f, 0xce, 0x5f, 0x7f, 0xed, 0x7d, 0xfd, 0x06, 0xde, 0x36, 0xe0, 0x42, 0x85,
+  0xf1, 0x4c, 0x34, 0x75, 0x69, 0x64, 0xfe, 0x48, 0xab, 0xf4, 0x5c, 0xe3, 0x86, 0xa7, 0x42, 0x81,
+  0xc0, 0xee, 0x5b, 0xfa, 0xe2, 0x85, 0xa9, 0xb0, 0x1d, 0x48, 0x84, 0x74, 0x08, 0x56, 0x83, 0xcd,
+  0xda, 0x4e, 0x3c, 0x97, 0xbe, 0x10, 0xd6, 0x34, 0xa8, 0x23, 0x59, 0x60, 0x08, 0xd4, 0x6a, 0x4c,
+  0x03, 0x82, 0x4b, 0xac, 0x4c, 0xd9, 0xa7, 0xec, 0xd9, 0x64, 0x92, 0xee, 0x55, 0xa4, 0x77, 0xf6,
+  0x94, 0xf1, 0x5d, 0x69, 0xbe, 0xeb, 0xac, 0xcc, 0x17, 0x41, 0x90, 0x18, 0xc9, 0x92, 0x5d, 0x89,
+  0xfa, 0xf0, 0x29, 0x9d, 0x8f, 0x1f, 0x9e, 0x76, 0x8c, 0xf0, 0x30, 0xe5, 0x91, 0x88, 0xed, 0x1c,
+  0x91, 0x44, 0x0f, 0xb5, 0x21, 0x87, 0xa4, 0x4b, 0x24, 0x0b, 0x01, 0xdb, 0xd5, 0xc7, 0xa6, 0xd3,
+  0x29, 0x7b, 0x8e, 0xd9, 0xed, 0xb4, 0xed, 0x87, 0xdf, 0x7e, 0x66, 0x67, 0x5d, 0x29, 0x19, 0xbe,
+  0x92, 0xa5, 0x7a, 0x27, 0x73, 0xf3, 0x84, 0xbd, 0x01, 0xa5, 0x55, 0x16, 0x6a, 0x8d, 0x25, 0x26,
+  0x0e, 0xae, 0xc9, 0x32, 0x92, 0x7e, 0xbf, 0x40, 0x1c, 0x25, 0x0c, 0xca, 0x80, 0xbf, 0x54, 0x15,
+  0x98, 0xc6, 0x27, 0x3d, 0xa3, 0x38, 0xee, 0x09, 0xf6, 0xa1, 0x71, 0xca, 0xd3, 0xc8, 0xd8, 0x7b,
+  0xa1, 0x58, 0x22, 0x97, 0x8d, 0xb4, 0x39, 0xb0, 0xcf, 0x26, 0xee, 0x7e, 0xf2, 0x23, 0xca, 0x80,
+  0x0a, 0x34, 0x6c, 0x9d, 0xb6, 0xc2, 0x61, 0xb0, 0x2e, 0x71, 0xe0, 0x30, 0x3e, 0xa5, 0x8c, 0xd4,
+  0x6a, 0x3c, 0x80, 0xf0, 0x8a, 0xd6, 0xdc, 0x29, 0x02, 0x70, 0x32, 0x1d, 0xc2, 0x0b, 0x5c, 0x02,
+  0xb9, 0xd9, 0x29, 0xdd, 0x87, 0xdf, 0x7f, 0x61, 0x84, 0x69, 0x2b, 0x37, 0xb8, 0x8b, 0x67, 0xf6,
+  0xd1, 0x29, 0x5b, 0x48, 0xa4, 0xb1, 0xbf, 0x2a, 0xad, 0x83, 0x6d, 0x59, 0x1e, 0x0b, 0x8b, 0xd4,
+  0x18, 0x52, 0x83, 0x5b, 0xda, 0x16, 0x49, 0x1e, 0x49, 0x53, 0x1b, 0x3c, 0xc2, 0xc1, 0xc0, 0x6b,
+  0x2a, 0x52, 0x29, 0xe5, 0x1f, 0xcd, 0xac, 0xe3, 0x65, 0x70, 0x79, 0x60, 0x87, 0x7e, 0x7b, 0x71,
+  0x49, 0xa6, 0xe3, 0x35, 0xcc, 0xb1, 0xbf, 0x78, 0x77, 0xe8, 0x68, 0xb1, 0xf4, 0x8b, 0x26, 0xa8,
+  0x9b, 0x49, 0x9f, 0x15, 0x38, 0x55, 0x14, 0x22, 0xfd, 0x17, 0xd2, 0x91, 0x56, 0xa2, 0xc2, 0x5e,
+  0x90, 0x4b, 0xf8, 0x7f, 0x7a, 0x2d, 0x1a, 0x9d, 0x79, 0x5c, 0xc8, 0x2c, 0xf2, 0x5e, 0xb9, 0xe5,
+  0x88, 0xf9, 0x4d, 0xdd, 0x6e, 0xef, 0xfe, 0x66, 0xdf, 0xb9, 0x50, 0x10, 0x74, 0x18, 0x1d, 0x66,
+  0xa5, 0x74, 0xee, 0x9b, 0xf6, 0xae, 0xeb, 0x2e, 0xfa, 0x40, 0x8d, 0xdc, 0x50, 0xac, 0x21, 0x4e,
+  0x3c, 0x61, 0x73, 0xfa, 0x4c, 0xbb, 0x31, 0x09, 0x0f, 0x61, 0x42, 0x70, 0x3e, 0xda, 0xe5, 0x8c,
+  0xab, 0x8f, 0x05, 0x24, 0xef, 0xef, 0x9c, 0x1b, 0x74, 0xff, 0x6c, 0xf2, 0xfc, 0xf3, 0xe1, 0x7f,
+  0x07, 0xee, 0x37, 0x34, 0x62, 0x57, 0xbc, 0xc5, 0x61, 0xf2, 0xaf, 0x66, 0xf4, 0x79, 0x3e, 0xe3,
+  0xd7, 0x3d, 0x48, 0xf5, 0x5b, 0x67, 0x51, 0x1a, 0x63, 0x93, 0xf0, 0xb3, 0x34, 0xcb, 0x3e, 0xfc,
+  0x98, 0x0d, 0x6f, 0x6e, 0xd2, 0xe1, 0x62, 0x88, 0xf7, 0x54, 0x4b, 0xad, 0xc3, 0xd5, 0x66, 0x9d,
+  0xdc, 0x8c, 0x98, 0xea, 0x37, 0x15, 0xbe, 0xc7, 0x2f, 0x5a, 0x12, 0x21, 0xe1, 0xc0, 0xe8, 0x4a,
+  0x5d, 0x53, 0xd2, 0x47, 0xe3, 0xee, 0x5f, 0xdc, 0xd1, 0x78, 0x6e, 0xf2, 0x0d, 0x7e, 0x15, 0xbe,
+  0x2a, 0x8f, 0xff, 0x01,
+};
+
+static const WebAssetPart web_asset_webota_parts[] = {
+  { 10, 1209, 2795, 0x9a9afa4a, WEB_FIELD_DEVICE_ID },
+  { 1219, 17, 11, 0xdb4f2d93, WEB_FIELD_FW_VERSION },
+  { 1236, 1008, 2536, 0x53ac3731, WEB_FIELD_NONE },
+};
+
+const WebAsset WEB_ASSET_WEBOTA = { "text/html; charset=utf-8", "ac3bba71a5e66854", web_asset_webota_gz, web_asset_webota_parts, 3 };
@@ -2,6 +2,7 @@
 //WiFiSetup.cpp
 
 #include "WiFiSetup.h" 
+#include "WebAssets.h"
 #include <WiFi.h> 
 
 const int MAX_NETS = 10;
@@ -71,7 +72,7 @@ bool WiFiSetup::createAccessPoint() {
     
     // Configurar rotas HTTP
     server.on("/", HTTP_GET, [this]() {
-        server.send(200, "text/html; charset=utf-8", getConfigHTML());
+        webAssetSend(server, WEB_ASSET_SETUP);
     });
     
     server.on("/api/setup", HTTP_POST, [this]() {
@@ -87,7 +88,7 @@ bool WiFiSetup::createAccessPoint() {
         WiFi.mode(WIFI_AP_STA);
         WiFi.disconnect();      
         int n = WiFi.scanNetworks(false);
-        DynamicJsonDocument doc(1024);
+        JsonDoc doc(1024);
         JsonArray arr = doc.createNestedArray("networks");
         for (int i = 0; i < n; i++) {
           arr.add(WiFi.SSID(i));
@@ -98,10 +99,11 @@ bool WiFiSetup::createAccessPoint() {
       });
         
     server.onNotFound([this]() {
-    server.send(200, "text/html; charset=utf-8", getConfigHTML());
+        webAssetSend(server, WEB_ASSET_SETUP);
     });
 
-    // Iniciar servidor web
+    // Iniciar servidor web (If-None-Match para o 304 das páginas)
+    webAssetCollectHeaders(server);
     server.begin();
     Serial.println("[WiFiSetup] Servidor web iniciado na porta 80");
     portalActive = true;
@@ -120,7 +122,7 @@ bool WiFiSetup::connectToWiFi() {
     return false;
   }
 
-  DynamicJsonDocument doc(4096);
+  JsonDoc doc(4096);
   DeserializationError err = deserializeJson(doc, file);
   file.close();
   if (err) {
@@ -247,7 +249,7 @@ bool WiFiSetup::loadConfigFromSPIFFS() {
     return false;
   }
 
-  DynamicJsonDocument doc(4096);
+  JsonDoc doc(4096);
   DeserializationError error = deserializeJson(doc, file);
   file.close();
 
@@ -297,7 +299,7 @@ bool WiFiSetup::loadConfigFromSPIFFS() {
   return true;
 }
 
-bool WiFiSetup::saveConfigToSPIFFS(const DynamicJsonDocument& config) {
+bool WiFiSetup::saveConfigToSPIFFS(const JsonDocument& config) {
     Serial.printf("[WiFiSetup] Salvando configuração em %s\n", CONFIG_FILE);
     
     File file = SPIFFS.open(CONFIG_FILE, "w");
@@ -326,7 +328,7 @@ void WiFiSetup::handleConfigSubmit() {
     return;
   }
 
-  DynamicJsonDocument doc(1024);
+  JsonDoc doc(1024);
   DeserializationError error = deserializeJson(doc, server.arg("plain"));
 
   if (error) {
@@ -388,7 +390,7 @@ void WiFiSetup::handleConfigSubmit() {
   }
 
   // ======== RECONSTRÓI JSON A PARTIR DO VETOR ========
-  DynamicJsonDocument full(4096);
+  JsonDoc full(4096);
   full["serverUsername"] = newUser;
   full["serverPassword"] = newPwd;
 
@@ -418,7 +420,7 @@ void WiFiSetup::handleConfigSubmit() {
 }
 
 void WiFiSetup::handleStatus() {
-    DynamicJsonDocument doc(256);
+    JsonDoc doc(256);
     doc["configured"] = isConfigured();
     doc["ssid"] = ssid;
     doc["wifiConnected"] = (WiFi.status() == WL_CONNECTED);
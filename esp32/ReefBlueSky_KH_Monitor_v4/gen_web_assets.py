@@ -0,0 +1,127 @@
+# gen_web_assets.py
+# Gera WebAssetsData.cpp a partir de web/*.html: minifica, divide nos campos
+# {{DEVICE_ID}} / {{FW_VERSION}} e comprime cada trecho como bloco deflate
+# independente (full flush), prontos para WebAssets.cpp servir com
+# Content-Encoding: gzip sem descomprimir nada no device.
+#
+# Uso:
+#   python gen_web_assets.py        # regenera WebAssetsData.cpp
+#
+# Rodar sempre que um arquivo em web/ mudar.
+
+import hashlib
+import os
+import re
+import zlib
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+WEB_DIR = os.path.join(HERE, "web")
+OUT_CPP = os.path.join(HERE, "WebAssetsData.cpp")
+
+# arquivo -> (símbolo, tipo MIME)
+ASSETS = [
+    ("setup.html",  "WEB_ASSET_SETUP",  "text/html; charset=utf-8"),
+    ("webota.html", "WEB_ASSET_WEBOTA", "text/html; charset=utf-8"),
+]
+
+# Mesma ordem de WebAssetField em WebAssets.h
+FIELDS = {"DEVICE_ID": "WEB_FIELD_DEVICE_ID", "FW_VERSION": "WEB_FIELD_FW_VERSION"}
+
+GZIP_HEADER = bytes([0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 2, 0xFF])  # sem mtime, XFL=máx., OS=desconhecido
+MAX_PART = 0xFFFF
+
+
+def minify_css(css):
+    css = re.sub(r"/\*.*?\*/", "", css, flags=re.S)
+    css = re.sub(r"\s+", " ", css)
+    css = re.sub(r"\s*([{};:,>])\s*", r"\1", css)
+    return css.replace(";}", "}").strip()
+
+
+def minify(html):
+    html = re.sub(r"<!--.*?-->", "", html, flags=re.S)
+    html = re.sub(r"(<style[^>]*>)(.*?)(</style>)",
+                  lambda m: m.group(1) + minify_css(m.group(2)) + m.group(3),
+                  html, flags=re.S)
+    # Indentação e linhas vazias; mantém as quebras (ASI do JavaScript)
+    lines = [l.strip() for l in html.split("\n")]
+    html = "\n".join(l for l in lines if l)
+    return re.sub(r">\n<", "><", html)
+
+
+def split_fields(text):
+    """[(trecho, campo depois dele ou None)]"""
+    parts = []
+    pos = 0
+    for m in re.finditer(r"\{\{(\w+)\}\}", text):
+        if m.group(1) not in FIELDS:
+            raise RuntimeError("campo desconhecido: " + m.group(0))
+        parts.append((text[pos:m.start()], FIELDS[m.group(1)]))
+        pos = m.end()
+    parts.append((text[pos:], None))
+    return parts
+
+
+def compress(parts):
+    """Cabeçalho gzip + um bloco deflate por trecho; o último fecha o stream."""
+    blob = bytearray(GZIP_HEADER)
+    table = []
+    z = zlib.compressobj(9, zlib.DEFLATED, -15, 9)
+    for i, (raw, field) in enumerate(parts):
+        data = raw.encode("utf-8")
+        last = i == len(parts) - 1
+        comp = z.compress(data) + z.flush(zlib.Z_FINISH if last else zlib.Z_FULL_FLUSH)
+        if len(comp) > MAX_PART:
+            raise RuntimeError("trecho comprimido passa de 64KB")
+        off = len(blob)
+        blob += comp
+        table.append((off, len(blob) - off, len(data), zlib.crc32(data), field))
+    return bytes(blob), table
+
+
+def c_bytes(data, indent="  "):
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append(indent + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(rows)
+
+
+def main():
+    out = [
+        "// WebAssetsData.cpp",
+        "// GERADO por gen_web_assets.py a partir de web/*.html - não editar.",
+        "",
+        '#include "WebAssets.h"',
+        "",
+    ]
+    for fname, sym, mime in ASSETS:
+        with open(os.path.join(WEB_DIR, fname), "r", encoding="utf-8") as f:
+            src = f.read()
+        text = minify(src)
+        blob, table = compress(split_fields(text))
+        etag = hashlib.sha256(blob).hexdigest()[:16]
+        name = sym.lower()
+
+        out.append("// %s: %d bytes -> %d minificado -> %d gzip" %
+                   (fname, len(src.encode("utf-8")), len(text.encode("utf-8")), len(blob) + 8))
+        out.append("static const uint8_t %s_gz[] PROGMEM = {" % name)
+        out.append(c_bytes(blob))
+        out.append("};")
+        out.append("")
+        out.append("static const WebAssetPart %s_parts[] = {" % name)
+        for off, ln, raw, crc, field in table:
+            out.append("  { %d, %d, %d, 0x%08x, %s }," %
+                       (off, ln, raw, crc, field or "WEB_FIELD_NONE"))
+        out.append("};")
+        out.append("")
+        out.append('const WebAsset %s = { "%s", "%s", %s_gz, %s_parts, %d };' %
+                   (sym, mime, etag, name, name, len(table)))
+        out.append("")
+
+    with open(OUT_CPP, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(out))
+    print("gerado " + os.path.relpath(OUT_CPP, HERE))
+
+
+if __name__ == "__main__":
+    main()
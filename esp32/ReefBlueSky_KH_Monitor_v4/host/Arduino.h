@@ -0,0 +1,64 @@
+// Arduino.h (host) - só o necessário para compilar os módulos testados aqui
+#pragma once
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(m) ((void)(m))
+#define portEXIT_CRITICAL(m)  ((void)(m))
+#define RTC_NOINIT_ATTR
+
+// Relógio controlado pelo teste
+extern uint32_t hostMillis;
+inline unsigned long millis() { return hostMillis; }
+inline void delay(unsigned long ms) { hostMillis += ms; }
+
+template <typename T>
+inline T min(T a, T b) { return b < a ? b : a; }
+
+class String {
+public:
+  String(const char* s = "") : _s(s ? s : "") {}
+  String(const std::string& s) : _s(s) {}
+  size_t length() const { return _s.size(); }
+  const char* c_str() const { return _s.c_str(); }
+  String& operator+=(const String& o) { _s += o._s; return *this; }
+  String& operator+=(const char* o) { _s += o; return *this; }
+  friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+  friend String operator+(const String& a, const char* b) { return String(a._s + b); }
+  friend String operator+(const char* a, const String& b) { return String(a + b._s); }
+
+private:
+  std::string _s;
+};
+
+// Serial: silenciosa, a não ser que o teste ligue hostSerialEcho
+extern bool hostSerialEcho;
+struct HostSerial {
+  void printf(const char* fmt, ...) {
+    if (!hostSerialEcho) return;
+    va_list ap;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+  }
+  void println(const char* s) { if (hostSerialEcho) puts(s); }
+};
+extern HostSerial Serial;
+
+class Stream {
+public:
+  virtual ~Stream() {}
+  virtual int available() = 0;
+  virtual size_t readBytes(char* buffer, size_t length) = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual size_t write(uint8_t) = 0;
+  virtual void flush() = 0;
+};
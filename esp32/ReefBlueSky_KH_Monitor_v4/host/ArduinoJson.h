@@ -0,0 +1,31 @@
+// ArduinoJson.h (host) - BasicJsonDocument com o mesmo padrão de alocação
+// da ArduinoJson 6: um pool de 'capacity' bytes no construtor, liberado no
+// destrutor; shrinkToFit() chama reallocate.
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+
+template <typename TAllocator>
+class BasicJsonDocument : private TAllocator {
+public:
+  explicit BasicJsonDocument(size_t capacity)
+      : _pool((char*)this->allocate(capacity)), _capacity(_pool ? capacity : 0) {}
+  BasicJsonDocument(const BasicJsonDocument& src) : BasicJsonDocument(src._capacity) {
+    if (_pool) memcpy(_pool, src._pool, _capacity);
+  }
+  ~BasicJsonDocument() { this->deallocate(_pool); }
+
+  size_t capacity() const { return _capacity; }
+  char* pool() { return _pool; }
+
+  void shrinkToFit(size_t used) {
+    char* p = (char*)this->reallocate(_pool, used);
+    if (p) { _pool = p; _capacity = used; }
+  }
+
+private:
+  BasicJsonDocument& operator=(const BasicJsonDocument&);
+  char*  _pool;
+  size_t _capacity;
+};
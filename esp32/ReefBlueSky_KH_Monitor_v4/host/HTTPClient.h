@@ -0,0 +1,34 @@
+// HTTPClient.h (host) - WiFi sempre conectado e um POST que guarda o corpo
+// enviado (lido do Stream como o HTTPClient do ESP32 faz)
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+#define WL_CONNECTED 3
+
+struct HostWiFi {
+  int status() const { return WL_CONNECTED; }
+};
+extern HostWiFi WiFi;
+
+extern std::vector<uint8_t> hostHttpBody;
+extern int hostHttpCode;
+
+class HTTPClient {
+public:
+  bool begin(const String&) { return true; }
+  void addHeader(const char*, const String&) {}
+  int sendRequest(const char*, Stream* body, size_t size) {
+    hostHttpBody.assign(size, 0);
+    size_t n = body->readBytes((char*)hostHttpBody.data(), size);
+    hostHttpBody.resize(n);
+    return hostHttpCode;
+  }
+  void end() {}
+};
+
+// Do MultiDeviceAuth.h (o real puxa Preferences/ArduinoJson; no teste o
+// include guard dele vem definido pelo Makefile)
+extern String deviceToken;
+bool sendAlert(const String& type, const String& message, const String& severity = "medium");
@@ -0,0 +1,66 @@
+// SPIFFS.h (host) - sistema de arquivos em memória (mapa caminho -> bytes)
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+#include <vector>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+typedef std::map<std::string, std::vector<uint8_t> > HostFiles;
+
+class File {
+public:
+  File() {}
+  File(std::vector<uint8_t>* data, bool writable) : _data(data), _writable(writable) {}
+  explicit operator bool() const { return _data != nullptr; }
+
+  size_t size() const { return _data ? _data->size() : 0; }
+  bool seek(size_t pos) {
+    if (!_data || pos > _data->size()) return false;
+    _pos = pos;
+    return true;
+  }
+  int read() {
+    if (!_data || _pos >= _data->size()) return -1;
+    return (*_data)[_pos++];
+  }
+  size_t read(uint8_t* buf, size_t n) {
+    if (!_data) return 0;
+    size_t k = min(n, _data->size() - _pos);
+    memcpy(buf, _data->data() + _pos, k);
+    _pos += k;
+    return k;
+  }
+  size_t write(const uint8_t* buf, size_t n) {
+    if (!_data || !_writable) return 0;
+    _data->insert(_data->end(), buf, buf + n);
+    return n;
+  }
+  void close() { _data = nullptr; }
+
+private:
+  std::vector<uint8_t>* _data = nullptr;
+  bool   _writable = false;
+  size_t _pos = 0;
+};
+
+struct HostSPIFFS {
+  HostFiles files;
+
+  bool begin(bool) { return true; }
+  bool exists(const char* path) const { return files.count(path) != 0; }
+  bool remove(const char* path) { return files.erase(path) != 0; }
+  File open(const char* path, const char* mode) {
+    if (mode[0] == 'r') {
+      HostFiles::iterator it = files.find(path);
+      return it == files.end() ? File() : File(&it->second, false);
+    }
+    std::vector<uint8_t>& f = files[path];
+    if (mode[0] == 'w') f.clear();
+    return File(&f, true);
+  }
+};
+extern HostSPIFFS SPIFFS;
@@ -0,0 +1,182 @@
+// binlog_roundtrip.cpp - BinLog (firmware) -> backend/binlog/binlog.js
+//
+// Grava logs com o BinLog de verdade (stubs de SPIFFS/HTTP em memória) e
+// salva em arquivos o que sairia do device pelos três caminhos:
+//   binlog_upload.bin   corpo do POST /device/logs (syncToServer)
+//   binlog_spiffs.bin   segmento /blog0.bin (ERROR salvo pelo loop())
+//   binlog_frame.bin    frame de carona da telemetria (pendingFrame), com
+//                       o anel transbordado (registros perdidos)
+// e em binlog_expected.txt o texto esperado de cada registro (snprintf com
+// os mesmos argumentos). binlog_roundtrip.js decodifica com o binlog.js do
+// backend (formatos extraídos deste arquivo pelo gen_formats.js) e compara.
+//
+// Uso: make test (./binlog_roundtrip && node binlog_roundtrip.js)
+
+#include "../BinLog.h"
+#include <SPIFFS.h>
+#include <string>
+#include <vector>
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+
+// ---------- Stubs ----------
+
+uint32_t hostMillis = 1000;
+bool hostSerialEcho = false;
+HostSerial Serial;
+HostSPIFFS SPIFFS;
+HostWiFi WiFi;
+std::vector<uint8_t> hostHttpBody;
+int hostHttpCode = 200;
+String deviceToken = "token";
+const char* CLOUD_BASE_URL = "http://host";
+bool sendAlert(const String&, const String&, const String&) { return true; }
+
+// ---------- Esperado ----------
+
+static FILE* expected;
+
+// Uma linha por registro: "<seção>\t<NIVEL>\t<mensagem>"
+static void expect(const char* section, const char* level, const char* fmt, ...) {
+  char msg[BINLOG_MAX_RECORD];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(msg, sizeof(msg), fmt, ap);
+  va_end(ap);
+  fprintf(expected, "%s\t%s\t%s\n", section, level, msg);
+}
+
+static void writeFile(const char* path, const uint8_t* data, size_t n) {
+  FILE* f = fopen(path, "wb");
+  CHECK(f != nullptr);
+  if (!f) return;
+  fwrite(data, 1, n, f);
+  fclose(f);
+}
+
+// ---------- Casos ----------
+
+// Todos os tipos de argumento e os especificadores usados no firmware
+static void logAllTypes() {
+  int32_t neg = -42;
+  uint32_t heap = 123456u;
+  unsigned long up = 4000000000ul;
+  int64_t big = -5000000000LL;
+  uint64_t ts = 1760000000123ULL;
+  float kh = 7.85f;
+
+  LOG_I("BOOT: FW=%s, Heap=%d, ResetReason=%d", "4.2.1", (int)heap, 1);
+  expect("upload", "INFO", "BOOT: FW=%s, Heap=%d, ResetReason=%d", "4.2.1", (int)heap, 1);
+  LOG_W("WiFi desconectado! Uptime=%lu, Heap=%d", up, neg);
+  expect("upload", "WARN", "WiFi desconectado! Uptime=%lu, Heap=%d", up, neg);
+  LOG_D("KH=%.2f dKH temp=%.1f C ph=%5.1f", kh, 25.25f, 8.1f);
+  expect("upload", "DEBUG", "KH=%.2f dKH temp=%.1f C ph=%5.1f", (double)kh, 25.25, (double)8.1f);
+  LOG_I("Hora %02d:%02d ano %04d id %08x", 7, 5, 2025, 0xbeefu);
+  expect("upload", "INFO", "Hora %02d:%02d ano %04d id %08x", 7, 5, 2025, 0xbeefu);
+  LOG_I("64 bits: %lld %llu", (long long)big, (unsigned long long)ts);
+  expect("upload", "INFO", "64 bits: %lld %llu", (long long)big, (unsigned long long)ts);
+  LOG_I("pump=%u vol=%.2f mL 100%% [%-6s]", 3u, 12.5f, "ok");
+  expect("upload", "INFO", "pump=%u vol=%.2f mL 100%% [%-6s]", 3u, 12.5, "ok");
+  LOG_I("Sem argumentos");
+  expect("upload", "INFO", "Sem argumentos");
+
+  // String acima de BINLOG_MAX_STR: truncada no registro
+  const char* longUid = "RBS-KH-0123456789abcdef0123456789abcdef0123456789abcdef";
+  LOG_I("uid=%s fim", longUid);
+  expect("upload", "INFO", "uid=%.*s fim", BINLOG_MAX_STR, longUid);
+}
+
+static void testUpload() {
+  logAllTypes();
+
+  hostMillis = 61000;   // SYNC_INTERVAL
+  hostHttpBody.clear();
+  debugLog.syncToServer();
+  CHECK(!hostHttpBody.empty());
+  CHECK(debugLog.pendingBytes() == 0);   // 200: consumido
+  writeFile("binlog_upload.bin", hostHttpBody.data(), hostHttpBody.size());
+
+  // Device formata igual ao snprintf (alerta de boot, console)
+  uint8_t rec[BINLOG_MAX_RECORD];
+  size_t off = BINLOG_FRAME_HDR;
+  memcpy(rec, hostHttpBody.data() + off, hostHttpBody[off]);
+  char line[200];
+  debugLog.format(rec, line, sizeof(line));
+  CHECK(strstr(line, "[INFO] ") == line && strstr(line, ": BOOT: FW=4.2.1, Heap=123456, ResetReason=1"));
+}
+
+// ERROR vai para o SPIFFS pelo loop(), no máximo uma vez a cada
+// BINLOG_ERROR_SAVE_MS, e não no caminho de quem logou
+static void testErrorSave() {
+  const char* seg = "/blog0.bin";
+  size_t before = SPIFFS.exists(seg) ? SPIFFS.files[seg].size() : 0;
+
+  LOG_E("Health send FAILED! WiFi=%d%%, Heap=%d", 71, 9000);
+  expect("spiffs", "ERROR", "Health send FAILED! WiFi=%d%%, Heap=%d", 71, 9000);
+  CHECK((SPIFFS.exists(seg) ? SPIFFS.files[seg].size() : 0) == before);   // nada síncrono
+
+  debugLog.loop();
+  size_t first = SPIFFS.files[seg].size();
+  CHECK(first > before);
+
+  hostMillis += 1000;
+  LOG_E("WiFi OFF > %lu ms, RESTART!", 600000ul);
+  expect("spiffs", "ERROR", "WiFi OFF > %lu ms, RESTART!", 600000ul);
+  debugLog.loop();
+  CHECK(SPIFFS.files[seg].size() == first);   // dentro do intervalo
+
+  hostMillis += BINLOG_ERROR_SAVE_MS;
+  debugLog.loop();
+  CHECK(SPIFFS.files[seg].size() > first);
+  debugLog.loop();
+
+  const std::vector<uint8_t>& f = SPIFFS.files[seg];
+  writeFile("binlog_spiffs.bin", f.data(), f.size());
+}
+
+// Anel transbordado: o frame de carona leva o contador de perdidos
+static void testOverflowFrame() {
+  // Os ERROR do caso anterior ainda estão no anel (salvo != enviado)
+  BinLogMark m;
+  static uint8_t out[8192];
+  size_t n = debugLog.pendingFrame(out, sizeof(out), m);
+  CHECK(n > BINLOG_FRAME_HDR);
+  debugLog.markSent(m);
+
+  const int total = 300;
+  for (int i = 0; i < total; i++) {
+    LOG_D("Medição %d de %d: KH=%.2f (%s)", i, total, 7.0f + i * 0.01f, "ciclo de teste");
+  }
+  uint32_t dropped = debugLog.dropped();
+  CHECK(dropped > 0);
+
+  n = debugLog.pendingFrame(out, sizeof(out), m);
+  CHECK(n > BINLOG_FRAME_HDR);
+  writeFile("binlog_frame.bin", out, n);
+  for (int i = (int)dropped; i < total; i++) {
+    expect("frame", "DEBUG", "Medição %d de %d: KH=%.2f (%s)", i, total, (double)(7.0f + i * 0.01f),
+           "ciclo de teste");
+  }
+  fprintf(expected, "frame-dropped\t%u\n", (unsigned)dropped);
+  debugLog.markSent(m);
+  CHECK(debugLog.dropped() == 0 && debugLog.pendingBytes() == 0);
+}
+
+int main() {
+  expected = fopen("binlog_expected.txt", "w");
+  if (!expected) return 1;
+
+  debugLog.begin();
+  testUpload();
+  testErrorSave();
+  testOverflowFrame();
+  fclose(expected);
+
+  if (errors) {
+    printf("FALHOU (%d erros)\n", errors);
+    return 1;
+  }
+  printf("BinLog: arquivos gravados para o binlog_roundtrip.js\n");
+  return 0;
+}
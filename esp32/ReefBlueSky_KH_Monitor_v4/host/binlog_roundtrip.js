@@ -0,0 +1,54 @@
+// binlog_roundtrip.js - decodifica com o backend/binlog/binlog.js o que o
+// binlog_roundtrip (C++) gravou e compara com o texto esperado.
+// Formatos: gen_formats.js rodado nesta pasta (mesmo caminho do backend).
+//
+// Uso: node binlog_roundtrip.js   (depois de ./binlog_roundtrip; make test)
+
+const fs = require('fs');
+const path = require('path');
+const { execFileSync } = require('child_process');
+
+const BACKEND = path.join(__dirname, '..', '..', '..', 'backend', 'binlog');
+const { decode } = require(path.join(BACKEND, 'binlog.js'));
+
+let errors = 0;
+function check(ok, what) {
+  if (!ok) {
+    console.error(`falhou: ${what}`);
+    errors++;
+  }
+}
+
+const json = execFileSync(process.execPath, [path.join(BACKEND, 'gen_formats.js'), __dirname], { encoding: 'utf8' });
+const formats = new Map(Object.entries(JSON.parse(json)).map(([id, fmt]) => [parseInt(id, 16) >>> 0, fmt]));
+
+// seção -> [{level, message}], e registros perdidos esperados
+const expected = {};
+let expectedDropped = -1;
+for (const line of fs.readFileSync(path.join(__dirname, 'binlog_expected.txt'), 'utf8').split('\n')) {
+  if (!line) continue;
+  const f = line.split('\t');
+  if (f[0] === 'frame-dropped') { expectedDropped = Number(f[1]); continue; }
+  (expected[f[0]] = expected[f[0]] || []).push({ level: f[1], message: f.slice(2).join('\t') });
+}
+
+const nowMs = Date.now();
+for (const [section, file] of [['upload', 'binlog_upload.bin'], ['spiffs', 'binlog_spiffs.bin'], ['frame', 'binlog_frame.bin']]) {
+  const r = decode(fs.readFileSync(path.join(__dirname, file)), formats);
+  const want = expected[section] || [];
+  check(r.lines.length === want.length, `${file}: ${r.lines.length} registros, esperados ${want.length}`);
+  for (let i = 0; i < Math.min(r.lines.length, want.length); i++) {
+    const got = r.lines[i];
+    check(got.level === want[i].level && got.message === want[i].message,
+      `${file}[${i}]: "${got.level} ${got.message}" != "${want[i].level} ${want[i].message}"`);
+    check(Math.abs(got.ts - nowMs) < 600000, `${file}[${i}]: timestamp ${got.ts}`);
+  }
+  if (section === 'frame') check(r.dropped === expectedDropped, `perdidos ${r.dropped}, esperados ${expectedDropped}`);
+  console.log(`${file}: ${r.lines.length} registros decodificados`);
+}
+
+if (errors) {
+  console.log(`FALHOU (${errors} erros)`);
+  process.exit(1);
+}
+console.log('OK');
@@ -0,0 +1,256 @@
+// command_batch_test.cpp - lote de comandos (CommandQueue) contra um
+// servidor substituto local
+//
+// StandIn reproduz as regras de POST /device/commands/poll do backend:
+// aplica os acks (done/error/pending), entrega até 'max' comandos pendentes
+// em ordem, segura dependente cuja dependência ainda está rodando e marca
+// erro quando ela falhou. O "device" é o laço de processCloudCommand() do
+// .ino, com a barreira de restart e um reboot simulado (perde a RAM).
+//
+// Uso: ./command_batch_test      (make test)
+
+#include "../CommandQueue.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+
+// ---------- Servidor substituto ----------
+
+struct ServerCmd {
+  int32_t id;
+  std::string type;
+  int32_t dependsOn;
+  std::string status;    // pending, inprogress, done, error
+  std::string error;
+};
+
+struct Delivered {
+  int32_t id;
+  std::string type;
+  int32_t dependsOn;
+};
+
+struct StandIn {
+  std::vector<ServerCmd> cmds;
+  int requests = 0;
+  int32_t nextId = 100;
+
+  int32_t add(const char* type, int32_t dependsOn = 0) {
+    cmds.push_back({ nextId, type, dependsOn, "pending", "" });
+    return nextId++;
+  }
+  ServerCmd* find(int32_t id) {
+    for (ServerCmd& c : cmds) if (c.id == id) return &c;
+    return nullptr;
+  }
+
+  // POST /device/commands/poll {max, acks}
+  std::vector<Delivered> poll(int max, const CommandQueue& q, size_t nAcks) {
+    requests++;
+    for (size_t i = 0; i < nAcks; i++) {
+      const CommandAck& a = q.ack(i);
+      ServerCmd* c = find(a.id);
+      if (!c || c->status != "inprogress") continue;
+      c->status = CommandQueue::statusName(a.status);
+      c->error = a.error;
+    }
+    std::vector<Delivered> out;
+    for (ServerCmd& c : cmds) {
+      if ((int)out.size() >= max) break;
+      if (c.status != "pending") continue;
+      if (c.dependsOn) {
+        bool inBatch = false;
+        for (const Delivered& d : out) inBatch |= d.id == c.dependsOn;
+        if (!inBatch) {
+          ServerCmd* dep = find(c.dependsOn);
+          if (dep && dep->status == "error") {
+            c.status = "error";
+            c.error = "dependência falhou";
+            continue;
+          }
+          if (dep && dep->status != "done") break;
+        }
+      }
+      out.push_back({ c.id, c.type, c.dependsOn });
+    }
+    for (const Delivered& d : out) find(d.id)->status = "inprogress";
+    return out;
+  }
+
+  // POST /device/commands/complete (firmware antigo)
+  void complete(int32_t id, bool ok) {
+    requests++;
+    find(id)->status = ok ? "done" : "error";
+  }
+};
+
+// ---------- Device ----------
+
+struct Device {
+  StandIn& server;
+  CommandQueue* queue = new CommandQueue();
+  std::vector<std::string> executed;
+  bool rebooted = false;
+
+  explicit Device(StandIn& s) : server(s) {}
+  ~Device() { delete queue; }
+
+  static bool run(const std::string& type) { return type.compare(0, 4, "fail") != 0; }
+
+  void poll(int max) {
+    size_t nAcks = queue->ackCount();
+    std::vector<Delivered> batch = server.poll(max, *queue, nAcks);
+    queue->ackSent(nAcks);
+
+    queue->beginBatch();
+    for (const Delivered& d : batch) {
+      queue->push(d.id, d.dependsOn, d.type == "restart");
+    }
+    int slot;
+    while ((slot = queue->next()) >= 0) {
+      const Delivered& d = batch[slot];
+      if (queue->isBarrier(slot)) {
+        queue->requeueRemaining();
+        queue->complete(slot, true, "");
+        size_t n = queue->ackCount();
+        server.poll(0, *queue, n);           // flushCommandAcks
+        queue->ackSent(n);
+        executed.push_back(d.type);
+        delete queue;                        // reboot: RAM perdida
+        queue = new CommandQueue();
+        rebooted = true;
+        return;
+      }
+      bool ok = run(d.type);
+      executed.push_back(d.type);
+      queue->complete(slot, ok, ok ? "" : "falhou");
+    }
+  }
+
+  // Firmware antigo: 1 comando por poll + 1 /complete por comando
+  void pollLegacy() {
+    CommandQueue empty;
+    std::vector<Delivered> batch = server.poll(1, empty, 0);
+    for (const Delivered& d : batch) {
+      executed.push_back(d.type);
+      server.complete(d.id, run(d.type));
+    }
+  }
+};
+
+static std::string join(const std::vector<std::string>& v) {
+  std::string s;
+  for (const std::string& x : v) s += (s.empty() ? "" : ",") + x;
+  return s;
+}
+
+// ---------- Casos ----------
+
+static void testRoundTrips() {
+  StandIn legacy, batched;
+  const char* types[] = { "setkhtarget", "setintervalminutes", "testmode", "testnow", "manualpump", "setkhreference" };
+  for (const char* t : types) { legacy.add(t); batched.add(t); }
+
+  Device oldDev(legacy);
+  int polls = 0;
+  while (oldDev.executed.size() < 6) { oldDev.pollLegacy(); polls++; }
+  oldDev.pollLegacy();
+
+  Device dev(batched);
+  int bpolls = 0;
+  while (dev.executed.size() < 6) { dev.poll(CMD_BATCH_MAX); bpolls++; }
+  dev.poll(CMD_BATCH_MAX);                   // acks do último lote
+
+  CHECK(join(dev.executed) == join(oldDev.executed));
+  for (const ServerCmd& c : batched.cmds) CHECK(c.status == "done");
+  printf("6 comandos: legado %d polls / %d requisições, lote %d polls / %d requisições\n",
+         polls, legacy.requests, bpolls, batched.requests);
+  CHECK(bpolls == 2);
+  CHECK(batched.requests == 3);
+  CHECK(legacy.requests == 13);
+}
+
+static void testDependencies() {
+  StandIn s;
+  int32_t a = s.add("fail_fillchamber");
+  int32_t b = s.add("testnow", a);
+  int32_t c = s.add("setkhreference", b);
+  int32_t d = s.add("setkhtarget");
+  Device dev(s);
+  dev.poll(CMD_BATCH_MAX);
+  dev.poll(CMD_BATCH_MAX);
+
+  CHECK(join(dev.executed) == "fail_fillchamber,setkhtarget");
+  CHECK(s.find(a)->status == "error");
+  CHECK(s.find(b)->status == "error");
+  CHECK(s.find(c)->status == "error");
+  CHECK(s.find(d)->status == "done");
+  CHECK(s.find(b)->error.find("dependência") != std::string::npos);
+}
+
+static void testCrossBatchDependency() {
+  StandIn s;
+  int32_t a = s.add("khcorrection");
+  s.add("testmode");
+  s.add("testmode");
+  s.add("testmode");
+  int32_t e = s.add("fail_manualpump");
+  int32_t f = s.add("testnow", e);          // próximo lote: dependência falhou
+  int32_t g = s.add("testnow", a);          // dependência concluída no 1º lote
+  Device dev(s);
+  dev.poll(CMD_BATCH_MAX);
+  dev.poll(CMD_BATCH_MAX);
+  dev.poll(CMD_BATCH_MAX);
+
+  CHECK(s.find(e)->status == "error");
+  CHECK(s.find(f)->status == "error");
+  CHECK(s.find(g)->status == "done");
+  CHECK(join(dev.executed) == "khcorrection,testmode,testmode,testmode,fail_manualpump,testnow");
+}
+
+static void testBarrier() {
+  StandIn s;
+  int32_t a = s.add("setkhtarget");
+  int32_t r = s.add("restart");
+  int32_t b = s.add("testnow");
+  int32_t c = s.add("setkhreference", b);
+  Device dev(s);
+  dev.poll(CMD_BATCH_MAX);
+
+  CHECK(dev.rebooted);
+  CHECK(s.find(a)->status == "done");
+  CHECK(s.find(r)->status == "done");
+  CHECK(s.find(b)->status == "pending");    // devolvidos antes do reboot
+  CHECK(s.find(c)->status == "pending");
+
+  dev.poll(CMD_BATCH_MAX);                  // depois do boot
+  dev.poll(CMD_BATCH_MAX);
+  CHECK(join(dev.executed) == "setkhtarget,restart,testnow,setkhreference");
+  CHECK(s.find(c)->status == "done");
+}
+
+static void testAckOverflow() {
+  CommandQueue q;
+  for (int i = 0; i < CMD_ACK_MAX + 3; i++) q.reject(i + 1, "x");
+  CHECK(q.ackCount() == CMD_ACK_MAX);
+  CHECK(q.ack(0).id == 4);                  // perde os mais antigos
+  q.ackSent(2);
+  CHECK(q.ack(0).id == 6);
+}
+
+int main() {
+  testRoundTrips();
+  testDependencies();
+  testCrossBatchDependency();
+  testBarrier();
+  testAckOverflow();
+  if (errors) {
+    printf("FALHOU (%d erros)\n", errors);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,123 @@
+// json_arena_soak.cpp - 30 dias de requisições JSON do KH contra a JsonArena
+//
+// Reproduz os documentos que o firmware cria (tamanhos e aninhamento de
+// CloudAuth, MeasurementHistory, processCloudCommand, WiFiSetup...), com
+// liberações fora de ordem e shrinkToFit, e confere a cada requisição:
+//   - a arena volta a 0 bytes em uso;
+//   - nenhum pool sobrescreve outro (padrão por documento);
+//   - o pico fica abaixo de JSON_ARENA_SIZE e sem fallback para o heap.
+// Ou seja: a memória de JSON do firmware fica limitada à arena, por mais
+// tempo que o device fique ligado, e nenhum malloc/free de pool JSON sobra
+// para fragmentar o heap.
+//
+// Uso: ./json_arena_soak [dias]      (make test = 30 dias)
+
+#include "../JsonArena.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// ---------- Carga ----------
+
+static uint32_t rng = 12345;
+static uint32_t rnd(uint32_t n) {
+  rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+  return rng % n;
+}
+
+static uint32_t errors = 0;
+
+// Documento da carga: preenche o pool com um padrão e confere ao destruir
+struct Doc {
+  JsonDoc doc;
+  uint8_t tag;
+
+  explicit Doc(size_t cap) : doc(cap), tag((uint8_t)rnd(255)) {
+    if (doc.pool()) memset(doc.pool(), tag, doc.capacity());
+  }
+  ~Doc() { check(); }
+  void check() {
+    for (size_t i = 0; i < doc.capacity(); i++) {
+      if ((uint8_t)doc.pool()[i] != tag) {
+        fprintf(stderr, "pool sobrescrito (cap=%u)\n", (unsigned)doc.capacity());
+        errors++;
+        return;
+      }
+    }
+  }
+};
+
+static void request(int kind) {
+  switch (kind) {
+    case 0: { Doc health(512); break; }                        // sendHealthMetrics
+    case 1: {                                                  // syncOfflineMeasurements
+      Doc sync(4096);
+      Doc resp(512);
+      break;
+    }
+    case 2: {                                                  // poll + processCloudCommand
+      Doc resp(2048);
+      for (int c = rnd(3); c > 0; c--) {
+        Doc cmd(768);
+        if (rnd(4) == 0) { Doc cfg(768); }                     // KH_Analyzer/KH_Calibrator save
+        if (rnd(8) == 0) { Doc hist(8192); Doc gz(8192); }     // history save + compress
+      }
+      break;
+    }
+    case 3: {                                                  // WiFiSetup: scan + save config
+      Doc scan(1024);
+      Doc* cfg = new Doc(4096);
+      Doc* full = new Doc(4096);
+      delete cfg;                                              // fora de ordem
+      full->doc.shrinkToFit(1500);
+      delete full;
+      break;
+    }
+    case 4: {                                                  // registro / refresh token
+      Doc req(256);
+      Doc* resp = new Doc(2048);
+      resp->doc.shrinkToFit(300);
+      Doc* extra = new Doc(512);
+      delete resp;
+      delete extra;
+      break;
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  int days = argc > 1 ? atoi(argv[1]) : 30;
+  uint64_t minutes = (uint64_t)days * 24 * 60;
+  uint32_t requests = 0;
+
+  // Maior que a arena: vai para o heap e volta por free()
+  { Doc big(JSON_ARENA_SIZE + 1); }
+  const uint32_t expectedFallbacks = 1;
+
+  printf("dia  requisições  documentos  arena pico  fallbacks\n");
+  for (uint64_t t = 0; t < minutes; t++) {
+    int n = 2 + rnd(4);
+    for (int i = 0; i < n; i++) {
+      request(rnd(10) < 6 ? rnd(3) : rnd(5));
+      requests++;
+      if (jsonArenaStats().used != 0) {
+        fprintf(stderr, "arena não voltou a zero (%u bytes)\n", jsonArenaStats().used);
+        errors++;
+      }
+    }
+    if ((t + 1) % (7 * 24 * 60) == 0 || t + 1 == minutes) {
+      JsonArenaStats s = jsonArenaStats();
+      printf("%3u  %11u  %10u  %5u/%u  %9u\n", (unsigned)((t + 1) / (24 * 60)), requests,
+             s.allocs, s.peak, (unsigned)JSON_ARENA_SIZE, s.fallbacks);
+    }
+  }
+
+  JsonArenaStats s = jsonArenaStats();
+  printf("\n%u documentos, pico da arena %u bytes, %u fallbacks (%u malloc/free de pool fora do heap)\n",
+         s.allocs, s.peak, s.fallbacks, 2 * (s.allocs - s.fallbacks));
+  if (s.peak > JSON_ARENA_SIZE || s.fallbacks != expectedFallbacks || errors) {
+    printf("FALHOU (%u erros)\n", errors);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
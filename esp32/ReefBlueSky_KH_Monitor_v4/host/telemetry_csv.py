@@ -0,0 +1,119 @@
+# telemetry_csv.py
+# Grava o stream de telemetria local do KH (LiveTelemetry, ws://<ip>:81/)
+# em CSV. Só biblioteca padrão: handshake WebSocket e frames feitos à mão.
+#
+# Uso:
+#   python telemetry_csv.py 192.168.0.50 [--hz 10] [--out kh.csv] [--seconds 600]
+#
+# Colunas: seq, millis, ph, temp_c, ph_adc, level_a, level_b, level_c, state
+# Ctrl+C encerra e fecha o arquivo.
+
+import argparse
+import base64
+import os
+import socket
+import struct
+import sys
+import time
+
+FRAME_HDR = 12
+SAMPLE = struct.Struct("<IhhHBB")   # millis, pH*1000, temp*100, adc, níveis, estado
+STATES = ["STARTUP", "IDLE", "MEASURING", "PREDICTING", "ERROR", "WAITING_CALIBRATION",
+          "AI_KH_CALIBRATE_PH", "AI_KH_RENEW_A", "AI_KH_TEST_A_TO_B", "AI_KH_CLEAN_B_TO_C",
+          "AI_PREP_NEW_TEST"]
+
+
+def recv_exact(sock, n):
+    buf = b""
+    while len(buf) < n:
+        chunk = sock.recv(n - len(buf))
+        if not chunk:
+            raise ConnectionError("conexão fechada pelo device")
+        buf += chunk
+    return buf
+
+
+def connect(host, port, hz):
+    sock = socket.create_connection((host, port), timeout=10)
+    key = base64.b64encode(os.urandom(16)).decode()
+    sock.sendall(("GET /?hz=%d HTTP/1.1\r\nHost: %s:%d\r\nUpgrade: websocket\r\n"
+                  "Connection: Upgrade\r\nSec-WebSocket-Key: %s\r\n"
+                  "Sec-WebSocket-Version: 13\r\n\r\n" % (hz, host, port, key)).encode())
+    resp = b""
+    while b"\r\n\r\n" not in resp:
+        resp += recv_exact(sock, 1)
+    if b" 101 " not in resp.split(b"\r\n")[0]:
+        raise ConnectionError("handshake recusado: " + resp.decode(errors="replace"))
+    return sock
+
+
+def send_frame(sock, opcode, payload=b""):
+    # Cliente sempre mascara (RFC 6455)
+    mask = os.urandom(4)
+    data = bytes(b ^ mask[i & 3] for i, b in enumerate(payload))
+    sock.sendall(bytes([0x80 | opcode, 0x80 | len(payload)]) + mask + data)
+
+
+def read_frame(sock):
+    b0, b1 = recv_exact(sock, 2)
+    n = b1 & 0x7F
+    if n == 126:
+        n = struct.unpack(">H", recv_exact(sock, 2))[0]
+    elif n == 127:
+        n = struct.unpack(">Q", recv_exact(sock, 8))[0]
+    return b0 & 0x0F, recv_exact(sock, n)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Grava a telemetria local do KH em CSV")
+    ap.add_argument("host")
+    ap.add_argument("--port", type=int, default=81)
+    ap.add_argument("--hz", type=int, default=10)
+    ap.add_argument("--out", default="kh_telemetry.csv")
+    ap.add_argument("--seconds", type=float, default=0, help="0 = até Ctrl+C")
+    args = ap.parse_args()
+
+    sock = connect(args.host, args.port, args.hz)
+    sock.settimeout(5)
+    t_end = time.time() + args.seconds if args.seconds > 0 else None
+    rows = 0
+    lost = 0
+
+    with open(args.out, "w", newline="") as f:
+        f.write("seq,millis,ph,temp_c,ph_adc,level_a,level_b,level_c,state\n")
+        try:
+            while t_end is None or time.time() < t_end:
+                op, payload = read_frame(sock)
+                if op == 0x8:
+                    print("device fechou a conexão")
+                    break
+                if op == 0x9:
+                    send_frame(sock, 0xA, payload)
+                    continue
+                if op != 0x2 or len(payload) < FRAME_HDR:
+                    continue
+
+                _, n, period, seq, lost = struct.unpack_from("<BBHII", payload)
+                for i in range(n):
+                    ms, ph, temp, adc, lv, st = SAMPLE.unpack_from(payload, FRAME_HDR + i * SAMPLE.size)
+                    state = STATES[st] if st < len(STATES) else str(st)
+                    f.write("%d,%d,%.3f,%.2f,%d,%d,%d,%d,%s\n" % (
+                        seq + i * (period // 100), ms, ph / 1000.0, temp / 100.0, adc,
+                        lv & 1, (lv >> 1) & 1, (lv >> 2) & 1, state))
+                rows += n
+                sys.stdout.write("\r%d amostras, %d perdidas" % (rows, lost))
+                sys.stdout.flush()
+        except KeyboardInterrupt:
+            pass
+        finally:
+            try:
+                send_frame(sock, 0x8, struct.pack(">H", 1000))
+            except OSError:
+                pass
+            sock.close()
+
+    print("\n%d amostras gravadas em %s" % (rows, args.out))
+
+
+if __name__ == "__main__":
+    main()
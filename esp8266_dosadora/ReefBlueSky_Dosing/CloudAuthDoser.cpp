@@ -3,6 +3,8 @@
 #include "CloudAuthDoser.h"
 #include "FwVersion.h"
 #include "OtaUpdate.h"
+#include <memory>
+#include <new>
 
 #ifdef ESP8266
   #include <ESP8266HTTPClient.h>
@@ -195,8 +197,8 @@ bool CloudAuthDoser::ensureTokenFresh() {
   return true;
 }
 
-bool CloudAuthDoser::fetchDoserConfig(JsonDocument& outConfig) {
-  if (!isAuthenticated()) return false;
+bool CloudAuthDoser::fetchDoserConfig(DoserControl* doser) {
+  if (!isAuthenticated() || !doser) return false;
 
   HTTPClient http;
   String url = serverUrl + "/iot/dosing/handshake";
@@ -205,49 +207,90 @@ bool CloudAuthDoser::fetchDoserConfig(JsonDocument& outConfig) {
   payload["esp_uid"] = espUid;
   payload["hw_type"] = HW_TYPE;
   payload["firmware_version"] = FW_VERSION;
+  if (doser->getConfigVersion().length() > 0) {
+    payload["config_version"] = doser->getConfigVersion();
+  }
 
   String jsonPayload;
   serializeJson(payload, jsonPayload);
-  Serial.print("[CloudAuth] Handshake payload: ");
-  Serial.println(jsonPayload);
 
   WiFiClient client;
   http.begin(client, url);
   http.setTimeout(HTTP_TIMEOUT_MS);  // [FIX] Adicionar timeout
   http.addHeader("Content-Type", "application/json");
 
+  // HTTP/1.0: corpo sem chunked, lido direto do socket pelo parser
+  http.useHTTP10(true);
   int httpCode = http.POST(jsonPayload);
-  String response = http.getString();
-  http.end();
 
   if (httpCode == 404) {
     Serial.println("[CloudAuth] Handshake: doser ainda não cadastrado/configurado no servidor");
-    Serial.println(response);  // {"success":false,"error":"Device not found"}
+    Serial.println(http.getString());  // {"success":false,"error":"Device not found"}
+    http.end();
     return false;              // deixa o loop tentar mais tarde
   }
 
   if (httpCode != 200) {
     Serial.printf("[CloudAuth] Handshake failed: %d\n%s\n",
-                  httpCode, response.c_str());
+                  httpCode, http.getString().c_str());
+    http.end();
     return false;
   }
 
-  Serial.print("[CloudAuth] Handshake resp: ");
-  Serial.println(response);
-
-  deserializeJson(outConfig, response);
+  // Stage de tamanho fixo só durante o handshake, em vez da resposta
+  // inteira em String + documento JSON de 8 KB
+  std::unique_ptr<DoserConfigStage> cfg(new (std::nothrow) DoserConfigStage());
+  if (!cfg) {
+    Serial.println("[CloudAuth] Handshake: sem memória para a config");
+    http.end();
+    return false;
+  }
+  const char* parseErr = nullptr;
+  bool parsed = parseDoserConfig(http.getStream(), *cfg, &parseErr);
+  http.end();
+  uint32_t heap = ESP.getFreeHeap();
+  if (heap < hsMinHeap) hsMinHeap = heap;
 
-  if (outConfig.containsKey("user_utc_offset_sec")) {
-    g_userUtcOffsetSec = outConfig["user_utc_offset_sec"].as<int32_t>();
-    Serial.printf("[CloudAuth] user_utc_offset_sec=%ld\n", (long)g_userUtcOffsetSec);
+  if (!parsed) {
+    Serial.printf("[CloudAuth] Handshake: JSON inválido (%s)\n", parseErr ? parseErr : "?");
+    return false;
   }
 
+  int32_t prevOffset = g_userUtcOffsetSec;
+  if (cfg->hasOffset) {
+    g_userUtcOffsetSec = cfg->utcOffsetSec;
+  }
+  // Fuso mudou sem agenda mudar (ex.: boot com config local, horário de
+  // verão): os jobs já montados estão com o offset antigo
+  time_t nowUsr = time(nullptr) + g_userUtcOffsetSec;
+  bool rebuildForOffset = g_userUtcOffsetSec != prevOffset && nowUsr > 1700000000;
+
+  if (cfg->unchanged) {
+    hsUnchanged++;
+    for (uint8_t i = 0; i < cfg->volumeCount; i++) {
+      doser->setPumpVolume(cfg->volumes[i].pumpId, cfg->volumes[i].volumeMl);
+    }
+    if (rebuildForOffset) doser->rebuildJobs(nowUsr);
+    return true;
+  }
 
-  return outConfig.containsKey("pumps");
+  if (!cfg->hasPumps) return false;
+
+  hsFull++;
+  Serial.printf("[CloudAuth] Handshake: config %s (user_utc_offset_sec=%ld, heap livre %lu)\n",
+                cfg->version[0] ? cfg->version : "(sem versão)", (long)g_userUtcOffsetSec,
+                (unsigned long)heap);
+  doser->applyConfig(*cfg);
+  if (rebuildForOffset) doser->rebuildJobs(nowUsr);
+  Serial.printf("[CloudAuth] Handshake desde o boot: %lu completos, %lu unchanged, %lu gravações, heap mín %lu\n",
+                (unsigned long)hsFull, (unsigned long)hsUnchanged,
+                (unsigned long)doser->getConfigWrites(), (unsigned long)hsMinHeap);
+  return true;
 }
 
 
-bool CloudAuthDoser::sendDoserStatus(uint32_t uptime, int8_t rssi, const JsonDocument& pumpsStatus) {
+bool CloudAuthDoser::sendDoserStatus(uint32_t uptime, int8_t rssi, const JsonDocument& pumpsStatus,
+                                     const JsonDocument* lanStatus) {
   if (!isAuthenticated()) return false;
 
   HTTPClient http;
@@ -258,6 +301,7 @@ bool CloudAuthDoser::sendDoserStatus(uint32_t uptime, int8_t rssi, const JsonDoc
   payload["uptime_s"]   = uptime;
   payload["signal_dbm"] = rssi;
   payload["pumps"]      = pumpsStatus;
+  if (lanStatus) payload["lan"] = *lanStatus;
 
   String jsonPayload;
   serializeJson(payload, jsonPayload);
@@ -322,48 +366,35 @@ bool CloudAuthDoser::reportDosingExecution(
   return (httpCode == 200 || httpCode == 201);
 }
 
-bool CloudAuthDoser::fetchCommands(JsonDocument& outDoc) {
+bool CloudAuthDoser::fetchLanKey(String& hexKey) {
   if (!isAuthenticated()) return false;
 
   HTTPClient http;
-  String url = serverUrl + "/iot/dosing/commands";
-
-  DynamicJsonDocument payload(128);
-  payload["esp_uid"] = espUid;
-
-  String jsonPayload;
-  serializeJson(payload, jsonPayload);
+  String url = serverUrl + "/device/lan-key";
 
   WiFiClient client;
   http.begin(client, url);
-  http.setTimeout(HTTP_TIMEOUT_MS);  // [FIX] Adicionar timeout
-  http.addHeader("Content-Type", "application/json");
+  http.setTimeout(HTTP_TIMEOUT_MS);
+  http.addHeader("Authorization", getAuthHeader());
 
-  int httpCode = http.POST(jsonPayload);
-  String response = http.getString();
+  int httpCode = http.GET();
+  String resp = http.getString();
   http.end();
 
   if (httpCode != 200) {
-    Serial.printf("[CloudAuth] fetchCommands httpCode=%d\n", httpCode);
-    Serial.println(response);
-    return false;
-  }
-
-  DeserializationError err = deserializeJson(outDoc, response);
-  if (err) {
-    Serial.printf("[CloudAuth] JSON error in commands: %s\n", err.c_str());
+    Serial.printf("[CloudAuth] lan-key falhou: %d\n", httpCode);
     return false;
   }
 
-  JsonArray cmds = outDoc["commands"].as<JsonArray>();
-  if (!cmds.isNull() && cmds.size() > 0) {
-    Serial.printf("[CloudAuth] %d command(s) received\n", cmds.size());
-  }
-
+  DynamicJsonDocument doc(512);
+  if (deserializeJson(doc, resp) || !(doc["success"] | false)) return false;
+  const char* key = doc["data"]["key"] | "";
+  if (strlen(key) != 64) return false;
+  hexKey = key;
+  Serial.printf("[CloudAuth] Chave LAN recebida (key_id %s)\n", (const char*)(doc["data"]["key_id"] | "?"));
   return true;
 }
 
-
 void CloudAuthDoser::handleCommand(JsonObject cmd, DoserControl* doser) {
   String type = cmd["type"].as<String>();
   JsonObject payload = cmd["payload"].as<JsonObject>();
@@ -378,16 +409,22 @@ void CloudAuthDoser::handleCommand(JsonObject cmd, DoserControl* doser) {
   else if (type == "MANUAL_DOSE") {
     // NÃO depender de pump_id vindo do servidor
     uint8_t  pumpIndex   = payload["pump_index"]   | 0;
-    uint16_t volumeMl    = payload["volume_ml"]    | 0;
+    float    volumeMl    = payload["volume_ml"]    | 0.0f;   // correção de KH vem fracionada
     uint32_t execId      = payload["execution_id"] | 0;
+    uint32_t requestId   = payload["request_id"]   | 0;      // pedido do monitor (ver DoserLan)
     const char* origin   = payload["origin"] | "MANUAL";
 
-    Serial.printf("[CMD] MANUAL_DOSE idx=%u vol=%u execId=%lu origin=%s\n",
-                  pumpIndex, volumeMl, execId, origin);
+    Serial.printf("[CMD] MANUAL_DOSE idx=%u vol=%.2f execId=%lu origin=%s\n",
+                  pumpIndex, (double)volumeMl, execId, origin);
 
     if (doser) {
-      // usa só o índice; DoserControl pega pump.id da config
-      doser->startManualDose(pumpIndex, volumeMl, execId);
+      if (doser->requestExecuted(requestId)) {
+        // Já dosado pela LAN; só o ACK não chegou ao monitor
+        Serial.printf("[CMD] Pedido %lu já executado pela LAN, ignorando\n", (unsigned long)requestId);
+      } else if (doser->startManualDose(pumpIndex, volumeMl, execId)) {
+        // usa só o índice; DoserControl pega pump.id da config
+        doser->markRequestExecuted(requestId);
+      }
     }
   }
 
@@ -403,11 +440,25 @@ void CloudAuthDoser::handleCommand(JsonObject cmd, DoserControl* doser) {
 
 
 void CloudAuthDoser::processCommands(DoserControl* doser) {
+  if (!cmdPollReady) {
+    cmdPollReady = cmdPoll.begin(serverUrl.c_str(), espUid.c_str());
+    if (!cmdPollReady) return;
+  }
+  if (!cmdPoll.loop(millis())) return;
+
   DynamicJsonDocument doc(2048);
-  if (!fetchCommands(doc)) return;
+  DeserializationError err = deserializeJson(doc, cmdPoll.body());
+  if (err) {
+    Serial.printf("[CloudAuth] JSON error in commands: %s\n", err.c_str());
+    return;
+  }
 
   if (!doc.containsKey("commands")) return;
   JsonArray cmds = doc["commands"].as<JsonArray>();
+  if (cmds.size() > 0) {
+    Serial.printf("[CloudAuth] %d command(s) received (%lu pedidos desde o boot)\n",
+                  cmds.size(), (unsigned long)cmdPoll.requests());
+  }
 
   for (JsonObject cmd : cmds) {
     handleCommand(cmd, doser);
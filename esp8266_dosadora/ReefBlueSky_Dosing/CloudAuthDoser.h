@@ -3,6 +3,7 @@
 #ifndef CLOUDAUTH_DOSER_H
 #define CLOUDAUTH_DOSER_H
 #include "DoserControl.h"
+#include "CommandPoll.h"
 
 #include <Arduino.h>
 #ifdef ESP8266
@@ -70,7 +71,13 @@ private:
 
   ExponentialBackoff backoff;  // [FIX] Controle de backoff
 
-  bool fetchCommands(JsonDocument& outDoc);
+  uint32_t hsFull      = 0;            // respostas com config completa
+  uint32_t hsUnchanged = 0;            // respostas "unchanged"
+  uint32_t hsMinHeap   = UINT32_MAX;   // menor heap livre durante o handshake
+
+  CommandPoll cmdPoll;                 // long-poll de /iot/dosing/commands
+  bool        cmdPollReady = false;
+
   void handleCommand(JsonObject cmd, DoserControl* doser);
 
   bool performRegistration();
@@ -86,11 +93,26 @@ public:
   // Novo: expõe o token para outros módulos (FwVersion, OTA, etc.)
   const String& getAccessToken() const { return accessToken; }
 
+  // Chamar a cada loop(): não bloqueia; executa os comandos quando o
+  // long-poll responde
   void processCommands(DoserControl* doser);
+  const CommandPoll& commandPoll() const { return cmdPoll; }
 
   bool ensureTokenFresh();
-  bool fetchDoserConfig(JsonDocument& outConfig);
-  bool sendDoserStatus(uint32_t uptime, int8_t rssi, const JsonDocument& pumpsStatus);
+  // Handshake condicional: manda a config_version aplicada no doser; se o
+  // servidor responder "unchanged" só atualiza fuso e volumes (resposta
+  // de ~200 bytes), senão aplica a config nova como diff. true = doser
+  // está com a config atual do servidor.
+  bool fetchDoserConfig(DoserControl* doser);
+
+  // Medição do handshake (desde o boot)
+  uint32_t getHandshakeFull() const { return hsFull; }
+  uint32_t getHandshakeUnchanged() const { return hsUnchanged; }
+  uint32_t getHandshakeMinHeap() const { return hsMinHeap; }
+  bool sendDoserStatus(uint32_t uptime, int8_t rssi, const JsonDocument& pumpsStatus,
+                       const JsonDocument* lanStatus = nullptr);
+  // Chave LAN do usuário (GET /device/lan-key), hex de 64 caracteres
+  bool fetchLanKey(String& hexKey);
   bool reportDosingExecution(uint32_t pumpId, float volumeMl, uint32_t scheduledAt, uint32_t executedAt, const char* status, const char* origin, uint32_t scheduleId, uint8_t doseIndex);
 
 
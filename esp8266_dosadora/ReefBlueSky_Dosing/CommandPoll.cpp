@@ -0,0 +1,167 @@
+//CommandPoll.cpp
+#include "CommandPoll.h"
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+
+// Valor numérico de um header (nome sem diferenciar maiúsculas); -1 se ausente
+static long headerValue(const char* headers, const char* end, const char* name) {
+  size_t n = strlen(name);
+  const char* line = strstr(headers, "\r\n");
+  while (line && line < end) {
+    line += 2;
+    if (strncasecmp(line, name, n) == 0 && line[n] == ':') {
+      return strtol(line + n + 1, nullptr, 10);
+    }
+    line = strstr(line, "\r\n");
+  }
+  return -1;
+}
+
+bool CommandPoll::begin(const char* serverUrl, const char* espUid) {
+  const char* p = serverUrl;
+  if (strncmp(p, "http://", 7) != 0) {
+    Serial.printf("[CmdPoll] URL não suportada (só http://): %s\n", serverUrl);
+    return false;
+  }
+  p += 7;
+
+  const char* slash = strchr(p, '/');
+  const char* hostEnd = slash ? slash : p + strlen(p);
+  const char* colon = (const char*)memchr(p, ':', hostEnd - p);
+
+  size_t hostLen = (colon ? colon : hostEnd) - p;
+  if (hostLen == 0 || hostLen >= sizeof(_host)) return false;
+  memcpy(_host, p, hostLen);
+  _host[hostLen] = 0;
+  _port = colon ? (uint16_t)atoi(colon + 1) : 80;
+
+  snprintf(_path, sizeof(_path), "%s/iot/dosing/commands", slash ? slash : "");
+  strncpy(_espUid, espUid, sizeof(_espUid) - 1);
+
+  reset();
+  _nextAt = millis();
+  Serial.printf("[CmdPoll] Long-poll em %s:%u%s (wait_s=%u)\n", _host, _port, _path, _waitS);
+  return true;
+}
+
+void CommandPoll::reset() {
+  _client.stop();
+  _state = CP_IDLE;
+  _len = 0;
+  _body = nullptr;
+}
+
+void CommandPoll::fail(uint32_t nowMs) {
+  reset();
+  _failures++;
+  _backoffMs = _backoffMs ? _backoffMs * 2 : CMDPOLL_BACKOFF_MIN_MS;
+  if (_backoffMs > CMDPOLL_BACKOFF_MAX_MS) _backoffMs = CMDPOLL_BACKOFF_MAX_MS;
+  _nextAt = nowMs + _backoffMs;
+}
+
+bool CommandPoll::startRequest(uint32_t nowMs) {
+  if (!_client.connect(_host, _port)) {
+    Serial.printf("[CmdPoll] Falha ao conectar em %s:%u\n", _host, _port);
+    fail(nowMs);
+    return false;
+  }
+
+  char body[96];
+  int bodyLen = snprintf(body, sizeof(body), "{\"esp_uid\":\"%s\",\"wait_s\":%u}", _espUid, _waitS);
+
+  // Monta o pedido inteiro em _buf (a resposta só chega depois)
+  int n = snprintf(_buf, sizeof(_buf),
+                   "POST %s HTTP/1.0\r\n"
+                   "Host: %s\r\n"
+                   "Content-Type: application/json\r\n"
+                   "Content-Length: %d\r\n"
+                   "Connection: close\r\n\r\n%s",
+                   _path, _host, bodyLen, body);
+  _client.write((const uint8_t*)_buf, n);
+
+  _len = 0;
+  _body = nullptr;
+  _sentAt = nowMs;
+  _state = CP_WAITING;
+  _requests++;
+  return true;
+}
+
+bool CommandPoll::loop(uint32_t nowMs) {
+  if (_state == CP_IDLE) {
+    if ((int32_t)(nowMs - _nextAt) < 0) return false;
+    if (!startRequest(nowMs)) return false;
+  }
+
+  // Lê o que já chegou, sem esperar
+  while (_client.available() > 0 && _len < sizeof(_buf) - 1) {
+    int n = _client.read((uint8_t*)_buf + _len, sizeof(_buf) - 1 - _len);
+    if (n <= 0) break;
+    _len += n;
+  }
+  _buf[_len] = 0;
+
+  char* hdrEnd = strstr(_buf, "\r\n\r\n");
+  bool complete = false;
+  if (hdrEnd) {
+    long contentLength = headerValue(_buf, hdrEnd, "Content-Length");
+    size_t got = _len - (hdrEnd + 4 - _buf);
+    complete = contentLength >= 0 && got >= (size_t)contentLength;
+  }
+  if (!complete && !_client.connected() && _client.available() == 0) {
+    // Servidor fechou: sem Content-Length o corpo vai até o fim
+    if (!hdrEnd) {
+      fail(nowMs);
+      return false;
+    }
+    complete = true;
+  }
+
+  if (!complete) {
+    if (_len >= sizeof(_buf) - 1) {
+      Serial.println("[CmdPoll] Resposta maior que o buffer");
+      fail(nowMs);
+    } else if (nowMs - _sentAt > _waitS * 1000UL + CMDPOLL_GRACE_MS) {
+      Serial.println("[CmdPoll] Timeout esperando resposta");
+      fail(nowMs);
+    }
+    return false;
+  }
+
+  return finishResponse(nowMs);
+}
+
+bool CommandPoll::finishResponse(uint32_t nowMs) {
+  char* hdrEnd = strstr(_buf, "\r\n\r\n");
+  int status = 0;
+  const char* sp = strchr(_buf, ' ');
+  if (sp) status = atoi(sp + 1);
+  _client.stop();
+  _state = CP_IDLE;
+
+  if (status == 502 || status == 504) {
+    // Proxy no caminho não segura tanto tempo: pede menos
+    uint16_t before = _waitS;
+    _waitS = _waitS / 2 < CMDPOLL_WAIT_MIN_S ? CMDPOLL_WAIT_MIN_S : _waitS / 2;
+    Serial.printf("[CmdPoll] HTTP %d, wait_s %u -> %u\n", status, before, _waitS);
+    fail(nowMs);
+    return false;
+  }
+  if (status != 200) {
+    Serial.printf("[CmdPoll] HTTP %d\n", status);
+    fail(nowMs);
+    return false;
+  }
+
+  bool longPoll = headerValue(_buf, hdrEnd, "X-Long-Poll") > 0;
+  if (longPoll == _legacy) {
+    Serial.println(longPoll ? "[CmdPoll] Servidor com long-poll"
+                            : "[CmdPoll] Servidor sem long-poll, poll a cada 1 s");
+  }
+  _legacy = !longPoll;
+  _backoffMs = 0;
+  _nextAt = _legacy ? nowMs + CMDPOLL_LEGACY_MS : nowMs;
+  _body = hdrEnd + 4;
+  return true;
+}
@@ -0,0 +1,92 @@
+//CommandPoll.h
+#ifndef COMMAND_POLL_H
+#define COMMAND_POLL_H
+
+#include <Arduino.h>
+#ifdef ESP8266
+  #include <ESP8266WiFi.h>
+  #include <WiFiClient.h>
+#else
+  #include <WiFi.h>
+  #include <WiFiClient.h>
+#endif
+
+/**
+ * Long-poll de comandos da dosadora (POST /iot/dosing/commands com wait_s)
+ *
+ * Antes: um HTTPClient novo por segundo (86k requisições/dia) para pegar
+ * dose manual que chega poucas vezes por semana. Agora o pedido fica
+ * aberto no servidor até CMDPOLL_WAIT_S e volta na hora em que um comando
+ * é enfileirado; o próximo pedido sai logo em seguida.
+ *
+ * Não bloqueia o loop(): só o connect TCP é síncrono; a espera é feita
+ * lendo o socket a cada chamada de loop(), então bombas em andamento
+ * continuam sendo desligadas no tempo certo.
+ *
+ * Fallback automático:
+ *  - servidor sem long-poll (sem header X-Long-Poll): volta ao poll de
+ *    CMDPOLL_LEGACY_MS, como antes;
+ *  - 502/504 (proxy cortou a espera): reduz o wait_s pela metade, até
+ *    CMDPOLL_WAIT_MIN_S;
+ *  - erro de rede: backoff exponencial até CMDPOLL_BACKOFF_MAX_MS.
+ *
+ * HTTP/1.0 + Connection: close para a resposta vir com Content-Length
+ * (sem chunked).
+ */
+
+#define CMDPOLL_WAIT_S          90      // espera pedida ao servidor
+#define CMDPOLL_WAIT_MIN_S      20
+#define CMDPOLL_GRACE_MS        15000UL // além do wait_s antes de desistir
+#define CMDPOLL_LEGACY_MS       1000UL
+#define CMDPOLL_BACKOFF_MIN_MS  2000UL
+#define CMDPOLL_BACKOFF_MAX_MS  30000UL
+#define CMDPOLL_BUF             1536    // headers + corpo da resposta
+
+class CommandPoll {
+public:
+  // serverUrl no formato http://host[:porta]/base (o mesmo do CloudAuth)
+  bool begin(const char* serverUrl, const char* espUid);
+
+  // Avança a máquina de estados; true quando chegou uma resposta 200
+  // (corpo em body() até a próxima chamada)
+  bool loop(uint32_t nowMs);
+
+  const char* body() const { return _body; }
+
+  bool     legacy() const { return _legacy; }
+  uint16_t waitS() const { return _waitS; }
+  uint32_t requests() const { return _requests; }
+  uint32_t failures() const { return _failures; }
+
+  // Derruba o pedido em andamento (WiFi caiu, OTA...)
+  void reset();
+
+private:
+  enum State { CP_IDLE, CP_WAITING };
+
+  bool startRequest(uint32_t nowMs);
+  bool finishResponse(uint32_t nowMs);
+  void fail(uint32_t nowMs);
+
+  WiFiClient _client;
+  State    _state = CP_IDLE;
+
+  char     _host[64] = {0};
+  uint16_t _port = 80;
+  char     _path[96] = {0};
+  char     _espUid[40] = {0};
+
+  char     _buf[CMDPOLL_BUF];
+  size_t   _len = 0;
+  char*    _body = nullptr;
+
+  uint16_t _waitS = CMDPOLL_WAIT_S;
+  bool     _legacy = false;
+  uint32_t _sentAt = 0;
+  uint32_t _nextAt = 0;
+  uint32_t _backoffMs = 0;
+  uint32_t _requests = 0;
+  uint32_t _failures = 0;
+};
+
+#endif
@@ -0,0 +1,161 @@
+//DoseJobs.cpp
+#include "DoseJobs.h"
+#include <math.h>
+
+// Preenche um job; false se o horário não cabe no offset de 20 bits
+// (só com horário inválido vindo da config)
+static bool fillJob(DoseJob& job, uint32_t offsetSec, uint8_t pumpIdx, uint8_t schedIdx,
+                    uint8_t doseIndex, float volumeMl) {
+  if (offsetSec > DOSE_JOB_MAX_OFFSET_S) return false;
+  float cml = roundf(volumeMl * 100.0f);
+  job.offsetSec  = offsetSec;
+  job.pumpIndex  = pumpIdx;
+  job.schedIndex = schedIdx;
+  job.doseIndex  = doseIndex;
+  job.volumeCml  = cml <= 0 ? 0 : cml >= (float)DOSE_JOB_MAX_CML ? DOSE_JOB_MAX_CML : (uint32_t)cml;
+  job.executed   = 0;
+  job.reserved   = 0;
+  return true;
+}
+
+uint16_t buildDoseJobs(const PumpConfig* pumps, uint8_t pumpCount,
+                       const Schedule* schedules, uint8_t scheduleCount,
+                       time_t now, DoseJob* jobs, uint16_t maxJobs,
+                       uint32_t& baseEpoch) {
+  uint16_t doseJobCount = 0;
+  baseEpoch = 0;
+  if (now == 0) return 0;
+
+  struct tm timeinfo;
+#if defined(ESP8266)
+  timeinfo = *localtime(&now);
+#else
+  localtime_r(&now, &timeinfo);
+#endif
+
+  uint8_t  weekday       = timeinfo.tm_wday; // 0=domingo..6=sábado
+  uint32_t todayMidnight = (uint32_t)now - (now % 86400);
+  uint32_t nowSec        = timeinfo.tm_hour * 3600u +
+                           timeinfo.tm_min  * 60u  +
+                           timeinfo.tm_sec;
+  baseEpoch = todayMidnight;
+
+  Serial.printf("[DoserControl] rebuildJobs() now=%lu weekday=%u todayMidnight=%lu nowSec=%lu\n",
+                (unsigned long)now,
+                (unsigned int)weekday,
+                (unsigned long)todayMidnight,
+                (unsigned long)nowSec);
+
+  for (uint8_t p = 0; p < pumpCount; p++) {
+    if (!pumps[p].enabled) continue;
+
+    for (uint8_t s = 0; s < scheduleCount; s++) {
+      const Schedule& sched = schedules[s];
+      if (!sched.enabled) continue;
+      if (sched.pumpIndex != p) continue;
+
+      uint32_t startSec = sched.startMin * 60u;
+      uint32_t endSec   = sched.endMin * 60u;
+
+      Serial.printf("[DoserControl]   pumpIdx=%u sched.id=%lu enabled=%u start=%lu end=%lu doses=%u daysMask=%u\n",
+                    p,
+                    (unsigned long)sched.id,
+                    (unsigned int)sched.enabled,
+                    (unsigned long)startSec,
+                    (unsigned long)endSec,
+                    (unsigned int)sched.dosesPerDay,
+                    (unsigned int)sched.daysMask);
+
+      uint8_t maskBit   = (1 << weekday);
+      bool todayValid   = (sched.daysMask & maskBit) != 0;
+
+      if (endSec <= startSec) continue; // janela vazia ou invertida, ignora
+      uint32_t rangeSec = endSec - startSec;
+
+      if (sched.dosesPerDay == 0) continue;
+
+      uint32_t intervalPerDose = rangeSec / sched.dosesPerDay;
+      float volumePerDose   = sched.volumePerDayMl / sched.dosesPerDay;
+
+      Serial.printf("[DoserControl]   rangeSec=%lu intervalPerDose=%lu volumePerDose=%u\n",
+                    (unsigned long)rangeSec,
+                    (unsigned long)intervalPerDose,
+                    (unsigned int)volumePerDose);
+
+      // Usar horários ajustados do backend se disponível
+      bool useAdjustedTimes = (sched.adjustedTimesCount > 0);
+      if (useAdjustedTimes) {
+        Serial.printf("[DoserControl]   Usando %d horários ajustados pelo backend\n",
+                      sched.adjustedTimesCount);
+      }
+      uint8_t numDoses = useAdjustedTimes ? sched.adjustedTimesCount : sched.dosesPerDay;
+
+      // Próximo dia válido na máscara (1 se a máscara estiver vazia, como antes)
+      int daysAhead = 1;
+      for (int d = 1; d <= 7; d++) {
+        uint8_t w = (weekday + d) % 7;
+        if (sched.daysMask & (1 << w)) {
+          daysAhead = d;
+          break;
+        }
+      }
+
+      // pass 0: doses HOJE (se hoje é válido e horário ainda não passou)
+      // pass 1: doses no PRÓXIMO dia válido
+      for (uint8_t pass = 0; pass < 2; pass++) {
+        if (pass == 0 && !todayValid) continue;
+        uint32_t dayOffset = pass == 0 ? 0 : (uint32_t)daysAhead * 86400u;
+
+        for (uint8_t d = 0; d < numDoses; d++) {
+          if (doseJobCount >= maxJobs) {
+            Serial.printf("[DoserControl] ⚠️  ERRO: Limite de %d jobs atingido!\n", maxJobs);
+            Serial.printf("[DoserControl] ⚠️  Bomba %s (ID:%lu) Schedule ID:%lu %snão foi agendada\n",
+                          pumps[p].name, (unsigned long)pumps[p].id, (unsigned long)sched.id,
+                          pass ? "(NEXTDAY) " : "");
+            Serial.println("[DoserControl] ⚠️  Reduza o número de doses diárias ou desative agendamentos desnecessários");
+            break;
+          }
+
+          // Usar horário ajustado ou calcular
+          uint32_t secSinceMidnight = useAdjustedTimes
+              ? sched.adjustedMin[d] * 60u
+              : (startSec + (d * intervalPerDose));
+
+          // Só pular se o horário já passou (está no passado)
+          if (pass == 0 && secSinceMidnight < nowSec) {
+            continue;
+          }
+
+          uint32_t whenEpoch = todayMidnight + dayOffset + secSinceMidnight;
+
+          time_t tWhen = (time_t)whenEpoch;
+          char bufWhen[20];
+          strftime(bufWhen, sizeof(bufWhen), "%Y-%m-%d %H:%M:%S", localtime(&tWhen));
+          Serial.printf("[DoserControl]   %s job: pumpId=%lu schedId=%lu when=%s (epoch=%lu, daysAhead=%d)\n",
+                        pass ? "NEXTDAY" : "TODAY",
+                        (unsigned long)pumps[p].id,
+                        (unsigned long)sched.id,
+                        bufWhen,
+                        (unsigned long)whenEpoch,
+                        pass ? daysAhead : 0);
+
+          // [FIX] Usar volume individual do backend se disponível, senão calcula
+          float doseVolume = volumePerDose;
+          if (sched.doseVolumesCount > 0 && d < sched.doseVolumesCount) {
+            doseVolume = sched.doseVolumeCml[d] * 0.01f;
+          }
+
+          if (!fillJob(jobs[doseJobCount], dayOffset + secSinceMidnight, p, s, d + 1, doseVolume)) {
+            Serial.printf("[DoserControl] ⚠️  Horário fora da faixa (schedId=%lu), dose ignorada\n",
+                          (unsigned long)sched.id);
+            continue;
+          }
+          doseJobCount++;
+        }
+      }
+    }
+  }
+
+  Serial.printf("[DoserControl] Rebuilt %d dose job(s) (futuro)\n", doseJobCount);
+  return doseJobCount;
+}
@@ -0,0 +1,21 @@
+//DoseJobs.h
+#ifndef DOSE_JOBS_H
+#define DOSE_JOBS_H
+
+#include <Arduino.h>
+#include <time.h>
+#include "DoserTypes.h"
+
+/**
+ * Montagem da tabela de jobs da dosadora (hoje + próximo dia válido)
+ *
+ * Separado do DoserControl para rodar também no host (host/job_replay_test
+ * compara com o algoritmo antigo). now já vem no fuso do usuário; baseEpoch
+ * recebe a meia-noite de hoje, referência de DoseJob::offsetSec.
+ */
+uint16_t buildDoseJobs(const PumpConfig* pumps, uint8_t pumpCount,
+                       const Schedule* schedules, uint8_t scheduleCount,
+                       time_t now, DoseJob* jobs, uint16_t maxJobs,
+                       uint32_t& baseEpoch);
+
+#endif
@@ -0,0 +1,536 @@
+//DoserConfigParser.cpp
+#include "DoserConfigParser.h"
+#include <string.h>
+#include <stdlib.h>
+
+namespace {
+
+// Valor escalar lido do JSON (objetos/arrays no lugar de escalar viram OTHER)
+struct Scalar {
+  enum Type { NUL, BOOL, NUMBER, STRING, OTHER } type;
+  bool   b;
+  double num;
+  char   str[48];
+};
+
+// Leitor byte a byte com um caractere de lookahead
+class Reader {
+public:
+  explicit Reader(Stream& in) : _in(in) {}
+
+  const char* error() const { return _err; }
+  bool fail(const char* e) {
+    if (!_err) _err = e;
+    return false;
+  }
+
+  // Próximo caractere não-branco, sem consumir; -1 no fim
+  int peek() {
+    while (true) {
+      int c = look();
+      if (c != ' ' && c != '\t' && c != '\r' && c != '\n') return c;
+      _look = -2;
+    }
+  }
+
+  int get() {
+    int c = look();
+    _look = -2;
+    return c;
+  }
+
+  bool expect(char c) {
+    if (peek() != c) return fail("caractere inesperado");
+    get();
+    return true;
+  }
+
+  // Itera os membros de um objeto já aberto com '{'. true = leu a chave e
+  // o ':'; false = fim do objeto ou erro (ver error())
+  bool member(bool& first, char* key, size_t cap) {
+    int c = peek();
+    if (c == '}') {
+      get();
+      return false;
+    }
+    if (!first) {
+      if (c != ',') return fail("esperado ',' ou '}'");
+      get();
+    }
+    first = false;
+    return readString(key, cap) && expect(':');
+  }
+
+  // Idem para arrays abertos com '['. true = há mais um elemento
+  bool element(bool& first) {
+    int c = peek();
+    if (c == ']') {
+      get();
+      return false;
+    }
+    if (!first) {
+      if (c != ',') return fail("esperado ',' ou ']'");
+      get();
+    }
+    first = false;
+    return true;
+  }
+
+  // String JSON; guarda até cap-1 bytes em buf (nullptr = só pula)
+  bool readString(char* buf, size_t cap) {
+    if (peek() != '"') return fail("esperado string");
+    get();
+    size_t n = 0;
+    bool truncated = false;
+    while (true) {
+      int c = get();
+      if (c < 0) return fail("string truncada");
+      if (c == '"') break;
+      if (c < 0x20) return fail("caractere de controle em string");
+
+      char utf8[4];
+      size_t len = 1;
+      utf8[0] = (char)c;
+      if (c == '\\') {
+        int e = get();
+        switch (e) {
+          case '"': case '\\': case '/': utf8[0] = (char)e; break;
+          case 'b': utf8[0] = '\b'; break;
+          case 'f': utf8[0] = '\f'; break;
+          case 'n': utf8[0] = '\n'; break;
+          case 'r': utf8[0] = '\r'; break;
+          case 't': utf8[0] = '\t'; break;
+          case 'u': {
+            uint32_t cp = 0;
+            for (int i = 0; i < 4; i++) {
+              int h = get();
+              int v = (h >= '0' && h <= '9') ? h - '0'
+                    : (h >= 'a' && h <= 'f') ? h - 'a' + 10
+                    : (h >= 'A' && h <= 'F') ? h - 'A' + 10 : -1;
+              if (v < 0) return fail("escape \\u inválido");
+              cp = (cp << 4) | (uint32_t)v;
+            }
+            if (cp >= 0xD800 && cp <= 0xDFFF) cp = '?';   // surrogates: não usados aqui
+            if (cp < 0x80) {
+              utf8[0] = (char)cp;
+            } else if (cp < 0x800) {
+              utf8[0] = (char)(0xC0 | (cp >> 6));
+              utf8[1] = (char)(0x80 | (cp & 0x3F));
+              len = 2;
+            } else {
+              utf8[0] = (char)(0xE0 | (cp >> 12));
+              utf8[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+              utf8[2] = (char)(0x80 | (cp & 0x3F));
+              len = 3;
+            }
+            break;
+          }
+          default:
+            return fail("escape inválido");
+        }
+      }
+
+      if (buf && !truncated) {
+        if (n + len < cap) {
+          memcpy(buf + n, utf8, len);
+          n += len;
+        } else {
+          truncated = true;
+        }
+      }
+    }
+    if (buf) {
+      // não deixa sequência UTF-8 pela metade no corte
+      if (truncated) {
+        size_t k = n;
+        while (k > 0 && ((uint8_t)buf[k - 1] & 0xC0) == 0x80) k--;
+        if (k > 0 && ((uint8_t)buf[k - 1] & 0x80)) {
+          uint8_t lead = (uint8_t)buf[k - 1];
+          size_t need = (lead & 0xE0) == 0xC0 ? 2 : (lead & 0xF0) == 0xE0 ? 3 : 4;
+          if (n - (k - 1) < need) n = k - 1;
+        }
+      }
+      buf[n] = 0;
+    }
+    return true;
+  }
+
+  // Qualquer valor; objeto/array é pulado e vira OTHER
+  bool readScalar(Scalar& v, int depth) {
+    int c = peek();
+    v.type = Scalar::OTHER;
+    if (c == '"') {
+      v.type = Scalar::STRING;
+      return readString(v.str, sizeof(v.str));
+    }
+    if (c == 't') {
+      v.type = Scalar::BOOL;
+      v.b = true;
+      return literal("true");
+    }
+    if (c == 'f') {
+      v.type = Scalar::BOOL;
+      v.b = false;
+      return literal("false");
+    }
+    if (c == 'n') {
+      v.type = Scalar::NUL;
+      return literal("null");
+    }
+    if (c == '-' || (c >= '0' && c <= '9')) {
+      v.type = Scalar::NUMBER;
+      return readNumber(v.num);
+    }
+    if (c == '{' || c == '[') return skipValue(depth);
+    return fail(c < 0 ? "JSON truncado" : "valor inválido");
+  }
+
+  // Pula um valor inteiro (profundidade limitada: pilha fixa)
+  bool skipValue(int depth) {
+    if (depth > DOSER_CFG_MAX_DEPTH) return fail("aninhamento excessivo");
+    int c = peek();
+    if (c == '{') {
+      get();
+      bool first = true;
+      while (member(first, nullptr, 0)) {
+        if (!skipValue(depth + 1)) return false;
+      }
+      return !_err;
+    }
+    if (c == '[') {
+      get();
+      bool first = true;
+      while (element(first)) {
+        if (!skipValue(depth + 1)) return false;
+      }
+      return !_err;
+    }
+    Scalar v;
+    return readScalar(v, depth);
+  }
+
+private:
+  int look() {
+    if (_look == -2) {
+      char c;
+      _look = _in.readBytes(&c, 1) == 1 ? (uint8_t)c : -1;
+    }
+    return _look;
+  }
+
+  bool literal(const char* word) {
+    for (const char* p = word; *p; p++) {
+      if (get() != *p) return fail("literal inválido");
+    }
+    return true;
+  }
+
+  bool readNumber(double& out) {
+    char buf[32];
+    size_t n = 0;
+    while (true) {
+      int c = look();
+      bool numChar = (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+      if (!numChar) break;
+      if (n >= sizeof(buf) - 1) return fail("número longo demais");
+      buf[n++] = (char)get();
+    }
+    buf[n] = 0;
+    char* end = nullptr;
+    out = strtod(buf, &end);
+    if (n == 0 || end != buf + n) return fail("número inválido");
+    return true;
+  }
+
+  Stream&     _in;
+  int         _look = -2;    // -2 = nada lido ainda
+  const char* _err = nullptr;
+};
+
+// Número (ou string numérica, como DECIMAL vindo do MariaDB)
+bool asNumber(const Scalar& v, double& out) {
+  if (v.type == Scalar::NUMBER) {
+    out = v.num;
+    return true;
+  }
+  if (v.type == Scalar::STRING && v.str[0]) {
+    char* end = nullptr;
+    out = strtod(v.str, &end);
+    return *end == 0;
+  }
+  return false;
+}
+
+double numberOr(const Scalar& v, double def) {
+  double d;
+  return asNumber(v, d) ? d : def;
+}
+
+// Inteiro sem sinal saturado (lixo/negativo não vira UB no cast)
+uint32_t uintOr(const Scalar& v, uint32_t def, uint32_t max) {
+  double d;
+  if (!asNumber(v, d)) return def;
+  if (!(d > 0)) return 0;
+  return d >= (double)max ? max : (uint32_t)d;
+}
+
+// enabled vem como bool (bombas) ou 0/1 (agendas, JSON_OBJECT do MariaDB);
+// null/ausente = habilitado
+bool boolOr(const Scalar& v, bool def) {
+  if (v.type == Scalar::BOOL) return v.b;
+  if (v.type == Scalar::NUMBER) return v.num != 0;
+  return def;
+}
+
+// "HH:MM" -> minutos desde a meia-noite (sem ':' = 0; lixo satura)
+uint16_t parseTimeToMinutes(const char* s) {
+  const char* colon = strchr(s, ':');
+  if (!colon) return 0;
+  // aritmética sem sinal: lixo dá um horário inválido, não overflow
+  uint32_t hours = (uint32_t)strtol(s, nullptr, 10);
+  uint32_t minutes = (uint32_t)strtol(colon + 1, nullptr, 10);
+  uint32_t total = hours * 60u + minutes;
+  return total > UINT16_MAX || hours > UINT16_MAX ? UINT16_MAX : (uint16_t)total;
+}
+
+// mL -> 0,01 mL (saturado na largura do DoseJob, ~167 L por dose)
+uint32_t toCml(double ml) {
+  double cml = ml * 100.0 + 0.5;
+  if (!(cml > 0)) return 0;
+  return cml >= DOSE_JOB_MAX_CML ? DOSE_JOB_MAX_CML : (uint32_t)cml;
+}
+
+bool parseSchedule(Reader& r, Schedule& s, uint8_t pumpIndex, int depth) {
+  memset(&s, 0, sizeof(s));
+  s.enabled        = true;
+  s.daysMask       = 127;
+  s.dosesPerDay    = 1;
+  s.volumePerDayMl = 10;
+  s.pumpIndex      = pumpIndex;
+
+  if (!r.expect('{')) return false;
+  bool first = true;
+  char key[24];
+  while (r.member(first, key, sizeof(key))) {
+    // arrays (só se vierem como array; string/null são ignorados)
+    if (strcmp(key, "adjusted_times") == 0 && r.peek() == '[') {
+      r.get();
+      bool f = true;
+      while (r.element(f)) {
+        Scalar t;
+        if (!r.readScalar(t, depth + 2)) return false;
+        if (t.type == Scalar::STRING && t.str[0] && s.adjustedTimesCount < 24) {
+          s.adjustedMin[s.adjustedTimesCount++] = parseTimeToMinutes(t.str);
+        }
+      }
+      if (r.error()) return false;
+      continue;
+    }
+    if (strcmp(key, "dose_volumes") == 0 && r.peek() == '[') {
+      r.get();
+      bool f = true;
+      while (r.element(f)) {
+        Scalar t;
+        if (!r.readScalar(t, depth + 2)) return false;
+        if (s.doseVolumesCount < 24) {
+          s.doseVolumeCml[s.doseVolumesCount++] = toCml(numberOr(t, 0));
+        }
+      }
+      if (r.error()) return false;
+      continue;
+    }
+
+    Scalar v;
+    if (!r.readScalar(v, depth + 1)) return false;
+    if      (strcmp(key, "id") == 0)                s.id = uintOr(v, 0, UINT32_MAX);
+    else if (strcmp(key, "enabled") == 0)           s.enabled = boolOr(v, true);
+    else if (strcmp(key, "days_mask") == 0)         s.daysMask = (uint8_t)uintOr(v, 127, 127);
+    else if (strcmp(key, "doses_per_day") == 0)     s.dosesPerDay = (uint8_t)uintOr(v, 1, UINT8_MAX);
+    else if (strcmp(key, "volume_per_day_ml") == 0) s.volumePerDayMl = (float)numberOr(v, 10);
+    else if (strcmp(key, "min_gap_minutes") == 0)   s.minGapMinutes = (uint16_t)uintOr(v, 0, UINT16_MAX);
+    else if (strcmp(key, "start_time") == 0 && v.type == Scalar::STRING)
+      s.startMin = parseTimeToMinutes(v.str);
+    else if (strcmp(key, "end_time") == 0 && v.type == Scalar::STRING)
+      s.endMin = parseTimeToMinutes(v.str);
+  }
+  return !r.error();
+}
+
+bool parsePump(Reader& r, DoserConfigStage& cfg, int depth) {
+  PumpConfig& p = cfg.pumps[cfg.pumpCount];
+  memset(&p, 0, sizeof(p));
+  p.index             = cfg.pumpCount;
+  p.enabled           = true;
+  p.calibMlPerSec     = 1.0f;
+  p.maxDailyMl        = 100;
+  p.currentVolumeMl   = 500;
+  p.containerVolumeMl = 500;
+  p.alarmThresholdPct = 10;
+
+  if (!r.expect('{')) return false;
+  bool first = true;
+  char key[24];
+  while (r.member(first, key, sizeof(key))) {
+    if (strcmp(key, "schedules") == 0 && r.peek() == '[') {
+      r.get();
+      bool f = true;
+      while (r.element(f)) {
+        if (cfg.scheduleCount < MAX_SCHEDULES) {
+          if (!parseSchedule(r, cfg.schedules[cfg.scheduleCount], cfg.pumpCount, depth + 2)) return false;
+          cfg.scheduleCount++;
+        } else if (!r.skipValue(depth + 2)) {
+          return false;
+        }
+      }
+      if (r.error()) return false;
+      continue;
+    }
+    if (strcmp(key, "name") == 0 && r.peek() == '"') {
+      if (!r.readString(p.name, sizeof(p.name))) return false;
+      continue;
+    }
+
+    Scalar v;
+    if (!r.readScalar(v, depth + 1)) return false;
+    if      (strcmp(key, "id") == 0)                    p.id = uintOr(v, 0, UINT32_MAX);
+    else if (strcmp(key, "enabled") == 0)               p.enabled = boolOr(v, true);
+    else if (strcmp(key, "calibration_rate_ml_s") == 0) p.calibMlPerSec = (float)numberOr(v, 1.0);
+    else if (strcmp(key, "max_daily_ml") == 0)          p.maxDailyMl = (uint16_t)uintOr(v, 100, UINT16_MAX);
+    else if (strcmp(key, "current_volume_ml") == 0)     p.currentVolumeMl = (uint16_t)uintOr(v, 500, UINT16_MAX);
+    else if (strcmp(key, "container_volume_ml") == 0)   p.containerVolumeMl = (uint16_t)uintOr(v, 500, UINT16_MAX);
+    else if (strcmp(key, "alarm_threshold_pct") == 0)   p.alarmThresholdPct = (uint8_t)uintOr(v, 10, UINT8_MAX);
+  }
+  return !r.error();
+}
+
+void writeJsonString(Print& out, const char* s) {
+  out.print('"');
+  for (; *s; s++) {
+    uint8_t c = (uint8_t)*s;
+    if (c == '"' || c == '\\') {
+      out.print('\\');
+      out.print((char)c);
+    } else if (c < 0x20) {
+      out.printf("\\u%04x", c);
+    } else {
+      out.print((char)c);
+    }
+  }
+  out.print('"');
+}
+
+void writeTime(Print& out, uint16_t min) {
+  out.printf("\"%02u:%02u\"", (unsigned)(min / 60), (unsigned)(min % 60));
+}
+
+} // namespace
+
+bool parseDoserConfig(Stream& in, DoserConfigStage& out, const char** error) {
+  memset(&out, 0, sizeof(out));
+  Reader r(in);
+
+  bool ok = r.expect('{');
+  bool first = true;
+  char key[24];
+  while (ok && r.member(first, key, sizeof(key))) {
+    if (strcmp(key, "pumps") == 0 && r.peek() == '[') {
+      r.get();
+      out.hasPumps = true;
+      bool f = true;
+      while (ok && r.element(f)) {
+        if (out.pumpCount < MAX_PUMPS) {
+          ok = parsePump(r, out, 3);
+          if (ok) out.pumpCount++;
+        } else {
+          ok = r.skipValue(3);
+        }
+      }
+      continue;
+    }
+    if (strcmp(key, "volumes") == 0 && r.peek() == '{') {
+      r.get();
+      bool f = true;
+      char id[12];
+      while (ok && r.member(f, id, sizeof(id))) {
+        Scalar v;
+        ok = r.readScalar(v, 3);
+        double ml;
+        if (ok && asNumber(v, ml) && out.volumeCount < MAX_PUMPS) {
+          out.volumes[out.volumeCount].pumpId = (uint32_t)strtoul(id, nullptr, 10);
+          out.volumes[out.volumeCount].volumeMl = (uint16_t)uintOr(v, 0, UINT16_MAX);
+          out.volumeCount++;
+        }
+      }
+      continue;
+    }
+    if (strcmp(key, "config_version") == 0 && r.peek() == '"') {
+      ok = r.readString(out.version, sizeof(out.version));
+      continue;
+    }
+
+    Scalar v;
+    ok = r.readScalar(v, 2);
+    double d;
+    if (!ok) break;
+    if (strcmp(key, "user_utc_offset_sec") == 0 && asNumber(v, d)) {
+      out.hasOffset = true;
+      out.utcOffsetSec = d < -86400 ? -86400 : d > 86400 ? 86400 : (int32_t)d;
+    } else if (strcmp(key, "unchanged") == 0) {
+      out.unchanged = boolOr(v, false);
+    }
+  }
+
+  if (r.error()) {
+    if (error) *error = r.error();
+    return false;
+  }
+  return ok;
+}
+
+void writeDoserConfig(Print& out,
+                      const PumpConfig* pumps, uint8_t pumpCount,
+                      const Schedule* schedules, uint8_t scheduleCount,
+                      const char* version, int32_t utcOffsetSec) {
+  out.print("{\"config_version\":");
+  writeJsonString(out, version ? version : "");
+  out.printf(",\"user_utc_offset_sec\":%ld,\"pumps\":[", (long)utcOffsetSec);
+
+  for (uint8_t p = 0; p < pumpCount; p++) {
+    const PumpConfig& pc = pumps[p];
+    if (p) out.print(',');
+    out.printf("{\"id\":%lu,\"enabled\":%s,\"name\":", (unsigned long)pc.id, pc.enabled ? "true" : "false");
+    writeJsonString(out, pc.name);
+    out.printf(",\"calibration_rate_ml_s\":%.6f,\"max_daily_ml\":%u,\"current_volume_ml\":%u,"
+               "\"container_volume_ml\":%u,\"alarm_threshold_pct\":%u,\"schedules\":[",
+               (double)pc.calibMlPerSec, (unsigned)pc.maxDailyMl, (unsigned)pc.currentVolumeMl,
+               (unsigned)pc.containerVolumeMl, (unsigned)pc.alarmThresholdPct);
+
+    bool firstSched = true;
+    for (uint8_t s = 0; s < scheduleCount; s++) {
+      const Schedule& sc = schedules[s];
+      if (sc.pumpIndex != p) continue;
+      if (!firstSched) out.print(',');
+      firstSched = false;
+      out.printf("{\"id\":%lu,\"enabled\":%d,\"days_mask\":%u,\"doses_per_day\":%u,"
+                 "\"volume_per_day_ml\":%.4f,\"min_gap_minutes\":%u,\"start_time\":",
+                 (unsigned long)sc.id, sc.enabled ? 1 : 0, (unsigned)sc.daysMask,
+                 (unsigned)sc.dosesPerDay, (double)sc.volumePerDayMl, (unsigned)sc.minGapMinutes);
+      writeTime(out, sc.startMin);
+      out.print(",\"end_time\":");
+      writeTime(out, sc.endMin);
+      out.print(",\"adjusted_times\":[");
+      for (uint8_t i = 0; i < sc.adjustedTimesCount; i++) {
+        if (i) out.print(',');
+        writeTime(out, sc.adjustedMin[i]);
+      }
+      out.print("],\"dose_volumes\":[");
+      for (uint8_t i = 0; i < sc.doseVolumesCount; i++) {
+        out.printf(i ? ",%lu.%02u" : "%lu.%02u", (unsigned long)(sc.doseVolumeCml[i] / 100u),
+                   (unsigned)(sc.doseVolumeCml[i] % 100u));
+      }
+      out.print("]}");
+    }
+    out.print("]}");
+  }
+  out.print("]}");
+}
@@ -0,0 +1,65 @@
+//DoserConfigParser.h
+#ifndef DOSER_CONFIG_PARSER_H
+#define DOSER_CONFIG_PARSER_H
+
+#include <Arduino.h>
+#include "DoserTypes.h"
+
+/**
+ * Parser em streaming da config da dosadora (resposta do handshake e
+ * /doser_config.json)
+ *
+ * Antes a resposta inteira virava String + DynamicJsonDocument(8192) e só
+ * então o DoserControl andava pelas bombas. Aqui o JSON é lido byte a byte
+ * do Stream (WiFiClient do HTTPClient ou File) e cada campo conhecido cai
+ * direto em PumpConfig/Schedule; o resto é pulado sem guardar nada. Memória
+ * fixa: o DoserConfigStage (~1,5 KB, alocado só durante o handshake) e a
+ * pilha do descendente recursivo (profundidade limitada).
+ *
+ * Entrada inválida (truncada, tipos trocados, aninhamento absurdo) devolve
+ * false e o stage deve ser descartado: nada é aplicado pela metade.
+ *
+ * Chaves lidas (as mesmas do backend):
+ *   config_version, user_utc_offset_sec, unchanged, volumes{"<id>":ml},
+ *   pumps[{ id, enabled, name, calibration_rate_ml_s, max_daily_ml,
+ *           current_volume_ml, container_volume_ml, alarm_threshold_pct,
+ *           schedules[{ id, enabled, days_mask, doses_per_day,
+ *                       volume_per_day_ml, min_gap_minutes, start_time,
+ *                       end_time, adjusted_times[], dose_volumes[] }] }]
+ */
+
+#define DOSER_CFG_MAX_DEPTH   8    // objetos/arrays aninhados aceitos
+#define DOSER_CFG_VERSION_LEN 24
+
+struct PumpVolume {
+  uint32_t pumpId;
+  uint16_t volumeMl;
+};
+
+struct DoserConfigStage {
+  PumpConfig pumps[MAX_PUMPS];
+  uint8_t    pumpCount;
+  Schedule   schedules[MAX_SCHEDULES];
+  uint8_t    scheduleCount;
+
+  char       version[DOSER_CFG_VERSION_LEN];
+  bool       hasOffset;
+  int32_t    utcOffsetSec;
+
+  bool       hasPumps;            // veio "pumps" (config completa)
+  bool       unchanged;           // resposta "unchanged" do handshake
+  PumpVolume volumes[MAX_PUMPS];  // volumes da resposta "unchanged"
+  uint8_t    volumeCount;
+};
+
+// Lê um objeto JSON do stream para o stage; false + *error em entrada
+// inválida. Para no '}' final (não espera EOF do socket).
+bool parseDoserConfig(Stream& in, DoserConfigStage& out, const char** error = nullptr);
+
+// Escreve a config no mesmo formato que parseDoserConfig lê
+void writeDoserConfig(Print& out,
+                      const PumpConfig* pumps, uint8_t pumpCount,
+                      const Schedule* schedules, uint8_t scheduleCount,
+                      const char* version, int32_t utcOffsetSec);
+
+#endif
@@ -1,11 +1,14 @@
 //DoserControl.cpp
 #include "DoserControl.h"
+#include "DoseJobs.h"
 #ifdef ESP8266
   #include <LittleFS.h>
   #define SPIFFS LittleFS
 #else
   #include <SPIFFS.h>
 #endif
+#include <memory>
+#include <new>
 
 DoserControl::DoserControl() {
   manualRun.active   = false;
@@ -40,369 +43,179 @@ void DoserControl::initPins(const int* pins) {
   Serial.println("[DoserControl] GPIO pins initialized");
 }
 
-void DoserControl::saveConfigToFile(const JsonDocument& config) {
+void DoserControl::saveConfigToFile() {
+  extern int32_t g_userUtcOffsetSec;  // já está no CloudAuthDoser.cpp
+
   File f = SPIFFS.open("/doser_config.json", "w");
   if (!f) {
     Serial.println("[DoserControl] Falha ao abrir /doser_config.json para escrita");
     return;
   }
-  serializeJson(config, f);
+  // Gravado direto das structs (sem montar documento em RAM)
+  writeDoserConfig(f, pumps, pumpCount, schedules, scheduleCount,
+                   configVersion.c_str(), g_userUtcOffsetSec);
   f.close();
-  Serial.println("[DoserControl] Config salva em /doser_config.json");
+  configWrites++;
+  Serial.printf("[DoserControl] Config salva em /doser_config.json (%lu gravações desde o boot)\n",
+                (unsigned long)configWrites);
 }
 
-void DoserControl::loadFromServer(const JsonDocument& config) {
-  Serial.println("[DoserControl] Carregando config do servidor...");
-
-  if (!config.containsKey("pumps")) {
-    Serial.println("[DoserControl] Nenhuma bomba na config");
-    return;
-  }
-
-  JsonArrayConst pumpsArray = config["pumps"].as<JsonArrayConst>();
-  pumpCount     = 0;
-  scheduleCount = 0;
-
-  for (JsonObjectConst pumpObj : pumpsArray) {
-    if (pumpCount >= MAX_PUMPS) break;
-
-    PumpConfig& pump = pumps[pumpCount];
-    if (pumpObj["id"].is<const char*>()) {
-      pump.id = String(pumpObj["id"].as<const char*>()).toInt();
-    } else {
-      pump.id = pumpObj["id"].as<uint32_t>();  // se vier numérico
-    }
-    pump.index              = pumpCount;
-    pump.enabled = pumpObj["enabled"].isNull()
-               ? true
-               : pumpObj["enabled"].as<bool>();    pump.calibMlPerSec      = pumpObj["calibration_rate_ml_s"] | 1.0f;
-    pump.maxDailyMl         = pumpObj["max_daily_ml"] | 100;
-    pump.currentVolumeMl    = pumpObj["current_volume_ml"] | 500;
-    pump.containerVolumeMl  = pumpObj["container_volume_ml"] | 500;
-    pump.alarmThresholdPct  = pumpObj["alarm_threshold_pct"] | 10;
-    pump.name               = pumpObj["name"].as<String>();
-
-    Serial.printf("[DoserControl] Pump %d: %s (%.1f mL/s)\n",
-                  pumpCount, pump.name.c_str(), pump.calibMlPerSec);
-
-    // NOVO LOG:
-    Serial.printf("[DoserControl]   Pump DB id=%lu index=%u\n",
-                  pump.id, pump.index);
-
-
-    if (pumpObj.containsKey("schedules")) {
-      JsonArrayConst schedArray = pumpObj["schedules"].as<JsonArrayConst>();
-
-      for (JsonObjectConst schedObj : schedArray) {
-        if (scheduleCount >= MAX_SCHEDULES) break;
-
-        Schedule& sched    = schedules[scheduleCount];
-        sched.id           = schedObj["id"] | 0;
-        sched.enabled = schedObj["enabled"].isNull()
-                        ? true
-                        : schedObj["enabled"].as<bool>();
-        sched.daysMask     = schedObj["days_mask"] | 127;
-        sched.dosesPerDay  = schedObj["doses_per_day"] | 1;
-        sched.pumpIndex    = pumpCount;  
-
-        // DEBUG: logar o valor bruto do JSON
-        JsonVariantConst volVar = schedObj["volume_per_day_ml"];
-        Serial.print("[DoserControl]   raw volume_per_day_ml = ");
-        serializeJson(volVar, Serial);
-        Serial.println();
-
-        // volume_per_day_ml vindo como número (int/float/double)
-        if (!volVar.isNull()) {
-          double vol = volVar.as<double>();
-          sched.volumePerDayMl = (float)vol;
-        } else {
-          sched.volumePerDayMl = 10;
-        }
-
-        sched.minGapMinutes  = schedObj["min_gap_minutes"] | 0;
-
-        String startStr = schedObj["start_time"].as<String>();
-        String endStr   = schedObj["end_time"].as<String>();
-
-        sched.startSecSinceMidnight = parseTimeToSeconds(startStr);
-        sched.endSecSinceMidnight   = parseTimeToSeconds(endStr);
-
-        // Ler horários ajustados do backend (se existir)
-        sched.adjustedTimesCount = 0;
-        if (schedObj.containsKey("adjusted_times") && !schedObj["adjusted_times"].isNull()) {
-          JsonArrayConst adjTimes = schedObj["adjusted_times"].as<JsonArrayConst>();
-          uint8_t idx = 0;
-          for (JsonVariantConst timeVar : adjTimes) {
-            if (idx >= 24) break;  // Máximo 24 horários
-            String timeStr = timeVar.as<String>();
-            if (timeStr.length() > 0) {
-              sched.adjustedTimes[idx] = parseTimeToSeconds(timeStr);
-              idx++;
-            }
-          }
-          sched.adjustedTimesCount = idx;
-          Serial.printf("[DoserControl]   Schedule %d tem %d horários ajustados pelo backend:\n",
-                        scheduleCount, sched.adjustedTimesCount);
-          for (uint8_t i = 0; i < idx; i++) {
-            uint32_t sec = sched.adjustedTimes[i];
-            uint8_t h = sec / 3600;
-            uint8_t m = (sec % 3600) / 60;
-            uint8_t s = sec % 60;
-            Serial.printf("[DoserControl]     [%d] %02d:%02d:%02d (%lu sec)\n",
-                          i, h, m, s, (unsigned long)sec);
-          }
-        }
-
-        // [FIX] Ler volumes individuais por dose do backend (garantem total exato)
-        sched.doseVolumesCount = 0;
-        if (schedObj.containsKey("dose_volumes") && !schedObj["dose_volumes"].isNull()) {
-          JsonArrayConst doseVols = schedObj["dose_volumes"].as<JsonArrayConst>();
-          uint8_t idx = 0;
-          for (JsonVariantConst volVar : doseVols) {
-            if (idx >= 24) break;
-            sched.doseVolumes[idx] = (float)volVar.as<double>();
-            idx++;
-          }
-          sched.doseVolumesCount = idx;
-          Serial.printf("[DoserControl]   Schedule %d tem %d volumes individuais: ",
-                        scheduleCount, sched.doseVolumesCount);
-          for (uint8_t i = 0; i < idx; i++) {
-            Serial.printf("%.2f", (double)sched.doseVolumes[i]);
-            if (i < idx - 1) Serial.print(", ");
-          }
-          Serial.println(" ml");
-        }
-
-        float volumePerDose = (sched.dosesPerDay > 0)
-                                ? (sched.volumePerDayMl / sched.dosesPerDay)
-                                : 0;
-
-        Serial.printf("[DoserControl]   Schedule %d: %u doses/day, %.2f mL/day (~%.2f mL/dose), daysMask=%u\n",
-                      scheduleCount,
-                      (unsigned int)sched.dosesPerDay,
-                      (double)sched.volumePerDayMl,
-                      (double)volumePerDose,
-                      (unsigned int)sched.daysMask);
+bool DoserControl::loadFromFile() {
+  extern int32_t g_userUtcOffsetSec;
 
+  File f = SPIFFS.open("/doser_config.json", "r");
+  if (!f) return false;
 
-        scheduleCount++;
-      }
-    }
-
-    pumpCount++;
+  std::unique_ptr<DoserConfigStage> cfg(new (std::nothrow) DoserConfigStage());
+  if (!cfg) {
+    f.close();
+    Serial.println("[DoserControl] Sem memória para ler config local");
+    return false;
   }
-
-  Serial.printf("[DoserControl] Carregadas %d bombas, %d agendas\n", pumpCount, scheduleCount);
-
-  extern int32_t g_userUtcOffsetSec;  // já está no CloudAuthDoser.cpp
-
-  time_t nowUtc = time(nullptr);
-  time_t nowUsr = nowUtc + g_userUtcOffsetSec;
-
-  // só considera válido se já passou de um epoch "razoável"
-  if (nowUsr > 1700000000) {
-    Serial.printf("[DoserControl] rebuildJobs() inicial com now=%lu\n",
-                  (unsigned long)nowUsr);
-    rebuildJobs(nowUsr);
-  } else {
-    Serial.printf("[DoserControl] Horario invalido (now=%lu), adiando rebuildJobs\n",
-                  (unsigned long)nowUsr);
+  const char* err = nullptr;
+  bool ok = parseDoserConfig(f, *cfg, &err);
+  f.close();
+  if (!ok) {
+    Serial.printf("[DoserControl] /doser_config.json inválido: %s\n", err ? err : "?");
+    return false;
   }
 
-
-  // Persistir config local para operar offline depois
-  saveConfigToFile(config);
+  if (cfg->hasOffset) {
+    g_userUtcOffsetSec = cfg->utcOffsetSec;
+  }
+  applyConfig(*cfg, false);
+  return pumpCount > 0;
 }
 
-void DoserControl::rebuildJobs(time_t now) {
-  doseJobCount = 0;
-  if (now == 0) return;
-
-  struct tm timeinfo;
-#if defined(ESP8266)
-  timeinfo = *localtime(&now);
-#else
-  localtime_r(&now, &timeinfo);
-#endif
-
-  uint8_t  weekday       = timeinfo.tm_wday; // 0=domingo..6=sábado
-  uint32_t todayMidnight = (uint32_t)now - (now % 86400);
-  uint32_t nowSec        = timeinfo.tm_hour * 3600u +
-                           timeinfo.tm_min  * 60u  +
-                           timeinfo.tm_sec;
+// currentVolumeMl não entra: é estado de execução, não config
+bool DoserControl::samePump(const PumpConfig& a, const PumpConfig& b) {
+  return a.id == b.id &&
+         a.enabled == b.enabled &&
+         a.calibMlPerSec == b.calibMlPerSec &&
+         a.maxDailyMl == b.maxDailyMl &&
+         a.containerVolumeMl == b.containerVolumeMl &&
+         a.alarmThresholdPct == b.alarmThresholdPct &&
+         strcmp(a.name, b.name) == 0;
+}
 
-  Serial.printf("[DoserControl] rebuildJobs() now=%lu weekday=%u todayMidnight=%lu nowSec=%lu\n",
-                (unsigned long)now,
-                (unsigned int)weekday,
-                (unsigned long)todayMidnight,
-                (unsigned long)nowSec);
+bool DoserControl::sameSchedule(const Schedule& a, const Schedule& b) {
+  if (a.id != b.id || a.enabled != b.enabled || a.daysMask != b.daysMask ||
+      a.dosesPerDay != b.dosesPerDay || a.volumePerDayMl != b.volumePerDayMl ||
+      a.minGapMinutes != b.minGapMinutes ||
+      a.startMin != b.startMin || a.endMin != b.endMin ||
+      a.pumpIndex != b.pumpIndex ||
+      a.adjustedTimesCount != b.adjustedTimesCount ||
+      a.doseVolumesCount != b.doseVolumesCount) {
+    return false;
+  }
+  return memcmp(a.adjustedMin, b.adjustedMin, a.adjustedTimesCount * sizeof(a.adjustedMin[0])) == 0 &&
+         memcmp(a.doseVolumeCml, b.doseVolumeCml, a.doseVolumesCount * sizeof(a.doseVolumeCml[0])) == 0;
+}
 
-  for (uint8_t p = 0; p < pumpCount; p++) {
-    if (!pumps[p].enabled) continue;
+bool DoserControl::applyConfig(const DoserConfigStage& config, bool persist) {
+  if (!config.hasPumps) {
+    Serial.println("[DoserControl] Nenhuma bomba na config");
+    return false;
+  }
 
-    for (uint8_t s = 0; s < scheduleCount; s++) {
-      Schedule& sched = schedules[s];
-      if (!sched.enabled) continue;
-      if (sched.pumpIndex != p) continue;
+  // Compara posição a posição com o que já está carregado e só sobrescreve
+  // o que mudou; jobs só são refeitos se agenda ou bomba habilitada mudou
+  uint8_t changedPumps  = 0;
+  uint8_t changedScheds = 0;
+  bool    jobsDirty     = false;
+
+  for (uint8_t i = 0; i < config.pumpCount; i++) {
+    const PumpConfig& incoming = config.pumps[i];
+    PumpConfig& pump = pumps[i];
+    if (i >= pumpCount || !samePump(pump, incoming)) {
+      if (i >= pumpCount || pump.id != incoming.id || pump.enabled != incoming.enabled) {
+        jobsDirty = true;
+      }
+      pump = incoming;
+      changedPumps++;
+      Serial.printf("[DoserControl] Pump %d: %s (%.1f mL/s) DB id=%lu\n",
+                    i, pump.name, pump.calibMlPerSec,
+                    (unsigned long)pump.id);
+    } else {
+      pump.currentVolumeMl = incoming.currentVolumeMl;
+    }
+  }
 
-      Serial.printf("[DoserControl]   pumpIdx=%u sched.id=%lu enabled=%u start=%u end=%u doses=%u daysMask=%u\n",
-                    p,
+  for (uint8_t i = 0; i < config.scheduleCount; i++) {
+    const Schedule& incomingSched = config.schedules[i];
+    Schedule& sched = schedules[i];
+    if (i >= scheduleCount || !sameSchedule(sched, incomingSched)) {
+      sched = incomingSched;
+      changedScheds++;
+      jobsDirty = true;
+      Serial.printf("[DoserControl]   Schedule %d (id=%lu): %u doses/day, %.2f mL/day, daysMask=%u, %u horários e %u volumes do backend\n",
+                    i,
                     (unsigned long)sched.id,
-                    (unsigned int)sched.enabled,
-                    sched.startSecSinceMidnight,
-                    sched.endSecSinceMidnight,
                     (unsigned int)sched.dosesPerDay,
-                    (unsigned int)sched.daysMask);
-
-      uint8_t maskBit   = (1 << weekday);
-      bool todayValid   = (sched.daysMask & maskBit) != 0;
-
-      uint32_t rangeSec = 0;
-      if (sched.endSecSinceMidnight > sched.startSecSinceMidnight) {
-        rangeSec = sched.endSecSinceMidnight - sched.startSecSinceMidnight;
-      } else if (sched.endSecSinceMidnight == sched.startSecSinceMidnight) {
-        continue;
-      } else {
-        continue; // janela invertida, ignora
-      }
-
-      if (rangeSec == 0 || sched.dosesPerDay == 0) continue;
-
-      uint32_t intervalPerDose = rangeSec / sched.dosesPerDay;
-      float volumePerDose   = sched.volumePerDayMl / sched.dosesPerDay;
-
-      Serial.printf("[DoserControl]   rangeSec=%lu intervalPerDose=%lu volumePerDose=%u\n",
-                    (unsigned long)rangeSec,
-                    (unsigned long)intervalPerDose,
-                    (unsigned int)volumePerDose);
-
-      // Usar horários ajustados do backend se disponível
-      bool useAdjustedTimes = (sched.adjustedTimesCount > 0);
-      if (useAdjustedTimes) {
-        Serial.printf("[DoserControl]   Usando %d horários ajustados pelo backend\n",
-                      sched.adjustedTimesCount);
-      }
-
-      // 1) Doses HOJE (se hoje é válido e horário ainda não passou)
-      if (todayValid) {
-        uint8_t numDoses = useAdjustedTimes ? sched.adjustedTimesCount : sched.dosesPerDay;
-        for (uint8_t d = 0; d < numDoses; d++) {
-          if (doseJobCount >= MAX_DOSE_JOBS) {
-            Serial.printf("[DoserControl] ⚠️  ERRO: Limite de %d jobs atingido!\n", MAX_DOSE_JOBS);
-            Serial.printf("[DoserControl] ⚠️  Bomba %s (ID:%lu) Schedule ID:%lu não foi agendada\n",
-                          pumps[p].name.c_str(), pumps[p].id, (unsigned long)sched.id);
-            Serial.println("[DoserControl] ⚠️  Reduza o número de doses diárias ou desative agendamentos desnecessários");
-            break;
-          }
-
-          // Usar horário ajustado ou calcular
-          uint32_t secSinceMidnight = useAdjustedTimes
-              ? sched.adjustedTimes[d]
-              : (sched.startSecSinceMidnight + (d * intervalPerDose));
-
-          // Só pular se o horário já passou (está no passado)
-          if (secSinceMidnight < nowSec) {
-            continue;
-          }
-
-          uint32_t whenEpoch = todayMidnight + secSinceMidnight;
-
-          // formata em data/hora legível
-          time_t tNow  = (time_t)now;
-          time_t tWhen = (time_t)whenEpoch;
-          char bufNow[20];
-          char bufWhen[20];
-          strftime(bufNow,  sizeof(bufNow),  "%Y-%m-%d %H:%M:%S", localtime(&tNow));
-          strftime(bufWhen, sizeof(bufWhen), "%Y-%m-%d %H:%M:%S", localtime(&tWhen));
-
+                    (double)sched.volumePerDayMl,
+                    (unsigned int)sched.daysMask,
+                    (unsigned int)sched.adjustedTimesCount,
+                    (unsigned int)sched.doseVolumesCount);
+    }
+  }
 
-          Serial.printf("[DoserControl]   TODAY job: pumpId=%lu schedId=%lu when=%s now=%s (epoch=%lu)\n",
-                        pumps[p].id,
-                        (unsigned long)sched.id,
-                        bufWhen,
-                        bufNow,
-                        (unsigned long)whenEpoch);
+  bool removed = config.pumpCount < pumpCount || config.scheduleCount < scheduleCount;
+  if (removed) jobsDirty = true;
+  pumpCount     = config.pumpCount;
+  scheduleCount = config.scheduleCount;
 
+  String newVersion = config.version;
+  bool versionChanged = newVersion != configVersion;
+  configVersion = newVersion;
 
-          // [FIX] Usar volume individual do backend se disponível, senão calcula
-          float doseVolume = volumePerDose;
-          if (sched.doseVolumesCount > 0 && d < sched.doseVolumesCount) {
-            doseVolume = sched.doseVolumes[d];
-          }
+  bool changed = changedPumps > 0 || changedScheds > 0 || removed;
+  if (!changed && !versionChanged) {
+    Serial.println("[DoserControl] Config igual à atual, nada a aplicar");
+    return false;
+  }
 
-          DoseJob& job   = doseJobs[doseJobCount];
-          job.pumpId     = pumps[p].id;
-          job.scheduleId = sched.id;
-          job.volumeMl   = doseVolume;
-          job.whenEpoch  = whenEpoch;
-          job.executed   = false;
-          job.retries    = 0;
-          job.minGapSec  = sched.minGapMinutes * 60;  // [NOVO] Converter minutos para segundos
-          job.doseIndex  = d + 1;
-          doseJobCount++;
-        }
-      }
+  configApplies++;
+  Serial.printf("[DoserControl] Config %s: %d bombas (%u alteradas), %d agendas (%u alteradas)\n",
+                configVersion.length() ? configVersion.c_str() : "(sem versão)",
+                pumpCount, changedPumps, scheduleCount, changedScheds);
 
-      // 2) Doses para o PRÓXIMO dia válido na máscara
-      int daysAhead = 1;
-      for (int d = 1; d <= 7; d++) {
-        uint8_t w = (weekday + d) % 7;
-        if (sched.daysMask & (1 << w)) {
-          daysAhead = d;
-          break;
-        }
-      }
+  if (jobsDirty) {
+    extern int32_t g_userUtcOffsetSec;  // já está no CloudAuthDoser.cpp
 
-      uint32_t baseMidnight = todayMidnight + (uint32_t)daysAhead * 86400u;
+    time_t nowUtc = time(nullptr);
+    time_t nowUsr = nowUtc + g_userUtcOffsetSec;
 
-      uint8_t numDosesNextDay = useAdjustedTimes ? sched.adjustedTimesCount : sched.dosesPerDay;
-      for (uint8_t d = 0; d < numDosesNextDay; d++) {
-        if (doseJobCount >= MAX_DOSE_JOBS) {
-          Serial.printf("[DoserControl] ⚠️  ERRO: Limite de %d jobs atingido!\n", MAX_DOSE_JOBS);
-          Serial.printf("[DoserControl] ⚠️  Bomba %s (ID:%lu) Schedule ID:%lu (NEXTDAY) não foi agendada\n",
-                        pumps[p].name.c_str(), pumps[p].id, (unsigned long)sched.id);
-          Serial.println("[DoserControl] ⚠️  Reduza o número de doses diárias ou desative agendamentos desnecessários");
-          break;
-        }
+    // só considera válido se já passou de um epoch "razoável"
+    if (nowUsr > 1700000000) {
+      Serial.printf("[DoserControl] rebuildJobs() com now=%lu\n",
+                    (unsigned long)nowUsr);
+      rebuildJobs(nowUsr);
+    } else {
+      Serial.printf("[DoserControl] Horario invalido (now=%lu), adiando rebuildJobs\n",
+                    (unsigned long)nowUsr);
+      doseJobCount = 0;   // jobs apontam para posições de bomba/agenda que mudaram
+    }
+  }
 
-        // Usar horário ajustado ou calcular
-        uint32_t secSinceMidnight = useAdjustedTimes
-            ? sched.adjustedTimes[d]
-            : (sched.startSecSinceMidnight + (d * intervalPerDose));
-
-        uint32_t whenEpoch = baseMidnight + secSinceMidnight;
-        time_t tWhen = (time_t)whenEpoch;
-        char bufWhen[20];
-        strftime(bufWhen, sizeof(bufWhen), "%Y-%m-%d %H:%M:%S", localtime(&tWhen));
-
-        Serial.printf("[DoserControl]   NEXTDAY job: pumpId=%lu schedId=%lu when=%s (epoch=%lu, daysAhead=%d)\n",
-                      pumps[p].id,
-                      (unsigned long)sched.id,
-                      bufWhen,
-                      (unsigned long)whenEpoch,
-                      daysAhead);
-
-        // [FIX] Usar volume individual do backend se disponível, senão calcula
-        float doseVolume = volumePerDose;
-        if (sched.doseVolumesCount > 0 && d < sched.doseVolumesCount) {
-          doseVolume = sched.doseVolumes[d];
-        }
+  // Persistir config local para operar offline depois (só quando mudou)
+  if (persist) {
+    saveConfigToFile();
+  }
+  return true;
+}
 
-        DoseJob& job   = doseJobs[doseJobCount];
-        job.pumpId     = pumps[p].id;
-        job.scheduleId = sched.id;
-        job.volumeMl   = doseVolume;
-        job.whenEpoch  = whenEpoch;
-        job.executed   = false;
-        job.retries    = 0;
-        job.minGapSec  = sched.minGapMinutes * 60;  // [NOVO] Converter minutos para segundos
-        job.doseIndex  = d + 1;
-        doseJobCount++;
-      }
+void DoserControl::setPumpVolume(uint32_t pumpId, uint16_t volumeMl) {
+  for (uint8_t p = 0; p < pumpCount; p++) {
+    if (pumps[p].id == pumpId) {
+      pumps[p].currentVolumeMl = volumeMl;
+      return;
     }
   }
+}
 
-  Serial.printf("[DoserControl] Rebuilt %d dose job(s) (futuro)\n", doseJobCount);
+void DoserControl::rebuildJobs(time_t now) {
+  doseJobCount = buildDoseJobs(pumps, pumpCount, schedules, scheduleCount,
+                               now, doseJobs, MAX_DOSE_JOBS, jobsBaseEpoch);
 
   // [REMOVIDO] Conflitos agora são resolvidos no backend
   // resolveTimeConflicts();
@@ -497,12 +310,13 @@ void DoserControl::loop(time_t now) {
   processActiveRuns(nowMs, now);
 
   // Verificar e disparar novos jobs
-  for (uint8_t i = 0; i < doseJobCount; i++) {
+  for (uint16_t i = 0; i < doseJobCount; i++) {
     DoseJob& job = doseJobs[i];
 
     if (job.executed) continue;
 
-    if ((uint32_t)now >= job.whenEpoch) {
+    uint32_t whenEpoch = jobsBaseEpoch + job.offsetSec;
+    if ((uint32_t)now >= whenEpoch) {
       // Se existe dose em execução (auto ou manual), adia este job
       bool anyActive = manualRun.active;
       for (uint8_t k = 0; k < MAX_ACTIVE_RUNS && !anyActive; k++) {
@@ -515,50 +329,38 @@ void DoserControl::loop(time_t now) {
         continue;
       }
 
-      // Encontrar a bomba
-      uint8_t pumpIdx = 255;
-      for (uint8_t p = 0; p < pumpCount; p++) {
-        if (pumps[p].id == job.pumpId) {
-          pumpIdx = p;
-          break;
-        }
-      }
+      // Bomba e agenda pela posição (a tabela é refeita quando mudam)
+      uint8_t pumpIdx = job.pumpIndex;
 
       if (pumpIdx < pumpCount) {
         PumpConfig& pump = pumps[pumpIdx];
+        uint32_t jobPumpId  = pump.id;
+        uint32_t scheduleId = job.schedIndex < scheduleCount ? schedules[job.schedIndex].id : 0;
+        float    volumeMl   = doseJobVolume(job);
 
         if (!pump.enabled) {
-          Serial.printf("[DoserControl] Pump %lu disabled\n", job.pumpId);
+          Serial.printf("[DoserControl] Pump %lu disabled\n", jobPumpId);
           job.executed = true;
           if (onExecutionCallback) {
-            onExecutionCallback(job.pumpId, job.volumeMl, job.scheduleId,
-                                job.whenEpoch, "DISABLED", "AUTO", job.doseIndex);
+            onExecutionCallback(jobPumpId, volumeMl, scheduleId,
+                                whenEpoch, "DISABLED", "AUTO", job.doseIndex);
           }
           continue;
         }
 
-        if (pump.currentVolumeMl < job.volumeMl) {
-          Serial.printf("[DoserControl] Pump %lu: volume insuficiente\n", job.pumpId);
+        if (pump.currentVolumeMl < volumeMl) {
+          Serial.printf("[DoserControl] Pump %lu: volume insuficiente\n", jobPumpId);
           job.executed = true;
           if (onExecutionCallback) {
-            onExecutionCallback(job.pumpId, job.volumeMl, job.scheduleId,
-                                job.whenEpoch, "LOW_VOLUME", "AUTO", job.doseIndex);
+            onExecutionCallback(jobPumpId, volumeMl, scheduleId,
+                                whenEpoch, "LOW_VOLUME", "AUTO", job.doseIndex);
           }
           continue;
         }
 
-        // Encontrar índice do schedule só para ler minGapMinutes
-        int schedIdx = -1;
-        for (uint8_t s = 0; s < scheduleCount; s++) {
-          if (schedules[s].id == job.scheduleId) {
-            schedIdx = s;
-            break;
-          }
-        }
-
         uint32_t minGapSec = 0;
-        if (schedIdx >= 0) {
-          minGapSec = (uint32_t)schedules[schedIdx].minGapMinutes * 60;
+        if (job.schedIndex < scheduleCount) {
+          minGapSec = (uint32_t)schedules[job.schedIndex].minGapMinutes * 60;
         }
 
         // min_gap global entre bombas diferentes (apenas automáticas)
@@ -566,32 +368,32 @@ void DoserControl::loop(time_t now) {
         if (minGapSec > 0 &&
             lastAnyExecEpoch != 0 &&
             lastPumpIdExec != 0 &&
-            lastPumpIdExec != job.pumpId &&           // bomba diferente
+            lastPumpIdExec != jobPumpId &&           // bomba diferente
             (uint32_t)now < lastAnyExecEpoch + minGapSec) {
           // ainda dentro do intervalo mínimo entre bombas diferentes -> adia
           continue;
         }
 
         uint32_t durationMs =
-          (uint32_t)((job.volumeMl / pump.calibMlPerSec) * 1000);
+          (uint32_t)((volumeMl / pump.calibMlPerSec) * 1000);
         Serial.printf("[DoserControl] Pump %lu: dosing %.2f mL for %lu ms\n",
-                      (unsigned long)job.pumpId,
-                      (double)job.volumeMl,
+                      (unsigned long)jobPumpId,
+                      (double)volumeMl,
                       (unsigned long)durationMs);
 
         // ----- GUARD RAIL DE VOLUME/DURAÇÃO -----
         const float MAX_RUN_FRACTION_OF_DAILY = 0.5f;   // 50% do volume diário
         float maxRunVolume = pump.maxDailyMl * MAX_RUN_FRACTION_OF_DAILY;
 
-        if (job.volumeMl > maxRunVolume) {
+        if (volumeMl > maxRunVolume) {
           Serial.printf("[DoserControl] GUARD_FAIL volume alto: pumpId=%lu job=%.2f mL maxRun=%.2f mL\n",
-                        (unsigned long)job.pumpId,
-                        (double)job.volumeMl,
+                        (unsigned long)jobPumpId,
+                        (double)volumeMl,
                         (double)maxRunVolume);
 
           job.executed = true;
           if (onExecutionCallback) {
-            onExecutionCallback(job.pumpId, job.volumeMl, job.scheduleId,
+            onExecutionCallback(jobPumpId, volumeMl, scheduleId,
                                 (uint32_t)now, "GUARD_VOLUME", "AUTO", job.doseIndex);
           }
           continue;
@@ -603,13 +405,13 @@ void DoserControl::loop(time_t now) {
 
         if (durationMs > maxDurationMs) {
           Serial.printf("[DoserControl] GUARD_FAIL duration alto: pumpId=%lu dur=%lu ms max=%lu ms\n",
-                        (unsigned long)job.pumpId,
+                        (unsigned long)jobPumpId,
                         (unsigned long)durationMs,
                         (unsigned long)maxDurationMs);
 
           job.executed = true;
           if (onExecutionCallback) {
-            onExecutionCallback(job.pumpId, job.volumeMl, job.scheduleId,
+            onExecutionCallback(jobPumpId, volumeMl, scheduleId,
                                 (uint32_t)now, "GUARD_DURATION", "AUTO", job.doseIndex);
           }
           continue;
@@ -618,50 +420,55 @@ void DoserControl::loop(time_t now) {
         uint32_t nowEpoch = (uint32_t)now;
         if (!canStartAutoDose(pumpIdx, job.doseIndex, nowEpoch)) {
           Serial.printf("[DoserControl] DUP_SKIP pumpIdx=%u pumpId=%lu schedId=%lu dose=%u\n",
-              pumpIdx, (unsigned long)job.pumpId,
-              (unsigned long)job.scheduleId, job.doseIndex);
+              pumpIdx, (unsigned long)jobPumpId,
+              (unsigned long)scheduleId, job.doseIndex);
           
           // não executa, mas marca como executado para não ficar em loop infinito
           job.executed = true;
           // opcional: reportar status especial para o backend
           if (onExecutionCallback) {
-            onExecutionCallback(job.pumpId, job.volumeMl, job.scheduleId,
+            onExecutionCallback(jobPumpId, volumeMl, scheduleId,
                                 nowEpoch, "SKIPPED_DUP", "AUTO", job.doseIndex);
           }
           continue;
         }              
 
-        startAutoRun(pumpIdx, durationMs, job.pumpId, job.scheduleId, job.volumeMl, job.doseIndex);
+        startAutoRun(pumpIdx, durationMs, jobPumpId, scheduleId, volumeMl, job.doseIndex);
 
-        pump.currentVolumeMl -= job.volumeMl;
+        pump.currentVolumeMl -= volumeMl;
         job.executed = true;
 
         // registra última execução automática (global)
         lastAnyExecEpoch = (uint32_t)now;
-        lastPumpIdExec   = job.pumpId;
+        lastPumpIdExec   = jobPumpId;
       }
 
     }
   }
 }
 
-void DoserControl::startManualDose(uint8_t pumpIdx, float volumeMl,
+bool DoserControl::startManualDose(uint8_t pumpIdx, float volumeMl,
                                    uint32_t scheduleId, uint32_t pumpIdOverride) {
-  if (pumpIdx >= pumpCount) return;
+  if (pumpIdx >= pumpCount) return false;
   PumpConfig& pump = pumps[pumpIdx];
+  // Sem calibração a duração daria infinito: bomba ligada sem parar
+  if (pump.calibMlPerSec <= 0 || volumeMl <= 0) {
+    Serial.println("[DoserControl] Bomba sem calibração ou volume inválido, dose manual recusada");
+    return false;
+  }
 
   // Se já existe dose automática em execução, não começar manual
   for (uint8_t i = 0; i < MAX_ACTIVE_RUNS; i++) {
     if (activeRuns[i].inUse) {
       Serial.println("[DoserControl] Auto-run em andamento, bloqueando dose manual");
-      return;
+      return false;
     }
   }
 
   // Se já existe manual em execução, também não iniciar outra
   if (manualRun.active) {
     Serial.println("[DoserControl] Manual em andamento, ignorando nova dose manual");
-    return;
+    return false;
   }
 
   uint32_t durationMs = (uint32_t)((volumeMl / pump.calibMlPerSec) * 1000);
@@ -677,6 +484,29 @@ void DoserControl::startManualDose(uint8_t pumpIdx, float volumeMl,
   manualRun.origin     = "MANUAL";
 
   pump.currentVolumeMl -= volumeMl;
+  return true;
+}
+
+bool DoserControl::isBusy() const {
+  if (manualRun.active) return true;
+  for (uint8_t i = 0; i < MAX_ACTIVE_RUNS; i++) {
+    if (activeRuns[i].inUse) return true;
+  }
+  return false;
+}
+
+bool DoserControl::requestExecuted(uint32_t requestId) const {
+  if (requestId == 0) return false;   // sem id: não dá para deduplicar
+  for (uint8_t i = 0; i < 8; i++) {
+    if (recentRequests[i] == requestId) return true;
+  }
+  return false;
+}
+
+void DoserControl::markRequestExecuted(uint32_t requestId) {
+  if (requestId == 0) return;
+  recentRequests[recentNext] = requestId;
+  recentNext = (recentNext + 1) % 8;
 }
 
 void DoserControl::stopManualDose(uint32_t pumpId) {
@@ -717,16 +547,6 @@ void DoserControl::buildPumpsStatusJson(JsonDocument& outDoc) const {
   }
 }
 
-uint32_t DoserControl::parseTimeToSeconds(const String& timeStr) {
-  int colonPos = timeStr.indexOf(':');
-  if (colonPos < 0) return 0;
-
-  int hours   = timeStr.substring(0, colonPos).toInt();
-  int minutes = timeStr.substring(colonPos + 1).toInt();
-
-  return (hours * 3600) + (minutes * 60);
-}
-
 // Janela para bloquear repetição da mesma dose (em segundos)
 static const uint32_t DUP_WINDOW_SEC = 5 * 60;   // 5 minutos
 
@@ -760,10 +580,10 @@ bool DoserControl::canStartAutoDose(uint8_t pumpIdx, uint8_t doseIndex, uint32_t
 void DoserControl::resolveTimeConflicts() {
   if (doseJobCount <= 1) return;  // Nada a fazer se houver 0 ou 1 job
 
-  // Ordenar jobs por whenEpoch (bubble sort simples - poucos jobs)
-  for (uint8_t i = 0; i < doseJobCount - 1; i++) {
-    for (uint8_t j = i + 1; j < doseJobCount; j++) {
-      if (doseJobs[j].whenEpoch < doseJobs[i].whenEpoch) {
+  // Ordenar jobs por horário (bubble sort simples - poucos jobs)
+  for (uint16_t i = 0; i < doseJobCount - 1; i++) {
+    for (uint16_t j = i + 1; j < doseJobCount; j++) {
+      if (doseJobs[j].offsetSec < doseJobs[i].offsetSec) {
         DoseJob temp = doseJobs[i];
         doseJobs[i] = doseJobs[j];
         doseJobs[j] = temp;
@@ -773,24 +593,27 @@ void DoserControl::resolveTimeConflicts() {
 
   // Detectar e resolver conflitos
   uint8_t conflictsResolved = 0;
-  for (uint8_t i = 0; i < doseJobCount - 1; i++) {
+  for (uint16_t i = 0; i < doseJobCount - 1; i++) {
     // Se o próximo job tem o mesmo horário
-    if (doseJobs[i].whenEpoch == doseJobs[i + 1].whenEpoch) {
-      // Usar o minGapSec do job atual (ou 30s se não configurado)
-      uint16_t gapSec = (doseJobs[i].minGapSec > 0) ? doseJobs[i].minGapSec : 30;
+    if (doseJobs[i].offsetSec == doseJobs[i + 1].offsetSec) {
+      // Usar o minGap da agenda do job atual (ou 30s se não configurado)
+      uint16_t gapSec = 30;
+      if (doseJobs[i].schedIndex < scheduleCount && schedules[doseJobs[i].schedIndex].minGapMinutes > 0) {
+        gapSec = schedules[doseJobs[i].schedIndex].minGapMinutes * 60;
+      }
 
       // Ajustar o próximo job
-      uint32_t oldEpoch = doseJobs[i + 1].whenEpoch;
-      doseJobs[i + 1].whenEpoch = doseJobs[i].whenEpoch + gapSec;
+      uint32_t oldEpoch = jobsBaseEpoch + doseJobs[i + 1].offsetSec;
+      doseJobs[i + 1].offsetSec = doseJobs[i].offsetSec + gapSec;
 
       time_t tOld = (time_t)oldEpoch;
-      time_t tNew = (time_t)doseJobs[i + 1].whenEpoch;
+      time_t tNew = (time_t)(jobsBaseEpoch + doseJobs[i + 1].offsetSec);
       char bufOld[20], bufNew[20];
       strftime(bufOld, sizeof(bufOld), "%Y-%m-%d %H:%M:%S", localtime(&tOld));
       strftime(bufNew, sizeof(bufNew), "%Y-%m-%d %H:%M:%S", localtime(&tNew));
 
       Serial.printf("[DoserControl] [CONFLICT] PumpId=%lu escalonado: %s -> %s (+%us)\n",
-                    doseJobs[i + 1].pumpId, bufOld, bufNew, gapSec);
+                    (unsigned long)pumps[doseJobs[i + 1].pumpIndex].id, bufOld, bufNew, gapSec);
 
       conflictsResolved++;
 
@@ -803,4 +626,3 @@ void DoserControl::resolveTimeConflicts() {
     Serial.printf("[DoserControl] %u conflito(s) de horário resolvido(s)\n", conflictsResolved);
   }
 }
-
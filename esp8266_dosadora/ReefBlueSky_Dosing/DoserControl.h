@@ -5,82 +5,8 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <time.h>
-
-#define MAX_PUMPS      6
-#define MAX_SCHEDULES 10
-#define MAX_DOSE_JOBS 300  // [FIX] Suporta 24 doses/dia × 6 bombas × 2 dias = 288 jobs + margem
-#define MAX_ACTIVE_RUNS MAX_PUMPS
-
-struct PumpConfig {
-  uint32_t id;
-  uint8_t  index;
-  bool     enabled;
-  float    calibMlPerSec;
-  uint16_t maxDailyMl;
-  uint16_t currentVolumeMl;
-  uint16_t containerVolumeMl;
-  uint8_t  alarmThresholdPct;
-  String   name;
-};
-
-struct Schedule {
-  uint32_t id;
-  bool     enabled;
-  uint8_t  daysMask;
-  uint8_t  dosesPerDay;
-  float volumePerDayMl;
-  uint16_t minGapMinutes;
-  uint32_t startSecSinceMidnight;
-  uint32_t endSecSinceMidnight;
-  uint8_t  pumpIndex;
-  // Horários ajustados pelo backend (em segundos desde meia-noite)
-  uint32_t adjustedTimes[24];  // Máximo 24 doses por dia
-  uint8_t  adjustedTimesCount;
-  // [FIX] Volumes individuais por dose (backend calcula para garantir total exato)
-  float doseVolumes[24];  // Volume específico de cada dose
-  uint8_t  doseVolumesCount;
-};
-
-
-struct DoseJob {
-  uint32_t pumpId;
-  uint32_t scheduleId;
-  uint32_t whenEpoch;
-  float volumeMl;
-  bool     executed;
-  uint8_t  retries;
-  uint16_t minGapSec;  // [NOVO] Intervalo mínimo entre bombas (segundos)
-  uint8_t  doseIndex;   // [NOVO] 1..dosesPerDay (posição da dose na schedule)
-
-};
-
-struct ManualRun {
-  bool     active;
-  uint32_t pumpId;
-  uint8_t  pumpIndex;
-  uint32_t startMs;
-  uint32_t durationMs;
-  uint32_t scheduleId;
-  float volumeMl;
-  const char* origin;
-};
-
-struct ActiveRun {
-  bool     inUse;
-  uint8_t  pumpIndex;
-  uint32_t endMs;
-  uint32_t pumpId;
-  uint32_t scheduleId;
-  float volumeMl;
-  const char* origin;
-  uint8_t  doseIndex;   
-
-};
-
-struct LastDoseInfo {
-  uint32_t lastEpoch;
-  uint8_t  lastDoseIndex;
-};
+#include "DoserTypes.h"
+#include "DoserConfigParser.h"
 
 
 class DoserControl {
@@ -92,7 +18,8 @@ private:
   uint8_t  scheduleCount = 0;
 
   DoseJob  doseJobs[MAX_DOSE_JOBS];
-  uint8_t  doseJobCount = 0;
+  uint16_t doseJobCount = 0;      // até MAX_DOSE_JOBS (300): não cabe em uint8_t
+  uint32_t jobsBaseEpoch = 0;     // meia-noite de referência dos offsets dos jobs
 
   ManualRun manualRun;
   ActiveRun activeRuns[MAX_ACTIVE_RUNS];
@@ -105,9 +32,18 @@ private:
   uint32_t lastAnyExecEpoch = 0;    // horário da última dose automática (qualquer bomba)
   uint32_t lastPumpIdExec   = 0;    // pumpId da última dose automática
 
+  uint32_t  recentRequests[8] = {0};   // ids de pedidos do monitor já executados
+  uint8_t   recentNext = 0;
+
   uint32_t  lastJobsRebuild = 0;
   uint32_t  lastDailyExecuted = 0;
 
+  // Versão da config aplicada (config_version do handshake) e contadores
+  // para medir quanto o handshake custa em escrita no LittleFS
+  String    configVersion;
+  uint32_t  configApplies = 0;     // configs novas aplicadas
+  uint32_t  configWrites  = 0;     // gravações de /doser_config.json
+
   typedef std::function<void(uint32_t pumpId,
                             float volumeMl,
                             uint32_t scheduleId,
@@ -123,27 +59,46 @@ public:
   DoserControl();
 
   void initPins(const int pins[MAX_PUMPS]);
-  void loadFromServer(const JsonDocument& config);
+  // Aplica só o que mudou (bombas/agendas comparadas campo a campo); jobs
+  // são refeitos e o arquivo gravado apenas se algo mudou. true = mudou.
+  bool applyConfig(const DoserConfigStage& config, bool persist = true);
+  // Config salva em /doser_config.json (boot offline); true = há bombas
+  bool loadFromFile();
+  // Volume atual vindo do servidor (handshake "unchanged"); não grava nada
+  void setPumpVolume(uint32_t pumpId, uint16_t volumeMl);
+
+  const String& getConfigVersion() const { return configVersion; }
+  uint32_t getConfigApplies() const { return configApplies; }
+  uint32_t getConfigWrites() const { return configWrites; }
 
   void rebuildJobs(time_t now);
   void loop(time_t now);
 
-  void startManualDose(uint8_t pumpIdx, float volumeMl,
-                     uint32_t scheduleId, uint32_t pumpIdOverride = 0);
+  // false = recusada (bomba inválida/sem calibração ou outra dose rodando)
+  bool startManualDose(uint8_t pumpIdx, float volumeMl,
+                       uint32_t scheduleId, uint32_t pumpIdOverride = 0);
   void stopManualDose(uint32_t pumpId);
+  bool isBusy() const;
+
+  // Pedidos de dose do monitor (LAN ou fallback pela nuvem, mesmo id):
+  // um id já executado não dosa de novo
+  bool requestExecuted(uint32_t requestId) const;
+  void markRequestExecuted(uint32_t requestId);
 
   uint8_t        getPumpCount() const { return pumpCount; }
   const PumpConfig& getPump(uint8_t idx) const { return pumps[idx]; }
   uint8_t        getScheduleCount() const { return scheduleCount; }
-  uint8_t        getDoseJobCount() const { return doseJobCount; }
-  const DoseJob& getDoseJob(uint8_t idx) const { return doseJobs[idx]; }
+  uint16_t       getDoseJobCount() const { return doseJobCount; }
+  const DoseJob& getDoseJob(uint16_t idx) const { return doseJobs[idx]; }
+  uint32_t       getDoseJobEpoch(const DoseJob& job) const { return jobsBaseEpoch + job.offsetSec; }
 
   void buildPumpsStatusJson(JsonDocument& outDoc) const;
 
   void onExecution(ExecutionCallback cb) { onExecutionCallback = cb; }
 
 private:
-  uint32_t parseTimeToSeconds(const String& timeStr);
+  static bool samePump(const PumpConfig& a, const PumpConfig& b);
+  static bool sameSchedule(const Schedule& a, const Schedule& b);
   void     startAutoRun(uint8_t pumpIdx, uint32_t durationMs,
                         uint32_t pumpId, uint32_t scheduleId, float volumeMl, uint8_t doseIndex);
   void     processActiveRuns(uint32_t nowMs, time_t nowSec);
@@ -151,7 +106,7 @@ private:
 
   bool     canStartAutoDose(uint8_t pumpIdx, uint8_t doseIndex, uint32_t nowEpoch); // ✅ NOVA
 
-  void     saveConfigToFile(const JsonDocument& config);
+  void     saveConfigToFile();
 };
 
 #endif
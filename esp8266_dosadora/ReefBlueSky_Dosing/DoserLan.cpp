@@ -0,0 +1,171 @@
+//DoserLan.cpp
+#include "DoserLan.h"
+#ifdef ESP8266
+  #include <ESP8266WiFi.h>
+  #include <LittleFS.h>
+  #define SPIFFS LittleFS
+#else
+  #include <WiFi.h>
+  #include <SPIFFS.h>
+#endif
+#include <time.h>
+
+static bool hexToBytes(const String& hex, uint8_t* out, size_t len) {
+  if (hex.length() != len * 2) return false;
+  for (size_t i = 0; i < len; i++) {
+    char buf[3] = {hex[2 * i], hex[2 * i + 1], 0};
+    char* end;
+    out[i] = (uint8_t)strtoul(buf, &end, 16);
+    if (*end) return false;
+  }
+  return true;
+}
+
+static IPAddress toIp(uint32_t ip) {
+  return IPAddress((ip >> 24) & 0xFF, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF);
+}
+
+bool DoserLan::loadKey(String& hexKey) {
+  if (!SPIFFS.exists(DOSERLAN_KEY_FILE)) return false;
+  File f = SPIFFS.open(DOSERLAN_KEY_FILE, "r");
+  if (!f) return false;
+  StaticJsonDocument<160> doc;
+  DeserializationError err = deserializeJson(doc, f);
+  f.close();
+  if (err) return false;
+  hexKey = doc["key"] | "";
+  return hexKey.length() == 64;
+}
+
+bool DoserLan::saveKey(const String& hexKey) {
+  String current;
+  if (loadKey(current) && current == hexKey) return true;   // não regrava a mesma chave
+  File f = SPIFFS.open(DOSERLAN_KEY_FILE, "w");
+  if (!f) return false;
+  StaticJsonDocument<160> doc;
+  doc["key"] = hexKey;
+  serializeJson(doc, f);
+  f.close();
+  return true;
+}
+
+bool DoserLan::begin(const String& espUid, const String& hexKey, DoserControl* d) {
+  String hex = hexKey;
+  if (hex.length() == 0 && !loadKey(hex)) {
+    Serial.println("[LAN] Sem chave LAN ainda (precisa da nuvem uma vez)");
+    return false;
+  }
+  if (!hexToBytes(hex, key, 32)) {
+    Serial.println("[LAN] Chave LAN inválida");
+    return false;
+  }
+
+  doser = d;
+  uid = espUid;
+
+  IPAddress group = toIp(LANLINK_GROUP_IP);
+#ifdef ESP8266
+  bool ok = udp.beginMulticast(WiFi.localIP(), group, LANLINK_PORT);
+  uint32_t session = ESP.random();
+#else
+  bool ok = udp.beginMulticast(group, LANLINK_PORT);
+  uint32_t session = esp_random();
+#endif
+  if (!ok) {
+    Serial.println("[LAN] beginMulticast falhou");
+    return false;
+  }
+
+  LanLink::Config cfg;
+  cfg.role = LanLink::ROLE_DOSER;
+  cfg.uid = uid.c_str();
+  cfg.key = key;
+  cfg.keyLen = 32;
+  cfg.session = session;
+
+  LanLink::Handlers h;
+  h.send = sendDatagram;
+  h.onMeasurement = onMeasurement;
+  h.onDose = onDose;
+  h.ctx = this;
+
+  if (!link.begin(cfg, h)) return false;
+  Serial.printf("[LAN] Pronto em %s:%u (key_id %08lx)\n", WiFi.localIP().toString().c_str(),
+                LANLINK_PORT, (unsigned long)link.keyId());
+  return true;
+}
+
+void DoserLan::loop() {
+  if (!link.ready()) return;
+  uint32_t epoch = (uint32_t)time(nullptr);
+
+  // Tudo que chegou desde a última volta (datagramas pequenos, poucos)
+  uint8_t buf[LANLINK_MAX_DATAGRAM];
+  int size;
+  while ((size = udp.parsePacket()) > 0) {
+    int n = udp.read(buf, sizeof(buf));
+    IPAddress ip = udp.remoteIP();
+    uint32_t from = ((uint32_t)ip[0] << 24) | ((uint32_t)ip[1] << 16) | ((uint32_t)ip[2] << 8) | ip[3];
+    if (n > 0 && size <= (int)sizeof(buf)) {
+      link.onDatagram(buf, (size_t)n, from, udp.remotePort(), millis(), epoch);
+    }
+  }
+
+  link.loop(millis(), epoch);
+}
+
+void DoserLan::sendDatagram(void* ctx, uint32_t ip, uint16_t port, const uint8_t* data, size_t len) {
+  DoserLan* self = (DoserLan*)ctx;
+  self->udp.beginPacket(toIp(ip), port);
+  self->udp.write(data, len);
+  self->udp.endPacket();
+}
+
+void DoserLan::onMeasurement(void* ctx, const LanLink::Peer& from, float kh, uint32_t measuredAt) {
+  DoserLan* self = (DoserLan*)ctx;
+  self->lastKh = kh;
+  self->lastKhAt = measuredAt;
+  Serial.printf("[LAN] KH %.2f dKH de %s (medido em %lu)\n", (double)kh, from.uid,
+                (unsigned long)measuredAt);
+}
+
+uint8_t DoserLan::onDose(void* ctx, const LanLink::Peer& from, uint32_t requestId,
+                         uint8_t pumpIndex, float volumeMl) {
+  DoserLan* self = (DoserLan*)ctx;
+  DoserControl* doser = self->doser;
+  Serial.printf("[LAN] Pedido %lu de %s: bomba %u, %.2f mL\n", (unsigned long)requestId,
+                from.uid, pumpIndex, (double)volumeMl);
+
+  if (!doser || pumpIndex >= doser->getPumpCount() || !(volumeMl > 0) || volumeMl > DOSERLAN_MAX_ML) {
+    self->lanRefused++;
+    return LanLink::ACK_REJECTED;
+  }
+  // Mesmo pedido já dosado (ex.: veio antes pela nuvem): confirma sem repetir
+  if (doser->requestExecuted(requestId)) return LanLink::ACK_OK;
+  // Outra dose rodando: o monitor tenta de novo mais tarde
+  if (doser->isBusy()) return LanLink::ACK_BUSY;
+
+  if (!doser->startManualDose(pumpIndex, volumeMl, 0)) {
+    self->lanRefused++;
+    return LanLink::ACK_REJECTED;
+  }
+  doser->markRequestExecuted(requestId);
+  self->lanDoses++;
+  return LanLink::ACK_OK;
+}
+
+void DoserLan::buildStatusJson(JsonObject out) const {
+  const LanLink::Stats& s = link.stats();
+  out["ready"]     = link.ready();
+  out["peers"]     = link.peerCount();
+  out["doses"]     = lanDoses;
+  out["refused"]   = lanRefused;
+  out["received"]  = s.received;
+  out["dups"]      = s.duplicates;
+  out["auth_fail"] = s.authFailures;
+  out["replays"]   = s.replays;
+  if (lastKhAt) {
+    out["last_kh"]    = lastKh;
+    out["last_kh_at"] = lastKhAt;
+  }
+}
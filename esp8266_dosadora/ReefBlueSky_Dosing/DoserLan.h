@@ -0,0 +1,64 @@
+//DoserLan.h
+#ifndef DOSER_LAN_H
+#define DOSER_LAN_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <WiFiUdp.h>
+#include <ReefBlueSkyCore.h>
+#include "DoserControl.h"
+
+/**
+ * Canal direto com o monitor de KH na rede local (LanLink do ReefBlueSkyCore)
+ *
+ * O monitor manda cada medição e, numa correção de KH, o pedido de dose
+ * direto para cá por UDP, sem passar por nuvem + long-poll. A dose vira um
+ * startManualDose() como a do app. Se não confirmamos em ~1 s o monitor
+ * usa a nuvem (POST /device/doser-dose) com o mesmo request_id; o
+ * DoserControl lembra os ids executados e não dosa duas vezes.
+ *
+ * A chave vem do backend (GET /device/lan-key, a mesma para o monitor do
+ * usuário) e fica em /doser_lan_key.json: sem internet depois do primeiro
+ * boot a LAN continua funcionando.
+ *
+ * Precisa da biblioteca ReefBlueSkyCore (esp32/ReefBlueSkyCore, instalar
+ * como no README dela).
+ */
+
+#define DOSERLAN_KEY_FILE   "/doser_lan_key.json"
+#define DOSERLAN_MAX_ML     200.0f   // pedido maior que isso é recusado
+
+class DoserLan {
+public:
+  // hexKey vazio = usa a chave do arquivo; false = sem chave ainda
+  bool begin(const String& uid, const String& hexKey, DoserControl* doser);
+  bool ready() const { return link.ready(); }
+
+  // Chamar a cada volta do loop()
+  void loop();
+
+  // Objeto "lan" do status periódico
+  void buildStatusJson(JsonObject out) const;
+
+  static bool loadKey(String& hexKey);
+  static bool saveKey(const String& hexKey);
+
+private:
+  static void    sendDatagram(void* ctx, uint32_t ip, uint16_t port, const uint8_t* data, size_t len);
+  static void    onMeasurement(void* ctx, const LanLink::Peer& from, float kh, uint32_t measuredAt);
+  static uint8_t onDose(void* ctx, const LanLink::Peer& from, uint32_t requestId,
+                        uint8_t pumpIndex, float volumeMl);
+
+  WiFiUDP       udp;
+  LanLink       link;
+  DoserControl* doser = nullptr;
+  String        uid;
+  uint8_t       key[LANLINK_KEY_MAX];
+
+  float    lastKh = 0;
+  uint32_t lastKhAt = 0;        // epoch da medição
+  uint32_t lanDoses = 0;
+  uint32_t lanRefused = 0;
+};
+
+#endif
@@ -0,0 +1,99 @@
+//DoserTypes.h
+#ifndef DOSER_TYPES_H
+#define DOSER_TYPES_H
+
+// Estruturas da dosadora sem dependência de ArduinoJson (usadas pelo
+// DoserControl e pelo parser de config em streaming)
+
+#include <stdint.h>
+
+#define MAX_PUMPS      6
+#define MAX_SCHEDULES 10
+#define MAX_DOSE_JOBS 300  // [FIX] Suporta 24 doses/dia × 6 bombas × 2 dias = 288 jobs + margem (índice uint16_t)
+#define MAX_ACTIVE_RUNS MAX_PUMPS
+
+struct PumpConfig {
+  uint32_t id;
+  uint8_t  index;
+  bool     enabled;
+  float    calibMlPerSec;
+  uint16_t maxDailyMl;
+  uint16_t currentVolumeMl;
+  uint16_t containerVolumeMl;
+  uint8_t  alarmThresholdPct;
+  char     name[24];   // truncado; vem do JSON sem String no heap
+};
+
+// Agenda como vem do backend. Horários em minutos desde a meia-noite (o
+// backend só manda "HH:MM") e volumes por dose em 0,01 mL: os dois arrays
+// de 24 eram a maior parte da struct (224 -> 164 bytes). Volume em 32 bits,
+// como o DoseJob (24 bits): dose única acima de 655 mL não pode saturar
+struct Schedule {
+  uint32_t id;
+  float    volumePerDayMl;
+  uint16_t minGapMinutes;
+  uint16_t startMin;
+  uint16_t endMin;
+  bool     enabled;
+  uint8_t  daysMask;
+  uint8_t  dosesPerDay;
+  uint8_t  pumpIndex;
+  uint8_t  adjustedTimesCount;
+  uint8_t  doseVolumesCount;
+  // Horários ajustados pelo backend (minutos desde meia-noite)
+  uint16_t adjustedMin[24];  // Máximo 24 doses por dia
+  // [FIX] Volumes individuais por dose (backend calcula para garantir total exato), em 0,01 mL
+  uint32_t doseVolumeCml[24];
+};
+
+// Job de dose: 8 bytes (antes 24). Horário relativo à meia-noite de
+// referência da tabela (DoserControl::jobsBaseEpoch), bomba e agenda pela
+// posição nos arrays (ids saem de pumps[]/schedules[]), volume em 0,01 mL.
+// minGap e retries saíram: o minGap já é lido da agenda e retries não era usado.
+#define DOSE_JOB_MAX_OFFSET_S ((1UL << 20) - 1)   // ~12 dias; a tabela cobre hoje + próximo dia válido (até 8)
+#define DOSE_JOB_MAX_CML      ((1UL << 24) - 1)
+
+struct DoseJob {
+  uint32_t offsetSec  : 20;  // segundos desde jobsBaseEpoch
+  uint32_t pumpIndex  : 3;
+  uint32_t schedIndex : 4;
+  uint32_t doseIndex  : 5;   // [NOVO] 1..dosesPerDay (posição da dose na schedule)
+  uint32_t volumeCml  : 24;  // volume em 0,01 mL
+  uint32_t executed   : 1;
+  uint32_t reserved   : 7;
+};
+
+static_assert(sizeof(DoseJob) == 8, "DoseJob deve ter 8 bytes");
+static_assert(MAX_PUMPS <= 8 && MAX_SCHEDULES <= 16, "índices de DoseJob não cabem nos bitfields");
+
+inline float doseJobVolume(const DoseJob& job) { return job.volumeCml * 0.01f; }
+
+struct ManualRun {
+  bool     active;
+  uint32_t pumpId;
+  uint8_t  pumpIndex;
+  uint32_t startMs;
+  uint32_t durationMs;
+  uint32_t scheduleId;
+  float volumeMl;
+  const char* origin;
+};
+
+struct ActiveRun {
+  bool     inUse;
+  uint8_t  pumpIndex;
+  uint32_t endMs;
+  uint32_t pumpId;
+  uint32_t scheduleId;
+  float volumeMl;
+  const char* origin;
+  uint8_t  doseIndex;   
+
+};
+
+struct LastDoseInfo {
+  uint32_t lastEpoch;
+  uint8_t  lastDoseIndex;
+};
+
+#endif
@@ -0,0 +1,118 @@
+// FwDelta.h
+// Aplicador de patch binário (formato RBSD) para OTA delta.
+//
+// O patch é gerado no servidor por backend/fwdelta (bsdiff + LZSS) e
+// aplicado em streaming: os bytes chegam do HTTP em pedaços quaisquer,
+// o firmware antigo é lido da partição em execução e o novo sai em ordem
+// pelo callback de escrita. Sem malloc; ~2.5 KB de estado em fwd_ctx_t.
+//
+// Cópias idênticas em:
+//   backend/fwdelta/FwDelta.{h,c}                (original + testes no host)
+//   esp32/ReefBlueSky_KH_Monitor_v4/FwDelta.{h,c}
+//   esp8266_dosadora/ReefBlueSky_Dosing/FwDelta.{h,c}
+//   ReefBlueSkyDisplayC6_LVGL/Display/src/ota/FwDelta.{h,c}
+// "make check-copies" em backend/fwdelta confere se estão em sincronia.
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Layout do cabeçalho (little-endian, FWD_HEADER_SIZE bytes):
+//   0  "RBSD"          4  versão (1)       5  flags (bit0 = corpo LZSS)
+//   6  bits da janela  7  bits do tamanho  8  old_size   12 new_size
+//   16 body_size       20 old_sha256[32]   52 new_sha256[32]
+// Corpo: registros (diff_len, extra_len, seek) em varint, seguidos de
+// diff_len bytes somados ao antigo e extra_len bytes literais.
+//
+// Os primeiros FWD_OLD_SKIP bytes do firmware antigo são lidos como zero:
+// o cabeçalho da imagem (modo/tamanho da flash) pode ser reescrito na
+// gravação, então o patch nunca depende dele. old_sha256 é o SHA-256 do
+// antigo já com esses bytes zerados.
+#define FWD_MAGIC            "RBSD"
+#define FWD_VERSION          1
+#define FWD_HEADER_SIZE      84
+#define FWD_FLAG_LZSS        0x01
+#define FWD_OLD_SKIP         16
+#define FWD_WINDOW_BITS_MAX  11      // janela LZSS de até 2 KB
+#define FWD_MIN_MATCH        3
+#define FWD_OLD_CACHE        256
+#define FWD_OUT_BUF          256
+
+enum {
+    FWD_OK          = 0,     // consumiu tudo, quer mais dados
+    FWD_HEADER      = 1,     // cabeçalho pronto: validar antes de continuar
+    FWD_DONE        = 2,     // new_size bytes escritos
+    FWD_ERR_MAGIC   = -1,
+    FWD_ERR_FORMAT  = -2,
+    FWD_ERR_READ    = -3,
+    FWD_ERR_WRITE   = -4,
+    FWD_ERR_RANGE   = -5,
+};
+
+// Lê 'len' bytes do firmware antigo em 'off' (0 = ok)
+typedef int (*fwd_read_old_fn)(void *user, uint32_t off, uint8_t *buf, uint32_t len);
+// Recebe o próximo pedaço do firmware novo (0 = ok)
+typedef int (*fwd_write_fn)(void *user, const uint8_t *buf, uint32_t len);
+
+typedef struct {
+    uint8_t  flags;
+    uint8_t  win_bits;
+    uint8_t  len_bits;
+    uint32_t old_size;
+    uint32_t new_size;
+    uint32_t body_size;
+    uint8_t  old_sha256[32];
+    uint8_t  new_sha256[32];
+} fwd_header_t;
+
+typedef struct {
+    fwd_read_old_fn read_old;
+    fwd_write_fn    write;
+    void           *user;
+
+    fwd_header_t hdr;
+    uint8_t  hdr_buf[FWD_HEADER_SIZE];
+    uint32_t hdr_len;
+    uint32_t body_read;
+
+    // LZSS
+    uint32_t bitbuf;
+    uint8_t  bitcnt;
+    uint16_t win_pos;
+    uint8_t  window[1u << FWD_WINDOW_BITS_MAX];
+
+    // registros
+    uint8_t  state;
+    uint8_t  vshift;
+    uint32_t vacc;
+    uint32_t diff_left;
+    uint32_t extra_left;
+    int32_t  seek;
+    uint32_t old_pos;
+
+    uint32_t cache_off;
+    uint32_t cache_len;
+    uint8_t  cache[FWD_OLD_CACHE];
+
+    uint32_t written;
+    uint32_t out_len;
+    uint8_t  out[FWD_OUT_BUF];
+    int      err;
+} fwd_ctx_t;
+
+void fwd_init(fwd_ctx_t *c, fwd_read_old_fn read_old, fwd_write_fn write, void *user);
+
+// Alimenta bytes do patch. *used recebe quantos foram consumidos (pode ser
+// < len quando retorna FWD_HEADER ou FWD_DONE). Retorna FWD_* ou erro < 0.
+int fwd_feed(fwd_ctx_t *c, const uint8_t *data, size_t len, size_t *used);
+
+// Lê o firmware antigo como o patch o enxerga (FWD_OLD_SKIP bytes zerados)
+int fwd_read_old(fwd_ctx_t *c, uint32_t off, uint8_t *buf, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
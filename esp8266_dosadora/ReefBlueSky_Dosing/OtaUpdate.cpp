@@ -5,14 +5,18 @@
   #include <ESP8266HTTPClient.h>
   #include <ESP8266WebServer.h>
   #include <Updater.h>
+  #include <bearssl/bearssl_hash.h>
 #else
   #include <WiFi.h>
   #include <HTTPClient.h>
   #include <WebServer.h>
   #include <Update.h>
+  #include <mbedtls/sha256.h>
+  #include <esp_ota_ops.h>
 #endif
 
 #include <WiFiClient.h>
+#include "FwDelta.h"
 
 
 extern const char* CLOUD_BASE_URL;
@@ -124,217 +128,521 @@ static void callProgressCallback(int written, int total) {
 }
 
 // ======== OTA VIA HTTP ========
+//
+// Mesmo protocolo do KH/LCD: GET com Range para retomar quedas, identidade
+// do arquivo por X-Firmware-SHA256 (ou ETag + tamanho) e SHA-256 em streaming
+// conferido antes de confirmar o update.
+//
+// No ESP8266 não há task separada para a flash: o buffer de leitura abaixo
+// e o buffer de setor do Updater fazem o papel do par de buffers. O Updater
+// também não retoma depois de reboot, então a retomada vale só dentro da
+// mesma sessão (reconexão com Range no Update já aberto).
+//
+// O último bloco só é entregue ao Updater depois do SHA-256 conferido: com
+// bytes faltando, Update.end() descarta a imagem em vez de ativá-la.
 
-/**
- * Download + Update internal
- * Usa yield() em vez de delay() pra não bloquear OTA
- */
-static bool otaInternal(const String& url) {
-  if (WiFi.status() != WL_CONNECTED) {
-    g_lastError = "WiFi not connected";
-    Serial.println("[OTA] WiFi desconectado.");
-    callEventCallback("failed", "WiFi not connected");
-    return false;
+#ifdef ESP8266
+  #define OTA_BUF_SIZE       2048
+#else
+  #define OTA_BUF_SIZE       4096
+#endif
+#define OTA_MAX_RECONNECTS   5
+#define OTA_READ_TIMEOUT_MS  15000
+
+#ifdef ESP8266
+  typedef br_sha256_context OtaShaCtx;
+  static void otaShaStart(OtaShaCtx* c) { br_sha256_init(c); }
+  static void otaShaUpdate(OtaShaCtx* c, const uint8_t* d, size_t n) { br_sha256_update(c, d, n); }
+  static void otaShaFinish(OtaShaCtx* c, uint8_t* out) { br_sha256_out(c, out); }
+#else
+  typedef mbedtls_sha256_context OtaShaCtx;
+  static void otaShaStart(OtaShaCtx* c) { mbedtls_sha256_init(c); mbedtls_sha256_starts(c, 0); }
+  static void otaShaUpdate(OtaShaCtx* c, const uint8_t* d, size_t n) { mbedtls_sha256_update(c, d, n); }
+  static void otaShaFinish(OtaShaCtx* c, uint8_t* out) { mbedtls_sha256_finish(c, out); mbedtls_sha256_free(c); }
+#endif
+
+// Identidade do arquivo no servidor (decide se a reconexão é o mesmo .bin)
+struct OtaSource {
+  String   sha256;      // X-Firmware-SHA256 (hex minúsculo) ou ""
+  String   etag;
+  uint32_t total = 0;
+
+  String id() const { return sha256.length() ? sha256 : etag + ":" + String(total); }
+};
+
+static OtaStats g_stats;
+static uint8_t g_otaBuf[OTA_BUF_SIZE];   // fora da pilha (a do loop no ESP8266 tem 4 KB)
+
+static void otaAbortUpdate() {
+  #ifdef ESP8266
+    Update.end();   // com bytes faltando: descarta sem ativar
+  #else
+    Update.abort();
+  #endif
+}
+
+// GET com Range (se from > 0); preenche a identidade do arquivo.
+// Retorna o código HTTP, -2 se o 206 não começar em 'from'.
+static int otaOpen(HTTPClient& http, WiFiClient& client, const String& url,
+                   uint32_t from, OtaSource& src) {
+  static const char* keys[] = {"X-Firmware-SHA256", "ETag", "Content-Range"};
+
+  http.setTimeout(30000);
+  if (!http.begin(client, url)) return -1;
+  http.collectHeaders(keys, 3);
+  if (from > 0) http.addHeader("Range", "bytes=" + String(from) + "-");
+
+  int code = http.GET();
+  if (code != HTTP_CODE_OK && code != HTTP_CODE_PARTIAL_CONTENT) return code;
+
+  src.sha256 = http.header("X-Firmware-SHA256");
+  src.sha256.toLowerCase();
+  src.etag  = http.header("ETag");
+  src.total = 0;
+
+  if (code == HTTP_CODE_PARTIAL_CONTENT) {
+    String cr = http.header("Content-Range");   // "bytes a-b/total"
+    int slash = cr.lastIndexOf('/');
+    if (!cr.startsWith("bytes ") || slash < 0 ||
+        (uint32_t)cr.substring(6).toInt() != from) {
+      return -2;
+    }
+    src.total = (uint32_t)cr.substring(slash + 1).toInt();
+  } else if (http.getSize() > 0) {
+    src.total = (uint32_t)http.getSize();
   }
+  return code;
+}
 
+static bool otaFailed(const String& error) {
+  g_lastError = error;
+  Serial.println("[OTA] Falha: " + error);
+  if (g_ota_command_id > 0)
+    reportOtaProgressToCloud(g_ota_command_id, g_ota_last_reported, "failed");
+  callEventCallback("failed", g_lastError);
+  g_otaInProgress = false;
+  return false;
+}
+
+static void otaBeginSession() {
   g_otaInProgress = true;
   g_lastError = "";
   g_ota_last_reported = -1;
+  g_stats = OtaStats();
 
   // Reporta início (0%) se commandId válido
   if (g_ota_command_id > 0) {
     reportOtaProgressToCloud(g_ota_command_id, 0, "in_progress");
     g_ota_last_reported = 0;
   }
+}
 
-  WiFiClient client;
-  HTTPClient http;
-
-  Serial.println("[OTA] Baixando: " + url);
-  callEventCallback("started", url);
+// Throughput, callbacks e reporte ao backend (throttle 25%)
+static void otaProgress(uint32_t received, uint32_t total, unsigned long t0, int& lastPct) {
+  unsigned long dt = millis() - t0;
+  if (dt > 0) g_stats.bytesPerSec = (uint64_t)received * 1000 / dt;
 
-  // Timeout na requisição
-  http.setTimeout(30000);
+  int prog = (uint64_t)received * 100 / total;
+  if (prog == lastPct) return;
+  lastPct = prog;
 
-  if (!http.begin(client, url)) {
-    g_lastError = "HTTP begin failed";
-    Serial.println("[OTA] HTTP begin falhou.");
-    callEventCallback("failed", g_lastError);
-    g_otaInProgress = false;
-    return false;
+  callProgressCallback(received, total);
+  if (prog % 10 == 0) {
+    Serial.printf("[OTA] %d%% (%u/%u) %u KB/s, flash %u ms\n", prog, received,
+                  total, g_stats.bytesPerSec / 1024, g_stats.flashWaitMs);
   }
+  if (g_ota_command_id > 0) {
+    int milestone = (prog / 25) * 25;
+    if (milestone > g_ota_last_reported) {
+      reportOtaProgressToCloud(g_ota_command_id, milestone, "in_progress");
+      g_ota_last_reported = milestone;
+    }
+  }
+}
 
-  int httpCode = http.GET();
-  Serial.printf("[OTA] HTTP code=%d\n", httpCode);
-
-  if (httpCode != HTTP_CODE_OK) {
-    g_lastError = "HTTP " + String(httpCode);
-    Serial.printf("[OTA] erro HTTP: %s\n", http.errorToString(httpCode).c_str());
-    http.end();
-    callEventCallback("failed", g_lastError);
-    g_otaInProgress = false;
+// Conexão caiu: reabre com Range a partir de 'received'. false = desistir
+// (error preenchido); true = seguir lendo (mesmo que esta tentativa falhe).
+static bool otaReconnect(HTTPClient& http, WiFiClient& client, const String& url,
+                         uint32_t received, uint32_t total, const OtaSource& src,
+                         String& error) {
+  http.end();
+  if (++g_stats.reconnects > OTA_MAX_RECONNECTS) {
+    error = "Conexão perdida em " + String(received) + "/" + String(total);
     return false;
   }
+  Serial.printf("[OTA] Conexão caiu em %u/%u, retomando (%u/%d)\n",
+                received, total, g_stats.reconnects, OTA_MAX_RECONNECTS);
+  callEventCallback("resuming", String(received));
+  delay(1000 * g_stats.reconnects);
+
+  OtaSource again;
+  int code = otaOpen(http, client, url, received, again);
+  if (code == HTTP_CODE_PARTIAL_CONTENT) {
+    if (again.id() != src.id() || again.total != total) {
+      error = "Firmware mudou no servidor durante o download";
+      return false;
+    }
+  } else {
+    Serial.printf("[OTA] Retomada falhou: HTTP %d\n", code);
+    http.end();   // próxima volta tenta de novo
+  }
+  return true;
+}
 
-  int contentLen = http.getSize();
-  Serial.printf("[OTA] Content-Length: %d bytes\n", contentLen);
+static bool otaBeginUpdate(uint32_t size) {
+  if (Update.begin(size)) return true;
+#ifdef ESP8266
+  Serial.print("[OTA] Update.begin falhou: ");
+  Update.printError(Serial);
+  g_lastError = "Update.begin failed";
+#else
+  g_lastError = "Update.begin failed: " + String(Update.errorString());
+#endif
+  return false;
+}
 
-  WiFiClient* stream = http.getStreamPtr();
+// SHA conferido: entrega o último bloco retido, ativa a imagem e reinicia
+static bool otaCommit(const uint8_t* last, size_t lastLen, uint32_t total) {
+  if (Update.write((uint8_t*)last, lastLen) != lastLen) {
+    otaAbortUpdate();
+    return otaFailed("Write error no último bloco, code=" + String(Update.getError()));
+  }
+  callProgressCallback(total, total);
 
-  // Usar contentLen se disponível; em ESP8266 não existe UPDATE_SIZE_UNKNOWN
-  #ifdef ESP8266
-    size_t total = (contentLen > 0) ? (size_t)contentLen : 0;
-  #else
-    size_t total = (contentLen > 0) ? (size_t)contentLen : (size_t)UPDATE_SIZE_UNKNOWN;
-  #endif
+  Serial.println("\n[OTA] Download concluído, finalizando...");
 
-  if (!Update.begin(total)) {
+  if (!Update.end(true)) {  // true = setSize() com bytes escritos
   #ifdef ESP8266
-    g_lastError = "Update.begin failed";
-    Serial.print("[OTA] Update.begin falhou: ");
+    Serial.print("[OTA] Erro: ");
     Update.printError(Serial);
+    return otaFailed("Update.end failed");
   #else
-    g_lastError = "Update.begin failed: " + String(Update.errorString());
-    Serial.printf("[OTA] Update.begin falhou: %s\n", Update.errorString());
+    return otaFailed("Update.end failed: " + String(Update.errorString()));
   #endif
-    http.end();
-    callEventCallback("failed", g_lastError);
-    g_otaInProgress = false;
-    return false;
   }
 
-  callEventCallback("downloading", "0%");
+  if (!Update.isFinished()) {
+    return otaFailed("Update incomplete");
+  }
 
-  size_t written = 0;
-  uint8_t buff[512];
-  unsigned long lastYield = millis();
+  // Reporta 100% / done antes de reiniciar
+  if (g_ota_command_id > 0)
+    reportOtaProgressToCloud(g_ota_command_id, 100, "done");
 
-  unsigned long lastDataMs = millis();
+  // Log de sucesso no backend antes de reiniciar
+  logOtaSuccessToCloud();
 
-  while (g_otaInProgress) {
-    size_t available = stream->available();
+  Serial.println("[OTA] 100% OK - Reboot em 2s!");
+  callEventCallback("success", "Rebooting...");
+  g_otaInProgress = false;
 
-    if (available) {
-      size_t len = stream->readBytes(buff,
-        (available > sizeof(buff)) ? sizeof(buff) : available);
+  delay(2000);
+  Serial.println("[OTA] chamando ESP.restart()");
+  ESP.restart();
+  return true;
+}
 
-      if (len == 0) {
-        // fim do stream
-        break;
-      }
+static bool otaInternal(const String& url) {
+  if (WiFi.status() != WL_CONNECTED) {
+    g_lastError = "WiFi not connected";
+    Serial.println("[OTA] WiFi desconectado.");
+    callEventCallback("failed", "WiFi not connected");
+    return false;
+  }
 
-      size_t writeRes = Update.write(buff, len);
-      if (writeRes != len) {
-        g_lastError = String("Write error: ") + String(writeRes) + "/" + String(len) +
-                      " code=" + String(Update.getError());
-        Serial.printf("[OTA] write falhou %u/%u, error=%d\n",
-          writeRes, len, Update.getError());
-        http.end();
+  otaBeginSession();
 
-        #ifdef ESP8266
-          Update.end();
-        #else
-          Update.abort();
-        #endif
+  WiFiClient client;
+  HTTPClient http;
+  OtaSource src;
 
-        if (g_ota_command_id > 0)
-          reportOtaProgressToCloud(g_ota_command_id, g_ota_last_reported, "failed");
-        callEventCallback("failed", g_lastError);
-        g_otaInProgress = false;
-        return false;
-      }
+  Serial.println("[OTA] Baixando: " + url);
+  callEventCallback("started", url);
+
+  int httpCode = otaOpen(http, client, url, 0, src);
+  Serial.printf("[OTA] HTTP code=%d, total=%u, sha256=%s\n",
+                httpCode, src.total, src.sha256.length() ? src.sha256.c_str() : "-");
+
+  if (httpCode != HTTP_CODE_OK) {
+    http.end();
+    return otaFailed("HTTP " + String(httpCode));
+  }
+  // Range e a retenção do último bloco precisam do tamanho
+  if (src.total == 0) {
+    http.end();
+    return otaFailed("Content-Length ausente");
+  }
+  const uint32_t total = src.total;
+
+  if (!otaBeginUpdate(total)) {
+    http.end();
+    return otaFailed(g_lastError);
+  }
+
+  callEventCallback("downloading", "0%");
 
-      written += len;
+  OtaShaCtx sha;
+  otaShaStart(&sha);
+
+  // http.begin(client, ...) lê deste client; após http.end() ele só fica
+  // desconectado (getStreamPtr() devolveria nullptr) e dispara a retomada
+  WiFiClient* stream = &client;
+  String error;
+  uint32_t received = 0;
+  size_t lastLen = 0;                 // último bloco, retido até conferir o SHA
+  int lastPct = -1;
+  unsigned long t0 = millis();
+  unsigned long lastDataMs = t0;
+  unsigned long lastYield = t0;
+
+  while (received < total) {
+    if (!g_otaInProgress) { error = "Cancelled"; break; }
+
+    size_t avail = stream->available();
+    if (avail) {
+      size_t want = min((size_t)OTA_BUF_SIZE, (size_t)(total - received));
+      size_t len = stream->readBytes(g_otaBuf, min(want, avail));
+      if (len == 0) continue;
+
+      otaShaUpdate(&sha, g_otaBuf, len);
+      received += len;
       lastDataMs = millis();
 
-      // Log de progresso
-      if (contentLen > 0) {
-        int prog = (written * 100) / (size_t)contentLen;
-        if (prog % 10 == 0 || written == (size_t)contentLen) {
-          Serial.printf("[OTA] %d%% (%u/%d)\n", prog, written, contentLen);
-          callProgressCallback(written, contentLen);
-        }
-        // Throttle: reporta ao backend apenas em múltiplos de 25%
-        if (g_ota_command_id > 0) {
-          int milestone = (prog / 25) * 25;
-          if (milestone > g_ota_last_reported) {
-            reportOtaProgressToCloud(g_ota_command_id, milestone, "in_progress");
-            g_ota_last_reported = milestone;
-          }
-        }
-      } else {
-        if (written % 10240 == 0) {
-          Serial.printf("[OTA] %u bytes...\n", written);
-          callProgressCallback(written, written);
-        }
+      if (received == total) {
+        lastLen = len;
+        break;
       }
 
+      unsigned long tw = millis();
+      size_t writeRes = Update.write(g_otaBuf, len);
+      g_stats.flashWaitMs += millis() - tw;
+      if (writeRes != len) {
+        error = String("Write error: ") + String(writeRes) + "/" + String(len) +
+                " code=" + String(Update.getError());
+        break;
+      }
+      otaProgress(received, total, t0, lastPct);
+
       unsigned long now = millis();
       if (now - lastYield > 100) {
         yield();
         lastYield = now;
       }
+      continue;
+    }
 
-    } else {
-      // já baixou tudo e não vem mais nada há 5s → sai do loop
-      if (contentLen > 0 &&
-          written >= (size_t)contentLen &&
-          millis() - lastDataMs > 5000) {
-        Serial.println("[OTA] Timeout pós-download, saindo do loop");
-        break;
-      }
+    if (stream->connected() && millis() - lastDataMs < OTA_READ_TIMEOUT_MS) {
       yield();
       delay(1);
+      continue;
     }
+    if (!otaReconnect(http, client, url, received, total, src, error)) break;
+    lastDataMs = millis();
   }
 
   http.end();
 
-  Serial.printf("\n[OTA] pós-http.end, written=%u, total=%d\n", written, contentLen);
+  uint8_t digest[32];
+  otaShaFinish(&sha, digest);
+  char hex[65];
+  for (int i = 0; i < 32; i++) sprintf(hex + i * 2, "%02x", digest[i]);
 
-  Serial.println("\n[OTA] Download concluído, finalizando...");
+  Serial.printf("[OTA] Download: %u/%u bytes, %u KB/s, %u reconexões\n",
+                received, total, g_stats.bytesPerSec / 1024, g_stats.reconnects);
 
-  if (!Update.end(true)) {  // true = setSize() com bytes escritos
-  #ifdef ESP8266
-    g_lastError = "Update.end failed";
-    Serial.print("[OTA] Erro: ");
-    Update.printError(Serial);
-  #else
-    g_lastError = "Update.end failed: " + String(Update.errorString());
-    Serial.printf("[OTA] Erro: %s\n", Update.errorString());
-  #endif
-    if (g_ota_command_id > 0)
-      reportOtaProgressToCloud(g_ota_command_id, g_ota_last_reported, "failed");
-    callEventCallback("failed", g_lastError);
-    g_otaInProgress = false;
+  if (error.length() == 0 && src.sha256.length() && src.sha256 != hex) {
+    error = "SHA-256 divergente: " + String(hex);
+  }
+  if (error.length()) {
+    otaAbortUpdate();
+    return otaFailed(error);
+  }
+  if (!src.sha256.length()) {
+    Serial.printf("[OTA] Servidor sem X-Firmware-SHA256; sha256=%s\n", hex);
+  }
+
+  return otaCommit(g_otaBuf, lastLen, total);
+}
+
+// ======== OTA DELTA ========
+//
+// O backend gera patches RBSD (backend/fwdelta) do firmware de cada versão
+// anterior para a mais nova; tipicamente 10-40x menores que o .bin. FwDelta
+// lê o firmware antigo direto da flash e entrega a imagem nova em ordem ao
+// Updater, com o mesmo truque de reter o último bloco até conferir o
+// SHA-256. Sem patch para a versão atual (404) ou falha -> imagem completa.
+
+struct OtaDeltaSink {
+  OtaShaCtx sha;
+  size_t    held = 0;    // bytes em g_otaBuf ainda não entregues ao Updater
+  bool      failed = false;
+};
+
+#ifdef ESP8266
+// O sketch em execução começa no endereço 0 da flash; flashRead exige
+// endereço e tamanho alinhados em 4 bytes
+static int otaDeltaReadOld(void* user, uint32_t off, uint8_t* buf, uint32_t len) {
+  (void)user;
+  static uint32_t tmp[(FWD_OLD_CACHE + 8) / 4];
+  while (len > 0) {
+    uint32_t base = off & ~3u;
+    uint32_t skip = off - base;
+    uint32_t n = min(len, (uint32_t)FWD_OLD_CACHE);
+    uint32_t span = (skip + n + 3) & ~3u;
+    if (!ESP.flashRead(base, tmp, span)) return -1;
+    memcpy(buf, (uint8_t*)tmp + skip, n);
+    off += n;
+    buf += n;
+    len -= n;
+  }
+  return 0;
+}
+#else
+static int otaDeltaReadOld(void* user, uint32_t off, uint8_t* buf, uint32_t len) {
+  (void)user;
+  return esp_partition_read(esp_ota_get_running_partition(), off, buf, len) == ESP_OK ? 0 : -1;
+}
+#endif
+
+// Retém até OTA_BUF_SIZE bytes: só grava o bloco cheio quando chega mais dado
+static int otaDeltaWrite(void* user, const uint8_t* data, uint32_t len) {
+  OtaDeltaSink* s = (OtaDeltaSink*)user;
+  otaShaUpdate(&s->sha, data, len);
+  while (len > 0) {
+    if (s->held == OTA_BUF_SIZE) {
+      unsigned long tw = millis();
+      size_t res = Update.write(g_otaBuf, OTA_BUF_SIZE);
+      g_stats.flashWaitMs += millis() - tw;
+      if (res != OTA_BUF_SIZE) { s->failed = true; return -1; }
+      s->held = 0;
+    }
+    uint32_t n = min((uint32_t)(OTA_BUF_SIZE - s->held), len);
+    memcpy(g_otaBuf + s->held, data, n);
+    s->held += n;
+    data += n;
+    len -= n;
+  }
+  return 0;
+}
+
+// Confere o firmware em execução com o old_sha256 do patch
+static bool otaDeltaCheckOld(fwd_ctx_t* fwd) {
+  OtaShaCtx sha;
+  uint8_t buf[FWD_OLD_CACHE];
+  uint8_t digest[32];
+  otaShaStart(&sha);
+  bool ok = true;
+  for (uint32_t pos = 0; pos < fwd->hdr.old_size && ok; pos += sizeof(buf)) {
+    uint32_t n = min((uint32_t)sizeof(buf), fwd->hdr.old_size - pos);
+    ok = fwd_read_old(fwd, pos, buf, n) == FWD_OK;
+    if (ok) otaShaUpdate(&sha, buf, n);
+    if ((pos & 0xFFFF) == 0) yield();
+  }
+  otaShaFinish(&sha, digest);
+  return ok && memcmp(digest, fwd->hdr.old_sha256, 32) == 0;
+}
+
+// true só se aplicou e vai reiniciar; false = usar a imagem completa
+static bool otaDeltaInternal(const String& url) {
+  g_lastError = "";
+  if (WiFi.status() != WL_CONNECTED) return false;
+
+  WiFiClient client;
+  HTTPClient http;
+  OtaSource src;
+  int httpCode = otaOpen(http, client, url, 0, src);
+  if (httpCode != HTTP_CODE_OK || src.total == 0) {
+    Serial.printf("[OTA] Sem patch delta (HTTP %d), usando imagem completa\n", httpCode);
+    http.end();
     return false;
   }
 
-  if (!Update.isFinished()) {
-    g_lastError = "Update incomplete";
-    Serial.println("[OTA] Update não finalizou corretamente");
-    if (g_ota_command_id > 0)
-      reportOtaProgressToCloud(g_ota_command_id, g_ota_last_reported, "failed");
-    callEventCallback("failed", g_lastError);
-    g_otaInProgress = false;
+  // ~2.5 KB de estado só durante o delta (RAM do ESP8266 é curta)
+  fwd_ctx_t* fwd = (fwd_ctx_t*)malloc(sizeof(fwd_ctx_t));
+  if (!fwd) {
+    http.end();
     return false;
   }
 
-  // Reporta 100% / done antes de reiniciar
-  if (g_ota_command_id > 0)
-    reportOtaProgressToCloud(g_ota_command_id, 100, "done");
+  otaBeginSession();
+  Serial.printf("[OTA] Delta: %s (%u bytes)\n", url.c_str(), src.total);
+  callEventCallback("started", url);
 
-  // Log de sucesso no backend antes de reiniciar
-  logOtaSuccessToCloud();
+  OtaDeltaSink sink;
+  otaShaStart(&sink.sha);
+  fwd_init(fwd, otaDeltaReadOld, otaDeltaWrite, &sink);
+
+  const uint32_t total = src.total;
+  WiFiClient* stream = &client;
+  String error;
+  bool updating = false;
+  uint32_t received = 0;
+  int lastPct = -1;
+  int r = FWD_OK;
+  unsigned long t0 = millis();
+  unsigned long lastDataMs = t0;
+  uint8_t in[256];
+
+  while (r != FWD_DONE) {
+    if (!g_otaInProgress) { error = "Cancelled"; break; }
+    if (received >= total) { error = "Patch incompleto"; break; }
+
+    size_t avail = stream->available();
+    if (avail) {
+      size_t len = stream->readBytes(in, min(min(avail, sizeof(in)), (size_t)(total - received)));
+      received += len;
+      lastDataMs = millis();
 
-  Serial.println("[OTA] 100% OK - Reboot em 2s!");
-  callEventCallback("success", "Rebooting...");
-  g_otaInProgress = false;
+      const uint8_t* p = in;
+      while (len > 0 && r != FWD_DONE) {
+        size_t used = 0;
+        r = fwd_feed(fwd, p, len, &used);
+        p += used;
+        len -= used;
+        if (r < 0) break;
+        if (r == FWD_HEADER) {
+          if (!otaDeltaCheckOld(fwd)) { error = "Firmware em execução não confere com o patch"; break; }
+          if (!otaBeginUpdate(fwd->hdr.new_size)) { error = g_lastError; break; }
+          updating = true;
+        }
+      }
+      if (r < 0 && error.length() == 0) error = "Patch inválido (" + String(r) + ")";
+      if (error.length()) break;
+      otaProgress(received, total, t0, lastPct);
+      yield();
+      continue;
+    }
 
-  delay(2000);
-  Serial.println("[OTA] chamando ESP.restart()");
-  ESP.restart();
-  return true;
+    if (stream->connected() && millis() - lastDataMs < OTA_READ_TIMEOUT_MS) {
+      yield();
+      delay(1);
+      continue;
+    }
+    if (!otaReconnect(http, client, url, received, total, src, error)) break;
+    lastDataMs = millis();
+  }
+  http.end();
+
+  uint8_t digest[32];
+  otaShaFinish(&sink.sha, digest);
+  const uint32_t newSize = fwd->hdr.new_size;
+  if (error.length() == 0 && memcmp(digest, fwd->hdr.new_sha256, 32) != 0) {
+    error = "Imagem reconstruída não confere (SHA-256)";
+  }
+  free(fwd);
+
+  Serial.printf("[OTA] Delta: %u/%u bytes de patch -> %u bytes, %u KB/s\n",
+                received, total, newSize, g_stats.bytesPerSec / 1024);
+
+  if (error.length()) {
+    if (updating) otaAbortUpdate();
+    Serial.println("[OTA] Delta falhou (" + error + "), usando imagem completa");
+    callEventCallback("delta_failed", error);
+    g_lastError = error;
+    g_otaInProgress = false;
+    return false;
+  }
+  return otaCommit(g_otaBuf, sink.held, newSize);
 }
 
 bool otaFromUrl(const String& url) {
@@ -351,6 +659,9 @@ bool otaUpdateKh() {
 }
 
 bool otaUpdateDoser() {
+  // Patch delta a partir do firmware em execução; sem patch -> imagem completa
+  if (otaDeltaInternal(g_baseUrl + "/ota/doser/latest.delta?from=" + String(FW_VERSION))) return true;
+  if (g_lastError == "Cancelled") return false;
   return otaInternal(g_baseUrl + "/ota/doser/latest.bin");
 }
 
@@ -732,12 +1043,8 @@ bool otaIsInProgress() {
 
 void otaCancel() {
   if (g_otaInProgress || g_webOtaInProgress) {
-
-  #ifdef ESP8266
-      Update.end();
-  #else
-      Update.abort();
-  #endif
+    // OTA HTTP: o loop de download vê a flag e descarta o Update sozinho
+    if (g_webOtaInProgress) otaAbortUpdate();
 
     g_otaInProgress = false;
     g_webOtaInProgress = false;
@@ -750,3 +1057,7 @@ void otaCancel() {
 String otaGetLastError() {
   return g_lastError;
 }
+
+OtaStats otaGetStats() {
+  return g_stats;
+}
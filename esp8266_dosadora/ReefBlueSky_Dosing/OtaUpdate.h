@@ -16,6 +16,14 @@ typedef void (*OtaProgressCallback)(int percent, int written, int total);
 // Callback opcional para eventos OTA (started, success, failed)
 typedef void (*OtaEventCallback)(const String& event, const String& details);
 
+// Métricas do download OTA atual (válidas dentro do OtaProgressCallback)
+struct OtaStats {
+  uint32_t bytesPerSec;   // média desde o início do download
+  uint32_t resumedFrom;   // sempre 0 aqui: o Updater não retoma após reboot
+  uint16_t reconnects;    // reconexões com Range dentro da sessão
+  uint32_t flashWaitMs;   // tempo gasto em Update.write()
+};
+
 // ======== Inicialização ========
 
 /**
@@ -33,7 +41,9 @@ void otaInit(
 // ======== OTA via HTTP ========
 
 /**
- * Baixa e atualiza firmware a partir de uma URL completa
+ * Baixa e atualiza firmware a partir de uma URL completa.
+ * Quedas de conexão são retomadas com Range e o SHA-256 é conferido com o
+ * header X-Firmware-SHA256 do servidor antes de ativar a imagem.
  * @param url URL do arquivo .bin
  * @return true se sucesso (vai fazer reboot), false se erro
  */
@@ -75,3 +85,8 @@ void otaCancel();
  * Retorna última mensagem de erro
  */
 String otaGetLastError();
+
+/**
+ * Métricas do último/atual download OTA (throughput, reconexões)
+ */
+OtaStats otaGetStats();
@@ -25,6 +25,7 @@ const char* FW_VERSION     = "RBS_DOSER_260204.bin";
 #include "WiFiSetupDoser.h"
 #include "CloudAuthDoser.h"
 #include "DoserControl.h"
+#include "DoserLan.h"
 
 // ============================================================================
 // CONFIGURAÇÃO DE HARDWARE
@@ -44,12 +45,14 @@ String espUid;
 WiFiSetupDoser* wifiSetup = nullptr;
 CloudAuthDoser* cloudAuth = nullptr;
 DoserControl* doser = nullptr;
+DoserLan* doserLan = nullptr;
 
 uint32_t lastConfigButton = 0;
 bool configButtonPressed = false;
 
 uint32_t lastStatus = 0;
 uint32_t lastHandshake = 0;
+uint32_t lastLanKeyTry = 0;
 
 // ============================================================================
 // SETUP
@@ -117,42 +120,31 @@ void setup() {
     handleExecution(pumpId, volumeMl, scheduleId, whenEpoch, status, origin, doseIndex);
   });
 
-  // 7. Handshake inicial: SEMPRE tentar config do servidor primeiro
+  // 7. Config local primeiro (traz a config_version), depois o handshake
+  //    condicional: se o servidor não mudou nada, nada é baixado nem gravado
   bool configLoaded = false;
-  DynamicJsonDocument configDoc(8192);
 
-  if (cloudAuth && cloudAuth->fetchDoserConfig(configDoc)) {
-    Serial.println("[SETUP] Config do servidor recebida, carregando doser...");
-    doser->loadFromServer(configDoc);
+  if (doser->loadFromFile()) {
+    Serial.println("[SETUP] Config local encontrada, doser carregado");
     configLoaded = true;
-    Serial.println("[SETUP] ✓ Dosadora pronta com config do servidor!");
-  } else {
-    Serial.println("[SETUP] Falha no handshake inicial, tentando config local...");
   }
 
-  // 7.1 Se handshake falhar, tenta config local (modo offline)
-  if (!configLoaded && SPIFFS.exists("/doser_config.json")) {
-    File f = SPIFFS.open("/doser_config.json", "r");
-    if (f) {
-      DynamicJsonDocument localDoc(8192);
-      DeserializationError err = deserializeJson(localDoc, f);
-      f.close();
-      if (!err && localDoc.containsKey("pumps")) {
-        Serial.println("[SETUP] Config local encontrada, carregando doser (offline)...");
-        doser->loadFromServer(localDoc);
-        configLoaded = true;
-      } else {
-        Serial.printf("[SETUP] Falha ao ler config local: %s\n", err.c_str());
-      }
-    } else {
-      Serial.println("[SETUP] Erro ao abrir /doser_config.json");
-    }
+  if (cloudAuth && cloudAuth->fetchDoserConfig(doser)) {
+    configLoaded = true;
+    Serial.println("[SETUP] ✓ Dosadora pronta com config do servidor!");
+  } else {
+    Serial.println("[SETUP] Falha no handshake inicial, operando com config local (offline)");
   }
+  lastHandshake = millis();
 
   if (!configLoaded) {
     Serial.println("[SETUP] Nenhuma config válida (server nem local); aguardando próximo handshake...");
   }
 
+  // 8. LAN com o monitor de KH (chave do servidor ou do arquivo)
+  doserLan = new DoserLan();
+  setupLan();
+
 }
 
 void generateEspUid() {
@@ -187,31 +179,32 @@ void loop() {
   handleConfigButton();
 
   // 5) Cloud
-  static uint32_t lastCmdCheck = 0;
-
   if (cloudAuth && cloudAuth->isAuthenticated()) {
     cloudAuth->ensureTokenFresh();
 
-    // comandos a cada 1s
-    if (doser && (now - lastCmdCheck > 1000)) {
+    // comandos: long-poll não bloqueante (CommandPoll), chamado a cada volta
+    if (doser) {
       cloudAuth->processCommands(doser);
-      lastCmdCheck = now;
     }
 
     // Status periódico (30s)
     if (now - lastStatus > 30000) {
       DynamicJsonDocument statusDoc(512);
       doser->buildPumpsStatusJson(statusDoc);
-      cloudAuth->sendDoserStatus(now / 1000, WiFi.RSSI(), statusDoc);
+      StaticJsonDocument<256> lanDoc;
+      if (doserLan) doserLan->buildStatusJson(lanDoc.to<JsonObject>());
+      cloudAuth->sendDoserStatus(now / 1000, WiFi.RSSI(), statusDoc, doserLan ? &lanDoc : nullptr);
       lastStatus = now;
     }
 
-    // Handshake periódico (5min)
+    // LAN sem chave (primeiro boot offline): tenta de novo a cada 5 min
+    if (doserLan && !doserLan->ready() && now - lastLanKeyTry > 300000) {
+      setupLan();
+    }
+
+    // Handshake periódico (60 s): condicional, "unchanged" na maioria das vezes
     if (now - lastHandshake > 60000) {
-      DynamicJsonDocument configDoc(8192);
-      if (cloudAuth->fetchDoserConfig(configDoc)) {
-        doser->loadFromServer(configDoc);
-      }
+      cloudAuth->fetchDoserConfig(doser);
       lastHandshake = now;
     }
   } else {
@@ -224,7 +217,12 @@ void loop() {
     }
   }
 
-  // 6) DoserControl loop
+  // 6) Pedidos do monitor pela LAN, antes do DoserControl ligar/desligar bombas
+  if (doserLan) {
+    doserLan->loop();
+  }
+
+  // 7) DoserControl loop
   if (doser) {
     time_t nowUtc = time(nullptr);
     time_t nowUsr = nowUtc + g_userUtcOffsetSec;
@@ -372,6 +370,19 @@ void setupCloud() {
 }
 
 
+void setupLan() {
+  lastLanKeyTry = millis();
+  if (!doserLan || WiFi.status() != WL_CONNECTED) return;
+
+  String hexKey;
+  if (cloudAuth && cloudAuth->isAuthenticated() && cloudAuth->fetchLanKey(hexKey)) {
+    DoserLan::saveKey(hexKey);
+  }
+  // Sem resposta do servidor: begin() usa a chave salva
+  doserLan->begin(espUid, hexKey, doser);
+}
+
+
 void handleExecution(uint32_t pumpId, float volumeMl,
                      uint32_t scheduleId, uint32_t whenEpoch,
                      const char* status, const char* origin, uint8_t doseIndex) {
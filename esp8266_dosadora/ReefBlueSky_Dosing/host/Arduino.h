@@ -0,0 +1,84 @@
+// Arduino.h (host) - só o necessário para compilar os módulos testados aqui
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <chrono>
+#include <thread>
+
+inline uint32_t millis() {
+  static const auto t0 = std::chrono::steady_clock::now();
+  return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - t0).count();
+}
+
+inline void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// Serial vai para stderr só com HOST_VERBOSE=1
+struct HostSerial {
+  bool on() const { static bool v = getenv("HOST_VERBOSE") != nullptr; return v; }
+  void printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    if (!on()) return;
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+  }
+  void println(const char* s) { if (on()) fprintf(stderr, "%s\n", s); }
+};
+extern HostSerial Serial;
+
+// Print/Stream mínimos (File e WiFiClient no firmware)
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t len) {
+    size_t n = 0;
+    while (len--) n += write(*buf++);
+    return n;
+  }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    // como no core: buffer na pilha e malloc se não couber
+    char stackBuf[64];
+    char* buf = stackBuf;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(stackBuf), fmt, ap);
+    va_end(ap);
+    if (n < 0) return 0;
+    if ((size_t)n >= sizeof(stackBuf)) {
+      buf = (char*)malloc(n + 1);
+      if (!buf) return 0;
+      va_start(ap, fmt);
+      vsnprintf(buf, n + 1, fmt, ap);
+      va_end(ap);
+    }
+    size_t w = write((const uint8_t*)buf, n);
+    if (buf != stackBuf) free(buf);
+    return w;
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  size_t write(uint8_t) override { return 0; }
+  size_t readBytes(char* buf, size_t len) {
+    size_t n = 0;
+    while (n < len) {
+      int c = read();
+      if (c < 0) break;
+      buf[n++] = (char)c;
+    }
+    return n;
+  }
+};
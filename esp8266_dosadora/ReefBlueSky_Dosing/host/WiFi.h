@@ -0,0 +1,3 @@
+// WiFi.h (host)
+#pragma once
+#include "WiFiClient.h"
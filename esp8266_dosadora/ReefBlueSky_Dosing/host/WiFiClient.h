@@ -0,0 +1,71 @@
+// WiFiClient.h (host) - WiFiClient do core Arduino sobre socket POSIX
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+class WiFiClient {
+public:
+  ~WiFiClient() { stop(); }
+
+  int connect(const char* host, uint16_t port) {
+    stop();
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) return 0;
+    _fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (_fd < 0) return 0;
+    if (::connect(_fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+      stop();
+      return 0;
+    }
+    return 1;
+  }
+
+  size_t write(const uint8_t* buf, size_t n) {
+    size_t sent = 0;
+    while (_fd >= 0 && sent < n) {
+      ssize_t r = send(_fd, buf + sent, n - sent, MSG_NOSIGNAL);
+      if (r <= 0) break;
+      sent += r;
+    }
+    return sent;
+  }
+
+  int available() {
+    int n = 0;
+    if (_fd < 0 || ioctl(_fd, FIONREAD, &n) != 0) return 0;
+    return n;
+  }
+
+  int read(uint8_t* buf, size_t n) {
+    if (_fd < 0) return -1;
+    ssize_t r = recv(_fd, buf, n, MSG_DONTWAIT);
+    return r > 0 ? (int)r : -1;
+  }
+
+  uint8_t connected() {
+    if (_fd < 0) return 0;
+    char c;
+    ssize_t r = recv(_fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (r > 0) return 1;
+    if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 1;
+    return 0;
+  }
+
+  void stop() {
+    if (_fd >= 0) close(_fd);
+    _fd = -1;
+  }
+
+private:
+  int _fd = -1;
+};
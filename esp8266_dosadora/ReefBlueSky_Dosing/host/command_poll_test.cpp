@@ -0,0 +1,281 @@
+// command_poll_test.cpp - máquina de estados do CommandPoll contra um
+// servidor substituto local (socket TCP de verdade em 127.0.0.1)
+//
+// StandIn reproduz POST /iot/dosing/commands do backend: com wait_s segura
+// a resposta até chegar comando (inject) ou o tempo acabar, e manda o
+// header X-Long-Poll; no modo legado responde na hora sem o header; no
+// modo gateway responde 504. Tempo do servidor comprimido: 1 s de wait_s
+// = SCALE_MS de relógio, para simular horas em segundos.
+//
+// Uso: ./command_poll_test      (make test; HOST_VERBOSE=1 mostra o Serial)
+
+#include "../CommandPoll.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+HostSerial Serial;
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+
+static const uint32_t SCALE_MS = 10;   // 1 s do servidor = 10 ms aqui
+
+// ---------- Servidor substituto ----------
+
+enum Mode { LONGPOLL, LEGACY, GATEWAY };
+
+struct StandIn {
+  int listenFd = -1;
+  uint16_t port = 0;
+  std::thread th;
+  std::atomic<bool> stop{false};
+  std::atomic<int> mode{LONGPOLL};
+  std::atomic<int> requests{0};
+  std::atomic<int> lastWait{0};
+  std::atomic<int> active{0};    // conexões em atendimento (uma thread cada)
+
+  std::mutex mu;
+  std::condition_variable cv;
+  std::string pending;           // comandos JSON enfileirados
+
+  void start() {
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(listenFd, (sockaddr*)&addr, sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(listenFd, (sockaddr*)&addr, &len);
+    port = ntohs(addr.sin_port);
+    listen(listenFd, 4);
+    th = std::thread([this] { run(); });
+  }
+
+  void shutdown() {
+    stop = true;
+    cv.notify_all();
+    ::shutdown(listenFd, SHUT_RDWR);
+    close(listenFd);
+    th.join();
+    while (active > 0) delay(1);
+  }
+
+  void inject(const char* cmdJson) {
+    std::lock_guard<std::mutex> lk(mu);
+    if (!pending.empty()) pending += ",";
+    pending += cmdJson;
+    cv.notify_all();
+  }
+
+  static void reply(int fd, int status, bool longPoll, const std::string& body) {
+    char hdr[256];
+    int n = snprintf(hdr, sizeof(hdr),
+                     "HTTP/1.1 %d X\r\nContent-Type: application/json\r\n%s"
+                     "Content-Length: %zu\r\nConnection: close\r\n\r\n",
+                     status, longPoll ? "x-long-poll: 90\r\n" : "", body.size());
+    send(fd, hdr, n, MSG_NOSIGNAL);
+    send(fd, body.data(), body.size(), MSG_NOSIGNAL);
+  }
+
+  static bool peerClosed(int fd) {
+    char c;
+    return recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 0;
+  }
+
+  void run() {
+    while (!stop) {
+      int fd = accept(listenFd, nullptr, nullptr);
+      if (fd < 0) continue;
+      active++;
+      std::thread([this, fd] { handle(fd); close(fd); active--; }).detach();
+    }
+  }
+
+  void handle(int fd) {
+      // lê headers + corpo
+      std::string req;
+      char buf[512];
+      while (true) {
+        ssize_t r = recv(fd, buf, sizeof(buf), 0);
+        if (r <= 0) break;
+        req.append(buf, r);
+        size_t he = req.find("\r\n\r\n");
+        size_t cl = req.find("Content-Length: ");
+        if (he != std::string::npos && cl != std::string::npos &&
+            req.size() >= he + 4 + (size_t)atoi(req.c_str() + cl + 16)) break;
+      }
+      requests++;
+      size_t w = req.find("\"wait_s\":");
+      int waitS = w == std::string::npos ? 0 : atoi(req.c_str() + w + 9);
+      lastWait = waitS;
+
+      if (mode == GATEWAY) {
+        reply(fd, 504, false, "<html>Gateway Timeout</html>");
+        return;
+      }
+      std::unique_lock<std::mutex> lk(mu);
+      if (mode == LONGPOLL) {
+        // como o backend: desiste se o cliente fechou (não consome comando)
+        uint32_t until = millis() + waitS * SCALE_MS;
+        while (pending.empty() && !stop && (int32_t)(millis() - until) < 0) {
+          cv.wait_for(lk, std::chrono::milliseconds(5));
+          if (peerClosed(fd)) return;
+        }
+      }
+      std::string body = "{\"success\":true,\"commands\":[" + pending + "]}";
+      pending.clear();
+      lk.unlock();
+      reply(fd, 200, mode == LONGPOLL, body);
+  }
+};
+
+// Uma volta do loop() da dosadora (delay(50) lá; aqui 2 ms)
+static bool step(CommandPoll& poll) {
+  bool got = poll.loop(millis());
+  delay(2);
+  return got;
+}
+
+static void begin(CommandPoll& poll, uint16_t port) {
+  char url[64];
+  snprintf(url, sizeof(url), "http://127.0.0.1:%u/api/v1", port);
+  CHECK(poll.begin(url, "RBS-DOSER-TEST"));
+}
+
+// ---------- Casos ----------
+
+// Ocioso: quantos pedidos por "dia" com long-poll contra o poll de 1 s
+static void testIdle(StandIn& s) {
+  s.mode = LONGPOLL;
+  int before = s.requests;
+  CommandPoll poll;
+  begin(poll, s.port);
+
+  // intervalo médio entre pedidos (do 1º ao último) no tempo do servidor
+  uint32_t t0 = millis(), first = 0, last = 0;
+  uint32_t seen = 0;
+  while (millis() - t0 < 4000) {
+    CHECK(!step(poll) || strstr(poll.body(), "\"commands\":[]"));
+    if (poll.requests() != seen) {
+      seen = poll.requests();
+      if (seen == 1) first = millis();
+      last = millis();
+    }
+  }
+  int reqs = s.requests - before;
+  double virtualS = (last - first) / (double)SCALE_MS;
+  double perDay = (seen - 1) * 86400.0 / virtualS;
+  printf("ocioso: %d pedidos, 1 a cada %.0f s simulados -> %.0f/dia (poll de 1 s: 86400/dia, %.0fx menos)\n",
+         reqs, virtualS / (seen - 1), perDay, 86400.0 / perDay);
+  CHECK(!poll.legacy());
+  CHECK(s.lastWait == CMDPOLL_WAIT_S);
+  CHECK(reqs == (int)seen);
+  CHECK(perDay <= 1000);             // ~duas ordens de grandeza
+}
+
+// Latência: comando entra no meio da espera e sai na hora
+static void testLatency(StandIn& s) {
+  s.mode = LONGPOLL;
+  CommandPoll poll;
+  begin(poll, s.port);
+
+  uint32_t worst = 0;
+  for (int i = 0; i < 5; i++) {
+    uint32_t t0 = millis();
+    while (millis() - t0 < 50 + i * 37u) step(poll);   // pedido já em espera
+
+    char cmd[96];
+    snprintf(cmd, sizeof(cmd), "{\"id\":%d,\"type\":\"MANUAL_DOSE\",\"payload\":{\"pump_index\":1}}", i + 1);
+    uint32_t injectAt = millis();
+    s.inject(cmd);
+
+    bool got = false;
+    while (!got && millis() - injectAt < 2000) {
+      got = step(poll) && strstr(poll.body(), cmd) != nullptr;
+    }
+    CHECK(got);
+    uint32_t lat = millis() - injectAt;
+    if (lat > worst) worst = lat;
+  }
+  printf("latência comando -> firmware: pior de 5 = %u ms\n", worst);
+  CHECK(worst < 200);
+}
+
+// Servidor antigo (sem X-Long-Poll): volta ao poll de 1 s
+static void testLegacyFallback(StandIn& s) {
+  s.mode = LEGACY;
+  int before = s.requests;
+  CommandPoll poll;
+  begin(poll, s.port);
+
+  uint32_t t0 = millis();
+  while (millis() - t0 < 2500) step(poll);
+  int reqs = s.requests - before;
+  printf("servidor legado: %d pedidos em 2,5 s\n", reqs);
+  CHECK(poll.legacy());
+  CHECK(reqs >= 2 && reqs <= 4);
+
+  // servidor atualizado: sai do modo legado sozinho (próximo pedido em
+  // até 1 s + espera de 90 * SCALE_MS)
+  s.mode = LONGPOLL;
+  t0 = millis();
+  while (millis() - t0 < 2500) step(poll);
+  CHECK(!poll.legacy());
+}
+
+// Proxy cortando a espera (504): reduz wait_s e continua
+static void testGatewayShrink(StandIn& s) {
+  s.mode = GATEWAY;
+  CommandPoll poll;
+  begin(poll, s.port);
+
+  uint32_t t0 = millis();
+  while (poll.failures() == 0 && millis() - t0 < 500) step(poll);
+  CHECK(poll.failures() == 1);
+  CHECK(poll.waitS() == CMDPOLL_WAIT_S / 2);
+
+  s.mode = LONGPOLL;
+  int before = s.requests;
+  t0 = millis();
+  while (s.requests == before && millis() - t0 < CMDPOLL_BACKOFF_MIN_MS + 500) step(poll);
+  CHECK(s.requests > before);
+  CHECK(s.lastWait == CMDPOLL_WAIT_S / 2);
+}
+
+// Servidor fora do ar: backoff, sem martelar connect()
+static void testServerDown() {
+  StandIn tmp;
+  tmp.start();
+  uint16_t deadPort = tmp.port;
+  tmp.shutdown();
+
+  CommandPoll poll;
+  begin(poll, deadPort);
+  uint32_t t0 = millis();
+  while (millis() - t0 < 500) step(poll);
+  CHECK(poll.failures() == 1);
+  CHECK(poll.requests() == 0);
+}
+
+int main() {
+  StandIn s;
+  s.start();
+  testIdle(s);
+  testLatency(s);
+  testLegacyFallback(s);
+  testGatewayShrink(s);
+  testServerDown();
+  s.shutdown();
+
+  if (errors) {
+    printf("FALHOU (%d erros)\n", errors);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
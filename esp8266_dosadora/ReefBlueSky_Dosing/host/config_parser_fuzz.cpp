@@ -0,0 +1,344 @@
+// config_parser_fuzz.cpp - DoserConfigParser contra entradas válidas e lixo
+//
+//  1. respostas reais do backend (DECIMAL como string, enabled 0/1, null,
+//     campos desconhecidos aninhados, "unchanged" com volumes);
+//  2. ida e volta: structs aleatórias -> writeDoserConfig -> parse -> iguais;
+//  3. mutações aleatórias (byte trocado, apagado, inserido, truncado),
+//     aninhamento profundo e strings enormes: tem que devolver false ou um
+//     stage dentro dos limites, nunca estourar (rodar com make asan).
+//
+// Uso: ./config_parser_fuzz [iterações]   (padrão 20000)
+
+#include "../DoserConfigParser.h"
+#include <math.h>
+#include <string>
+
+HostSerial Serial;
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+
+class MemStream : public Stream {
+public:
+  explicit MemStream(const std::string& s) : _s(s) {}
+  int available() override { return (int)(_s.size() - _pos); }
+  int read() override { return _pos < _s.size() ? (uint8_t)_s[_pos++] : -1; }
+  size_t consumed() const { return _pos; }
+private:
+  const std::string& _s;
+  size_t _pos = 0;
+};
+
+class StringPrint : public Print {
+public:
+  size_t write(uint8_t c) override { s += (char)c; return 1; }
+  std::string s;
+};
+
+static uint32_t rngState = 12345;
+static uint32_t rnd() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+static uint32_t rnd(uint32_t n) { return rnd() % n; }
+
+static bool parse(const std::string& json, DoserConfigStage& out, const char** err = nullptr) {
+  MemStream in(json);
+  return parseDoserConfig(in, out, err);
+}
+
+static bool near(float a, float b) { return fabsf(a - b) <= 1e-4f * (1 + fabsf(a)); }
+
+// ---------- 1. Respostas do backend ----------
+
+static void testBackendResponse() {
+  const std::string json =
+      "{\"success\":true,\"server_time\":1760000000,\"user_utc_offset_sec\":-10800,"
+      "\"config_version\":\"3f2a9c0d11b2e4f5\",\"meta\":{\"a\":[1,{\"b\":null}],\"c\":\"x\"},"
+      "\"pumps\":[{\"id\":\"12\",\"name\":\"Ca\\u00e7\\\"\\u00e3o\",\"enabled\":true,"
+      "\"calibration_rate_ml_s\":\"1.2500\",\"max_daily_ml\":80,\"current_volume_ml\":\"321\","
+      "\"container_volume_ml\":1000,\"alarm_threshold_pct\":null,\"extra\":[[],[[]]],"
+      "\"schedules\":[{\"id\":7,\"enabled\":0,\"days_mask\":62,\"doses_per_day\":4,"
+      "\"volume_per_day_ml\":\"12.50\",\"min_gap_minutes\":30,\"start_time\":\"08:00:00\","
+      "\"end_time\":\"20:30:00\",\"adjusted_times\":[\"08:00\",\"\",\"12:15\",null,\"16:30\"],"
+      "\"dose_volumes\":[3.13,\"3.12\",3.13,3.12]},"
+      "{\"id\":8,\"enabled\":null,\"adjusted_times\":null,\"dose_volumes\":\"[]\"}]},"
+      "{\"id\":13,\"enabled\":false,\"name\":null,\"schedules\":null}]}"
+      "LIXO DEPOIS DO OBJETO";
+
+  DoserConfigStage cfg;
+  const char* err = nullptr;
+  MemStream in(json);
+  CHECK(parseDoserConfig(in, cfg, &err));
+  CHECK(in.available() == (int)strlen("LIXO DEPOIS DO OBJETO"));   // parou no '}'
+
+  CHECK(cfg.hasPumps && !cfg.unchanged);
+  CHECK(strcmp(cfg.version, "3f2a9c0d11b2e4f5") == 0);
+  CHECK(cfg.hasOffset && cfg.utcOffsetSec == -10800);
+  CHECK(cfg.pumpCount == 2);
+  CHECK(cfg.scheduleCount == 2);
+
+  const PumpConfig& p = cfg.pumps[0];
+  CHECK(p.id == 12 && p.index == 0 && p.enabled);
+  CHECK(strcmp(p.name, "Ca\xc3\xa7\"\xc3\xa3o") == 0);
+  CHECK(near(p.calibMlPerSec, 1.25f));
+  CHECK(p.maxDailyMl == 80 && p.currentVolumeMl == 321 && p.containerVolumeMl == 1000);
+  CHECK(p.alarmThresholdPct == 10);                 // null -> padrão
+
+  const Schedule& s = cfg.schedules[0];
+  CHECK(s.id == 7 && !s.enabled && s.daysMask == 62 && s.dosesPerDay == 4);
+  CHECK(near(s.volumePerDayMl, 12.5f) && s.minGapMinutes == 30 && s.pumpIndex == 0);
+  CHECK(s.startMin == 8 * 60 && s.endMin == 20 * 60 + 30);
+  CHECK(s.adjustedTimesCount == 3);                 // vazio e null ignorados
+  CHECK(s.adjustedMin[1] == 12 * 60 + 15);
+  CHECK(s.doseVolumesCount == 4 && s.doseVolumeCml[1] == 312 && s.doseVolumeCml[2] == 313);
+
+  const Schedule& s2 = cfg.schedules[1];
+  CHECK(s2.id == 8 && s2.enabled && s2.daysMask == 127 && s2.dosesPerDay == 1);
+  CHECK(near(s2.volumePerDayMl, 10) && s2.adjustedTimesCount == 0 && s2.doseVolumesCount == 0);
+
+  const PumpConfig& p2 = cfg.pumps[1];
+  CHECK(p2.id == 13 && p2.index == 1 && !p2.enabled && p2.name[0] == 0);
+  CHECK(near(p2.calibMlPerSec, 1.0f) && p2.currentVolumeMl == 500);
+
+  // handshake sem mudança: só volumes
+  DoserConfigStage u;
+  CHECK(parse("{\"success\":true,\"unchanged\":true,\"config_version\":\"abc\","
+              "\"server_time\":1,\"user_utc_offset_sec\":3600,"
+              "\"volumes\":{\"12\":250,\"13\":\"99\",\"14\":null}}", u));
+  CHECK(u.unchanged && !u.hasPumps && u.pumpCount == 0);
+  CHECK(u.volumeCount == 2 && u.volumes[0].pumpId == 12 && u.volumes[0].volumeMl == 250);
+  CHECK(u.volumes[1].pumpId == 13 && u.volumes[1].volumeMl == 99);
+  CHECK(u.utcOffsetSec == 3600);
+
+  // dose acima de 655,35 mL (limite do uint16_t antigo) chega inteira
+  DoserConfigStage l;
+  CHECK(parse("{\"pumps\":[{\"id\":1,\"schedules\":[{\"id\":2,\"doses_per_day\":1,"
+              "\"volume_per_day_ml\":1000,\"dose_volumes\":[1000,\"700.5\",-3]}]}]}", l));
+  CHECK(l.scheduleCount == 1 && l.schedules[0].doseVolumesCount == 3);
+  CHECK(l.schedules[0].doseVolumeCml[0] == 100000 && l.schedules[0].doseVolumeCml[1] == 70050);
+  CHECK(l.schedules[0].doseVolumeCml[2] == 0);
+
+  // mais bombas/agendas que o firmware comporta: excedente ignorado
+  std::string big = "{\"pumps\":[";
+  for (int i = 0; i < MAX_PUMPS + 3; i++) {
+    if (i) big += ",";
+    big += "{\"id\":" + std::to_string(i + 1) + ",\"schedules\":[";
+    for (int j = 0; j < 4; j++) big += std::string(j ? "," : "") + "{\"id\":" + std::to_string(j) + "}";
+    big += "]}";
+  }
+  big += "]}";
+  DoserConfigStage b;
+  CHECK(parse(big, b));
+  CHECK(b.pumpCount == MAX_PUMPS && b.scheduleCount == MAX_SCHEDULES);
+  CHECK(b.schedules[MAX_SCHEDULES - 1].pumpIndex == (MAX_SCHEDULES - 1) / 4);
+
+  printf("backend: ok (stage %u bytes, contra DynamicJsonDocument de 8192 + String da resposta)\n",
+         (unsigned)sizeof(DoserConfigStage));
+}
+
+// ---------- 2. Ida e volta ----------
+
+static void randomName(char* out, size_t cap) {
+  static const char* parts[] = {"Ca", "Mg", "KH", " ", "\"", "\\", "ç", "ã", "/", "\t", "Elos", "Fe"};
+  out[0] = 0;
+  size_t n = rnd(6);
+  for (size_t i = 0; i < n; i++) {
+    const char* p = parts[rnd(sizeof(parts) / sizeof(parts[0]))];
+    if (strlen(out) + strlen(p) >= cap) break;
+    strcat(out, p);
+  }
+}
+
+static void randomConfig(DoserConfigStage& c) {
+  memset(&c, 0, sizeof(c));
+  c.pumpCount = rnd(MAX_PUMPS + 1);
+  for (uint8_t i = 0; i < c.pumpCount; i++) {
+    PumpConfig& p = c.pumps[i];
+    p.id = 1 + rnd(100000);
+    p.index = i;
+    p.enabled = rnd(2);
+    randomName(p.name, sizeof(p.name));
+    p.calibMlPerSec = (float)(rnd(50000) / 10000.0);
+    p.maxDailyMl = rnd(65536);
+    p.currentVolumeMl = rnd(65536);
+    p.containerVolumeMl = rnd(65536);
+    p.alarmThresholdPct = rnd(101);
+
+    uint8_t n = rnd(4);
+    for (uint8_t k = 0; k < n && c.scheduleCount < MAX_SCHEDULES; k++) {
+      Schedule& s = c.schedules[c.scheduleCount++];
+      s.id = rnd(1000000);
+      s.enabled = rnd(2);
+      s.daysMask = rnd(128);
+      s.dosesPerDay = 1 + rnd(24);
+      s.volumePerDayMl = (float)(rnd(100000) / 100.0);
+      s.minGapMinutes = rnd(600);
+      s.pumpIndex = i;
+      s.startMin = rnd(1440);
+      s.endMin = rnd(1440);
+      s.adjustedTimesCount = rnd(25);
+      for (uint8_t t = 0; t < s.adjustedTimesCount; t++) s.adjustedMin[t] = rnd(1440);
+      s.doseVolumesCount = rnd(25);
+      for (uint8_t t = 0; t < s.doseVolumesCount; t++) s.doseVolumeCml[t] = rnd(200000);
+    }
+  }
+  snprintf(c.version, sizeof(c.version), "%08x%08x", rnd(), rnd());
+  c.utcOffsetSec = (int32_t)rnd(50401) - 43200;
+}
+
+static std::string write(const DoserConfigStage& c) {
+  StringPrint out;
+  writeDoserConfig(out, c.pumps, c.pumpCount, c.schedules, c.scheduleCount, c.version, c.utcOffsetSec);
+  return out.s;
+}
+
+static bool samePumps(const DoserConfigStage& a, const DoserConfigStage& b) {
+  if (a.pumpCount != b.pumpCount) return false;
+  for (uint8_t i = 0; i < a.pumpCount; i++) {
+    const PumpConfig& x = a.pumps[i];
+    const PumpConfig& y = b.pumps[i];
+    if (x.id != y.id || x.index != y.index || x.enabled != y.enabled || strcmp(x.name, y.name) ||
+        !near(x.calibMlPerSec, y.calibMlPerSec) || x.maxDailyMl != y.maxDailyMl ||
+        x.currentVolumeMl != y.currentVolumeMl || x.containerVolumeMl != y.containerVolumeMl ||
+        x.alarmThresholdPct != y.alarmThresholdPct) return false;
+  }
+  return true;
+}
+
+static bool sameSchedules(const DoserConfigStage& a, const DoserConfigStage& b) {
+  if (a.scheduleCount != b.scheduleCount) return false;
+  for (uint8_t i = 0; i < a.scheduleCount; i++) {
+    const Schedule& x = a.schedules[i];
+    const Schedule& y = b.schedules[i];
+    if (x.id != y.id || x.enabled != y.enabled || x.daysMask != y.daysMask ||
+        x.dosesPerDay != y.dosesPerDay || !near(x.volumePerDayMl, y.volumePerDayMl) ||
+        x.minGapMinutes != y.minGapMinutes || x.pumpIndex != y.pumpIndex ||
+        x.startMin != y.startMin || x.endMin != y.endMin ||
+        x.adjustedTimesCount != y.adjustedTimesCount || x.doseVolumesCount != y.doseVolumesCount) return false;
+    for (uint8_t t = 0; t < x.adjustedTimesCount; t++) if (x.adjustedMin[t] != y.adjustedMin[t]) return false;
+    for (uint8_t t = 0; t < x.doseVolumesCount; t++) if (x.doseVolumeCml[t] != y.doseVolumeCml[t]) return false;
+  }
+  return true;
+}
+
+static void testRoundTrip(int iterations) {
+  size_t maxLen = 0;
+  for (int it = 0; it < iterations; it++) {
+    DoserConfigStage a, b;
+    randomConfig(a);
+    std::string json = write(a);
+    if (json.size() > maxLen) maxLen = json.size();
+
+    const char* err = nullptr;
+    bool ok = parse(json, b, &err);
+    CHECK(ok);
+    if (!ok) {
+      fprintf(stderr, "erro '%s' em: %s\n", err, json.c_str());
+      return;
+    }
+    CHECK(b.hasPumps && b.hasOffset && b.utcOffsetSec == a.utcOffsetSec);
+    CHECK(strcmp(a.version, b.version) == 0);
+    CHECK(samePumps(a, b));
+    CHECK(sameSchedules(a, b));
+    if (errors) {
+      fprintf(stderr, "diferença em: %s\n", json.c_str());
+      return;
+    }
+  }
+  printf("ida e volta: %d configs ok (maior JSON %u bytes)\n", iterations, (unsigned)maxLen);
+}
+
+// ---------- 3. Entradas inválidas ----------
+
+static void checkBounds(const DoserConfigStage& c) {
+  CHECK(c.pumpCount <= MAX_PUMPS);
+  CHECK(c.scheduleCount <= MAX_SCHEDULES);
+  CHECK(c.volumeCount <= MAX_PUMPS);
+  CHECK(memchr(c.version, 0, sizeof(c.version)) != nullptr);
+  for (uint8_t i = 0; i < c.pumpCount; i++) CHECK(memchr(c.pumps[i].name, 0, sizeof(c.pumps[i].name)) != nullptr);
+  for (uint8_t i = 0; i < c.scheduleCount; i++) {
+    CHECK(c.schedules[i].adjustedTimesCount <= 24);
+    CHECK(c.schedules[i].doseVolumesCount <= 24);
+    CHECK(c.schedules[i].pumpIndex < MAX_PUMPS);
+  }
+}
+
+static void mutate(std::string& s) {
+  static const char junk[] = "{}[],:\"\\-0123456789.eEtruefalsnl \n\x01\xff\xc3";
+  int n = 1 + rnd(4);
+  for (int i = 0; i < n && !s.empty(); i++) {
+    size_t pos = rnd(s.size());
+    switch (rnd(5)) {
+      case 0: s[pos] = junk[rnd(sizeof(junk) - 1)]; break;
+      case 1: s.erase(pos, 1 + rnd(8)); break;
+      case 2: s.insert(pos, 1, junk[rnd(sizeof(junk) - 1)]); break;
+      case 3: s.resize(pos); break;
+      case 4: s.insert(pos, s.substr(rnd(s.size()), rnd(40))); break;
+    }
+  }
+}
+
+static void testMalformed(int iterations) {
+  int rejected = 0;
+  for (int it = 0; it < iterations; it++) {
+    DoserConfigStage a, b;
+    randomConfig(a);
+    std::string json = write(a);
+    mutate(json);
+    if (!parse(json, b)) rejected++;
+    checkBounds(b);
+    if (errors) {
+      fprintf(stderr, "fora dos limites em: %s\n", json.c_str());
+      return;
+    }
+  }
+
+  // aninhamento muito além do limite: falha limpa, sem recursão sem fim
+  DoserConfigStage c;
+  const char* err = nullptr;
+  std::string deep = "{\"x\":" + std::string(100000, '[') + std::string(100000, ']') + "}";
+  CHECK(!parse(deep, c, &err));
+  CHECK(err && strstr(err, "aninhamento"));
+  std::string deepOk = "{\"x\":" + std::string(DOSER_CFG_MAX_DEPTH - 1, '[') +
+                       std::string(DOSER_CFG_MAX_DEPTH - 1, ']') + ",\"pumps\":[]}";
+  CHECK(parse(deepOk, c) && c.hasPumps);
+
+  // string gigante: truncada no nome, pulada no resto
+  std::string longStr(100000, 'a');
+  CHECK(parse("{\"pumps\":[{\"id\":1,\"name\":\"" + longStr + "\",\"zz\":\"" + longStr + "\"}]}", c));
+  CHECK(c.pumpCount == 1 && strlen(c.pumps[0].name) == sizeof(c.pumps[0].name) - 1);
+  // corte no meio de um caractere UTF-8 não deixa byte solto
+  std::string utf = "{\"pumps\":[{\"name\":\"" + std::string(22, 'a') + "\xc3\xa7\"}]}";
+  CHECK(parse(utf, c) && strlen(c.pumps[0].name) == 22);
+
+  // casos pontuais
+  static const char* bad[] = {
+    "", "{", "{\"pumps\":", "{\"pumps\":[", "{\"pumps\":[{\"id\":1,}]}", "{\"pumps\":[,]}",
+    "{\"a\":1 \"b\":2}", "{\"a\":tru}", "{\"a\":\"\\x\"}", "{\"a\":\"\\u12G4\"}",
+    "{\"a\":1e}", "{\"a\":--1}", "{\"a\":\"\x01\"}", "[1,2]", "{\"a\":nul}",
+    "{\"a\":123456789012345678901234567890123}",
+  };
+  for (const char* s : bad) {
+    CHECK(!parse(s, c));
+    checkBounds(c);
+  }
+
+  printf("malformado: %d mutações, %d rejeitadas, nenhuma fora dos limites\n", iterations, rejected);
+}
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+  testBackendResponse();
+  testRoundTrip(iterations / 4);
+  testMalformed(iterations);
+
+  if (errors) {
+    printf("FALHOU (%d erros)\n", errors);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,334 @@
+// job_replay_test.cpp - tabela compacta de jobs (DoseJobs.cpp) contra o
+// rebuildJobs() antigo (structs de 24 bytes, horário em epoch, volume float)
+//
+// Para configs aleatórias (bombas desligadas, máscara vazia, horários
+// ajustados, volumes por dose, janelas invertidas) refaz as duas tabelas a
+// cada 5 min ao longo de 8 dias, como o loop() da dosadora, e exige os
+// mesmos jobs na mesma ordem: bomba, agenda, horário e índice iguais,
+// volume dentro do arredondamento de 0,01 mL.
+//
+// Uso: ./job_replay_test [configs]   (padrão 100)
+
+#include "../DoseJobs.h"
+#include <math.h>
+
+HostSerial Serial;
+
+static int errors = 0;
+#define CHECK(c) do { if (!(c)) { fprintf(stderr, "linha %d: %s\n", __LINE__, #c); errors++; } } while (0)
+
+// ---------- Referência: layout e algoritmo antes da compactação ----------
+
+struct LegacySchedule {
+  uint32_t id;
+  bool     enabled;
+  uint8_t  daysMask;
+  uint8_t  dosesPerDay;
+  float volumePerDayMl;
+  uint16_t minGapMinutes;
+  uint32_t startSecSinceMidnight;
+  uint32_t endSecSinceMidnight;
+  uint8_t  pumpIndex;
+  uint32_t adjustedTimes[24];
+  uint8_t  adjustedTimesCount;
+  float doseVolumes[24];
+  uint8_t  doseVolumesCount;
+};
+
+struct LegacyDoseJob {
+  uint32_t pumpId;
+  uint32_t scheduleId;
+  uint32_t whenEpoch;
+  float volumeMl;
+  bool     executed;
+  uint8_t  retries;
+  uint16_t minGapSec;
+  uint8_t  doseIndex;
+};
+
+// Contador em uint16_t: o original usava uint8_t e dava a volta em 256
+static uint16_t legacyRebuild(const PumpConfig* pumps, uint8_t pumpCount,
+                              const LegacySchedule* schedules, uint8_t scheduleCount,
+                              time_t now, LegacyDoseJob* jobs) {
+  uint16_t doseJobCount = 0;
+  if (now == 0) return 0;
+  struct tm timeinfo;
+  localtime_r(&now, &timeinfo);
+  uint8_t  weekday       = timeinfo.tm_wday;
+  uint32_t todayMidnight = (uint32_t)now - (now % 86400);
+  uint32_t nowSec        = timeinfo.tm_hour * 3600u + timeinfo.tm_min * 60u + timeinfo.tm_sec;
+
+  for (uint8_t p = 0; p < pumpCount; p++) {
+    if (!pumps[p].enabled) continue;
+    for (uint8_t s = 0; s < scheduleCount; s++) {
+      const LegacySchedule& sched = schedules[s];
+      if (!sched.enabled) continue;
+      if (sched.pumpIndex != p) continue;
+
+      uint8_t maskBit = (1 << weekday);
+      bool todayValid = (sched.daysMask & maskBit) != 0;
+      uint32_t rangeSec = 0;
+      if (sched.endSecSinceMidnight > sched.startSecSinceMidnight) {
+        rangeSec = sched.endSecSinceMidnight - sched.startSecSinceMidnight;
+      } else {
+        continue;
+      }
+      if (rangeSec == 0 || sched.dosesPerDay == 0) continue;
+
+      uint32_t intervalPerDose = rangeSec / sched.dosesPerDay;
+      float volumePerDose = sched.volumePerDayMl / sched.dosesPerDay;
+      bool useAdjustedTimes = (sched.adjustedTimesCount > 0);
+
+      if (todayValid) {
+        uint8_t numDoses = useAdjustedTimes ? sched.adjustedTimesCount : sched.dosesPerDay;
+        for (uint8_t d = 0; d < numDoses; d++) {
+          if (doseJobCount >= MAX_DOSE_JOBS) break;
+          uint32_t secSinceMidnight = useAdjustedTimes
+              ? sched.adjustedTimes[d]
+              : (sched.startSecSinceMidnight + (d * intervalPerDose));
+          if (secSinceMidnight < nowSec) continue;
+          float doseVolume = volumePerDose;
+          if (sched.doseVolumesCount > 0 && d < sched.doseVolumesCount) doseVolume = sched.doseVolumes[d];
+          LegacyDoseJob& job = jobs[doseJobCount++];
+          job.pumpId = pumps[p].id;
+          job.scheduleId = sched.id;
+          job.volumeMl = doseVolume;
+          job.whenEpoch = todayMidnight + secSinceMidnight;
+          job.executed = false;
+          job.retries = 0;
+          job.minGapSec = sched.minGapMinutes * 60;
+          job.doseIndex = d + 1;
+        }
+      }
+
+      int daysAhead = 1;
+      for (int d = 1; d <= 7; d++) {
+        uint8_t w = (weekday + d) % 7;
+        if (sched.daysMask & (1 << w)) {
+          daysAhead = d;
+          break;
+        }
+      }
+      uint32_t baseMidnight = todayMidnight + (uint32_t)daysAhead * 86400u;
+      uint8_t numDosesNextDay = useAdjustedTimes ? sched.adjustedTimesCount : sched.dosesPerDay;
+      for (uint8_t d = 0; d < numDosesNextDay; d++) {
+        if (doseJobCount >= MAX_DOSE_JOBS) break;
+        uint32_t secSinceMidnight = useAdjustedTimes
+            ? sched.adjustedTimes[d]
+            : (sched.startSecSinceMidnight + (d * intervalPerDose));
+        float doseVolume = volumePerDose;
+        if (sched.doseVolumesCount > 0 && d < sched.doseVolumesCount) doseVolume = sched.doseVolumes[d];
+        LegacyDoseJob& job = jobs[doseJobCount++];
+        job.pumpId = pumps[p].id;
+        job.scheduleId = sched.id;
+        job.volumeMl = doseVolume;
+        job.whenEpoch = baseMidnight + secSinceMidnight;
+        job.executed = false;
+        job.retries = 0;
+        job.minGapSec = sched.minGapMinutes * 60;
+        job.doseIndex = d + 1;
+      }
+    }
+  }
+  return doseJobCount;
+}
+
+// O parser antigo guardava segundos e floats; o novo, minutos e 0,01 mL
+static LegacySchedule toLegacy(const Schedule& s) {
+  LegacySchedule l;
+  memset(&l, 0, sizeof(l));
+  l.id = s.id;
+  l.enabled = s.enabled;
+  l.daysMask = s.daysMask;
+  l.dosesPerDay = s.dosesPerDay;
+  l.volumePerDayMl = s.volumePerDayMl;
+  l.minGapMinutes = s.minGapMinutes;
+  l.startSecSinceMidnight = s.startMin * 60u;
+  l.endSecSinceMidnight = s.endMin * 60u;
+  l.pumpIndex = s.pumpIndex;
+  l.adjustedTimesCount = s.adjustedTimesCount;
+  for (uint8_t i = 0; i < s.adjustedTimesCount; i++) l.adjustedTimes[i] = s.adjustedMin[i] * 60u;
+  l.doseVolumesCount = s.doseVolumesCount;
+  for (uint8_t i = 0; i < s.doseVolumesCount; i++) l.doseVolumes[i] = (float)(s.doseVolumeCml[i] / 100.0);
+  return l;
+}
+
+// ---------- Configs aleatórias ----------
+
+static uint32_t rngState = 2463534242u;
+static uint32_t rnd() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+static uint32_t rnd(uint32_t n) { return rnd() % n; }
+
+struct Config {
+  PumpConfig pumps[MAX_PUMPS];
+  uint8_t pumpCount;
+  Schedule schedules[MAX_SCHEDULES];
+  uint8_t scheduleCount;
+};
+
+static void randomConfig(Config& c) {
+  memset(&c, 0, sizeof(c));
+  c.pumpCount = 1 + rnd(MAX_PUMPS);
+  for (uint8_t i = 0; i < c.pumpCount; i++) {
+    c.pumps[i].id = 100 + rnd(1000);
+    c.pumps[i].index = i;
+    c.pumps[i].enabled = rnd(8) != 0;
+  }
+  c.scheduleCount = rnd(MAX_SCHEDULES + 1);
+  for (uint8_t k = 0; k < c.scheduleCount; k++) {
+    Schedule& s = c.schedules[k];
+    s.id = 1 + rnd(100000);
+    s.enabled = rnd(8) != 0;
+    s.daysMask = rnd(6) == 0 ? 0 : rnd(128);
+    s.dosesPerDay = rnd(20) == 0 ? 0 : 1 + rnd(24);
+    s.volumePerDayMl = rnd(50000) / 100.0f;
+    s.minGapMinutes = rnd(60);
+    s.pumpIndex = rnd(c.pumpCount + 1);             // às vezes aponta para bomba inexistente
+    s.startMin = rnd(1440);
+    s.endMin = rnd(5) == 0 ? rnd(1440) : s.startMin + rnd(1440 - s.startMin);
+    if (rnd(2)) {
+      s.adjustedTimesCount = 1 + rnd(24);
+      for (uint8_t t = 0; t < s.adjustedTimesCount; t++) s.adjustedMin[t] = rnd(1440);
+    }
+    if (rnd(2)) {
+      s.doseVolumesCount = rnd(25);
+      for (uint8_t t = 0; t < s.doseVolumesCount; t++) s.doseVolumeCml[t] = rnd(10) == 0 ? rnd(200000) : rnd(20000);
+    }
+  }
+}
+
+// ---------- Replay ----------
+
+static DoseJob       jobs[MAX_DOSE_JOBS];
+static LegacyDoseJob legacy[MAX_DOSE_JOBS];
+
+// Compara as duas tabelas; devolve quantos jobs
+static uint32_t compareAt(const Config& c, const LegacySchedule* ls, time_t now) {
+  uint32_t base = 0;
+  uint16_t n = buildDoseJobs(c.pumps, c.pumpCount, c.schedules, c.scheduleCount, now, jobs, MAX_DOSE_JOBS, base);
+  uint16_t ln = legacyRebuild(c.pumps, c.pumpCount, ls, c.scheduleCount, now, legacy);
+  CHECK(n == ln);
+  if (n != ln) return 0;
+  for (uint16_t i = 0; i < n; i++) {
+    const DoseJob& j = jobs[i];
+    const LegacyDoseJob& l = legacy[i];
+    bool same = c.pumps[j.pumpIndex].id == l.pumpId &&
+                c.schedules[j.schedIndex].id == l.scheduleId &&
+                base + j.offsetSec == l.whenEpoch &&
+                j.doseIndex == l.doseIndex &&
+                c.schedules[j.schedIndex].minGapMinutes * 60u == l.minGapSec &&
+                !j.executed &&
+                fabsf(doseJobVolume(j) - l.volumeMl) <= 0.005f + 1e-4f * l.volumeMl;
+    CHECK(same);
+    if (!same) {
+      fprintf(stderr, "job %u em now=%ld: pump %u/%u sched %u/%u when %u/%u dose %u/%u vol %.4f/%.4f\n",
+              i, (long)now, c.pumps[j.pumpIndex].id, l.pumpId, c.schedules[j.schedIndex].id, l.scheduleId,
+              base + j.offsetSec, l.whenEpoch, (unsigned)j.doseIndex, l.doseIndex,
+              doseJobVolume(j), l.volumeMl);
+      return 0;
+    }
+  }
+  return n;
+}
+
+static void testReplay(int configs) {
+  uint64_t compared = 0;
+  uint32_t rebuilds = 0;
+  for (int it = 0; it < configs && !errors; it++) {
+    Config c;
+    randomConfig(c);
+    LegacySchedule ls[MAX_SCHEDULES];
+    for (uint8_t k = 0; k < c.scheduleCount; k++) ls[k] = toLegacy(c.schedules[k]);
+
+    time_t start = 1735689600 + (time_t)rnd(365) * 86400 + rnd(86400);   // algum dia de 2025
+    for (time_t now = start; now < start + 8 * 86400 && !errors; now += 300 + rnd(3)) {
+      compared += compareAt(c, ls, now);
+      rebuilds++;
+    }
+  }
+  printf("replay: %d configs, %u reconstruções, %llu jobs idênticos\n",
+         configs, rebuilds, (unsigned long long)compared);
+}
+
+// 6 bombas × 24 doses × 2 dias = 288 jobs: passava de 255 (contador uint8_t)
+static void testFullTable() {
+  Config c;
+  memset(&c, 0, sizeof(c));
+  c.pumpCount = MAX_PUMPS;
+  for (uint8_t i = 0; i < MAX_PUMPS; i++) {
+    c.pumps[i].id = 10 + i;
+    c.pumps[i].enabled = true;
+    Schedule& s = c.schedules[c.scheduleCount++];
+    s.id = 100 + i;
+    s.enabled = true;
+    s.daysMask = 127;
+    s.dosesPerDay = 24;
+    s.volumePerDayMl = 24.0f;
+    s.pumpIndex = i;
+    s.startMin = 0;
+    s.endMin = 1439;
+  }
+  LegacySchedule ls[MAX_SCHEDULES];
+  for (uint8_t k = 0; k < c.scheduleCount; k++) ls[k] = toLegacy(c.schedules[k]);
+
+  time_t midnight = 1760054400;   // 00:00 UTC
+  CHECK(compareAt(c, ls, midnight) == 288);
+
+  // tabela menor que a demanda: para no limite, sem escrever além
+  uint32_t base;
+  uint16_t n = buildDoseJobs(c.pumps, c.pumpCount, c.schedules, c.scheduleCount, midnight, jobs, 100, base);
+  CHECK(n == 100);
+}
+
+// Dose única de 1000 mL: o volume por dose era uint16_t e saturava em 655,35 mL
+static void testLargeDose() {
+  Config c;
+  memset(&c, 0, sizeof(c));
+  c.pumpCount = 1;
+  c.pumps[0].id = 10;
+  c.pumps[0].enabled = true;
+  Schedule& s = c.schedules[c.scheduleCount++];
+  s.id = 100;
+  s.enabled = true;
+  s.daysMask = 127;
+  s.dosesPerDay = 1;
+  s.volumePerDayMl = 1000.0f;
+  s.startMin = 8 * 60;
+  s.endMin = 9 * 60;
+  s.doseVolumesCount = 1;
+  s.doseVolumeCml[0] = 100000;
+  LegacySchedule ls[MAX_SCHEDULES];
+  ls[0] = toLegacy(s);
+
+  time_t midnight = 1760054400;
+  CHECK(compareAt(c, ls, midnight) == 2);
+  CHECK(fabsf(doseJobVolume(jobs[0]) - 1000.0f) < 0.01f);
+}
+
+int main(int argc, char** argv) {
+  setenv("TZ", "UTC0", 1);   // no ESP o relógio é UTC; o fuso já vem somado em now
+  tzset();
+
+  int configs = argc > 1 ? atoi(argv[1]) : 100;
+  testFullTable();
+  testLargeDose();
+  testReplay(configs);
+
+  printf("memória: jobs %u -> %u bytes, agendas %u -> %u bytes (%u bytes livres a mais)\n",
+         (unsigned)(sizeof(LegacyDoseJob) * MAX_DOSE_JOBS), (unsigned)(sizeof(DoseJob) * MAX_DOSE_JOBS),
+         (unsigned)(sizeof(LegacySchedule) * MAX_SCHEDULES), (unsigned)(sizeof(Schedule) * MAX_SCHEDULES),
+         (unsigned)((sizeof(LegacyDoseJob) - sizeof(DoseJob)) * MAX_DOSE_JOBS +
+                    (sizeof(LegacySchedule) - sizeof(Schedule)) * MAX_SCHEDULES));
+
+  if (errors) {
+    printf("FALHOU (%d erros)\n", errors);
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}